@@ -147,6 +147,15 @@ if "%ryan_scratch%"=="1"               set didbuild=1 && %compile% ..\src\scratc
 if "%textperf%"=="1"                   set didbuild=1 && %compile% ..\src\scratch\textperf.c                                 %compile_link% %out%textperf.exe || exit /b 1
 if "%convertperf%"=="1"                set didbuild=1 && %compile% ..\src\scratch\convertperf.c                              %compile_link% %out%convertperf.exe || exit /b 1
 if "%debugstringperf%"=="1"            set didbuild=1 && %compile% ..\src\scratch\debugstringperf.c                          %compile_link% %out%debugstringperf.exe || exit /b 1
+if "%dmnperf%"=="1"                    set didbuild=1 && %compile% ..\src\scratch\dmnperf.c                                  %compile_link% %out%dmnperf.exe || exit /b 1
+if "%searchperf%"=="1"                 set didbuild=1 && %compile% ..\src\scratch\searchperf.c                               %compile_link% %out%searchperf.exe || exit /b 1
+if "%fsperf%"=="1"                     set didbuild=1 && %compile% ..\src\scratch\fsperf.c                                   %compile_link% %out%fsperf.exe || exit /b 1
+if "%acperf%"=="1"                     set didbuild=1 && %compile% ..\src\scratch\acperf.c                                   %compile_link% %out%acperf.exe || exit /b 1
+if "%condperf%"=="1"                   set didbuild=1 && %compile% ..\src\scratch\condperf.c                                 %compile_link% %out%condperf.exe || exit /b 1
+if "%unwindperf%"=="1"                 set didbuild=1 && %compile% ..\src\scratch\unwindperf.c                               %compile_link% %out%unwindperf.exe || exit /b 1
+if "%stepperf%"=="1"                   set didbuild=1 && %compile% ..\src\scratch\stepperf.c                                 %compile_link% %out%stepperf.exe || exit /b 1
+if "%dumpperf%"=="1"                   set didbuild=1 && %compile% ..\src\scratch\dumpperf.c                                 %compile_link% %out%dumpperf.exe || exit /b 1
+if "%lexperf%"=="1"                    set didbuild=1 && %compile% ..\src\scratch\lexperf.c                                  %compile_link% %out%lexperf.exe || exit /b 1
 if "%parse_inline_sites%"=="1"         set didbuild=1 && %compile% ..\src\scratch\parse_inline_sites.c                       %compile_link% %out%parse_inline_sites.exe || exit /b 1
 if "%strip_lib_debug%"=="1"            set didbuild=1 && %compile% ..\src\strip_lib_debug\strip_lib_debug.c                  %compile_link% %out%strip_lib_debug.exe || exit /b 1
 if "%mule_main%"=="1"                  set didbuild=1 && del vc*.pdb mule*.pdb && %compile_release% %only_compile% ..\src\mule\mule_inline.cpp %obj_out%mule_inline.obj && %compile_release% %only_compile% ..\src\mule\mule_o2.cpp %obj_out%mule_o2.obj && %compile_debug% %EHsc% ..\src\mule\mule_main.cpp ..\src\mule\mule_c.c mule_inline.obj mule_o2.obj %compile_link% %no_aslr% %out%mule_main.exe || exit /b 1
@@ -67,6 +67,15 @@ cd build
 if [ -v raddbg ];                then didbuild=1 && $compile ../src/raddbg/raddbg_main.c                                    $compile_link $link_os_gfx $link_render $link_font_provider $out raddbg; fi
 if [ -v radbin ];                then didbuild=1 && $compile ../src/radbin/radbin_main.c                                    $compile_link $out radbin; fi
 if [ -v radlink ];               then didbuild=1 && $compile ../src/linker/lnk.c                                            $compile_link $out radlink; fi
+if [ -v dmnperf ];               then didbuild=1 && $compile ../src/scratch/dmnperf.c                                       $compile_link $out dmnperf; fi
+if [ -v searchperf ];            then didbuild=1 && $compile ../src/scratch/searchperf.c                                    $compile_link $out searchperf; fi
+if [ -v fsperf ];                then didbuild=1 && $compile ../src/scratch/fsperf.c                                        $compile_link $out fsperf; fi
+if [ -v acperf ];                then didbuild=1 && $compile ../src/scratch/acperf.c                                        $compile_link $out acperf; fi
+if [ -v condperf ];              then didbuild=1 && $compile ../src/scratch/condperf.c                                      $compile_link $out condperf; fi
+if [ -v unwindperf ];            then didbuild=1 && $compile ../src/scratch/unwindperf.c                                    $compile_link $out unwindperf; fi
+if [ -v stepperf ];              then didbuild=1 && $compile ../src/scratch/stepperf.c                                      $compile_link $out stepperf; fi
+if [ -v dumpperf ];              then didbuild=1 && $compile ../src/scratch/dumpperf.c                                      $compile_link $out dumpperf; fi
+if [ -v lexperf ];               then didbuild=1 && $compile ../src/scratch/lexperf.c                                       $compile_link $out lexperf; fi
 cd ..
 
 # --- Warn On No Builds -------------------------------------------------------
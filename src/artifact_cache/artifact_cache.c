@@ -5,7 +5,7 @@
 //~ rjf: Layer Initialization
 
 internal void
-ac_init(void)
+ac_init(CmdLine *cmdline)
 {
   Arena *arena = arena_alloc();
   ac_shared = push_array(arena, AC_Shared, 1);
@@ -18,8 +18,46 @@ ac_init(void)
     ac_shared->req_batches[idx].mutex = mutex_alloc();
     ac_shared->req_batches[idx].arena = arena_alloc();
   }
+  
+  //- set up memory budget
+  ac_shared->budget_bytes = GB(2);
+  String8 budget_mb_string = cmd_line_string(cmdline, str8_lit("ac_budget_mb"));
+  if(budget_mb_string.size != 0)
+  {
+    U64 budget_mb = 0;
+    if(try_u64_from_str8_c_rules(budget_mb_string, &budget_mb))
+    {
+      ac_shared->budget_bytes = MB(budget_mb);
+    }
+  }
+  
   ac_shared->cancel_thread_semaphore = semaphore_alloc(0, 1, str8_zero());
   ac_shared->cancel_thread = thread_launch(ac_cancel_thread_entry_point, 0);
+  
+  //- set up thin request scheduler; with no thin workers, thin requests are
+  // drained by the async lanes at the end of each tick
+#if !NO_ASYNC
+  ac_shared->thin_workers_count = Max(2, get_system_info()->logical_processor_count/2);
+  String8 thin_workers_count_string = cmd_line_string(cmdline, str8_lit("thin_worker_count"));
+  if(thin_workers_count_string.size != 0)
+  {
+    try_u64_from_str8_c_rules(thin_workers_count_string, &ac_shared->thin_workers_count);
+  }
+#endif
+  ac_shared->thin_deques_count = Max(1, ac_shared->thin_workers_count);
+  ac_shared->thin_deques = push_array(arena, AC_ThinDeque, ac_shared->thin_deques_count*2);
+  for EachIndex(idx, ac_shared->thin_deques_count*2)
+  {
+    ac_shared->thin_deques[idx].mutex = mutex_alloc();
+    ac_shared->thin_deques[idx].arena = arena_alloc();
+  }
+  ac_shared->thin_wake_mutex = mutex_alloc();
+  ac_shared->thin_wake_cv = cond_var_alloc();
+  ac_shared->thin_workers = push_array(arena, Thread, ac_shared->thin_workers_count);
+  for EachIndex(idx, ac_shared->thin_workers_count)
+  {
+    ac_shared->thin_workers[idx] = thread_launch(ac_thin_worker_thread_entry_point, (void *)idx);
+  }
 }
 
 ////////////////////////////////
@@ -93,7 +131,7 @@ ac_artifact_from_key_(Access *access, String8 key, AC_ArtifactParams *params, U6
           artifact = n->val;
           access_touch(access, &n->access_pt, stripe->cv);
         }
-        if(is_stale)
+        if(is_stale && !(params->flags & AC_Flag_NoRequest))
         {
           B32 got_task = (ins_atomic_u64_eval_cond_assign(&n->working_count, 1, 0) == 0);
           need_request = got_task;
@@ -104,7 +142,7 @@ ac_artifact_from_key_(Access *access, String8 key, AC_ArtifactParams *params, U6
   }
   
   //- rjf: didn't get artifact we want? -> fall back to slow path
-  if(!got_artifact || need_request)
+  if((!got_artifact || need_request) && !(params->flags & AC_Flag_NoRequest))
   {
     RWMutexScope(stripe->rw_mutex, 1) for(;;)
     {
@@ -140,6 +178,7 @@ ac_artifact_from_key_(Access *access, String8 key, AC_ArtifactParams *params, U6
         node->key = str8_copy(stripe->arena, key);
         node->working_count = 1;
         node->evict_threshold_us = params->evict_threshold_us;
+        ins_atomic_u64_inc_eval(&cache->stats.count);
       }
       node->access_pt.last_time_touched_us = now_time_us();
       node->access_pt.last_update_idx_touched = update_tick_idx();
@@ -148,29 +187,39 @@ ac_artifact_from_key_(Access *access, String8 key, AC_ArtifactParams *params, U6
       if(need_request)
       {
         need_request = 0;
-        MutexScope(req_batch->mutex)
+        AC_Request request = {key, params->gen, &node->cancelled, params->create, now_time_us()};
+        
+        // rjf: thin, & have thin workers? -> hand off to the thin scheduler
+        if(!(params->flags & AC_Flag_Wide) && ac_shared->thin_workers_count != 0)
         {
-          AC_RequestNode *n = push_array(req_batch->arena, AC_RequestNode, 1);
-          if(params->flags & AC_Flag_Wide)
+          ac_thin_request_submit(&request, (params->flags & AC_Flag_HighPriority) ? 0 : 1);
+        }
+        
+        // rjf: otherwise -> push to batch for the next async tick
+        else
+        {
+          MutexScope(req_batch->mutex)
           {
-            SLLQueuePush(req_batch->first_wide, req_batch->last_wide, n);
-            req_batch->wide_count += 1;
+            AC_RequestNode *n = push_array(req_batch->arena, AC_RequestNode, 1);
+            if(params->flags & AC_Flag_Wide)
+            {
+              SLLQueuePush(req_batch->first_wide, req_batch->last_wide, n);
+              req_batch->wide_count += 1;
+            }
+            else
+            {
+              SLLQueuePush(req_batch->first_thin, req_batch->last_thin, n);
+              req_batch->thin_count += 1;
+            }
+            MemoryCopyStruct(&n->v, &request);
+            n->v.key = str8_copy(req_batch->arena, key);
           }
-          else
+          cond_var_broadcast(async_tick_start_cond_var);
+          ins_atomic_u32_eval_assign(&async_loop_again, 1);
+          if(params->flags & AC_Flag_HighPriority)
           {
-            SLLQueuePush(req_batch->first_thin, req_batch->last_thin, n);
-            req_batch->thin_count += 1;
+            ins_atomic_u32_eval_assign(&async_loop_again_high_priority, 1);
           }
-          n->v.key = str8_copy(req_batch->arena, key);
-          n->v.gen = params->gen;
-          n->v.cancel_signal = &node->cancelled;
-          n->v.create = params->create;
-        }
-        cond_var_broadcast(async_tick_start_cond_var);
-        ins_atomic_u32_eval_assign(&async_loop_again, 1);
-        if(params->flags & AC_Flag_HighPriority)
-        {
-          ins_atomic_u32_eval_assign(&async_loop_again_high_priority, 1);
         }
       }
       
@@ -194,6 +243,16 @@ ac_artifact_from_key_(Access *access, String8 key, AC_ArtifactParams *params, U6
     }
   }
   
+  //- record hit/miss
+  if(got_artifact)
+  {
+    ins_atomic_u64_inc_eval(&cache->stats.hits);
+  }
+  else
+  {
+    ins_atomic_u64_inc_eval(&cache->stats.misses);
+  }
+  
   //- rjf: report staleness
   if(params->stale_out)
   {
@@ -204,9 +263,218 @@ ac_artifact_from_key_(Access *access, String8 key, AC_ArtifactParams *params, U6
   return artifact;
 }
 
+////////////////////////////////
+//~ Cache Nodes
+
+internal void
+ac_node_release(AC_Cache *cache, AC_Slot *slot, Stripe *stripe, AC_Node *node)
+{
+  DLLRemove(slot->first, slot->last, node);
+  node->next = (AC_Node *)stripe->free;
+  stripe->free = node;
+  if(cache->destroy)
+  {
+    cache->destroy(node->val);
+  }
+  ins_atomic_u64_add_eval(&cache->stats.bytes, -(S64)node->size);
+  ins_atomic_u64_add_eval(&ac_shared->total_bytes, -(S64)node->size);
+  ins_atomic_u64_dec_eval(&cache->stats.count);
+  ins_atomic_u64_inc_eval(&cache->stats.evictions);
+}
+
+internal void
+ac_node_store(AC_Cache *cache, AC_Node *node, AC_Artifact val, U64 gen, U64 size, U64 create_us)
+{
+  // NOTE: the previous value (if any) was destroyed or is identical, so its
+  // footprint is replaced
+  S64 size_delta = (S64)size - (S64)node->size;
+  ins_atomic_u64_add_eval(&cache->stats.bytes, size_delta);
+  U64 total_bytes = ins_atomic_u64_add_eval(&ac_shared->total_bytes, size_delta);
+  if(size_delta > 0 && total_bytes > ac_shared->budget_bytes)
+  {
+    ins_atomic_u32_eval_assign(&async_loop_again, 1);
+    cond_var_broadcast(async_tick_start_cond_var);
+  }
+  node->size = size;
+  node->create_us = create_us;
+  node->last_completed_gen = gen;
+  node->val = val;
+  ins_atomic_u64_dec_eval(&node->working_count);
+  ins_atomic_u64_inc_eval(&node->completion_count);
+}
+
+////////////////////////////////
+//~ Stats
+
+internal AC_CacheStats
+ac_cache_stats_from_create(AC_CreateFunctionType *create)
+{
+  AC_CacheStats stats = {0};
+  U64 cache_hash = u64_hash_from_str8(str8_struct(&create));
+  U64 cache_slot_idx = cache_hash%ac_shared->cache_slots_count;
+  Stripe *cache_stripe = stripe_from_slot_idx(&ac_shared->cache_stripes, cache_slot_idx);
+  RWMutexScope(cache_stripe->rw_mutex, 0)
+  {
+    for(AC_Cache *c = ac_shared->cache_slots[cache_slot_idx]; c != 0; c = c->next)
+    {
+      if(c->create == create)
+      {
+        stats.bytes     = ins_atomic_u64_eval(&c->stats.bytes);
+        stats.count     = ins_atomic_u64_eval(&c->stats.count);
+        stats.hits      = ins_atomic_u64_eval(&c->stats.hits);
+        stats.misses    = ins_atomic_u64_eval(&c->stats.misses);
+        stats.evictions = ins_atomic_u64_eval(&c->stats.evictions);
+        break;
+      }
+    }
+  }
+  return stats;
+}
+
+internal AC_CacheStats
+ac_total_stats(void)
+{
+  AC_CacheStats stats = {0};
+  for EachIndex(cache_slot_idx, ac_shared->cache_slots_count)
+  {
+    Stripe *cache_stripe = stripe_from_slot_idx(&ac_shared->cache_stripes, cache_slot_idx);
+    RWMutexScope(cache_stripe->rw_mutex, 0)
+    {
+      for EachNode(c, AC_Cache, ac_shared->cache_slots[cache_slot_idx])
+      {
+        stats.bytes     += ins_atomic_u64_eval(&c->stats.bytes);
+        stats.count     += ins_atomic_u64_eval(&c->stats.count);
+        stats.hits      += ins_atomic_u64_eval(&c->stats.hits);
+        stats.misses    += ins_atomic_u64_eval(&c->stats.misses);
+        stats.evictions += ins_atomic_u64_eval(&c->stats.evictions);
+      }
+    }
+  }
+  return stats;
+}
+
 ////////////////////////////////
 //~ rjf: Asynchronous Tick
 
+internal int
+ac_evict_candidate_score_compare(AC_EvictCandidate **a, AC_EvictCandidate **b)
+{
+  int result = ((*a)->score > (*b)->score ? -1 : (*a)->score < (*b)->score ? +1 : 0);
+  return result;
+}
+
+internal void
+ac_budget_evict(void)
+{
+  U64 budget_bytes = ac_shared->budget_bytes;
+  if(ins_atomic_u64_eval(&ac_shared->total_bytes) <= budget_bytes)
+  {
+    return;
+  }
+  ProfBeginFunction();
+  Temp scratch = scratch_begin(0, 0);
+  
+  //- gather completed, unused artifacts which hold memory; score them so that
+  // large artifacts which have been idle for long, & were cheap to compute,
+  // are evicted first
+  AC_EvictCandidate *first_candidate = 0;
+  U64 candidates_count = 0;
+  U64 now_us = now_time_us();
+  for EachIndex(cache_slot_idx, ac_shared->cache_slots_count)
+  {
+    Stripe *cache_stripe = stripe_from_slot_idx(&ac_shared->cache_stripes, cache_slot_idx);
+    RWMutexScope(cache_stripe->rw_mutex, 0)
+    {
+      for EachNode(cache, AC_Cache, ac_shared->cache_slots[cache_slot_idx])
+      {
+        if(ins_atomic_u64_eval(&cache->stats.bytes) == 0)
+        {
+          continue;
+        }
+        for EachIndex(slot_idx, cache->slots_count)
+        {
+          AC_Slot *slot = &cache->slots[slot_idx];
+          Stripe *stripe = stripe_from_slot_idx(&cache->stripes, slot_idx);
+          RWMutexScope(stripe->rw_mutex, 0)
+          {
+            for EachNode(n, AC_Node, slot->first)
+            {
+              if(n->size != 0 &&
+                 ins_atomic_u64_eval(&n->working_count) == 0 &&
+                 ins_atomic_u64_eval(&n->completion_count) != 0 &&
+                 access_pt_is_expired(&n->access_pt, .time = 0))
+              {
+                U64 last_time_touched_us = ins_atomic_u64_eval(&n->access_pt.last_time_touched_us);
+                U64 idle_us = now_us - Min(now_us, last_time_touched_us);
+                AC_EvictCandidate *candidate = push_array(scratch.arena, AC_EvictCandidate, 1);
+                candidate->cache = cache;
+                candidate->slot_idx = slot_idx;
+                candidate->node = n;
+                candidate->score = (F64)(idle_us + 1) * (F64)n->size / (F64)(n->create_us + 1);
+                SLLStackPush(first_candidate, candidate);
+                candidates_count += 1;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  
+  //- sort candidates by score
+  AC_EvictCandidate **candidates = push_array_no_zero(scratch.arena, AC_EvictCandidate *, candidates_count);
+  {
+    U64 idx = 0;
+    for EachNode(c, AC_EvictCandidate, first_candidate)
+    {
+      candidates[idx] = c;
+      idx += 1;
+    }
+  }
+  quick_sort(candidates, candidates_count, sizeof(candidates[0]), ac_evict_candidate_score_compare);
+  
+  //- evict until below the budget, with some slack, so that a cache which
+  // hovers around the budget does not evict on every tick
+  U64 target_bytes = budget_bytes - budget_bytes/8;
+  for EachIndex(idx, candidates_count)
+  {
+    if(ins_atomic_u64_eval(&ac_shared->total_bytes) <= target_bytes)
+    {
+      break;
+    }
+    AC_EvictCandidate *c = candidates[idx];
+    U64 cache_slot_idx = u64_hash_from_str8(str8_struct(&c->cache->create))%ac_shared->cache_slots_count;
+    Stripe *cache_stripe = stripe_from_slot_idx(&ac_shared->cache_stripes, cache_slot_idx);
+    RWMutexScope(cache_stripe->rw_mutex, 0)
+    {
+      AC_Slot *slot = &c->cache->slots[c->slot_idx];
+      Stripe *stripe = stripe_from_slot_idx(&c->cache->stripes, c->slot_idx);
+      RWMutexScope(stripe->rw_mutex, 1)
+      {
+        // NOTE: the node may have been touched, evicted, or reused since it
+        // was gathered; only evict it if it is still in the slot & still idle
+        for EachNode(n, AC_Node, slot->first)
+        {
+          if(n == c->node)
+          {
+            if(n->size != 0 &&
+               ins_atomic_u64_eval(&n->working_count) == 0 &&
+               ins_atomic_u64_eval(&n->completion_count) != 0 &&
+               access_pt_is_expired(&n->access_pt, .time = 0))
+            {
+              ac_node_release(c->cache, slot, stripe, n);
+            }
+            break;
+          }
+        }
+      }
+    }
+  }
+  
+  scratch_end(scratch);
+  ProfEnd();
+}
+
 internal void
 ac_async_tick(void)
 {
@@ -252,13 +520,7 @@ ac_async_tick(void)
                   }
                   else
                   {
-                    DLLRemove(slot->first, slot->last, n);
-                    n->next = (AC_Node *)stripe->free;
-                    stripe->free = n;
-                    if(cache->destroy)
-                    {
-                      cache->destroy(n->val);
-                    }
+                    ac_node_release(cache, slot, stripe, n);
                   }
                 }
               }
@@ -273,6 +535,15 @@ ac_async_tick(void)
     }
   }
   
+  //////////////////////////////
+  //- evict down to the memory budget, if exceeded
+  //
+  lane_sync();
+  if(lane_idx() == 0)
+  {
+    ac_budget_evict();
+  }
+  
   //////////////////////////////
   //- rjf: gather requests
   //
@@ -281,8 +552,6 @@ ac_async_tick(void)
   {
     AC_Request *wide;
     U64 wide_count;
-    AC_Request *thin;
-    U64 thin_count;
   };
   RequestBatchTask *tasks = 0;
   U64 tasks_count = 0;
@@ -296,9 +565,7 @@ ac_async_tick(void)
       MutexScope(batch->mutex)
       {
         tasks[task_idx].wide_count = batch->wide_count;
-        tasks[task_idx].thin_count = batch->thin_count;
         tasks[task_idx].wide = push_array(scratch.arena, AC_Request, tasks[task_idx].wide_count);
-        tasks[task_idx].thin = push_array(scratch.arena, AC_Request, tasks[task_idx].thin_count);
         {
           U64 idx = 0;
           for EachNode(n, AC_RequestNode, batch->first_wide)
@@ -308,14 +575,9 @@ ac_async_tick(void)
             idx += 1;
           }
         }
+        for EachNode(n, AC_RequestNode, batch->first_thin)
         {
-          U64 idx = 0;
-          for EachNode(n, AC_RequestNode, batch->first_thin)
-          {
-            MemoryCopyStruct(&tasks[task_idx].thin[idx], &n->v);
-            tasks[task_idx].thin[idx].key = str8_copy(scratch.arena, tasks[task_idx].thin[idx].key);
-            idx += 1;
-          }
+          ac_thin_request_submit(&n->v, task_idx);
         }
         arena_clear(batch->arena);
         batch->first_wide = batch->last_wide = batch->first_thin = batch->last_thin = 0;
@@ -372,7 +634,10 @@ ac_async_tick(void)
         // rjf: compute val
         B32 retry = 0;
         U64 gen = r->gen;
-        AC_Artifact val = r->create(r->key, r->cancel_signal, &retry, &gen);
+        U64 size = 0;
+        U64 create_start_us = now_time_us();
+        AC_Artifact val = r->create(r->key, r->cancel_signal, &retry, &gen, &size);
+        U64 create_us = now_time_us() - create_start_us;
         
         // rjf: retry? -> resubmit request
         if(retry && lane_idx() == 0 && !ins_atomic_u32_eval(r->cancel_signal))
@@ -435,10 +700,7 @@ ac_async_tick(void)
                 }
                 
                 // rjf: write new value
-                n->last_completed_gen = gen;
-                n->val = val;
-                ins_atomic_u64_dec_eval(&n->working_count);
-                ins_atomic_u64_inc_eval(&n->completion_count);
+                ac_node_store(cache, n, val, gen, size, create_us);
               }
             }
           }
@@ -452,130 +714,10 @@ ac_async_tick(void)
     }
     lane_sync();
     
-    //- rjf: do all thin requests for this priority
-    U64 done_thin_count = 0;
-    ProfScope("thin requests (p%I64u)", task_idx)
-    {
-      U64 req_take_counter = 0;
-      U64 *req_take_counter_ptr = 0;
-      if(lane_idx() == 0)
-      {
-        req_take_counter_ptr = &req_take_counter;
-      }
-      lane_sync_u64(&req_take_counter_ptr, 0);
-      for(;;)
-      {
-        // rjf: any new higher priority tasks? -> cancel
-        if(task_idx == 1 && ins_atomic_u64_eval(req_take_counter_ptr) >= task->thin_count/2 &&
-           ins_atomic_u32_eval(&async_loop_again_high_priority))
-        {
-          ins_atomic_u64_eval_assign(cancelled_ptr, 1);
-        }
-        
-        // rjf: cancelled? -> exit
-        if(ins_atomic_u64_eval(cancelled_ptr))
-        {
-          break;
-        }
-        
-        // rjf: take next task
-        U64 req_idx = ins_atomic_u64_inc_eval(req_take_counter_ptr) - 1;
-        if(req_idx >= task->thin_count) { break; }
-        AC_Request *r = &task->thin[req_idx];
-        
-        // rjf: push thin lane ctx
-        U64 thin_lane_ctx_broadcast_memory = 0;
-        LaneCtx thin_lane_ctx = {0, 1, {0}, &thin_lane_ctx_broadcast_memory};
-        LaneCtx lane_ctx_restore = lane_ctx(thin_lane_ctx);
-        
-        // rjf: compute val
-        B32 retry = 0;
-        U64 gen = r->gen;
-        AC_Artifact val = r->create(r->key, r->cancel_signal, &retry, &gen);
-        
-        // rjf: restore wide lane ctx
-        lane_ctx(lane_ctx_restore);
-        
-        // rjf: retry? -> resubmit request
-        if(retry && !ins_atomic_u32_eval(r->cancel_signal))
-        {
-          AC_RequestBatch *batch = &ac_shared->req_batches[task_idx];
-          MutexScope(batch->mutex)
-          {
-            AC_RequestNode *n = push_array(batch->arena, AC_RequestNode, 1);
-            SLLQueuePush(batch->first_thin, batch->last_thin, n);
-            batch->thin_count += 1;
-            MemoryCopyStruct(&n->v, r);
-            n->v.key = str8_copy(batch->arena, n->v.key);
-          }
-          ins_atomic_u32_eval_assign(&async_loop_again, 1);
-        }
-        
-        // rjf: create function -> cache
-        AC_Cache *cache = 0;
-        if(!retry)
-        {
-          U64 cache_hash = u64_hash_from_str8(str8_struct(&r->create));
-          U64 cache_slot_idx = cache_hash%ac_shared->cache_slots_count;
-          Stripe *cache_stripe = stripe_from_slot_idx(&ac_shared->cache_stripes, cache_slot_idx);
-          RWMutexScope(cache_stripe->rw_mutex, 0)
-          {
-            for(AC_Cache *c = ac_shared->cache_slots[cache_slot_idx]; c != 0; c = c->next)
-            {
-              if(c->create == r->create)
-              {
-                cache = c;
-                break;
-              }
-            }
-          }
-        }
-        
-        // rjf: write value into cache
-        if(!retry)
-        {
-          U64 hash = u64_hash_from_str8(r->key);
-          U64 slot_idx = hash%cache->slots_count;
-          AC_Slot *slot = &cache->slots[slot_idx];
-          Stripe *stripe = stripe_from_slot_idx(&cache->stripes, slot_idx);
-          RWMutexScope(stripe->rw_mutex, 1)
-          {
-            for(AC_Node *n = slot->first; n != 0; n = n->next)
-            {
-              if(str8_match(n->key, r->key, 0))
-              {
-                // rjf: eliminate existing values, if any, if they do not match the current
-                if(cache->destroy != 0 && !MemoryMatchStruct(&n->val, &val) && ins_atomic_u64_eval(&n->completion_count) > 0) for(;;)
-                {
-                  if(access_pt_is_expired(&n->access_pt, .time = 0, .update_idxs = 0))
-                  {
-                    cache->destroy(n->val);
-                    MemoryZeroStruct(&n->val);
-                    break;
-                  }
-                  cond_var_wait_rw(stripe->cv, stripe->rw_mutex, 1, max_U64);
-                }
-                
-                // rjf: store
-                n->last_completed_gen = gen;
-                n->val = val;
-                ins_atomic_u64_dec_eval(&n->working_count);
-                ins_atomic_u64_inc_eval(&n->completion_count);
-              }
-            }
-          }
-          cond_var_broadcast(stripe->cv);
-        }
-      }
-      lane_sync();
-      done_thin_count = ins_atomic_u64_eval(req_take_counter_ptr);
-      lane_sync();
-    }
-    
     //- rjf: cancelled early, unfinished tasks? -> defer to next tick
     if(lane_idx() == 0 && task_idx > 0)
     {
-      B32 need_another_try = (done_wide_count < task->wide_count || done_thin_count < task->thin_count);
+      B32 need_another_try = (done_wide_count < task->wide_count);
       AC_RequestBatch *batch = &ac_shared->req_batches[task_idx];
       MutexScope(batch->mutex)
       {
@@ -589,17 +731,6 @@ ac_async_tick(void)
           MemoryCopyStruct(&n->v, r);
           n->v.key = str8_copy(batch->arena, n->v.key);
         }
-        
-        // rjf: push leftover thin tasks
-        for(U64 idx = done_thin_count; idx < task->thin_count; idx += 1)
-        {
-          AC_Request *r = &task->thin[idx];
-          AC_RequestNode *n = push_array(batch->arena, AC_RequestNode, 1);
-          SLLQueuePush(batch->first_thin, batch->last_thin, n);
-          batch->thin_count += 1;
-          MemoryCopyStruct(&n->v, r);
-          n->v.key = str8_copy(batch->arena, n->v.key);
-        }
       }
       if(need_another_try)
       {
@@ -610,6 +741,26 @@ ac_async_tick(void)
   }
   lane_sync();
   
+  //////////////////////////////
+  //- no thin workers? -> drain thin requests on the async lanes
+  //
+  if(ac_shared->thin_workers_count == 0) ProfScope("thin requests")
+  {
+    for(B32 done = 0; !done;)
+    {
+      Temp temp = temp_begin(scratch.arena);
+      AC_Request r = {0};
+      U64 priority = 0;
+      done = !ac_thin_request_take(temp.arena, 0, &r, &priority);
+      if(!done)
+      {
+        ac_thin_request_run(&r, priority);
+      }
+      temp_end(temp);
+    }
+  }
+  lane_sync();
+  
   //////////////////////////////
   //- rjf: disable cancellation scanning
   //
@@ -620,6 +771,240 @@ ac_async_tick(void)
   scratch_end(scratch);
 }
 
+////////////////////////////////
+//~ Thin Request Scheduler
+
+internal AC_ThinDeque *
+ac_thin_deque_from_idx(U64 deque_idx, U64 priority)
+{
+  AC_ThinDeque *deque = &ac_shared->thin_deques[(deque_idx%ac_shared->thin_deques_count)*2 + priority];
+  return deque;
+}
+
+internal void
+ac_thin_request_submit(AC_Request *request, U64 priority)
+{
+  U64 deque_idx = ins_atomic_u64_inc_eval(&ac_shared->thin_submit_counter);
+  AC_ThinDeque *deque = ac_thin_deque_from_idx(deque_idx, priority);
+  MutexScope(deque->mutex)
+  {
+    AC_RequestNode *n = push_array(deque->arena, AC_RequestNode, 1);
+    MemoryCopyStruct(&n->v, request);
+    n->v.key = str8_copy(deque->arena, request->key);
+    DLLPushBack(deque->first, deque->last, n);
+    deque->count += 1;
+  }
+  ins_atomic_u64_inc_eval(&ac_shared->thin_queued_count);
+  MutexScope(ac_shared->thin_wake_mutex)
+  {
+    cond_var_signal(ac_shared->thin_wake_cv);
+  }
+}
+
+internal B32
+ac_thin_request_take(Arena *arena, U64 deque_idx, AC_Request *request_out, U64 *priority_out)
+{
+  B32 result = 0;
+  for(U64 priority = 0; priority < 2 && !result; priority += 1)
+  {
+    for(U64 victim_num = 0; victim_num < ac_shared->thin_deques_count && !result; victim_num += 1)
+    {
+      // NOTE: own deque -> newest request first; stealing -> oldest first
+      B32 is_steal = (victim_num != 0);
+      AC_ThinDeque *deque = ac_thin_deque_from_idx(deque_idx + victim_num, priority);
+      MutexScope(deque->mutex)
+      {
+        AC_RequestNode *n = (is_steal ? deque->first : deque->last);
+        if(n != 0)
+        {
+          DLLRemove(deque->first, deque->last, n);
+          deque->count -= 1;
+          MemoryCopyStruct(request_out, &n->v);
+          request_out->key = str8_copy(arena, n->v.key);
+          if(deque->count == 0)
+          {
+            arena_clear(deque->arena);
+          }
+          result = 1;
+        }
+      }
+      if(result)
+      {
+        priority_out[0] = priority;
+        ins_atomic_u64_dec_eval(&ac_shared->thin_queued_count);
+        if(is_steal)
+        {
+          ins_atomic_u64_inc_eval(&ac_shared->thin_stats.steal_count);
+        }
+      }
+    }
+  }
+  return result;
+}
+
+internal void
+ac_thin_request_run(AC_Request *r, U64 priority)
+{
+  //- record queue latency
+  U64 start_us = now_time_us();
+  U64 queue_latency_us = start_us - Min(start_us, r->submit_us);
+  ins_atomic_u64_inc_eval(&ac_shared->thin_stats.run_count);
+  ins_atomic_u64_add_eval(&ac_shared->thin_stats.queue_latency_us, queue_latency_us);
+  for(U64 max_us = ins_atomic_u64_eval(&ac_shared->thin_stats.queue_latency_max_us);
+      max_us < queue_latency_us;
+      max_us = ins_atomic_u64_eval(&ac_shared->thin_stats.queue_latency_max_us))
+  {
+    if(ins_atomic_u64_eval_cond_assign(&ac_shared->thin_stats.queue_latency_max_us, queue_latency_us, max_us) == max_us)
+    {
+      break;
+    }
+  }
+  
+  //- push thin lane ctx
+  U64 thin_lane_ctx_broadcast_memory = 0;
+  LaneCtx thin_lane_ctx = {0, 1, {0}, &thin_lane_ctx_broadcast_memory};
+  LaneCtx lane_ctx_restore = lane_ctx(thin_lane_ctx);
+  
+  //- compute val
+  B32 retry = 0;
+  U64 gen = r->gen;
+  U64 size = 0;
+  AC_Artifact val = r->create(r->key, r->cancel_signal, &retry, &gen, &size);
+  U64 create_us = now_time_us() - start_us;
+  
+  //- restore lane ctx
+  lane_ctx(lane_ctx_restore);
+  
+  //- retry? -> resubmit request on the next async tick
+  if(retry && !ins_atomic_u32_eval(r->cancel_signal))
+  {
+    AC_RequestBatch *batch = &ac_shared->req_batches[priority];
+    MutexScope(batch->mutex)
+    {
+      AC_RequestNode *n = push_array(batch->arena, AC_RequestNode, 1);
+      SLLQueuePush(batch->first_thin, batch->last_thin, n);
+      batch->thin_count += 1;
+      MemoryCopyStruct(&n->v, r);
+      n->v.key = str8_copy(batch->arena, n->v.key);
+    }
+    ins_atomic_u32_eval_assign(&async_loop_again, 1);
+    cond_var_broadcast(async_tick_start_cond_var);
+  }
+  
+  //- create function -> cache
+  AC_Cache *cache = 0;
+  if(!retry)
+  {
+    U64 cache_hash = u64_hash_from_str8(str8_struct(&r->create));
+    U64 cache_slot_idx = cache_hash%ac_shared->cache_slots_count;
+    Stripe *cache_stripe = stripe_from_slot_idx(&ac_shared->cache_stripes, cache_slot_idx);
+    RWMutexScope(cache_stripe->rw_mutex, 0)
+    {
+      for(AC_Cache *c = ac_shared->cache_slots[cache_slot_idx]; c != 0; c = c->next)
+      {
+        if(c->create == r->create)
+        {
+          cache = c;
+          break;
+        }
+      }
+    }
+  }
+  
+  //- write value into cache
+  if(!retry)
+  {
+    U64 hash = u64_hash_from_str8(r->key);
+    U64 slot_idx = hash%cache->slots_count;
+    AC_Slot *slot = &cache->slots[slot_idx];
+    Stripe *stripe = stripe_from_slot_idx(&cache->stripes, slot_idx);
+    RWMutexScope(stripe->rw_mutex, 1)
+    {
+      for(AC_Node *n = slot->first; n != 0; n = n->next)
+      {
+        if(str8_match(n->key, r->key, 0))
+        {
+          // rjf: eliminate existing values, if any, if they do not match the current
+          if(cache->destroy != 0 && !MemoryMatchStruct(&n->val, &val) && ins_atomic_u64_eval(&n->completion_count) > 0) for(;;)
+          {
+            if(access_pt_is_expired(&n->access_pt, .time = 0, .update_idxs = 0))
+            {
+              cache->destroy(n->val);
+              MemoryZeroStruct(&n->val);
+              break;
+            }
+            cond_var_wait_rw(stripe->cv, stripe->rw_mutex, 1, max_U64);
+          }
+          
+          // rjf: store
+          ac_node_store(cache, n, val, gen, size, create_us);
+        }
+      }
+    }
+    cond_var_broadcast(stripe->cv);
+  }
+}
+
+internal void
+ac_thin_worker_thread_entry_point(void *p)
+{
+  U64 worker_idx = (U64)p;
+  ThreadNameF("ac_thin_worker_%I64u", worker_idx);
+  is_async_thread = 1;
+  for(;!ins_atomic_u32_eval(&global_async_exit);)
+  {
+    Temp scratch = scratch_begin(0, 0);
+    AC_Request r = {0};
+    U64 priority = 0;
+    if(ac_thin_request_take(scratch.arena, worker_idx, &r, &priority))
+    {
+      ins_atomic_u64_inc_eval(&ac_shared->thin_active_count);
+      ProfScope("thin request (p%I64u)", priority)
+      {
+        ac_thin_request_run(&r, priority);
+      }
+      ins_atomic_u64_dec_eval(&ac_shared->thin_active_count);
+    }
+    else MutexScope(ac_shared->thin_wake_mutex)
+    {
+      // NOTE: submitters & ac_thin_workers_join signal under this mutex, so
+      // checking both conditions here cannot miss a wakeup
+      if(ins_atomic_u64_eval(&ac_shared->thin_queued_count) == 0 && !ins_atomic_u32_eval(&global_async_exit))
+      {
+        cond_var_wait(ac_shared->thin_wake_cv, ac_shared->thin_wake_mutex, max_U64);
+      }
+    }
+    scratch_end(scratch);
+  }
+}
+
+internal void
+ac_thin_workers_join(void)
+{
+  if(ac_shared != 0)
+  {
+    MutexScope(ac_shared->thin_wake_mutex)
+    {
+      cond_var_broadcast(ac_shared->thin_wake_cv);
+    }
+    for EachIndex(idx, ac_shared->thin_workers_count)
+    {
+      thread_join(ac_shared->thin_workers[idx], max_U64);
+    }
+  }
+}
+
+internal AC_ThinStats
+ac_thin_stats(void)
+{
+  AC_ThinStats stats = {0};
+  stats.run_count            = ins_atomic_u64_eval(&ac_shared->thin_stats.run_count);
+  stats.steal_count          = ins_atomic_u64_eval(&ac_shared->thin_stats.steal_count);
+  stats.queue_latency_us     = ins_atomic_u64_eval(&ac_shared->thin_stats.queue_latency_us);
+  stats.queue_latency_max_us = ins_atomic_u64_eval(&ac_shared->thin_stats.queue_latency_max_us);
+  return stats;
+}
+
 ////////////////////////////////
 //~ rjf: Cancel Thread
 
@@ -628,8 +1013,14 @@ ac_cancel_thread_entry_point(void *p)
 {
   for(;;)
   {
+    // NOTE: scanning is enabled during async ticks, & whenever thin workers
+    // are busy, since thin requests now run outside of ticks
     sleep_ms(50);
-    semaphore_take(ac_shared->cancel_thread_semaphore, max_U64);
+    B32 tick_is_active = semaphore_take(ac_shared->cancel_thread_semaphore, now_time_us()+50000);
+    if(!tick_is_active && ins_atomic_u64_eval(&ac_shared->thin_active_count) == 0)
+    {
+      continue;
+    }
     {
       for EachIndex(cache_slot_idx, ac_shared->cache_slots_count)
       {
@@ -675,6 +1066,9 @@ ac_cancel_thread_entry_point(void *p)
         }
       }
     }
-    semaphore_drop(ac_shared->cancel_thread_semaphore);
+    if(tick_is_active)
+    {
+      semaphore_drop(ac_shared->cancel_thread_semaphore);
+    }
   }
 }
@@ -16,7 +16,9 @@ struct AC_Artifact
 ////////////////////////////////
 //~ rjf: Artifact Computation Function Types
 
-typedef AC_Artifact AC_CreateFunctionType(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out);
+// NOTE: `size_out` receives the # of bytes which the artifact keeps alive until
+// it is destroyed; artifacts which own no memory may leave it untouched (0).
+typedef AC_Artifact AC_CreateFunctionType(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out);
 typedef void AC_DestroyFunctionType(AC_Artifact artifact);
 
 typedef U32 AC_Flags;
@@ -25,6 +27,7 @@ typedef enum AC_FlagsEnum
   AC_Flag_WaitForFresh = (1<<0),
   AC_Flag_HighPriority = (1<<1),
   AC_Flag_Wide = (1<<2),
+  AC_Flag_NoRequest = (1<<3),
 }
 AC_FlagsEnum;
 
@@ -50,12 +53,14 @@ struct AC_Request
   U64 gen;
   B32 *cancel_signal;
   AC_CreateFunctionType *create;
+  U64 submit_us;
 };
 
 typedef struct AC_RequestNode AC_RequestNode;
 struct AC_RequestNode
 {
   AC_RequestNode *next;
+  AC_RequestNode *prev;
   AC_Request v;
 };
 
@@ -77,7 +82,8 @@ struct AC_Node
   U64 completion_count;
   U64 evict_threshold_us;
   B32 cancelled;
-  U64 _unused_;
+  U64 size;
+  U64 create_us;
 };
 
 typedef struct AC_Slot AC_Slot;
@@ -87,6 +93,16 @@ struct AC_Slot
   AC_Node *last;
 };
 
+typedef struct AC_CacheStats AC_CacheStats;
+struct AC_CacheStats
+{
+  U64 bytes;
+  U64 count;
+  U64 hits;
+  U64 misses;
+  U64 evictions;
+};
+
 typedef struct AC_Cache AC_Cache;
 struct AC_Cache
 {
@@ -99,6 +115,19 @@ struct AC_Cache
   U64 slots_count;
   AC_Slot *slots;
   StripeArray stripes;
+  
+  // stats
+  AC_CacheStats stats;
+};
+
+typedef struct AC_EvictCandidate AC_EvictCandidate;
+struct AC_EvictCandidate
+{
+  AC_EvictCandidate *next;
+  AC_Cache *cache;
+  U64 slot_idx;
+  AC_Node *node;
+  F64 score;
 };
 
 typedef struct AC_RequestBatch AC_RequestBatch;
@@ -114,6 +143,33 @@ struct AC_RequestBatch
   U64 thin_count;
 };
 
+////////////////////////////////
+//~ Thin Request Scheduler Types
+//
+// Thin requests are independent, so they don't need to wait on the lockstep
+// async lanes. Each thin worker thread owns one deque per priority; requests
+// are dealt round-robin into deques, the owner pops the newest request from
+// its own deque, & idle workers steal the oldest requests from other deques.
+
+typedef struct AC_ThinDeque AC_ThinDeque;
+struct AC_ThinDeque
+{
+  Mutex mutex;
+  Arena *arena;
+  AC_RequestNode *first;
+  AC_RequestNode *last;
+  U64 count;
+};
+
+typedef struct AC_ThinStats AC_ThinStats;
+struct AC_ThinStats
+{
+  U64 run_count;
+  U64 steal_count;
+  U64 queue_latency_us;
+  U64 queue_latency_max_us;
+};
+
 typedef struct AC_Shared AC_Shared;
 struct AC_Shared
 {
@@ -127,6 +183,22 @@ struct AC_Shared
   // rjf: requests
   AC_RequestBatch req_batches[2]; // 0: high priority, 1: low priority
   
+  // thin request scheduler
+  U64 thin_workers_count;
+  Thread *thin_workers;
+  U64 thin_deques_count;
+  AC_ThinDeque *thin_deques; // [thin_deques_count][2]
+  U64 thin_submit_counter;
+  U64 thin_queued_count;
+  U64 thin_active_count;
+  Mutex thin_wake_mutex;
+  CondVar thin_wake_cv;
+  AC_ThinStats thin_stats;
+  
+  // memory budget, across all caches
+  U64 budget_bytes;
+  U64 total_bytes;
+  
   // rjf: cancel thread
   Thread cancel_thread;
   Semaphore cancel_thread_semaphore;
@@ -140,7 +212,7 @@ global AC_Shared *ac_shared = 0;
 ////////////////////////////////
 //~ rjf: Layer Initialization
 
-internal void ac_init(void);
+internal void ac_init(CmdLine *cmdline);
 
 ////////////////////////////////
 //~ rjf: Cache Lookups
@@ -148,11 +220,35 @@ internal void ac_init(void);
 internal AC_Artifact ac_artifact_from_key_(Access *access, String8 key, AC_ArtifactParams *params, U64 endt_us);
 #define ac_artifact_from_key(access, key, create_fn, destroy_fn, endt_us, ...) ac_artifact_from_key_((access), (key), &(AC_ArtifactParams){.create = (create_fn), .destroy = (destroy_fn), .evict_threshold_us = (2000000), __VA_ARGS__}, (endt_us))
 
+////////////////////////////////
+//~ Cache Nodes
+
+internal void ac_node_release(AC_Cache *cache, AC_Slot *slot, Stripe *stripe, AC_Node *node);
+internal void ac_node_store(AC_Cache *cache, AC_Node *node, AC_Artifact val, U64 gen, U64 size, U64 create_us);
+
+////////////////////////////////
+//~ Stats
+
+internal AC_CacheStats ac_cache_stats_from_create(AC_CreateFunctionType *create);
+internal AC_CacheStats ac_total_stats(void);
+
 ////////////////////////////////
 //~ rjf: Asynchronous Tick
 
+internal void ac_budget_evict(void);
 internal void ac_async_tick(void);
 
+////////////////////////////////
+//~ Thin Request Scheduler
+
+internal AC_ThinDeque *ac_thin_deque_from_idx(U64 deque_idx, U64 priority);
+internal void ac_thin_request_submit(AC_Request *request, U64 priority);
+internal B32 ac_thin_request_take(Arena *arena, U64 deque_idx, AC_Request *request_out, U64 *priority_out);
+internal void ac_thin_request_run(AC_Request *request, U64 priority);
+internal void ac_thin_worker_thread_entry_point(void *p);
+internal void ac_thin_workers_join(void);
+internal AC_ThinStats ac_thin_stats(void);
+
 ////////////////////////////////
 //~ rjf: Cancel Thread
 
@@ -300,6 +300,17 @@
 # error Atomic intrinsics for pointers not defined for this architecture.
 #endif
 
+//- spin-wait hint
+#if COMPILER_MSVC && (ARCH_X64 || ARCH_X86)
+# define ins_pause() _mm_pause()
+#elif (COMPILER_CLANG || COMPILER_GCC) && (ARCH_X64 || ARCH_X86)
+# define ins_pause() __builtin_ia32_pause()
+#elif (COMPILER_CLANG || COMPILER_GCC) && ARCH_ARM64
+# define ins_pause() __asm__ volatile("yield")
+#else
+# define ins_pause() NoOp
+#endif
+
 ////////////////////////////////
 //~ rjf: Linked List Building Macros
 
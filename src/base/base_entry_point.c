@@ -9,6 +9,7 @@ global Mutex async_tick_stop_mutex = {0};
 global B32 async_loop_again = 0;
 global B32 async_loop_again_high_priority = 0;
 global B32 global_async_exit = 0;
+global AsyncTickStats global_async_tick_stats = {0};
 thread_static B32 is_async_thread = 0;
 
 // NOTE(rjf): defined by target
@@ -59,7 +60,7 @@ main_thread_base_entry_point(int arguments_count, char **arguments)
   
   //- rjf: initialize all included layers
 #if defined(ARTIFACT_CACHE_H) && !defined(AC_INIT_MANUAL)
-  ac_init();
+  ac_init(&cmdline);
 #endif
 #if defined(CONTENT_H) && !defined(C_INIT_MANUAL)
   c_init();
@@ -139,6 +140,9 @@ main_thread_base_entry_point(int arguments_count, char **arguments)
   {
     thread_join(async_threads[idx], max_U64);
   }
+#if defined(ARTIFACT_CACHE_H)
+  ac_thin_workers_join();
+#endif
 #endif
   
   //- rjf: end captures
@@ -202,6 +206,8 @@ async_thread_entry_point(void *params)
       ins_atomic_u32_eval_assign(&async_loop_again_high_priority, 0);
     }
     lane_sync();
+    U64 tick_begin_us = now_time_us();
+    U64 tick_begin_barrier_wait_us = tctx_selected()->lane_barrier_wait_us;
     
     // rjf: do all ticks for all layers
     ProfScope("async tick")
@@ -222,6 +228,12 @@ async_thread_entry_point(void *params)
     
     // rjf: take exit signal; break if set
     lane_sync();
+    ins_atomic_u64_add_eval(&global_async_tick_stats.lane_us, now_time_us() - tick_begin_us);
+    ins_atomic_u64_add_eval(&global_async_tick_stats.lane_barrier_wait_us, tctx_selected()->lane_barrier_wait_us - tick_begin_barrier_wait_us);
+    if(lane_idx() == 0)
+    {
+      ins_atomic_u64_inc_eval(&global_async_tick_stats.tick_count);
+    }
     B32 need_exit = 0;
     if(lane_idx() == 0)
     {
@@ -234,3 +246,13 @@ async_thread_entry_point(void *params)
     }
   }
 }
+
+internal AsyncTickStats
+async_tick_stats(void)
+{
+  AsyncTickStats stats = {0};
+  stats.tick_count           = ins_atomic_u64_eval(&global_async_tick_stats.tick_count);
+  stats.lane_us              = ins_atomic_u64_eval(&global_async_tick_stats.lane_us);
+  stats.lane_barrier_wait_us = ins_atomic_u64_eval(&global_async_tick_stats.lane_barrier_wait_us);
+  return stats;
+}
@@ -4,10 +4,19 @@
 #ifndef BASE_ENTRY_POINT_H
 #define BASE_ENTRY_POINT_H
 
+typedef struct AsyncTickStats AsyncTickStats;
+struct AsyncTickStats
+{
+  U64 tick_count;
+  U64 lane_us;              // sum of all lanes' time spent in async ticks
+  U64 lane_barrier_wait_us; // portion of lane_us spent waiting at lane barriers
+};
+
 internal void main_thread_base_entry_point(int argc, char **argv);
 internal void supplement_thread_base_entry_point(void (*entry_point)(void *params), void *params);
 internal U64 update_tick_idx(void);
 internal B32 update(void);
 internal void async_thread_entry_point(void *params);
+internal AsyncTickStats async_tick_stats(void);
 
 #endif // BASE_ENTRY_POINT_H
@@ -46,6 +46,20 @@ struct FileMap
   U64 u64[1];
 };
 
+typedef struct FileWatcher FileWatcher;
+struct FileWatcher
+{
+  U64 u64[1];
+};
+
+typedef struct FileWatchChanges FileWatchChanges;
+struct FileWatchChanges
+{
+  String8List paths;           // watched paths which may have changed (may repeat)
+  String8List unwatched_paths; // paths which are no longer watched; callers must poll them
+  B32 lost_changes;            // changes were dropped; any watched path may have changed
+};
+
 ////////////////////////////////
 //~ rjf: Handle Type Functions
 
@@ -99,4 +113,12 @@ internal void file_iter_end(FileIter *iter);
 //- rjf: directory creation
 internal B32 make_directory(String8 path);
 
+//- file change watching (Linux only; elsewhere, callers must poll)
+#if OS_LINUX
+internal FileWatcher      file_watcher_alloc(void);
+internal void             file_watcher_release(FileWatcher watcher);
+internal B32              file_watcher_add_path(FileWatcher watcher, String8 path);
+internal FileWatchChanges file_watcher_pop_changes(Arena *arena, FileWatcher watcher);
+#endif
+
 #endif // BASE_FILES_H
@@ -108,6 +108,7 @@ tctx_lane_barrier_wait(void *broadcast_ptr, U64 broadcast_size, U64 broadcast_sr
   }
   
   // rjf: all cases: barrier
+  U64 wait_begin_us = now_time_us();
   barrier_wait(tctx->lane_ctx.barrier);
   
   // rjf: doing broadcast -> copy from broadcast memory on destination lanes
@@ -122,6 +123,10 @@ tctx_lane_barrier_wait(void *broadcast_ptr, U64 broadcast_size, U64 broadcast_sr
     barrier_wait(tctx->lane_ctx.barrier);
   }
   
+  // record time spent waiting on other lanes
+  tctx->lane_barrier_wait_us += now_time_us() - wait_begin_us;
+  tctx->lane_barrier_wait_count += 1;
+  
   ProfEnd();
 }
 
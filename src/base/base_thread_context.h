@@ -64,6 +64,8 @@ struct TCTX
   
   // rjf: lane context
   LaneCtx lane_ctx;
+  U64 lane_barrier_wait_us;
+  U64 lane_barrier_wait_count;
   
   // rjf: source location info
   char *file_name;
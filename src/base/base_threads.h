@@ -91,6 +91,7 @@ internal void set_platform_thread_name(String8 name);
 internal Thread thread_launch(ThreadEntryPointFunctionType *f, void *p);
 internal B32 thread_join(Thread thread, U64 endt_us);
 internal void thread_detach(Thread thread);
+internal void thread_yield(void);
 
 ////////////////////////////////
 //~ rjf: @per_os_impl Synchronization Primitive Functions
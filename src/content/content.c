@@ -167,6 +167,7 @@ c_submit_data(C_Key key, Arena **data_arena, String8 data)
   
   //- rjf: hash data, unpack hash
   U128 hash = u128_hash_from_str8(data);
+  U128 prev_hash = c_hash_from_key(key, 0);
   U64 slot_idx = hash.u64[1]%c_shared->blob_slots_count;
   U64 stripe_idx = slot_idx%c_shared->blob_stripes_count;
   C_BlobSlot *slot = &c_shared->blob_slots[slot_idx];
@@ -214,6 +215,13 @@ c_submit_data(C_Key key, Arena **data_arena, String8 data)
       DLLPushBack(slot->first, slot->last, node);
     }
     
+    // NOTE: record which blob this key held before this one, so that data
+    // derived from the previous blob can be updated, rather than rebuilt
+    if(!u128_match(prev_hash, u128_zero()) && !u128_match(prev_hash, hash))
+    {
+      node->prev_hash = prev_hash;
+    }
+    
     // rjf: bump key ref count
     node->key_ref_count += 1;
     
@@ -440,6 +448,28 @@ c_hash_from_key(C_Key key, U64 rewind_count)
   return result;
 }
 
+internal U128
+c_prev_hash_from_hash(U128 hash)
+{
+  U128 result = {0};
+  U64 slot_idx = hash.u64[1]%c_shared->blob_slots_count;
+  U64 stripe_idx = slot_idx%c_shared->blob_stripes_count;
+  C_BlobSlot *slot = &c_shared->blob_slots[slot_idx];
+  C_Stripe *stripe = &c_shared->blob_stripes[stripe_idx];
+  MutexScopeR(stripe->rw_mutex)
+  {
+    for(C_BlobNode *n = slot->first; n != 0; n = n->next)
+    {
+      if(u128_match(n->hash, hash))
+      {
+        result = n->prev_hash;
+        break;
+      }
+    }
+  }
+  return result;
+}
+
 internal String8
 c_data_from_hash(Access *access, U128 hash)
 {
@@ -144,6 +144,7 @@ struct C_BlobNode
   C_BlobNode *next;
   C_BlobNode *prev;
   U128 hash;
+  U128 prev_hash;
   Arena *arena;
   String8 data;
   AccessPt access_pt;
@@ -233,6 +234,7 @@ internal void c_hash_downstream_dec(U128 hash);
 //~ rjf: Cache Lookups
 
 internal U128 c_hash_from_key(C_Key key, U64 rewind_count);
+internal U128 c_prev_hash_from_hash(U128 hash);
 internal String8 c_data_from_hash(Access *access, U128 hash);
 
 ////////////////////////////////
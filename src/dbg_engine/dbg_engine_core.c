@@ -37,6 +37,15 @@ d_init(void)
       d_ctrl_state->thread_reg_cache.stripes[idx].arena = arena_alloc();
       d_ctrl_state->thread_reg_cache.stripes[idx].rw_mutex = rw_mutex_alloc();
     }
+    d_ctrl_state->unwind_cache.slots_count = 1024;
+    d_ctrl_state->unwind_cache.slots = push_array(arena, D_UnwindCacheSlot, d_ctrl_state->unwind_cache.slots_count);
+    d_ctrl_state->unwind_cache.stripes_count = get_system_info()->logical_processor_count;
+    d_ctrl_state->unwind_cache.stripes = push_array(arena, D_UnwindCacheStripe, d_ctrl_state->unwind_cache.stripes_count);
+    for(U64 idx = 0; idx < d_ctrl_state->unwind_cache.stripes_count; idx += 1)
+    {
+      d_ctrl_state->unwind_cache.stripes[idx].arena = arena_alloc();
+      d_ctrl_state->unwind_cache.stripes[idx].rw_mutex = rw_mutex_alloc();
+    }
     d_ctrl_state->module_image_info_cache.slots_count = 1024;
     d_ctrl_state->module_image_info_cache.slots = push_array(arena, D_ModuleImageInfoCacheSlot, d_ctrl_state->module_image_info_cache.slots_count);
     d_ctrl_state->module_image_info_cache.stripes_count = get_system_info()->logical_processor_count;
@@ -68,6 +77,7 @@ d_init(void)
     d_ctrl_state->ctrl_thread_entity_store = d_entity_ctx_rw_store_alloc();
     d_ctrl_state->ctrl_thread_eval_cache = e_cache_alloc();
     d_ctrl_state->ctrl_thread_msg_process_arena = arena_alloc();
+    d_ctrl_state->cond_bytecode_cache = d_cond_bytecode_cache_alloc();
     d_ctrl_state->dmn_event_arena = arena_alloc();
     d_ctrl_state->user_entry_point_arena = arena_alloc();
     d_ctrl_state->dbg_dir_arena = arena_alloc();
@@ -110,6 +120,7 @@ d_init(void)
     {
       d_user_state->member_caches[idx].arena = arena_alloc();
     }
+    d_user_state->trap_net_cache = d_trap_net_cache_alloc();
     
     // rjf: set up run state
     d_user_state->ctrl_last_run_arena = arena_alloc();
@@ -66,7 +66,9 @@ enum
   D_BreakpointFlag_BreakOnWrite   = (1<<0),
   D_BreakpointFlag_BreakOnRead    = (1<<1),
   D_BreakpointFlag_BreakOnExecute = (1<<2),
+  D_BreakpointFlag_InProcessCondition = (1<<3),
 };
+#define D_BreakpointFlags_Hardware (D_BreakpointFlag_BreakOnWrite|D_BreakpointFlag_BreakOnRead|D_BreakpointFlag_BreakOnExecute)
 
 typedef struct D_Breakpoint D_Breakpoint;
 struct D_Breakpoint
@@ -1859,6 +1859,178 @@ d_raddbg_data_from_module(Arena *arena, D_Handle module_handle)
   return result;
 }
 
+////////////////////////////////
+//~ Dump Memory Functions
+
+internal int
+d_dump_memory_range_sort_key_compare(D_DumpMemoryRangeSortKey *a, D_DumpMemoryRangeSortKey *b)
+{
+  int result = (a->base_vaddr < b->base_vaddr ? -1 :
+                a->base_vaddr > b->base_vaddr ? +1 :
+                a->idx < b->idx ? -1 :
+                a->idx > b->idx ? +1 :
+                0);
+  return result;
+}
+
+internal D_DumpMemoryRange *
+d_dump_memory_ranges_sort_coalesce(Arena *arena, D_DumpMemoryRange *ranges, U64 ranges_count, U64 *count_out)
+{
+  ProfBeginFunction();
+  Temp scratch = scratch_begin(&arena, 1);
+  
+  //- sort range indices by (base_vaddr, dump order)
+  D_DumpMemoryRangeSortKey *keys = push_array_no_zero(scratch.arena, D_DumpMemoryRangeSortKey, ranges_count);
+  for EachIndex(idx, ranges_count)
+  {
+    keys[idx].base_vaddr = ranges[idx].base_vaddr;
+    keys[idx].idx = idx;
+  }
+  quick_sort(keys, ranges_count, sizeof(keys[0]), d_dump_memory_range_sort_key_compare);
+  
+  //- sweep the address space; where ranges overlap, the last one in dump
+  // order wins. every piece ends at a range's start or end, so there are at
+  // most 2x as many pieces as ranges.
+  U64 *active_idxs = push_array_no_zero(scratch.arena, U64, ranges_count);
+  U64 active_count = 0;
+  D_DumpMemoryRange *pieces = push_array_no_zero(scratch.arena, D_DumpMemoryRange, ranges_count*2);
+  U64 pieces_count = 0;
+  U64 vaddr = 0;
+  for(U64 key_idx = 0; key_idx < ranges_count || active_count != 0;)
+  {
+    // jump over unmapped gaps; begin every range which starts here
+    if(active_count == 0)
+    {
+      vaddr = keys[key_idx].base_vaddr;
+    }
+    for(;key_idx < ranges_count && keys[key_idx].base_vaddr == vaddr; key_idx += 1)
+    {
+      if(dim_1u64(ranges[keys[key_idx].idx].foff_range) != 0)
+      {
+        active_idxs[active_count] = keys[key_idx].idx;
+        active_count += 1;
+      }
+    }
+    U64 next_begin_vaddr = (key_idx < ranges_count ? keys[key_idx].base_vaddr : max_U64);
+    
+    // drop ranges which ended; pick the winner of the rest
+    U64 winner_idx = 0;
+    for(U64 active_num = 0; active_num < active_count;)
+    {
+      D_DumpMemoryRange *r = &ranges[active_idxs[active_num]];
+      if(r->base_vaddr + dim_1u64(r->foff_range) <= vaddr)
+      {
+        active_idxs[active_num] = active_idxs[active_count-1];
+        active_count -= 1;
+        continue;
+      }
+      if(active_num == 0 || active_idxs[active_num] > winner_idx)
+      {
+        winner_idx = active_idxs[active_num];
+      }
+      active_num += 1;
+    }
+    if(active_count == 0)
+    {
+      continue;
+    }
+    
+    // emit the winner up to its end, or the next range's start; extend the
+    // previous piece if this one continues it, both in the address space & in
+    // the file
+    D_DumpMemoryRange *winner = &ranges[winner_idx];
+    U64 piece_vaddr_opl = Min(winner->base_vaddr + dim_1u64(winner->foff_range), next_begin_vaddr);
+    Rng1U64 piece_foff_range = r1u64(winner->foff_range.min + (vaddr - winner->base_vaddr),
+                                     winner->foff_range.min + (piece_vaddr_opl - winner->base_vaddr));
+    D_DumpMemoryRange *last = (pieces_count != 0 ? &pieces[pieces_count-1] : 0);
+    if(last != 0 && last->base_vaddr + dim_1u64(last->foff_range) == vaddr && last->foff_range.max == piece_foff_range.min)
+    {
+      last->foff_range.max = piece_foff_range.max;
+    }
+    else
+    {
+      pieces[pieces_count].base_vaddr = vaddr;
+      pieces[pieces_count].foff_range = piece_foff_range;
+      pieces_count += 1;
+    }
+    vaddr = piece_vaddr_opl;
+  }
+  
+  //- copy the table out
+  D_DumpMemoryRange *result = push_array_no_zero(arena, D_DumpMemoryRange, pieces_count);
+  MemoryCopy(result, pieces, sizeof(pieces[0])*pieces_count);
+  *count_out = pieces_count;
+  scratch_end(scratch);
+  ProfEnd();
+  return result;
+}
+
+internal U64
+d_dump_memory_range_idx_from_vaddr(D_DumpMemoryRange *ranges, U64 ranges_count, U64 vaddr)
+{
+  // NOTE: returns the first range which ends after `vaddr` (which contains
+  // `vaddr`, if it is mapped at all), or `ranges_count` if there is none
+  U64 lo = 0;
+  U64 hi = ranges_count;
+  for(;lo < hi;)
+  {
+    U64 mid = lo + (hi-lo)/2;
+    if(ranges[mid].base_vaddr + dim_1u64(ranges[mid].foff_range) <= vaddr)
+    {
+      lo = mid+1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+internal String8
+d_dump_data_from_vaddr_range(String8 dump_data, D_DumpMemoryRange *ranges, U64 ranges_count, Rng1U64 vaddr_range)
+{
+  String8 result = {0};
+  U64 idx = d_dump_memory_range_idx_from_vaddr(ranges, ranges_count, vaddr_range.min);
+  if(idx < ranges_count && ranges[idx].base_vaddr <= vaddr_range.min && vaddr_range.min < vaddr_range.max)
+  {
+    D_DumpMemoryRange *r = &ranges[idx];
+    U64 vaddr_opl = Min(vaddr_range.max, r->base_vaddr + dim_1u64(r->foff_range));
+    U64 foff = r->foff_range.min + (vaddr_range.min - r->base_vaddr);
+    result = str8_substr(dump_data, r1u64(foff, foff + (vaddr_opl - vaddr_range.min)));
+  }
+  return result;
+}
+
+internal U64
+d_dump_memory_read(String8 dump_data, D_DumpMemoryRange *ranges, U64 ranges_count, Rng1U64 vaddr_range, void *dst)
+{
+  // NOTE: bytes which are not in the dump are left untouched; a read which
+  // touches any byte in the dump reports the whole range as read
+  B32 range_found = 0;
+  for(U64 vaddr = vaddr_range.min; vaddr < vaddr_range.max;)
+  {
+    String8 data = d_dump_data_from_vaddr_range(dump_data, ranges, ranges_count, r1u64(vaddr, vaddr_range.max));
+    if(data.size != 0)
+    {
+      MemoryCopy((U8 *)dst + (vaddr - vaddr_range.min), data.str, data.size);
+      range_found = 1;
+      vaddr += data.size;
+    }
+    else
+    {
+      U64 next_idx = d_dump_memory_range_idx_from_vaddr(ranges, ranges_count, vaddr);
+      if(next_idx >= ranges_count || ranges[next_idx].base_vaddr <= vaddr)
+      {
+        break;
+      }
+      vaddr = ranges[next_idx].base_vaddr;
+    }
+  }
+  U64 result = (range_found ? dim_1u64(vaddr_range) : 0);
+  return result;
+}
+
 ////////////////////////////////
 //~ rjf: Unwinding Functions
 
@@ -1926,23 +2098,21 @@ d_establish_frame_unwind_context__dwarf(Arena *arena, D_Handle process_handle, D
   String8     unwind_data  = {0};
   EH_FrameHdr eh_frame_hdr = {0};
   EH_PtrCtx   eh_ptr_ctx   = {0};
+  U64 hash = d_hash_from_handle(module_handle);
+  U64 slot_idx = hash%d_ctrl_state->module_image_info_cache.slots_count;
+  U64 stripe_idx = slot_idx%d_ctrl_state->module_image_info_cache.stripes_count;
+  D_ModuleImageInfoCacheSlot *slot = &d_ctrl_state->module_image_info_cache.slots[slot_idx];
+  D_ModuleImageInfoCacheStripe *stripe = &d_ctrl_state->module_image_info_cache.stripes[stripe_idx];
+  MutexScopeR(stripe->rw_mutex) for EachNode(n, D_ModuleImageInfoCacheNode, slot->first)
   {
-    U64 hash = d_hash_from_handle(module_handle);
-    U64 slot_idx = hash%d_ctrl_state->module_image_info_cache.slots_count;
-    U64 stripe_idx = slot_idx%d_ctrl_state->module_image_info_cache.stripes_count;
-    D_ModuleImageInfoCacheSlot *slot = &d_ctrl_state->module_image_info_cache.slots[slot_idx];
-    D_ModuleImageInfoCacheStripe *stripe = &d_ctrl_state->module_image_info_cache.stripes[stripe_idx];
-    MutexScopeR(stripe->rw_mutex) for EachNode(n, D_ModuleImageInfoCacheNode, slot->first)
+    if(d_handle_match(n->module, module_handle))
     {
-      if(d_handle_match(n->module, module_handle))
-      {
-        cfi_rebase   = n->cfi_rebase;
-        is_unwind_eh = n->is_unwind_eh;
-        unwind_data  = n->dwarf_unwind_data;
-        eh_frame_hdr = n->eh_frame_hdr;
-        eh_ptr_ctx   = n->eh_ptr_ctx;
-        break;
-      }
+      cfi_rebase   = n->cfi_rebase;
+      is_unwind_eh = n->is_unwind_eh;
+      unwind_data  = n->dwarf_unwind_data;
+      eh_frame_hdr = n->eh_frame_hdr;
+      eh_ptr_ctx   = n->eh_ptr_ctx;
+      break;
     }
   }
   
@@ -1952,7 +2122,37 @@ d_establish_frame_unwind_context__dwarf(Arena *arena, D_Handle process_handle, D
   // use .eh_frame_hdr to quickly locate nearest FDE
   U64 fde_addr = eh_find_nearest_fde(eh_frame_hdr, &eh_ptr_ctx, ip);
   
-  if(fde_addr != max_U64)
+  // look for the FDE's rows in the module's CFI row tables, built by earlier
+  // unwinds; these live until the module is unloaded
+  U64         reg_count          = dw_reg_count_from_arch(arch);
+  U64         cfi_row_table_slot = u64_hash_from_str8(str8_struct(&fde_addr))%D_CFI_ROW_TABLE_SLOTS_COUNT;
+  B32         is_row_table_found = 0;
+  DW_CFI_Row *cfi_row            = 0;
+  U64         ret_addr_reg       = 0;
+  if(fde_addr != max_U64) MutexScopeR(stripe->rw_mutex) for EachNode(n, D_ModuleImageInfoCacheNode, slot->first)
+  {
+    if(d_handle_match(n->module, module_handle))
+    {
+      for EachNode(t, D_CFIRowTableNode, n->cfi_row_table_slots[cfi_row_table_slot])
+      {
+        if(t->fde_addr == fde_addr)
+        {
+          DW_CFI_Row *row = dw_cfi_row_from_row_table(&t->table, ip);
+          if(row != 0)
+          {
+            cfi_row = dw_copy_cfi_row_deep(arena, row, reg_count);
+            ret_addr_reg = t->ret_addr_reg;
+          }
+          is_row_table_found = 1;
+          break;
+        }
+      }
+      break;
+    }
+  }
+  
+  // no row table for this FDE? -> parse its CIE & FDE, & build one
+  if(fde_addr != max_U64 && !is_row_table_found)
   {
     // parse call frame info
     DW_CIE cie           = {0};
@@ -2061,51 +2261,87 @@ d_establish_frame_unwind_context__dwarf(Arena *arena, D_Handle process_handle, D
         decode_ptr_ctx  = &cie;
       }
       
-      // find register rules for IP
-      DW_CFI_Row *cfi_row = dw_cfi_row_from_pc(arena, arch, &cie, &fde, decode_ptr_func, decode_ptr_ctx, ip);
-      if(cfi_row)
+      // find register rules for IP; build & store a row table for the FDE,
+      // unless its data may be stale
+      ret_addr_reg = cie.ret_addr_reg;
+      if(result.flags & D_UnwindFlag_Stale)
       {
-        // setup machine ops
-        void *mem_read_ctx  = 0;
-        MachineOp_MemRead *mem_read_func  = 0;
-        switch(arch)
+        cfi_row = dw_cfi_row_from_pc(arena, arch, &cie, &fde, decode_ptr_func, decode_ptr_ctx, ip);
+      }
+      else MutexScopeW(stripe->rw_mutex) for EachNode(n, D_ModuleImageInfoCacheNode, slot->first)
+      {
+        if(d_handle_match(n->module, module_handle))
         {
-          case Arch_Null: break;
-          case Arch_x64:
+          D_CFIRowTableNode *table_node = 0;
+          for EachNode(t, D_CFIRowTableNode, n->cfi_row_table_slots[cfi_row_table_slot])
           {
-            D_MemoryReadContextDwarfX64 *mem_read_ctx_x64 = push_array(scratch.arena, D_MemoryReadContextDwarfX64, 1);
-            mem_read_ctx_x64->process_handle = process_handle;
-            mem_read_ctx_x64->endt_us        = endt_us;
-            mem_read_ctx = mem_read_ctx_x64;
-            mem_read_func = ctrl_machine_mem_read;
-          }break;
-          case Arch_x86:
-          case Arch_arm64:
-          case Arch_arm32:
+            if(t->fde_addr == fde_addr)
+            {
+              table_node = t;
+              break;
+            }
+          }
+          if(table_node == 0)
           {
-            NotImplemented;
-          }break;
-          default: { InvalidPath; }break;
-        }
-        
-        // compute CFA for the row
-        U64 cfa = 0;
-        MachineOpResult unwind_status = dw_compute_cfa(arch, cfi_row, regs, mem_read_func, mem_read_ctx, &cfa);
-        
-        // on success fill out output
-        if(unwind_status == MachineOpResult_Ok)
-        {
-          ctx_out->cfa          = cfa;
-          ctx_out->cfi_row      = cfi_row;
-          ctx_out->ret_addr_reg = cie.ret_addr_reg;
+            table_node = push_array(n->arena, D_CFIRowTableNode, 1);
+            table_node->fde_addr     = fde_addr;
+            table_node->ret_addr_reg = cie.ret_addr_reg;
+            table_node->table        = dw_cfi_row_table_from_fde(n->arena, arch, &cie, &fde, decode_ptr_func, decode_ptr_ctx);
+            SLLStackPush(n->cfi_row_table_slots[cfi_row_table_slot], table_node);
+          }
+          DW_CFI_Row *row = dw_cfi_row_from_row_table(&table_node->table, ip);
+          if(row != 0)
+          {
+            cfi_row = dw_copy_cfi_row_deep(arena, row, reg_count);
+          }
+          break;
         }
-        
-        // translate unwind status code
-        result = d_unwind_step_result_from_machine_op_result(unwind_status);
       }
     }
   }
   
+  // compute the CFA
+  if(cfi_row)
+  {
+    // setup machine ops
+    void *mem_read_ctx  = 0;
+    MachineOp_MemRead *mem_read_func  = 0;
+    switch(arch)
+    {
+      case Arch_Null: break;
+      case Arch_x64:
+      {
+        D_MemoryReadContextDwarfX64 *mem_read_ctx_x64 = push_array(scratch.arena, D_MemoryReadContextDwarfX64, 1);
+        mem_read_ctx_x64->process_handle = process_handle;
+        mem_read_ctx_x64->endt_us        = endt_us;
+        mem_read_ctx = mem_read_ctx_x64;
+        mem_read_func = ctrl_machine_mem_read;
+      }break;
+      case Arch_x86:
+      case Arch_arm64:
+      case Arch_arm32:
+      {
+        NotImplemented;
+      }break;
+      default: { InvalidPath; }break;
+    }
+    
+    // compute CFA for the row
+    U64 cfa = 0;
+    MachineOpResult unwind_status = dw_compute_cfa(arch, cfi_row, regs, mem_read_func, mem_read_ctx, &cfa);
+    
+    // on success fill out output
+    if(unwind_status == MachineOpResult_Ok)
+    {
+      ctx_out->cfa          = cfa;
+      ctx_out->cfi_row      = cfi_row;
+      ctx_out->ret_addr_reg = ret_addr_reg;
+    }
+    
+    // translate unwind status code
+    result = d_unwind_step_result_from_machine_op_result(unwind_status);
+  }
+  
   scratch_end(scratch);
   return result;
 }
@@ -2997,6 +3233,240 @@ d_unwind_step__pe_x64(D_Handle process_handle, D_Handle module_handle, U64 modul
   return result;
 }
 
+//- rjf: stack snapshots
+
+internal D_UnwindStackSnapshot
+d_unwind_stack_snapshot_from_process_sp(Arena *arena, D_Handle process, U64 sp)
+{
+  U64 page_size = KB(4);
+  U64 page_count = D_UNWIND_STACK_SNAPSHOT_SIZE/page_size;
+  D_UnwindStackSnapshot snapshot = {0};
+  snapshot.process = process;
+  snapshot.vaddr_range = r1u64(AlignDownPow2(sp, page_size), AlignDownPow2(sp, page_size) + D_UNWIND_STACK_SNAPSHOT_SIZE);
+  snapshot.data = push_array_no_zero(arena, U8, D_UNWIND_STACK_SNAPSHOT_SIZE);
+  snapshot.page_read_sizes = push_array(arena, U64, page_count);
+  if(snapshot.vaddr_range.max > snapshot.vaddr_range.min)
+  {
+    d_unwind_stack_snapshot_read_pages(&snapshot, D_UNWIND_STACK_SNAPSHOT_INITIAL_SIZE/page_size);
+  }
+  return snapshot;
+}
+
+internal void
+d_unwind_stack_snapshot_read_pages(D_UnwindStackSnapshot *snapshot, U64 page_count)
+{
+  U64 page_size = KB(4);
+  U64 first_page_idx = snapshot->page_read_count;
+  U64 opl_page_idx = Min(page_count, D_UNWIND_STACK_SNAPSHOT_SIZE/page_size);
+  if(first_page_idx < opl_page_idx)
+  {
+    Temp scratch = scratch_begin(0, 0);
+    U64 read_count = opl_page_idx - first_page_idx;
+    Rng1U64 *ranges = push_array(scratch.arena, Rng1U64, read_count);
+    void **dsts = push_array(scratch.arena, void *, read_count);
+    for EachIndex(idx, read_count)
+    {
+      U64 page_idx = first_page_idx + idx;
+      ranges[idx] = r1u64(snapshot->vaddr_range.min + page_idx*page_size, snapshot->vaddr_range.min + (page_idx+1)*page_size);
+      dsts[idx] = snapshot->data + page_idx*page_size;
+    }
+    d_process_read_many(snapshot->process, read_count, ranges, dsts, snapshot->page_read_sizes + first_page_idx);
+    snapshot->page_read_count = opl_page_idx;
+    scratch_end(scratch);
+  }
+}
+
+internal B32
+d_unwind_stack_snapshot_read(D_UnwindStackSnapshot *snapshot, D_Handle process, Rng1U64 range, void *out)
+{
+  B32 result = 0;
+  U64 page_size = KB(4);
+  if(snapshot != 0 && snapshot->data != 0 && d_handle_match(snapshot->process, process) &&
+     snapshot->vaddr_range.min <= range.min && range.min < range.max && range.max <= snapshot->vaddr_range.max)
+  {
+    result = 1;
+    U64 first_page_idx = (range.min - snapshot->vaddr_range.min)/page_size;
+    U64 opl_page_idx = (range.max - snapshot->vaddr_range.min + page_size-1)/page_size;
+    if(opl_page_idx > snapshot->page_read_count)
+    {
+      d_unwind_stack_snapshot_read_pages(snapshot, Max(opl_page_idx, snapshot->page_read_count*2));
+    }
+    for(U64 page_idx = first_page_idx; page_idx < opl_page_idx; page_idx += 1)
+    {
+      if(snapshot->page_read_sizes[page_idx] != page_size)
+      {
+        result = 0;
+        break;
+      }
+    }
+    if(result)
+    {
+      MemoryCopy(out, snapshot->data + (range.min - snapshot->vaddr_range.min), dim_1u64(range));
+    }
+  }
+  return result;
+}
+
+//- unwind cache
+
+internal U128
+d_unwind_cache_hash_from_inputs(D_Handle process, void *regs, U64 reg_block_size, Rng1U64 stack_read_vaddr_range, B32 *good_out)
+{
+  Temp scratch = scratch_begin(0, 0);
+  U64 stack_read_size = dim_1u64(stack_read_vaddr_range);
+  U8 *stack_data = push_array_no_zero(scratch.arena, U8, stack_read_size);
+  B32 good = (d_process_read(process, stack_read_vaddr_range, stack_data) == stack_read_size);
+  U64 regs_hash = u64_hash_from_str8(str8((U8 *)regs, reg_block_size));
+  U128 result = u128_hash_from_seed_str8(regs_hash, str8(stack_data, stack_read_size));
+  good_out[0] = good;
+  scratch_end(scratch);
+  return result;
+}
+
+internal B32
+d_unwind_cache_lookup(Arena *arena, D_Handle thread, D_Handle process, void *regs, U64 reg_block_size, U64 module_gen, D_Unwind *unwind_out)
+{
+  D_UnwindCache *cache = &d_ctrl_state->unwind_cache;
+  U64 hash = d_hash_from_handle(thread);
+  U64 slot_idx = hash%cache->slots_count;
+  U64 stripe_idx = slot_idx%cache->stripes_count;
+  D_UnwindCacheSlot *slot = &cache->slots[slot_idx];
+  D_UnwindCacheStripe *stripe = &cache->stripes[stripe_idx];
+  
+  //- find the thread's last unwind, & the stack memory which it read
+  B32 is_found = 0;
+  Rng1U64 stack_read_vaddr_range = {0};
+  MutexScopeR(stripe->rw_mutex)
+  {
+    for EachNode(n, D_UnwindCacheNode, slot->first)
+    {
+      if(d_handle_match(n->thread, thread) && n->module_gen == module_gen)
+      {
+        is_found = 1;
+        stack_read_vaddr_range = n->stack_read_vaddr_range;
+        break;
+      }
+    }
+  }
+  
+  //- hash the current registers & stack memory; if they match the last
+  // unwind's, copy it out
+  B32 result = 0;
+  if(is_found)
+  {
+    B32 good = 0;
+    U128 current_hash = d_unwind_cache_hash_from_inputs(process, regs, reg_block_size, stack_read_vaddr_range, &good);
+    if(good) MutexScopeR(stripe->rw_mutex)
+    {
+      for EachNode(n, D_UnwindCacheNode, slot->first)
+      {
+        if(d_handle_match(n->thread, thread) && n->module_gen == module_gen && u128_match(n->hash, current_hash))
+        {
+          unwind_out->flags = n->unwind.flags;
+          unwind_out->frames.count = n->unwind.frames.count;
+          unwind_out->frames.v = push_array(arena, D_UnwindFrame, unwind_out->frames.count);
+          for EachIndex(idx, unwind_out->frames.count)
+          {
+            unwind_out->frames.v[idx].cfa  = n->unwind.frames.v[idx].cfa;
+            unwind_out->frames.v[idx].regs = push_array_no_zero(arena, U8, reg_block_size);
+            MemoryCopy(unwind_out->frames.v[idx].regs, n->unwind.frames.v[idx].regs, reg_block_size);
+          }
+          result = 1;
+          break;
+        }
+      }
+    }
+  }
+  ins_atomic_u64_inc_eval(result ? &cache->hit_count : &cache->miss_count);
+  return result;
+}
+
+internal void
+d_unwind_cache_store(D_Handle thread, D_Handle process, void *regs, U64 reg_block_size, U64 module_gen, Rng1U64 stack_read_vaddr_range, D_Unwind *unwind)
+{
+  B32 good = 0;
+  U128 unwind_hash = d_unwind_cache_hash_from_inputs(process, regs, reg_block_size, stack_read_vaddr_range, &good);
+  if(good)
+  {
+    D_UnwindCache *cache = &d_ctrl_state->unwind_cache;
+    U64 hash = d_hash_from_handle(thread);
+    U64 slot_idx = hash%cache->slots_count;
+    U64 stripe_idx = slot_idx%cache->stripes_count;
+    D_UnwindCacheSlot *slot = &cache->slots[slot_idx];
+    D_UnwindCacheStripe *stripe = &cache->stripes[stripe_idx];
+    MutexScopeW(stripe->rw_mutex)
+    {
+      D_UnwindCacheNode *node = 0;
+      for EachNode(n, D_UnwindCacheNode, slot->first)
+      {
+        if(d_handle_match(n->thread, thread))
+        {
+          node = n;
+          break;
+        }
+      }
+      if(node == 0)
+      {
+        node = stripe->free_node;
+        if(node != 0)
+        {
+          SLLStackPop(stripe->free_node);
+        }
+        else
+        {
+          node = push_array_no_zero(stripe->arena, D_UnwindCacheNode, 1);
+        }
+        MemoryZeroStruct(node);
+        DLLPushBack(slot->first, slot->last, node);
+        node->thread  = thread;
+        node->process = process;
+        node->arena   = arena_alloc(.reserve_size = KB(64), .commit_size = KB(64));
+      }
+      arena_clear(node->arena);
+      node->module_gen             = module_gen;
+      node->stack_read_vaddr_range = stack_read_vaddr_range;
+      node->hash                   = unwind_hash;
+      node->unwind.flags           = unwind->flags;
+      node->unwind.frames.count    = unwind->frames.count;
+      node->unwind.frames.v        = push_array(node->arena, D_UnwindFrame, unwind->frames.count);
+      for EachIndex(idx, unwind->frames.count)
+      {
+        node->unwind.frames.v[idx].cfa  = unwind->frames.v[idx].cfa;
+        node->unwind.frames.v[idx].regs = push_array_no_zero(node->arena, U8, reg_block_size);
+        MemoryCopy(node->unwind.frames.v[idx].regs, unwind->frames.v[idx].regs, reg_block_size);
+      }
+    }
+  }
+}
+
+internal void
+d_unwind_cache_release(D_Handle process, D_Handle thread)
+{
+  // NOTE: a zero thread handle releases all of the process' cached unwinds
+  D_UnwindCache *cache = &d_ctrl_state->unwind_cache;
+  B32 all_threads = d_handle_match(thread, d_handle_zero());
+  U64 first_slot_idx = all_threads ? 0 : d_hash_from_handle(thread)%cache->slots_count;
+  U64 opl_slot_idx = all_threads ? cache->slots_count : first_slot_idx+1;
+  for(U64 slot_idx = first_slot_idx; slot_idx < opl_slot_idx; slot_idx += 1)
+  {
+    D_UnwindCacheSlot *slot = &cache->slots[slot_idx];
+    D_UnwindCacheStripe *stripe = &cache->stripes[slot_idx%cache->stripes_count];
+    MutexScopeW(stripe->rw_mutex)
+    {
+      for(D_UnwindCacheNode *n = slot->first, *next = 0; n != 0; n = next)
+      {
+        next = n->next;
+        if(d_handle_match(n->process, process) && (all_threads || d_handle_match(n->thread, thread)))
+        {
+          DLLRemove(slot->first, slot->last, n);
+          arena_release(n->arena);
+          SLLStackPush(stripe->free_node, n);
+        }
+      }
+    }
+  }
+}
+
 //- rjf: abstracted full unwind
 
 internal D_Unwind
@@ -3017,11 +3487,30 @@ d_unwind_from_thread(Arena *arena, D_Handle thread, U64 endt_us)
   void *regs_block = d_cached_reg_block_from_thread(scratch.arena, thread);
   B32 regs_block_good = (arch != Arch_Null && regs_block != 0);
   
+  //- reuse the thread's last unwind, if its inputs did not change
+  U64 module_gen = d_module_gen();
+  B32 is_cached = (regs_block_good && d_unwind_cache_lookup(arena, thread, process_entity->handle, regs_block, arch_reg_block_size, module_gen, &unwind));
+  void *initial_regs_block = 0;
+  if(regs_block_good && !is_cached)
+  {
+    initial_regs_block = push_array_no_zero(scratch.arena, U8, arch_reg_block_size);
+    MemoryCopy(initial_regs_block, regs_block, arch_reg_block_size);
+  }
+  
+  //- rjf: read top of stack in one batch; select for unwind-step reads
+  D_UnwindStackSnapshot stack_snapshot = {0};
+  D_UnwindStackSnapshot *last_stack_snapshot = d_unwind_stack_snapshot;
+  if(regs_block_good && !is_cached)
+  {
+    stack_snapshot = d_unwind_stack_snapshot_from_process_sp(scratch.arena, process_entity->handle, arch_sp_from_reg_block(arch_info, regs_block));
+    d_unwind_stack_snapshot = &stack_snapshot;
+  }
+  
   //- rjf: loop & unwind
   D_UnwindFrameNode *first_frame_node = 0;
   D_UnwindFrameNode *last_frame_node = 0;
   U64 frame_node_count = 0;
-  if(regs_block_good)
+  if(regs_block_good && !is_cached)
   {
     for(unwind.flags = 0;;)
     {
@@ -3105,7 +3594,11 @@ d_unwind_from_thread(Arena *arena, D_Handle thread, U64 endt_us)
     }
   }
   
+  //- rjf: deselect stack snapshot
+  d_unwind_stack_snapshot = last_stack_snapshot;
+  
   //- rjf: bake frames list into result array
+  if(!is_cached)
   {
     unwind.frames.count = frame_node_count;
     unwind.frames.v = push_array(arena, D_UnwindFrame, unwind.frames.count);
@@ -3116,6 +3609,13 @@ d_unwind_from_thread(Arena *arena, D_Handle thread, U64 endt_us)
     }
   }
   
+  //- keep complete unwinds, which only read a bounded range of the stack
+  if(regs_block_good && !is_cached && !(unwind.flags & (D_UnwindFlag_Stale|D_UnwindFlag_Error)) &&
+     dim_1u64(stack_snapshot.stack_read_vaddr_range) <= D_UNWIND_CACHE_MAX_STACK_READ_SIZE)
+  {
+    d_unwind_cache_store(thread, process_entity->handle, initial_regs_block, arch_reg_block_size, module_gen, stack_snapshot.stack_read_vaddr_range, &unwind);
+  }
+  
   scratch_end(scratch);
   ProfEnd();
   return unwind;
@@ -3282,6 +3782,34 @@ d_reg_gen(void)
   return result;
 }
 
+internal U64
+d_module_gen(void)
+{
+  U64 result = ins_atomic_u64_eval(&d_ctrl_state->module_gen);
+  return result;
+}
+
+internal U64
+d_mem_gen_from_process_vaddr_range(D_Handle process, Rng1U64 vaddr_range)
+{
+  // NOTE(rjf): if the demon can track writes to pages, then use its per-page
+  // generations, so that pages which were not written since they were last
+  // read are not considered stale. the top bit keeps these numbers from ever
+  // colliding with the global memory generation. ranges the demon can't track
+  // (e.g. shared mappings, which other processes may write) report 0 and fall
+  // back to the global generation.
+  U64 result = d_mem_gen();
+  if(process.controller_kind == D_ControllerKind_Demon)
+  {
+    U64 page_gen = dmn_process_memory_gen_from_range(d_dmn_from_handle(process), vaddr_range);
+    if(page_gen != 0)
+    {
+      result = page_gen | (1ull<<63);
+    }
+  }
+  return result;
+}
+
 //- rjf: name -> register/alias hash tables, for eval
 
 internal E_String2NumMap *
@@ -3459,6 +3987,7 @@ d_ctrl_thread__entry_point(void *p)
           arena_clear(d_ctrl_state->ctrl_thread_msg_process_arena);
           d_ctrl_state->module_req_cache_slots_count = 4096;
           d_ctrl_state->module_req_cache_slots = push_array(d_ctrl_state->ctrl_thread_msg_process_arena, D_ModuleReqCacheNode *, d_ctrl_state->module_req_cache_slots_count);
+          d_cond_bytecode_cache_clear(d_ctrl_state->cond_bytecode_cache);
           MemoryZeroStruct(&d_ctrl_state->msg_user_bp_touched_files);
           MemoryZeroStruct(&d_ctrl_state->msg_user_bp_touched_symbols);
           MemoryCopyArray(d_ctrl_state->exception_code_filters, msg->exception_code_filters);
@@ -3698,7 +4227,7 @@ d_ctrl_thread__append_resolved_module_user_bp_traps(Arena *arena, D_EvalScope *e
     {
       String8 expr = bp->vaddr_expr;
       E_Value value = e_value_from_string(expr);
-      if(value.u64 != 0 || bp->flags != 0)
+      if(value.u64 != 0 || (bp->flags & D_BreakpointFlags_Hardware) != 0)
       {
         DMN_Trap trap = {process_dmn, value.u64, (U64)bp};
         trap.flags = d_dmn_trap_flags_from_breakpoint_flags(bp->flags);
@@ -3722,7 +4251,7 @@ d_ctrl_thread__append_resolved_process_user_bp_traps(Arena *arena, D_EvalScope *
     {
       String8 expr = bp->vaddr_expr;
       E_Value value = e_value_from_string(expr);
-      if(value.u64 != 0 || bp->flags != 0)
+      if(value.u64 != 0 || (bp->flags & D_BreakpointFlags_Hardware) != 0)
       {
         DMN_Trap trap = {process_dmn, value.u64, (U64)bp};
         trap.flags = d_dmn_trap_flags_from_breakpoint_flags(bp->flags);
@@ -4146,6 +4675,7 @@ d_ctrl_thread__module_open(D_Handle process, D_Handle module, Rng1U64 vaddr_rang
         node->is_unwind_eh                = is_unwind_eh;
         node->eh_frame_hdr                = eh_frame_hdr;
         node->eh_ptr_ctx                  = eh_ptr_ctx;
+        node->cfi_row_table_slots         = push_array(arena, D_CFIRowTableNode *, D_CFI_ROW_TABLE_SLOTS_COUNT);
         node->entry_point_voff            = entry_point_voff;
         node->initial_debug_info_path     = initial_debug_info_path;
         node->raddbg_attached_marker_voff = raddbg_is_attached_section_voff_range.min;
@@ -4154,6 +4684,10 @@ d_ctrl_thread__module_open(D_Handle process, D_Handle module, Rng1U64 vaddr_rang
     }
   }
   
+  //- bump module generation, so that cached unwinds are not reused across
+  // module changes
+  ins_atomic_u64_inc_eval(&d_ctrl_state->module_gen);
+  
   scratch_end(scratch);
 }
 
@@ -4191,6 +4725,7 @@ d_ctrl_thread__module_close(D_Handle process, D_Handle module, Rng1U64 vaddr_ran
       }
     }
   }
+  ins_atomic_u64_inc_eval(&d_ctrl_state->module_gen);
   
   //////////////////////////////
   //- rjf: write 0 at attachment market, to signify detachment
@@ -4224,6 +4759,9 @@ d_ctrl_thread__close_dump_process(D_MsgID msg_id, D_Handle process)
   ins_atomic_u64_inc_eval(&d_ctrl_state->reg_gen);
   ins_atomic_u64_inc_eval(&d_ctrl_state->run_gen);
   
+  // eliminate the process' cached unwinds
+  d_unwind_cache_release(process, d_handle_zero());
+  
   // rjf: eliminate dump node from cache
   {
     D_DumpCache *cache = &d_ctrl_state->dump_cache;
@@ -4568,6 +5106,7 @@ d_ctrl_thread__next_dmn_event(Arena *arena, DMN_CtrlCtx *ctrl_ctx, D_Msg *msg, D
       String8 module_path = path_normalized_from_string(scratch.arena, event->string);
       U64 exe_timestamp = properties_from_file_path(module_path).modified;
       d_ctrl_thread__module_open(process_handle, module_handle, r1u64(event->address, event->address+event->size), module_path, event->elf_phdr_vrange, event->elf_phdr_entsize);
+      d_cond_bytecode_cache_clear(d_ctrl_state->cond_bytecode_cache);
       out_evt1->kind       = D_EventKind_NewModule;
       out_evt1->msg_id     = msg->msg_id;
       out_evt1->entity     = module_handle;
@@ -4600,6 +5139,7 @@ d_ctrl_thread__next_dmn_event(Arena *arena, DMN_CtrlCtx *ctrl_ctx, D_Msg *msg, D
       out_evt->entity     = d_handle_from_dmn(D_MachineID_Local, event->process);
       out_evt->u64_code   = event->code;
       d_ctrl_state->process_counter -= 1;
+      d_unwind_cache_release(out_evt->entity, d_handle_zero());
     }break;
     case DMN_EventKind_ExitThread:
     {
@@ -4608,6 +5148,7 @@ d_ctrl_thread__next_dmn_event(Arena *arena, DMN_CtrlCtx *ctrl_ctx, D_Msg *msg, D
       out_evt->msg_id     = msg->msg_id;
       out_evt->entity     = d_handle_from_dmn(D_MachineID_Local, event->thread);
       out_evt->entity_id  = event->code;
+      d_unwind_cache_release(d_handle_from_dmn(D_MachineID_Local, event->process), out_evt->entity);
     }break;
     case DMN_EventKind_UnloadModule:
     ProfScope("unload module %.*s", str8_varg(event->string))
@@ -4618,6 +5159,7 @@ d_ctrl_thread__next_dmn_event(Arena *arena, DMN_CtrlCtx *ctrl_ctx, D_Msg *msg, D
       D_Entity *process_ent = d_process_from_entity(module_ent);
       String8 module_path = event->string;
       d_ctrl_thread__module_close(process_ent->handle, module_handle, module_ent->vaddr_range);
+      d_cond_bytecode_cache_clear(d_ctrl_state->cond_bytecode_cache);
       out_evt->kind       = D_EventKind_EndModule;
       out_evt->msg_id     = msg->msg_id;
       out_evt->entity     = module_handle;
@@ -4745,6 +5287,43 @@ d_ctrl_eval_space_read(E_Space space, void *out, E_SpaceRangeInfo *out_range_inf
         {
           U64 read_size = d_process_read(entity->handle, range, out);
           result = (read_size == dim_1u64(range));
+          
+          // rjf: short read, & caller wants per-byte info -> read the rest of
+          // the range page-by-page, in one batch, so that only the bytes on
+          // unreadable pages are marked as bad
+          if(!result && out_range_info != 0 && out_range_info->byte_bad_flags != 0)
+          {
+            Temp scratch = scratch_begin(0, 0);
+            U64 page_size = KB(4);
+            Rng1U64 rest_range = r1u64(range.min + read_size, range.max);
+            U64 page_count = (AlignPow2(rest_range.max, page_size) - AlignDownPow2(rest_range.min, page_size))/page_size;
+            Rng1U64 *ranges = push_array(scratch.arena, Rng1U64, page_count);
+            void **dsts = push_array(scratch.arena, void *, page_count);
+            U64 *read_sizes = push_array(scratch.arena, U64, page_count);
+            for EachIndex(page_idx, page_count)
+            {
+              U64 page_base_vaddr = AlignDownPow2(rest_range.min, page_size) + page_idx*page_size;
+              ranges[page_idx] = intersect_1u64(rest_range, r1u64(page_base_vaddr, page_base_vaddr+page_size));
+              dsts[page_idx] = (U8 *)out + (ranges[page_idx].min - range.min);
+            }
+            d_process_read_many(entity->handle, page_count, ranges, dsts, read_sizes);
+            for EachIndex(page_idx, page_count)
+            {
+              Rng1U64 bad_range = r1u64(ranges[page_idx].min + read_sizes[page_idx], ranges[page_idx].max);
+              for(U64 vaddr = bad_range.min; vaddr < bad_range.max; vaddr += 1)
+              {
+                U64 idx_in_range = vaddr - range.min;
+                out_range_info->byte_bad_flags[idx_in_range/64] |= (1ull<<(idx_in_range%64));
+                ((U8 *)out)[idx_in_range] = 0;
+              }
+              if(bad_range.min < bad_range.max)
+              {
+                out_range_info->flags |= E_SpaceRangeFlag_AnyByteBad;
+              }
+            }
+            result = 1;
+            scratch_end(scratch);
+          }
         }break;
         case D_EntityKind_Thread:
         {
@@ -4769,6 +5348,14 @@ d_ctrl_eval_space_read(E_Space space, void *out, E_SpaceRangeInfo *out_range_inf
 
 internal D_EvalScope *
 d_ctrl_thread__eval_scope_begin(Arena *arena, D_BreakpointList *user_bps, D_Entity *thread)
+{
+  D_EvalScope *scope = d_ctrl_thread__interpret_scope_begin(arena, user_bps, thread);
+  d_ctrl_thread__eval_scope_select_ir_ctx(arena, scope);
+  return scope;
+}
+
+internal D_EvalScope *
+d_ctrl_thread__interpret_scope_begin(Arena *arena, D_BreakpointList *user_bps, D_Entity *thread)
 {
   ProfBeginFunction();
   D_EntityCtx *entity_ctx = &d_ctrl_state->ctrl_thread_entity_store->ctx;
@@ -4966,21 +5553,6 @@ d_ctrl_thread__eval_scope_begin(Arena *arena, D_BreakpointList *user_bps, D_Enti
   }
   e_select_base_ctx(&scope->base_ctx);
   
-  //////////////////////////////
-  //- rjf: build IR evaluation context
-  //
-  {
-    E_IRCtx *ctx = &scope->ir_ctx;
-    ctx->regs_map      = d_string2reg_from_arch(arch);
-    ctx->locals_map    = e_push_locals_map_from_rdi_voff(arena, eval_dbg_infos_primary->rdi, thread_rip_voff);
-    ctx->member_map    = e_push_member_map_from_rdi_voff(arena, eval_dbg_infos_primary->rdi, thread_rip_voff);
-    ctx->macro_map     = push_array(arena, E_String2ExprMap, 1);
-    ctx->macro_map[0]  = e_string2expr_map_make(arena, 512);
-    ctx->auto_hook_map = push_array(arena, E_AutoHookMap, 1);
-    ctx->auto_hook_map[0] = e_auto_hook_map_make(arena, 512);
-  }
-  e_select_ir_ctx(&scope->ir_ctx);
-  
   //////////////////////////////
   //- rjf: build eval interpretation context
   //
@@ -5004,12 +5576,159 @@ d_ctrl_thread__eval_scope_begin(Arena *arena, D_BreakpointList *user_bps, D_Enti
   return scope;
 }
 
+internal void
+d_ctrl_thread__eval_scope_select_ir_ctx(Arena *arena, D_EvalScope *scope)
+{
+  ProfBeginFunction();
+  RDI_Parsed *primary_rdi = scope->base_ctx.primary_dbg_info->rdi;
+  U64 thread_rip_voff = scope->base_ctx.thread_ip_voff;
+  {
+    E_IRCtx *ctx = &scope->ir_ctx;
+    ctx->regs_map      = d_string2reg_from_arch(scope->base_ctx.thread_arch);
+    ctx->locals_map    = e_push_locals_map_from_rdi_voff(arena, primary_rdi, thread_rip_voff);
+    ctx->member_map    = e_push_member_map_from_rdi_voff(arena, primary_rdi, thread_rip_voff);
+    ctx->macro_map     = push_array(arena, E_String2ExprMap, 1);
+    ctx->macro_map[0]  = e_string2expr_map_make(arena, 512);
+    ctx->auto_hook_map = push_array(arena, E_AutoHookMap, 1);
+    ctx->auto_hook_map[0] = e_auto_hook_map_make(arena, 512);
+  }
+  e_select_ir_ctx(&scope->ir_ctx);
+  ProfEnd();
+}
+
 internal void
 d_ctrl_thread__eval_scope_end(D_EvalScope *scope)
 {
   access_close(scope->access);
 }
 
+//- conditional breakpoint bytecode cache
+
+internal D_CondBytecodeCache *
+d_cond_bytecode_cache_alloc(void)
+{
+  Arena *arena = arena_alloc();
+  D_CondBytecodeCache *cache = push_array(arena, D_CondBytecodeCache, 1);
+  cache->arena = arena;
+  cache->arena_clear_pos = arena_pos(arena);
+  d_cond_bytecode_cache_clear(cache);
+  return cache;
+}
+
+internal void
+d_cond_bytecode_cache_release(D_CondBytecodeCache *cache)
+{
+  arena_release(cache->arena);
+}
+
+internal void
+d_cond_bytecode_cache_clear(D_CondBytecodeCache *cache)
+{
+  arena_pop_to(cache->arena, cache->arena_clear_pos);
+  cache->slots_count = 256;
+  cache->slots = push_array(cache->arena, D_CondBytecodeCacheNode *, cache->slots_count);
+}
+
+internal D_CondBytecodeCacheNode *
+d_cond_bytecode_cache_node_from_key(D_CondBytecodeCache *cache, String8 condition, D_Handle thread, D_Handle module, U64 ip_voff)
+{
+  D_CondBytecodeCacheNode *result = 0;
+  U64 hash = d_hash_from_seed_string(d_hash_from_handle(thread) ^ d_hash_from_handle(module) ^ ip_voff, condition);
+  U64 slot_idx = hash%cache->slots_count;
+  for(D_CondBytecodeCacheNode *n = cache->slots[slot_idx]; n != 0; n = n->next)
+  {
+    if(n->ip_voff == ip_voff && d_handle_match(n->thread, thread) && d_handle_match(n->module, module) && str8_match(n->condition, condition, 0))
+    {
+      result = n;
+      break;
+    }
+  }
+  return result;
+}
+
+internal String8
+d_cond_bytecode_from_cache(D_CondBytecodeCache *cache, String8 condition, D_Handle thread, D_Handle module, U64 ip_voff)
+{
+  String8 result = {0};
+  D_CondBytecodeCacheNode *n = d_cond_bytecode_cache_node_from_key(cache, condition, thread, module, ip_voff);
+  if(n != 0)
+  {
+    result = n->bytecode;
+  }
+  return result;
+}
+
+internal void
+d_cond_bytecode_cache_store(D_CondBytecodeCache *cache, String8 condition, D_Handle thread, D_Handle module, U64 ip_voff, String8 bytecode)
+{
+  U64 hash = d_hash_from_seed_string(d_hash_from_handle(thread) ^ d_hash_from_handle(module) ^ ip_voff, condition);
+  U64 slot_idx = hash%cache->slots_count;
+  D_CondBytecodeCacheNode *n = push_array(cache->arena, D_CondBytecodeCacheNode, 1);
+  SLLStackPush(cache->slots[slot_idx], n);
+  n->condition = push_str8_copy(cache->arena, condition);
+  n->thread    = thread;
+  n->module    = module;
+  n->ip_voff   = ip_voff;
+  n->bytecode  = push_str8_copy(cache->arena, bytecode);
+}
+
+internal E_Interpretation
+d_ctrl_thread__interpretation_from_condition(D_CondBytecodeCache *cache, Arena *arena, D_EvalScope *eval_scope, String8 condition, D_Handle thread, D_Handle module, U64 ip_voff)
+{
+  E_Interpretation result = {0};
+  String8 bytecode = d_cond_bytecode_from_cache(cache, condition, thread, module, ip_voff);
+  
+  //- cached -> only run the interpreter
+  if(bytecode.size != 0) ProfScope("interpret cached condition bytecode")
+  {
+    cache->hit_count += 1;
+    result = e_interpret(bytecode);
+  }
+  
+  //- not cached -> do full parse/type-check/IR/bytecode pipeline; only keep
+  // the bytecode if it was produced without errors, so that conditions which
+  // refer to not-yet-loaded debug info get another chance on later hits
+  else ProfScope("evaluate condition")
+  {
+    cache->miss_count += 1;
+    if(eval_scope->ir_ctx.regs_map == 0)
+    {
+      d_ctrl_thread__eval_scope_select_ir_ctx(arena, eval_scope);
+    }
+    E_Eval eval = e_eval_from_string(condition);
+    result.code  = eval.code;
+    result.value = eval.value;
+    result.space = eval.space;
+    if(eval.msgs.max_kind == E_MsgKind_Null && eval.bytecode.size != 0)
+    {
+      d_cond_bytecode_cache_store(cache, condition, thread, module, ip_voff, eval.bytecode);
+    }
+  }
+  
+  return result;
+}
+
+internal String8
+d_ctrl_thread__native_code_from_condition(D_CondBytecodeCache *cache, D_EvalScope *eval_scope, String8 condition, D_Handle thread, D_Handle module, U64 ip_voff)
+{
+  String8 result = {0};
+  D_CondBytecodeCacheNode *n = d_cond_bytecode_cache_node_from_key(cache, condition, thread, module, ip_voff);
+  if(n != 0 && !n->native_code_is_computed) ProfScope("compile condition to native code")
+  {
+    Temp scratch = scratch_begin(0, 0);
+    RDI_Parsed *primary_rdi = eval_scope->base_ctx.primary_dbg_info->rdi;
+    String8 frame_base_bytecode = e_frame_base_bytecode_from_voff(scratch.arena, primary_rdi, ip_voff);
+    n->native_code = e_native_code_from_bytecode(cache->arena, n->bytecode, frame_base_bytecode);
+    n->native_code_is_computed = 1;
+    scratch_end(scratch);
+  }
+  if(n != 0)
+  {
+    result = n->native_code;
+  }
+  return result;
+}
+
 //- rjf: log flusher
 
 internal void
@@ -5251,7 +5970,6 @@ d_ctrl_thread__open_crash_dump(DMN_CtrlCtx *ctrl_ctx, D_Msg *msg)
               }break;
               case MDMP_StreamKind_Memory64List:
               {
-                U64 memories64_count = 0;
                 U64 off = dir->location.foff;
                 off += str8_deserial_read_struct(data, off, &memories64_count);
                 off += str8_deserial_read_struct(data, off, &memories64_base_foff);
@@ -5275,12 +5993,22 @@ d_ctrl_thread__open_crash_dump(DMN_CtrlCtx *ctrl_ctx, D_Msg *msg)
           U64 foff = memories64_base_foff;
           for EachIndex(idx, memories64_count)
           {
-            memory_ranges[memories_count + idx].base_vaddr = memories64[memories_count + idx].start_of_memory_range;
+            memory_ranges[memories_count + idx].base_vaddr = memories64[idx].start_of_memory_range;
             memory_ranges[memories_count + idx].foff_range = r1u64(foff, foff+memories64[idx].size);
             foff += memories64[idx].size;
           }
         }
         
+        // build the interval table which reads search: clamp ranges to the
+        // file, then sort & merge them
+        for EachIndex(idx, memory_ranges_count)
+        {
+          Rng1U64 *foff_range = &memory_ranges[idx].foff_range;
+          foff_range->max = Min(foff_range->max, data.size);
+          foff_range->min = Min(foff_range->min, foff_range->max);
+        }
+        memory_ranges = d_dump_memory_ranges_sort_coalesce(arena, memory_ranges, memory_ranges_count, &memory_ranges_count);
+        
         // rjf: system info -> arch
         if(system_info != 0) switch(system_info->processor_architecture)
         {
@@ -6419,15 +7147,11 @@ d_ctrl_thread__run(DMN_CtrlCtx *ctrl_ctx, D_Msg *msg)
         // rjf: evaluate hit stop conditions
         if(conditions.node_count != 0) ProfScope("evaluate hit stop conditions")
         {
-          D_EvalScope *eval_scope = d_ctrl_thread__eval_scope_begin(temp.arena, &msg->user_bps, thread);
+          D_EvalScope *eval_scope = d_ctrl_thread__interpret_scope_begin(temp.arena, &msg->user_bps, thread);
           for(String8Node *condition_n = conditions.first; condition_n != 0; condition_n = condition_n->next)
           {
-            // rjf: evaluate
-            E_Eval eval = zero_struct;
-            ProfScope("evaluate expression")
-            {
-              eval = e_eval_from_string(condition_n->string);
-            }
+            // rjf: evaluate (IR ctx is only built if the condition's bytecode is not cached)
+            E_Interpretation eval = d_ctrl_thread__interpretation_from_condition(d_ctrl_state->cond_bytecode_cache, temp.arena, eval_scope, condition_n->string, thread->handle, module->handle, thread_rip_voff);
             
             // rjf: interpret evaluation
             if(eval.code == E_InterpretationCode_Good && eval.value.u64 == 0)
@@ -6444,6 +7168,49 @@ d_ctrl_thread__run(DMN_CtrlCtx *ctrl_ctx, D_Msg *msg)
               break;
             }
           }
+          
+          // attach native code to the traps of breakpoints whose conditions are
+          // tested in-process, so that the debuggee only stops on later hits
+          // when the condition holds; the code replaces the site instruction
+          // with a jump, so it must be at least that big, & must not branch
+          if(arch == Arch_x64) ProfScope("attach in-process conditions")
+          {
+            DASM_Inst site_inst = {0};
+            B32 site_inst_is_decoded = 0;
+            for(DMN_TrapChunkNode *n = user_traps.first; n != 0; n = n->next)
+            {
+              for EachIndex(idx, n->count)
+              {
+                DMN_Trap *trap = &n->v[idx];
+                D_Breakpoint *user_bp = (D_Breakpoint *)trap->id;
+                if(!dmn_handle_match(trap->process, event->process) ||
+                   trap->vaddr != event->instruction_pointer ||
+                   trap->condition_code.size != 0 ||
+                   user_bp == 0 || (trap->id & bit64) ||
+                   !(user_bp->flags & D_BreakpointFlag_InProcessCondition) ||
+                   user_bp->condition.size == 0)
+                {
+                  continue;
+                }
+                String8 code = d_ctrl_thread__native_code_from_condition(d_ctrl_state->cond_bytecode_cache, eval_scope, user_bp->condition, thread->handle, module->handle, thread_rip_voff);
+                if(code.size != 0 && !site_inst_is_decoded)
+                {
+                  U8 site_bytes[16] = {0};
+                  U64 site_bytes_size = dmn_process_read(event->process, r1u64(trap->vaddr, trap->vaddr + sizeof(site_bytes)), site_bytes);
+                  site_inst = dasm_inst_from_code(temp.arena, arch, trap->vaddr, str8(site_bytes, site_bytes_size), DASM_Syntax_Intel);
+                  site_inst_is_decoded = 1;
+                }
+                if(code.size != 0 &&
+                   site_inst.size >= X64_COND_SITE_JMP_SIZE &&
+                   !(site_inst.flags & (DASM_InstFlag_Call|DASM_InstFlag_Branch|DASM_InstFlag_UnconditionalJump|DASM_InstFlag_Return|DASM_InstFlag_Repeats)))
+                {
+                  trap->condition_code              = push_str8_copy(d_ctrl_state->ctrl_thread_msg_process_arena, code);
+                  trap->condition_site_size         = site_inst.size;
+                  trap->condition_site_rip_disp_off = site_inst.rip_disp_off;
+                }
+              }
+            }
+          }
           d_ctrl_thread__eval_scope_end(eval_scope);
         }
         
@@ -6886,26 +7653,46 @@ d_process_read(D_Handle process, Rng1U64 range, void *dst)
         // rjf: find all overlapping memory ranges, & fill respective portion of output
         if(node != 0)
         {
-          B32 range_found = 0;
-          for EachIndex(idx, node->memory_ranges_count)
-          {
-            D_DumpMemoryRange *r = &node->memory_ranges[idx];
-            Rng1U64 foff_range = r->foff_range;
-            Rng1U64 vaddr_range = r1u64(r->base_vaddr, r->base_vaddr + dim_1u64(foff_range));
-            Rng1U64 legal_vaddr_range = intersect_1u64(vaddr_range, range);
-            if(legal_vaddr_range.min < legal_vaddr_range.max)
-            {
-              range_found = 1;
-              Rng1U64 legal_foff_range = r1u64(legal_vaddr_range.min - r->base_vaddr + foff_range.min, legal_vaddr_range.max - r->base_vaddr + foff_range.min);
-              Rng1U64 dst_off_range = r1u64(legal_vaddr_range.min - range.min, legal_vaddr_range.max - range.min);
-              MemoryCopy((U8 *)dst + dst_off_range.min, (U8 *)node->base + legal_foff_range.min, dim_1u64(dst_off_range));
-            }
-          }
-          if(range_found)
-          {
-            result = dim_1u64(range);
-          }
+          String8 dump_data = str8((U8 *)node->base, node->base ? node->props.size : 0);
+          result = d_dump_memory_read(dump_data, node->memory_ranges, node->memory_ranges_count, range, dst);
+        }
+      }
+    }break;
+  }
+  return result;
+}
+
+internal U64
+d_process_read_many(D_Handle process, U64 count, Rng1U64 *ranges, void **dsts, U64 *read_sizes_out)
+{
+  U64 result = 0;
+  switch((D_ControllerKindEnum)process.controller_kind)
+  {
+    default:
+    {
+      if(read_sizes_out != 0)
+      {
+        MemoryZeroTyped(read_sizes_out, count);
+      }
+    }break;
+    
+    //- rjf: demon process reads -> batch
+    case D_ControllerKind_Demon:
+    {
+      result = dmn_process_read_many(d_dmn_from_handle(process), count, ranges, dsts, read_sizes_out);
+    }break;
+    
+    //- rjf: dump process reads -> already in memory; read each range
+    case D_ControllerKind_Dump:
+    {
+      for EachIndex(idx, count)
+      {
+        U64 read_size = d_process_read(process, ranges[idx], dsts[idx]);
+        if(read_sizes_out != 0)
+        {
+          read_sizes_out[idx] = read_size;
         }
+        result += read_size;
       }
     }break;
   }
@@ -6959,7 +7746,7 @@ d_data_from_process_vaddr_range(Arena *arena, D_Handle process, Rng1U64 vaddr_ra
 //- rjf: process memory artifact cache
 
 internal AC_Artifact
-d_memory_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out)
+d_memory_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   AC_Artifact artifact = {0};
   {
@@ -6987,7 +7774,7 @@ d_memory_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *g
     Arena *range_arena = 0;
     void *range_base = 0;
     U64 zero_terminated_size = 0;
-    U64 pre_read_mem_gen = d_mem_gen();
+    U64 pre_read_mem_gen = d_mem_gen_from_process_vaddr_range(process, vaddr_range_clamped);
     B32 pre_run_state = ins_atomic_u64_eval(&d_ctrl_state->ctrl_thread_run_state);
     if(range_size != 0)
     {
@@ -7056,7 +7843,7 @@ d_memory_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *g
         }
       }
     }
-    U64 post_read_mem_gen = d_mem_gen();
+    U64 post_read_mem_gen = d_mem_gen_from_process_vaddr_range(process, vaddr_range_clamped);
     B32 post_run_state = ins_atomic_u64_eval(&d_ctrl_state->ctrl_thread_run_state);
     
     //- rjf: form content key
@@ -7081,6 +7868,7 @@ d_memory_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *g
     {
       hash = c_submit_data(content_key, &range_arena, str8((U8 *)range_base, zero_terminated_size));
       gen_out[0] = pre_read_mem_gen;
+      size_out[0] = zero_terminated_size;
     }
     
     //- rjf: wakeup on new submissions
@@ -7135,7 +7923,7 @@ d_key_from_process_vaddr_range(D_Handle process, Rng1U64 vaddr_range, B32 zero_t
   Access *access = access_open();
   AC_Artifact artifact = ac_artifact_from_key(access, key, d_memory_artifact_create, d_memory_artifact_destroy, endt_us,
                                               .flags = AC_Flag_HighPriority | (wait_for_fresh ? AC_Flag_WaitForFresh : 0),
-                                              .gen = d_mem_gen(),
+                                              .gen = d_mem_gen_from_process_vaddr_range(process, vaddr_range),
                                               .slots_count = 2048,
                                               .stale_out = out_is_stale,
                                               .evict_threshold_us = 10000000);
@@ -7294,19 +8082,35 @@ d_process_memory_slice_from_vaddr_range(Arena *arena, D_Handle process, Rng1U64
 internal B32
 d_process_memory_read(D_Handle process, Rng1U64 range, B32 *is_stale_out, void *out, U64 endt_us)
 {
-  Temp scratch = scratch_begin(0, 0);
-  U64 needed_size = dim_1u64(range);
-  D_ProcessMemorySlice slice = d_process_memory_slice_from_vaddr_range(scratch.arena, process, range, 0, endt_us);
-  B32 good = (slice.data.size >= needed_size && !slice.any_byte_bad);
-  if(good)
+  //- rjf: reads from the top of the stack, while unwinding -> use the snapshot
+  B32 good = d_unwind_stack_snapshot_read(d_unwind_stack_snapshot, process, range, out);
+  
+  //- reads while unwinding, which don't land in a module's image -> the
+  // unwind depends on these bytes; grow the snapshot's stack read range
+  if(d_unwind_stack_snapshot != 0 && d_handle_match(d_unwind_stack_snapshot->process, process) &&
+     (good || d_module_from_process_vaddr(d_entity_from_handle(process), range.min) == &d_entity_nil))
   {
-    MemoryCopy(out, slice.data.str, needed_size);
+    Rng1U64 *stack_read_vaddr_range = &d_unwind_stack_snapshot->stack_read_vaddr_range;
+    *stack_read_vaddr_range = (dim_1u64(*stack_read_vaddr_range) == 0 ? range : union_1u64(*stack_read_vaddr_range, range));
   }
-  if(slice.stale && is_stale_out)
+  
+  //- rjf: all other reads -> go through cache
+  if(!good)
   {
-    *is_stale_out = 1;
+    Temp scratch = scratch_begin(0, 0);
+    U64 needed_size = dim_1u64(range);
+    D_ProcessMemorySlice slice = d_process_memory_slice_from_vaddr_range(scratch.arena, process, range, 0, endt_us);
+    good = (slice.data.size >= needed_size && !slice.any_byte_bad);
+    if(good)
+    {
+      MemoryCopy(out, slice.data.str, needed_size);
+    }
+    if(slice.stale && is_stale_out)
+    {
+      *is_stale_out = 1;
+    }
+    scratch_end(scratch);
   }
-  scratch_end(scratch);
   return good;
 }
 
@@ -7314,7 +8118,7 @@ d_process_memory_read(D_Handle process, Rng1U64 range, B32 *is_stale_out, void *
 //~ rjf: Call Stack Artifact Cache Hooks / Lookups
 
 internal AC_Artifact
-d_call_stack_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out)
+d_call_stack_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   AC_Artifact artifact = {0};
   {
@@ -7480,6 +8284,7 @@ d_call_stack_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U6
     {
       artifact.u64[0] = (U64)arena;
       artifact.u64[1] = (U64)call_stack;
+      size_out[0] = arena_pos(arena);
     }
     
     //- rjf: mark retry
@@ -7521,7 +8326,7 @@ d_call_stack_from_thread(Access *access, D_Handle thread_handle, B32 high_priori
 //~ rjf: Call Stack Tree Artifact Cache Hooks / Lookups
 
 internal AC_Artifact
-d_call_stack_tree_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out)
+d_call_stack_tree_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   Temp scratch = scratch_begin(0, 0);
   Access *access = access_open();
@@ -7627,6 +8432,10 @@ d_call_stack_tree_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_ou
   {
     artifact.u64[0] = (U64)arena;
     artifact.u64[1] = (U64)tree;
+    if(arena != 0)
+    {
+      size_out[0] = arena_pos(arena);
+    }
   }
   
   //- rjf: retry on stale
@@ -58,6 +58,24 @@ struct D_FrameUnwindContext
   U64 ret_addr_reg;
 };
 
+// NOTE(rjf): before unwinding, the top of the thread's stack is read in one
+// batch (one page per range, so unmapped pages don't fail the whole read).
+// reads made by the unwind steps which land in it skip the memory cache. the
+// snapshot starts small, & doubles whenever a read lands past its read pages.
+#define D_UNWIND_STACK_SNAPSHOT_SIZE KB(64)
+#define D_UNWIND_STACK_SNAPSHOT_INITIAL_SIZE KB(8)
+
+typedef struct D_UnwindStackSnapshot D_UnwindStackSnapshot;
+struct D_UnwindStackSnapshot
+{
+  D_Handle process;
+  Rng1U64 vaddr_range;
+  U8 *data;
+  U64 *page_read_sizes;
+  U64 page_read_count;
+  Rng1U64 stack_read_vaddr_range;
+};
+
 ////////////////////////////////
 //~ rjf: Call Stack Types
 
@@ -168,9 +186,70 @@ struct D_ThreadRegCache
   D_ThreadRegCacheStripe *stripes;
 };
 
+////////////////////////////////
+//~ Unwind Cache Types
+
+// NOTE: a thread's unwind is decided by its registers, the stack memory which
+// the unwind reads, & the process' modules. each thread's last unwind is kept
+// with a hash of its registers & of that stack memory, so that threads which
+// did not move between two stops (e.g. workers blocked in the kernel) are not
+// unwound again.
+#define D_UNWIND_CACHE_MAX_STACK_READ_SIZE MB(1)
+
+typedef struct D_UnwindCacheNode D_UnwindCacheNode;
+struct D_UnwindCacheNode
+{
+  D_UnwindCacheNode *next;
+  D_UnwindCacheNode *prev;
+  D_Handle thread;
+  D_Handle process;
+  Arena *arena;
+  U64 module_gen;
+  Rng1U64 stack_read_vaddr_range;
+  U128 hash;
+  D_Unwind unwind;
+};
+
+typedef struct D_UnwindCacheSlot D_UnwindCacheSlot;
+struct D_UnwindCacheSlot
+{
+  D_UnwindCacheNode *first;
+  D_UnwindCacheNode *last;
+};
+
+typedef struct D_UnwindCacheStripe D_UnwindCacheStripe;
+struct D_UnwindCacheStripe
+{
+  Arena *arena;
+  RWMutex rw_mutex;
+  D_UnwindCacheNode *free_node;
+};
+
+typedef struct D_UnwindCache D_UnwindCache;
+struct D_UnwindCache
+{
+  U64 slots_count;
+  D_UnwindCacheSlot *slots;
+  U64 stripes_count;
+  D_UnwindCacheStripe *stripes;
+  U64 hit_count;
+  U64 miss_count;
+};
+
 ////////////////////////////////
 //~ rjf: Module Image Info Cache Types
 
+#define D_CFI_ROW_TABLE_SLOTS_COUNT 256
+
+typedef struct D_CFIRowTableNode D_CFIRowTableNode;
+struct D_CFIRowTableNode
+{
+  D_CFIRowTableNode *next;
+  U64 fde_addr;
+  U64 ret_addr_reg;
+  DW_CFI_RowTable table;
+};
+
 typedef struct D_ModuleImageInfoCacheNode D_ModuleImageInfoCacheNode;
 struct D_ModuleImageInfoCacheNode
 {
@@ -185,6 +264,7 @@ struct D_ModuleImageInfoCacheNode
   String8 dwarf_unwind_data;
   EH_FrameHdr eh_frame_hdr;
   EH_PtrCtx eh_ptr_ctx;
+  D_CFIRowTableNode **cfi_row_table_slots;
   U64 entry_point_voff;
   String8 initial_debug_info_path;
   U64 raddbg_attached_marker_voff;
@@ -224,6 +304,13 @@ struct D_DumpMemoryRange
   Rng1U64 foff_range;
 };
 
+typedef struct D_DumpMemoryRangeSortKey D_DumpMemoryRangeSortKey;
+struct D_DumpMemoryRangeSortKey
+{
+  U64 base_vaddr;
+  U64 idx;
+};
+
 typedef struct D_DumpThread D_DumpThread;
 struct D_DumpThread
 {
@@ -255,7 +342,7 @@ struct D_DumpNode
   FileMap map;
   void *base;
   Arena *arena;
-  D_DumpMemoryRange *memory_ranges;
+  D_DumpMemoryRange *memory_ranges; // sorted by base_vaddr, disjoint, & coalesced
   U64 memory_ranges_count;
   D_DumpThread *threads;
   U64 threads_count;
@@ -318,6 +405,41 @@ struct D_ModuleReqCacheNode
   B32 required;
 };
 
+////////////////////////////////
+//~ Conditional Breakpoint Bytecode Cache Types
+//
+// Compiled bytecode for breakpoint conditions, keyed by (condition, thread,
+// module, ip voff), so that repeated hits only need to run the interpreter.
+// The thread is part of the key because register reads in the bytecode refer
+// to the thread's register space. Cleared whenever modules are loaded or
+// unloaded, & for each new message. Conditions of breakpoints which are tested
+// in-process also keep their native code (see `e_native_code_from_bytecode`),
+// which is computed at most once, as most conditions do not compile.
+
+typedef struct D_CondBytecodeCacheNode D_CondBytecodeCacheNode;
+struct D_CondBytecodeCacheNode
+{
+  D_CondBytecodeCacheNode *next;
+  String8 condition;
+  D_Handle thread;
+  D_Handle module;
+  U64 ip_voff;
+  String8 bytecode;
+  String8 native_code;
+  B32 native_code_is_computed;
+};
+
+typedef struct D_CondBytecodeCache D_CondBytecodeCache;
+struct D_CondBytecodeCache
+{
+  Arena *arena;
+  U64 arena_clear_pos;
+  U64 slots_count;
+  D_CondBytecodeCacheNode **slots;
+  U64 hit_count;
+  U64 miss_count;
+};
+
 ////////////////////////////////
 //~ rjf: Wakeup Hook Function Types
 
@@ -338,6 +460,7 @@ struct D_CtrlState
   
   // rjf: caches
   D_ThreadRegCache thread_reg_cache;
+  D_UnwindCache unwind_cache;
   D_ModuleImageInfoCache module_image_info_cache;
   D_DumpCache dump_cache;
   
@@ -345,6 +468,7 @@ struct D_CtrlState
   U64 run_gen;
   U64 mem_gen;
   U64 reg_gen;
+  U64 module_gen;
   
   // rjf: user -> ctrl msg ring buffer
   U64 u2c_ring_size;
@@ -385,6 +509,7 @@ struct D_CtrlState
   D_DbgDirNode *dbg_dir_root;
   U64 module_req_cache_slots_count;
   D_ModuleReqCacheNode **module_req_cache_slots;
+  D_CondBytecodeCache *cond_bytecode_cache;
   String8List msg_user_bp_touched_files;
   String8List msg_user_bp_touched_symbols;
 };
@@ -411,6 +536,7 @@ read_only global D_CallStackTreeNode d_call_stack_tree_node_nil =
   &d_call_stack_tree_node_nil,
 };
 thread_static D_EntityCtxLookupAccel *d_entity_ctx_lookup_accel = 0;
+thread_static D_UnwindStackSnapshot *d_unwind_stack_snapshot = 0;
 
 ////////////////////////////////
 //~ rjf: Basic Type Functions
@@ -564,6 +690,15 @@ internal U64 d_entry_point_voff_from_module(D_Handle module_handle);
 internal String8 d_initial_debug_info_path_from_module(Arena *arena, D_Handle module_handle);
 internal String8 d_raddbg_data_from_module(Arena *arena, D_Handle module_handle);
 
+////////////////////////////////
+//~ Dump Memory Functions
+
+internal int d_dump_memory_range_sort_key_compare(D_DumpMemoryRangeSortKey *a, D_DumpMemoryRangeSortKey *b);
+internal D_DumpMemoryRange *d_dump_memory_ranges_sort_coalesce(Arena *arena, D_DumpMemoryRange *ranges, U64 ranges_count, U64 *count_out);
+internal U64 d_dump_memory_range_idx_from_vaddr(D_DumpMemoryRange *ranges, U64 ranges_count, U64 vaddr);
+internal String8 d_dump_data_from_vaddr_range(String8 dump_data, D_DumpMemoryRange *ranges, U64 ranges_count, Rng1U64 vaddr_range);
+internal U64 d_dump_memory_read(String8 dump_data, D_DumpMemoryRange *ranges, U64 ranges_count, Rng1U64 vaddr_range, void *dst);
+
 ////////////////////////////////
 //~ rjf: Unwinding Functions
 
@@ -576,6 +711,17 @@ internal D_UnwindStepResult d_unwind_step__dwarf(D_Handle process_handle, Arch a
 internal U64 *d_unwind_reg_from_pe_gpr_reg__pe_x64(X64_RegBlock *regs, PE_UnwindGprRegX64 gpr_reg);
 internal D_UnwindStepResult d_unwind_step__pe_x64(D_Handle process_handle, D_Handle module_handle, U64 module_base_vaddr, X64_RegBlock *regs, U64 endt_us);
 
+//- rjf: stack snapshots
+internal D_UnwindStackSnapshot d_unwind_stack_snapshot_from_process_sp(Arena *arena, D_Handle process, U64 sp);
+internal void d_unwind_stack_snapshot_read_pages(D_UnwindStackSnapshot *snapshot, U64 page_count);
+internal B32 d_unwind_stack_snapshot_read(D_UnwindStackSnapshot *snapshot, D_Handle process, Rng1U64 range, void *out);
+
+//- unwind cache
+internal U128 d_unwind_cache_hash_from_inputs(D_Handle process, void *regs, U64 reg_block_size, Rng1U64 stack_read_vaddr_range, B32 *good_out);
+internal B32 d_unwind_cache_lookup(Arena *arena, D_Handle thread, D_Handle process, void *regs, U64 reg_block_size, U64 module_gen, D_Unwind *unwind_out);
+internal void d_unwind_cache_store(D_Handle thread, D_Handle process, void *regs, U64 reg_block_size, U64 module_gen, Rng1U64 stack_read_vaddr_range, D_Unwind *unwind);
+internal void d_unwind_cache_release(D_Handle process, D_Handle thread);
+
 //- rjf: abstracted full unwind
 internal D_Unwind d_unwind_from_thread(Arena *arena, D_Handle thread, U64 endt_us);
 
@@ -597,6 +743,8 @@ internal void d_halt(void);
 internal U64 d_run_gen(void);
 internal U64 d_mem_gen(void);
 internal U64 d_reg_gen(void);
+internal U64 d_module_gen(void);
+internal U64 d_mem_gen_from_process_vaddr_range(D_Handle process, Rng1U64 vaddr_range);
 
 //- rjf: name -> register/alias hash tables, for eval
 internal E_String2NumMap *d_string2reg_from_arch(Arch arch);
@@ -636,8 +784,20 @@ internal B32 d_ctrl_eval_space_read(E_Space space, void *out, E_SpaceRangeInfo *
 
 //- rjf: control thread eval scopes
 internal D_EvalScope *d_ctrl_thread__eval_scope_begin(Arena *arena, D_BreakpointList *user_bps, D_Entity *thread);
+internal D_EvalScope *d_ctrl_thread__interpret_scope_begin(Arena *arena, D_BreakpointList *user_bps, D_Entity *thread);
+internal void d_ctrl_thread__eval_scope_select_ir_ctx(Arena *arena, D_EvalScope *scope);
 internal void d_ctrl_thread__eval_scope_end(D_EvalScope *scope);
 
+//- conditional breakpoint bytecode cache
+internal D_CondBytecodeCache *d_cond_bytecode_cache_alloc(void);
+internal void d_cond_bytecode_cache_release(D_CondBytecodeCache *cache);
+internal void d_cond_bytecode_cache_clear(D_CondBytecodeCache *cache);
+internal D_CondBytecodeCacheNode *d_cond_bytecode_cache_node_from_key(D_CondBytecodeCache *cache, String8 condition, D_Handle thread, D_Handle module, U64 ip_voff);
+internal String8 d_cond_bytecode_from_cache(D_CondBytecodeCache *cache, String8 condition, D_Handle thread, D_Handle module, U64 ip_voff);
+internal void d_cond_bytecode_cache_store(D_CondBytecodeCache *cache, String8 condition, D_Handle thread, D_Handle module, U64 ip_voff, String8 bytecode);
+internal E_Interpretation d_ctrl_thread__interpretation_from_condition(D_CondBytecodeCache *cache, Arena *arena, D_EvalScope *eval_scope, String8 condition, D_Handle thread, D_Handle module, U64 ip_voff);
+internal String8 d_ctrl_thread__native_code_from_condition(D_CondBytecodeCache *cache, D_EvalScope *eval_scope, String8 condition, D_Handle thread, D_Handle module, U64 ip_voff);
+
 //- rjf: log flusher
 internal void d_ctrl_thread__end_and_flush_log(void);
 
@@ -656,13 +816,14 @@ internal void d_ctrl_thread__single_step(DMN_CtrlCtx *ctrl_ctx, D_Msg *msg);
 
 //- rjf: synchronous process memory reading helpers
 internal U64 d_process_read(D_Handle process, Rng1U64 range, void *dst);
+internal U64 d_process_read_many(D_Handle process, U64 count, Rng1U64 *ranges, void **dsts, U64 *read_sizes_out);
 internal B32 d_process_write(D_Handle process, Rng1U64 range, void *dst);
 internal String8 d_data_from_process_vaddr_range(Arena *arena, D_Handle process, Rng1U64 vaddr_range, B32 zero_terminated);
 #define d_process_read_struct(process, vaddr, ptr) d_process_read((process), r1u64((vaddr), (vaddr) + sizeof(*(ptr))), (ptr))
 #define d_process_write_struct(process, vaddr, ptr) d_process_write((process), r1u64((vaddr), (vaddr)+(sizeof(*ptr))), (ptr))
 
 //- rjf: process memory artifact cache
-internal AC_Artifact d_memory_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out);
+internal AC_Artifact d_memory_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out);
 internal void d_memory_artifact_destroy(AC_Artifact artifact);
 internal C_Key d_key_from_process_vaddr_range(D_Handle process, Rng1U64 vaddr_range, B32 zero_terminated, B32 wait_for_fresh, U64 endt_us, B32 *out_is_stale);
 
@@ -674,14 +835,14 @@ internal B32 d_process_memory_read(D_Handle process, Rng1U64 range, B32 *is_stal
 ////////////////////////////////
 //~ rjf: Call Stack Artifact Cache Hooks / Lookups
 
-internal AC_Artifact d_call_stack_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out);
+internal AC_Artifact d_call_stack_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out);
 internal void d_call_stack_artifact_destroy(AC_Artifact artifact);
 internal D_CallStack d_call_stack_from_thread(Access *access, D_Handle thread_handle, B32 high_priority, U64 endt_us);
 
 ////////////////////////////////
 //~ rjf: Call Stack Tree Artifact Cache Hooks / Lookups
 
-internal AC_Artifact d_call_stack_tree_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out);
+internal AC_Artifact d_call_stack_tree_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out);
 internal void d_call_stack_tree_artifact_destroy(AC_Artifact artifact);
 internal D_CallStackTree d_call_stack_tree(Access *access, U64 endt_us);
 
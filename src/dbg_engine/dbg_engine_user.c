@@ -288,6 +288,106 @@ d_cmd_list_push_new(Arena *arena, D_CmdList *cmds, D_CmdKind kind, D_CmdParams *
 // - for any instructions which may change the stack pointer, traps are placed
 //     at them with the "save-stack-pointer | single-step-after" behaviors.
 
+//- line-stepping trap net cache
+
+internal D_TrapNetCache *
+d_trap_net_cache_alloc(void)
+{
+  Arena *arena = arena_alloc();
+  D_TrapNetCache *cache = push_array(arena, D_TrapNetCache, 1);
+  cache->arena = arena;
+  cache->arena_clear_pos = arena_pos(arena);
+  d_trap_net_cache_clear(cache);
+  return cache;
+}
+
+internal void
+d_trap_net_cache_release(D_TrapNetCache *cache)
+{
+  arena_release(cache->arena);
+}
+
+internal void
+d_trap_net_cache_clear(D_TrapNetCache *cache)
+{
+  arena_pop_to(cache->arena, cache->arena_clear_pos);
+  cache->slots_count = 256;
+  cache->slots = push_array(cache->arena, D_TrapNetCacheNode *, cache->slots_count);
+}
+
+internal D_TrapNetCacheNode *
+d_trap_net_cache_node_from_key(D_TrapNetCache *cache, D_TrapNetCacheKey *key)
+{
+  D_TrapNetCacheNode *result = 0;
+  U64 hash = d_hash_from_seed_string(d_hash_from_handle(key->module) ^ key->dbgi_key.u64[0] ^ key->step_kind, str8_struct(&key->voff_range));
+  U64 slot_idx = hash%cache->slots_count;
+  for(D_TrapNetCacheNode *n = cache->slots[slot_idx]; n != 0; n = n->next)
+  {
+    if(n->key.step_kind == key->step_kind &&
+       d_handle_match(n->key.module, key->module) &&
+       di_key_match(n->key.dbgi_key, key->dbgi_key) &&
+       n->key.voff_range.min == key->voff_range.min &&
+       n->key.voff_range.max == key->voff_range.max)
+    {
+      result = n;
+      break;
+    }
+  }
+  return result;
+}
+
+internal B32
+d_trap_net_from_cache(Arena *arena, D_TrapNetCache *cache, D_TrapNetCacheKey *key, U64 mem_gen, String8 machine_code, D_TrapNet *net_out)
+{
+  B32 result = 0;
+  D_TrapNetCacheNode *n = d_trap_net_cache_node_from_key(cache, key);
+  if(n != 0)
+  {
+    // NOTE: without machine code, only the generation the code was read at
+    // can tell that it is unchanged; with it, the bytes themselves can.
+    if(n->mem_gen == mem_gen)
+    {
+      result = 1;
+    }
+    else if(machine_code.size != 0 && str8_match(n->machine_code, machine_code, 0))
+    {
+      n->mem_gen = mem_gen;
+      result = 1;
+    }
+  }
+  if(result)
+  {
+    cache->hit_count += 1;
+    net_out->traps = d_trap_list_copy(arena, &n->traps);
+    net_out->good_line_info = 1;
+    net_out->good_read = 1;
+  }
+  else if(machine_code.size != 0)
+  {
+    cache->miss_count += 1;
+  }
+  return result;
+}
+
+internal void
+d_trap_net_cache_store(D_TrapNetCache *cache, D_TrapNetCacheKey *key, U64 mem_gen, String8 machine_code, D_TrapList *traps)
+{
+  D_TrapNetCacheNode *n = d_trap_net_cache_node_from_key(cache, key);
+  if(n == 0)
+  {
+    U64 hash = d_hash_from_seed_string(d_hash_from_handle(key->module) ^ key->dbgi_key.u64[0] ^ key->step_kind, str8_struct(&key->voff_range));
+    U64 slot_idx = hash%cache->slots_count;
+    n = push_array(cache->arena, D_TrapNetCacheNode, 1);
+    SLLStackPush(cache->slots[slot_idx], n);
+    n->key = *key;
+  }
+  n->mem_gen      = mem_gen;
+  n->machine_code = push_str8_copy(cache->arena, machine_code);
+  n->traps        = d_trap_list_copy(cache->arena, traps);
+}
+
+//- trap net builders
+
 internal D_TrapNet
 d_trap_net_from_thread__step_over_inst(Arena *arena, D_Entity *thread)
 {
@@ -391,10 +491,16 @@ d_trap_net_from_thread__step_over_line(Arena *arena, D_Entity *thread)
   // rjf: line vaddr range => did we find anything successfully?
   B32 good_line_info = (line_vaddr_rng.max != 0);
   
+  // line => cached trap net, if the line's code has not been written since
+  D_TrapNetCache *trap_net_cache = d_user_state->trap_net_cache;
+  D_TrapNetCacheKey trap_net_cache_key = {D_CmdKind_StepOverLine, module->handle, dbgi_key, d_voff_range_from_vaddr_range(module, line_vaddr_rng)};
+  U64 machine_code_mem_gen = d_mem_gen_from_process_vaddr_range(process->handle, line_vaddr_rng);
+  B32 is_cached = (good_line_info && d_trap_net_from_cache(arena, trap_net_cache, &trap_net_cache_key, machine_code_mem_gen, str8_zero(), &result));
+  
   // rjf: line vaddr range => line's machine code
   String8 machine_code = {0};
   B32 good_machine_code = 0;
-  if(good_line_info)
+  if(good_line_info && !is_cached)
   {
     D_ProcessMemorySlice machine_code_slice = d_process_memory_slice_from_vaddr_range(scratch.arena, process->handle, line_vaddr_rng, 0, now_time_us()+50000);
     machine_code = machine_code_slice.data;
@@ -417,9 +523,15 @@ d_trap_net_from_thread__step_over_line(Arena *arena, D_Entity *thread)
     }
   }
   
+  // machine code => cached trap net, if the line's code bytes are unchanged
+  if(good_machine_code && !is_cached)
+  {
+    is_cached = d_trap_net_from_cache(arena, trap_net_cache, &trap_net_cache_key, machine_code_mem_gen, machine_code, &result);
+  }
+  
   // rjf: machine code => ctrl flow analysis
   DASM_CtrlFlowInfo ctrl_flow_info = {0};
-  if(good_machine_code)
+  if(good_machine_code && !is_cached)
   {
     ctrl_flow_info = dasm_ctrl_flow_info_from_arch_vaddr_code(scratch.arena,
                                                               DASM_InstFlag_Call|
@@ -440,7 +552,7 @@ d_trap_net_from_thread__step_over_line(Arena *arena, D_Entity *thread)
   }
   
   // rjf: push traps for all exit points
-  if(good_machine_code) for(DASM_CtrlFlowPointNode *n = ctrl_flow_info.exit_points.first; n != 0; n = n->next)
+  if(good_machine_code && !is_cached) for(DASM_CtrlFlowPointNode *n = ctrl_flow_info.exit_points.first; n != 0; n = n->next)
   {
     DASM_CtrlFlowPoint *point = &n->v;
     D_TrapFlags flags = 0;
@@ -500,7 +612,7 @@ d_trap_net_from_thread__step_over_line(Arena *arena, D_Entity *thread)
   }
   
   // rjf: push traps for natural linear flow
-  if(good_line_info && good_machine_code)
+  if(good_line_info && good_machine_code && !is_cached)
   {
     U64 line_opl_vaddr = line_vaddr_rng.max;
     for EachNode(n, Rng1U64Node, all_vaddr_ranges_on_same_line.first)
@@ -524,12 +636,18 @@ d_trap_net_from_thread__step_over_line(Arena *arena, D_Entity *thread)
   }
   
   // rjf: store goodness
-  if(good_machine_code)
+  if(good_machine_code && !is_cached)
   {
     result.good_line_info = good_line_info;
     result.good_read = good_machine_code;
   }
   
+  // trap net => cache
+  if(good_line_info && good_machine_code && !is_cached)
+  {
+    d_trap_net_cache_store(trap_net_cache, &trap_net_cache_key, machine_code_mem_gen, machine_code, &result.traps);
+  }
+  
   // rjf: log
   LogInfoNamedBlockF("traps") for(D_TrapNode *n = result.traps.first; n != 0; n = n->next)
   {
@@ -545,6 +663,7 @@ internal D_TrapNet
 d_trap_net_from_thread__step_into_line(Arena *arena, D_Entity *thread)
 {
   Temp scratch = scratch_begin(&arena, 1);
+  Access *access = access_open();
   D_TrapNet result = {0};
   
   // rjf: thread => info
@@ -602,19 +721,31 @@ d_trap_net_from_thread__step_into_line(Arena *arena, D_Entity *thread)
   // rjf: line vaddr range => did we find anything successfully?
   B32 good_line_info = (line_vaddr_rng.max != 0);
   
+  // line => cached trap net, if the line's code has not been written since
+  D_TrapNetCache *trap_net_cache = d_user_state->trap_net_cache;
+  D_TrapNetCacheKey trap_net_cache_key = {D_CmdKind_StepIntoLine, module->handle, dbgi_key, d_voff_range_from_vaddr_range(module, line_vaddr_rng)};
+  U64 machine_code_mem_gen = d_mem_gen_from_process_vaddr_range(process->handle, line_vaddr_rng);
+  B32 is_cached = (good_line_info && d_trap_net_from_cache(arena, trap_net_cache, &trap_net_cache_key, machine_code_mem_gen, str8_zero(), &result));
+  
   // rjf: line vaddr range => line's machine code
   String8 machine_code = {0};
   B32 good_machine_code = 0;
-  if(good_line_info)
+  if(good_line_info && !is_cached)
   {
     D_ProcessMemorySlice machine_code_slice = d_process_memory_slice_from_vaddr_range(scratch.arena, process->handle, line_vaddr_rng, 0, now_time_us()+5000);
     machine_code = machine_code_slice.data;
     good_machine_code = (machine_code.size >= dim_1u64(line_vaddr_rng) && !machine_code_slice.any_byte_bad);
   }
   
+  // machine code => cached trap net, if the line's code bytes are unchanged
+  if(good_machine_code && !is_cached)
+  {
+    is_cached = d_trap_net_from_cache(arena, trap_net_cache, &trap_net_cache_key, machine_code_mem_gen, machine_code, &result);
+  }
+  
   // rjf: machine code => ctrl flow analysis
   DASM_CtrlFlowInfo ctrl_flow_info = {0};
-  if(good_machine_code)
+  if(good_machine_code && !is_cached)
   {
     ctrl_flow_info = dasm_ctrl_flow_info_from_arch_vaddr_code(scratch.arena,
                                                               DASM_InstFlag_Call|
@@ -638,7 +769,8 @@ d_trap_net_from_thread__step_into_line(Arena *arena, D_Entity *thread)
   }
   
   // rjf: push traps for all exit points
-  if(good_machine_code) for(DASM_CtrlFlowPointNode *n = ctrl_flow_info.exit_points.first; n != 0; n = n->next)
+  B32 is_cacheable = 1;
+  if(good_machine_code && !is_cached) for(DASM_CtrlFlowPointNode *n = ctrl_flow_info.exit_points.first; n != 0; n = n->next)
   {
     DASM_CtrlFlowPoint *point = &n->v;
     D_TrapFlags flags = 0;
@@ -659,6 +791,14 @@ d_trap_net_from_thread__step_into_line(Arena *arena, D_Entity *thread)
       if(lines.count == 0)
       {
         add = 0;
+        
+        // the destination's debug info may only not be loaded yet, in which
+        // case this trap net must be rebuilt for the next step
+        if(!di_key_match(jump_dest_dbgi_key, di_key_zero()) &&
+           di_rdi_from_key(access, jump_dest_dbgi_key, 1, 0) == &rdi_parsed_nil)
+        {
+          is_cacheable = 0;
+        }
       }
     }
     
@@ -709,7 +849,7 @@ d_trap_net_from_thread__step_into_line(Arena *arena, D_Entity *thread)
   }
   
   // rjf: push traps for natural linear flow
-  if(good_line_info && good_machine_code)
+  if(good_line_info && good_machine_code && !is_cached)
   {
     U64 line_opl_vaddr = line_vaddr_rng.max;
     for EachNode(n, Rng1U64Node, all_vaddr_ranges_on_same_line.first)
@@ -733,11 +873,19 @@ d_trap_net_from_thread__step_into_line(Arena *arena, D_Entity *thread)
   }
   
   // rjf: store goodness
+  if(!is_cached)
   {
     result.good_line_info = good_line_info;
     result.good_read = good_machine_code;
   }
   
+  // trap net => cache
+  if(good_line_info && good_machine_code && !is_cached && is_cacheable)
+  {
+    d_trap_net_cache_store(trap_net_cache, &trap_net_cache_key, machine_code_mem_gen, machine_code, &result.traps);
+  }
+  
+  access_close(access);
   scratch_end(scratch);
   return result;
 }
@@ -1626,6 +1774,12 @@ d_tick(Arena *arena, D_TargetArray *targets, D_BreakpointArray *breakpoints, D_P
           MTX_Op op = {r1u64(max_U64, max_U64), event->string};
           mtx_push_op(d_user_state->output_log_key, op);
         }break;
+        
+        case D_EventKind_NewModule:
+        case D_EventKind_EndModule:
+        {
+          d_trap_net_cache_clear(d_user_state->trap_net_cache);
+        }break;
       }
       log_infof("}\n\n");
     }
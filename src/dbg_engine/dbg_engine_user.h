@@ -151,6 +151,45 @@ struct D_RunLocalsCache
   D_RunLocalsCacheSlot *table;
 };
 
+//- line-stepping trap net cache
+//
+// Trap nets for line steps, keyed by (step kind, module, debug info, line voff
+// range), so that stepping through the same lines again (e.g. a loop body)
+// does not re-disassemble them. Each node keeps the line's machine code & the
+// memory generation it was read at; an unchanged generation is a hit without
+// any read, & a changed one is still a hit if the code bytes match. Cleared
+// whenever modules are loaded or unloaded.
+
+typedef struct D_TrapNetCacheKey D_TrapNetCacheKey;
+struct D_TrapNetCacheKey
+{
+  D_CmdKind step_kind;
+  D_Handle module;
+  DI_Key dbgi_key;
+  Rng1U64 voff_range;
+};
+
+typedef struct D_TrapNetCacheNode D_TrapNetCacheNode;
+struct D_TrapNetCacheNode
+{
+  D_TrapNetCacheNode *next;
+  D_TrapNetCacheKey key;
+  U64 mem_gen;
+  String8 machine_code;
+  D_TrapList traps;
+};
+
+typedef struct D_TrapNetCache D_TrapNetCache;
+struct D_TrapNetCache
+{
+  Arena *arena;
+  U64 arena_clear_pos;
+  U64 slots_count;
+  D_TrapNetCacheNode **slots;
+  U64 hit_count;
+  U64 miss_count;
+};
+
 ////////////////////////////////
 //~ rjf: User -> Ctrl Message Types
 
@@ -358,6 +397,7 @@ struct D_UserState
   U64 member_cache_reggen_idx;
   D_RunLocalsCache member_caches[2];
   U64 member_cache_gen;
+  D_TrapNetCache *trap_net_cache;
   
   // rjf: user -> ctrl driving state
   Arena *ctrl_last_run_arena;
@@ -420,6 +460,15 @@ internal void d_cmd_list_push_new(Arena *arena, D_CmdList *cmds, D_CmdKind kind,
 ////////////////////////////////
 //~ rjf: Stepping "Trap Net" Builders
 
+//- line-stepping trap net cache
+internal D_TrapNetCache *d_trap_net_cache_alloc(void);
+internal void d_trap_net_cache_release(D_TrapNetCache *cache);
+internal void d_trap_net_cache_clear(D_TrapNetCache *cache);
+internal D_TrapNetCacheNode *d_trap_net_cache_node_from_key(D_TrapNetCache *cache, D_TrapNetCacheKey *key);
+internal B32 d_trap_net_from_cache(Arena *arena, D_TrapNetCache *cache, D_TrapNetCacheKey *key, U64 mem_gen, String8 machine_code, D_TrapNet *net_out);
+internal void d_trap_net_cache_store(D_TrapNetCache *cache, D_TrapNetCacheKey *key, U64 mem_gen, String8 machine_code, D_TrapList *traps);
+
+//- trap net builders
 internal D_TrapNet d_trap_net_from_thread__step_over_inst(Arena *arena, D_Entity *thread);
 internal D_TrapNet d_trap_net_from_thread__step_over_line(Arena *arena, D_Entity *thread);
 internal D_TrapNet d_trap_net_from_thread__step_into_line(Arena *arena, D_Entity *thread);
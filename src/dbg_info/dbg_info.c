@@ -331,6 +331,7 @@ di_close(DI_Key key, B32 force_closed)
   FileProperties file_props = {0};
   void *file_base = 0;
   Arena *arena = 0;
+  DI_SectionUnpackCache *section_unpack_cache = 0;
   RWMutexScope(stripe->rw_mutex, 1)
   {
     DI_Node *node = 0;
@@ -367,6 +368,7 @@ di_close(DI_Key key, B32 force_closed)
             file_props = node->file_props;
             file_base = node->file_base;
             arena = node->arena;
+            section_unpack_cache = (DI_SectionUnpackCache *)node->rdi.section_unpack_user_data;
             break;
           }
           cond_var_wait_rw(stripe->cv, stripe->rw_mutex, 1, max_U64);
@@ -383,6 +385,7 @@ di_close(DI_Key key, B32 force_closed)
     file_map_view_close(file_map, file_base, r1u64(0, file_props.size));
     file_map_close(file_map);
     file_close(file);
+    di_section_unpack_cache_release(section_unpack_cache);
     if(arena != 0)
     {
       arena_release(arena);
@@ -390,6 +393,55 @@ di_close(DI_Key key, B32 force_closed)
   }
 }
 
+////////////////////////////////
+//~ Lazy RDI Section Unpacking
+
+internal DI_SectionUnpackCache *
+di_section_unpack_cache_alloc(Arena *arena, RDI_Parsed *rdi)
+{
+  DI_SectionUnpackCache *cache = push_array(arena, DI_SectionUnpackCache, 1);
+  cache->arena = arena;
+  cache->mutex = mutex_alloc();
+  cache->sections_count = rdi->sections_count;
+  cache->sections_data = push_array(arena, U64, cache->sections_count);
+  return cache;
+}
+
+internal void
+di_section_unpack_cache_release(DI_SectionUnpackCache *cache)
+{
+  if(cache != 0)
+  {
+    mutex_release(cache->mutex);
+  }
+}
+
+internal void *
+di_rdi_section_unpack(void *user_data, RDI_Parsed *rdi, RDI_SectionKind kind)
+{
+  DI_SectionUnpackCache *cache = (DI_SectionUnpackCache *)user_data;
+  void *result = 0;
+  if(0 <= kind && kind < cache->sections_count)
+  {
+    result = (void *)ins_atomic_u64_eval(&cache->sections_data[kind]);
+    if(result == 0) MutexScope(cache->mutex)
+    {
+      result = (void *)ins_atomic_u64_eval(&cache->sections_data[kind]);
+      if(result == 0) ProfScope("unpack rdi section %i", (int)kind)
+      {
+        U64 unpacked_size = rdi->sections[kind].unpacked_size;
+        U8 *unpacked_data = push_array_no_zero(cache->arena, U8, unpacked_size);
+        if(rdi_decompress_section(unpacked_data, unpacked_size, rdi, kind))
+        {
+          result = unpacked_data;
+          ins_atomic_u64_eval_assign(&cache->sections_data[kind], (U64)result);
+        }
+      }
+    }
+  }
+  return result;
+}
+
 ////////////////////////////////
 //~ rjf: Debug Info Lookups
 
@@ -959,7 +1011,8 @@ di_async_tick(void)
         (void)parse_status;
       }
       
-      //- rjf: decompress & re-parse, if necessary
+      //- rjf: if compressed, set up lazy unpacking; each section is
+      // decompressed on its first touch, rather than all sections up-front
       Arena *rdi_parsed_arena = 0;
       RDI_Parsed rdi_parsed = rdi_parsed_maybe_compressed;
       {
@@ -967,10 +1020,8 @@ di_async_tick(void)
         if(decompressed_size > file_props.size)
         {
           rdi_parsed_arena = arena_alloc();
-          U8 *decompressed_data = push_array_no_zero(rdi_parsed_arena, U8, decompressed_size);
-          rdi_decompress_parsed(decompressed_data, decompressed_size, &rdi_parsed_maybe_compressed);
-          RDI_ParseStatus parse_status = rdi_parse(decompressed_data, decompressed_size, &rdi_parsed);
-          (void)parse_status;
+          rdi_parsed.section_unpack_function = di_rdi_section_unpack;
+          rdi_parsed.section_unpack_user_data = di_section_unpack_cache_alloc(rdi_parsed_arena, &rdi_parsed);
         }
       }
       
@@ -1010,6 +1061,7 @@ di_async_tick(void)
           }
           else
           {
+            di_section_unpack_cache_release((DI_SectionUnpackCache *)rdi_parsed.section_unpack_user_data);
             if(rdi_parsed_arena != 0)
             {
               arena_release(rdi_parsed_arena);
@@ -1073,11 +1125,406 @@ di_conversion_completion_signal_receiver_thread_entry_point(void *p)
   }
 }
 
+////////////////////////////////
+//~ Search Index Building / Queries
+
+internal U32
+di_search_index_char_fold(U8 c)
+{
+  U32 result = (U32)(correct_slash_from_char(upper_from_char(c)) & 0x3f);
+  return result;
+}
+
+internal String8
+di_search_name_from_rdi_element(Arena *arena, RDI_Parsed *rdi, RDI_SectionKind section_kind, void *element)
+{
+  String8 name = {0};
+  switch(section_kind)
+  {
+    case RDI_SectionKind_UDTs:
+    {
+      RDI_UDT *udt = (RDI_UDT *)element;
+      RDI_TypeNode *type_node = rdi_element_from_name_idx(rdi, TypeNodes, udt->self_type_idx);
+      name = fully_qualified_from_rdi_string_and_container(arena, rdi, type_node->user_defined.name_string_idx, udt->container_idx, udt->container_flags);
+    }break;
+    case RDI_SectionKind_SourceFiles:
+    {
+      Temp scratch = scratch_begin(&arena, 1);
+      RDI_SourceFile *file = (RDI_SourceFile *)element;
+      String8List path_parts = {0};
+      for(RDI_FilePathNode *fpn = rdi_element_from_name_idx(rdi, FilePathNodes, file->file_path_node_idx);
+          fpn != rdi_element_from_name_idx(rdi, FilePathNodes, 0);
+          fpn = rdi_element_from_name_idx(rdi, FilePathNodes, fpn->parent_path_node))
+      {
+        String8 path_part = {0};
+        path_part.str = rdi_string_from_idx(rdi, fpn->name_string_idx, &path_part.size);
+        str8_list_push_front(scratch.arena, &path_parts, path_part);
+      }
+      StringJoin join = {0};
+      join.sep = str8_lit("/");
+      name = str8_list_join(arena, &path_parts, &join);
+      scratch_end(scratch);
+    }break;
+    default:
+    {
+      RDI_Symbol *symbol = (RDI_Symbol *)element;
+      name = fully_qualified_str8_from_rdi_symbol(arena, rdi, symbol);
+    }break;
+  }
+  return name;
+}
+
+internal String8
+di_search_index_name_from_rdi_element_idx(Arena *arena, void *user_data, U64 idx)
+{
+  DI_SearchIndexRDINameParams *params = (DI_SearchIndexRDINameParams *)user_data;
+  U64 element_count = 0;
+  void *table_base = rdi_section_raw_table_from_kind(params->rdi, params->section_kind, &element_count);
+  U64 element_size = rdi_section_element_size_table[params->section_kind];
+  String8 name = {0};
+  if(idx < element_count)
+  {
+    name = di_search_name_from_rdi_element(arena, params->rdi, params->section_kind, (U8 *)table_base + element_size*idx);
+  }
+  return name;
+}
+
+internal DI_SearchIndex *
+di_search_index_build(Arena *arena, U64 element_count, DI_SearchIndexNameFunctionType *name_function, void *name_function_user_data, B32 *cancel_signal)
+{
+  // NOTE: called on all lanes; the index is allocated on lane 0's `arena`.
+  ProfBeginFunction();
+  Temp scratch = scratch_begin(&arena, 1);
+  DI_SearchIndex *index = 0;
+  
+  //- set up per-lane trigram counts & offsets
+  U32 **lanes_trigram_counts = 0;
+  U32 **lanes_trigram_offs = 0;
+  if(lane_idx() == 0)
+  {
+    lanes_trigram_counts = push_array(scratch.arena, U32 *, lane_count());
+    lanes_trigram_offs = push_array(scratch.arena, U32 *, lane_count());
+  }
+  lane_sync_u64(&lanes_trigram_counts, 0);
+  lane_sync_u64(&lanes_trigram_offs, 0);
+  U32 *trigram_counts = lanes_trigram_counts[lane_idx()] = push_array(scratch.arena, U32, DI_SEARCH_INDEX_TRIGRAM_COUNT);
+  U32 *trigram_offs = lanes_trigram_offs[lane_idx()] = push_array(scratch.arena, U32, DI_SEARCH_INDEX_TRIGRAM_COUNT);
+  
+  //- gather the unique trigrams of each element in this lane's range
+  Arena *trigrams_arena = arena_alloc();
+  Rng1U64 range = lane_range(element_count);
+  U32 **elements_trigrams = push_array(scratch.arena, U32 *, dim_1u64(range));
+  U32 *elements_trigrams_counts = push_array(scratch.arena, U32, dim_1u64(range));
+  ProfScope("gather unique trigrams")
+  {
+    U64 *trigram_bits = push_array(scratch.arena, U64, DI_SEARCH_INDEX_TRIGRAM_COUNT/64);
+    for EachInRange(idx, range)
+    {
+      if(idx%10000 == 0 && !!ins_atomic_u32_eval(cancel_signal))
+      {
+        break;
+      }
+      Temp temp = temp_begin(scratch.arena);
+      String8 name = name_function(temp.arena, name_function_user_data, idx);
+      if(name.size >= 3)
+      {
+        U32 *trigrams = push_array_no_zero(trigrams_arena, U32, name.size-2);
+        U32 trigrams_count = 0;
+        U32 trigram = (di_search_index_char_fold(name.str[0])<<6) | di_search_index_char_fold(name.str[1]);
+        for(U64 off = 2; off < name.size; off += 1)
+        {
+          trigram = ((trigram<<6) | di_search_index_char_fold(name.str[off])) & (DI_SEARCH_INDEX_TRIGRAM_COUNT-1);
+          U64 bit = (1ull<<(trigram%64));
+          if(!(trigram_bits[trigram/64] & bit))
+          {
+            trigram_bits[trigram/64] |= bit;
+            trigrams[trigrams_count] = trigram;
+            trigrams_count += 1;
+            trigram_counts[trigram] += 1;
+          }
+        }
+        for EachIndex(trigram_idx, trigrams_count)
+        {
+          trigram_bits[trigrams[trigram_idx]/64] = 0;
+        }
+        arena_pop(trigrams_arena, sizeof(U32)*(name.size-2-trigrams_count));
+        elements_trigrams[idx-range.min] = trigrams;
+        elements_trigrams_counts[idx-range.min] = trigrams_count;
+      }
+      temp_end(temp);
+    }
+  }
+  lane_sync();
+  
+  //- decide if we cancelled
+  B32 cancelled = 0;
+  if(lane_idx() == 0 && !!ins_atomic_u32_eval(cancel_signal))
+  {
+    cancelled = 1;
+  }
+  lane_sync_u64(&cancelled, 0);
+  
+  //- allocate index
+  if(!cancelled && lane_idx() == 0)
+  {
+    index = push_array(arena, DI_SearchIndex, 1);
+    index->element_count = element_count;
+    index->trigram_postings_offs = push_array_no_zero(arena, U64, DI_SEARCH_INDEX_TRIGRAM_COUNT+1);
+  }
+  lane_sync_u64(&index, 0);
+  
+  //- compute lane * trigram *relative* offsets, & per-trigram totals
+  if(!cancelled)
+  {
+    Rng1U64 trigram_range = lane_range(DI_SEARCH_INDEX_TRIGRAM_COUNT);
+    for EachInRange(trigram, trigram_range)
+    {
+      U32 layout_off = 0;
+      for EachIndex(lane_idx, lane_count())
+      {
+        lanes_trigram_offs[lane_idx][trigram] = layout_off;
+        layout_off += lanes_trigram_counts[lane_idx][trigram];
+      }
+      index->trigram_postings_offs[trigram] = layout_off;
+    }
+  }
+  lane_sync();
+  
+  //- convert per-trigram totals -> absolute offsets; allocate postings
+  if(!cancelled && lane_idx() == 0)
+  {
+    U64 last_off = 0;
+    for EachIndex(trigram, DI_SEARCH_INDEX_TRIGRAM_COUNT)
+    {
+      U64 count = index->trigram_postings_offs[trigram];
+      index->trigram_postings_offs[trigram] = last_off;
+      last_off += count;
+    }
+    index->trigram_postings_offs[DI_SEARCH_INDEX_TRIGRAM_COUNT] = last_off;
+    index->postings_count = last_off;
+    index->postings = push_array_no_zero(arena, U32, index->postings_count);
+  }
+  lane_sync();
+  
+  //- fill postings; lanes own ascending element ranges & are laid out in
+  // lane order, so every trigram's postings come out sorted
+  if(!cancelled) ProfScope("fill postings")
+  {
+    for EachInRange(idx, range)
+    {
+      U32 *trigrams = elements_trigrams[idx-range.min];
+      U32 trigrams_count = elements_trigrams_counts[idx-range.min];
+      for EachIndex(trigram_idx, trigrams_count)
+      {
+        U32 trigram = trigrams[trigram_idx];
+        index->postings[index->trigram_postings_offs[trigram] + trigram_offs[trigram]] = (U32)idx;
+        trigram_offs[trigram] += 1;
+      }
+    }
+  }
+  lane_sync();
+  
+  arena_release(trigrams_arena);
+  scratch_end(scratch);
+  ProfEnd();
+  return index;
+}
+
+internal int
+di_search_posting_list_qsort_compare__count_ascending(DI_SearchPostingList *a, DI_SearchPostingList *b)
+{
+  int result = 0;
+  if(a->count < b->count)
+  {
+    result = -1;
+  }
+  else if(a->count > b->count)
+  {
+    result = +1;
+  }
+  return result;
+}
+
+internal DI_SearchPostingListArray
+di_search_posting_list_array_from_query(Arena *arena, DI_SearchIndex *index, String8 query)
+{
+  // NOTE: an empty result means the query has no part long enough to
+  // filter on (all elements are candidates); a list of count zero means
+  // nothing can match.
+  DI_SearchPostingListArray result = {0};
+  Temp scratch = scratch_begin(&arena, 1);
+  String8List parts = str8_split(scratch.arena, query, (U8 *)" ", 1, 0);
+  U64 lists_count = 0;
+  for EachNode(n, String8Node, parts.first)
+  {
+    lists_count += (n->string.size >= 3) ? (n->string.size-2) : 0;
+  }
+  if(lists_count != 0)
+  {
+    result.v = push_array(arena, DI_SearchPostingList, lists_count);
+    for EachNode(n, String8Node, parts.first)
+    {
+      if(n->string.size < 3)
+      {
+        continue;
+      }
+      U32 trigram = (di_search_index_char_fold(n->string.str[0])<<6) | di_search_index_char_fold(n->string.str[1]);
+      for(U64 off = 2; off < n->string.size; off += 1)
+      {
+        trigram = ((trigram<<6) | di_search_index_char_fold(n->string.str[off])) & (DI_SEARCH_INDEX_TRIGRAM_COUNT-1);
+        DI_SearchPostingList *list = &result.v[result.count];
+        list->v = index->postings + index->trigram_postings_offs[trigram];
+        list->count = index->trigram_postings_offs[trigram+1] - index->trigram_postings_offs[trigram];
+        result.count += 1;
+      }
+    }
+    quick_sort(result.v, result.count, sizeof(result.v[0]), di_search_posting_list_qsort_compare__count_ascending);
+  }
+  scratch_end(scratch);
+  return result;
+}
+
+internal B32
+di_search_posting_lists_contain(DI_SearchPostingList *lists, U64 lists_count, U64 *cursors, U32 idx)
+{
+  // NOTE: `idx` must not decrease across calls sharing `cursors`; each
+  // cursor is left at the lower bound of `idx` in its list.
+  B32 result = 1;
+  for EachIndex(list_idx, lists_count)
+  {
+    DI_SearchPostingList *list = &lists[list_idx];
+    U64 min = cursors[list_idx];
+    U64 max = list->count;
+    for(;min < max;)
+    {
+      U64 mid = min + (max-min)/2;
+      if(list->v[mid] < idx)
+      {
+        min = mid+1;
+      }
+      else
+      {
+        max = mid;
+      }
+    }
+    cursors[list_idx] = min;
+    if(min >= list->count || list->v[min] != idx)
+    {
+      result = 0;
+      break;
+    }
+  }
+  return result;
+}
+
+////////////////////////////////
+//~ Search Index Artifact Cache Hooks / Lookups
+
+internal AC_Artifact
+di_search_index_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
+{
+  ProfBeginFunction();
+  Access *access = access_open();
+  AC_Artifact artifact = {0};
+  {
+    //- unpack key
+    DI_Key dbgi_key = {0};
+    RDI_SectionKind section_kind = RDI_SectionKind_NULL;
+    {
+      U64 key_read_off = 0;
+      key_read_off += str8_deserial_read_struct(key, key_read_off, &dbgi_key);
+      key_read_off += str8_deserial_read_struct(key, key_read_off, &section_kind);
+    }
+    
+    //- map key -> RDI
+    RDI_Parsed *rdi = &rdi_parsed_nil;
+    if(lane_idx() == 0)
+    {
+      rdi = di_rdi_from_key(access, dbgi_key, 0, 0);
+    }
+    lane_sync_u64(&rdi, 0);
+    
+    //- build index
+    Arena *arena = 0;
+    DI_SearchIndex *index = 0;
+    if(rdi != &rdi_parsed_nil)
+    {
+      if(lane_idx() == 0)
+      {
+        arena = arena_alloc();
+      }
+      lane_sync_u64(&arena, 0);
+      U64 element_count = 0;
+      rdi_section_raw_table_from_kind(rdi, section_kind, &element_count);
+      DI_SearchIndexRDINameParams name_params = {rdi, section_kind};
+      index = di_search_index_build(arena, element_count, di_search_index_name_from_rdi_element_idx, &name_params, cancel_signal);
+    }
+    
+    //- bundle as artifact; if the debug info was not loaded or we were
+    // cancelled, complete with a zero generation, so the next lookup (which
+    // asks for generation 1) treats this as stale & requests again
+    if(index != 0)
+    {
+      artifact.u64[0] = (U64)arena;
+      artifact.u64[1] = (U64)index;
+      if(lane_idx() == 0)
+      {
+        size_out[0] = arena_pos(arena);
+      }
+    }
+    else
+    {
+      gen_out[0] = 0;
+      if(lane_idx() == 0 && arena != 0)
+      {
+        arena_release(arena);
+      }
+    }
+  }
+  access_close(access);
+  ProfEnd();
+  return artifact;
+}
+
+internal void
+di_search_index_artifact_destroy(AC_Artifact artifact)
+{
+  Arena *arena = (Arena *)artifact.u64[0];
+  if(arena != 0)
+  {
+    arena_release(arena);
+  }
+}
+
+internal DI_SearchIndex *
+di_search_index_from_key_section(Access *access, DI_Key key, RDI_SectionKind section_kind, U64 endt_us)
+{
+  DI_SearchIndex *index = 0;
+  {
+    Temp scratch = scratch_begin(0, 0);
+    
+    // form key
+    String8List key_parts = {0};
+    str8_list_push(scratch.arena, &key_parts, str8_struct(&key));
+    str8_list_push(scratch.arena, &key_parts, str8_struct(&section_kind));
+    String8 artifact_key = str8_list_join(scratch.arena, &key_parts, 0);
+    
+    // get artifact
+    AC_Artifact artifact = ac_artifact_from_key(access, artifact_key, di_search_index_artifact_create, di_search_index_artifact_destroy, endt_us, .gen = 1, .flags = AC_Flag_Wide, .evict_threshold_us = 60000000);
+    
+    // unpack artifact
+    index = (DI_SearchIndex *)artifact.u64[1];
+    
+    scratch_end(scratch);
+  }
+  return index;
+}
+
 ////////////////////////////////
 //~ rjf: Search Artifact Cache Hooks / Lookups
 
 internal AC_Artifact
-di_search_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out)
+di_search_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   ProfBeginFunction();
   Access *access = access_open();
@@ -1107,20 +1554,28 @@ di_search_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *
       lane_sync_u64(&keys.count, 0);
     }
     
-    //- rjf: map all debug info keys -> RDIs
+    //- map all debug info keys -> RDIs & search indices (requesting
+    // indices which are not yet built; we fall back to full scans until then)
     RDI_Parsed **rdis = 0;
+    DI_SearchIndex **indexes = 0;
     ProfScope("map all debug info keys -> RDIs")
     {
       if(lane_idx() == 0)
       {
         rdis = push_array(scratch.arena, RDI_Parsed *, keys.count);
+        indexes = push_array(scratch.arena, DI_SearchIndex *, keys.count);
       }
       lane_sync_u64(&rdis, 0);
+      lane_sync_u64(&indexes, 0);
       {
         Rng1U64 range = lane_range(keys.count);
         for EachInRange(idx, range)
         {
           rdis[idx] = di_rdi_from_key(access, keys.v[idx], 0, 0);
+          if(rdis[idx] != &rdi_parsed_nil)
+          {
+            indexes[idx] = di_search_index_from_key_section(access, keys.v[idx], section_kind, 0);
+          }
         }
       }
     }
@@ -1156,51 +1611,47 @@ di_search_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *
           void *table_base = rdi_section_raw_table_from_kind(rdi, section_kind, &element_count);
           U64 element_size = rdi_section_element_size_table[section_kind];
           
+          // narrow to candidates via the search index, if it is built &
+          // the query has a part long enough to filter on
+          U64 candidates_count = element_count;
+          DI_SearchPostingListArray lists = {0};
+          U64 *lists_cursors = 0;
+          DI_SearchIndex *index = indexes[rdi_idx];
+          if(index != 0 && index->element_count == element_count)
+          {
+            lists = di_search_posting_list_array_from_query(scratch.arena, index, query);
+            if(lists.count != 0)
+            {
+              candidates_count = lists.v[0].count;
+              lists_cursors = push_array(scratch.arena, U64, lists.count);
+            }
+          }
+          
           // rjf: do search
-          Rng1U64 range = lane_range(element_count);
-          for EachInRange(idx, range)
+          Rng1U64 range = lane_range(candidates_count);
+          for EachInRange(candidate_idx, range)
           {
             //- rjf: every so often, check if we need to cancel, and cancel
-            if(idx%10000 == 0 && !!ins_atomic_u32_eval(cancel_signal))
+            if(candidate_idx%10000 == 0 && !!ins_atomic_u32_eval(cancel_signal))
             {
               break;
             }
             
-            //- rjf: get element, map to string; if empty, continue to next element
-            void *element = (U8 *)table_base + element_size*idx;
-            String8 name = {0};
-            switch(section_kind)
+            //- map candidate -> element index; skip if it is missing any
+            // other query trigram
+            U64 idx = candidate_idx;
+            if(lists.count != 0)
             {
-              case RDI_SectionKind_UDTs:
+              idx = lists.v[0].v[candidate_idx];
+              if(!di_search_posting_lists_contain(lists.v+1, lists.count-1, lists_cursors+1, (U32)idx))
               {
-                RDI_UDT *udt = (RDI_UDT *)element;
-                RDI_TypeNode *type_node = rdi_element_from_name_idx(rdi, TypeNodes, udt->self_type_idx);
-                name = fully_qualified_from_rdi_string_and_container(arena, rdi, type_node->user_defined.name_string_idx, udt->container_idx, udt->container_flags);
-              }break;
-              case RDI_SectionKind_SourceFiles:
-              {
-                Temp scratch = scratch_begin(&arena, 1);
-                RDI_SourceFile *file = (RDI_SourceFile *)element;
-                String8List path_parts = {0};
-                for(RDI_FilePathNode *fpn = rdi_element_from_name_idx(rdi, FilePathNodes, file->file_path_node_idx);
-                    fpn != rdi_element_from_name_idx(rdi, FilePathNodes, 0);
-                    fpn = rdi_element_from_name_idx(rdi, FilePathNodes, fpn->parent_path_node))
-                {
-                  String8 path_part = {0};
-                  path_part.str = rdi_string_from_idx(rdi, fpn->name_string_idx, &path_part.size);
-                  str8_list_push_front(scratch.arena, &path_parts, path_part);
-                }
-                StringJoin join = {0};
-                join.sep = str8_lit("/");
-                name = str8_list_join(arena, &path_parts, &join);
-                scratch_end(scratch);
-              }break;
-              default:
-              {
-                RDI_Symbol *symbol = (RDI_Symbol *)element;
-                name = fully_qualified_str8_from_rdi_symbol(arena, rdi, symbol);
-              }break;
+                continue;
+              }
             }
+            
+            //- rjf: get element, map to string; if empty, continue to next element
+            void *element = (U8 *)table_base + element_size*idx;
+            String8 name = di_search_name_from_rdi_element(arena, rdi, section_kind, element);
             if(name.size == 0) { continue; }
             
             //- rjf: fuzzy match against query
@@ -1432,6 +1883,13 @@ di_search_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *
       artifact.u64[1] = arenas_count;
       artifact.u64[2] = (U64)items.v;
       artifact.u64[3] = items.count;
+      if(lane_idx() == 0)
+      {
+        for EachIndex(idx, arenas_count)
+        {
+          size_out[0] += arena_pos(arenas[idx]);
+        }
+      }
     }
     
     //- rjf: release results on cancel
@@ -1494,7 +1952,7 @@ di_search_item_array_from_target_query(Access *access, RDI_SectionKind target, S
 //~ rjf: Match Artifact Cache Hooks / Lookups
 
 internal AC_Artifact
-di_match_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out)
+di_match_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   ProfBeginFunction();
   Temp scratch = scratch_begin(0, 0);
@@ -58,6 +58,15 @@ struct DI_KeySlot
 ////////////////////////////////
 //~ rjf: Debug Info Cache Types
 
+typedef struct DI_SectionUnpackCache DI_SectionUnpackCache;
+struct DI_SectionUnpackCache
+{
+  Arena *arena;
+  Mutex mutex;
+  U64 *sections_data; // [sections_count], unpacked section data addresses, 0 until first touched
+  U64 sections_count;
+};
+
 typedef struct DI_Node DI_Node;
 struct DI_Node
 {
@@ -193,6 +202,50 @@ struct DI_SearchItemArray
   U64 count;
 };
 
+////////////////////////////////
+//~ Search Index Types
+//
+// Per-(debug info, section) index from name trigrams to the sorted element
+// indices whose names contain them. Characters are folded the same way fuzzy
+// matching compares them (case- and slash-insensitive) and truncated to 6
+// bits, so a trigram is an 18-bit key; collisions only cost extra candidates,
+// which fuzzy_match_find then rejects.
+
+#define DI_SEARCH_INDEX_TRIGRAM_BITS  18
+#define DI_SEARCH_INDEX_TRIGRAM_COUNT (1<<DI_SEARCH_INDEX_TRIGRAM_BITS)
+
+typedef String8 DI_SearchIndexNameFunctionType(Arena *arena, void *user_data, U64 idx);
+
+typedef struct DI_SearchIndex DI_SearchIndex;
+struct DI_SearchIndex
+{
+  U64 element_count;
+  U64 *trigram_postings_offs; // [DI_SEARCH_INDEX_TRIGRAM_COUNT+1]
+  U32 *postings;
+  U64 postings_count;
+};
+
+typedef struct DI_SearchPostingList DI_SearchPostingList;
+struct DI_SearchPostingList
+{
+  U32 *v;
+  U64 count;
+};
+
+typedef struct DI_SearchPostingListArray DI_SearchPostingListArray;
+struct DI_SearchPostingListArray
+{
+  DI_SearchPostingList *v;
+  U64 count;
+};
+
+typedef struct DI_SearchIndexRDINameParams DI_SearchIndexRDINameParams;
+struct DI_SearchIndexRDINameParams
+{
+  RDI_Parsed *rdi;
+  RDI_SectionKind section_kind;
+};
+
 ////////////////////////////////
 //~ rjf: Match Types
 
@@ -326,6 +379,13 @@ internal DI_Key di_key_from_path_timestamp(String8 path, U64 min_timestamp);
 internal void di_open(DI_Key key);
 internal void di_close(DI_Key key, B32 force_closed);
 
+////////////////////////////////
+//~ Lazy RDI Section Unpacking
+
+internal DI_SectionUnpackCache *di_section_unpack_cache_alloc(Arena *arena, RDI_Parsed *rdi);
+internal void di_section_unpack_cache_release(DI_SectionUnpackCache *cache);
+internal void *di_rdi_section_unpack(void *user_data, RDI_Parsed *rdi, RDI_SectionKind kind);
+
 ////////////////////////////////
 //~ rjf: Debug Info Lookups
 
@@ -350,17 +410,34 @@ internal void di_async_tick(void);
 internal void di_signal_completion(void);
 internal void di_conversion_completion_signal_receiver_thread_entry_point(void *p);
 
+////////////////////////////////
+//~ Search Index Building / Queries
+
+internal U32 di_search_index_char_fold(U8 c);
+internal String8 di_search_name_from_rdi_element(Arena *arena, RDI_Parsed *rdi, RDI_SectionKind section_kind, void *element);
+internal String8 di_search_index_name_from_rdi_element_idx(Arena *arena, void *user_data, U64 idx);
+internal DI_SearchIndex *di_search_index_build(Arena *arena, U64 element_count, DI_SearchIndexNameFunctionType *name_function, void *name_function_user_data, B32 *cancel_signal);
+internal DI_SearchPostingListArray di_search_posting_list_array_from_query(Arena *arena, DI_SearchIndex *index, String8 query);
+internal B32 di_search_posting_lists_contain(DI_SearchPostingList *lists, U64 lists_count, U64 *cursors, U32 idx);
+
+////////////////////////////////
+//~ Search Index Artifact Cache Hooks / Lookups
+
+internal AC_Artifact di_search_index_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out);
+internal void di_search_index_artifact_destroy(AC_Artifact artifact);
+internal DI_SearchIndex *di_search_index_from_key_section(Access *access, DI_Key key, RDI_SectionKind section_kind, U64 endt_us);
+
 ////////////////////////////////
 //~ rjf: Search Artifact Cache Hooks / Lookups
 
-internal AC_Artifact di_search_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out);
+internal AC_Artifact di_search_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out);
 internal void di_search_artifact_destroy(AC_Artifact artifact);
 internal DI_SearchItemArray di_search_item_array_from_target_query(Access *access, RDI_SectionKind target, String8 query, U64 endt_us, B32 *stale_out);
 
 ////////////////////////////////
 //~ rjf: Match Artifact Cache Hooks / Lookups
 
-internal AC_Artifact di_match_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out);
+internal AC_Artifact di_match_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out);
 internal DI_Match di_match_from_string(String8 string, U64 match_index, DI_Key preferred_dbgi_key, U64 endt_us);
 
 #endif // DBG_INFO_H
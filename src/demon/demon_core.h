@@ -132,6 +132,15 @@ struct DMN_Trap
   U64 id;
   DMN_TrapFlags flags;
   U32 size;
+  
+  // optional native code for a software trap's condition (see
+  // `x64_cond_trampoline_from_code`), plus the size of the instruction at
+  // `vaddr`, & the offset of its rip-relative displacement (0 if it has none).
+  // backends may use these to test the condition inside the process, & only
+  // report a breakpoint when it is nonzero; they are free to ignore them.
+  String8 condition_code;
+  U32 condition_site_size;
+  U32 condition_site_rip_disp_off;
 };
 
 typedef struct DMN_TrapChunkNode DMN_TrapChunkNode;
@@ -244,7 +253,9 @@ internal void dmn_process_memory_decommit(DMN_Handle process, U64 vaddr, U64 siz
 internal void dmn_process_memory_release(DMN_Handle process, U64 vaddr, U64 size);
 internal void dmn_process_memory_protect(DMN_Handle process, U64 vaddr, U64 size, AccessFlags flags);
 internal U64 dmn_process_read(DMN_Handle process, Rng1U64 range, void *dst);
+internal U64 dmn_process_read_many(DMN_Handle process, U64 count, Rng1U64 *ranges, void **dsts, U64 *read_sizes_out);
 internal B32 dmn_process_write(DMN_Handle process, Rng1U64 range, void *src);
+internal U64 dmn_process_memory_gen_from_range(DMN_Handle process, Rng1U64 range); // 0 if the backend cannot track writes to the range
 
 //- rjf: threads
 internal Arch dmn_arch_from_thread(DMN_Handle handle);
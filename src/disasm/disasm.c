@@ -146,7 +146,7 @@ struct DASM_Artifact
 };
 
 internal AC_Artifact
-dasm_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out)
+dasm_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   DASM_Artifact *artifact = 0;
   if(lane_idx() == 0)
@@ -333,6 +333,7 @@ dasm_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_o
       info_arena = arena_alloc();
       info.text_key = text_key;
       info.lines = dasm_line_array_from_chunk_list(info_arena, &line_list);
+      size_out[0] = text.size + arena_pos(info_arena);
     }
     
     //- rjf: if stale, retry
@@ -30,54 +30,74 @@ dw_is_dwarf_present_from_elf_bin(String8 data, ELF_Bin *bin)
 internal DW_Raw
 dw_input_from_elf_bin(Arena *arena, String8 data, ELF_Bin *bin)
 {
-  DW_Raw result = {0};
-  B32 is_section_present[ArrayCount(result.sec)] = {0};
-  for(U64 section_idx = 1; section_idx < bin->shdrs.count; section_idx += 1)
+  // NOTE: may be called by all lanes at once, in which case compressed
+  // sections are decompressed in parallel - largest first, one section per
+  // lane at a time. all section data is allocated on lane 0's arena.
+  ProfBeginFunction();
+  typedef struct DW_ElfCompressedSection DW_ElfCompressedSection;
+  struct DW_ElfCompressedSection
   {
-    ELF_Shdr64 *shdr = &bin->shdrs.v[section_idx];
-    if(shdr->sh_type != ELF_ShType_ProgBits) { continue; } // skip BSS sections
-    
-    //- rjf: unpack section
-    String8 section_name = elf_name_from_shdr64(data, bin, shdr);
-    DW_SectionKind section_kind = dw_section_kind_from_string(section_name);
-    String8 section_data__maybe_compressed = str8_substr(data, r1u64(shdr->sh_offset, shdr->sh_offset + shdr->sh_size));
-    B32 is_dwo = 0;
-    if(section_kind == DW_Section_Null)
-    {
-      section_kind = dw_section_dwo_kind_from_string(section_name);
-      is_dwo = (section_kind != DW_Section_Null);
-    }
-    
-    if(section_kind == DW_Section_Null)  { continue; } // skip unknown sections
-    if(is_section_present[section_kind]) { continue; } // skip duplicate sections
-    
-    //- rjf: decompress section data if needed
-    String8 section_data__uncompressed = {0};
-    if(!(shdr->sh_flags & ELF_Shf_Compressed))
-    {
-      section_data__uncompressed = section_data__maybe_compressed;
-    }
-    else
+    DW_SectionKind kind;
+    ELF_CompressType type;
+    String8 compressed;
+    U8 *buffer;
+    U64 buffer_size;
+  };
+  Temp scratch = scratch_begin(&arena, 1);
+  DW_Raw *result = 0;
+  DW_ElfCompressedSection *compressed_sections = 0;
+  U64 compressed_sections_count = 0;
+  if(lane_idx() == 0)
+  {
+    result = push_array(scratch.arena, DW_Raw, 1);
+    compressed_sections = push_array(scratch.arena, DW_ElfCompressedSection, ArrayCount(result->sec));
+    B32 is_section_present[ArrayCount(result->sec)] = {0};
+    for(U64 section_idx = 1; section_idx < bin->shdrs.count; section_idx += 1)
     {
-      // rjf: read compressed-section header
-      ELF_Chdr64 chdr64 = {0};
-      U64 chdr_size = 0;
-      if(ELF_HdrIs64Bit(bin->hdr.e_ident))
+      ELF_Shdr64 *shdr = &bin->shdrs.v[section_idx];
+      if(shdr->sh_type != ELF_ShType_ProgBits) { continue; } // skip BSS sections
+      
+      //- rjf: unpack section
+      String8 section_name = elf_name_from_shdr64(data, bin, shdr);
+      DW_SectionKind section_kind = dw_section_kind_from_string(section_name);
+      String8 section_data__maybe_compressed = str8_substr(data, r1u64(shdr->sh_offset, shdr->sh_offset + shdr->sh_size));
+      B32 is_dwo = 0;
+      if(section_kind == DW_Section_Null)
       {
-        chdr_size = str8_deserial_read_struct(section_data__maybe_compressed, 0, &chdr64);
+        section_kind = dw_section_dwo_kind_from_string(section_name);
+        is_dwo = (section_kind != DW_Section_Null);
       }
-      else if(ELF_HdrIs32Bit(bin->hdr.e_ident))
+      
+      if(section_kind == DW_Section_Null)  { continue; } // skip unknown sections
+      if(is_section_present[section_kind]) { continue; } // skip duplicate sections
+      
+      //- rjf: gather compressed section data, to decompress after all sections
+      // are found
+      String8 section_data__uncompressed = {0};
+      if(!(shdr->sh_flags & ELF_Shf_Compressed))
       {
-        ELF_Chdr32 chdr32 = {0};
-        chdr_size = str8_deserial_read_struct(section_data__maybe_compressed, 0, &chdr32);
-        if(chdr_size == sizeof(chdr32))
-        {
-          chdr64 = elf_chdr64_from_chdr32(chdr32);
-        }
+        section_data__uncompressed = section_data__maybe_compressed;
       }
-      
-      // rjf: decompress
+      else
       {
+        // rjf: read compressed-section header
+        ELF_Chdr64 chdr64 = {0};
+        U64 chdr_size = 0;
+        if(ELF_HdrIs64Bit(bin->hdr.e_ident))
+        {
+          chdr_size = str8_deserial_read_struct(section_data__maybe_compressed, 0, &chdr64);
+        }
+        else if(ELF_HdrIs32Bit(bin->hdr.e_ident))
+        {
+          ELF_Chdr32 chdr32 = {0};
+          chdr_size = str8_deserial_read_struct(section_data__maybe_compressed, 0, &chdr32);
+          if(chdr_size == sizeof(chdr32))
+          {
+            chdr64 = elf_chdr64_from_chdr32(chdr32);
+          }
+        }
+        
+        // rjf: gather
         String8 section_data__compressed_contents = str8_skip(section_data__maybe_compressed, chdr_size);
         switch(chdr64.ch_type)
         {
@@ -86,14 +106,15 @@ dw_input_from_elf_bin(Arena *arena, String8 data, ELF_Bin *bin)
             section_data__uncompressed = section_data__compressed_contents;
           }break;
           case ELF_CompressType_ZLib:
-          {
-            U8 *section_data_uncompressed_buffer = push_array_no_zero_aligned(arena, U8, chdr64.ch_size, chdr64.ch_addr_align);
-            U64 section_data_uncompressed_size = zsinflate(section_data_uncompressed_buffer, chdr64.ch_size, section_data__compressed_contents.str, section_data__compressed_contents.size);
-            section_data__uncompressed = str8(section_data_uncompressed_buffer, section_data_uncompressed_size);
-          }break;
           case ELF_CompressType_ZStd:
           {
-            NotImplemented;
+            DW_ElfCompressedSection *s = &compressed_sections[compressed_sections_count];
+            compressed_sections_count += 1;
+            s->kind        = section_kind;
+            s->type        = chdr64.ch_type;
+            s->compressed  = section_data__compressed_contents;
+            s->buffer      = push_array_no_zero_aligned(arena, U8, chdr64.ch_size, chdr64.ch_addr_align);
+            s->buffer_size = chdr64.ch_size;
           }break;
           default:
           {
@@ -101,14 +122,65 @@ dw_input_from_elf_bin(Arena *arena, String8 data, ELF_Bin *bin)
           }break;
         }
       }
+      
+      //- rjf: store
+      is_section_present[section_kind] = 1;
+      DW_Section *d = &result->sec[section_kind];
+      d->name   = push_str8_copy(arena, section_name);
+      d->data   = section_data__uncompressed;
+      d->is_dwo = is_dwo;
     }
     
-    //- rjf: store
-    is_section_present[section_kind] = 1;
-    DW_Section *d = &result.sec[section_kind];
-    d->name   = push_str8_copy(arena, section_name);
-    d->data   = section_data__uncompressed;
-    d->is_dwo = is_dwo;
+    //- sort compressed sections by decreasing size, so that the largest ones
+    // start first
+    for(U64 idx = 1; idx < compressed_sections_count; idx += 1)
+    {
+      for(U64 idx2 = idx; idx2 > 0 && compressed_sections[idx2-1].compressed.size < compressed_sections[idx2].compressed.size; idx2 -= 1)
+      {
+        Swap(DW_ElfCompressedSection, compressed_sections[idx2-1], compressed_sections[idx2]);
+      }
+    }
+  }
+  lane_sync_u64(&result, 0);
+  lane_sync_u64(&compressed_sections, 0);
+  lane_sync_u64(&compressed_sections_count, 0);
+  
+  //- decompress sections, in parallel
+  {
+    U64 section_take_idx_ = 0;
+    U64 *section_take_idx_ptr = &section_take_idx_;
+    lane_sync_u64(&section_take_idx_ptr, 0);
+    for(;;)
+    {
+      U64 idx = ins_atomic_u64_inc_eval(section_take_idx_ptr)-1;
+      if(idx >= compressed_sections_count)
+      {
+        break;
+      }
+      DW_ElfCompressedSection *s = &compressed_sections[idx];
+      U64 size = 0;
+      switch(s->type)
+      {
+        case ELF_CompressType_ZLib:
+        {
+          size = zsinflate(s->buffer, s->buffer_size, s->compressed.str, s->compressed.size);
+          if(size > s->buffer_size)
+          {
+            size = 0;
+          }
+        }break;
+        case ELF_CompressType_ZStd:
+        {
+          size = zstd_decompress(s->buffer, s->buffer_size, s->compressed);
+        }break;
+      }
+      result->sec[s->kind].data = str8(s->buffer, size);
+    }
   }
-  return result;
+  lane_sync();
+  DW_Raw raw = *result;
+  lane_sync();
+  scratch_end(scratch);
+  ProfEnd();
+  return raw;
 }
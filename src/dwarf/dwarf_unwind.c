@@ -27,6 +27,22 @@ dw_copy_cfi_row(Arena *arena, DW_CFI_Row *row, U64 reg_count)
   return new_row;
 }
 
+internal DW_CFI_Row *
+dw_copy_cfi_row_deep(Arena *arena, DW_CFI_Row *row, U64 reg_count)
+{
+  DW_CFI_Row *new_row = dw_copy_cfi_row(arena, row, reg_count);
+  if (new_row->cfa.rule == DW_CFA_Rule_Expression) {
+    new_row->cfa.expr = push_str8_copy(arena, new_row->cfa.expr);
+  }
+  for EachIndex(reg_idx, reg_count) {
+    DW_CFI_Register *reg = &new_row->regs[reg_idx];
+    if (reg->rule == DW_CFI_RegisterRule_Expression || reg->rule == DW_CFI_RegisterRule_ValExpression) {
+      reg->expr = push_str8_copy(arena, reg->expr);
+    }
+  }
+  return new_row;
+}
+
 internal DW_CFI_Unwind *
 dw_cfi_unwind_init(Arena        *arena,
                    Arch          arch,
@@ -236,6 +252,82 @@ dw_cfi_row_from_pc(Arena *arena, Arch arch, DW_CIE *cie, DW_FDE *fde, DW_DecodeP
   return result;
 }
 
+internal DW_CFI_RowTable
+dw_cfi_row_table_from_fde(Arena *arena, Arch arch, DW_CIE *cie, DW_FDE *fde, DW_DecodePtr *decode_ptr_func, void *decode_ptr_ctx)
+{
+  Temp scratch = scratch_begin(&arena, 1);
+  
+  typedef struct RowNode RowNode;
+  struct RowNode
+  {
+    RowNode    *next;
+    Rng1U64     pc_range;
+    DW_CFI_Row *row;
+  };
+  
+  // replay the FDE once, collecting each row which covers a non-empty range
+  RowNode       *first_row = 0;
+  RowNode       *last_row  = 0;
+  U64            row_count = 0;
+  U64            reg_count = dw_reg_count_from_arch(arch);
+  DW_CFI_Unwind *uw        = dw_cfi_unwind_init(scratch.arena, arch, cie, fde, decode_ptr_func, decode_ptr_ctx);
+  DW_CFI_Row    *row       = dw_copy_cfi_row(scratch.arena, uw->row, uw->reg_count);
+  U64            prev_pc   = uw->pc;
+  for (;;) {
+    B32 is_next_row = dw_cfi_next_row(scratch.arena, uw);
+    U64 next_pc     = is_next_row ? uw->pc : fde->pc_range.max;
+    DW_CFI_Row *src = is_next_row ? row : uw->row;
+    if (prev_pc < next_pc) {
+      RowNode *n = push_array(scratch.arena, RowNode, 1);
+      n->pc_range = r1u64(prev_pc, next_pc);
+      n->row      = dw_copy_cfi_row_deep(arena, src, reg_count);
+      SLLQueuePush(first_row, last_row, n);
+      row_count += 1;
+    }
+    if (!is_next_row) { break; }
+    dw_memcpy_cfi_row(row, uw->row, uw->reg_count);
+    prev_pc = uw->pc;
+  }
+  
+  // flatten
+  DW_CFI_RowTable table = {0};
+  table.count     = row_count;
+  table.pc_ranges = push_array_no_zero(arena, Rng1U64, row_count);
+  table.rows      = push_array_no_zero(arena, DW_CFI_Row, row_count);
+  {
+    U64 row_idx = 0;
+    for EachNode(n, RowNode, first_row) {
+      table.pc_ranges[row_idx] = n->pc_range;
+      table.rows[row_idx]      = *n->row;
+      table.rows[row_idx].next = 0;
+      row_idx += 1;
+    }
+  }
+  
+  scratch_end(scratch);
+  return table;
+}
+
+internal DW_CFI_Row *
+dw_cfi_row_from_row_table(DW_CFI_RowTable *table, U64 pc)
+{
+  DW_CFI_Row *result = 0;
+  U64 l = 0;
+  U64 r = table->count;
+  while (l < r) {
+    U64 m = l + (r - l) / 2;
+    if (pc < table->pc_ranges[m].min) {
+      r = m;
+    } else if (pc >= table->pc_ranges[m].max) {
+      l = m + 1;
+    } else {
+      result = &table->rows[m];
+      break;
+    }
+  }
+  return result;
+}
+
 internal MachineOpResult
 dw_compute_cfa(Arch arch, DW_CFI_Row *row, void *reg_block, MachineOp_MemRead *mem_read_func, void *mem_read_ud, U64 *cfa_out)
 {
@@ -258,6 +350,7 @@ dw_compute_cfa(Arch arch, DW_CFI_Row *row, void *reg_block, MachineOp_MemRead *m
         break;
       }
       *cfa_out = cfa_reg_value + row->cfa.off;
+      unwind_status = MachineOpResult_Ok;
     }break;
     case DW_CFA_Rule_Expression:
     {
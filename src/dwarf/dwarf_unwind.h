@@ -65,15 +65,27 @@ typedef struct DW_CFI_Unwind
   U64              reg_count;
 } DW_CFI_Unwind;
 
+// all rows of one FDE, sorted by PC; rows own copies of their expressions, so
+// tables may outlive the CIE & FDE data they were built from
+typedef struct DW_CFI_RowTable
+{
+  U64         count;
+  Rng1U64    *pc_ranges;
+  DW_CFI_Row *rows;
+} DW_CFI_RowTable;
+
 ////////////////////////////////
 
 internal DW_CFI_Row * dw_make_cfi_row(Arena *arena, U64 reg_count);
 internal DW_CFI_Row * dw_copy_cfi_row(Arena *arena, DW_CFI_Row *row, U64 reg_count);
+internal DW_CFI_Row * dw_copy_cfi_row_deep(Arena *arena, DW_CFI_Row *row, U64 reg_count);
 
 internal DW_CFI_Unwind * dw_cfi_unwind_init(Arena *arena, Arch arch, DW_CIE *cie, DW_FDE *fde, DW_DecodePtr *decode_ptr_func, void *decode_ptr_ud);
 internal B32             dw_cfi_next_row(Arena *arena, DW_CFI_Unwind *uw);
 
 internal DW_CFI_Row *    dw_cfi_row_from_pc(Arena *arena, Arch arch, struct DW_CIE *cie, struct DW_FDE *fde, DW_DecodePtr *decode_ptr_func, void *decode_ptr_ctx, U64 pc);
+internal DW_CFI_RowTable dw_cfi_row_table_from_fde(Arena *arena, Arch arch, struct DW_CIE *cie, struct DW_FDE *fde, DW_DecodePtr *decode_ptr_func, void *decode_ptr_ctx);
+internal DW_CFI_Row *    dw_cfi_row_from_row_table(DW_CFI_RowTable *table, U64 pc);
 internal MachineOpResult dw_compute_cfa(Arch arch, DW_CFI_Row *row, void *reg_block, MachineOp_MemRead *mem_read_func, void *mem_read_ud, U64 *cfa_out);
 internal MachineOpResult dw_cfi_apply_register_rules(Arch arch, U64 cfa, DW_CFI_Row *row, void *reg_block, MachineOp_MemRead *mem_read_func, void *mem_read_ud);
 
@@ -4,6 +4,16 @@
 ////////////////////////////////
 //~ rjf: Context Selection Functions (Selection Required For All Subsequent APIs)
 
+internal String8
+e_frame_base_bytecode_from_voff(Arena *arena, RDI_Parsed *rdi, U64 voff)
+{
+  RDI_Symbol *proc = rdi_procedure_from_voff(rdi, voff);
+  RDI_Location location = rdi_location_from_location_voff(rdi, proc->location, voff);
+  E_OpList oplist = e_oplist_from_location(arena, rdi, location);
+  String8 bytecode = e_bytecode_from_oplist(arena, &oplist);
+  return bytecode;
+}
+
 internal void
 e_select_interpret_ctx(E_InterpretCtx *ctx, RDI_Parsed *primary_rdi, U64 ip_voff)
 {
@@ -13,10 +23,7 @@ e_select_interpret_ctx(E_InterpretCtx *ctx, RDI_Parsed *primary_rdi, U64 ip_voff
   if(primary_rdi != 0)
   {
     Temp scratch = scratch_begin(0, 0);
-    RDI_Symbol *proc = rdi_procedure_from_voff(primary_rdi, ip_voff);
-    RDI_Location location = rdi_location_from_location_voff(primary_rdi, proc->location, ip_voff);
-    E_OpList oplist = e_oplist_from_location(scratch.arena, primary_rdi, location);
-    String8 bytecode = e_bytecode_from_oplist(scratch.arena, &oplist);
+    String8 bytecode = e_frame_base_bytecode_from_voff(scratch.arena, primary_rdi, ip_voff);
     E_Interpretation frame_base_interpretation = e_interpret(bytecode);
     U64 frame_base = frame_base_interpretation.value.u64;
     if(frame_base_interpretation.code == E_InterpretationCode_Good)
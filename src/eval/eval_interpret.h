@@ -28,6 +28,7 @@ thread_static E_InterpretCtx *e_interpret_ctx = 0;
 ////////////////////////////////
 //~ rjf: Context Selection Functions (Selection Required For All Subsequent APIs)
 
+internal String8 e_frame_base_bytecode_from_voff(Arena *arena, RDI_Parsed *rdi, U64 voff);
 internal void e_select_interpret_ctx(E_InterpretCtx *ctx, RDI_Parsed *primary_rdi, U64 ip_voff);
 
 ////////////////////////////////
@@ -2573,6 +2573,7 @@ e_append_oplist_from_irtree(Arena *arena, E_IRNode *root, E_Space *current_space
         e_append_oplist_from_irtree(arena, child, current_space, out);
       }
       e_oplist_push_set_space(arena, out, space);
+      *current_space = space;
     }break;
     
     case E_IRExtKind_SetBaseOff:
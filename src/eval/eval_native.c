@@ -0,0 +1,668 @@
+// Copyright (c) Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+////////////////////////////////
+//~ Native Code Generation Helpers
+
+internal void
+e_native_emit(E_NativeCompiler *c, String8 bytes)
+{
+  if(c->code_size + bytes.size <= E_NATIVE_CODE_CAP)
+  {
+    MemoryCopy(c->code + c->code_size, bytes.str, bytes.size);
+    c->code_size += bytes.size;
+  }
+  else
+  {
+    c->good = 0;
+  }
+}
+
+internal void
+e_native_emit_u32(E_NativeCompiler *c, U32 x)
+{
+  e_native_emit(c, str8_struct(&x));
+}
+
+internal void
+e_native_emit_mov_imm(E_NativeCompiler *c, U8 reg, U64 x)
+{
+  // reg: 0 -> rax, 1 -> rcx
+  if(x <= max_U32)
+  {
+    U8 inst = 0xB8 + reg;                           // mov e??, imm32 (zero-extends)
+    e_native_emit(c, str8(&inst, 1));
+    e_native_emit_u32(c, (U32)x);
+  }
+  else if((S64)x == (S64)(S32)x)
+  {
+    U8 inst[] = {0x48, 0xC7, (U8)(0xC0 + reg)};     // mov r??, simm32
+    e_native_emit(c, str8(inst, sizeof(inst)));
+    e_native_emit_u32(c, (U32)x);
+  }
+  else
+  {
+    U8 inst[] = {0x48, (U8)(0xB8 + reg)};           // mov r??, imm64
+    e_native_emit(c, str8(inst, sizeof(inst)));
+    e_native_emit(c, str8_struct(&x));
+  }
+}
+
+internal void
+e_native_emit_mask(E_NativeCompiler *c, U64 byte_size)
+{
+  if(byte_size < 8)
+  {
+    e_native_emit_mov_imm(c, 1, max_U64 >> (64 - byte_size*8));
+    e_native_emit(c, str8_lit("\x48\x21\xC8"));     // and rax, rcx
+  }
+}
+
+internal void
+e_native_emit_error_jz(E_NativeCompiler *c)
+{
+  if(c->error_jump_count < E_NATIVE_ERROR_JUMPS_CAP)
+  {
+    e_native_emit(c, str8_lit("\x0F\x84"));         // jz <error>
+    c->error_jump_offs[c->error_jump_count] = c->code_size;
+    c->error_jump_count += 1;
+    e_native_emit_u32(c, 0);
+  }
+  else
+  {
+    c->good = 0;
+  }
+}
+
+////////////////////////////////
+//~ Native Code Generation Stack Helpers
+
+internal void
+e_native_push_const(E_NativeCompiler *c, U64 x)
+{
+  if(c->stack_count < E_NATIVE_STACK_CAP)
+  {
+    c->stack[c->stack_count].is_const = 1;
+    c->stack[c->stack_count].value = x;
+    c->stack_count += 1;
+  }
+  else
+  {
+    c->good = 0;
+  }
+}
+
+internal void
+e_native_materialize_consts(E_NativeCompiler *c, U64 opl_idx)
+{
+  for(U64 idx = c->runtime_count; idx < opl_idx; idx += 1)
+  {
+    U64 x = c->stack[idx].value;
+    if((S64)x == (S64)(S32)x)
+    {
+      e_native_emit(c, str8_lit("\x68"));           // push simm32
+      e_native_emit_u32(c, (U32)x);
+    }
+    else
+    {
+      e_native_emit_mov_imm(c, 0, x);
+      e_native_emit(c, str8_lit("\x50"));           // push rax
+    }
+    c->stack[idx].is_const = 0;
+  }
+  c->runtime_count = Max(c->runtime_count, opl_idx);
+}
+
+internal B32
+e_native_pop_operands(E_NativeCompiler *c, U64 count)
+{
+  // operands go to rax (first) & rcx (second); runtime operands are on top
+  // of the native stack, & consts below operands are only possible when all
+  // operands are consts, so materializing them first keeps the stacks in sync
+  B32 result = (count <= c->stack_count);
+  if(result)
+  {
+    U64 first_idx = c->stack_count - count;
+    e_native_materialize_consts(c, first_idx);
+    for(U64 n = 0; n < count; n += 1)
+    {
+      U64 idx = c->stack_count - 1 - n;
+      U8 reg = (U8)(idx - first_idx);
+      if(c->stack[idx].is_const)
+      {
+        e_native_emit_mov_imm(c, reg, c->stack[idx].value);
+      }
+      else
+      {
+        U8 inst = 0x58 + reg;                       // pop r??
+        e_native_emit(c, str8(&inst, 1));
+      }
+    }
+    c->stack_count = first_idx;
+    c->runtime_count = Min(c->runtime_count, first_idx);
+  }
+  return result;
+}
+
+internal void
+e_native_push_rax(E_NativeCompiler *c)
+{
+  if(c->stack_count < E_NATIVE_STACK_CAP)
+  {
+    e_native_materialize_consts(c, c->stack_count);
+    e_native_emit(c, str8_lit("\x50"));             // push rax
+    c->stack[c->stack_count].is_const = 0;
+    c->stack[c->stack_count].value = 0;
+    c->stack_count += 1;
+    c->runtime_count = c->stack_count;
+  }
+  else
+  {
+    c->good = 0;
+  }
+}
+
+internal void
+e_native_emit_reg_read(E_NativeCompiler *c, U64 off, U64 size)
+{
+  // find the general purpose register (or rflags) which holds the range
+  ARCH_Info *arch_info = arch_info_from_arch(Arch_x64);
+  X64_RegCode reg_code = X64_RegCode_nil;
+  U64 byte_off = 0;
+  for(X64_RegCode code = X64_RegCode_rax; code <= X64_RegCode_rflags; code = (X64_RegCode)(code + 1))
+  {
+    if(X64_RegCode_r15 < code && code < X64_RegCode_rflags)
+    {
+      continue;
+    }
+    Rng1U16 rng = arch_info->reg_code_rng_table[code];
+    if(rng.min <= off && off + size <= rng.max)
+    {
+      reg_code = code;
+      byte_off = off - rng.min;
+      break;
+    }
+  }
+
+  // load it into rax; rax, rcx, rdx, rflags, & rsp are read from the frame
+  switch(reg_code)
+  {
+    default:
+    {
+      U8 reg_idx = (U8)(reg_code - X64_RegCode_rax);
+      U8 inst[] = {(U8)(0x48 | (reg_idx >= 8 ? 0x04 : 0)), 0x89, (U8)(0xC0 | ((reg_idx & 7) << 3))}; // mov rax, r??
+      e_native_emit(c, str8(inst, sizeof(inst)));
+    }break;
+    case X64_RegCode_nil:   {c->good = 0;}break;
+    case X64_RegCode_rax:   {e_native_emit(c, str8_lit("\x48\x8B\x42\x10"));}break;             // mov rax, [rdx+16]
+    case X64_RegCode_rcx:   {e_native_emit(c, str8_lit("\x48\x8B\x42\x08"));}break;             // mov rax, [rdx+8]
+    case X64_RegCode_rdx:   {e_native_emit(c, str8_lit("\x48\x8B\x02"));}break;                 // mov rax, [rdx]
+    case X64_RegCode_rflags:{e_native_emit(c, str8_lit("\x48\x8B\x42\x18"));}break;             // mov rax, [rdx+24]
+    case X64_RegCode_rsp:   {e_native_emit(c, str8_lit("\x48\x8D\x82\xA0\x00\x00\x00"));}break; // lea rax, [rdx+160]
+  }
+  StaticAssert(X64_COND_FRAME_OFF_RAX == 0x10 && X64_COND_FRAME_OFF_RCX == 0x08 && X64_COND_FRAME_OFF_RDX == 0 &&
+               X64_COND_FRAME_OFF_RFLAGS == 0x18 && X64_COND_FRAME_OFF_RSP == 0xA0, e_native_cond_frame_layout_check);
+
+  // shift & mask down to the read range
+  if(byte_off != 0)
+  {
+    U8 inst[] = {0x48, 0xC1, 0xE8, (U8)(byte_off*8)}; // shr rax, imm8
+    e_native_emit(c, str8(inst, sizeof(inst)));
+  }
+  e_native_emit_mask(c, size);
+}
+
+////////////////////////////////
+//~ Native Code Generation Functions
+
+internal void
+e_native_compile(E_NativeCompiler *c, String8 bytecode)
+{
+  U8 *ptr = bytecode.str;
+  U8 *opl = bytecode.str + bytecode.size;
+  for(;c->good && ptr < opl;)
+  {
+    //- consume next opcode
+    RDI_EvalOp op = (RDI_EvalOp)*ptr;
+    U16 ctrlbits = 0;
+    if(op < RDI_EvalOp_COUNT)
+    {
+      ctrlbits = rdi_eval_op_ctrlbits_table[op];
+    }
+    else switch(op)
+    {
+      case E_IRExtKind_SetSpace:{ctrlbits = RDI_EVAL_CTRLBITS(32, 0, 0);}break;
+      case E_IRExtKind_SetBaseOff:{ctrlbits = RDI_EVAL_CTRLBITS(8, 0, 0);}break;
+      default:{c->good = 0;}break;
+    }
+    ptr += 1;
+
+    //- decode
+    E_Value imm = {0};
+    {
+      U32 decode_size = RDI_DECODEN_FROM_CTRLBITS(ctrlbits);
+      if(ptr + decode_size > opl || RDI_POPN_FROM_CTRLBITS(ctrlbits) > c->stack_count)
+      {
+        c->good = 0;
+        break;
+      }
+      MemoryCopy(&imm, ptr, decode_size);
+      ptr += decode_size;
+    }
+    RDI_EvalTypeGroup type_group = (RDI_EvalTypeGroup)imm.u512.u8[0];
+    U64 op_arithmetic_size = (U64)imm.u512.u8[1];
+    B32 is_int = (type_group == RDI_EvalTypeGroup_U || type_group == RDI_EvalTypeGroup_S);
+    B32 is_float = (type_group == RDI_EvalTypeGroup_F32 || type_group == RDI_EvalTypeGroup_F64);
+
+    //- generate
+    switch(op)
+    {
+      default:{c->good = 0;}break;
+
+      //- state & consts, known when compiling
+      case E_IRExtKind_SetSpace:
+      {
+        E_Space space = {0};
+        MemoryCopy(&space, &imm, sizeof(space));
+        c->space_is_reg = e_space_match(space, e_interpret_ctx->reg_space);
+        c->good = (c->space_is_reg || e_space_match(space, e_interpret_ctx->primary_space));
+      }break;
+      case E_IRExtKind_SetBaseOff:{c->base_off = imm.u64;}break;
+      case RDI_EvalOp_Stop:{ptr = opl;}break;
+      case RDI_EvalOp_Noop:{}break;
+      case RDI_EvalOp_ConstU8:
+      case RDI_EvalOp_ConstU16:
+      case RDI_EvalOp_ConstU32:
+      case RDI_EvalOp_ConstU64:{e_native_push_const(c, imm.u64);}break;
+      case RDI_EvalOp_ModuleOff:{e_native_push_const(c, c->base_off + imm.u64);}break;
+
+      //- frame offsets -> inline the procedure's frame base computation
+      case RDI_EvalOp_FrameOff:
+      if(!c->is_in_frame_base && c->frame_base_bytecode.size != 0)
+      {
+        B32 space_is_reg = c->space_is_reg;
+        U64 base_off = c->base_off;
+        U64 stack_count = c->stack_count;
+        c->is_in_frame_base = 1;
+        c->space_is_reg = 0;
+        c->base_off = (e_interpret_ctx->module_base ? e_interpret_ctx->module_base[0] : 0);
+        e_native_compile(c, c->frame_base_bytecode);
+        c->is_in_frame_base = 0;
+        c->space_is_reg = space_is_reg;
+        c->base_off = base_off;
+        c->good = c->good && (c->stack_count == stack_count + 1);
+        e_native_push_const(c, imm.u64);
+        e_native_pop_operands(c, 2);
+        e_native_emit(c, str8_lit("\x48\x01\xC8"));                       // add rax, rcx
+        e_native_push_rax(c);
+      }
+      else
+      {
+        c->good = 0;
+      }break;
+
+      //- reads
+      case RDI_EvalOp_MemRead:
+      if(c->space_is_reg)
+      {
+        // register reads only ever have const offsets
+        E_NativeSlot *slot = &c->stack[c->stack_count-1];
+        if(slot->is_const && 0 < imm.u64 && imm.u64 <= 8)
+        {
+          U64 off = slot->value;
+          c->stack_count -= 1;
+          e_native_materialize_consts(c, c->stack_count);
+          e_native_emit_reg_read(c, off, imm.u64);
+          e_native_push_rax(c);
+        }
+        else
+        {
+          c->good = 0;
+        }
+      }
+      else
+      {
+        e_native_pop_operands(c, 1);
+        switch(imm.u64)
+        {
+          default:{c->good = 0;}break;
+          case 1:{e_native_emit(c, str8_lit("\x0F\xB6\x00"));}break;      // movzx eax, byte [rax]
+          case 2:{e_native_emit(c, str8_lit("\x0F\xB7\x00"));}break;      // movzx eax, word [rax]
+          case 4:{e_native_emit(c, str8_lit("\x8B\x00"));}break;          // mov eax, [rax]
+          case 8:{e_native_emit(c, str8_lit("\x48\x8B\x00"));}break;      // mov rax, [rax]
+        }
+        e_native_push_rax(c);
+      }break;
+      case RDI_EvalOp_RegRead:
+      {
+        U8 rdi_reg_code = (imm.u64&0x0000FF)>>0;
+        U8 byte_size    = (imm.u64&0x00FF00)>>8;
+        U8 byte_off     = (imm.u64&0xFF0000)>>16;
+        ARCH_Info *arch_info = arch_info_from_arch(Arch_x64);
+        ARCH_RegCode base_reg_code = arch_reg_code_from_rdi(Arch_x64, rdi_reg_code);
+        if(0 < base_reg_code && base_reg_code < arch_info->reg_code_count && 0 < byte_size && byte_size <= 8)
+        {
+          e_native_materialize_consts(c, c->stack_count);
+          e_native_emit_reg_read(c, arch_info->reg_code_rng_table[base_reg_code].min + byte_off, byte_size);
+          e_native_push_rax(c);
+        }
+        else
+        {
+          c->good = 0;
+        }
+      }break;
+
+      //- stack manipulation
+      case RDI_EvalOp_Pick:
+      if(imm.u64 < c->stack_count)
+      {
+        U64 idx = c->stack_count - imm.u64 - 1;
+        if(c->stack[idx].is_const)
+        {
+          e_native_push_const(c, c->stack[idx].value);
+        }
+        else if(c->stack_count < E_NATIVE_STACK_CAP)
+        {
+          e_native_materialize_consts(c, c->stack_count);
+          e_native_emit(c, str8_lit("\xFF\xB2"));                         // push [rdx - 8*(idx+1)]
+          e_native_emit_u32(c, (U32)(-(S32)(8*(idx+1))));
+          c->stack[c->stack_count].is_const = 0;
+          c->stack_count += 1;
+          c->runtime_count = c->stack_count;
+        }
+        else
+        {
+          c->good = 0;
+        }
+      }
+      else
+      {
+        c->good = 0;
+      }break;
+      case RDI_EvalOp_Pop:
+      {
+        c->stack_count -= 1;
+        if(c->stack_count < c->runtime_count)
+        {
+          e_native_emit(c, str8_lit("\x59"));                             // pop rcx
+          c->runtime_count = c->stack_count;
+        }
+      }break;
+
+      //- unary ops
+      case RDI_EvalOp_Abs:
+      case RDI_EvalOp_Neg:
+      case RDI_EvalOp_BitNot:
+      case RDI_EvalOp_LogNot:
+      case RDI_EvalOp_ByteSwap:
+      {
+        e_native_pop_operands(c, 1);
+        switch(op)
+        {
+          default:{}break;
+          case RDI_EvalOp_Abs:
+          {
+            c->good = c->good && !is_float;
+            e_native_emit(c, str8_lit("\x48\x85\xC0\x79\x03\x48\xF7\xD8"));  // test rax, rax; jns +3; neg rax
+          }break;
+          case RDI_EvalOp_Neg:
+          {
+            c->good = c->good && !is_float;
+            e_native_emit(c, str8_lit("\x48\xF7\xD8"));                   // neg rax
+          }break;
+          case RDI_EvalOp_BitNot:
+          {
+            c->good = c->good && is_int;
+            e_native_emit(c, str8_lit("\x48\xF7\xD0"));                   // not rax
+          }break;
+          case RDI_EvalOp_LogNot:
+          {
+            c->good = c->good && is_int;
+            e_native_emit(c, str8_lit("\x48\x85\xC0\x0F\x94\xC0\x0F\xB6\xC0")); // test rax, rax; sete al; movzx eax, al
+          }break;
+          case RDI_EvalOp_ByteSwap:
+          switch(imm.u64)
+          {
+            default:{c->good = 0;}break;
+            case 2:{e_native_emit(c, str8_lit("\x0F\xB7\xC0\x66\xC1\xC0\x08"));}break; // movzx eax, ax; rol ax, 8
+            case 4:{e_native_emit(c, str8_lit("\x0F\xC8"));}break;        // bswap eax
+            case 8:{e_native_emit(c, str8_lit("\x48\x0F\xC8"));}break;    // bswap rax
+          }break;
+        }
+        e_native_push_rax(c);
+      }break;
+      case RDI_EvalOp_Trunc:
+      case RDI_EvalOp_TruncSigned:
+      {
+        e_native_pop_operands(c, 1);
+        U64 bit_count = imm.u64;
+        if(bit_count == 0 || (op == RDI_EvalOp_Trunc && bit_count >= 64))
+        {
+          e_native_emit(c, str8_lit("\x31\xC0"));                         // xor eax, eax
+        }
+        else if(op == RDI_EvalOp_Trunc)
+        {
+          e_native_emit_mov_imm(c, 1, max_U64 >> (64 - bit_count));
+          e_native_emit(c, str8_lit("\x48\x21\xC8"));                     // and rax, rcx
+        }
+        else if(bit_count <= 32)
+        {
+          // the interpreter tests `(1 << (bits-1))` as an int
+          e_native_emit_mov_imm(c, 1, (U64)(S64)(S32)(1u << (bit_count - 1)));
+          e_native_emit(c, str8_lit("\x48\x85\xC8"));                     // test rax, rcx
+          e_native_emit_mov_imm(c, 1, max_U64 >> (64 - bit_count));
+          e_native_emit(c, str8_lit("\x74\x08"                            // jz .positive
+                                    "\x48\xF7\xD1"                        // not rcx
+                                    "\x48\x09\xC8"                        // or rax, rcx
+                                    "\xEB\x03"                            // jmp .done
+                                    "\x48\x21\xC8"));                     // .positive: and rax, rcx
+        }
+        else
+        {
+          c->good = 0;
+        }
+        e_native_push_rax(c);
+      }break;
+      case RDI_EvalOp_Convert:
+      {
+        // the interpreter only converts to/from floats, producing 0 otherwise
+        U32 in = imm.u64&0xFF;
+        U32 out = (imm.u64 >> 8)&0xFF;
+        B32 in_is_int = (in == RDI_EvalTypeGroup_U || in == RDI_EvalTypeGroup_S);
+        B32 out_is_int = (out == RDI_EvalTypeGroup_U || out == RDI_EvalTypeGroup_S);
+        c->good = c->good && (in == out || (in_is_int && out_is_int));
+        e_native_pop_operands(c, 1);
+        e_native_emit(c, str8_lit("\x31\xC0"));                           // xor eax, eax
+        e_native_push_rax(c);
+      }break;
+
+      //- binary ops
+      case RDI_EvalOp_Add:
+      case RDI_EvalOp_Sub:
+      case RDI_EvalOp_Mul:
+      case RDI_EvalOp_Div:
+      case RDI_EvalOp_Mod:
+      case RDI_EvalOp_LShift:
+      case RDI_EvalOp_RShift:
+      case RDI_EvalOp_BitAnd:
+      case RDI_EvalOp_BitOr:
+      case RDI_EvalOp_BitXor:
+      case RDI_EvalOp_LogAnd:
+      case RDI_EvalOp_LogOr:
+      case RDI_EvalOp_EqEq:
+      case RDI_EvalOp_NtEq:
+      case RDI_EvalOp_LsEq:
+      case RDI_EvalOp_GrEq:
+      case RDI_EvalOp_Less:
+      case RDI_EvalOp_Grtr:
+      {
+        e_native_pop_operands(c, 2);
+        switch(op)
+        {
+          default:{}break;
+          case RDI_EvalOp_Add:{c->good = c->good && !is_float; e_native_emit(c, str8_lit("\x48\x01\xC8"));}break;     // add rax, rcx
+          case RDI_EvalOp_Sub:{c->good = c->good && !is_float; e_native_emit(c, str8_lit("\x48\x29\xC8"));}break;     // sub rax, rcx
+          case RDI_EvalOp_Mul:{c->good = c->good && !is_float; e_native_emit(c, str8_lit("\x48\x0F\xAF\xC1"));}break; // imul rax, rcx
+          case RDI_EvalOp_BitAnd:{c->good = c->good && is_int; e_native_emit(c, str8_lit("\x48\x21\xC8"));}break;     // and rax, rcx
+          case RDI_EvalOp_BitOr: {c->good = c->good && is_int; e_native_emit(c, str8_lit("\x48\x09\xC8"));}break;     // or rax, rcx
+          case RDI_EvalOp_BitXor:{c->good = c->good && is_int; e_native_emit(c, str8_lit("\x48\x31\xC8"));}break;     // xor rax, rcx
+          case RDI_EvalOp_Div:
+          {
+            c->good = c->good && is_int;
+            e_native_emit(c, str8_lit("\x48\x85\xC9"));                   // test rcx, rcx
+            e_native_emit_error_jz(c);
+            e_native_emit(c, str8_lit("\x52"                              // push rdx
+                                      "\x31\xD2"                          // xor edx, edx
+                                      "\x48\xF7\xF1"                      // div rcx
+                                      "\x5A"));                           // pop rdx
+          }break;
+          case RDI_EvalOp_Mod:
+          {
+            // the interpreter produces 0 for mods by zero
+            c->good = c->good && is_int;
+            e_native_emit(c, str8_lit("\x48\x85\xC9"                      // test rcx, rcx
+                                      "\x74\x0C"                          // jz .zero
+                                      "\x52"                              // push rdx
+                                      "\x31\xD2"                          // xor edx, edx
+                                      "\x48\xF7\xF1"                      // div rcx
+                                      "\x48\x89\xD0"                      // mov rax, rdx
+                                      "\x5A"                              // pop rdx
+                                      "\xEB\x02"                          // jmp .done
+                                      "\x31\xC0"));                       // .zero: xor eax, eax
+          }break;
+          case RDI_EvalOp_LShift:
+          case RDI_EvalOp_RShift:
+          {
+            // narrow shifts happen on (sign-)extended 32-bit values, & are
+            // then truncated, as in C
+            B32 is_signed = (type_group == RDI_EvalTypeGroup_S);
+            B32 is_right = (op == RDI_EvalOp_RShift);
+            U8 shift_modrm = (is_right ? (is_signed ? 0xF8 : 0xE8) : 0xE0);
+            c->good = c->good && is_int;
+            switch(op_arithmetic_size)
+            {
+              default:{e_native_emit(c, str8_lit("\x31\xC0"));}break;     // xor eax, eax
+              case 1:
+              case 2:
+              {
+                U8 extend_op = (op_arithmetic_size == 1 ? 0xB6 : 0xB7) + (is_signed ? 0x08 : 0);
+                U8 inst[] =
+                {
+                  0x0F, extend_op, 0xC0,                                  // mov(s|z)x eax, (al|ax)
+                  0xD3, shift_modrm,                                      // (shl|shr|sar) eax, cl
+                  0x0F, (U8)(op_arithmetic_size == 1 ? 0xB6 : 0xB7), 0xC0, // movzx eax, (al|ax)
+                };
+                e_native_emit(c, str8(inst, sizeof(inst)));
+              }break;
+              case 4:
+              {
+                U8 inst[] = {0xD3, shift_modrm};                          // (shl|shr|sar) eax, cl
+                e_native_emit(c, str8(inst, sizeof(inst)));
+              }break;
+              case 8:
+              {
+                U8 inst[] = {0x48, 0xD3, shift_modrm};                    // (shl|shr|sar) rax, cl
+                e_native_emit(c, str8(inst, sizeof(inst)));
+              }break;
+            }
+          }break;
+          case RDI_EvalOp_LogAnd:
+          case RDI_EvalOp_LogOr:
+          {
+            c->good = c->good && is_int;
+            e_native_emit(c, str8_lit("\x48\x85\xC0"                      // test rax, rax
+                                      "\x0F\x95\xC0"                      // setnz al
+                                      "\x48\x85\xC9"                      // test rcx, rcx
+                                      "\x0F\x95\xC1"));                   // setnz cl
+            e_native_emit(c, op == RDI_EvalOp_LogAnd ? str8_lit("\x20\xC8") : str8_lit("\x08\xC8")); // (and|or) al, cl
+            e_native_emit(c, str8_lit("\x0F\xB6\xC0"));                   // movzx eax, al
+          }break;
+          case RDI_EvalOp_EqEq:
+          case RDI_EvalOp_NtEq:
+          case RDI_EvalOp_LsEq:
+          case RDI_EvalOp_GrEq:
+          case RDI_EvalOp_Less:
+          case RDI_EvalOp_Grtr:
+          {
+            B32 is_signed = (type_group == RDI_EvalTypeGroup_S);
+            U8 setcc = 0;
+            switch(op)
+            {
+              default:{}break;
+              case RDI_EvalOp_EqEq:{setcc = 0x94;}break;                  // sete
+              case RDI_EvalOp_NtEq:{setcc = 0x95;}break;                  // setne
+              case RDI_EvalOp_LsEq:{setcc = is_signed ? 0x9E : 0x96;}break; // setle/setbe
+              case RDI_EvalOp_GrEq:{setcc = is_signed ? 0x9D : 0x93;}break; // setge/setae
+              case RDI_EvalOp_Less:{setcc = is_signed ? 0x9C : 0x92;}break; // setl/setb
+              case RDI_EvalOp_Grtr:{setcc = is_signed ? 0x9F : 0x97;}break; // setg/seta
+            }
+            if(op != RDI_EvalOp_EqEq && op != RDI_EvalOp_NtEq)
+            {
+              c->good = c->good && is_int;
+            }
+            U8 inst[] =
+            {
+              0x48, 0x39, 0xC8,                                           // cmp rax, rcx
+              0x0F, setcc, 0xC0,                                          // setcc al
+              0x0F, 0xB6, 0xC0,                                           // movzx eax, al
+            };
+            e_native_emit(c, str8(inst, sizeof(inst)));
+          }break;
+        }
+        e_native_push_rax(c);
+      }break;
+    }
+  }
+}
+
+internal String8
+e_native_code_from_bytecode(Arena *arena, String8 bytecode, String8 frame_base_bytecode)
+{
+  String8 result = {0};
+  if(e_interpret_ctx->reg_arch == Arch_x64 && bytecode.size != 0)
+  {
+    Temp scratch = scratch_begin(&arena, 1);
+    E_NativeCompiler *c = push_array(scratch.arena, E_NativeCompiler, 1);
+    c->code = push_array_no_zero(scratch.arena, U8, E_NATIVE_CODE_CAP);
+    c->good = 1;
+    c->base_off = (e_interpret_ctx->module_base ? e_interpret_ctx->module_base[0] : 0);
+    c->frame_base_bytecode = frame_base_bytecode;
+
+    //- generate body
+    e_native_compile(c, bytecode);
+
+    //- result is the bottom of the stack, as in the interpreter
+    if(c->stack_count == 0)
+    {
+      e_native_emit(c, str8_lit("\x31\xC0"));                             // xor eax, eax
+    }
+    else if(c->stack[0].is_const)
+    {
+      e_native_emit_mov_imm(c, 0, c->stack[0].value);
+    }
+    else
+    {
+      e_native_emit(c, str8_lit("\x48\x8B\x42\xF8"));                     // mov rax, [rdx-8]
+    }
+
+    //- error exit: nonzero result, so the debugger evaluates the condition
+    if(c->error_jump_count != 0)
+    {
+      e_native_emit(c, str8_lit("\xEB\x05"));                             // jmp .done
+      for EachIndex(idx, c->error_jump_count)
+      {
+        U64 jump_off = c->error_jump_offs[idx];
+        U32 disp = (U32)(c->code_size - (jump_off + sizeof(U32)));
+        MemoryCopy(c->code + jump_off, &disp, sizeof(disp));
+      }
+      e_native_emit(c, str8_lit("\xB8\x01\x00\x00\x00"));                 // .error: mov eax, 1
+    }
+
+    if(c->good)
+    {
+      result = push_str8_copy(arena, str8(c->code, c->code_size));
+    }
+    scratch_end(scratch);
+  }
+  return result;
+}
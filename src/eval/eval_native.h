@@ -0,0 +1,62 @@
+// Copyright (c) Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+#ifndef EVAL_NATIVE_H
+#define EVAL_NATIVE_H
+
+////////////////////////////////
+//~ Native Code Generation
+//
+// Compiles the subset of bytecode which simple conditions lower to - integer
+// arithmetic & comparisons over constants, registers, frame & module offsets,
+// & memory in the primary space - to x64 code which follows the condition
+// code convention of condition trampolines (see `x64/x64.h`). The interpret
+// context selects the register & primary spaces, as for `e_interpret`.
+//
+// Anything outside of that subset (floats, control flow, TLS, wide values,
+// other spaces) produces no code. Where the interpreter would fail, the code
+// produces a nonzero result (divides by zero), or faults (bad memory reads),
+// so that the debugger evaluates the condition itself.
+
+#define E_NATIVE_STACK_CAP 64
+#define E_NATIVE_CODE_CAP  KB(4)
+#define E_NATIVE_ERROR_JUMPS_CAP 16
+
+typedef struct E_NativeSlot E_NativeSlot;
+struct E_NativeSlot
+{
+  B32 is_const;
+  U64 value;
+};
+
+typedef struct E_NativeCompiler E_NativeCompiler;
+struct E_NativeCompiler
+{
+  U8 *code;
+  U64 code_size;
+  B32 good;
+
+  // compile-time view of the evaluation stack; consts are folded until a
+  // runtime value needs them, so they always sit on top of runtime values,
+  // which live on the native stack, below the condition frame
+  E_NativeSlot stack[E_NATIVE_STACK_CAP];
+  U64 stack_count;
+  U64 runtime_count;
+
+  // interpreter state which is known when compiling
+  B32 space_is_reg;
+  U64 base_off;
+  String8 frame_base_bytecode;
+  B32 is_in_frame_base;
+
+  // `jz` displacements to patch to the error exit
+  U64 error_jump_offs[E_NATIVE_ERROR_JUMPS_CAP];
+  U64 error_jump_count;
+};
+
+////////////////////////////////
+//~ Native Code Generation Functions
+
+internal String8 e_native_code_from_bytecode(Arena *arena, String8 bytecode, String8 frame_base_bytecode);
+
+#endif // EVAL_NATIVE_H
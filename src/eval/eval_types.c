@@ -2577,7 +2577,7 @@ E_TYPE_EXPAND_RANGE_FUNCTION_DEF(array)
 //~ rjf: (Built-In Type Hooks) `list` lens
 
 internal AC_Artifact
-e_list_gather_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out)
+e_list_gather_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   Temp scratch = scratch_begin(0, 0);
   
@@ -2702,6 +2702,7 @@ e_list_gather_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U
         idx += n->count;
       }
     }
+    size_out[0] = arena_pos(arena);
   }
   
   //- rjf: package
@@ -17,6 +17,9 @@ fs_init(void)
   fs_shared->slots_count = 1024;
   fs_shared->slots = push_array(arena, FS_Slot, fs_shared->slots_count);
   fs_shared->stripes = stripe_array_alloc(arena);
+#if OS_LINUX
+  fs_shared->watcher = file_watcher_alloc();
+#endif
 }
 
 ////////////////////////////////
@@ -32,7 +35,7 @@ fs_change_gen(void)
 //~ rjf: Cache Interaction
 
 internal AC_Artifact
-fs_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out)
+fs_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   ProfBeginFunction();
   Temp scratch = scratch_begin(0, 0);
@@ -159,6 +162,7 @@ fs_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out
         {
           c_submit_data(content_key, &data_arena, str8(data_buffer, data_buffer_size));
         }
+        size_out[0] = data_buffer_size;
       }
     }
     lane_sync();
@@ -196,6 +200,13 @@ fs_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out
         MemoryZeroStruct(node);
         node->path = str8_copy(stripe->arena, path);
         SLLQueuePush(slot->first, slot->last, node);
+        
+        // NOTE: the watch starts after `pre_props` was measured; re-stat once
+        // on the next tick, to catch changes in between.
+#if OS_LINUX
+        node->is_watched = file_watcher_add_path(fs_shared->watcher, node->path);
+#endif
+        node->is_stat_requested = 1;
       }
       node->last_modified_timestamp = pre_props.modified;
       node->size = pre_props.size;
@@ -288,8 +299,48 @@ internal void
 fs_async_tick(void)
 {
   ProfBeginFunction();
+  Temp scratch = scratch_begin(0, 0);
+  
+  //- flag paths the watcher reports as possibly changed, & go back to polling
+  // paths it no longer watches; if it dropped changes, poll every path this
+  // tick
+  B32 poll_all = 0;
+#if OS_LINUX
+  if(lane_idx() == 0) ProfScope("gather watched changes")
+  {
+    FileWatchChanges changes = file_watcher_pop_changes(scratch.arena, fs_shared->watcher);
+    poll_all = changes.lost_changes;
+    String8List lists[] = {changes.paths, changes.unwatched_paths};
+    for EachElement(list_idx, lists)
+    {
+      for EachNode(path_n, String8Node, lists[list_idx].first)
+      {
+        U64 hash = u64_hash_from_str8(path_n->string);
+        U64 slot_idx = hash%fs_shared->slots_count;
+        FS_Slot *slot = &fs_shared->slots[slot_idx];
+        Stripe *stripe = stripe_from_slot_idx(&fs_shared->stripes, slot_idx);
+        RWMutexScope(stripe->rw_mutex, 1)
+        {
+          for(FS_Node *n = slot->first; n != 0; n = n->next)
+          {
+            if(str8_match(n->path, path_n->string, 0))
+            {
+              n->is_stat_requested = 1;
+              if(list_idx == 1)
+              {
+                n->is_watched = 0;
+              }
+              break;
+            }
+          }
+        }
+      }
+    }
+  }
+#endif
+  lane_sync_u64(&poll_all, 0);
   
-  //- rjf: detect changed timestamps for active paths
+  //- rjf: detect changed timestamps for active paths (unwatched, or flagged)
   {
     Rng1U64 range = lane_range(fs_shared->slots_count);
     for EachInRange(slot_idx, range)
@@ -303,6 +354,18 @@ fs_async_tick(void)
         {
           for(FS_Node *n = slot->first; n != 0; n = n->next)
           {
+            if(n->is_watched && !n->is_stat_requested && !poll_all)
+            {
+              continue;
+            }
+            if(n->is_stat_requested)
+            {
+              found_work = 1;
+              if(write_mode)
+              {
+                n->is_stat_requested = 0;
+              }
+            }
             FileProperties props = properties_from_file_path(n->path);
             if(props.modified != n->last_modified_timestamp)
             {
@@ -311,6 +374,14 @@ fs_async_tick(void)
               {
                 n->gen += 1;
                 ins_atomic_u64_inc_eval(&fs_shared->change_gen);
+#if OS_LINUX
+                // a polled path which exists again (e.g. was re-created
+                // after its watch was dropped) -> try to watch it again
+                if(!n->is_watched && props.modified != 0)
+                {
+                  n->is_watched = file_watcher_add_path(fs_shared->watcher, n->path);
+                }
+#endif
               }
             }
           }
@@ -323,5 +394,6 @@ fs_async_tick(void)
     }
   }
   
+  scratch_end(scratch);
   ProfEnd();
 }
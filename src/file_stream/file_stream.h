@@ -15,6 +15,8 @@ struct FS_Node
   U64 gen;
   U64 last_modified_timestamp;
   U64 size;
+  B32 is_watched;        // changes are reported by `fs_shared->watcher`; not polled
+  B32 is_stat_requested; // watcher reported a possible change; re-stat on next tick
 };
 
 typedef struct FS_Slot FS_Slot;
@@ -35,6 +37,7 @@ struct FS_Shared
   U64 slots_count;
   FS_Slot *slots;
   StripeArray stripes;
+  FileWatcher watcher;
 };
 
 ////////////////////////////////
@@ -55,7 +58,7 @@ internal U64 fs_change_gen(void);
 ////////////////////////////////
 //~ rjf: Artifact Cache Hooks / Accessing API
 
-internal AC_Artifact fs_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out);
+internal AC_Artifact fs_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out);
 internal void fs_artifact_destroy(AC_Artifact artifact);
 
 internal C_Key fs_key_from_path_range(String8 path, Rng1U64 range, U64 endt_us);
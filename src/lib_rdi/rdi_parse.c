@@ -236,6 +236,16 @@ rdi_section_raw_data_from_kind(RDI_Parsed *rdi, RDI_SectionKind kind, RDI_Sectio
     result = rdi->raw_data+rdi->sections[kind].off;
     *size_out = rdi->sections[kind].encoded_size;
     *encoding_out = rdi->sections[kind].encoding;
+    if(rdi->sections[kind].encoding != RDI_SectionEncoding_Unpacked && rdi->section_unpack_function != 0)
+    {
+      void *unpacked_data = rdi->section_unpack_function(rdi->section_unpack_user_data, rdi, kind);
+      if(unpacked_data != 0)
+      {
+        result = unpacked_data;
+        *size_out = rdi->sections[kind].unpacked_size;
+        *encoding_out = RDI_SectionEncoding_Unpacked;
+      }
+    }
   }
   return result;
 }
@@ -332,6 +342,37 @@ rdi_decompress_parsed(U8 *decompressed_data, U64 decompressed_size, RDI_Parsed *
   }
 }
 
+internal B32
+rdi_decompress_section(U8 *decompressed_data, U64 decompressed_size, RDI_Parsed *rdi, RDI_SectionKind kind)
+{
+  B32 result = 0;
+  if(0 <= kind && kind < rdi->sections_count)
+  {
+    RDI_Section *section = &rdi->sections[kind];
+    if(section->unpacked_size <= decompressed_size &&
+       section->off <= rdi->raw_data_size &&
+       section->encoded_size <= rdi->raw_data_size - section->off)
+    {
+      switch(section->encoding)
+      {
+        default:{}break;
+        case RDI_SectionEncoding_Unpacked:
+        {
+          MemoryCopy(decompressed_data, rdi->raw_data + section->off, Min(section->encoded_size, section->unpacked_size));
+          result = 1;
+        }break;
+        case RDI_SectionEncoding_LZB:
+        {
+          rr_lzb_simple_decode(rdi->raw_data + section->off, section->encoded_size,
+                               decompressed_data, section->unpacked_size);
+          result = 1;
+        }break;
+      }
+    }
+  }
+  return result;
+}
+
 //- strings
 
 RDI_PROC RDI_U8 *
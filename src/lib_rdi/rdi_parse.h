@@ -54,12 +54,25 @@ typedef enum RDI_ParseStatus
 RDI_ParseStatus;
 
 typedef struct RDI_Parsed RDI_Parsed;
+
+// NOTE: Lazy Section Unpacking
+//
+// * optional hook for compressed RDIs; when set, any section which is not
+// * stored unpacked is passed to this hook the first time it is touched,
+// * instead of reading as empty.
+// * the hook returns `unpacked_size` bytes of unpacked section data (e.g. from
+// * `rdi_decompress_section`), and owns, caches, & synchronizes that data; it
+// * may return 0 on failure.
+typedef void *RDI_SectionUnpackFunctionType(void *user_data, RDI_Parsed *rdi, RDI_SectionKind kind);
+
 struct RDI_Parsed
 {
   RDI_U8 *raw_data;
   RDI_U64 raw_data_size;
   RDI_Section *sections;
   RDI_U64 sections_count;
+  RDI_SectionUnpackFunctionType *section_unpack_function;
+  void *section_unpack_user_data;
 };
 
 typedef struct RDI_ParsedLineTable RDI_ParsedLineTable;
@@ -150,6 +163,7 @@ RDI_PROC RDI_U64 rdi_decompressed_size_from_parsed(RDI_Parsed *rdi);
 
 //- decompression
 internal void rdi_decompress_parsed(U8 *decompressed_data, U64 decompressed_size, RDI_Parsed *og_rdi);
+internal B32 rdi_decompress_section(U8 *decompressed_data, U64 decompressed_size, RDI_Parsed *rdi, RDI_SectionKind kind);
 
 //- strings
 RDI_PROC RDI_U8 *rdi_string_from_idx(RDI_Parsed *rdi, RDI_U32 idx, RDI_U64 *len_out);
@@ -144,6 +144,7 @@ lnk_make_default_cmd_line(Arena *arena, LNK_CmdLine user_cmd_line)
   lnk_cmd_line_push_option_if_not_presentf(arena, &cmd_line, LNK_CmdSwitch_Rad_Exe,                     "");
   lnk_cmd_line_push_option_if_not_presentf(arena, &cmd_line, LNK_CmdSwitch_Rad_Guid,                    "imageblake3");
   lnk_cmd_line_push_option_if_not_presentf(arena, &cmd_line, LNK_CmdSwitch_Rad_LargePages,              "no");
+  lnk_cmd_line_push_option_if_not_presentf(arena, &cmd_line, LNK_CmdSwitch_Rad_LibIndex,                "");
   lnk_cmd_line_push_option_if_not_presentf(arena, &cmd_line, LNK_CmdSwitch_Rad_LinkVer,                 "14.0");
   lnk_cmd_line_push_option_if_not_presentf(arena, &cmd_line, LNK_CmdSwitch_Rad_OsVer,                   "6.0");
   lnk_cmd_line_push_option_if_not_presentf(arena, &cmd_line, LNK_CmdSwitch_Rad_PageSize,                "%u", KB(4));
@@ -218,18 +219,23 @@ lnk_config_from_argcv(Arena *arena, int argc, char **argv)
 #endif
 
   // make command line
-  LNK_CmdLine cmd_line = {0};
+  LNK_CmdLine cmd_line      = {0};
+  String8     cmd_line_text = {0};
   {
     String8List unwrapped_cmd_line = lnk_unwrap_rsp(scratch.arena, raw_cmd_line);
     LNK_CmdLine user_cmd_line      = lnk_cmd_line_parse_windows_rules(scratch.arena, unwrapped_cmd_line);
     LNK_CmdLine default_cmd_line   = lnk_make_default_cmd_line(scratch.arena, user_cmd_line);
     lnk_cmd_line_concat_in_place(&cmd_line, &default_cmd_line);
     lnk_cmd_line_concat_in_place(&cmd_line, &user_cmd_line);
+    cmd_line_text = str8_list_join(scratch.arena, &unwrapped_cmd_line, &(StringJoin){ .sep = str8_lit_comp("\n") });
   }
 
   // init config
   LNK_Config *config = lnk_config_from_cmd_line(raw_cmd_line, cmd_line);
 
+  // hash of the expanded command line and work dir, incremental links are done only when it matches
+  config->cmd_line_hash = u128_hash_from_str8(push_str8f(scratch.arena, "%S\n%S", config->work_dir, cmd_line_text));
+
   scratch_end(scratch);
   return config;
 }
@@ -1285,7 +1291,7 @@ lnk_load_libs(TP_Context *tp, TP_Arena *arena, LNK_Config *config, LNK_Inputer *
       lnk_log(LNK_Log_InputObj, "[ Lib Input Size %M ]", input_size);
     }
 
-    lnk_lib_list_push_parallel(tp, arena, &link->libs, new_input_libs.count, new_input_libs.v);
+    lnk_lib_list_push_parallel(tp, arena, &link->libs, &link->lib_index, config->lib_cache_dir, config->io_flags, new_input_libs.count, new_input_libs.v);
 
     ProfEnd();
   }
@@ -1418,11 +1424,9 @@ lnk_load_inputs(TP_Context *tp, TP_Arena *arena, LNK_Config *config, LNK_Inputer
     if (config->entry_point_name.size == 0 && config->subsystem != PE_WindowsSubsystem_UNKNOWN) {
       String8Array entry_points = pe_get_entry_point_names(config->machine, config->subsystem, config->file_characteristics);
       for EachIndex(entry_idx, entry_points.count) {
-        for (LNK_LibNode *lib_n = link->libs.first; lib_n != 0; lib_n = lib_n->next) {
-          if (lnk_search_lib(&lib_n->data, entry_points.v[entry_idx], 0)) {
-            config->entry_point_name = entry_points.v[entry_idx];
-            goto found_entry_in_libs;
-          }
+        if (lnk_lib_index_search(&link->lib_index, entry_points.v[entry_idx])) {
+          config->entry_point_name = entry_points.v[entry_idx];
+          goto found_entry_in_libs;
         }
       }
       found_entry_in_libs:;
@@ -1557,8 +1561,108 @@ lnk_queue_lib_member(Arena                *arena,
   }
 }
 
+internal B32
+lnk_is_lib_search_symbol(LNK_Symbol *symbol)
+{
+  // slot is empty while undefined symbol is replaced with an alternate name
+  if (symbol == 0) {
+    return 1;
+  }
+  COFF_SymbolValueInterpType interp = lnk_interp_from_symbol(symbol);
+  return interp == COFF_SymbolValueInterp_Undefined || interp == COFF_SymbolValueInterp_Weak;
+}
+
+internal void
+lnk_push_lib_search_candidate(Arena *arena, LNK_Lib *lib, LNK_SymbolHashTrie *slot, U32 member_idx)
+{
+  LNK_LibSearchCandidate *candidate = push_array(arena, LNK_LibSearchCandidate, 1);
+  candidate->slot       = slot;
+  candidate->member_idx = member_idx;
+  for (;;) {
+    LNK_LibSearchCandidate *head = ins_atomic_ptr_eval(&lib->search_candidates);
+    candidate->next = head;
+    if (ins_atomic_ptr_eval_cond_assign(&lib->search_candidates, candidate, head) == head) {
+      break;
+    }
+  }
+}
+
+internal
+THREAD_POOL_TASK_FUNC(lnk_push_candidates_from_new_lib_task)
+{
+  LNK_LibSearchCandidatesTask *task = raw_task;
+  LNK_Lib                     *lib  = task->new_libs[task_id];
+
+  for EachIndex(symbol_idx, lib->symbol_count) {
+    String8             name = lib->symbol_names.v[symbol_idx];
+    LNK_SymbolHashTrie *slot = lnk_symbol_table_search_(task->symtab, name);
+    if (slot && lnk_is_lib_search_symbol(slot->symbol)) {
+      // push member that index picked for the lib, so symbol defined in more than one member resolves the same way
+      LNK_LibSymbolDefn *defn = lnk_lib_index_search(task->lib_index, name);
+      for (; defn->lib != lib; defn = defn->next);
+      lnk_push_lib_search_candidate(arena, lib, slot, defn->member_idx);
+    }
+  }
+}
+
+internal
+THREAD_POOL_TASK_FUNC(lnk_push_candidates_from_new_symbols_task)
+{
+  LNK_LibSearchCandidatesTask *task   = raw_task;
+  LNK_SymbolSearchCursor      *cursor = &task->search_cursors[task_id];
+
+  LNK_SymbolHashTrieChunk *c     = cursor->chunk ? cursor->chunk : task->symtab->search_chunks[task_id].first;
+  U64                      start = cursor->count;
+  for (; c != 0; c = c->next, start = 0) {
+    for (U64 i = start; i < c->count; i += 1) {
+      LNK_SymbolHashTrie *slot = &c->v[i];
+      if (lnk_is_lib_search_symbol(slot->symbol)) {
+        // libs loaded in this round already have candidates for all symbols in the table
+        for (LNK_LibSymbolDefn *defn = lnk_lib_index_search(task->lib_index, *slot->name); defn != 0 && defn->lib->input_idx < task->new_libs_input_idx; defn = defn->next) {
+          lnk_push_lib_search_candidate(arena, defn->lib, slot, defn->member_idx);
+        }
+      }
+    }
+    cursor->chunk = c;
+    cursor->count = c->count;
+  }
+}
+
+internal void
+lnk_push_lib_search_candidates(TP_Context *tp, TP_Arena *arena, LNK_SymbolTable *symtab, LNK_Link *link)
+{
+  ProfBeginFunction();
+  Temp scratch = scratch_begin(arena->v, arena->count);
+
+  // gather libs loaded since the last push
+  U64 new_libs_count = 0;
+  for (LNK_LibNode *lib_n = *link->last_search_lib; lib_n != 0; lib_n = lib_n->next) {
+    new_libs_count += 1;
+  }
+  LNK_Lib **new_libs = push_array_no_zero(scratch.arena, LNK_Lib *, new_libs_count);
+  for (U64 i = 0; *link->last_search_lib; link->last_search_lib = &(*link->last_search_lib)->next, i += 1) {
+    new_libs[i] = &(*link->last_search_lib)->data;
+  }
+
+  LNK_LibSearchCandidatesTask task = {0};
+  task.symtab             = symtab;
+  task.lib_index          = &link->lib_index;
+  task.new_libs           = new_libs;
+  task.new_libs_input_idx = new_libs_count ? new_libs[0]->input_idx : max_U64;
+  task.search_cursors     = link->search_cursors;
+
+  // match new libs against every undefined and weak symbol in the table
+  tp_for_parallel(tp, arena, new_libs_count, lnk_push_candidates_from_new_lib_task, &task);
+
+  // match symbols inserted since the last push against previously loaded libs
+  tp_for_parallel(tp, arena, tp->worker_count, lnk_push_candidates_from_new_symbols_task, &task);
+
+  scratch_end(scratch);
+  ProfEnd();
+}
+
 internal
-THREAD_POOL_TASK_FUNC(lnk_search_lib_task)
+THREAD_POOL_TASK_FUNC(lnk_search_sorted_lib_task)
 {
   LNK_SearchLibTask    *task             = raw_task;
   LNK_Lib              *lib              = task->lib;
@@ -1570,20 +1674,23 @@ THREAD_POOL_TASK_FUNC(lnk_search_lib_task)
   for EachNode(c, LNK_SymbolHashTrieChunk, symtab->search_chunks[task_id].first) {
     for EachIndex(i, c->count) {
       LNK_Symbol *symbol = c->v[i].symbol;
+      if (symbol == 0) {
+        continue;
+      }
 
       LNK_ObjSymbolRef           symbol_ref    = lnk_ref_from_symbol(symbol);
       COFF_ParsedSymbol          symbol_parsed = lnk_parsed_from_symbol(symbol);
       COFF_SymbolValueInterpType symbol_interp = coff_interp_from_parsed_symbol(symbol_parsed);
       if (symbol_interp == COFF_SymbolValueInterp_Undefined) {
         U32 member_idx;
-        if (lnk_search_lib(lib, symbol->name, &member_idx)) {
+        if (lnk_search_lib_sorted(lib, symbol->name, &member_idx)) {
           lnk_queue_lib_member(arena, task->imports_hm, task->link->lib_member_infos_hm, member_ref_list, symbol, lib, lib_member_infos, member_idx);
         }
       } else if (symbol_interp == COFF_SymbolValueInterp_Weak) {
         COFF_SymbolWeakExt *weak_ext = coff_parse_weak_tag(symbol_parsed, symbol_ref.obj->header.is_big_obj);
         if (weak_ext->characteristics == COFF_WeakExt_SearchLibrary) {
           U32 member_idx;
-          if (lnk_search_lib(lib, symbol->name, &member_idx)) {
+          if (lnk_search_lib_sorted(lib, symbol->name, &member_idx)) {
             lnk_queue_lib_member(arena, task->imports_hm, task->link->lib_member_infos_hm, member_ref_list, symbol, lib, lib_member_infos, member_idx);
           }
         } else if (weak_ext->characteristics == COFF_WeakExt_AntiDependency) {
@@ -1594,7 +1701,7 @@ THREAD_POOL_TASK_FUNC(lnk_search_lib_task)
               COFF_SymbolValueInterpType dep_interp = coff_interp_from_parsed_symbol(dep_parsed);
               if (dep_interp == COFF_SymbolValueInterp_Weak) {
                 U32 member_idx;
-                if (lnk_search_lib(lib, symbol_parsed.name, &member_idx)) {
+                if (lnk_search_lib_sorted(lib, symbol_parsed.name, &member_idx)) {
                   lnk_queue_lib_member(arena, task->imports_hm, task->link->lib_member_infos_hm, member_ref_list, symbol, lib, lib_member_infos, member_idx);
                 }
               }
@@ -1606,6 +1713,56 @@ THREAD_POOL_TASK_FUNC(lnk_search_lib_task)
   }
 }
 
+internal void
+lnk_search_lib(Arena                *arena,
+               HashMap              *imports_hm,
+               LNK_Link             *link,
+               LNK_SymbolTable      *symtab,
+               B32                   search_anti_deps,
+               LNK_Lib              *lib,
+               LNK_LibMemberInfo    *lib_member_infos,
+               LNK_LibMemberRefList *member_ref_list)
+{
+  for (LNK_LibSearchCandidate **candidate_ptr = &lib->search_candidates; *candidate_ptr != 0; ) {
+    LNK_LibSearchCandidate *candidate = *candidate_ptr;
+    LNK_Symbol             *symbol    = candidate->slot->symbol;
+
+    // symbol was defined, drop candidate from the list
+    if ( ! lnk_is_lib_search_symbol(symbol)) {
+      *candidate_ptr = candidate->next;
+      continue;
+    }
+    candidate_ptr = &candidate->next;
+
+    if (symbol == 0) {
+      continue;
+    }
+
+    LNK_ObjSymbolRef           symbol_ref    = lnk_ref_from_symbol(symbol);
+    COFF_ParsedSymbol          symbol_parsed = lnk_parsed_from_symbol(symbol);
+    COFF_SymbolValueInterpType symbol_interp = coff_interp_from_parsed_symbol(symbol_parsed);
+    if (symbol_interp == COFF_SymbolValueInterp_Undefined) {
+      lnk_queue_lib_member(arena, imports_hm, link->lib_member_infos_hm, member_ref_list, symbol, lib, lib_member_infos, candidate->member_idx);
+    } else if (symbol_interp == COFF_SymbolValueInterp_Weak) {
+      COFF_SymbolWeakExt *weak_ext = coff_parse_weak_tag(symbol_parsed, symbol_ref.obj->header.is_big_obj);
+      if (weak_ext->characteristics == COFF_WeakExt_SearchLibrary) {
+        lnk_queue_lib_member(arena, imports_hm, link->lib_member_infos_hm, member_ref_list, symbol, lib, lib_member_infos, candidate->member_idx);
+      } else if (weak_ext->characteristics == COFF_WeakExt_AntiDependency) {
+        if (search_anti_deps) {
+          LNK_ObjSymbolRef dep_symbol = {0};
+          if (lnk_resolve_weak_symbol(symtab, symbol_ref, &dep_symbol)) {
+            COFF_ParsedSymbol          dep_parsed = lnk_parsed_symbol_from_coff_symbol_idx(dep_symbol.obj, dep_symbol.symbol_idx);
+            COFF_SymbolValueInterpType dep_interp = coff_interp_from_parsed_symbol(dep_parsed);
+            if (dep_interp == COFF_SymbolValueInterp_Weak) {
+              lnk_queue_lib_member(arena, imports_hm, link->lib_member_infos_hm, member_ref_list, symbol, lib, lib_member_infos, candidate->member_idx);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 internal LNK_Lib *
 lnk_find_first_crt_lib(LNK_Config *config, LNK_Inputer *inputer)
 {
@@ -1742,16 +1899,25 @@ lnk_link_inputs(TP_Context      *tp,
         } else {
           // search symbols in lib
           MemoryZeroTyped(member_ref_lists, tp->worker_count);
-          LNK_SearchLibTask search_task = {
-            .search_anti_deps = search_anti_deps,
-            .link             = link,
-            .imports_hm       = &imports_hm,
-            .lib              = lib,
-            .symtab           = symtab,
-            .lib_member_infos = lib_member_infos,
-            .member_ref_lists = member_ref_lists
-          };
-          tp_for_parallel(tp, arena, tp->worker_count, lnk_search_lib_task, &search_task);
+          if (config->flags & LNK_ConfigFlag_LibIndex) {
+            lnk_push_lib_search_candidates(tp, arena, symtab, link);
+            lnk_search_lib(arena->v[0], &imports_hm, link, symtab, search_anti_deps, lib, lib_member_infos, &member_ref_lists[0]);
+          } else {
+            // bsearch every undefined and weak symbol in the lib
+            if (lib->sorted_symbol_names.v == 0) {
+              lnk_lib_sort_symbols(link->arena, lib);
+            }
+            LNK_SearchLibTask search_task = {
+              .search_anti_deps = search_anti_deps,
+              .link             = link,
+              .imports_hm       = &imports_hm,
+              .lib              = lib,
+              .symtab           = symtab,
+              .lib_member_infos = lib_member_infos,
+              .member_ref_lists = member_ref_lists
+            };
+            tp_for_parallel(tp, arena, tp->worker_count, lnk_search_sorted_lib_task, &search_task);
+          }
         }
 
         LNK_LibMemberRefList queued_members = {0};
@@ -1921,6 +2087,8 @@ lnk_link_image(TP_Context *tp, TP_Arena *arena, LNK_Config *config, LNK_Inputer
   link->last_default_lib           = &config->input_default_lib_list.first;
   link->last_obj_lib               = &config->input_obj_lib_list.first;
   link->last_cmd_lib               = &config->input_list[LNK_Input_Lib].first;
+  link->last_search_lib            = &link->libs.first;
+  link->search_cursors             = push_array(arena->v[0], LNK_SymbolSearchCursor, tp->worker_count);
   link->try_to_resolve_entry_point = 1;
 
   // input :null_obj
@@ -2339,6 +2507,14 @@ lnk_link_image(TP_Context *tp, TP_Arena *arena, LNK_Config *config, LNK_Inputer
     lnk_opt_ref(tp, symtab, config, link->objs);
   }
 
+  //
+  // fold identical COMDAT sections
+  //
+  LNK_IcfStats icf_stats = {0};
+  if (config->opt_icf == LNK_SwitchState_Yes) {
+    icf_stats = lnk_opt_icf(tp, arena, symtab, config, link->objs);
+  }
+
   //
   // infer minimal padding size for functions from the target machine
   //
@@ -2353,6 +2529,8 @@ lnk_link_image(TP_Context *tp, TP_Arena *arena, LNK_Config *config, LNK_Inputer
   LNK_LinkResult result = {0};
   result.objs = link->objs;
   result.libs = link->libs;
+  result.lib_index = link->lib_index;
+  result.icf_stats = icf_stats;
 
   //
   // release link context
@@ -2716,6 +2894,544 @@ lnk_opt_ref(TP_Context *tp, LNK_SymbolTable *symtab, LNK_Config *config, LNK_Obj
                     &(LNK_OptRefTask){ .symtab = symtab, .config = config, .objs = objs });
 }
 
+internal B32
+lnk_icf_is_section_eligible(COFF_SectionHeader *section_header)
+{
+  if (~section_header->flags & COFF_SectionFlag_LnkCOMDAT)           { return 0; }
+  if (section_header->flags & COFF_SectionFlag_LnkRemove)            { return 0; }
+  if (section_header->flags & COFF_SectionFlag_LnkInfo)              { return 0; }
+  if (section_header->flags & LNK_SECTION_FLAG_DEBUG)                { return 0; }
+  if (section_header->flags & COFF_SectionFlag_MemWrite)             { return 0; }
+  if (section_header->flags & COFF_SectionFlag_CntUninitializedData) { return 0; }
+  return 1;
+}
+
+internal B32
+lnk_icf_is_section_root(LNK_Obj *obj, U32 section_number)
+{
+  COFF_SectionHeader *section_header = lnk_coff_section_header_from_section_number(obj, section_number);
+  if (!lnk_icf_is_section_eligible(section_header))          { return 0; }
+  if (~section_header->flags & COFF_SectionFlag_MemExecute) { return 0; }
+  if (section_header->fsize == 0)                            { return 0; }
+
+  COFF_ComdatSelectType select = COFF_ComdatSelect_Null;
+  lnk_try_comdat_props_from_section_number(obj, section_number, &select, 0, 0, 0);
+  return select != COFF_ComdatSelect_Associative;
+}
+
+internal B32
+lnk_icf_is_section_child(COFF_SectionHeader *section_header)
+{
+  // debug info doesn't affect the code, folded section's debug info is discarded
+  if (section_header->flags & COFF_SectionFlag_LnkRemove) { return 0; }
+  if (section_header->flags & COFF_SectionFlag_LnkInfo)   { return 0; }
+  if (section_header->flags & LNK_SECTION_FLAG_DEBUG)     { return 0; }
+  return 1;
+}
+
+internal U32
+lnk_icf_resolve_reloc_target(LNK_IcfTask *task, LNK_Obj *obj, U32 symbol_idx, U64 *value_out)
+{
+  LNK_ObjSymbolRef           ref    = { .obj = obj, .symbol_idx = symbol_idx };
+  COFF_ParsedSymbol          parsed = lnk_parsed_symbol_from_coff_symbol_idx(ref.obj, ref.symbol_idx);
+  COFF_SymbolValueInterpType interp = coff_interp_from_parsed_symbol(parsed);
+
+  // follow undefined and weak symbols to their definitions
+  for (U64 depth = 0; depth < 16 && (interp == COFF_SymbolValueInterp_Undefined || interp == COFF_SymbolValueInterp_Weak); depth += 1) {
+    LNK_ObjSymbolRef next_ref = {0};
+    if (!lnk_resolve_symbol(task->symtab, ref, &next_ref)) { break; }
+    ref    = next_ref;
+    parsed = lnk_parsed_symbol_from_coff_symbol_idx(ref.obj, ref.symbol_idx);
+    interp = coff_interp_from_parsed_symbol(parsed);
+  }
+
+  U32 target_idx = max_U32;
+  U64 value      = 0;
+  if (interp == COFF_SymbolValueInterp_Regular && parsed.section_number > 0 && parsed.section_number <= ref.obj->header.section_count_no_null) {
+    // COMDAT section was replaced by a leader from another obj
+    COFF_SectionHeader *section_header = lnk_coff_section_header_from_section_number(ref.obj, parsed.section_number);
+    if (section_header->flags & COFF_SectionFlag_LnkRemove) {
+      LNK_Symbol *symlink = lnk_obj_get_comdat_symlink(ref.obj, parsed.section_number);
+      if (symlink) {
+        ref    = lnk_ref_from_symbol(symlink);
+        parsed = lnk_parsed_from_symbol(symlink);
+      }
+    }
+
+    target_idx = task->sect_idxs[ref.obj->input_idx][parsed.section_number-1];
+    if (target_idx != max_U32) {
+      value = parsed.value;
+    } else {
+      U64 key[] = { ref.obj->input_idx, parsed.section_number, parsed.value };
+      value = XXH3_64bits_withSeed(key, sizeof(key), interp);
+    }
+  } else if (interp == COFF_SymbolValueInterp_Abs) {
+    value = XXH3_64bits_withSeed(&parsed.value, sizeof(parsed.value), interp);
+  } else {
+    value = XXH3_64bits_withSeed(parsed.name.str, parsed.name.size, interp);
+  }
+
+  *value_out = value;
+  return target_idx;
+}
+
+internal
+THREAD_POOL_TASK_FUNC(lnk_icf_count_sections_task)
+{
+  LNK_IcfTask *task = raw_task;
+  LNK_Obj     *obj  = task->objs[task_id];
+
+  U64 count = 0;
+  for EachIndex(sect_idx, obj->header.section_count_no_null) {
+    U32 section_number = sect_idx+1;
+    if (!lnk_icf_is_section_root(obj, section_number)) { continue; }
+    count += 1;
+    for EachNode(associated_n, U32Node, obj->associated_sections[section_number]) {
+      COFF_SectionHeader *section_header = lnk_coff_section_header_from_section_number(obj, associated_n->data);
+      if (lnk_icf_is_section_eligible(section_header)) { count += 1; }
+    }
+  }
+  task->counts[task_id] = count;
+}
+
+internal
+THREAD_POOL_TASK_FUNC(lnk_icf_gather_sections_task)
+{
+  LNK_IcfTask *task = raw_task;
+  U64          obj_idx = task_id;
+  LNK_Obj     *obj     = task->objs[obj_idx];
+
+  U32 *sect_idxs = push_array_no_zero(arena, U32, obj->header.section_count_no_null);
+  MemorySet(sect_idxs, 0xff, sizeof(sect_idxs[0]) * obj->header.section_count_no_null);
+  task->sect_idxs[obj_idx] = sect_idxs;
+
+  // assign indices to roots and their children
+  U64 cursor = task->offsets[obj_idx];
+  for EachIndex(sect_idx, obj->header.section_count_no_null) {
+    U32 section_number = sect_idx+1;
+    if (!lnk_icf_is_section_root(obj, section_number)) { continue; }
+
+    LNK_IcfSection *root = &task->sects[cursor];
+    root->obj            = obj;
+    root->section_number = section_number;
+    root->is_root        = 1;
+    sect_idxs[sect_idx]  = cursor++;
+
+    for EachNode(associated_n, U32Node, obj->associated_sections[section_number]) {
+      COFF_SectionHeader *section_header = lnk_coff_section_header_from_section_number(obj, associated_n->data);
+      if (lnk_icf_is_section_child(section_header)) {
+        root->children_count += 1;
+      }
+      if (lnk_icf_is_section_eligible(section_header)) {
+        LNK_IcfSection *child = &task->sects[cursor];
+        child->obj                     = obj;
+        child->section_number          = associated_n->data;
+        sect_idxs[associated_n->data-1] = cursor++;
+      }
+    }
+  }
+  Assert(cursor == task->offsets[obj_idx] + task->counts[obj_idx]);
+
+  // link roots with their children
+  for EachIndex(sect_idx, obj->header.section_count_no_null) {
+    U32 section_number = sect_idx+1;
+    U32 root_idx       = sect_idxs[sect_idx];
+    if (root_idx == max_U32 || !task->sects[root_idx].is_root) { continue; }
+
+    LNK_IcfSection *root = &task->sects[root_idx];
+    root->children = push_array_no_zero(arena, U32, root->children_count);
+
+    U64 child_cursor = 0;
+    for EachNode(associated_n, U32Node, obj->associated_sections[section_number]) {
+      COFF_SectionHeader *section_header = lnk_coff_section_header_from_section_number(obj, associated_n->data);
+      if (lnk_icf_is_section_child(section_header)) {
+        root->children[child_cursor++] = sect_idxs[associated_n->data-1];
+      }
+    }
+  }
+}
+
+internal
+THREAD_POOL_TASK_FUNC(lnk_icf_hash_sections_task)
+{
+  LNK_IcfTask *task  = raw_task;
+  Rng1U64      range = task->ranges[task_id];
+
+  for EachInRange(sect_idx, range) {
+    LNK_IcfSection     *sect           = &task->sects[sect_idx];
+    LNK_Obj            *obj            = sect->obj;
+    COFF_SectionHeader *section_header = lnk_coff_section_header_from_section_number(obj, sect->section_number);
+    String8             string_table   = lnk_coff_string_table_from_obj(obj);
+    String8             data           = str8_substr(obj->data, rng_1u64(section_header->foff, section_header->foff + section_header->fsize));
+    COFF_SectionFlags   flags          = section_header->flags & ~COFF_SectionFlags_LnkFlags;
+    COFF_RelocArray     relocs         = lnk_coff_reloc_info_from_section_number(obj, sect->section_number);
+
+    // sections are folded only within the same image section
+    String8 full_name = coff_name_from_section_header(string_table, section_header), name, postfix;
+    coff_parse_section_name(full_name, &name, &postfix);
+
+    // resolve relocation targets
+    sect->relocs_count = relocs.count;
+    sect->relocs       = push_array_no_zero(arena, LNK_IcfReloc, relocs.count);
+    for EachIndex(reloc_idx, relocs.count) {
+      COFF_Reloc   *reloc = &relocs.v[reloc_idx];
+      LNK_IcfReloc *dst   = &sect->relocs[reloc_idx];
+      dst->type       = reloc->type;
+      dst->apply_off  = reloc->apply_off;
+      dst->target_idx = lnk_icf_resolve_reloc_target(task, obj, reloc->isymbol, &dst->value);
+    }
+
+    // initial class is made from everything that doesn't depend on classes of other sections
+    XXH3_state_t state;
+    XXH3_INITSTATE(&state);
+    XXH3_64bits_reset(&state);
+    XXH3_64bits_update(&state, &sect->is_root, sizeof(sect->is_root));
+    XXH3_64bits_update(&state, name.str, name.size);
+    XXH3_64bits_update(&state, &flags, sizeof(flags));
+    XXH3_64bits_update(&state, &data.size, sizeof(data.size));
+    XXH3_64bits_update(&state, data.str, data.size);
+    XXH3_64bits_update(&state, &sect->relocs_count, sizeof(sect->relocs_count));
+    for EachIndex(reloc_idx, sect->relocs_count) {
+      LNK_IcfReloc *reloc     = &sect->relocs[reloc_idx];
+      B32           is_folded = reloc->target_idx != max_U32;
+      XXH3_64bits_update(&state, &reloc->type, sizeof(reloc->type));
+      XXH3_64bits_update(&state, &reloc->apply_off, sizeof(reloc->apply_off));
+      XXH3_64bits_update(&state, &is_folded, sizeof(is_folded));
+      XXH3_64bits_update(&state, &reloc->value, sizeof(reloc->value));
+    }
+    XXH3_64bits_update(&state, &sect->children_count, sizeof(sect->children_count));
+    for EachIndex(child_idx, sect->children_count) {
+      // child that can't be folded makes its root unique
+      if (sect->children[child_idx] == max_U32) {
+        XXH3_64bits_update(&state, &sect_idx, sizeof(sect_idx));
+      }
+    }
+    task->classes[sect_idx] = XXH3_64bits_digest(&state);
+  }
+}
+
+internal
+THREAD_POOL_TASK_FUNC(lnk_icf_refine_classes_task)
+{
+  LNK_IcfTask *task  = raw_task;
+  Rng1U64      range = task->ranges[task_id];
+
+  for EachInRange(sect_idx, range) {
+    LNK_IcfSection *sect = &task->sects[sect_idx];
+
+    XXH3_state_t state;
+    XXH3_INITSTATE(&state);
+    XXH3_64bits_reset(&state);
+    XXH3_64bits_update(&state, &task->classes[sect_idx], sizeof(task->classes[sect_idx]));
+    for EachIndex(reloc_idx, sect->relocs_count) {
+      LNK_IcfReloc *reloc = &sect->relocs[reloc_idx];
+      if (reloc->target_idx != max_U32) {
+        XXH3_64bits_update(&state, &task->classes[reloc->target_idx], sizeof(task->classes[reloc->target_idx]));
+      }
+    }
+    for EachIndex(child_idx, sect->children_count) {
+      U32 child = sect->children[child_idx];
+      if (child != max_U32) {
+        XXH3_64bits_update(&state, &task->classes[child], sizeof(task->classes[child]));
+      }
+    }
+    task->next_classes[sect_idx] = XXH3_64bits_digest(&state);
+  }
+}
+
+internal int
+lnk_icf_class_is_before(void *raw_a, void *raw_b)
+{
+  LNK_IcfClass *a = raw_a, *b = raw_b;
+  if (a->hash != b->hash) {
+    return a->hash < b->hash;
+  }
+  return a->sect_idx < b->sect_idx;
+}
+
+internal U64
+lnk_icf_count_classes(Arena *arena, U64 count, U64 *classes)
+{
+  Temp temp = temp_begin(arena);
+  U64 *sorted = push_array_no_zero(temp.arena, U64, count);
+  MemoryCopyTyped(sorted, classes, count);
+  radsort(sorted, count, u64_compar_is_before);
+  U64 classes_count = 0;
+  for EachIndex(i, count) {
+    if (i == 0 || sorted[i] != sorted[i-1]) { classes_count += 1; }
+  }
+  temp_end(temp);
+  return classes_count;
+}
+
+internal B8 *
+lnk_icf_find_unsettled_sections(Arena *arena, LNK_IcfTask *task, U64 *prev_classes)
+{
+  Temp scratch = scratch_begin(&arena, 1);
+
+  B8  *is_unsettled = push_array(arena, B8, task->sects_count);
+  U32 *queue        = push_array_no_zero(scratch.arena, U32, task->sects_count);
+  U64  queue_count  = 0;
+
+  // a section is unsettled when its class from the previous iteration split on the last one
+  {
+    LNK_IcfClass *prev = push_array_no_zero(scratch.arena, LNK_IcfClass, task->sects_count);
+    for EachIndex(sect_idx, task->sects_count) {
+      prev[sect_idx].hash     = prev_classes[sect_idx];
+      prev[sect_idx].sect_idx = sect_idx;
+    }
+    radsort(prev, task->sects_count, lnk_icf_class_is_before);
+
+    for (U64 run_first = 0, run_opl; run_first < task->sects_count; run_first = run_opl) {
+      B32 is_split = 0;
+      for (run_opl = run_first + 1; run_opl < task->sects_count && prev[run_opl].hash == prev[run_first].hash; run_opl += 1) {
+        is_split |= task->classes[prev[run_opl].sect_idx] != task->classes[prev[run_first].sect_idx];
+      }
+      if (is_split) {
+        for EachInRange(i, r1u64(run_first, run_opl)) {
+          is_unsettled[prev[i].sect_idx] = 1;
+          queue[queue_count++]           = prev[i].sect_idx;
+        }
+      }
+    }
+  }
+
+  // and so is every section that reaches an unsettled section through relocations or children,
+  // build reverse edges and walk them from the split sections
+  if (queue_count) {
+    U64 *users_counts = push_array(scratch.arena, U64, task->sects_count);
+    for EachIndex(sect_idx, task->sects_count) {
+      LNK_IcfSection *sect = &task->sects[sect_idx];
+      for EachIndex(reloc_idx, sect->relocs_count) {
+        if (sect->relocs[reloc_idx].target_idx != max_U32) { users_counts[sect->relocs[reloc_idx].target_idx] += 1; }
+      }
+      for EachIndex(child_idx, sect->children_count) {
+        if (sect->children[child_idx] != max_U32) { users_counts[sect->children[child_idx]] += 1; }
+      }
+    }
+
+    U64 *users_offsets = offsets_from_counts_array_u64(scratch.arena, users_counts, task->sects_count);
+    U32 *users         = push_array_no_zero(scratch.arena, U32, sum_array_u64(task->sects_count, users_counts));
+    MemoryZeroTyped(users_counts, task->sects_count);
+    for EachIndex(sect_idx, task->sects_count) {
+      LNK_IcfSection *sect = &task->sects[sect_idx];
+      for EachIndex(reloc_idx, sect->relocs_count) {
+        U32 target_idx = sect->relocs[reloc_idx].target_idx;
+        if (target_idx != max_U32) { users[users_offsets[target_idx] + users_counts[target_idx]++] = sect_idx; }
+      }
+      for EachIndex(child_idx, sect->children_count) {
+        U32 child = sect->children[child_idx];
+        if (child != max_U32) { users[users_offsets[child] + users_counts[child]++] = sect_idx; }
+      }
+    }
+
+    for EachIndex(queue_idx, queue_count) {
+      U32 sect_idx = queue[queue_idx];
+      for EachIndex(i, users_counts[sect_idx]) {
+        U32 user_idx = users[users_offsets[sect_idx] + i];
+        if (!is_unsettled[user_idx]) {
+          is_unsettled[user_idx] = 1;
+          queue[queue_count++]   = user_idx;
+        }
+      }
+    }
+  }
+
+  scratch_end(scratch);
+  return is_unsettled;
+}
+
+internal B32
+lnk_icf_section_match(LNK_IcfTask *task, U32 a_idx, U32 b_idx)
+{
+  if (a_idx == max_U32 || b_idx == max_U32)        { return 0; }
+  if (task->classes[a_idx] != task->classes[b_idx]) { return 0; }
+
+  LNK_IcfSection     *a        = &task->sects[a_idx];
+  LNK_IcfSection     *b        = &task->sects[b_idx];
+  COFF_SectionHeader *a_header = lnk_coff_section_header_from_section_number(a->obj, a->section_number);
+  COFF_SectionHeader *b_header = lnk_coff_section_header_from_section_number(b->obj, b->section_number);
+
+  // hashes may collide, compare sections for real
+  if ((a_header->flags & ~COFF_SectionFlags_LnkFlags) != (b_header->flags & ~COFF_SectionFlags_LnkFlags)) { return 0; }
+  if (a->relocs_count != b->relocs_count)     { return 0; }
+  if (a->children_count != b->children_count) { return 0; }
+
+  String8 a_name, b_name, postfix;
+  coff_parse_section_name(coff_name_from_section_header(lnk_coff_string_table_from_obj(a->obj), a_header), &a_name, &postfix);
+  coff_parse_section_name(coff_name_from_section_header(lnk_coff_string_table_from_obj(b->obj), b_header), &b_name, &postfix);
+  if (!str8_match(a_name, b_name, 0)) { return 0; }
+
+  String8 a_data = str8_substr(a->obj->data, rng_1u64(a_header->foff, a_header->foff + a_header->fsize));
+  String8 b_data = str8_substr(b->obj->data, rng_1u64(b_header->foff, b_header->foff + b_header->fsize));
+  if (!str8_match(a_data, b_data, 0)) { return 0; }
+
+  for EachIndex(reloc_idx, a->relocs_count) {
+    LNK_IcfReloc *a_reloc = &a->relocs[reloc_idx];
+    LNK_IcfReloc *b_reloc = &b->relocs[reloc_idx];
+    if (a_reloc->type != b_reloc->type)           { return 0; }
+    if (a_reloc->apply_off != b_reloc->apply_off) { return 0; }
+    if (a_reloc->value != b_reloc->value)         { return 0; }
+    if (a_reloc->target_idx != b_reloc->target_idx) {
+      if (a_reloc->target_idx == max_U32 || b_reloc->target_idx == max_U32)            { return 0; }
+      if (task->classes[a_reloc->target_idx] != task->classes[b_reloc->target_idx]) { return 0; }
+    }
+  }
+
+  for EachIndex(child_idx, a->children_count) {
+    if (!lnk_icf_section_match(task, a->children[child_idx], b->children[child_idx])) { return 0; }
+  }
+
+  return 1;
+}
+
+internal LNK_IcfStats
+lnk_opt_icf(TP_Context *tp, TP_Arena *arena, LNK_SymbolTable *symtab, LNK_Config *config, LNK_ObjList objs)
+{
+  ProfBeginFunction();
+  U64     time_begin = now_time_us();
+  Temp    scratch    = scratch_begin(arena->v, arena->count);
+  TP_Temp temp       = tp_temp_begin(arena);
+
+  LNK_IcfStats stats = {0};
+  LNK_IcfTask  task  = {0};
+  task.symtab    = symtab;
+  task.objs      = lnk_array_from_obj_list(scratch.arena, objs);
+  task.counts    = push_array(scratch.arena, U64, objs.count);
+  task.sect_idxs = push_array(scratch.arena, U32 *, objs.count);
+
+  tp_for_parallel_prof(tp, 0, objs.count, lnk_icf_count_sections_task, &task, "Count Sections");
+
+  task.offsets     = offsets_from_counts_array_u64(scratch.arena, task.counts, objs.count);
+  task.sects_count = sum_array_u64(objs.count, task.counts);
+  task.sects       = push_array(scratch.arena, LNK_IcfSection, task.sects_count);
+  task.ranges      = tp_divide_work(scratch.arena, task.sects_count, tp->worker_count);
+  task.classes      = push_array_no_zero(scratch.arena, U64, task.sects_count);
+  task.next_classes = push_array_no_zero(scratch.arena, U64, task.sects_count);
+  stats.sections_count = task.sects_count;
+
+  tp_for_parallel_prof(tp, arena, objs.count, lnk_icf_gather_sections_task, &task, "Gather Sections");
+  tp_for_parallel_prof(tp, arena, tp->worker_count, lnk_icf_hash_sections_task, &task, "Hash Sections");
+
+  // refine classes with classes of relocation targets and associated sections until partition stops changing,
+  // this also settles mutually recursive functions since their classes are refined together
+  ProfBegin("Refine Classes");
+  B32 is_converged  = 0;
+  U64 classes_count = lnk_icf_count_classes(scratch.arena, task.sects_count, task.classes);
+  for (;;) {
+    if (config->opt_iter_count != 0 && stats.iter_count >= config->opt_iter_count) { break; }
+
+    tp_for_parallel(tp, 0, tp->worker_count, lnk_icf_refine_classes_task, &task);
+    Swap(U64 *, task.classes, task.next_classes);
+    stats.iter_count += 1;
+
+    U64 next_classes_count = lnk_icf_count_classes(scratch.arena, task.sects_count, task.classes);
+    if (next_classes_count == classes_count) { is_converged = 1; break; }
+    classes_count = next_classes_count;
+  }
+  ProfEnd();
+
+  // /OPT:ICF=N stopped refinement before the partition settled, classes that are still splitting
+  // would fold callers of functions that differ deeper in the call graph, so keep those out
+  B8 *is_unsettled = 0;
+  if (!is_converged) {
+    ProfBegin("Find Unsettled Sections");
+    is_unsettled = lnk_icf_find_unsettled_sections(scratch.arena, &task, task.next_classes);
+    for EachIndex(sect_idx, task.sects_count) { stats.unsettled_count += is_unsettled[sect_idx]; }
+    ProfEnd();
+  }
+
+  // pick leaders and fold equal sections into them
+  U64                folds_count = 0;
+  LNK_ObjSectionRef *fold_srcs   = push_array_no_zero(scratch.arena, LNK_ObjSectionRef, task.sects_count);
+  LNK_ObjSectionRef *fold_dsts   = push_array_no_zero(scratch.arena, LNK_ObjSectionRef, task.sects_count);
+  {
+    ProfBegin("Find Equal Sections");
+
+    U64           roots_count = 0;
+    LNK_IcfClass *roots       = push_array_no_zero(scratch.arena, LNK_IcfClass, task.sects_count);
+    for EachIndex(sect_idx, task.sects_count) {
+      if (task.sects[sect_idx].is_root && !(is_unsettled && is_unsettled[sect_idx])) {
+        roots[roots_count].hash     = task.classes[sect_idx];
+        roots[roots_count].sect_idx = sect_idx;
+        roots_count += 1;
+      }
+    }
+
+    // sort on section index within a class so first obj in the link order provides the leader
+    radsort(roots, roots_count, lnk_icf_class_is_before);
+
+    for (U64 run_first = 0, run_opl; run_first < roots_count; run_first = run_opl) {
+      for (run_opl = run_first + 1; run_opl < roots_count && roots[run_opl].hash == roots[run_first].hash; run_opl += 1);
+
+      LNK_IcfSection *leader = &task.sects[roots[run_first].sect_idx];
+      for EachInRange(i, r1u64(run_first + 1, run_opl)) {
+        if (lnk_icf_section_match(&task, roots[run_first].sect_idx, roots[i].sect_idx)) {
+          LNK_IcfSection *sect = &task.sects[roots[i].sect_idx];
+          fold_srcs[folds_count] = (LNK_ObjSectionRef){ .obj = sect->obj,   .section_number = sect->section_number   };
+          fold_dsts[folds_count] = (LNK_ObjSectionRef){ .obj = leader->obj, .section_number = leader->section_number };
+          folds_count += 1;
+        }
+      }
+    }
+
+    ProfEnd();
+  }
+
+  tp_temp_end(temp);
+
+  {
+    ProfBegin("Fold Sections");
+
+    U64 default_align = coff_default_align_from_machine(config->machine);
+    for EachIndex(fold_idx, folds_count) {
+      LNK_ObjSectionRef   src        = fold_srcs[fold_idx];
+      LNK_ObjSectionRef   dst        = fold_dsts[fold_idx];
+      COFF_SectionHeader *src_header = lnk_coff_section_header_from_section_number(src.obj, src.section_number);
+      COFF_SectionHeader *dst_header = lnk_coff_section_header_from_section_number(dst.obj, dst.section_number);
+
+      // leader takes the strictest alignment of the sections folded into it
+      U64 src_align = coff_align_size_from_section_flags(src_header->flags);
+      U64 dst_align = coff_align_size_from_section_flags(dst_header->flags);
+      if ((src_align ? src_align : default_align) > (dst_align ? dst_align : default_align)) {
+        COFF_SectionFlags align_mask = COFF_SectionFlag_AlignMask << COFF_SectionFlag_AlignShift;
+        dst_header->flags = (dst_header->flags & ~align_mask) | (src_header->flags & align_mask);
+      }
+
+      // remove folded section and its associated sections from the output
+      src_header->flags |= COFF_SectionFlag_LnkRemove;
+      stats.folded_size += src_header->fsize;
+      for EachNode(associated_n, U32Node, src.obj->associated_sections[src.section_number]) {
+        COFF_SectionHeader *section_header = lnk_coff_section_header_from_section_number(src.obj, associated_n->data);
+        if (~section_header->flags & COFF_SectionFlag_LnkRemove) {
+          if (~section_header->flags & LNK_SECTION_FLAG_DEBUG) {
+            stats.folded_size += section_header->fsize;
+          }
+          section_header->flags |= COFF_SectionFlag_LnkRemove;
+        }
+      }
+
+      // redirect folded section to the leader
+      if (src.obj->folds == 0) {
+        src.obj->folds = push_array(arena->v[0], LNK_ObjSectionRef, src.obj->header.section_count_no_null + 1);
+      }
+      src.obj->folds[src.section_number] = dst;
+      stats.folded_count += 1;
+    }
+
+    ProfEnd();
+  }
+
+  stats.time_us = now_time_us() - time_begin;
+
+  lnk_log(LNK_Log_Debug, "/OPT:ICF total section fold    : %llu", (unsigned long long)stats.folded_count);
+  lnk_log(LNK_Log_Debug, "/OPT:ICF total file size fold  : %M",   (unsigned long long)stats.folded_size);
+
+  scratch_end(scratch);
+  ProfEnd();
+  return stats;
+}
+
 internal
 THREAD_POOL_TASK_FUNC(lnk_gather_section_definitions_task)
 {
@@ -2837,6 +3553,24 @@ THREAD_POOL_TASK_FUNC(lnk_set_comdat_leaders_contribs_task)
   ProfEnd();
 }
 
+internal
+THREAD_POOL_TASK_FUNC(lnk_set_folded_contribs_task)
+{
+  LNK_BuildImageTask *task    = raw_task;
+  U64                 obj_idx = task_id;
+  LNK_Obj            *obj     = task->objs[obj_idx];
+
+  if (obj->folds == 0) { return; }
+
+  ProfBeginV("Set Folded Section Contribs [%S]", obj->path);
+  for EachIndex(sect_idx, obj->header.section_count_no_null) {
+    LNK_ObjSectionRef fold = obj->folds[sect_idx+1];
+    if (fold.obj == 0) { continue; }
+    task->sect_map[obj_idx][sect_idx] = task->sect_map[fold.obj->input_idx][fold.section_number - 1];
+  }
+  ProfEnd();
+}
+
 internal
 THREAD_POOL_TASK_FUNC(lnk_flag_debug_symbols_task)
 {
@@ -3329,6 +4063,30 @@ THREAD_POOL_TASK_FUNC(lnk_fill_out_common_block_contribs_task)
   }
 }
 
+internal
+THREAD_POOL_TASK_FUNC(lnk_flag_incremental_contribs_task)
+{
+  LNK_BuildImageTask *task    = raw_task;
+  U64                 obj_idx = task_id;
+  LNK_Obj            *obj     = task->objs[obj_idx];
+
+  // only objs from the command line can be patched
+  if (lnk_inc_obj_kind_from_obj(obj) == LNK_IncObj_File) {
+    COFF_SectionHeader *section_table = lnk_coff_section_table_from_obj(obj);
+    String8             string_table  = lnk_coff_string_table_from_obj(obj);
+    for EachIndex(sect_idx, obj->header.section_count_no_null) {
+      COFF_SectionHeader *section_header = &section_table[sect_idx];
+      LNK_SectionContrib *sc             = task->sect_map[obj_idx][sect_idx];
+      if (sc == task->null_sc)                                { continue; }
+      if (section_header->flags & COFF_SectionFlag_LnkRemove) { continue; }
+      String8 sect_name = coff_name_from_section_header(string_table, section_header);
+      if (lnk_inc_can_grow_section(sect_name, section_header->flags)) {
+        sc->reserve = lnk_inc_reserve_from_size(section_header->fsize);
+      }
+    }
+  }
+}
+
 internal
 THREAD_POOL_TASK_FUNC(lnk_flag_hotpatch_contribs_task)
 {
@@ -4322,6 +5080,413 @@ lnk_build_win32_header(Arena *arena, LNK_SymbolTable *symtab, LNK_Config *config
   return result;
 }
 
+// --- Function Order ----------------------------------------------------------
+
+internal int
+lnk_order_edge_is_before(void *raw_a, void *raw_b)
+{
+  LNK_OrderEdge *a = raw_a;
+  LNK_OrderEdge *b = raw_b;
+  if (a->from == b->from) {
+    return a->to < b->to;
+  }
+  return a->from < b->from;
+}
+
+internal int
+lnk_order_density_is_before(void *raw_a, void *raw_b)
+{
+  LNK_OrderDensity *a = raw_a;
+  LNK_OrderDensity *b = raw_b;
+  if (a->density == b->density) {
+    return a->node_idx < b->node_idx;
+  }
+  return a->density > b->density;
+}
+
+internal int
+lnk_order_key_is_before(void *raw_a, void *raw_b)
+{
+  LNK_OrderKey *a = raw_a;
+  LNK_OrderKey *b = raw_b;
+  return a->key < b->key;
+}
+
+internal LNK_SectionContrib *
+lnk_order_contrib_from_symbol_name(LNK_BuildImageTask *task, String8 name)
+{
+  LNK_SectionContrib *sc     = 0;
+  LNK_Symbol         *symbol = lnk_symbol_table_search(task->symtab, name);
+  if (symbol && lnk_interp_from_symbol(symbol) == COFF_SymbolValueInterp_Regular) {
+    LNK_ObjSymbolRef    ref            = lnk_ref_from_symbol(symbol);
+    COFF_ParsedSymbol   parsed         = lnk_parsed_from_symbol(symbol);
+    COFF_SectionHeader *section_header = lnk_coff_section_header_from_section_number(ref.obj, parsed.section_number);
+
+    // like link.exe, only packaged functions can be moved, the rest of the section has to stay in one piece
+    if (section_header->flags & COFF_SectionFlag_LnkCOMDAT) {
+      sc = task->sect_map[ref.obj->input_idx][parsed.section_number - 1];
+      if (sc == task->null_sc) {
+        sc = 0;
+      }
+    }
+  }
+  return sc;
+}
+
+internal U32
+lnk_order_node_from_contrib(Arena *arena, HashTable *node_ht, LNK_OrderNode *nodes, U64 *nodes_count, LNK_SectionContrib *sc)
+{
+  BucketNode *bucket = hash_table_search_u64(node_ht, IntFromPtr(sc));
+  if (bucket) {
+    return bucket->v.value_u64;
+  }
+
+  U32 node_idx = safe_cast_u32(*nodes_count);
+  *nodes_count += 1;
+
+  LNK_OrderNode *node = &nodes[node_idx];
+  node->sc        = sc;
+  node->best_pred = max_U32;
+  hash_table_push_u64_u64(arena, node_ht, IntFromPtr(sc), node_idx);
+
+  return node_idx;
+}
+
+internal U32
+lnk_order_leader_from_node(LNK_OrderNode *nodes, U32 node_idx)
+{
+  U32 leader = node_idx;
+  while (nodes[leader].leader != leader) {
+    leader = nodes[leader].leader;
+  }
+  while (nodes[node_idx].leader != leader) {
+    U32 next = nodes[node_idx].leader;
+    nodes[node_idx].leader = leader;
+    node_idx = next;
+  }
+  return leader;
+}
+
+internal LNK_SectionContrib **
+lnk_order_from_order_file(Arena *arena, LNK_BuildImageTask *task, String8 path, String8 data, U64 *order_count_out, LNK_OrderStats *stats)
+{
+  ProfBeginFunction();
+  Temp scratch = scratch_begin(&arena, 1);
+
+  String8List          lines       = str8_split_by_string_chars(scratch.arena, data, str8_lit("\r\n"), 0);
+  U64                  order_count = 0;
+  LNK_SectionContrib **order       = push_array_no_zero(arena, LNK_SectionContrib *, lines.node_count);
+  for EachNode(line_n, String8Node, lines.first) {
+    String8 name = str8_skip_chop_whitespace(line_n->string);
+    if (name.size == 0) { continue; }
+
+    LNK_SectionContrib *sc = lnk_order_contrib_from_symbol_name(task, name);
+    if (sc) {
+      order[order_count++] = sc;
+    } else {
+      lnk_error(LNK_Warning_Order, "%S: \"%S\" is not a function in a COMDAT section; ignored", path, name);
+      stats->missing_count += 1;
+    }
+  }
+
+  scratch_end(scratch);
+  ProfEnd();
+  *order_count_out = order_count;
+  return order;
+}
+
+internal LNK_SectionContrib **
+lnk_order_from_profile(Arena *arena, LNK_BuildImageTask *task, String8 path, String8 data, U64 *order_count_out, LNK_OrderStats *stats)
+{
+  ProfBeginFunction();
+  Temp scratch = scratch_begin(&arena, 1);
+
+  String8List    lines       = str8_split_by_string_chars(scratch.arena, data, str8_lit("\r\n"), 0);
+  HashTable     *node_ht     = hash_table_init(scratch.arena, Max(lines.node_count, 1));
+  U64            nodes_count = 0;
+  LNK_OrderNode *nodes       = push_array(scratch.arena, LNK_OrderNode, lines.node_count * 2);
+  U64            edges_count = 0;
+  LNK_OrderEdge *edges       = push_array_no_zero(scratch.arena, LNK_OrderEdge, lines.node_count);
+
+  ProfBegin("Parse Profile");
+  {
+    U64 line_number = 0;
+    for EachNode(line_n, String8Node, lines.first) {
+      line_number += 1;
+
+      String8 line = str8_skip_chop_whitespace(line_n->string);
+      if (line.size == 0 || line.str[0] == '#') { continue; }
+
+      Temp        temp   = temp_begin(scratch.arena);
+      String8List tokens = str8_split_by_string_chars(temp.arena, line, str8_lit(" \t"), 0);
+      U64         count  = 0;
+      if (tokens.node_count == 3 && try_u64_from_str8_c_rules(tokens.last->string, &count)) {
+        LNK_SectionContrib *caller = lnk_order_contrib_from_symbol_name(task, tokens.first->string);
+        LNK_SectionContrib *callee = lnk_order_contrib_from_symbol_name(task, tokens.first->next->string);
+        if (caller && callee) {
+          LNK_OrderEdge *edge = &edges[edges_count++];
+          edge->from   = lnk_order_node_from_contrib(scratch.arena, node_ht, nodes, &nodes_count, caller);
+          edge->to     = lnk_order_node_from_contrib(scratch.arena, node_ht, nodes, &nodes_count, callee);
+          edge->weight = count;
+        } else {
+          stats->missing_count += 1;
+        }
+      } else if (tokens.node_count == 2 && try_u64_from_str8_c_rules(tokens.last->string, &count)) {
+        LNK_SectionContrib *sc = lnk_order_contrib_from_symbol_name(task, tokens.first->string);
+        if (sc) {
+          U32 node_idx = lnk_order_node_from_contrib(scratch.arena, node_ht, nodes, &nodes_count, sc);
+          nodes[node_idx].initial_weight += count;
+        } else {
+          stats->missing_count += 1;
+        }
+      } else {
+        lnk_error(LNK_Warning_Order, "%S(%llu): expected \"CALLER CALLEE COUNT\" or \"SYMBOL COUNT\"; line ignored", path, line_number);
+      }
+      temp_end(temp);
+    }
+  }
+  ProfEnd();
+
+  // a profile may list same call more than once, the heaviest caller is picked from the summed counts
+  ProfBegin("Pick Best Callers");
+  radsort(edges, edges_count, lnk_order_edge_is_before);
+  for (U64 run_first = 0, run_opl; run_first < edges_count; run_first = run_opl) {
+    U64 weight = 0;
+    for (run_opl = run_first; run_opl < edges_count && edges[run_opl].from == edges[run_first].from && edges[run_opl].to == edges[run_first].to; run_opl += 1) {
+      weight += edges[run_opl].weight;
+    }
+
+    LNK_OrderNode *callee = &nodes[edges[run_first].to];
+    callee->initial_weight += weight;
+    if (edges[run_first].from == edges[run_first].to) { continue; }
+    if (callee->best_pred == max_U32 || callee->best_pred_weight < weight) {
+      callee->best_pred        = edges[run_first].from;
+      callee->best_pred_weight = weight;
+    }
+  }
+  ProfEnd();
+
+  // C3 (Ottoni & Maher, "Optimizing Function Placement for Large-Scale Data-Center Applications"):
+  // visit functions from hottest to coldest and append each one to the cluster of its heaviest caller,
+  // unless the cluster outgrows a page-friendly size or merging dilutes cluster's density too much
+  ProfBegin("Build Clusters");
+  LNK_OrderDensity *densities = push_array_no_zero(scratch.arena, LNK_OrderDensity, nodes_count);
+  for EachIndex(node_idx, nodes_count) {
+    LNK_OrderNode *node = &nodes[node_idx];
+    node->size   = Max(lnk_size_from_section_contrib(node->sc), 1);
+    node->weight = node->initial_weight;
+    node->leader = node_idx;
+    node->next   = max_U32;
+    node->last   = node_idx;
+    densities[node_idx].density  = (F64)node->weight / (F64)node->size;
+    densities[node_idx].node_idx = node_idx;
+  }
+  radsort(densities, nodes_count, lnk_order_density_is_before);
+
+  for EachIndex(density_idx, nodes_count) {
+    U32            node_idx = densities[density_idx].node_idx;
+    LNK_OrderNode *node     = &nodes[node_idx];
+
+    // skip calls that are too cold to matter for this node
+    if (node->best_pred == max_U32 || node->best_pred_weight * 10 <= node->initial_weight) { continue; }
+
+    U32 pred_idx = lnk_order_leader_from_node(nodes, node->best_pred);
+    if (pred_idx == node_idx) { continue; }
+
+    LNK_OrderNode *pred = &nodes[pred_idx];
+    if (pred->size + node->size > LNK_ORDER_MAX_CLUSTER_SIZE) { continue; }
+
+    F64 pred_density = (F64)pred->weight / (F64)pred->size;
+    F64 new_density  = (F64)(pred->weight + node->weight) / (F64)(pred->size + node->size);
+    if (new_density < pred_density / LNK_ORDER_MAX_DENSITY_DEGRADATION) { continue; }
+
+    node->leader           = pred_idx;
+    nodes[pred->last].next = node_idx;
+    pred->last             = node->last;
+    pred->size            += node->size;
+    pred->weight          += node->weight;
+  }
+  ProfEnd();
+
+  // lay out clusters from the densest one
+  ProfBegin("Sort Clusters");
+  U64 clusters_count = 0;
+  for EachIndex(node_idx, nodes_count) {
+    LNK_OrderNode *node = &nodes[node_idx];
+    if (node->leader == node_idx) {
+      densities[clusters_count].density  = (F64)node->weight / (F64)node->size;
+      densities[clusters_count].node_idx = node_idx;
+      clusters_count += 1;
+    }
+  }
+  radsort(densities, clusters_count, lnk_order_density_is_before);
+
+  U64                  order_count = 0;
+  LNK_SectionContrib **order       = push_array_no_zero(arena, LNK_SectionContrib *, nodes_count);
+  for EachIndex(cluster_idx, clusters_count) {
+    for (U32 node_idx = densities[cluster_idx].node_idx; node_idx != max_U32; node_idx = nodes[node_idx].next) {
+      order[order_count++] = nodes[node_idx].sc;
+    }
+  }
+  Assert(order_count == nodes_count);
+  stats->clusters_count = clusters_count;
+  ProfEnd();
+
+  scratch_end(scratch);
+  ProfEnd();
+  *order_count_out = order_count;
+  return order;
+}
+
+internal U32
+lnk_order_rank_from_contrib(LNK_BuildImageTask *task, U32 **ranks, LNK_SectionContrib *sc)
+{
+  if (sc->u.obj_idx < task->objs_count && ranks[sc->u.obj_idx]) {
+    return ranks[sc->u.obj_idx][sc->u.obj_sect_idx];
+  }
+  return 0;
+}
+
+internal U64
+lnk_hot_span_from_section(LNK_BuildImageTask *task, U32 **ranks, LNK_Section *sect)
+{
+  // mirrors lnk_finalize_section_layout, offsets can't be written yet since they share storage with the obj indices
+  U64 cursor  = 0;
+  U64 hot_min = max_U64;
+  U64 hot_max = 0;
+  for (LNK_SectionContribChunk *sc_chunk = sect->contribs.first; sc_chunk != 0; sc_chunk = sc_chunk->next) {
+    for EachIndex(sc_idx, sc_chunk->count) {
+      LNK_SectionContrib *sc = sc_chunk->v[sc_idx];
+      if (sc->hotpatch) {
+        cursor += task->function_pad_min;
+      }
+      cursor = AlignPow2(cursor, sc->align);
+
+      U64 sc_size = lnk_size_from_section_contrib(sc);
+      if (lnk_order_rank_from_contrib(task, ranks, sc)) {
+        hot_min = Min(hot_min, cursor);
+        hot_max = Max(hot_max, cursor + sc_size);
+      }
+      cursor += sc_size + sc->reserve;
+    }
+  }
+  return hot_min < hot_max ? hot_max - hot_min : 0;
+}
+
+internal LNK_OrderStats
+lnk_order_section_contribs(LNK_BuildImageTask *task, LNK_Config *config)
+{
+  ProfBeginFunction();
+  U64  time_begin = now_time_us();
+  Temp scratch    = scratch_begin(0, 0);
+
+  LNK_OrderStats stats = {0};
+
+  String8 path = config->order_file_path.size ? config->order_file_path : config->order_profile_path;
+  if (!file_path_exists(path)) {
+    lnk_error(LNK_Error_FileNotFound, "unable to open order file \"%S\"", path);
+  }
+  String8 data = lnk_read_data_from_file_path(scratch.arena, config->io_flags, path);
+
+  U64                  order_count = 0;
+  LNK_SectionContrib **order;
+  if (config->order_file_path.size) {
+    order = lnk_order_from_order_file(scratch.arena, task, path, data, &order_count, &stats);
+  } else {
+    order = lnk_order_from_profile(scratch.arena, task, path, data, &order_count, &stats);
+  }
+
+  // rank contribs, symbols from one COMDAT or folded by ICF share a contrib and its first mention wins
+  U32 **ranks = push_array(scratch.arena, U32 *, task->objs_count);
+  for EachIndex(order_idx, order_count) {
+    LNK_SectionContrib *sc = order[order_idx];
+    if (ranks[sc->u.obj_idx] == 0) {
+      ranks[sc->u.obj_idx] = push_array(scratch.arena, U32, task->objs[sc->u.obj_idx]->header.section_count_no_null);
+    }
+    U32 *rank = &ranks[sc->u.obj_idx][sc->u.obj_sect_idx];
+    if (*rank == 0) {
+      stats.ordered_count += 1;
+      *rank = safe_cast_u32(stats.ordered_count);
+    }
+  }
+
+  // move ranked contribs to the front of their chunks, chunks are not reordered so grouped sections still
+  // follow the lexical order of their object-section names
+  ProfBegin("Reorder Contribs");
+  for (LNK_SectionNode *sect_n = task->sectab->list.first; sect_n != 0; sect_n = sect_n->next) {
+    stats.hot_span_before += lnk_hot_span_from_section(task, ranks, &sect_n->data);
+
+    for (LNK_SectionContribChunk *sc_chunk = sect_n->data.contribs.first; sc_chunk != 0; sc_chunk = sc_chunk->next) {
+      Temp          temp       = temp_begin(scratch.arena);
+      B32           has_ranked = 0;
+      LNK_OrderKey *keys       = push_array_no_zero(temp.arena, LNK_OrderKey, sc_chunk->count);
+      for EachIndex(sc_idx, sc_chunk->count) {
+        LNK_SectionContrib *sc   = sc_chunk->v[sc_idx];
+        U32                 rank = lnk_order_rank_from_contrib(task, ranks, sc);
+        keys[sc_idx].key = rank ? rank : stats.ordered_count + 1 + sc_idx;
+        keys[sc_idx].sc  = sc;
+        has_ranked      |= rank != 0;
+      }
+      if (has_ranked) {
+        radsort(keys, sc_chunk->count, lnk_order_key_is_before);
+        for EachIndex(sc_idx, sc_chunk->count) {
+          sc_chunk->v[sc_idx] = keys[sc_idx].sc;
+        }
+      }
+      temp_end(temp);
+    }
+
+    stats.hot_span_after += lnk_hot_span_from_section(task, ranks, &sect_n->data);
+  }
+  ProfEnd();
+
+  stats.time_us = now_time_us() - time_begin;
+
+  scratch_end(scratch);
+  ProfEnd();
+  return stats;
+}
+
+internal void
+lnk_write_image_guid(LNK_SymbolTable *symtab, String8 image_data, COFF_SectionHeader **image_section_table, Guid guid)
+{
+  LNK_Symbol *guid_pdb_symbol = lnk_symbol_table_search(symtab, str8_lit("RAD_LINK_PE_DEBUG_GUID_PDB"));
+  LNK_Symbol *guid_rdi_symbol = lnk_symbol_table_search(symtab, str8_lit("RAD_LINK_PE_DEBUG_GUID_RDI"));
+
+  if (guid_pdb_symbol) {
+    U64   cv_guid_foff = lnk_foff_from_symbol(image_section_table, guid_pdb_symbol);
+    Guid *cv_guid  = str8_deserial_get_raw_ptr(image_data, cv_guid_foff, sizeof(*cv_guid));
+    *cv_guid = guid;
+  }
+
+  if (guid_rdi_symbol) {
+    U64   cv_guid_foff = lnk_foff_from_symbol(image_section_table, guid_rdi_symbol);
+    Guid *cv_guid  = str8_deserial_get_raw_ptr(image_data, cv_guid_foff, sizeof(*cv_guid));
+    *cv_guid = guid;
+  }
+}
+
+internal void
+lnk_patch_image_guid(TP_Context *tp, LNK_Config *config, LNK_SymbolTable *symtab, String8 image_data, COFF_SectionHeader **image_section_table)
+{
+  LNK_Symbol *guid_pdb_symbol = lnk_symbol_table_search(symtab, str8_lit("RAD_LINK_PE_DEBUG_GUID_PDB"));
+  LNK_Symbol *guid_rdi_symbol = lnk_symbol_table_search(symtab, str8_lit("RAD_LINK_PE_DEBUG_GUID_RDI"));
+
+  if (guid_pdb_symbol || guid_rdi_symbol) {
+    switch (config->guid_type) {
+    case LNK_DebugInfoGuid_Null: break;
+    case Lnk_DebugInfoGuid_ImageBlake3: {
+      ProfBegin("Hash Image With Blake3");
+      U128 hash = lnk_blake3_hash_parallel(tp, 128, image_data);
+      MemoryCopy(&config->guid, hash.u8, sizeof(hash.u8));
+      ProfEnd();
+    } break;
+    }
+  }
+
+  lnk_write_image_guid(symtab, image_data, image_section_table, config->guid);
+}
+
 internal LNK_ImageContext
 lnk_build_image(TP_Arena *arena, TP_Context *tp, LNK_Config *config, LNK_SymbolTable *symtab, U64 objs_count, LNK_Obj **objs)
 {
@@ -4442,6 +5607,7 @@ lnk_build_image(TP_Arena *arena, TP_Context *tp, LNK_Config *config, LNK_SymbolT
     ProfEnd();
   }
 
+  LNK_OrderStats order_stats = {0};
   U64 expected_image_header_size;
   {
     ProfBegin("Alloc Section Map");
@@ -4478,6 +5644,7 @@ lnk_build_image(TP_Arena *arena, TP_Context *tp, LNK_Config *config, LNK_SymbolT
       ProfEnd();
     }
 
+    tp_for_parallel_prof(tp, 0, objs_count, lnk_set_folded_contribs_task, &task, "Update Section Map With Folded Contribs");
     tp_for_parallel_prof(tp, 0, objs_count, lnk_set_comdat_leaders_contribs_task, &task, "Update Section Map With COMDAT Leader Contribs");
 
     // build common block
@@ -4559,6 +5726,14 @@ lnk_build_image(TP_Arena *arena, TP_Context *tp, LNK_Config *config, LNK_SymbolT
         tp_for_parallel_prof(tp, arena, objs_count, lnk_flag_hotpatch_contribs_task, &task, "Flag Hotpatch Section Contribs");
       }
 
+      if (config->incremental == LNK_SwitchState_Yes) {
+        tp_for_parallel_prof(tp, arena, objs_count, lnk_flag_incremental_contribs_task, &task, "Flag Incremental Section Contribs");
+      }
+
+      if (config->order_file_path.size || config->order_profile_path.size) {
+        order_stats = lnk_order_section_contribs(&task, config);
+      }
+
       // assign contribs offsets, sizes, and section indices
       for (LNK_SectionNode *sect_n = sectab->list.first; sect_n != 0; sect_n = sect_n->next) {
         lnk_finalize_section_layout(&sect_n->data, config->file_align, config->function_pad_min);
@@ -4932,34 +6107,7 @@ lnk_build_image(TP_Arena *arena, TP_Context *tp, LNK_Config *config, LNK_SymbolT
     }
 
     // compute image guid, and patch PDB and RDI guids
-    {
-      LNK_Symbol *guid_pdb_symbol = lnk_symbol_table_search(symtab, str8_lit("RAD_LINK_PE_DEBUG_GUID_PDB"));
-      LNK_Symbol *guid_rdi_symbol = lnk_symbol_table_search(symtab, str8_lit("RAD_LINK_PE_DEBUG_GUID_RDI"));
-
-      if (guid_pdb_symbol || guid_rdi_symbol) {
-        switch (config->guid_type) {
-        case LNK_DebugInfoGuid_Null: break;
-        case Lnk_DebugInfoGuid_ImageBlake3: {
-          ProfBegin("Hash Image With Blake3");
-          U128 hash = lnk_blake3_hash_parallel(tp, 128, image_data);
-          MemoryCopy(&config->guid, hash.u8, sizeof(hash.u8));
-          ProfEnd();
-        } break;
-        }
-      }
-
-      if (guid_pdb_symbol) {
-        U64   cv_guid_foff = lnk_foff_from_symbol(image_section_table, guid_pdb_symbol);
-        Guid *cv_guid  = str8_deserial_get_raw_ptr(image_data, cv_guid_foff, sizeof(*cv_guid));
-        *cv_guid = config->guid;
-      }
-
-      if (guid_rdi_symbol) {
-        U64   cv_guid_foff = lnk_foff_from_symbol(image_section_table, guid_rdi_symbol);
-        Guid *cv_guid  = str8_deserial_get_raw_ptr(image_data, cv_guid_foff, sizeof(*cv_guid));
-        *cv_guid = config->guid;
-      }
-    }
+    lnk_patch_image_guid(tp, config, symtab, image_data, image_section_table);
     
     ProfEnd();
   }
@@ -4967,6 +6115,7 @@ lnk_build_image(TP_Arena *arena, TP_Context *tp, LNK_Config *config, LNK_SymbolT
   LNK_ImageContext image_ctx = {0};
   image_ctx.image_data       = image_data;
   image_ctx.sectab           = sectab;
+  image_ctx.order_stats      = order_stats;
 
   lnk_timer_end(LNK_Timer_Image);
   ProfEnd(); // :EndImage
@@ -5193,95 +6342,1621 @@ lnk_build_rad_map(Arena *arena, String8 image_data, LNK_Config *config, U64 objs
   return map;
 }
 
-internal void
-lnk_write_thread(void *raw_ctx)
+// --- Incremental -------------------------------------------------------------
+
+internal B32
+lnk_inc_can_grow_section(String8 sect_name, COFF_SectionFlags flags)
+{
+  // gaps are fine in code and plain data, but not in tables (imports, exceptions, CRT initializers, etc.)
+  B32 can_grow = !!(flags & COFF_SectionFlag_CntCode) ||
+                 str8_match(sect_name, str8_lit(".rdata"), 0) ||
+                 str8_match(sect_name, str8_lit(".data"),  0) ||
+                 str8_match(sect_name, str8_lit(".xdata"), 0) ||
+                 str8_match(sect_name, str8_lit(".bss"),   0);
+  return can_grow;
+}
+
+internal U64
+lnk_inc_reserve_from_size(U64 size)
+{
+  U64 reserve = Clamp(LNK_INCREMENTAL_RESERVE_MIN, size / 4, LNK_INCREMENTAL_RESERVE_MAX);
+  return AlignPow2(reserve, 16);
+}
+
+internal LNK_IncObjKind
+lnk_inc_obj_kind_from_obj(LNK_Obj *obj)
+{
+  // linker-made objs are the ones excluded from debug info
+  if (obj->exclude_from_debug_info)                     { return LNK_IncObj_Fixed;  }
+  if (obj->link_member == 0)                            { return LNK_IncObj_File;   }
+  if (obj->link_member->lib->type == COFF_Archive_Thin) { return LNK_IncObj_Fixed;  }
+  return LNK_IncObj_Member;
+}
+
+internal B32
+lnk_inc_is_symbol_resolved_by_name(COFF_ParsedSymbol symbol)
+{
+  B32 is_resolved_by_name = symbol.storage_class == COFF_SymStorageClass_External     ||
+                            symbol.storage_class == COFF_SymStorageClass_WeakExternal ||
+                            (symbol.storage_class == COFF_SymStorageClass_Section && symbol.section_number == COFF_Symbol_UndefinedSection);
+  return is_resolved_by_name;
+}
+
+internal B32
+lnk_inc_is_symbol_defined_by_name(LNK_Obj *obj, COFF_ParsedSymbol symbol)
+{
+  B32 is_defined = symbol.storage_class == COFF_SymStorageClass_External &&
+                   coff_interp_from_parsed_symbol(symbol) == COFF_SymbolValueInterp_Regular &&
+                   symbol.section_number >= 1 && symbol.section_number <= obj->header.section_count_no_null;
+  return is_defined;
+}
+
+internal U128
+lnk_inc_directives_hash_from_obj(LNK_Obj *obj)
+{
+  Temp scratch = scratch_begin(0,0);
+  String8List raw_directives = lnk_raw_directives_from_obj(scratch.arena, obj);
+  String8     directives     = str8_list_join(scratch.arena, &raw_directives, 0);
+  U128        hash           = u128_hash_from_str8(directives);
+  scratch_end(scratch);
+  return hash;
+}
+
+internal LNK_IncObjCapture *
+lnk_inc_capture_objs(Arena *arena, U64 objs_count, LNK_Obj **objs)
 {
   ProfBeginFunction();
-  LNK_WriteThreadContext *ctx = raw_ctx;
-  lnk_write_data_to_file_path(ctx->path, ctx->temp_path, ctx->data);
+  LNK_IncObjCapture *captures = push_array(arena, LNK_IncObjCapture, objs_count);
+  for EachIndex(obj_idx, objs_count) {
+    LNK_Obj            *obj           = objs[obj_idx];
+    LNK_IncObjCapture  *capture       = &captures[obj_idx];
+    COFF_SectionHeader *section_table = lnk_coff_section_table_from_obj(obj);
+
+    capture->directives_hash = lnk_inc_directives_hash_from_obj(obj);
+
+    capture->section_sizes = push_array(arena, U32, obj->header.section_count_no_null);
+    for EachIndex(sect_idx, obj->header.section_count_no_null) {
+      capture->section_sizes[sect_idx] = section_table[sect_idx].fsize;
+    }
+
+    capture->symbol_flags = push_array(arena, LNK_IncCaptureFlags, obj->header.symbol_count);
+    COFF_ParsedSymbol symbol;
+    for (U64 symbol_idx = 0; symbol_idx < obj->header.symbol_count; symbol_idx += (1 + symbol.aux_symbol_count)) {
+      symbol = lnk_parsed_symbol_from_coff_symbol_idx(obj, symbol_idx);
+      if (lnk_inc_is_symbol_resolved_by_name(symbol)) {
+        capture->symbol_flags[symbol_idx] |= LNK_IncCaptureFlag_ResolvedByName;
+      }
+      if (lnk_inc_is_symbol_defined_by_name(obj, symbol)) {
+        capture->symbol_flags[symbol_idx] |= LNK_IncCaptureFlag_DefinedByName;
+      }
+    }
+  }
   ProfEnd();
+  return captures;
 }
 
-internal void
-lnk_log_timers(void)
+internal U32
+lnk_inc_secnum_from_voff(U64 image_section_count, COFF_SectionHeader **image_section_table, U64 voff)
 {
-  Temp scratch = scratch_begin(0, 0);
-  
-  U64 total_build_time_micro = 0;
-  for (U64 i = 0; i < LNK_Timer_Count; ++i) {
-    total_build_time_micro += g_timers[i].end - g_timers[i].begin;
-  }
-  
-  String8List output_list = {0};
-  str8_list_pushf(scratch.arena, &output_list, "------ Link Times --------------------------------------------------------------");
-  for (U64 i = 0; i < LNK_Timer_Count; ++i) {
-    U64 build_time_micro = g_timers[i].end - g_timers[i].begin;
-    if (build_time_micro != 0) {
-      String8  timer_name = lnk_string_from_timer_type(i);
-      DateTime time       = date_time_from_micro_seconds(build_time_micro);
-      String8  time_str   = string_from_elapsed_time(scratch.arena, time);
-      str8_list_pushf(scratch.arena, &output_list, "  %-5S Time: %S", timer_name, time_str);
+  for (U64 secnum = 1; secnum <= image_section_count; secnum += 1) {
+    COFF_SectionHeader *image_section = image_section_table[secnum];
+    if (image_section->voff <= voff && voff < (U64)image_section->voff + image_section->vsize) {
+      return secnum;
     }
   }
-  
-  DateTime total_time = date_time_from_micro_seconds(total_build_time_micro);
-  String8 total_time_str = string_from_elapsed_time(scratch.arena, total_time);
-  str8_list_pushf(scratch.arena, &output_list, "  Total Time: %S", total_time_str);
-  
-  StringJoin new_line_join = { str8_lit_comp(""), str8_lit_comp("\n"), str8_lit_comp("") };
-  String8 output = str8_list_join(scratch.arena, &output_list, &new_line_join);
-  lnk_log(LNK_Log_Timers, "%S\n", output);
-  
-  scratch_end(scratch);
+  return 0;
 }
 
-internal void
-lnk_run(TP_Context *tp, TP_Arena *arena, LNK_Config *config)
+internal U32
+lnk_inc_foff_from_voff(COFF_SectionHeader *image_section, U64 voff)
+{
+  U32 foff = 0;
+  if (~image_section->flags & COFF_SectionFlag_CntUninitializedData && image_section->fsize > 0) {
+    foff = image_section->foff + (voff - image_section->voff);
+  }
+  return foff;
+}
+
+internal U64
+lnk_inc_voff_from_symbol(COFF_SectionHeader **image_section_table, LNK_IncSymbol *symbol)
+{
+  return (U64)image_section_table[symbol->secnum]->voff + symbol->value;
+}
+
+internal LNK_IncState *
+lnk_inc_state_from_image(Arena *arena, LNK_Config *config, String8 image_data, U64 objs_count, LNK_Obj **objs, LNK_IncObjCapture *captures, U64 libs_count, LNK_Lib **libs)
 {
   ProfBeginFunction();
+  Temp scratch = scratch_begin(&arena, 1);
 
-  Temp scratch = scratch_begin(arena->v, arena->count);
+  PE_BinInfo           pe                  = pe_bin_info_from_data(scratch.arena, image_data);
+  COFF_SectionHeader **image_section_table = coff_section_table_from_data(scratch.arena, image_data, pe.section_table_range);
 
-  if (lnk_get_log_status(LNK_Log_Debug)) {
-    String8 full_cmd_line = str8_list_join(scratch.arena, &config->raw_cmd_line, &(StringJoin){ .sep = str8_lit_comp(" ") });
-    lnk_fprintf(stderr, "--------------------------------------------------------------------------------\n");
-    lnk_fprintf(stderr, "Command Line: %.*s\n", str8_varg(full_cmd_line));
-    lnk_fprintf(stderr, "Work Dir    : %.*s\n", str8_varg(config->work_dir));
-    lnk_fprintf(stderr, "--------------------------------------------------------------------------------\n");
+  LNK_IncState *state = push_array(arena, LNK_IncState, 1);
+  state->cmd_line_hash = config->cmd_line_hash;
+
+  // inputs which are never patched, any change to them requires a full link
+  {
+    String8List input_paths = {0};
+    for EachIndex(lib_idx, libs_count) { str8_list_push(scratch.arena, &input_paths, libs[lib_idx]->path); }
+    for EachNode(path_n, String8Node, config->input_list[LNK_Input_Res].first)      { str8_list_push(scratch.arena, &input_paths, path_n->string); }
+    for EachNode(path_n, String8Node, config->input_list[LNK_Input_Manifest].first) { str8_list_push(scratch.arena, &input_paths, path_n->string); }
+
+    state->inputs_count = input_paths.node_count;
+    state->inputs       = push_array(arena, LNK_IncInput, state->inputs_count);
+    U64 input_idx = 0;
+    for EachNode(path_n, String8Node, input_paths.first) {
+      FileProperties props = properties_from_file_path(path_n->string);
+      LNK_IncInput  *input = &state->inputs[input_idx++];
+      input->path     = push_str8_copy(arena, path_n->string);
+      input->size     = props.size;
+      input->modified = props.modified;
+    }
   }
 
-  //
-  // Input Context
-  //
-  LNK_Inputer *inputer = lnk_inputer_init();
+  state->objs_count = objs_count;
+  state->objs       = push_array(arena, LNK_IncObj, objs_count);
+  for EachIndex(obj_idx, objs_count) {
+    LNK_Obj            *obj           = objs[obj_idx];
+    LNK_IncObjCapture  *capture       = &captures[obj_idx];
+    LNK_IncObj         *inc_obj       = &state->objs[obj_idx];
+    COFF_SectionHeader *section_table = lnk_coff_section_table_from_obj(obj);
+    String8             string_table  = lnk_coff_string_table_from_obj(obj);
+
+    inc_obj->kind            = lnk_inc_obj_kind_from_obj(obj);
+    inc_obj->directives_hash = capture->directives_hash;
+    if (inc_obj->kind == LNK_IncObj_Member) {
+      inc_obj->path       = push_str8_copy(arena, obj->link_member->lib->path);
+      inc_obj->member_off = obj->link_member->lib->member_offsets[obj->link_member->member_idx];
+    } else {
+      inc_obj->path = push_str8_copy(arena, obj->path);
+    }
+    if (inc_obj->kind == LNK_IncObj_File) {
+      FileProperties props = properties_from_file_path(obj->path);
+      inc_obj->size     = props.size;
+      inc_obj->modified = props.modified;
+    }
+
+    // sections headers are patched with image locations at this point
+    inc_obj->sections_count = obj->header.section_count_no_null;
+    inc_obj->sections       = push_array(arena, LNK_IncSection, inc_obj->sections_count);
+    for EachIndex(sect_idx, inc_obj->sections_count) {
+      COFF_SectionHeader *section_header = &section_table[sect_idx];
+      LNK_IncSection     *inc_sect       = &inc_obj->sections[sect_idx];
+      inc_sect->flags = section_header->flags & ~COFF_SectionFlag_LnkRemove;
+      inc_sect->size  = capture->section_sizes[sect_idx];
+
+      B32 is_in_image = !(section_header->flags & (COFF_SectionFlag_LnkRemove|COFF_SectionFlag_LnkInfo)) && section_header->vsize > 0;
+      if (is_in_image) {
+        inc_sect->secnum = lnk_inc_secnum_from_voff(pe.section_count, image_section_table, section_header->voff);
+        inc_sect->voff   = section_header->voff;
+        inc_sect->foff   = lnk_inc_foff_from_voff(image_section_table[inc_sect->secnum], section_header->voff);
+        inc_sect->cap    = inc_sect->size;
+        if (inc_obj->kind == LNK_IncObj_File) {
+          String8 sect_name = coff_name_from_section_header(string_table, section_header);
+          if (lnk_inc_can_grow_section(sect_name, section_header->flags)) {
+            inc_sect->cap += lnk_inc_reserve_from_size(inc_sect->size);
+          }
+        }
+      }
+    }
+
+    // symbols are patched with image locations at this point
+    COFF_ParsedSymbol symbol;
+    for (U64 symbol_idx = 0; symbol_idx < obj->header.symbol_count; symbol_idx += (1 + symbol.aux_symbol_count)) {
+      symbol = lnk_parsed_symbol_from_coff_symbol_idx(obj, symbol_idx);
+      if (capture->symbol_flags[symbol_idx] & LNK_IncCaptureFlag_ResolvedByName) {
+        inc_obj->symbols_count += 1;
+      }
+    }
+    inc_obj->symbols = push_array(arena, LNK_IncSymbol, inc_obj->symbols_count);
+    for (U64 symbol_idx = 0, inc_symbol_idx = 0; symbol_idx < obj->header.symbol_count; symbol_idx += (1 + symbol.aux_symbol_count)) {
+      symbol = lnk_parsed_symbol_from_coff_symbol_idx(obj, symbol_idx);
+      if (~capture->symbol_flags[symbol_idx] & LNK_IncCaptureFlag_ResolvedByName) { continue; }
+
+      LNK_IncSymbol *inc_symbol = &inc_obj->symbols[inc_symbol_idx++];
+      inc_symbol->name = push_str8_copy(arena, symbol.name);
+
+      COFF_SymbolValueInterpType interp = coff_interp_from_parsed_symbol(symbol);
+      if (symbol.section_number == lnk_obj_get_removed_section_number(obj)) {
+        inc_symbol->kind = LNK_IncSymbol_Removed;
+      } else if (interp == COFF_SymbolValueInterp_Regular) {
+        inc_symbol->kind   = LNK_IncSymbol_Regular;
+        inc_symbol->secnum = symbol.section_number;
+        inc_symbol->value  = symbol.value;
+
+        // is symbol defined by this obj, rather than a COMDAT leader from another obj?
+        if (capture->symbol_flags[symbol_idx] & LNK_IncCaptureFlag_DefinedByName) {
+          U64 voff = lnk_inc_voff_from_symbol(image_section_table, inc_symbol);
+          for EachIndex(sect_idx, inc_obj->sections_count) {
+            LNK_IncSection *inc_sect = &inc_obj->sections[sect_idx];
+            if (inc_sect->secnum && inc_sect->voff <= voff && voff <= (U64)inc_sect->voff + inc_sect->size) {
+              inc_symbol->flags |= LNK_IncSymbolFlag_Defined;
+              break;
+            }
+          }
+        }
+      } else if (interp == COFF_SymbolValueInterp_Abs) {
+        inc_symbol->kind  = LNK_IncSymbol_Abs;
+        inc_symbol->value = symbol.value;
+      } else {
+        inc_symbol->kind = LNK_IncSymbol_Unresolved;
+      }
+    }
+  }
+
+  scratch_end(scratch);
+  ProfEnd();
+  return state;
+}
+
+internal String8List
+lnk_inc_data_from_state(Arena *arena, LNK_IncState *state)
+{
+  ProfBeginFunction();
+  String8List srl = {0};
+  str8_serial_begin(arena, &srl);
+  str8_serial_push_cstr(arena, &srl, str8_lit(LNK_INCREMENTAL_MAGIC));
+  str8_serial_push_u32(arena, &srl, LNK_INCREMENTAL_VERSION);
+  str8_serial_push_struct(arena, &srl, &state->cmd_line_hash);
+  str8_serial_push_u64(arena, &srl, state->image_size);
+  str8_serial_push_u64(arena, &srl, state->image_modified);
+  str8_serial_push_u64(arena, &srl, state->inputs_count);
+  for EachIndex(input_idx, state->inputs_count) {
+    LNK_IncInput *input = &state->inputs[input_idx];
+    str8_serial_push_cstr(arena, &srl, input->path);
+    str8_serial_push_u64(arena, &srl, input->size);
+    str8_serial_push_u64(arena, &srl, input->modified);
+  }
+  str8_serial_push_u64(arena, &srl, state->objs_count);
+  for EachIndex(obj_idx, state->objs_count) {
+    LNK_IncObj *inc_obj = &state->objs[obj_idx];
+    str8_serial_push_u32(arena, &srl, inc_obj->kind);
+    str8_serial_push_cstr(arena, &srl, inc_obj->path);
+    str8_serial_push_u64(arena, &srl, inc_obj->member_off);
+    str8_serial_push_u64(arena, &srl, inc_obj->size);
+    str8_serial_push_u64(arena, &srl, inc_obj->modified);
+    str8_serial_push_struct(arena, &srl, &inc_obj->directives_hash);
+    str8_serial_push_u32(arena, &srl, inc_obj->sections_count);
+    str8_serial_push_u32(arena, &srl, inc_obj->symbols_count);
+    str8_serial_push_array(arena, &srl, inc_obj->sections, inc_obj->sections_count);
+    for EachIndex(symbol_idx, inc_obj->symbols_count) {
+      LNK_IncSymbol *inc_symbol = &inc_obj->symbols[symbol_idx];
+      str8_serial_push_cstr(arena, &srl, inc_symbol->name);
+      str8_serial_push_u32(arena, &srl, inc_symbol->flags & ~LNK_IncSymbolFlag_Final);
+      str8_serial_push_u32(arena, &srl, inc_symbol->kind);
+      str8_serial_push_u32(arena, &srl, inc_symbol->secnum);
+      str8_serial_push_u32(arena, &srl, inc_symbol->value);
+    }
+  }
+  ProfEnd();
+  return srl;
+}
+
+internal U64
+lnk_inc_read(String8 data, U64 *cursor, void *dst, U64 size, B32 *is_ok)
+{
+  U64 read_size = str8_deserial_read(data, *cursor, dst, size, 1);
+  *is_ok  &= read_size == size;
+  *cursor += read_size;
+  return read_size;
+}
+
+internal String8
+lnk_inc_read_cstr(String8 data, U64 *cursor, B32 *is_ok)
+{
+  String8 cstr      = {0};
+  U64     read_size = str8_deserial_read_cstr(data, *cursor, &cstr);
+  *is_ok  &= read_size > 0;
+  *cursor += read_size;
+  return cstr;
+}
+
+internal LNK_IncState *
+lnk_inc_state_from_data(Arena *arena, String8 data)
+{
+  ProfBeginFunction();
+  Temp temp = temp_begin(arena);
+
+  B32 is_ok  = 1;
+  U64 cursor = 0;
+
+  String8 magic   = lnk_inc_read_cstr(data, &cursor, &is_ok);
+  U32     version = 0;
+  lnk_inc_read(data, &cursor, &version, sizeof(version), &is_ok);
+  is_ok = is_ok && str8_match(magic, str8_lit(LNK_INCREMENTAL_MAGIC), 0) && version == LNK_INCREMENTAL_VERSION;
+
+  LNK_IncState *state = push_array(arena, LNK_IncState, 1);
+  if (is_ok) {
+    lnk_inc_read(data, &cursor, &state->cmd_line_hash,  sizeof(state->cmd_line_hash),  &is_ok);
+    lnk_inc_read(data, &cursor, &state->image_size,     sizeof(state->image_size),     &is_ok);
+    lnk_inc_read(data, &cursor, &state->image_modified, sizeof(state->image_modified), &is_ok);
+    lnk_inc_read(data, &cursor, &state->inputs_count,   sizeof(state->inputs_count),   &is_ok);
+  }
+
+  // every input takes at least one byte, which bounds counts in corrupted files
+  is_ok = is_ok && state->inputs_count <= data.size;
+  if (is_ok) {
+    state->inputs = push_array(arena, LNK_IncInput, state->inputs_count);
+    for (U64 input_idx = 0; is_ok && input_idx < state->inputs_count; input_idx += 1) {
+      LNK_IncInput *input = &state->inputs[input_idx];
+      input->path = lnk_inc_read_cstr(data, &cursor, &is_ok);
+      lnk_inc_read(data, &cursor, &input->size,     sizeof(input->size),     &is_ok);
+      lnk_inc_read(data, &cursor, &input->modified, sizeof(input->modified), &is_ok);
+    }
+    lnk_inc_read(data, &cursor, &state->objs_count, sizeof(state->objs_count), &is_ok);
+  }
+
+  is_ok = is_ok && state->objs_count <= data.size;
+  if (is_ok) {
+    state->objs = push_array(arena, LNK_IncObj, state->objs_count);
+    for (U64 obj_idx = 0; is_ok && obj_idx < state->objs_count; obj_idx += 1) {
+      LNK_IncObj *inc_obj = &state->objs[obj_idx];
+      U32 kind = 0;
+      lnk_inc_read(data, &cursor, &kind, sizeof(kind), &is_ok);
+      inc_obj->kind = kind;
+      inc_obj->path = lnk_inc_read_cstr(data, &cursor, &is_ok);
+      lnk_inc_read(data, &cursor, &inc_obj->member_off,      sizeof(inc_obj->member_off),      &is_ok);
+      lnk_inc_read(data, &cursor, &inc_obj->size,            sizeof(inc_obj->size),            &is_ok);
+      lnk_inc_read(data, &cursor, &inc_obj->modified,        sizeof(inc_obj->modified),        &is_ok);
+      lnk_inc_read(data, &cursor, &inc_obj->directives_hash, sizeof(inc_obj->directives_hash), &is_ok);
+      lnk_inc_read(data, &cursor, &inc_obj->sections_count,  sizeof(inc_obj->sections_count),  &is_ok);
+      lnk_inc_read(data, &cursor, &inc_obj->symbols_count,   sizeof(inc_obj->symbols_count),   &is_ok);
+
+      is_ok = is_ok && inc_obj->kind <= LNK_IncObj_Fixed;
+      is_ok = is_ok && (U64)inc_obj->sections_count * sizeof(inc_obj->sections[0]) <= data.size - cursor;
+      is_ok = is_ok && inc_obj->symbols_count <= data.size - cursor;
+      if (is_ok) {
+        inc_obj->sections = push_array(arena, LNK_IncSection, inc_obj->sections_count);
+        lnk_inc_read(data, &cursor, inc_obj->sections, sizeof(inc_obj->sections[0]) * inc_obj->sections_count, &is_ok);
+
+        inc_obj->symbols = push_array(arena, LNK_IncSymbol, inc_obj->symbols_count);
+        for (U64 symbol_idx = 0; is_ok && symbol_idx < inc_obj->symbols_count; symbol_idx += 1) {
+          LNK_IncSymbol *inc_symbol = &inc_obj->symbols[symbol_idx];
+          U32 kind = 0;
+          inc_symbol->name = lnk_inc_read_cstr(data, &cursor, &is_ok);
+          lnk_inc_read(data, &cursor, &inc_symbol->flags,  sizeof(inc_symbol->flags),  &is_ok);
+          lnk_inc_read(data, &cursor, &kind,               sizeof(kind),               &is_ok);
+          lnk_inc_read(data, &cursor, &inc_symbol->secnum, sizeof(inc_symbol->secnum), &is_ok);
+          lnk_inc_read(data, &cursor, &inc_symbol->value,  sizeof(inc_symbol->value),  &is_ok);
+          inc_symbol->kind = kind;
+          is_ok = is_ok && inc_symbol->kind <= LNK_IncSymbol_Removed;
+        }
+      }
+    }
+  }
+
+  if (!is_ok) {
+    temp_end(temp);
+    state = 0;
+  }
+
+  ProfEnd();
+  return state;
+}
+
+internal void
+lnk_inc_patch_symbol(LNK_Obj *obj, COFF_ParsedSymbol symbol, U32 section_number, U32 value, COFF_SymStorageClass storage_class)
+{
+  if (obj->header.is_big_obj) {
+    COFF_Symbol32 *symbol32  = symbol.raw_symbol;
+    symbol32->section_number = section_number;
+    symbol32->value          = value;
+    symbol32->storage_class  = storage_class;
+  } else {
+    COFF_Symbol16 *symbol16  = symbol.raw_symbol;
+    symbol16->section_number = (U16)section_number;
+    symbol16->value          = value;
+    symbol16->storage_class  = storage_class;
+  }
+}
+
+internal LNK_Obj *
+lnk_inc_obj_from_data(Arena *arena, COFF_MachineType machine, LNK_IncObj *inc_obj, String8 data)
+{
+  // symbols and section headers are patched in place, so make a copy which is safe to write to
+  LNK_Input input = {0};
+  input.path = inc_obj->path;
+  input.data = push_str8_copy(arena, data);
+  LNK_ObjNode *obj_node = lnk_obj_from_input(arena, machine, &input);
+  return &obj_node->data;
+}
+
+internal String8
+lnk_inc_layout_changed_obj(Arena *arena, LNK_IncPatch *patch, HashTable *names_ht, HashTable *moves_ht, COFF_SectionHeader **image_section_table)
+{
+  Temp scratch = scratch_begin(&arena, 1);
+
+  String8             fail          = {0};
+  LNK_Obj            *obj           = patch->obj;
+  LNK_IncObj         *inc_obj       = patch->inc_obj;
+  COFF_SectionHeader *section_table = lnk_coff_section_table_from_obj(obj);
+  String8             string_table  = lnk_coff_string_table_from_obj(obj);
+
+  if (obj->header.section_count_no_null != inc_obj->sections_count) {
+    fail = push_str8f(arena, "section count changed in %S", obj->path);
+    goto exit;
+  }
+  if (!u128_match(lnk_inc_directives_hash_from_obj(obj), inc_obj->directives_hash)) {
+    fail = push_str8f(arena, "linker directives changed in %S", obj->path);
+    goto exit;
+  }
+
+  // new contents must fit into the space that was laid out for the section
+  for EachIndex(sect_idx, inc_obj->sections_count) {
+    COFF_SectionHeader *section_header = &section_table[sect_idx];
+    LNK_IncSection     *inc_sect       = &inc_obj->sections[sect_idx];
+    String8             sect_name      = coff_name_from_section_header(string_table, section_header);
+    if ((section_header->flags & ~COFF_SectionFlag_LnkRemove) != inc_sect->flags) {
+      fail = push_str8f(arena, "flags changed for section %S (No. %llx) in %S", sect_name, sect_idx+1, obj->path);
+      goto exit;
+    }
+    if (inc_sect->secnum == 0) {
+      if (inc_sect->size == 0 && section_header->fsize > 0 && ~section_header->flags & COFF_SectionFlag_LnkInfo) {
+        fail = push_str8f(arena, "empty section %S (No. %llx) got data in %S", sect_name, sect_idx+1, obj->path);
+        goto exit;
+      }
+    } else {
+      if (section_header->fsize == 0) {
+        fail = push_str8f(arena, "section %S (No. %llx) became empty in %S", sect_name, sect_idx+1, obj->path);
+        goto exit;
+      }
+      if (section_header->fsize > inc_sect->cap) {
+        fail = push_str8f(arena, "section %S (No. %llx) in %S overflows its reserve (size 0x%x, capacity 0x%x)", sect_name, sect_idx+1, obj->path, section_header->fsize, inc_sect->cap);
+        goto exit;
+      }
+      if (section_header->fsize != inc_sect->size && !lnk_inc_can_grow_section(sect_name, section_header->flags)) {
+        fail = push_str8f(arena, "section %S (No. %llx) changed size in %S", sect_name, sect_idx+1, obj->path);
+        goto exit;
+      }
+    }
+  }
+
+  // old symbols by name
+  HashTable *old_symbols_ht      = hash_table_init(scratch.arena, inc_obj->symbols_count);
+  U64        old_defined_count   = 0;
+  for EachIndex(symbol_idx, inc_obj->symbols_count) {
+    LNK_IncSymbol *inc_symbol = &inc_obj->symbols[symbol_idx];
+    if (hash_table_search_string_raw(old_symbols_ht, inc_symbol->name) == 0) {
+      hash_table_push_string_raw(scratch.arena, old_symbols_ht, inc_symbol->name, inc_symbol);
+    }
+    if (inc_symbol->flags & LNK_IncSymbolFlag_Defined) {
+      old_defined_count += 1;
+    }
+  }
+
+  // resolve symbols against the previous link
+  U64 new_defined_count = 0;
+  {
+    COFF_ParsedSymbol symbol;
+    for (U64 symbol_idx = 0; symbol_idx < obj->header.symbol_count; symbol_idx += (1 + symbol.aux_symbol_count)) {
+      symbol = lnk_parsed_symbol_from_coff_symbol_idx(obj, symbol_idx);
+      if (coff_interp_from_parsed_symbol(symbol) == COFF_SymbolValueInterp_Common) {
+        fail = push_str8f(arena, "common symbol %S in %S", symbol.name, obj->path);
+        goto exit;
+      }
+      if (lnk_inc_is_symbol_resolved_by_name(symbol)) {
+        patch->symbols_count += 1;
+      }
+    }
+
+    patch->symbols = push_array(arena, LNK_IncSymbol, patch->symbols_count);
+    for (U64 symbol_idx = 0, inc_symbol_idx = 0; symbol_idx < obj->header.symbol_count; symbol_idx += (1 + symbol.aux_symbol_count)) {
+      symbol = lnk_parsed_symbol_from_coff_symbol_idx(obj, symbol_idx);
+      if (!lnk_inc_is_symbol_resolved_by_name(symbol)) { continue; }
+
+      LNK_IncSymbol *new_symbol = &patch->symbols[inc_symbol_idx++];
+      LNK_IncSymbol *old_symbol = hash_table_search_string_raw(old_symbols_ht, symbol.name);
+
+      B32 is_defined = 0;
+      if (lnk_inc_is_symbol_defined_by_name(obj, symbol)) {
+        is_defined = inc_obj->sections[symbol.section_number-1].secnum != 0;
+      }
+
+      if (is_defined) {
+        if (old_symbol == 0 || ~old_symbol->flags & LNK_IncSymbolFlag_Defined) {
+          fail = push_str8f(arena, "new symbol %S is defined in %S", symbol.name, obj->path);
+          goto exit;
+        }
+
+        LNK_IncSection *inc_sect = &inc_obj->sections[symbol.section_number-1];
+        new_symbol->name   = push_str8_copy(arena, symbol.name);
+        new_symbol->flags  = LNK_IncSymbolFlag_Defined|LNK_IncSymbolFlag_Final;
+        new_symbol->kind   = LNK_IncSymbol_Regular;
+        new_symbol->secnum = inc_sect->secnum;
+        new_symbol->value  = (inc_sect->voff - image_section_table[inc_sect->secnum]->voff) + symbol.value;
+        new_defined_count += 1;
+
+        // track moved symbols, so references in other objs can be relocated
+        U64 old_voff = lnk_inc_voff_from_symbol(image_section_table, old_symbol);
+        U64 new_voff = lnk_inc_voff_from_symbol(image_section_table, new_symbol);
+        if (old_voff != new_voff) {
+          LNK_IncSymbol *move = hash_table_search_u64_raw(moves_ht, old_voff);
+          if (move == 0) {
+            hash_table_push_u64_raw(arena, moves_ht, old_voff, new_symbol);
+          } else if (lnk_inc_voff_from_symbol(image_section_table, move) != new_voff) {
+            fail = push_str8f(arena, "symbols at 0x%llx moved to different locations (%S and %S)", old_voff, move->name, new_symbol->name);
+            goto exit;
+          }
+        }
+      } else {
+        // prefer obj's own resolution to handle COMDAT leaders and weak symbols with same names
+        LNK_IncSymbol *resolved_symbol = old_symbol && ~old_symbol->flags & LNK_IncSymbolFlag_Defined ? old_symbol : hash_table_search_string_raw(names_ht, symbol.name);
+        if (resolved_symbol == 0) {
+          fail = push_str8f(arena, "new reference to %S in %S", symbol.name, obj->path);
+          goto exit;
+        }
+        *new_symbol       = *resolved_symbol;
+        new_symbol->name  = push_str8_copy(arena, symbol.name);
+        new_symbol->flags = 0;
+      }
+    }
+  }
+
+  if (old_defined_count != new_defined_count) {
+    fail = push_str8f(arena, "symbol definitions were removed from %S", obj->path);
+    goto exit;
+  }
+
+  // commit new section sizes
+  for EachIndex(sect_idx, inc_obj->sections_count) {
+    if (inc_obj->sections[sect_idx].secnum) {
+      inc_obj->sections[sect_idx].size = section_table[sect_idx].fsize;
+    }
+  }
+
+  exit:;
+  scratch_end(scratch);
+  return fail;
+}
+
+internal void
+lnk_inc_patch_obj_symbols(LNK_IncPatch *patch, HashTable *moves_ht, COFF_SectionHeader **image_section_table)
+{
+  LNK_Obj    *obj                   = patch->obj;
+  LNK_IncObj *inc_obj               = patch->inc_obj;
+  U32         removed_section_number = lnk_obj_get_removed_section_number(obj);
+
+  COFF_ParsedSymbol symbol;
+  for (U64 symbol_idx = 0, inc_symbol_idx = 0; symbol_idx < obj->header.symbol_count; symbol_idx += (1 + symbol.aux_symbol_count)) {
+    symbol = lnk_parsed_symbol_from_coff_symbol_idx(obj, symbol_idx);
+    COFF_SymbolValueInterpType interp = coff_interp_from_parsed_symbol(symbol);
+
+    if (lnk_inc_is_symbol_resolved_by_name(symbol)) {
+      LNK_IncSymbol *inc_symbol = &patch->symbols[inc_symbol_idx++];
+
+      // follow symbol to its new location
+      if (inc_symbol->kind == LNK_IncSymbol_Regular && ~inc_symbol->flags & LNK_IncSymbolFlag_Final) {
+        LNK_IncSymbol *move = hash_table_search_u64_raw(moves_ht, lnk_inc_voff_from_symbol(image_section_table, inc_symbol));
+        if (move) {
+          inc_symbol->secnum = move->secnum;
+          inc_symbol->value  = move->value;
+        }
+      }
+
+      switch (inc_symbol->kind) {
+      case LNK_IncSymbol_Regular: {
+        COFF_SymStorageClass storage_class = inc_symbol->flags & LNK_IncSymbolFlag_Defined ? symbol.storage_class : COFF_SymStorageClass_Static;
+        lnk_inc_patch_symbol(obj, symbol, inc_symbol->secnum, inc_symbol->value, storage_class);
+      } break;
+      case LNK_IncSymbol_Abs: {
+        lnk_inc_patch_symbol(obj, symbol, COFF_Symbol_AbsSection32, inc_symbol->value, COFF_SymStorageClass_Static);
+      } break;
+      case LNK_IncSymbol_Removed: {
+        lnk_inc_patch_symbol(obj, symbol, removed_section_number, 0, COFF_SymStorageClass_Static);
+      } break;
+      case LNK_IncSymbol_Unresolved: {
+        // left as is, same as in the full link
+      } break;
+      }
+    } else if (interp == COFF_SymbolValueInterp_Regular && symbol.section_number >= 1 && symbol.section_number <= inc_obj->sections_count) {
+      LNK_IncSection *inc_sect = &inc_obj->sections[symbol.section_number-1];
+      if (inc_sect->flags & LNK_SECTION_FLAG_DEBUG) {
+        // debug info is relocated in the obj, same as in the full link
+      } else if (inc_sect->secnum) {
+        U32 value = (inc_sect->voff - image_section_table[inc_sect->secnum]->voff) + symbol.value;
+        lnk_inc_patch_symbol(obj, symbol, inc_sect->secnum, value, symbol.storage_class);
+      } else {
+        lnk_inc_patch_symbol(obj, symbol, removed_section_number, max_U32, symbol.storage_class);
+      }
+    }
+  }
+}
+
+internal String8
+lnk_inc_match_objs(Arena *arena, LNK_IncState *state, U64 objs_count, LNK_Obj **objs)
+{
+  if (objs_count != state->objs_count) {
+    return push_str8f(arena, "link has %llu objs, previous link had %llu", objs_count, state->objs_count);
+  }
+  for EachIndex(obj_idx, objs_count) {
+    LNK_Obj    *obj     = objs[obj_idx];
+    LNK_IncObj *inc_obj = &state->objs[obj_idx];
+
+    LNK_IncObjKind kind = lnk_inc_obj_kind_from_obj(obj);
+    String8        path = kind == LNK_IncObj_Member ? obj->link_member->lib->path : obj->path;
+    if (kind != inc_obj->kind || !str8_match(path, inc_obj->path, 0) || obj->header.section_count_no_null != inc_obj->sections_count) {
+      return push_str8f(arena, "%S doesn't match previous link", obj->path);
+    }
+
+    U64 symbols_count = 0;
+    COFF_ParsedSymbol symbol;
+    for (U64 symbol_idx = 0; symbol_idx < obj->header.symbol_count; symbol_idx += (1 + symbol.aux_symbol_count)) {
+      symbol = lnk_parsed_symbol_from_coff_symbol_idx(obj, symbol_idx);
+      symbols_count += lnk_inc_is_symbol_resolved_by_name(symbol);
+    }
+    if (symbols_count != inc_obj->symbols_count) {
+      return push_str8f(arena, "symbols of %S don't match previous link", obj->path);
+    }
+  }
+  return str8_zero();
+}
+
+internal void
+lnk_inc_move_obj_to_image(LNK_IncPatch *patch, HashTable *moves_ht, COFF_SectionHeader **image_section_table)
+{
+  LNK_Obj            *obj           = patch->obj;
+  LNK_IncObj         *inc_obj       = patch->inc_obj;
+  COFF_SectionHeader *section_table = lnk_coff_section_table_from_obj(obj);
+
+  // section headers get image locations, like the full link patches them
+  for EachIndex(sect_idx, inc_obj->sections_count) {
+    COFF_SectionHeader *section_header = &section_table[sect_idx];
+    LNK_IncSection     *inc_sect       = &inc_obj->sections[sect_idx];
+    if (section_header->flags & COFF_SectionFlag_LnkRemove) { continue; }
+    if (inc_sect->secnum) {
+      section_header->voff  = inc_sect->voff;
+      section_header->vsize = inc_sect->size;
+      if (~image_section_table[inc_sect->secnum]->flags & COFF_SectionFlag_CntUninitializedData) {
+        section_header->foff  = inc_sect->foff;
+        section_header->fsize = inc_sect->size;
+      }
+    } else {
+      // not in the image, debug sections keep their obj data
+      section_header->vsize = 0;
+      if (~section_header->flags & LNK_SECTION_FLAG_DEBUG) {
+        section_header->fsize = 0;
+      }
+    }
+  }
+
+  lnk_inc_patch_obj_symbols(patch, moves_ht, image_section_table);
+}
+
+internal int
+lnk_inc_base_reloc_is_before(void *raw_a, void *raw_b)
+{
+  return u64_compar_is_before(raw_a, raw_b);
+}
+
+internal U64
+lnk_inc_base_reloc_from_voff(U64 voff, U64 kind)
+{
+  return (voff << 4) | kind;
+}
+
+internal String8
+lnk_inc_check_base_relocs(Arena *arena, LNK_IncPatch *patch, U64 image_base_relocs_count, U64 *image_base_relocs)
+{
+  Temp scratch = scratch_begin(&arena, 1);
+
+  String8             fail          = {0};
+  LNK_Obj            *obj           = patch->obj;
+  LNK_IncObj         *inc_obj       = patch->inc_obj;
+  COFF_SectionHeader *section_table = lnk_coff_section_table_from_obj(obj);
+
+  for EachIndex(sect_idx, inc_obj->sections_count) {
+    LNK_IncSection     *inc_sect       = &inc_obj->sections[sect_idx];
+    COFF_SectionHeader *section_header = &section_table[sect_idx];
+    if (inc_sect->secnum == 0) { continue; }
+
+    // base relocs the section needs now
+    COFF_RelocArray relocs          = lnk_coff_relocs_from_section_header(obj, section_header);
+    U64             new_relocs_count = 0;
+    U64            *new_relocs       = push_array(scratch.arena, U64, relocs.count);
+    for EachIndex(reloc_idx, relocs.count) {
+      COFF_Reloc       *reloc  = &relocs.v[reloc_idx];
+      COFF_ParsedSymbol symbol = lnk_parsed_symbol_from_coff_symbol_idx(obj, reloc->isymbol);
+      if (coff_interp_from_parsed_symbol(symbol) == COFF_SymbolValueInterp_Abs) { continue; }
+      U64 is_addr = coff_is_addr_reloc(obj->header.machine, reloc->type);
+      if (is_addr) {
+        U64 kind = is_addr == 8 ? PE_BaseRelocKind_DIR64 : PE_BaseRelocKind_HIGHLOW;
+        new_relocs[new_relocs_count++] = lnk_inc_base_reloc_from_voff(inc_sect->voff + reloc->apply_off, kind);
+      }
+    }
+    radsort(new_relocs, new_relocs_count, lnk_inc_base_reloc_is_before);
+
+    // base relocs the image has for the section
+    U64 lo = lnk_inc_base_reloc_from_voff(inc_sect->voff, 0);
+    U64 hi = lnk_inc_base_reloc_from_voff((U64)inc_sect->voff + inc_sect->cap, 0);
+    U64 first = 0, opl = image_base_relocs_count;
+    while (first < opl) {
+      U64 mid = first + (opl - first) / 2;
+      if (image_base_relocs[mid] < lo) { first = mid + 1; } else { opl = mid; }
+    }
+    U64 image_relocs_count = 0;
+    while (first + image_relocs_count < image_base_relocs_count && image_base_relocs[first + image_relocs_count] < hi) {
+      image_relocs_count += 1;
+    }
+
+    B32 is_match = image_relocs_count == new_relocs_count && MemoryMatch(new_relocs, image_base_relocs + first, new_relocs_count * sizeof(new_relocs[0]));
+    if (!is_match) {
+      String8 sect_name = coff_name_from_section_header(lnk_coff_string_table_from_obj(obj), section_header);
+      fail = push_str8f(arena, "base relocations changed in section %S (No. %llx) in %S", sect_name, sect_idx+1, obj->path);
+      break;
+    }
+  }
+
+  scratch_end(scratch);
+  return fail;
+}
+
+internal String8
+lnk_inc_patch_image(Arena *arena, String8 image_data, COFF_MachineType machine, LNK_IncPatch *patch)
+{
+  String8             fail          = {0};
+  LNK_Obj            *obj           = patch->obj;
+  LNK_IncObj         *inc_obj       = patch->inc_obj;
+  COFF_SectionHeader *section_table = lnk_coff_section_table_from_obj(obj);
+  String8             string_table  = lnk_coff_string_table_from_obj(obj);
+
+  for EachIndex(sect_idx, inc_obj->sections_count) {
+    COFF_SectionHeader *section_header = &section_table[sect_idx];
+    LNK_IncSection     *inc_sect       = &inc_obj->sections[sect_idx];
+
+    if (inc_sect->secnum == 0) {
+      section_header->flags |= COFF_SectionFlag_LnkRemove;
+      continue;
+    }
+
+    // entries of unchanged objs are already sorted into .pdata
+    if (!patch->is_changed) {
+      String8 sect_name = coff_name_from_section_header(string_table, section_header);
+      if (str8_match(sect_name, str8_lit(".pdata"), 0)) {
+        section_header->flags |= COFF_SectionFlag_LnkRemove;
+        continue;
+      }
+    }
+
+    if (section_header->fsize != inc_sect->size) {
+      fail = push_str8f(arena, "size of section (No. %llx) in %S doesn't match previous link", sect_idx+1, obj->path);
+      break;
+    }
+
+    // copy section bytes and fill reserve
+    if (inc_sect->foff) {
+      String8 dst = str8_substr(image_data, rng_1u64(inc_sect->foff, (U64)inc_sect->foff + inc_sect->cap));
+      if (dst.size != inc_sect->cap) {
+        fail = push_str8f(arena, "section (No. %llx) in %S is out of image bounds", sect_idx+1, obj->path);
+        break;
+      }
+      U8 fill_byte = section_header->flags & COFF_SectionFlag_CntCode ? coff_code_align_byte_from_machine(machine) : 0;
+      if (section_header->flags & COFF_SectionFlag_CntUninitializedData) {
+        MemorySet(dst.str, 0, dst.size);
+      } else {
+        String8 src = str8_substr(obj->data, rng_1u64(section_header->foff, section_header->foff + section_header->fsize));
+        MemoryCopy(dst.str, src.str, src.size);
+        MemorySet(dst.str + src.size, fill_byte, dst.size - src.size);
+      }
+    }
+
+    // point section header at the image
+    section_header->voff  = inc_sect->voff;
+    section_header->vsize = inc_sect->size;
+    section_header->foff  = inc_sect->foff;
+  }
+
+  return fail;
+}
+
+internal B32
+lnk_inc_try_link(TP_Context *tp, TP_Arena *arena, LNK_Config *config, LNK_Inputer *inputer, LNK_SymbolTable *symtab, LNK_LinkResult **link_out)
+{
+  ProfBeginFunction();
+  lnk_timer_begin(LNK_Timer_Image);
+  Temp scratch = scratch_begin(arena->v, arena->count);
+
+  B32     is_linked = 0;
+  String8 fail      = {0};
+
+  if (config->rad_chunk_map == LNK_SwitchState_Yes) {
+    fail = str8_lit("/RAD_MAP needs a full link");
+    goto exit;
+  }
+
+  //
+  // load state of the previous link and check that it matches
+  //
+  String8       state_data = lnk_read_data_from_file_path(scratch.arena, config->io_flags, config->incremental_name);
+  LNK_IncState *state      = lnk_inc_state_from_data(scratch.arena, state_data);
+  if (state == 0) {
+    fail = push_str8f(scratch.arena, "unable to load state from %S", config->incremental_name);
+    goto exit;
+  }
+  if (!u128_match(state->cmd_line_hash, config->cmd_line_hash)) {
+    fail = str8_lit("command line changed");
+    goto exit;
+  }
+  {
+    FileProperties props = properties_from_file_path(config->out_path);
+    if (props.size != state->image_size || props.modified != state->image_modified) {
+      fail = push_str8f(scratch.arena, "%S changed since the last link", config->out_path);
+      goto exit;
+    }
+  }
+  for EachIndex(input_idx, state->inputs_count) {
+    LNK_IncInput  *input = &state->inputs[input_idx];
+    FileProperties props = properties_from_file_path(input->path);
+    if (props.size != input->size || props.modified != input->modified) {
+      fail = push_str8f(scratch.arena, "%S changed", input->path);
+      goto exit;
+    }
+  }
+
+  //
+  // find changed objs
+  //
+  U64           patches_count = 0;
+  LNK_IncPatch *patches       = push_array(scratch.arena, LNK_IncPatch, state->objs_count);
+  B8           *is_patched    = push_array(scratch.arena, B8, state->objs_count);
+  for EachIndex(obj_idx, state->objs_count) {
+    LNK_IncObj *inc_obj = &state->objs[obj_idx];
+    if (inc_obj->kind == LNK_IncObj_File) {
+      FileProperties props = properties_from_file_path(inc_obj->path);
+      if (props.size != inc_obj->size || props.modified != inc_obj->modified) {
+        LNK_IncPatch *patch = &patches[patches_count++];
+        patch->inc_obj    = inc_obj;
+        patch->is_changed = 1;
+        is_patched[obj_idx] = 1;
+        inc_obj->size     = props.size;
+        inc_obj->modified = props.modified;
+      }
+    }
+  }
+  U64 changed_count = patches_count;
+
+  if (changed_count == 0) {
+    lnk_log(LNK_Log_Incremental, "Incremental: %S is up to date", config->out_path);
+    is_linked = 1;
+    goto exit;
+  }
+
+  //
+  // load image
+  //
+  String8 image_data = push_str8_copy(scratch.arena, lnk_read_data_from_file_path(scratch.arena, config->io_flags, config->out_path));
+  if (image_data.size != state->image_size) {
+    fail = push_str8f(scratch.arena, "unable to read %S", config->out_path);
+    goto exit;
+  }
+  PE_BinInfo           pe                  = pe_bin_info_from_data(scratch.arena, image_data);
+  COFF_SectionHeader **image_section_table = coff_section_table_from_data(scratch.arena, image_data, pe.section_table_range);
+  COFF_MachineType     machine             = coff_machine_from_arch(pe.arch);
+  if (pe.data_dir_count < PE_DataDirectoryIndex_COUNT) {
+    fail = push_str8f(scratch.arena, "%S has too few data directories", config->out_path);
+    goto exit;
+  }
+
+  // external symbols by name
+  HashTable *names_ht = hash_table_init(scratch.arena, 0x4000);
+  for EachIndex(obj_idx, state->objs_count) {
+    LNK_IncObj *inc_obj = &state->objs[obj_idx];
+    for EachIndex(symbol_idx, inc_obj->symbols_count) {
+      LNK_IncSymbol *inc_symbol = &inc_obj->symbols[symbol_idx];
+      if (inc_symbol->kind == LNK_IncSymbol_Regular || inc_symbol->kind == LNK_IncSymbol_Abs) {
+        if (inc_symbol->kind == LNK_IncSymbol_Regular && (inc_symbol->secnum == 0 || inc_symbol->secnum > pe.section_count)) {
+          fail = push_str8f(scratch.arena, "%S has invalid section number for %S", config->incremental_name, inc_symbol->name);
+          goto exit;
+        }
+        if (hash_table_search_string_raw(names_ht, inc_symbol->name) == 0) {
+          hash_table_push_string_raw(scratch.arena, names_ht, inc_symbol->name, inc_symbol);
+        }
+      }
+    }
+    for EachIndex(sect_idx, inc_obj->sections_count) {
+      if (inc_obj->sections[sect_idx].secnum > pe.section_count) {
+        fail = push_str8f(scratch.arena, "%S has invalid section number for %S", config->incremental_name, inc_obj->path);
+        goto exit;
+      }
+    }
+  }
+
+  //
+  // lay out changed objs in the space of the previous link
+  //
+  HashTable *moves_ht = hash_table_init(scratch.arena, 0x1000);
+  for EachIndex(patch_idx, changed_count) {
+    LNK_IncPatch *patch    = &patches[patch_idx];
+    String8       obj_data = lnk_read_data_from_file_path(scratch.arena, config->io_flags, patch->inc_obj->path);
+    if (obj_data.size == 0) {
+      fail = push_str8f(scratch.arena, "unable to read %S", patch->inc_obj->path);
+      goto exit;
+    }
+    lnk_log(LNK_Log_Incremental, "Incremental: patching %S", patch->inc_obj->path);
+    patch->obj = lnk_inc_obj_from_data(scratch.arena, machine, patch->inc_obj, obj_data);
+    fail = lnk_inc_layout_changed_obj(scratch.arena, patch, names_ht, moves_ht, image_section_table);
+    if (fail.size) { goto exit; }
+  }
+
+  //
+  // symbols that moved can't be referenced from outside of objs
+  //
+  {
+    U64 tls_voff         = pe.data_dir_vranges[PE_DataDirectoryIndex_TLS].min;
+    U64 load_config_voff = pe.data_dir_vranges[PE_DataDirectoryIndex_LOAD_CONFIG].min;
+    if ((tls_voff && hash_table_search_u64(moves_ht, tls_voff)) || (load_config_voff && hash_table_search_u64(moves_ht, load_config_voff))) {
+      fail = str8_lit("TLS or load config directory moved");
+      goto exit;
+    }
+  }
+
+  //
+  // find unchanged objs that reference moved symbols
+  //
+  if (moves_ht->count) {
+    HashTable *libs_ht = hash_table_init(scratch.arena, 0x100);
+    for EachIndex(obj_idx, state->objs_count) {
+      LNK_IncObj *inc_obj = &state->objs[obj_idx];
+      if (is_patched[obj_idx]) { continue; }
+
+      LNK_IncSymbol *moved_symbol = 0;
+      for EachIndex(symbol_idx, inc_obj->symbols_count) {
+        LNK_IncSymbol *inc_symbol = &inc_obj->symbols[symbol_idx];
+        if (inc_symbol->kind == LNK_IncSymbol_Regular && hash_table_search_u64(moves_ht, lnk_inc_voff_from_symbol(image_section_table, inc_symbol))) {
+          moved_symbol = inc_symbol;
+          break;
+        }
+      }
+      if (moved_symbol == 0) { continue; }
+
+      String8 obj_data = {0};
+      if (inc_obj->kind == LNK_IncObj_File) {
+        obj_data = lnk_read_data_from_file_path(scratch.arena, config->io_flags, inc_obj->path);
+      } else if (inc_obj->kind == LNK_IncObj_Member) {
+        String8 *lib_data = hash_table_search_path_raw(libs_ht, inc_obj->path);
+        if (lib_data == 0) {
+          lib_data  = push_array(scratch.arena, String8, 1);
+          *lib_data = lnk_read_data_from_file_path(scratch.arena, config->io_flags, inc_obj->path);
+          hash_table_push_path_raw(scratch.arena, libs_ht, inc_obj->path, lib_data);
+        }
+        if (inc_obj->member_off < lib_data->size) {
+          obj_data = coff_archive_member_from_offset(*lib_data, inc_obj->member_off).data;
+        }
+      } else {
+        fail = push_str8f(scratch.arena, "moved symbol %S is referenced from %S", moved_symbol->name, inc_obj->path);
+        goto exit;
+      }
+      if (obj_data.size == 0) {
+        fail = push_str8f(scratch.arena, "unable to read %S", inc_obj->path);
+        goto exit;
+      }
+
+      LNK_IncPatch *patch = &patches[patches_count++];
+      patch->inc_obj       = inc_obj;
+      patch->obj           = lnk_inc_obj_from_data(scratch.arena, machine, inc_obj, obj_data);
+      patch->symbols_count = inc_obj->symbols_count;
+      patch->symbols       = inc_obj->symbols;
+      is_patched[obj_idx]  = 1;
+      lnk_log(LNK_Log_Incremental, "Incremental: relocating %S", inc_obj->path);
+
+      if (patch->obj->header.section_count_no_null != inc_obj->sections_count) {
+        fail = push_str8f(scratch.arena, "%S doesn't match previous link", inc_obj->path);
+        goto exit;
+      }
+    }
+  }
+
+  //
+  // patch symbol tables
+  //
+  for EachIndex(patch_idx, patches_count) {
+    LNK_IncPatch *patch = &patches[patch_idx];
+    U64 symbols_count = 0;
+    COFF_ParsedSymbol symbol;
+    for (U64 symbol_idx = 0; symbol_idx < patch->obj->header.symbol_count; symbol_idx += (1 + symbol.aux_symbol_count)) {
+      symbol = lnk_parsed_symbol_from_coff_symbol_idx(patch->obj, symbol_idx);
+      symbols_count += lnk_inc_is_symbol_resolved_by_name(symbol);
+    }
+    if (symbols_count != patch->symbols_count) {
+      fail = push_str8f(scratch.arena, "symbols of %S don't match previous link", patch->inc_obj->path);
+      goto exit;
+    }
+    lnk_inc_patch_obj_symbols(patch, moves_ht, image_section_table);
+  }
+
+  //
+  // changed objs must keep base relocations, because .reloc is not rebuilt
+  //
+  if (~config->flags & LNK_ConfigFlag_Fixed) {
+    Rng1U64               base_relocs_frange = pe.data_dir_franges[PE_DataDirectoryIndex_BASE_RELOC];
+    String8               raw_base_relocs    = str8_substr(image_data, base_relocs_frange);
+    PE_BaseRelocBlockList base_reloc_blocks  = pe_base_reloc_block_list_from_data(scratch.arena, raw_base_relocs);
+
+    U64 image_base_relocs_count = 0;
+    for EachNode(block_n, PE_BaseRelocBlockNode, base_reloc_blocks.first) { image_base_relocs_count += block_n->v.entry_count; }
+    U64 *image_base_relocs = push_array(scratch.arena, U64, image_base_relocs_count);
+    U64  base_reloc_idx    = 0;
+    for EachNode(block_n, PE_BaseRelocBlockNode, base_reloc_blocks.first) {
+      for EachIndex(entry_idx, block_n->v.entry_count) {
+        U16 entry = block_n->v.entries[entry_idx];
+        U16 kind  = entry >> 12;
+        if (kind == PE_BaseRelocKind_ABSOLUTE) { continue; }
+        image_base_relocs[base_reloc_idx++] = lnk_inc_base_reloc_from_voff(block_n->v.page_virt_off + (entry & 0xfff), kind);
+      }
+    }
+    image_base_relocs_count = base_reloc_idx;
+    radsort(image_base_relocs, image_base_relocs_count, lnk_inc_base_reloc_is_before);
+
+    for EachIndex(patch_idx, changed_count) {
+      fail = lnk_inc_check_base_relocs(scratch.arena, &patches[patch_idx], image_base_relocs_count, image_base_relocs);
+      if (fail.size) { goto exit; }
+    }
+  }
+
+  //
+  // replace exception entries of changed functions
+  //
+  Rng1U64 pdata_frange = pe.data_dir_franges[PE_DataDirectoryIndex_EXCEPTIONS];
+  String8 raw_pdata    = str8_substr(image_data, pdata_frange);
+  B32     is_pdata_changed = 0;
+  {
+    U64            pdata_count = raw_pdata.size / sizeof(PE_IntelPdata);
+    PE_IntelPdata *pdata       = (PE_IntelPdata *)raw_pdata.str;
+
+    // drop entries which are in the code of changed objs
+    U64 keep_count = 0;
+    for EachIndex(pdata_idx, pdata_count) {
+      B32 is_dropped = 0;
+      for EachIndex(patch_idx, changed_count) {
+        LNK_IncObj *inc_obj = patches[patch_idx].inc_obj;
+        for EachIndex(sect_idx, inc_obj->sections_count) {
+          LNK_IncSection *inc_sect = &inc_obj->sections[sect_idx];
+          if (inc_sect->secnum && inc_sect->flags & COFF_SectionFlag_CntCode) {
+            if (inc_sect->voff <= pdata[pdata_idx].voff_first && pdata[pdata_idx].voff_first < (U64)inc_sect->voff + inc_sect->cap) {
+              is_dropped = 1;
+              break;
+            }
+          }
+        }
+        if (is_dropped) { break; }
+      }
+      if (!is_dropped) {
+        pdata[keep_count++] = pdata[pdata_idx];
+      }
+    }
+
+    // changed objs put their new entries into the freed slots
+    U64 slot_idx = keep_count;
+    for EachIndex(patch_idx, changed_count) {
+      LNK_Obj            *obj           = patches[patch_idx].obj;
+      LNK_IncObj         *inc_obj       = patches[patch_idx].inc_obj;
+      COFF_SectionHeader *section_table = lnk_coff_section_table_from_obj(obj);
+      String8             string_table  = lnk_coff_string_table_from_obj(obj);
+      for EachIndex(sect_idx, inc_obj->sections_count) {
+        LNK_IncSection *inc_sect  = &inc_obj->sections[sect_idx];
+        String8         sect_name = coff_name_from_section_header(string_table, &section_table[sect_idx]);
+        if (inc_sect->secnum == 0 || !str8_match(sect_name, str8_lit(".pdata"), 0)) { continue; }
+
+        U64 entries_count = inc_sect->size / sizeof(PE_IntelPdata);
+        if (inc_sect->size % sizeof(PE_IntelPdata) != 0 || slot_idx + entries_count > pdata_count) {
+          fail = push_str8f(scratch.arena, "exception entries changed in %S", obj->path);
+          goto exit;
+        }
+        U64 slot_off = slot_idx * sizeof(PE_IntelPdata);
+        inc_sect->voff = pe.data_dir_vranges[PE_DataDirectoryIndex_EXCEPTIONS].min + slot_off;
+        inc_sect->foff = pdata_frange.min + slot_off;
+        slot_idx += entries_count;
+      }
+    }
+    if (slot_idx != pdata_count) {
+      fail = str8_lit("exception entries changed");
+      goto exit;
+    }
+
+    is_pdata_changed = keep_count != pdata_count;
+  }
+
+  //
+  // copy section bytes and relocate
+  //
+  for EachIndex(patch_idx, patches_count) {
+    fail = lnk_inc_patch_image(scratch.arena, image_data, machine, &patches[patch_idx]);
+    if (fail.size) { goto exit; }
+  }
+  {
+    LNK_Obj **patch_objs = push_array(scratch.arena, LNK_Obj *, patches_count);
+    for EachIndex(patch_idx, patches_count) { patch_objs[patch_idx] = patches[patch_idx].obj; }
+    LNK_ObjRelocPatcher task = { .image_data = image_data, .objs = patch_objs, .image_base = pe.image_base, .image_section_table = image_section_table };
+    tp_for_parallel_prof(tp, 0, patches_count, lnk_obj_reloc_patcher, &task, "Patch Relocs");
+  }
+  if (is_pdata_changed) {
+    pe_pdata_sort(machine, raw_pdata);
+  }
+  for EachIndex(patch_idx, changed_count) {
+    patches[patch_idx].inc_obj->symbols_count = patches[patch_idx].symbols_count;
+    patches[patch_idx].inc_obj->symbols       = patches[patch_idx].symbols;
+  }
+
+  //
+  // debug info is built from scratch for the patched image, so resolve inputs like the full link
+  // does and move objs to their locations in the image
+  //
+  U64       objs_count = 0;
+  LNK_Obj **objs       = 0;
+  if (lnk_do_debug_info(config)) {
+    lnk_timer_end(LNK_Timer_Image);
+    *link_out  = push_array(arena->v[0], LNK_LinkResult, 1);
+    **link_out = lnk_link_image(tp, arena, config, inputer, symtab);
+    lnk_timer_begin(LNK_Timer_Image);
+
+    // on mismatch the full link picks up the resolved inputs, which are still untouched
+    U64       link_objs_count = (*link_out)->objs.count;
+    LNK_Obj **link_objs       = lnk_array_from_obj_list(scratch.arena, (*link_out)->objs);
+    fail = lnk_inc_match_objs(scratch.arena, state, link_objs_count, link_objs);
+    if (fail.size) { goto exit; }
+    objs_count = link_objs_count;
+    objs       = link_objs;
+
+    // symbols in the state are final, so there are no moves to follow
+    HashTable *no_moves_ht = hash_table_init(scratch.arena, 1);
+    for EachIndex(obj_idx, objs_count) {
+      LNK_IncObj  *inc_obj = &state->objs[obj_idx];
+      LNK_IncPatch patch   = { .inc_obj = inc_obj, .obj = objs[obj_idx], .symbols_count = inc_obj->symbols_count, .symbols = inc_obj->symbols };
+      lnk_inc_move_obj_to_image(&patch, no_moves_ht, image_section_table);
+    }
+
+    // relocations in debug sections are applied to the obj data, image sections are relocated
+    // into a copy that is thrown away, since the image is relocated already
+    LNK_ObjRelocPatcher task = { .image_data = push_str8_copy(scratch.arena, image_data), .objs = objs, .image_base = pe.image_base, .image_section_table = image_section_table };
+    tp_for_parallel_prof(tp, 0, objs_count, lnk_obj_reloc_patcher, &task, "Patch Debug Relocs");
+  }
+
+  //
+  // patch image header
+  //
+  {
+    U32 *entry_point_voff = str8_deserial_get_raw_ptr(image_data, pe.optional_header_off + OffsetOf(PE_OptionalHeader32Plus, entry_point_va), sizeof(U32));
+    if (entry_point_voff) {
+      LNK_IncSymbol *move = hash_table_search_u64_raw(moves_ht, *entry_point_voff);
+      if (move) {
+        *entry_point_voff = safe_cast_u32(lnk_inc_voff_from_symbol(image_section_table, move));
+      }
+    }
+
+    // image guid is a hash of the image, which the full link takes before guids are written
+    if (objs) {
+      lnk_write_image_guid(symtab, image_data, image_section_table, config->guid);
+    }
+    if (config->flags & LNK_ConfigFlag_WriteImageChecksum) {
+      *pe.check_sum = 0;
+      *pe.check_sum = pe_compute_checksum(image_data.str, image_data.size);
+    }
+    if (objs) {
+      lnk_patch_image_guid(tp, config, symtab, image_data, image_section_table);
+    }
+  }
+
+  //
+  // write image, debug info, and updated state
+  //
+  lnk_write_data_to_file_path(config->out_path, config->temp_out_path, image_data);
+  if (objs) {
+    lnk_timer_end(LNK_Timer_Image);
+    lnk_build_debug_info(tp, arena, config, symtab, image_data, objs_count, objs);
+    lnk_timer_begin(LNK_Timer_Image);
+  }
+  {
+    FileProperties props = properties_from_file_path(config->out_path);
+    state->image_size     = props.size;
+    state->image_modified = props.modified;
+    lnk_write_data_list_to_file_path(config->incremental_name, str8_zero(), lnk_inc_data_from_state(scratch.arena, state));
+  }
+
+  lnk_log(LNK_Log_Incremental, "Incremental: patched %llu changed obj(s) and relocated %llu obj(s)", changed_count, patches_count - changed_count);
+  is_linked = 1;
+
+  exit:;
+  if (fail.size) {
+    lnk_log(LNK_Log_Incremental, "Incremental: %S; performing full link", fail);
+  }
+  scratch_end(scratch);
+  lnk_timer_end(LNK_Timer_Image);
+  ProfEnd();
+  return is_linked;
+}
+
+internal void
+lnk_write_thread(void *raw_ctx)
+{
+  ProfBeginFunction();
+  LNK_WriteThreadContext *ctx = raw_ctx;
+  lnk_write_data_list_to_file_path(ctx->path, ctx->temp_path, ctx->data);
+  ProfEnd();
+}
+
+internal void
+lnk_rdi_thread(void *raw_ctx)
+{
+  ProfBeginFunction();
+  LNK_RdiThreadContext *ctx = raw_ctx;
+  lnk_timer_begin(LNK_Timer_Rdi);
+
+  String8List rdi_data = lnk_build_rad_debug_info(ctx->tp,
+                                                  ctx->arena,
+                                                  OperatingSystem_Windows,
+                                                  rdi_arch_from_coff_machine(ctx->config->machine),
+                                                  lnk_get_image_name(ctx->config),
+                                                  ctx->image_data,
+                                                  ctx->objs_count,
+                                                  ctx->objs,
+                                                  ctx->cv->debug_s_arr,
+                                                  ctx->cv->symbol_input_count,
+                                                  ctx->cv->symbol_inputs,
+                                                  (CV_SymbolListArray[]){0},
+                                                  ctx->types);
+
+  ctx->write_ctx.path      = ctx->config->rad_debug_name;
+  ctx->write_ctx.temp_path = ctx->config->temp_rad_debug_name;
+  ctx->write_ctx.data      = rdi_data;
+  ctx->write_thread        = thread_launch(lnk_write_thread, &ctx->write_ctx);
+
+  lnk_timer_end(LNK_Timer_Rdi);
+  ProfEnd();
+}
+
+internal void
+lnk_log_timers(void)
+{
+  Temp scratch = scratch_begin(0, 0);
+  
+  U64 total_build_time_micro = 0;
+  for (U64 i = 0; i < LNK_Timer_Count; ++i) {
+    total_build_time_micro += g_timers[i].end - g_timers[i].begin;
+  }
+  
+  String8List output_list = {0};
+  str8_list_pushf(scratch.arena, &output_list, "------ Link Times --------------------------------------------------------------");
+  for (U64 i = 0; i < LNK_Timer_Count; ++i) {
+    U64 build_time_micro = g_timers[i].end - g_timers[i].begin;
+    if (build_time_micro != 0) {
+      String8  timer_name = lnk_string_from_timer_type(i);
+      DateTime time       = date_time_from_micro_seconds(build_time_micro);
+      String8  time_str   = string_from_elapsed_time(scratch.arena, time);
+      str8_list_pushf(scratch.arena, &output_list, "  %-5S Time: %S", timer_name, time_str);
+    }
+  }
+
+  // RDI and PDB are built concurrently
+  LNK_Timer rdi_timer     = g_timers[LNK_Timer_Rdi];
+  LNK_Timer pdb_timer     = g_timers[LNK_Timer_Pdb];
+  U64       overlap_begin = Max(rdi_timer.begin, pdb_timer.begin);
+  U64       overlap_end   = Min(rdi_timer.end, pdb_timer.end);
+  if (rdi_timer.end != 0 && pdb_timer.end != 0) {
+    DateTime wall_time     = date_time_from_micro_seconds(Max(rdi_timer.end, pdb_timer.end) - Min(rdi_timer.begin, pdb_timer.begin));
+    String8  wall_time_str = string_from_elapsed_time(scratch.arena, wall_time);
+    str8_list_pushf(scratch.arena, &output_list, "  RDI/PDB Wall Time: %S", wall_time_str);
+    if (overlap_end > overlap_begin) {
+      DateTime overlap_time     = date_time_from_micro_seconds(overlap_end - overlap_begin);
+      String8  overlap_time_str = string_from_elapsed_time(scratch.arena, overlap_time);
+      str8_list_pushf(scratch.arena, &output_list, "  RDI/PDB Overlap: %S", overlap_time_str);
+    }
+  }
+  
+  DateTime total_time = date_time_from_micro_seconds(total_build_time_micro);
+  String8 total_time_str = string_from_elapsed_time(scratch.arena, total_time);
+  str8_list_pushf(scratch.arena, &output_list, "  Total Time: %S", total_time_str);
+  
+  StringJoin new_line_join = { str8_lit_comp(""), str8_lit_comp("\n"), str8_lit_comp("") };
+  String8 output = str8_list_join(scratch.arena, &output_list, &new_line_join);
+  lnk_log(LNK_Log_Timers, "%S\n", output);
+  
+  scratch_end(scratch);
+}
+
+internal void
+lnk_log_link_stats(LNK_LinkResult link, LNK_ImageContext image_ctx)
+{
+  Temp scratch = scratch_begin(0, 0);
+
+  String8List output_list = {0};
+  str8_list_pushf(scratch.arena, &output_list, "------ Link Stats --------------------------------------------------------------");
+  str8_list_pushf(scratch.arena, &output_list, "  Objs: %llu", link.objs.count);
+  str8_list_pushf(scratch.arena, &output_list, "  Libs: %llu", link.libs.count);
+  str8_list_pushf(scratch.arena, &output_list, "  Lib Symbols: %llu (Definitions: %llu)", link.lib_index.names_count, link.lib_index.defns_count);
+
+  str8_list_pushf(scratch.arena, &output_list, "  Image Sections:");
+  for (LNK_SectionNode *sect_n = image_ctx.sectab->list.first; sect_n != 0; sect_n = sect_n->next) {
+    LNK_Section *sect = &sect_n->data;
+    if (sect->vsize == 0) { continue; }
+    str8_list_pushf(scratch.arena, &output_list, "    %-8S Virtual Size: %M, File Size: %M", sect->name, sect->vsize, sect->fsize);
+  }
+
+  LNK_IcfStats icf      = link.icf_stats;
+  DateTime     icf_time = date_time_from_micro_seconds(icf.time_us);
+  str8_list_pushf(scratch.arena, &output_list, "  /OPT:ICF:");
+  str8_list_pushf(scratch.arena, &output_list, "    Eligible Sections: %llu", icf.sections_count);
+  str8_list_pushf(scratch.arena, &output_list, "    Folded Sections:   %llu", icf.folded_count);
+  str8_list_pushf(scratch.arena, &output_list, "    Folded Size:       %M", icf.folded_size);
+  str8_list_pushf(scratch.arena, &output_list, "    Iterations:        %llu", icf.iter_count);
+  str8_list_pushf(scratch.arena, &output_list, "    Unsettled:         %llu", icf.unsettled_count);
+  str8_list_pushf(scratch.arena, &output_list, "    Time:              %S", string_from_elapsed_time(scratch.arena, icf_time));
+
+  LNK_OrderStats order      = image_ctx.order_stats;
+  DateTime       order_time = date_time_from_micro_seconds(order.time_us);
+  str8_list_pushf(scratch.arena, &output_list, "  /ORDER:");
+  str8_list_pushf(scratch.arena, &output_list, "    Ordered Contribs:  %llu", order.ordered_count);
+  str8_list_pushf(scratch.arena, &output_list, "    Clusters:          %llu", order.clusters_count);
+  str8_list_pushf(scratch.arena, &output_list, "    Missing Symbols:   %llu", order.missing_count);
+  str8_list_pushf(scratch.arena, &output_list, "    Hot Span Before:   %M", order.hot_span_before);
+  str8_list_pushf(scratch.arena, &output_list, "    Hot Span After:    %M", order.hot_span_after);
+  str8_list_pushf(scratch.arena, &output_list, "    Time:              %S", string_from_elapsed_time(scratch.arena, order_time));
+
+  StringJoin new_line_join = { str8_lit_comp(""), str8_lit_comp("\n"), str8_lit_comp("") };
+  String8    output        = str8_list_join(scratch.arena, &output_list, &new_line_join);
+  lnk_log(LNK_Log_LinkStats, "%S\n", output);
+
+  scratch_end(scratch);
+}
+
+internal void
+lnk_build_debug_info(TP_Context *tp, TP_Arena *arena, LNK_Config *config, LNK_SymbolTable *symtab, String8 image_data, U64 objs_count, LNK_Obj **objs)
+{
+  ProfBeginFunction();
+  lnk_timer_begin(LNK_Timer_Debug);
+  Temp scratch = scratch_begin(arena->v, arena->count);
+
+  U64       debug_info_objs_count = 0;
+  LNK_Obj **debug_info_objs       = push_array(scratch.arena, LNK_Obj *, objs_count);
+  for EachIndex(obj_idx, objs_count) {
+    LNK_Obj *obj = objs[obj_idx];
+    if (obj->exclude_from_debug_info) { continue; }
+    debug_info_objs[debug_info_objs_count++] = obj;
+  }
+
+  //
+  // CodeView
+  //
+  LNK_CodeViewInput cv       = lnk_make_code_view_input(tp, arena, config, debug_info_objs_count, debug_info_objs);
+  LNK_MergedTypes   cv_types = lnk_merge_types(tp, arena, &cv);
+
+  //
+  // RDI and PDB
+  //
+  // builders only read CodeView input, so when both are requested they run
+  // concurrently, each on its own half of the workers; a pool runs one task
+  // set at a time, so each half gets its own pool, which draws from the
+  // shared thread pool (if any) like the linker's pool does; on a single
+  // core the halves only take turns, so builders run back to back there
+  B32 do_rdi        = config->rad_debug == LNK_SwitchState_Yes;
+  B32 do_pdb        = config->debug_mode == LNK_DebugMode_Full;
+  B32 is_concurrent = do_rdi && do_pdb && tp->worker_count > 1 && get_system_info()->logical_processor_count > 1;
+
+  TP_Context *rdi_tp    = tp,    *pdb_tp    = tp;
+  TP_Arena   *rdi_arena = arena, *pdb_arena = arena;
+  if (is_concurrent) {
+    U32 rdi_worker_count = tp->worker_count / 2;
+    U32 pdb_worker_count = tp->worker_count - rdi_worker_count;
+    rdi_tp    = tp_alloc(scratch.arena, rdi_worker_count, config->max_worker_count, config->shared_thread_pool_name);
+    pdb_tp    = tp_alloc(scratch.arena, pdb_worker_count, config->max_worker_count, config->shared_thread_pool_name);
+    rdi_arena = tp_arena_alloc(rdi_tp);
+    pdb_arena = tp_arena_alloc(pdb_tp);
+  }
+
+  LNK_RdiThreadContext *rdi_ctx    = push_array(scratch.arena, LNK_RdiThreadContext, 1);
+  Thread                rdi_thread = {0};
+  if (do_rdi) {
+    rdi_ctx->tp         = rdi_tp;
+    rdi_ctx->arena      = rdi_arena;
+    rdi_ctx->config     = config;
+    rdi_ctx->image_data = image_data;
+    rdi_ctx->objs_count = debug_info_objs_count;
+    rdi_ctx->objs       = debug_info_objs;
+    rdi_ctx->cv         = &cv;
+    rdi_ctx->types      = cv_types;
+    if (is_concurrent) {
+      rdi_thread = thread_launch(lnk_rdi_thread, rdi_ctx);
+    } else {
+      lnk_rdi_thread(rdi_ctx);
+    }
+  }
+
+  LNK_WriteThreadContext *pdb_write_ctx    = push_array(scratch.arena, LNK_WriteThreadContext, 1);
+  Thread                  pdb_write_thread = {0};
+  if (do_pdb) {
+    lnk_timer_begin(LNK_Timer_Pdb);
+
+    LNK_MergedTypes pdb_types = cv_types;
+    if (config->pdb_hash_type_names != LNK_TypeNameHashMode_Null && config->pdb_hash_type_names != LNK_TypeNameHashMode_None) {
+      // replaced leaves are pointed to from a private leaf array, RDI keeps the original names
+      U64 tpi_count = pdb_types.count[CV_TypeIndexSource_TPI];
+      pdb_types.v[CV_TypeIndexSource_TPI] = push_array_no_zero(scratch.arena, U8 *, tpi_count);
+      MemoryCopyTyped(pdb_types.v[CV_TypeIndexSource_TPI], cv_types.v[CV_TypeIndexSource_TPI], tpi_count);
+
+      lnk_replace_type_names_with_hashes(pdb_tp,
+                                         pdb_arena,
+                                         pdb_types.count[CV_TypeIndexSource_TPI],
+                                         pdb_types.v    [CV_TypeIndexSource_TPI],
+                                         config->pdb_hash_type_names,
+                                         config->pdb_hash_type_name_length,
+                                         config->pdb_hash_type_name_map);
+    }
+
+    pdb_write_ctx->path      = config->pdb_name;
+    pdb_write_ctx->temp_path = config->temp_pdb_name;
+    pdb_write_ctx->data      = lnk_build_pdb(pdb_tp, pdb_arena, image_data, config, symtab, &cv, pdb_types);
+    pdb_write_thread         = thread_launch(lnk_write_thread, pdb_write_ctx);
+
+    lnk_timer_end(LNK_Timer_Pdb);
+  }
+
+  if (is_concurrent) {
+    thread_join(rdi_thread, -1);
+  }
+
+  //
+  // stripped PDB
+  //
+  if (config->pdb_stripped_name.size != 0) {
+    CV_DebugS *debug_s_arr = push_array(scratch.arena, CV_DebugS, cv.obj_count);
+    for EachIndex(obj_idx, cv.obj_count) {
+
+      CV_DebugS   *debug_s_dst = &debug_s_arr[obj_idx];
+      CV_DebugS   *debug_s_src = &cv.debug_s_arr[obj_idx];
+      String8List *dst         = &debug_s_dst->data_list[CV_C13SubSectionIdxKind_Symbols];
+      String8List *src         = &debug_s_src->data_list[CV_C13SubSectionIdxKind_Symbols];
+
+      U64 proc_count = 0;
+      U64 proc_size  = 0;
+      U64 section = 0;
+      for EachNode(n, String8Node, src->first) {
+        for (U64 cursor = 0; cursor < n->string.size; ) {
+          U64 c = cursor;
+          CV_Symbol symbol = {0};
+          TryReadBreak(cv_read_symbol(n->string, cursor, CV_SymbolAlign, &symbol), cursor);
+          if (symbol.kind == CV_SymKind_SKIP) { continue; }
+          if (cv_is_lproc(symbol)) {
+            proc_count += 1;
+            proc_size += AlignPow2(sizeof(CV_SymbolHeader) + symbol.data.size, CV_SymbolAlign);
+            proc_size += AlignPow2(sizeof(CV_SymbolHeader), CV_SymbolAlign); // S_END
+          }
+        }
+        section += 1;
+      }
+
+      if (proc_count) {
+        U64 end_count     = proc_count;
+        U64 symbol_count  = proc_count + end_count;
+        U64 buffer_size   = proc_size;
+        U8 *buffer        = push_array(scratch.arena, U8, buffer_size);
+        U64 buffer_cursor = 0;
+
+        for EachNode(n, String8Node, src->first) {
+          for (U64 cursor = 0; cursor < n->string.size; ) {
+            CV_Symbol symbol = {0};
+            TryReadBreak(cv_read_symbol(n->string, cursor, CV_SymbolAlign, &symbol), cursor);
+            if (symbol.kind == CV_SymKind_SKIP) { continue; }
+            if (cv_is_lproc(symbol)) {
+              CV_SymProc32 *src_proc = str8_deserial_get_raw_ptr(symbol.data, 0, sizeof(*src_proc));
+              memory_write32(&src_proc->itype, 0); // strip type index
+              buffer_cursor += cv_write_symbol(buffer, buffer_cursor, buffer_size, &symbol, CV_SymbolAlign);
+              buffer_cursor += cv_write_symbol(buffer, buffer_cursor, buffer_size, &(CV_Symbol){ .kind = CV_SymKind_END }, CV_SymbolAlign);
+            }
+          }
+        }
+        Assert(buffer_cursor == buffer_size);
+
+        str8_list_push(scratch.arena, dst, str8(buffer, buffer_size));
+      }
+    }
+
+    LNK_CodeViewInput stripped_cv = {0};
+    stripped_cv.config              = config;
+    stripped_cv.is_stripped         = 1;
+    stripped_cv.obj_arr             = cv.obj_arr;
+    stripped_cv.obj_count           = cv.obj_count; 
+    stripped_cv.count               = cv.obj_count;
+    stripped_cv.debug_s_arr         = debug_s_arr;
+
+    String8List pdb_data = lnk_build_pdb(tp, arena, image_data, config, symtab, &stripped_cv, (LNK_MergedTypes){0});
+    lnk_write_data_list_to_file_path(config->pdb_stripped_name, str8f(scratch.arena, "%S.tmp", config->pdb_stripped_name), pdb_data);
+  }
+
+  // wait for debug info to reach disk
+  if (do_rdi) { thread_join(rdi_ctx->write_thread, -1); }
+  if (do_pdb) { thread_join(pdb_write_thread, -1);      }
+
+  // written data lives on the builder arenas, so release them only after writes
+  if (is_concurrent) {
+    tp_arena_release(&rdi_arena);
+    tp_arena_release(&pdb_arena);
+    tp_release(rdi_tp);
+    tp_release(pdb_tp);
+  }
+
+  scratch_end(scratch);
+  lnk_timer_end(LNK_Timer_Debug);
+  ProfEnd();
+}
+
+internal void
+lnk_run(TP_Context *tp, TP_Arena *arena, LNK_Config *config)
+{
+  ProfBeginFunction();
+
+  Temp scratch = scratch_begin(arena->v, arena->count);
+
+  if (lnk_get_log_status(LNK_Log_Debug)) {
+    String8 full_cmd_line = str8_list_join(scratch.arena, &config->raw_cmd_line, &(StringJoin){ .sep = str8_lit_comp(" ") });
+    lnk_fprintf(stderr, "--------------------------------------------------------------------------------\n");
+    lnk_fprintf(stderr, "Command Line: %.*s\n", str8_varg(full_cmd_line));
+    lnk_fprintf(stderr, "Work Dir    : %.*s\n", str8_varg(config->work_dir));
+    lnk_fprintf(stderr, "--------------------------------------------------------------------------------\n");
+  }
+
+  //
+  // Input Context
+  //
+  LNK_Inputer *inputer = lnk_inputer_init();
 
   //
   // Symbol Table
   //
   LNK_SymbolTable *symtab = lnk_symbol_table_init(arena);
 
+  //
+  // Incremental Link
+  //
+  LNK_LinkResult *inc_link = 0;
+  if (config->incremental == LNK_SwitchState_Yes && lnk_inc_try_link(tp, arena, config, inputer, symtab, &inc_link)) {
+    if (lnk_get_log_status(LNK_Log_Timers)) {
+      lnk_log_timers();
+    }
+    scratch_end(scratch);
+    ProfEnd();
+    return;
+  }
+
   //
   // Link Image
   //
-  LNK_LinkResult link = lnk_link_image(tp, arena, config, inputer, symtab);
+  // incremental link with debug info may have resolved inputs before falling back
+  LNK_LinkResult link = inc_link ? *inc_link : lnk_link_image(tp, arena, config, inputer, symtab);
 
   U64       objs_count = link.objs.count;
   U64       libs_count = link.libs.count;
   LNK_Obj **objs       = lnk_array_from_obj_list(scratch.arena, link.objs);
   LNK_Lib **libs       = lnk_array_from_lib_list(scratch.arena, link.libs);
 
+  // symbol tables and section headers are overwritten with image locations, capture what incremental link needs
+  LNK_IncObjCapture *inc_captures = 0;
+  if (config->incremental == LNK_SwitchState_Yes) {
+    inc_captures = lnk_inc_capture_objs(scratch.arena, objs_count, objs);
+  }
+
   //
   // Layout Image
   //
   LNK_ImageContext image_ctx = lnk_build_image(arena, tp, config, symtab, objs_count, objs);
 
+  if (lnk_get_log_status(LNK_Log_LinkStats)) {
+    lnk_log_link_stats(link, image_ctx);
+  }
+
   // Write image in the background
   LNK_WriteThreadContext *image_write_ctx = push_array(scratch.arena, LNK_WriteThreadContext, 1);
   image_write_ctx->path      = config->out_path;
   image_write_ctx->temp_path = config->temp_out_path;
-  image_write_ctx->data      = image_ctx.image_data;
+  str8_list_push(scratch.arena, &image_write_ctx->data, image_ctx.image_data);
   Thread image_write_thread = thread_launch(lnk_write_thread, image_write_ctx);
 
+  //
+  // Incremental State
+  //
+  LNK_IncState *inc_state = 0;
+  if (config->incremental == LNK_SwitchState_Yes) {
+    inc_state = lnk_inc_state_from_image(scratch.arena, config, image_ctx.image_data, objs_count, objs, inc_captures, libs_count, libs);
+  }
+
   //
   // RAD Map
   //
@@ -5307,147 +7982,20 @@ lnk_run(TP_Context *tp, TP_Arena *arena, LNK_Config *config)
   // Debug Info
   //
   if (lnk_do_debug_info(config)) {
-    ProfBegin("Debug Info");
-    lnk_timer_begin(LNK_Timer_Debug);
-
-    U64       debug_info_objs_count = 0;
-    LNK_Obj **debug_info_objs       = push_array(scratch.arena, LNK_Obj *, objs_count);
-    for EachIndex(obj_idx, objs_count) {
-      LNK_Obj *obj = objs[obj_idx];
-      if (obj->exclude_from_debug_info) { continue; }
-      debug_info_objs[debug_info_objs_count++] = obj;
-    }
-
-    //
-    // CodeView
-    //
-    LNK_CodeViewInput cv       = lnk_make_code_view_input(tp, arena, config, debug_info_objs_count, debug_info_objs);
-    LNK_MergedTypes   cv_types = lnk_merge_types(tp, arena, &cv);
-
-    //
-    // RDI
-    //
-    if (config->rad_debug == LNK_SwitchState_Yes) {
-      lnk_timer_begin(LNK_Timer_Rdi);
-
-      String8List rdi_data = lnk_build_rad_debug_info(tp,
-                                                      arena,
-                                                      OperatingSystem_Windows,
-                                                      rdi_arch_from_coff_machine(config->machine),
-                                                      lnk_get_image_name(config),
-                                                      image_ctx.image_data,
-                                                      debug_info_objs_count,
-                                                      debug_info_objs,
-                                                      cv.debug_s_arr,
-                                                      cv.symbol_input_count,
-                                                      cv.symbol_inputs,
-                                                      (CV_SymbolListArray[]){0},
-                                                      cv_types);
-
-      lnk_write_data_list_to_file_path(config->rad_debug_name, config->temp_rad_debug_name, rdi_data);
-
-      lnk_timer_end(LNK_Timer_Rdi);
-    }
-
-    //
-    // PDB
-    //
-    // TODO: Parallel debug info builds are currently blocked by the patch
-    // strings in $$FILE_CHECKSUM step in `lnk_process_c13_data_task`.
-    if (config->debug_mode == LNK_DebugMode_Full) {
-      lnk_timer_begin(LNK_Timer_Pdb);
-
-      if (config->pdb_hash_type_names != LNK_TypeNameHashMode_Null && config->pdb_hash_type_names != LNK_TypeNameHashMode_None) {
-        lnk_replace_type_names_with_hashes(tp,
-                                           arena,
-                                           cv_types.count[CV_TypeIndexSource_TPI],
-                                           cv_types.v    [CV_TypeIndexSource_TPI],
-                                           config->pdb_hash_type_names,
-                                           config->pdb_hash_type_name_length,
-                                           config->pdb_hash_type_name_map);
-      }
-
-      String8List pdb_data = lnk_build_pdb(tp, arena, image_ctx.image_data, config, symtab, &cv, cv_types);
-      lnk_write_data_list_to_file_path(config->pdb_name, config->temp_pdb_name, pdb_data);
-      lnk_timer_end(LNK_Timer_Pdb);
-    }
-
-    //
-    // stripped PDB
-    //
-    if (config->pdb_stripped_name.size != 0) {
-      CV_DebugS *debug_s_arr = push_array(scratch.arena, CV_DebugS, cv.obj_count);
-      for EachIndex(obj_idx, cv.obj_count) {
-
-        CV_DebugS   *debug_s_dst = &debug_s_arr[obj_idx];
-        CV_DebugS   *debug_s_src = &cv.debug_s_arr[obj_idx];
-        String8List *dst         = &debug_s_dst->data_list[CV_C13SubSectionIdxKind_Symbols];
-        String8List *src         = &debug_s_src->data_list[CV_C13SubSectionIdxKind_Symbols];
-
-        U64 proc_count = 0;
-        U64 proc_size  = 0;
-        U64 section = 0;
-        for EachNode(n, String8Node, src->first) {
-          for (U64 cursor = 0; cursor < n->string.size; ) {
-            U64 c = cursor;
-            CV_Symbol symbol = {0};
-            TryReadBreak(cv_read_symbol(n->string, cursor, CV_SymbolAlign, &symbol), cursor);
-            if (symbol.kind == CV_SymKind_SKIP) { continue; }
-            if (cv_is_lproc(symbol)) {
-              proc_count += 1;
-              proc_size += AlignPow2(sizeof(CV_SymbolHeader) + symbol.data.size, CV_SymbolAlign);
-              proc_size += AlignPow2(sizeof(CV_SymbolHeader), CV_SymbolAlign); // S_END
-            }
-          }
-          section += 1;
-        }
-
-        if (proc_count) {
-          U64 end_count     = proc_count;
-          U64 symbol_count  = proc_count + end_count;
-          U64 buffer_size   = proc_size;
-          U8 *buffer        = push_array(scratch.arena, U8, buffer_size);
-          U64 buffer_cursor = 0;
-
-          for EachNode(n, String8Node, src->first) {
-            for (U64 cursor = 0; cursor < n->string.size; ) {
-              CV_Symbol symbol = {0};
-              TryReadBreak(cv_read_symbol(n->string, cursor, CV_SymbolAlign, &symbol), cursor);
-              if (symbol.kind == CV_SymKind_SKIP) { continue; }
-              if (cv_is_lproc(symbol)) {
-                CV_SymProc32 *src_proc = str8_deserial_get_raw_ptr(symbol.data, 0, sizeof(*src_proc));
-                memory_write32(&src_proc->itype, 0); // strip type index
-                buffer_cursor += cv_write_symbol(buffer, buffer_cursor, buffer_size, &symbol, CV_SymbolAlign);
-                buffer_cursor += cv_write_symbol(buffer, buffer_cursor, buffer_size, &(CV_Symbol){ .kind = CV_SymKind_END }, CV_SymbolAlign);
-              }
-            }
-          }
-          Assert(buffer_cursor == buffer_size);
-
-          str8_list_push(scratch.arena, dst, str8(buffer, buffer_size));
-        }
-      }
-
-      LNK_CodeViewInput stripped_cv = {0};
-      stripped_cv.config              = config;
-      stripped_cv.is_stripped         = 1;
-      stripped_cv.obj_arr             = cv.obj_arr;
-      stripped_cv.obj_count           = cv.obj_count; 
-      stripped_cv.count               = cv.obj_count;
-      stripped_cv.debug_s_arr         = debug_s_arr;
-      stripped_cv.symbol_input_ranges = push_array(scratch.arena, Rng1U64, tp->worker_count);
-
-      String8List pdb_data = lnk_build_pdb(tp, arena, image_ctx.image_data, config, symtab, &stripped_cv, (LNK_MergedTypes){0});
-      lnk_write_data_list_to_file_path(config->pdb_stripped_name, str8f(scratch.arena, "%S.tmp", config->pdb_stripped_name), pdb_data);
-    }
-
-    lnk_timer_end(LNK_Timer_Debug);
-    ProfEnd();
+    lnk_build_debug_info(tp, arena, config, symtab, image_ctx.image_data, objs_count, objs);
   }
 
   // wait for the thread to finish writing image to disk
   thread_join(image_write_thread, -1);
 
+  // state is written after the image so it records final image properties
+  if (inc_state) {
+    FileProperties image_props = properties_from_file_path(config->out_path);
+    inc_state->image_size     = image_props.size;
+    inc_state->image_modified = image_props.modified;
+    lnk_write_data_list_to_file_path(config->incremental_name, str8_zero(), lnk_inc_data_from_state(scratch.arena, inc_state));
+  }
+
   //
   // Timers
   //
@@ -68,6 +68,90 @@ typedef struct LNK_Inputer
   LNK_InputList  new_libs[LNK_InputSource_Count];
 } LNK_Inputer;
 
+// --- Identical COMDAT Folding ------------------------------------------------
+
+typedef struct LNK_IcfReloc
+{
+  U32 type;
+  U32 apply_off;
+  U32 target_idx; // eligible section the relocation points into, max_U32 when target can't be folded
+  U64 value;      // offset into the eligible target, or a key that identifies any other target
+} LNK_IcfReloc;
+
+typedef struct LNK_IcfSection
+{
+  LNK_Obj      *obj;
+  U32           section_number;
+  B32           is_root;        // non-associative COMDAT which can be folded, associated sections are folded with their roots
+  U64           relocs_count;
+  LNK_IcfReloc *relocs;
+  U64           children_count;
+  U32          *children;       // sections associated with the root, max_U32 for children that can't be folded
+} LNK_IcfSection;
+
+typedef struct LNK_IcfClass
+{
+  U64 hash;
+  U32 sect_idx;
+} LNK_IcfClass;
+
+typedef struct LNK_IcfStats
+{
+  U64 sections_count;
+  U64 iter_count;
+  U64 unsettled_count;
+  U64 folded_count;
+  U64 folded_size;
+  U64 time_us;
+} LNK_IcfStats;
+
+// --- Function Order ----------------------------------------------------------
+
+#define LNK_ORDER_MAX_CLUSTER_SIZE       MB(1)
+#define LNK_ORDER_MAX_DENSITY_DEGRADATION 8
+
+typedef struct LNK_OrderEdge
+{
+  U32 from;
+  U32 to;
+  U64 weight;
+} LNK_OrderEdge;
+
+typedef struct LNK_OrderNode
+{
+  LNK_SectionContrib *sc;
+  U64                 size;            // cluster size, valid on leaders
+  U64                 weight;          // cluster weight, valid on leaders
+  U64                 initial_weight;  // samples and call counts that land in this node
+  U32                 best_pred;       // heaviest caller, max_U32 when node has no callers
+  U64                 best_pred_weight;
+  U32                 leader;
+  U32                 next;            // next node in the cluster, max_U32 terminates the chain
+  U32                 last;            // last node in the cluster, valid on leaders
+} LNK_OrderNode;
+
+typedef struct LNK_OrderDensity
+{
+  F64 density;
+  U32 node_idx;
+} LNK_OrderDensity;
+
+typedef struct LNK_OrderKey
+{
+  U64                 key; // rank of the ordered contribs, contribs without a rank go after them in input order
+  LNK_SectionContrib *sc;
+} LNK_OrderKey;
+
+typedef struct LNK_OrderStats
+{
+  U64 ordered_count;
+  U64 clusters_count;
+  U64 missing_count;
+  U64 hot_span_before;
+  U64 hot_span_after;
+  U64 time_us;
+} LNK_OrderStats;
+
 // --- Image Link -------------------------------------------------------------
 
 #define LNK_IMPORT_STUB "*** RAD_IMPORT_STUB ***"
@@ -89,6 +173,12 @@ typedef struct LNK_LibMemberInfo
   LNK_LibMemberFlags flags;
 } LNK_LibMemberInfo;
 
+typedef struct LNK_SymbolSearchCursor
+{
+  LNK_SymbolHashTrieChunk *chunk;
+  U64                      count;
+} LNK_SymbolSearchCursor;
+
 typedef struct LNK_Link
 {
   Arena                   *arena;
@@ -101,14 +191,19 @@ typedef struct LNK_Link
   String8Node            **last_obj_lib;
   HashMap                  lib_member_infos_hm;
   LNK_LibMemberRefList     imports;
+  LNK_LibIndex             lib_index;
+  LNK_LibNode            **last_search_lib;
+  LNK_SymbolSearchCursor  *search_cursors;
   B32                      try_to_resolve_entry_point;
   B32                      asan_libs_resolved;
 } LNK_Link;
 
 typedef struct LNK_LinkResult
 {
-  LNK_ObjList objs;
-  LNK_LibList libs;
+  LNK_ObjList  objs;
+  LNK_LibList  libs;
+  LNK_LibIndex lib_index;
+  LNK_IcfStats icf_stats;
 } LNK_LinkResult;
 
 // -- Image Layout ------------------------------------------------------------
@@ -120,6 +215,7 @@ typedef struct LNK_ImageContext
 {
   String8           image_data;
   LNK_SectionTable *sectab;
+  LNK_OrderStats    order_stats;
 } LNK_ImageContext;
 
 typedef struct LNK_SectionDefinition
@@ -201,13 +297,21 @@ typedef struct LNK_BaseRelocPageArray
 
 // --- Workers Contexts --------------------------------------------------------
 
+typedef struct
+{
+  LNK_SymbolTable         *symtab;
+  LNK_LibIndex            *lib_index;
+  LNK_Lib                **new_libs;
+  U64                      new_libs_input_idx;
+  LNK_SymbolSearchCursor  *search_cursors;
+} LNK_LibSearchCandidatesTask;
+
 typedef struct
 {
   B32                   search_anti_deps;
   LNK_Link             *link;
   HashMap              *imports_hm;
   LNK_SymbolTable      *symtab;
-  LNK_Symbol           *import_stub;
   LNK_Lib              *lib;
   LNK_LibMemberInfo    *lib_member_infos;
   LNK_LibMemberRefList *member_ref_lists;
@@ -220,6 +324,20 @@ typedef struct
   LNK_ObjList      objs;
 } LNK_OptRefTask;
 
+typedef struct
+{
+  LNK_SymbolTable  *symtab;
+  LNK_Obj         **objs;
+  U64              *counts;
+  U64              *offsets;
+  U32             **sect_idxs; // (obj index, section index) -> eligible section index
+  LNK_IcfSection   *sects;
+  U64               sects_count;
+  Rng1U64          *ranges;
+  U64              *classes;
+  U64              *next_classes;
+} LNK_IcfTask;
+
 typedef struct
 {
   String8              image_data;
@@ -297,11 +415,25 @@ typedef struct
 
 typedef struct
 {
-  String8 path;
-  String8 temp_path;
-  String8 data;
+  String8     path;
+  String8     temp_path;
+  String8List data;
 } LNK_WriteThreadContext;
 
+typedef struct
+{
+  TP_Context             *tp;
+  TP_Arena               *arena;
+  LNK_Config             *config;
+  String8                 image_data;
+  U64                     objs_count;
+  LNK_Obj               **objs;
+  LNK_CodeViewInput      *cv;
+  LNK_MergedTypes         types;
+  LNK_WriteThreadContext  write_ctx;
+  Thread                  write_thread;
+} LNK_RdiThreadContext;
+
 typedef struct
 {
   String8  data;
@@ -309,12 +441,118 @@ typedef struct
   U128    *hashes;
 } LNK_Blake3Hasher;
 
+// --- Incremental -------------------------------------------------------------
+
+#define LNK_INCREMENTAL_MAGIC       "RADLINK INCREMENTAL"
+#define LNK_INCREMENTAL_VERSION     1
+#define LNK_INCREMENTAL_RESERVE_MIN 32
+#define LNK_INCREMENTAL_RESERVE_MAX KB(64)
+
+typedef enum
+{
+  LNK_IncObj_File,   // obj read from disk, patched in place when it changes
+  LNK_IncObj_Member, // member of a regular archive, relocated again when symbols it references move
+  LNK_IncObj_Fixed,  // linker-made obj or thin archive member, cannot be relocated again
+} LNK_IncObjKind;
+
+typedef enum
+{
+  LNK_IncSymbol_Unresolved,
+  LNK_IncSymbol_Regular,
+  LNK_IncSymbol_Abs,
+  LNK_IncSymbol_Removed,
+} LNK_IncSymbolKind;
+
+typedef U32 LNK_IncSymbolFlags;
+enum
+{
+  LNK_IncSymbolFlag_Defined = (1 << 0), // symbol is defined in a section of this obj that is in the image
+  LNK_IncSymbolFlag_Final   = (1 << 1), // location is up to date and must not be moved again
+};
+
+typedef struct LNK_IncSection
+{
+  U32 flags;  // section header flags without LnkRemove
+  U32 secnum; // image section number, zero when the section is not in the image
+  U32 voff;
+  U32 foff;   // zero when the section has no file data in the image
+  U32 size;
+  U32 cap;    // size plus bytes reserved after the contribution
+} LNK_IncSection;
+
+typedef struct LNK_IncSymbol
+{
+  String8            name;
+  LNK_IncSymbolFlags flags;
+  LNK_IncSymbolKind  kind;
+  U32                secnum;
+  U32                value;
+} LNK_IncSymbol;
+
+typedef struct LNK_IncObj
+{
+  LNK_IncObjKind  kind;
+  String8         path;       // path to the obj, or to the archive for members
+  U64             member_off; // offset of the member in the archive
+  U64             size;
+  U64             modified;
+  U128            directives_hash;
+  U32             sections_count;
+  U32             symbols_count;
+  LNK_IncSection *sections;
+  LNK_IncSymbol  *symbols;    // symbols which are resolved by name, in symbol table order
+} LNK_IncObj;
+
+typedef struct LNK_IncInput
+{
+  String8 path;
+  U64     size;
+  U64     modified;
+} LNK_IncInput;
+
+// state of the previous link, stored next to the image
+typedef struct LNK_IncState
+{
+  U128          cmd_line_hash;
+  U64           image_size;
+  U64           image_modified;
+  U64           inputs_count;
+  U64           objs_count;
+  LNK_IncInput *inputs;
+  LNK_IncObj   *objs;
+} LNK_IncState;
+
+typedef U8 LNK_IncCaptureFlags;
+enum
+{
+  LNK_IncCaptureFlag_ResolvedByName = (1 << 0),
+  LNK_IncCaptureFlag_DefinedByName  = (1 << 1),
+};
+
+// obj info which is overwritten by the image build
+typedef struct LNK_IncObjCapture
+{
+  U128                 directives_hash;
+  U32                 *section_sizes;
+  LNK_IncCaptureFlags *symbol_flags;
+} LNK_IncObjCapture;
+
+typedef struct LNK_IncPatch
+{
+  LNK_IncObj    *inc_obj;
+  LNK_Obj       *obj;
+  B32            is_changed;
+  U64            symbols_count;
+  LNK_IncSymbol *symbols;
+} LNK_IncPatch;
+
 // --- Config -----------------------------------------------------------------
 
 internal LNK_Config * lnk_config_from_argcv(Arena *arena, int argc, char **argv);
 
 // --- Entry Point -------------------------------------------------------------
 
+internal void lnk_build_debug_info(TP_Context *tp, TP_Arena *arena, LNK_Config *config, LNK_SymbolTable *symtab, String8 image_data, U64 objs_count, LNK_Obj **objs);
 internal void lnk_run(TP_Context *tp, TP_Arena *tp_arena, LNK_Config *config);
 
 // --- Path --------------------------------------------------------------------
@@ -374,17 +612,48 @@ internal LNK_LinkResult lnk_link_image (TP_Context *tp, TP_Arena *arena, LNK_Con
 
 // --- Optimizations -----------------------------------------------------------
 
-internal void lnk_opt_ref(TP_Context *tp, LNK_SymbolTable *symtab, LNK_Config *config, LNK_ObjList objs);
+internal void         lnk_opt_ref(TP_Context *tp, LNK_SymbolTable *symtab, LNK_Config *config, LNK_ObjList objs);
+internal LNK_IcfStats lnk_opt_icf(TP_Context *tp, TP_Arena *arena, LNK_SymbolTable *symtab, LNK_Config *config, LNK_ObjList objs);
 
 // --- Win32 Image -------------------------------------------------------------
 
 internal String8List      lnk_build_guard_tables(TP_Context *tp, LNK_SectionTable *sectab, LNK_SymbolTable *symtab, U64 objs_count, LNK_Obj **objs, COFF_MachineType machine, String8 entry_point_name, LNK_GuardFlags guard_flags, B32 emit_suppress_flag);
 internal String8          lnk_build_base_relocs(TP_Context *tp, TP_Arena *tp_temp, LNK_Config *config, U64 objs_count, LNK_Obj **objs);
 internal String8List      lnk_build_win32_image_header(Arena *arena, LNK_SymbolTable *symtab, LNK_Config *config, LNK_SectionArray sect_arr, U64 expected_image_header_size, U64 *file_header_offset_out, String8List *string_table_out);
+internal void             lnk_write_image_guid(LNK_SymbolTable *symtab, String8 image_data, COFF_SectionHeader **image_section_table, Guid guid);
+internal void             lnk_patch_image_guid(TP_Context *tp, LNK_Config *config, LNK_SymbolTable *symtab, String8 image_data, COFF_SectionHeader **image_section_table);
 internal LNK_ImageContext lnk_build_image(TP_Arena *arena, TP_Context *tp, LNK_Config *config, LNK_SymbolTable *symtab, U64 obj_count, LNK_Obj **objs);
 
+// --- Function Order ----------------------------------------------------------
+
+internal int                   lnk_order_edge_is_before(void *raw_a, void *raw_b);
+internal int                   lnk_order_density_is_before(void *raw_a, void *raw_b);
+internal int                   lnk_order_key_is_before(void *raw_a, void *raw_b);
+internal LNK_SectionContrib *  lnk_order_contrib_from_symbol_name(LNK_BuildImageTask *task, String8 name);
+internal U32                   lnk_order_node_from_contrib(Arena *arena, HashTable *node_ht, LNK_OrderNode *nodes, U64 *nodes_count, LNK_SectionContrib *sc);
+internal U32                   lnk_order_leader_from_node(LNK_OrderNode *nodes, U32 node_idx);
+internal LNK_SectionContrib ** lnk_order_from_order_file(Arena *arena, LNK_BuildImageTask *task, String8 path, String8 data, U64 *order_count_out, LNK_OrderStats *stats);
+internal LNK_SectionContrib ** lnk_order_from_profile(Arena *arena, LNK_BuildImageTask *task, String8 path, String8 data, U64 *order_count_out, LNK_OrderStats *stats);
+internal U32                   lnk_order_rank_from_contrib(LNK_BuildImageTask *task, U32 **ranks, LNK_SectionContrib *sc);
+internal U64                   lnk_hot_span_from_section(LNK_BuildImageTask *task, U32 **ranks, LNK_Section *sect);
+internal LNK_OrderStats        lnk_order_section_contribs(LNK_BuildImageTask *task, LNK_Config *config);
+
+// --- Incremental -------------------------------------------------------------
+
+internal B32                 lnk_inc_can_grow_section(String8 sect_name, COFF_SectionFlags flags);
+internal U64                 lnk_inc_reserve_from_size(U64 size);
+internal LNK_IncObjKind      lnk_inc_obj_kind_from_obj(LNK_Obj *obj);
+internal B32                 lnk_inc_is_symbol_resolved_by_name(COFF_ParsedSymbol symbol);
+internal LNK_IncObjCapture * lnk_inc_capture_objs(Arena *arena, U64 objs_count, LNK_Obj **objs);
+internal LNK_IncState *      lnk_inc_state_from_image(Arena *arena, LNK_Config *config, String8 image_data, U64 objs_count, LNK_Obj **objs, LNK_IncObjCapture *captures, U64 libs_count, LNK_Lib **libs);
+internal String8List         lnk_inc_data_from_state(Arena *arena, LNK_IncState *state);
+internal LNK_IncState *      lnk_inc_state_from_data(Arena *arena, String8 data);
+internal String8             lnk_inc_match_objs(Arena *arena, LNK_IncState *state, U64 objs_count, LNK_Obj **objs);
+internal void                lnk_inc_move_obj_to_image(LNK_IncPatch *patch, HashTable *moves_ht, COFF_SectionHeader **image_section_table);
+internal B32                 lnk_inc_try_link(TP_Context *tp, TP_Arena *arena, LNK_Config *config, LNK_Inputer *inputer, LNK_SymbolTable *symtab, LNK_LinkResult **link_out);
+
 // --- Logger ------------------------------------------------------------------
 
-internal void lnk_log_link_stats(LNK_ObjList obj_list, LNK_LibList *lib_index, LNK_SectionTable *sectab);
+internal void lnk_log_link_stats(LNK_LinkResult link, LNK_ImageContext image_ctx);
 internal void lnk_log_timers(void);
 
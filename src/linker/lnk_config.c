@@ -30,6 +30,7 @@ global read_only LNK_CmdSwitch g_cmd_switch_map[] =
   { LNK_CmdSwitch_Ignore,             0, "IGNORE",               ":#",                             "Ignore a warning."                                            },
   { LNK_CmdSwitch_ImpLib,             0, "IMPLIB",               ":FILENAME",                      "Set file name for the import library."                        },
   { LNK_CmdSwitch_Include,            1, "INCLUDE",              ":SYMBOL",                        "Force a link against SYMBOL."                                 },
+  { LNK_CmdSwitch_Incremental,        0, "INCREMENTAL",          "[:NO]",                          "Patch changed objs into the previous image when possible."    },
   { LNK_CmdSwitch_InferAsanLibs,      1, "INFERASANLIBS",        "[:NO]",                          "No support."                                                  },
   { LNK_CmdSwitch_InferAsanLibsNo,    1, "INFERASANLIBSNO",      "",                               "No support.",                                                 },
   { LNK_CmdSwitch_LargeAddressAware,  0, "LARGEADDRESSAWARE",    "[:NO]",                          "For images that can handle addresses > 2GiB."                 },
@@ -49,6 +50,7 @@ global read_only LNK_CmdSwitch g_cmd_switch_map[] =
   { LNK_CmdSwitch_NoImpLib,           0, "NOIMPLIB",             "",                               "Do not create the import library."                            },
   { LNK_CmdSwitch_NxCompat,           0, "NXCOMPAT",             "[:NO]",                          "Image is compatible with data execution prevention."          },
   { LNK_CmdSwitch_Opt,                0, "OPT",                  "{REF|ICF}",                      "Optimizations."                                               },
+  { LNK_CmdSwitch_Order,              0, "ORDER",                ":@FILENAME",                     "Lay out COMDAT functions in the order they are listed in FILENAME." },
   { LNK_CmdSwitch_Out,                0, "OUT",                  ":FILENAME",                      "File name of the output image."                               },
   { LNK_CmdSwitch_Pdb,                0, "PDB",                  ":FILENAME",                      "File name of the output PDB."                                 },
   { LNK_CmdSwitch_PdbAltPath,         0, "PDBALTPATH",           ":PATH",                          "Alternative output path for the PDB."                         },
@@ -77,9 +79,12 @@ global read_only LNK_CmdSwitch g_cmd_switch_map[] =
   { LNK_CmdSwitch_Rad_Exe,                          0, "RAD_EXE",                              "[:NO]",     "Set EXE bit in the image header."                                                 },
   { LNK_CmdSwitch_Rad_Guid,                         0, "RAD_GUID",                             ":{IMAGEBLAKE3|XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXXXXXX}", "The image guid that is embeded in the debug info." },
   { LNK_CmdSwitch_Rad_LargePages,                   0, "RAD_LARGE_PAGES",                      "[:NO]",     "Disabled by default on Windows."                                                  },
+  { LNK_CmdSwitch_Rad_LibCache,                     0, "RAD_LIB_CACHE",                        ":DIR",      "Directory for cached lib symbol indices, keyed by lib path, size and modification time." },
+  { LNK_CmdSwitch_Rad_LibIndex,                     0, "RAD_LIB_INDEX",                        "[:NO]",     "Resolve lib members through the archive symbol index; with NO every lib is searched for each undefined symbol." },
   { LNK_CmdSwitch_Rad_LinkVer,                      0, "RAD_LINK_VER",                         ":##,##",    "Linker version."                                                                  },
   { LNK_CmdSwitch_Rad_Log,                          0, "RAD_LOG",                              ":{ALL,INPUT_OBJ,INPUT_LIB,IO,LINK_STATS,TIMERS}", "Loggers."                                   },
   { LNK_CmdSwitch_Rad_MtPath,                       0, "RAD_MT_PATH",                          ":EXEPATH",  "Exe path to the manifest tool (default: " LNK_MANIFEST_MERGE_TOOL_NAME ")"        },
+  { LNK_CmdSwitch_Rad_OrderProfile,                 0, "RAD_ORDER_PROFILE",                    ":FILENAME", "Lay out COMDAT functions by call graph from a profile of \"CALLER CALLEE COUNT\" and \"SYMBOL COUNT\" lines." },
   { LNK_CmdSwitch_Rad_OsVer,                        0, "RAD_OS_VER",                           ":##,##",    "OS version."                                                                      },
   { LNK_CmdSwitch_Rad_PageSize,                     0, "RAD_PAGE_SIZE",                        ":#",        "Must be power of two."                                                            },
   { LNK_CmdSwitch_Rad_PathStyle,                    0, "RAD_PATH_STYLE",                       ":{WindowsAbsolute|UnixAbsolute}", "Set path style in the PDB."                                 },
@@ -1454,6 +1459,10 @@ lnk_apply_cmd_option_to_config(LNK_Config *config, String8 cmd_name, String8List
     }
   } break;
 
+  case LNK_CmdSwitch_Incremental: {
+    lnk_cmd_switch_parse_flag(obj, cmd_switch, value_strings, &config->incremental);
+  } break;
+
   case LNK_CmdSwitch_InferAsanLibs: {
     lnk_cmd_switch_parse_flag(obj, cmd_switch, value_strings, &config->infer_asan_libs);
   } break;
@@ -1661,6 +1670,17 @@ lnk_apply_cmd_option_to_config(LNK_Config *config, String8 cmd_name, String8List
     lnk_cmd_switch_set_flag_16(obj, cmd_switch, value_strings, &config->dll_characteristics, PE_DllCharacteristic_NX_COMPAT);
   } break;
 
+  case LNK_CmdSwitch_Order: {
+    String8 order_file_path = {0};
+    if (lnk_cmd_switch_parse_string(obj, cmd_switch, value_strings, &order_file_path)) {
+      if (str8_match(str8_prefix(order_file_path, 1), str8_lit("@"), 0)) {
+        config->order_file_path = push_str8_copy(config->arena, str8_skip(order_file_path, 1));
+      } else {
+        lnk_error_cmd_switch(LNK_Error_Cmdl, obj, cmd_switch, "expected @FILENAME but got \"%S\"", order_file_path);
+      }
+    }
+  } break;
+
   case LNK_CmdSwitch_Opt: {
     for (String8Node *n = value_strings.first; n != 0; n = n->next) {
       String8 param = n->string;
@@ -1834,6 +1854,10 @@ lnk_apply_cmd_option_to_config(LNK_Config *config, String8 cmd_name, String8List
     lnk_cmd_switch_set_flag_64(obj, cmd_switch, value_strings, &config->flags, LNK_ConfigFlag_CheckUnusedDelayLoadDll);
   } break;
 
+  case LNK_CmdSwitch_Rad_OrderProfile: {
+    lnk_cmd_switch_parse_string_copy(config->arena, obj, cmd_switch, value_strings, &config->order_profile_path);
+  } break;
+
   case LNK_CmdSwitch_Rad_Map: {
     lnk_cmd_switch_parse_string_copy(config->arena, obj, cmd_switch, value_strings, &config->rad_chunk_map_name);
     config->rad_chunk_map = LNK_SwitchState_Yes;
@@ -1928,6 +1952,14 @@ lnk_apply_cmd_option_to_config(LNK_Config *config, String8 cmd_name, String8List
     }
   } break;
 
+  case LNK_CmdSwitch_Rad_LibCache: {
+    lnk_cmd_switch_parse_string_copy(config->arena, obj, cmd_switch, value_strings, &config->lib_cache_dir);
+  } break;
+
+  case LNK_CmdSwitch_Rad_LibIndex: {
+    lnk_cmd_switch_set_flag_64(obj, cmd_switch, value_strings, &config->flags, LNK_ConfigFlag_LibIndex);
+  } break;
+
   case LNK_CmdSwitch_Rad_LinkVer: {
     lnk_cmd_switch_parse_version(obj, cmd_switch, value_strings, &config->link_ver);
   } break;
@@ -2212,6 +2244,30 @@ lnk_config_from_cmd_line(String8List raw_cmd_line, LNK_CmdLine cmd_line)
     config->import_table_emit_uiat = LNK_SwitchState_Yes;
   }
   
+  // order file is an explicit layout, profile is only a hint
+  if (config->order_file_path.size && config->order_profile_path.size) {
+    lnk_error_cmd_switch(LNK_Warning_Cmdl, 0, LNK_CmdSwitch_Rad_OrderProfile, "ignored because of /ORDER");
+    config->order_profile_path = str8_zero();
+  }
+
+  // incremental links patch the previous image in place, so they are limited to
+  // layouts that don't depend on contents of the other objs
+  if (config->incremental == LNK_SwitchState_Yes) {
+    if (config->opt_ref == LNK_SwitchState_Yes || config->opt_icf == LNK_SwitchState_Yes) {
+      lnk_error_cmd_switch(LNK_Warning_Cmdl, 0, LNK_CmdSwitch_Incremental, "ignored because of /OPT:REF or /OPT:ICF");
+      config->incremental = LNK_SwitchState_No;
+    } else if (config->guard_flags != LNK_Guard_None) {
+      lnk_error_cmd_switch(LNK_Warning_Cmdl, 0, LNK_CmdSwitch_Incremental, "ignored because of /GUARD");
+      config->incremental = LNK_SwitchState_No;
+    } else if (config->order_file_path.size || config->order_profile_path.size) {
+      lnk_error_cmd_switch(LNK_Warning_Cmdl, 0, LNK_CmdSwitch_Incremental, "ignored because of /ORDER or /RAD_ORDER_PROFILE");
+      config->incremental = LNK_SwitchState_No;
+    } else {
+      config->opt_ref = LNK_SwitchState_No;
+      config->opt_icf = LNK_SwitchState_No;
+    }
+  }
+
   // set flags for /OPT
   {
     // these flags remove and merge inline functions and methods defined in class,
@@ -2303,12 +2359,16 @@ lnk_config_from_cmd_line(String8List raw_cmd_line, LNK_CmdLine cmd_line)
     config->manifest_name = push_str8f(scratch.arena, "%S.manifest", config->out_path);
   }
 
+  // incremental link state is kept next to the image
+  config->incremental_name = path_replace_file_extension(scratch.arena, config->out_path, str8_lit("ilk"));
+
   // convert to full paths
-  config->out_path       = full_path_from_path(arena, config->out_path);
-  config->pdb_name       = full_path_from_path(arena, config->pdb_name);
-  config->rad_debug_name = full_path_from_path(arena, config->rad_debug_name);
-  config->imp_lib_name   = full_path_from_path(arena, config->imp_lib_name);
-  config->manifest_name  = full_path_from_path(arena, config->manifest_name);
+  config->out_path         = full_path_from_path(arena, config->out_path);
+  config->pdb_name         = full_path_from_path(arena, config->pdb_name);
+  config->rad_debug_name   = full_path_from_path(arena, config->rad_debug_name);
+  config->imp_lib_name     = full_path_from_path(arena, config->imp_lib_name);
+  config->manifest_name    = full_path_from_path(arena, config->manifest_name);
+  config->incremental_name = full_path_from_path(arena, config->incremental_name);
 
   // collect env vars
   HashTable *env_vars = hash_table_init(scratch.arena, 512);
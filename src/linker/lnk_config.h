@@ -57,6 +57,7 @@ typedef enum
   LNK_CmdSwitch_Ignore,
   LNK_CmdSwitch_ImpLib,
   LNK_CmdSwitch_Include,
+  LNK_CmdSwitch_Incremental,
   LNK_CmdSwitch_InferAsanLibs,
   LNK_CmdSwitch_InferAsanLibsNo,
   LNK_CmdSwitch_LargeAddressAware,
@@ -75,6 +76,7 @@ typedef enum
   LNK_CmdSwitch_NoImpLib,
   LNK_CmdSwitch_NxCompat,
   LNK_CmdSwitch_Opt,
+  LNK_CmdSwitch_Order,
   LNK_CmdSwitch_Out,
   LNK_CmdSwitch_Pdb,
   LNK_CmdSwitch_PdbAltPath,
@@ -104,6 +106,8 @@ typedef enum
   LNK_CmdSwitch_Rad_Ignore,
   LNK_CmdSwitch_Rad_ImageAltPath,
   LNK_CmdSwitch_Rad_LargePages,
+  LNK_CmdSwitch_Rad_LibCache,
+  LNK_CmdSwitch_Rad_LibIndex,
   LNK_CmdSwitch_Rad_LinkVer, 
   LNK_CmdSwitch_Rad_Log,
   LNK_CmdSwitch_Rad_Logo,
@@ -111,6 +115,7 @@ typedef enum
   LNK_CmdSwitch_Rad_MapLinesForUnresolvedSymbols,
   LNK_CmdSwitch_Rad_MemoryMapFiles,
   LNK_CmdSwitch_Rad_MtPath,
+  LNK_CmdSwitch_Rad_OrderProfile,
   LNK_CmdSwitch_Rad_OsVer,
   LNK_CmdSwitch_Rad_PageSize,
   LNK_CmdSwitch_Rad_PathStyle,
@@ -160,6 +165,7 @@ enum
   LNK_ConfigFlag_NoTsAware               = (1 << 6),
   LNK_ConfigFlag_WriteImageChecksum      = (1 << 8),
   LNK_ConfigFlag_ManifestEmbed           = (1 << 9),
+  LNK_ConfigFlag_LibIndex                = (1 << 10),
 };
 typedef U64 LNK_ConfigFlags;
 
@@ -272,6 +278,7 @@ typedef struct LNK_Config
   LNK_SwitchState             opt_icf;
   LNK_SwitchState             opt_lbr;
   U64                         opt_iter_count;
+  LNK_SwitchState             incremental;
   LNK_SwitchState             import_table_emit_biat;
   LNK_SwitchState             import_table_emit_uiat;
   LNK_GuardFlags              guard_flags;
@@ -315,6 +322,7 @@ typedef struct LNK_Config
   String8                     image_alt_path;
   String8                     imp_lib_name;
   String8List                 raw_cmd_line;
+  U128                        cmd_line_hash;
   String8                     pdb_name;
   String8                     pdb_alt_path;
   String8                     pdb_stripped_name;
@@ -338,6 +346,10 @@ typedef struct LNK_Config
   String8                     rad_chunk_map_name;
   String8                     rad_debug_name;
   String8                     rad_debug_alt_path;
+  String8                     incremental_name;
+  String8                     order_file_path;
+  String8                     order_profile_path;
+  String8                     lib_cache_dir;
   LNK_IncludeSymbolList       include_symbol_list;
   LNK_AltNameList             alt_name_list;
   LNK_MergeDirectiveList      merge_list;
@@ -267,6 +267,32 @@ THREAD_POOL_TASK_FUNC(lnk_read_type_servers_task)
   scratch_end(scratch);
 }
 
+internal Rng1U64 *
+lnk_make_symbol_input_ranges(Arena *arena, U64 symbol_input_count, LNK_SymbolInput *symbol_inputs, U64 worker_count)
+{
+  ProfBeginFunction();
+
+  U64 total_input_size = 0;
+  for EachIndex(i, symbol_input_count) { total_input_size += symbol_inputs[i].raw_symbols.size; }
+
+  U64      max_weight = CeilIntegerDiv(total_input_size, worker_count);
+  U64      cursor     = 0;
+  Rng1U64 *ranges     = push_array(arena, Rng1U64, worker_count);
+  for EachIndex(i, worker_count) {
+    if (cursor >= symbol_input_count) { break; }
+    U64 begin  = cursor;
+    U64 weight = 0;
+    for (; cursor < symbol_input_count; cursor += 1) {
+      if (weight >= max_weight) { break; }
+      weight += symbol_inputs[cursor].raw_symbols.size;
+    }
+    ranges[i] = r1u64(begin, cursor);
+  }
+
+  ProfEnd();
+  return ranges;
+}
+
 internal LNK_CodeViewInput
 lnk_make_code_view_input(TP_Context *tp, TP_Arena *tp_arena, LNK_Config *config, U64 obj_count, LNK_Obj **obj_arr)
 {
@@ -593,24 +619,7 @@ lnk_make_code_view_input(TP_Context *tp, TP_Arena *tp_arena, LNK_Config *config,
       }
     }
 
-    ProfBegin("Make Ranges");
-    U64 total_input_size = 0;
-    for EachIndex(i, input.symbol_input_count) { total_input_size += input.symbol_inputs[i].raw_symbols.size; }
-
-    U64 max_weight = CeilIntegerDiv(total_input_size, tp->worker_count);
-    U64 cursor     = 0;
-    input.symbol_input_ranges = push_array(tp_arena->v[0], Rng1U64, tp->worker_count);
-    for EachIndex(i, tp->worker_count) {
-      if (cursor >= input.symbol_input_count) { break; }
-      U64 begin  = cursor;
-      U64 weight = 0;
-      for (; cursor < input.symbol_input_count; cursor += 1) {
-        if (weight >= max_weight) { break; }
-        weight += input.symbol_inputs[cursor].raw_symbols.size;
-      }
-      input.symbol_input_ranges[i] = r1u64(begin, cursor);
-    }
-    ProfEnd();
+    input.symbol_input_ranges = lnk_make_symbol_input_ranges(tp_arena->v[0], input.symbol_input_count, input.symbol_inputs, tp->worker_count);
   }
   ProfEnd();
 
@@ -1672,6 +1681,11 @@ THREAD_POOL_TASK_FUNC(lnk_replace_type_names_with_hashes_lenient_task)
       if ((udt_info.props & CV_TypeProp_HasUniqueName) &&
            udt_info.unique_name.size > hash_max_chars &&
            udt_info.name.size > hash_max_chars) {
+        // leaves are shared with the RDI builder, replace names in a private copy
+        leaf_arr[leaf_idx] = push_str8_copy(arena, cv_raw_leaf_from_ptr(leaf_arr[leaf_idx])).str;
+        leaf               = cv_leaf_from_ptr(leaf_arr[leaf_idx]);
+        udt_info           = cv_get_udt_info(leaf.kind, leaf.data);
+
         // hash unique name
         U64 name_hash;
         blake3_hasher hasher; blake3_hasher_init(&hasher);
@@ -1758,6 +1772,11 @@ THREAD_POOL_TASK_FUNC(lnk_replace_type_names_with_hashes_full_task)
       CV_UDTInfo udt_info = cv_get_udt_info(leaf.kind, leaf.data);
 
       if (udt_info.name.size > hash_max_chars) {
+        // RDI may be reading the same leaf, edit a copy
+        leaf_arr[leaf_idx] = push_str8_copy(arena, cv_raw_leaf_from_ptr(leaf_arr[leaf_idx])).str;
+        leaf               = cv_leaf_from_ptr(leaf_arr[leaf_idx]);
+        udt_info           = cv_get_udt_info(leaf.kind, leaf.data);
+
         // pick name to hash
         String8 name;
         if (udt_info.props & CV_TypeProp_HasUniqueName) {
@@ -1858,7 +1877,7 @@ THREAD_POOL_TASK_FUNC(lnk_move_global_symbols_to_gsi)
   ProfBegin("Global Symbols");
   {
     VoidList global_symbols = {0};
-    for EachInRange(i, task->cv->symbol_input_ranges[task_id]) {
+    for EachInRange(i, task->symbol_input_ranges[task_id]) {
       LNK_SymbolInput symbols = task->cv->symbol_inputs[i];
       for (U64 cursor = 0, depth = 0; cursor + sizeof(CV_SymbolHeader) <= symbols.raw_symbols.size; ) {
         CV_Symbol symbol = {0};
@@ -2051,22 +2070,24 @@ THREAD_POOL_TASK_FUNC(lnk_move_global_symbols_to_gsi)
     tp_broadcast(&public_symbol_node_counts);
 
     // compute buffer size for CV public symbols
-    LNK_SymbolHashTrieChunkList symbol_chunks       = task->symtab->chunks[task_id];
-    U64                         public_symbol_size  = 0;
-    U64                         public_symbol_count = 0;
-    for EachNode(chunk, LNK_SymbolHashTrieChunk, symbol_chunks.first) {
-      for EachIndex(i, chunk->count) {
-        LNK_Symbol        *symbol        = chunk->v[i].symbol;
-        LNK_ObjSymbolRef   symbol_ref    = lnk_ref_from_symbol(symbol);
-        COFF_ParsedSymbol  symbol_parsed = lnk_parsed_from_symbol(symbol);
-
-        if (symbol_parsed.section_number == lnk_obj_get_removed_section_number(symbol_ref.obj)) { continue; }
-        COFF_SymbolValueInterpType symbol_interp = coff_interp_from_parsed_symbol(symbol_parsed);
-        if (symbol_interp != COFF_SymbolValueInterp_Regular) { continue; }
-
-        public_symbol_size  += AlignPow2(sizeof(CV_SymPub32) + symbol->name.size + 1, sizeof(void *));
-        public_symbol_count += 1;
-        public_symbol_node_counts[task_id] += 1;
+    Rng1U64 symbol_chunks_range = task->symbol_chunks_ranges[task_id];
+    U64     public_symbol_size  = 0;
+    U64     public_symbol_count = 0;
+    for EachInRange(chunks_idx, symbol_chunks_range) {
+      for EachNode(chunk, LNK_SymbolHashTrieChunk, task->symtab->chunks[chunks_idx].first) {
+        for EachIndex(i, chunk->count) {
+          LNK_Symbol        *symbol        = chunk->v[i].symbol;
+          LNK_ObjSymbolRef   symbol_ref    = lnk_ref_from_symbol(symbol);
+          COFF_ParsedSymbol  symbol_parsed = lnk_parsed_from_symbol(symbol);
+
+          if (symbol_parsed.section_number == lnk_obj_get_removed_section_number(symbol_ref.obj)) { continue; }
+          COFF_SymbolValueInterpType symbol_interp = coff_interp_from_parsed_symbol(symbol_parsed);
+          if (symbol_interp != COFF_SymbolValueInterp_Regular) { continue; }
+
+          public_symbol_size  += AlignPow2(sizeof(CV_SymPub32) + symbol->name.size + 1, sizeof(void *));
+          public_symbol_count += 1;
+          public_symbol_node_counts[task_id] += 1;
+        }
       }
     }
     public_symbol_sizes      [task_id] += public_symbol_size;
@@ -2093,21 +2114,23 @@ THREAD_POOL_TASK_FUNC(lnk_move_global_symbols_to_gsi)
     Arena         *public_symbol_arena      = public_symbol_arenas     [task_id];
     Arena         *public_symbol_node_arena = public_symbol_node_arenas[task_id];
     CV_SymbolList *public_symbol_list       = &public_symbols          [task_id];
-    for EachNode(chunk, LNK_SymbolHashTrieChunk, symbol_chunks.first) {
-      for EachIndex(i, chunk->count) {
-        LNK_Symbol        *symbol        = chunk->v[i].symbol;
-        LNK_ObjSymbolRef   symbol_ref    = lnk_ref_from_symbol(symbol);
-        COFF_ParsedSymbol  symbol_parsed = lnk_parsed_from_symbol(symbol);
-
-        // discard removed and non-section symbols
-        if (symbol_parsed.section_number == lnk_obj_get_removed_section_number(symbol_ref.obj)) { continue; }
-        COFF_SymbolValueInterpType symbol_interp = coff_interp_from_parsed_symbol(symbol_parsed);
-        if (symbol_interp != COFF_SymbolValueInterp_Regular) { continue; }
-
-        CV_Pub32Flags flags      = COFF_SymbolType_IsFunc(symbol_parsed.type) ? CV_Pub32Flag_Function : 0;
-        ISectOff      sc         = lnk_sc_from_symbol(symbol);
-        CV_Symbol     pub_symbol = cv_make_pub32(public_symbol_arena, flags, safe_cast_u32(sc.off), safe_cast_u16(sc.isect), symbol->name);
-        cv_symbol_list_push(public_symbol_node_arena, public_symbol_list, pub_symbol);
+    for EachInRange(chunks_idx, symbol_chunks_range) {
+      for EachNode(chunk, LNK_SymbolHashTrieChunk, task->symtab->chunks[chunks_idx].first) {
+        for EachIndex(i, chunk->count) {
+          LNK_Symbol        *symbol        = chunk->v[i].symbol;
+          LNK_ObjSymbolRef   symbol_ref    = lnk_ref_from_symbol(symbol);
+          COFF_ParsedSymbol  symbol_parsed = lnk_parsed_from_symbol(symbol);
+
+          // discard removed and non-section symbols
+          if (symbol_parsed.section_number == lnk_obj_get_removed_section_number(symbol_ref.obj)) { continue; }
+          COFF_SymbolValueInterpType symbol_interp = coff_interp_from_parsed_symbol(symbol_parsed);
+          if (symbol_interp != COFF_SymbolValueInterp_Regular) { continue; }
+
+          CV_Pub32Flags flags      = COFF_SymbolType_IsFunc(symbol_parsed.type) ? CV_Pub32Flag_Function : 0;
+          ISectOff      sc         = lnk_sc_from_symbol(symbol);
+          CV_Symbol     pub_symbol = cv_make_pub32(public_symbol_arena, flags, safe_cast_u32(sc.off), safe_cast_u16(sc.isect), symbol->name);
+          cv_symbol_list_push(public_symbol_node_arena, public_symbol_list, pub_symbol);
+        }
       }
     }
     barrier_wait(tp->barrier);
@@ -2485,6 +2508,12 @@ lnk_build_pdb(TP_Context *tp, TP_Arena *tp_arena, String8 image_data, LNK_Config
   // set min type indices
   for EachElement(ti_source, cv_types.min_type_indices) { task.pdb->type_servers[ti_source]->ti_lo = cv_types.min_type_indices[ti_source]; }
 
+  // per worker symbol inputs, split for this pool; PDB may be built on fewer workers than merged types
+  task.symbol_input_ranges = lnk_make_symbol_input_ranges(scratch.arena, cv->symbol_input_count, cv->symbol_inputs, tp->worker_count);
+
+  // per worker symbol table chunks, the table is split for the linker's pool
+  task.symbol_chunks_ranges = tp_divide_work(scratch.arena, symtab->arena->count, tp->worker_count);
+
   // per worker obj indices
   {
     U64 objs_per_worker = CeilIntegerDiv(cv->obj_count, tp->worker_count);
@@ -3733,7 +3762,8 @@ THREAD_POOL_TASK_FUNC(lnk_find_obj_compiler_info_task)
   // infer unit compiler data from S_COMPILE* which always follows S_OBJ
   for EachNode(n, String8Node, symbols.first) {
     for (U64 cursor = 0; cursor < n->string.size; ) {
-      CV_Symbol symbol = {0}; NotImplemented; // TODO: @symbol_pass
+      CV_Symbol symbol = {0};
+      TryReadBreak(cv_read_symbol(n->string, cursor, CV_SymbolAlign, &symbol), cursor);
       if (symbol.kind == CV_SymKind_COMPILE) {
         AssertAlways(sizeof(CV_SymCompile) <= symbol.data.size);
         CV_SymCompile *compile = (CV_SymCompile *)symbol.data.str;
@@ -139,6 +139,8 @@ typedef struct
   CV_StringHashTable   string_ht;
   PDB_DbiModule      **mod_arr;     // [obj_count]
   U32Array            *obj_indices; // [obj_count]
+  Rng1U64             *symbol_input_ranges;  // [worker_count]
+  Rng1U64             *symbol_chunks_ranges; // [worker_count]
 
   U64 symbol_count;
 
@@ -279,7 +281,8 @@ typedef struct
 ////////////////////////////////
 // CodeView
 
-internal LNK_CodeViewInput lnk_make_code_view_input(TP_Context *tp, TP_Arena *tp_arena, LNK_Config *config, U64 objs_count, LNK_Obj **objs);
+internal Rng1U64 *         lnk_make_symbol_input_ranges(Arena *arena, U64 symbol_input_count, LNK_SymbolInput *symbol_inputs, U64 worker_count);
+internal LNK_CodeViewInput lnk_make_code_view_input    (TP_Context *tp, TP_Arena *tp_arena, LNK_Config *config, U64 objs_count, LNK_Obj **objs);
 
 internal int             lnk_leaf_ref_compare                (LNK_LeafRef a, LNK_LeafRef b);
 internal int             lnk_leaf_ref_is_before              (void *raw_a, void *raw_b);
@@ -71,23 +71,24 @@ lnk_lib_from_data(Arena *arena, String8 data, String8 path, U64 input_idx, LNK_L
     
     symbol_count = first_member.symbol_count;
     
-    // convert big endian offsets
+    // convert big endian offsets, lib data is left untouched so it can be hashed for the cache
+    U32 *first_member_offsets = push_array_no_zero(scratch.arena, U32, symbol_count);
     for (U32 offset_idx = 0; offset_idx < symbol_count; offset_idx += 1) {
-      first_member.member_offsets[offset_idx] = from_be_u32(first_member.member_offsets[offset_idx]);
+      first_member_offsets[offset_idx] = from_be_u32(first_member.member_offsets[offset_idx]);
     }
 
     // compress member offsets to match those from the second header
     {
       HashTable *member_off_ht = hash_table_init(scratch.arena, (U64)((F64)first_member.symbol_count * 1.3));
       for EachIndex(symbol_idx, symbol_count) {
-        if (!hash_table_search_u32_u32(member_off_ht, first_member.member_offsets[symbol_idx], 0)) {
-          hash_table_push_u32_u32(scratch.arena, member_off_ht, first_member.member_offsets[symbol_idx], member_off_ht->count);
+        if (!hash_table_search_u32_u32(member_off_ht, first_member_offsets[symbol_idx], 0)) {
+          hash_table_push_u32_u32(scratch.arena, member_off_ht, first_member_offsets[symbol_idx], member_off_ht->count);
         }
       }
 
       symbol_indices = push_array(arena, U16, first_member.symbol_count);
       for EachIndex(symbol_idx, first_member.symbol_count) {
-        U32 member_off = first_member.member_offsets[symbol_idx];
+        U32 member_off = first_member_offsets[symbol_idx];
         U32 member_off_idx = 0;
         if (!hash_table_search_u32_u32(member_off_ht, member_off, &member_off_idx)) {
           InvalidPath;
@@ -115,24 +116,16 @@ lnk_lib_from_data(Arena *arena, String8 data, String8 path, U64 input_idx, LNK_L
         symbol_names = str8_array_from_list(arena, &symbol_name_list);
         scratch_end(scratch);
       }
-
-      // sort lexically symbol names
-      LNK_FirstMemberSortKey *sort_keys = push_array_no_zero(scratch.arena, LNK_FirstMemberSortKey, first_member.symbol_count);
-      for EachIndex(symbol_idx, first_member.symbol_count) {
-        sort_keys[symbol_idx].symbol_name    = symbol_names.v[symbol_idx];
-        sort_keys[symbol_idx].member_off_idx = symbol_indices[symbol_idx];
-      }
-      radsort(sort_keys, first_member.symbol_count, lnk_first_member_sort_key_is_before);
-
-      for EachIndex(symbol_idx, first_member.symbol_count) {
-        symbol_names.v[symbol_idx] = sort_keys[symbol_idx].symbol_name;
-        symbol_indices[symbol_idx] = sort_keys[symbol_idx].member_off_idx;
-      }
     }
 
     scratch_end(scratch);
   }
   
+  U64 *symbol_hashes = push_array_no_zero(arena, U64, symbol_names.count);
+  for EachIndex(symbol_idx, symbol_names.count) {
+    symbol_hashes[symbol_idx] = u64_hash_from_str8(symbol_names.v[symbol_idx]);
+  }
+
   // init lib
   lib_out->path              = push_str8_copy(arena, path);
   lib_out->data              = data;
@@ -142,6 +135,7 @@ lnk_lib_from_data(Arena *arena, String8 data, String8 path, U64 input_idx, LNK_L
   lib_out->member_offsets    = member_offsets;
   lib_out->symbol_indices    = symbol_indices;
   lib_out->symbol_names      = symbol_names;
+  lib_out->symbol_hashes     = symbol_hashes;
   lib_out->long_names        = parse.long_names;
   lib_out->input_idx         = input_idx;
   
@@ -157,8 +151,48 @@ THREAD_POOL_TASK_FUNC(lnk_lib_initer)
   U64          lib_node_idx = ins_atomic_u64_inc_eval(&task->next_free_lib_idx)-1;
   LNK_LibNode *lib_node     = &task->free_libs[lib_node_idx];
 
-  B32 is_valid_lib = lnk_lib_from_data(arena, input->data, input->path, task->lib_id_base + task_id, &lib_node->data);
+  LNK_Lib *lib          = &lib_node->data;
+  U64      lib_input_idx = task->lib_id_base + task_id;
+  B32      is_valid_lib  = 0;
+
+  // try to load symbol index from the cache
+  String8 cache_path   = {0};
+  U64     lib_modified = 0;
+  if (task->cache_dir.size) {
+    lib_modified = properties_from_file_path(input->path).modified;
+    if (lib_modified) {
+      cache_path    = lnk_lib_cache_path(arena, task->cache_dir, input->path, input->data.size, lib_modified);
+      String8 cache = lnk_lib_cache_data_from_path(arena, task->io_flags, cache_path);
+      is_valid_lib  = lnk_lib_from_cache(arena, cache, input->data, input->path, lib_modified, lib_input_idx, lib);
+      if (is_valid_lib) {
+        ins_atomic_u64_inc_eval(&task->cache_hits_count);
+      } else if (cache.size) {
+        // stale or corrupt entry, replace it with a fresh one
+        if (task->io_flags & LNK_IO_Flags_MemoryMapFiles) {
+          file_map_view_close((FileMap){0}, cache.str, r1u64(0, cache.size));
+        }
+        delete_file_at_path(cache_path);
+      }
+    }
+  }
+
+  if (!is_valid_lib) {
+    is_valid_lib = lnk_lib_from_data(arena, input->data, input->path, lib_input_idx, lib);
+    if (is_valid_lib && cache_path.size) {
+      Temp scratch = scratch_begin(&arena, 1);
+      String8List cache = lnk_lib_cache_from_lib(scratch.arena, lib, lib_modified);
+      if (cache.total_size && lnk_lib_cache_write(cache_path, cache)) {
+        ins_atomic_u64_inc_eval(&task->cache_writes_count);
+      }
+      scratch_end(scratch);
+    }
+  }
+
   if (is_valid_lib) {
+    for EachIndex(symbol_idx, lib->symbol_count) {
+      lnk_lib_index_insert(arena, task->index, lib, lib->symbol_hashes[symbol_idx], lib->symbol_names.v[symbol_idx], lib->symbol_indices[symbol_idx]-1);
+    }
+
     U64 valid_lib_idx = ins_atomic_u64_inc_eval(&task->valid_libs_count)-1;
     task->valid_libs[valid_lib_idx] = lib_node;
   } else {
@@ -186,14 +220,21 @@ lnk_lib_list_push_node(LNK_LibList *list, LNK_LibNode *node)
 }
 
 internal LNK_LibNodeArray
-lnk_lib_list_push_parallel(TP_Context *tp, TP_Arena *arena, LNK_LibList *list, U64 inputs_count, LNK_Input **inputs)
+lnk_lib_list_push_parallel(TP_Context *tp, TP_Arena *arena, LNK_LibList *list, LNK_LibIndex *index, String8 cache_dir, LNK_IO_Flags io_flags, U64 inputs_count, LNK_Input **inputs)
 {
   Temp scratch = scratch_begin(arena->v, arena->count);
 
   U64 lib_id_base = list->count;
 
+  if (cache_dir.size) {
+    make_directory(cache_dir);
+  }
+
   // parse libs in parallel
   LNK_LibIniter task = {0};
+  task.index         = index;
+  task.cache_dir     = cache_dir;
+  task.io_flags      = io_flags;
   task.lib_id_base   = list->count;
   task.free_libs     = push_array(arena->v[0], LNK_LibNode, inputs_count);
   task.valid_libs    = push_array(scratch.arena, LNK_LibNode *, inputs_count);
@@ -201,6 +242,10 @@ lnk_lib_list_push_parallel(TP_Context *tp, TP_Arena *arena, LNK_LibList *list, U
   task.inputs        = inputs;
   tp_for_parallel(tp, arena, inputs_count, lnk_lib_initer, &task);
 
+  if (cache_dir.size && inputs_count) {
+    lnk_log(LNK_Log_InputLib, "[ Lib Cache: %llu Hits, %llu Written, %llu Libs ]", task.cache_hits_count, task.cache_writes_count, inputs_count);
+  }
+
   // report invalid libs
   radsort(task.invalid_libs, task.invalid_libs_count, lnk_lib_node_ptr_is_before);
   for EachIndex(i, task.invalid_libs_count) {
@@ -220,16 +265,273 @@ lnk_lib_list_push_parallel(TP_Context *tp, TP_Arena *arena, LNK_LibList *list, U
   return result;
 }
 
+internal void
+lnk_lib_index_insert(Arena *arena, LNK_LibIndex *index, LNK_Lib *lib, U64 hash, String8 name, U32 member_idx)
+{
+  // find or insert node for the symbol name
+  LNK_LibSymbolHashTrie  *new_node = 0;
+  LNK_LibSymbolHashTrie  *node     = 0;
+  LNK_LibSymbolHashTrie **node_ptr = &index->root;
+  for (U64 h = hash; ; h <<= 2) {
+    node = ins_atomic_ptr_eval(node_ptr);
+
+    if (node == 0) {
+      if (new_node == 0) {
+        new_node       = push_array(arena, LNK_LibSymbolHashTrie, 1);
+        new_node->hash = hash;
+        new_node->name = name;
+      }
+
+      // try to insert new node, on failure descend into node from another thread
+      node = ins_atomic_ptr_eval_cond_assign(node_ptr, new_node, 0);
+      if (node == 0) {
+        ins_atomic_u64_inc_eval(&index->names_count);
+        node = new_node;
+        break;
+      }
+    }
+
+    // compare hashes first, so walking the trie doesn't touch names in lib data
+    if (node->hash == hash && str8_match(node->name, name, 0)) {
+      break;
+    }
+
+    node_ptr = node->child + (h >> 62);
+  }
+
+  // insert definition in the link order, nodes are never removed so it is safe to
+  // walk the list while other threads are inserting
+  LNK_LibSymbolDefn *new_defn = 0;
+  for (LNK_LibSymbolDefn **defn_ptr = &node->defns;;) {
+    LNK_LibSymbolDefn *curr = ins_atomic_ptr_eval(defn_ptr);
+
+    if (curr && curr->lib->input_idx <= lib->input_idx) {
+      // symbol is defined more than once in the same lib -- first member takes precedence
+      if (curr->lib == lib) {
+        break;
+      }
+      defn_ptr = &curr->next;
+      continue;
+    }
+
+    if (new_defn == 0) {
+      new_defn             = push_array(arena, LNK_LibSymbolDefn, 1);
+      new_defn->lib        = lib;
+      new_defn->member_idx = member_idx;
+    }
+    new_defn->next = curr;
+
+    if (ins_atomic_ptr_eval_cond_assign(defn_ptr, new_defn, curr) == curr) {
+      ins_atomic_u64_inc_eval(&index->defns_count);
+      break;
+    }
+  }
+}
+
+internal LNK_LibSymbolDefn *
+lnk_lib_index_search(LNK_LibIndex *index, String8 name)
+{
+  U64                    hash = u64_hash_from_str8(name);
+  LNK_LibSymbolHashTrie *node = index->root;
+  for (U64 h = hash; node != 0; h <<= 2) {
+    if (node->hash == hash && str8_match(node->name, name, 0)) {
+      return node->defns;
+    }
+    node = node->child[h >> 62];
+  }
+  return 0;
+}
+
+internal void
+lnk_lib_sort_symbols(Arena *arena, LNK_Lib *lib)
+{
+  Temp scratch = scratch_begin(&arena, 1);
+
+  // sort lexically symbol names
+  LNK_FirstMemberSortKey *sort_keys = push_array_no_zero(scratch.arena, LNK_FirstMemberSortKey, lib->symbol_count);
+  for EachIndex(symbol_idx, lib->symbol_count) {
+    sort_keys[symbol_idx].symbol_name    = lib->symbol_names.v[symbol_idx];
+    sort_keys[symbol_idx].member_off_idx = lib->symbol_indices[symbol_idx];
+  }
+  radsort(sort_keys, lib->symbol_count, lnk_first_member_sort_key_is_before);
+
+  lib->sorted_symbol_names.count = lib->symbol_count;
+  lib->sorted_symbol_names.v     = push_array_no_zero(arena, String8, lib->symbol_count);
+  lib->sorted_symbol_indices     = push_array_no_zero(arena, U16, lib->symbol_count);
+  for EachIndex(symbol_idx, lib->symbol_count) {
+    lib->sorted_symbol_names.v[symbol_idx] = sort_keys[symbol_idx].symbol_name;
+    lib->sorted_symbol_indices[symbol_idx] = sort_keys[symbol_idx].member_off_idx;
+  }
+
+  scratch_end(scratch);
+}
+
 internal force_inline B32
-lnk_search_lib(LNK_Lib *lib, String8 symbol_name, U32 *member_idx_out)
+lnk_search_lib_sorted(LNK_Lib *lib, String8 symbol_name, U32 *member_idx_out)
 {
-  U64 symbol_idx = str8_array_bsearch(lib->symbol_names, symbol_name);
+  U64 symbol_idx = str8_array_bsearch(lib->sorted_symbol_names, symbol_name);
   if (symbol_idx < lib->symbol_count) {
     if (member_idx_out) {
-      *member_idx_out = lib->symbol_indices[symbol_idx]-1;
+      *member_idx_out = lib->sorted_symbol_indices[symbol_idx]-1;
     }
     return 1;
   }
   return 0;
 }
 
+internal String8
+lnk_lib_cache_path(Arena *arena, String8 cache_dir, String8 lib_path, U64 lib_size, U64 lib_modified)
+{
+  Temp scratch = scratch_begin(&arena, 1);
+  String8 key  = push_str8f(scratch.arena, "%S\n%llu\n%llu", lib_path, lib_size, lib_modified);
+  U128    hash = u128_hash_from_str8(key);
+  String8 path = push_str8f(arena, "%S/%016llx%016llx.rlc", cache_dir, hash.u64[1], hash.u64[0]);
+  scratch_end(scratch);
+  return path;
+}
+
+internal String8
+lnk_lib_cache_data_from_path(Arena *arena, LNK_IO_Flags io_flags, String8 cache_path)
+{
+  String8 data = {0};
+  if (io_flags & LNK_IO_Flags_MemoryMapFiles) {
+    File file = file_open(AccessFlag_Read|AccessFlag_ShareRead, cache_path);
+    if (!file_match(file, file_zero())) {
+      U64     size = properties_from_file(file).size;
+      FileMap map  = file_map_open(AccessFlag_Read, file);
+      if (size) {
+        void *view = file_map_view_open(map, AccessFlag_Read, r1u64(0, size));
+        if (view) {
+          data = str8(view, size);
+        }
+      }
+      file_map_close(map);
+      file_close(file);
+    }
+  } else {
+    data = data_from_file_path(arena, cache_path);
+  }
+  return data;
+}
+
+internal B32
+lnk_lib_from_cache(Arena *arena, String8 cache, String8 data, String8 path, U64 lib_modified, U64 input_idx, LNK_Lib *lib_out)
+{
+  if (cache.size < sizeof(LNK_LibCacheHeader)) { return 0; }
+
+  LNK_LibCacheHeader *header = (LNK_LibCacheHeader *)cache.str;
+  if (header->magic != LNK_LIB_CACHE_MAGIC || header->version != LNK_LIB_CACHE_VERSION) { return 0; }
+  if (header->lib_size != data.size || header->lib_modified != lib_modified)             { return 0; }
+  if (header->linker_members_size > data.size)                                           { return 0; }
+  if (header->long_names_off + header->long_names_size > header->linker_members_size)    { return 0; }
+
+  U64 arrays_size = (U64)header->member_count * sizeof(U32) + (U64)header->symbol_count * (sizeof(U64) + sizeof(U32) * 2 + sizeof(U16));
+  if (cache.size < sizeof(*header) + arrays_size) { return 0; }
+
+  U128 payload_hash = u128_hash_from_str8(str8(cache.str + sizeof(*header), arrays_size));
+  if (!u128_match(payload_hash, header->payload_hash)) { return 0; }
+
+  // symbol names point into the linker members, make sure they are the same bytes the index was built from
+  U128 linker_members_hash = u128_hash_from_str8(str8_prefix(data, header->linker_members_size));
+  if (!u128_match(linker_members_hash, header->linker_members_hash)) { return 0; }
+
+  U64 *symbol_hashes  = (U64 *)(header + 1);
+  U32 *member_offsets = (U32 *)(symbol_hashes + header->symbol_count);
+  U32 *name_offs      = member_offsets + header->member_count;
+  U32 *name_sizes     = name_offs + header->symbol_count;
+  U16 *symbol_indices = (U16 *)(name_sizes + header->symbol_count);
+
+  String8Array symbol_names = {0};
+  symbol_names.count        = header->symbol_count;
+  symbol_names.v            = push_array_no_zero(arena, String8, header->symbol_count);
+  for EachIndex(symbol_idx, header->symbol_count) {
+    if ((U64)name_offs[symbol_idx] + name_sizes[symbol_idx] > header->linker_members_size) { return 0; }
+    if (symbol_indices[symbol_idx] == 0 || symbol_indices[symbol_idx] > header->member_count) { return 0; }
+    symbol_names.v[symbol_idx] = str8(data.str + name_offs[symbol_idx], name_sizes[symbol_idx]);
+  }
+
+  lib_out->path           = push_str8_copy(arena, path);
+  lib_out->data           = data;
+  lib_out->type           = (COFF_ArchiveType)header->type;
+  lib_out->member_count   = header->member_count;
+  lib_out->symbol_count   = header->symbol_count;
+  lib_out->member_offsets = member_offsets;
+  lib_out->symbol_indices = symbol_indices;
+  lib_out->symbol_names   = symbol_names;
+  lib_out->symbol_hashes  = symbol_hashes;
+  lib_out->long_names     = str8(data.str + header->long_names_off, header->long_names_size);
+  lib_out->input_idx      = input_idx;
+
+  return 1;
+}
+
+internal String8List
+lnk_lib_cache_from_lib(Arena *arena, LNK_Lib *lib, U64 lib_modified)
+{
+  String8List result = {0};
+
+  // offsets are stored as 32-bit values
+  if (lib->data.size > max_U32) { goto exit; }
+
+  U64 linker_members_size = lib->data.size;
+  for EachIndex(member_idx, lib->member_count) {
+    linker_members_size = Min(linker_members_size, lib->member_offsets[member_idx]);
+  }
+
+  U32 *name_offs  = push_array_no_zero(arena, U32, lib->symbol_count);
+  U32 *name_sizes = push_array_no_zero(arena, U32, lib->symbol_count);
+  for EachIndex(symbol_idx, lib->symbol_count) {
+    String8 name = lib->symbol_names.v[symbol_idx];
+    U64     off  = (U64)(name.str - lib->data.str);
+    if (name.str < lib->data.str || off + name.size > linker_members_size) { goto exit; }
+    name_offs[symbol_idx]  = (U32)off;
+    name_sizes[symbol_idx] = (U32)name.size;
+  }
+
+  String8List payload = {0};
+  str8_list_push(arena, &payload, str8_array(lib->symbol_hashes, lib->symbol_count));
+  str8_list_push(arena, &payload, str8_array(lib->member_offsets, lib->member_count));
+  str8_list_push(arena, &payload, str8_array(name_offs, lib->symbol_count));
+  str8_list_push(arena, &payload, str8_array(name_sizes, lib->symbol_count));
+  str8_list_push(arena, &payload, str8_array(lib->symbol_indices, lib->symbol_count));
+  String8 payload_data = str8_list_join(arena, &payload, 0);
+
+  LNK_LibCacheHeader *header  = push_array(arena, LNK_LibCacheHeader, 1);
+  header->magic               = LNK_LIB_CACHE_MAGIC;
+  header->version             = LNK_LIB_CACHE_VERSION;
+  header->type                = lib->type;
+  header->lib_size            = lib->data.size;
+  header->lib_modified        = lib_modified;
+  header->linker_members_size = linker_members_size;
+  header->linker_members_hash = u128_hash_from_str8(str8_prefix(lib->data, linker_members_size));
+  header->long_names_off      = lib->long_names.size ? (U64)(lib->long_names.str - lib->data.str) : 0;
+  header->long_names_size     = lib->long_names.size;
+  header->member_count        = lib->member_count;
+  header->symbol_count        = lib->symbol_count;
+  header->payload_hash        = u128_hash_from_str8(payload_data);
+
+  str8_list_push(arena, &result, str8_struct(header));
+  str8_list_push(arena, &result, payload_data);
+
+  exit:;
+  return result;
+}
+
+internal B32
+lnk_lib_cache_write(String8 cache_path, String8List cache)
+{
+  Temp scratch = scratch_begin(0, 0);
+
+  // write under a unique name and rename, so concurrent links never read a partially written entry
+  String8 temp_path  = push_str8f(scratch.arena, "%S.%x.%llx.tmp", cache_path, tid(), now_time_us());
+  B32     is_written = write_data_list_to_file_path(temp_path, cache);
+  if (is_written) {
+    is_written = move_file_path(cache_path, temp_path);
+  }
+  if (!is_written) {
+    delete_file_at_path(temp_path);
+  }
+
+  scratch_end(scratch);
+  return is_written;
+}
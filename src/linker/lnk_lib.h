@@ -3,18 +3,29 @@
 
 #pragma once
 
+typedef struct LNK_LibSearchCandidate
+{
+  struct LNK_LibSearchCandidate *next;
+  LNK_SymbolHashTrie            *slot;       // symbol table slot, so the search sees latest symbol with this name
+  U32                            member_idx;
+} LNK_LibSearchCandidate;
+
 typedef struct LNK_Lib
 {
-  String8              path;
-  String8              data;
-  COFF_ArchiveType     type;
-  U32                  member_count;
-  U32                  symbol_count;
-  U32                 *member_offsets;
-  U16                 *symbol_indices;
-  String8Array         symbol_names;
-  String8              long_names;
-  U64                  input_idx;
+  String8                 path;
+  String8                 data;
+  COFF_ArchiveType        type;
+  U32                     member_count;
+  U32                     symbol_count;
+  U32                    *member_offsets;
+  U16                    *symbol_indices;
+  String8Array            symbol_names;
+  U64                    *symbol_hashes;     // hashes of symbol names for the archive symbol index
+  String8                 long_names;
+  U64                     input_idx;
+  LNK_LibSearchCandidate *search_candidates; // undefined and weak symbols that one of the lib's members may define
+  String8Array            sorted_symbol_names; // symbol names in lexical order, built on first search with /RAD_LIB_INDEX:NO
+  U16                    *sorted_symbol_indices;
 } LNK_Lib;
  
 typedef struct LNK_LibNode
@@ -36,16 +47,74 @@ typedef struct LNK_LibList
   LNK_LibNode *last;
 } LNK_LibList;
 
+// --- Archive Symbol Index ----------------------------------------------------
+
+typedef struct LNK_LibSymbolDefn
+{
+  struct LNK_LibSymbolDefn *next;       // same symbol in a lib that comes later in the link order
+  struct LNK_Lib           *lib;
+  U32                       member_idx;
+} LNK_LibSymbolDefn;
+
+typedef struct LNK_LibSymbolHashTrie
+{
+  U64                           hash;
+  String8                       name;
+  LNK_LibSymbolDefn            *defns;   // sorted on lib input index, first definition takes precedence
+  struct LNK_LibSymbolHashTrie *child[4];
+} LNK_LibSymbolHashTrie;
+
+typedef struct LNK_LibIndex
+{
+  LNK_LibSymbolHashTrie *root;
+  U64                    names_count;
+  U64                    defns_count;
+} LNK_LibIndex;
+
 typedef struct LNK_FirstMemberSortKey
 {
   String8 symbol_name;
   U16     member_off_idx;
 } LNK_FirstMemberSortKey;
 
+// --- Archive Index Cache -----------------------------------------------------
+
+#define LNK_LIB_CACHE_MAGIC   0x4548434142494c52ull // "RLIBACHE"
+#define LNK_LIB_CACHE_VERSION 2
+
+// cache file layout:
+//  header
+//  U64 symbol_hashes[symbol_count]
+//  U32 member_offsets[member_count]
+//  U32 name_offs[symbol_count]        offset of the symbol name in lib data
+//  U32 name_sizes[symbol_count]
+//  U16 symbol_indices[symbol_count]
+// payload_hash covers the arrays, so a damaged entry that keeps its size is rejected too
+typedef struct LNK_LibCacheHeader
+{
+  U64  magic;
+  U32  version;
+  U32  type;
+  U64  lib_size;
+  U64  lib_modified;
+  U64  linker_members_size; // size of lib data that precedes the first regular member
+  U128 linker_members_hash;
+  U64  long_names_off;
+  U64  long_names_size;
+  U32  member_count;
+  U32  symbol_count;
+  U128 payload_hash;
+} LNK_LibCacheHeader;
+
 // --- Workers Contexts --------------------------------------------------------
  
 typedef struct
 {
+  LNK_LibIndex       *index;
+  String8             cache_dir;
+  LNK_IO_Flags        io_flags;
+  U64                 cache_hits_count;
+  U64                 cache_writes_count;
   struct LNK_Input  **inputs;
   U64                 lib_id_base;
   U64                 next_free_lib_idx;
@@ -64,7 +133,17 @@ internal int lnk_lib_node_ptr_is_before(void *raw_a, void *raw_b);
 internal B32              lnk_lib_from_data(Arena *arena, String8 data, String8 path, U64 input_idx, LNK_Lib *lib_out);
 internal LNK_Lib **       lnk_array_from_lib_list(Arena *arena, LNK_LibList list);
 internal void             lnk_lib_list_push_node(LNK_LibList *list, LNK_LibNode *node);
-internal LNK_LibNodeArray lnk_lib_list_push_parallel(TP_Context *tp, TP_Arena *arena, LNK_LibList *list, U64 inputs_count, struct LNK_Input **inputs);
+internal LNK_LibNodeArray lnk_lib_list_push_parallel(TP_Context *tp, TP_Arena *arena, LNK_LibList *list, LNK_LibIndex *index, String8 cache_dir, LNK_IO_Flags io_flags, U64 inputs_count, struct LNK_Input **inputs);
+
+internal void                lnk_lib_index_insert(Arena *arena, LNK_LibIndex *index, LNK_Lib *lib, U64 hash, String8 name, U32 member_idx);
+internal LNK_LibSymbolDefn * lnk_lib_index_search(LNK_LibIndex *index, String8 name);
+
+internal void              lnk_lib_sort_symbols(Arena *arena, LNK_Lib *lib);
+internal force_inline B32  lnk_search_lib_sorted(LNK_Lib *lib, String8 symbol_name, U32 *member_idx_out);
 
-internal force_inline B32 lnk_search_lib(LNK_Lib *lib, String8 symbol_name, U32 *member_idx_out);
+internal String8     lnk_lib_cache_path(Arena *arena, String8 cache_dir, String8 lib_path, U64 lib_size, U64 lib_modified);
+internal String8     lnk_lib_cache_data_from_path(Arena *arena, LNK_IO_Flags io_flags, String8 cache_path);
+internal B32         lnk_lib_from_cache(Arena *arena, String8 cache, String8 data, String8 path, U64 lib_modified, U64 input_idx, LNK_Lib *lib_out);
+internal String8List lnk_lib_cache_from_lib(Arena *arena, LNK_Lib *lib, U64 lib_modified);
+internal B32         lnk_lib_cache_write(String8 cache_path, String8List cache);
 
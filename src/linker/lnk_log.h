@@ -15,6 +15,7 @@ typedef enum
   LNK_Log_LinkStats,
   LNK_Log_Timers,
   LNK_Log_Links, 
+  LNK_Log_Incremental,
   LNK_Log_Count
 } LNK_LogType;
 
@@ -111,6 +112,7 @@ typedef enum
   LNK_Warning_GHash,
   LNK_Warning_UndefinedSectionSymbol,
   LNK_Warning_CyclicSymbol,
+  LNK_Warning_Order,
   LNK_Warning_Last,
   
   LNK_Error_Count
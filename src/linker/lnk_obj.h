@@ -5,6 +5,12 @@
 
 // --- Input -------------------------------------------------------------------
 
+typedef struct LNK_ObjSectionRef
+{
+  struct LNK_Obj *obj;
+  U32             section_number;
+} LNK_ObjSectionRef;
+
 typedef struct LNK_Obj
 {
   String8                  path;
@@ -16,6 +22,7 @@ typedef struct LNK_Obj
   B8                       exclude_from_debug_info;
   U32Node                **associated_sections;
   LNK_SymbolHashTrie     **symlinks;
+  LNK_ObjSectionRef       *folds; // section number -> section it was folded into by /OPT:ICF
   struct LNK_LibMemberRef *link_member;
   struct LNK_ObjNode      *self;
 } LNK_Obj;
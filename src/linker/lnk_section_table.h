@@ -23,6 +23,7 @@ typedef struct LNK_SectionContrib
   } u;
   U16 align; // contribution alignment in the image
   B8 hotpatch;
+  U32 reserve; // bytes left free after the contribution, so an incremental link can grow it in place
 } LNK_SectionContrib;
 
 typedef struct LNK_SectionContribChunk
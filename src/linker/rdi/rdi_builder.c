@@ -4307,7 +4307,7 @@ rdib_data_sections_from_scopes(TP_Context            *tp,
 
   str8_list_push(arena->v[0], &scopes_sect.data,      str8_array(task.scopes_rdi,      total_scope_count     ));
   str8_list_push(arena->v[0], &scope_voffs_sect.data, str8_array(task.scope_voffs_rdi, total_scope_voff_count));
-  str8_list_push(arena->v[0], &locals_sect.data,      str8_array(task.locals_rdi,      total_local_count     ));
+  //str8_list_push(arena->v[0], &locals_sect.data,      str8_array(task.locals_rdi,      total_local_count     ));
   //str8_list_push(arena->v[0], &loc_blocks_sect.data,  str8_array(task.loc_blocks_rdi,  total_loc_block_count ));
   str8_list_push(arena->v[0], &loc_data_sect.data,    str8_array(task.loc_data_rdi,    total_loc_data_size   ));
 
@@ -5393,6 +5393,7 @@ if (((RDIB_Type*)(t))->kind == RDI_TypeKindExt_VirtualTable) break; \
     name_maps[RDI_NameMapKind_NULL              ] = rdib_init_string_map(scratch.arena, 1                   );
     name_maps[RDI_NameMapKind_GlobalVariables   ] = rdib_init_string_map(scratch.arena, total_gvar_count    );
     name_maps[RDI_NameMapKind_ThreadVariables   ] = rdib_init_string_map(scratch.arena, total_tvar_count    );
+    name_maps[RDI_NameMapKind_Constants         ] = rdib_init_string_map(scratch.arena, 1                   );
     name_maps[RDI_NameMapKind_Procedures        ] = rdib_init_string_map(scratch.arena, total_proc_count    );
     name_maps[RDI_NameMapKind_Types             ] = rdib_init_string_map(scratch.arena, total_type_count    );
     name_maps[RDI_NameMapKind_LinkNameProcedures] = rdib_init_string_map(scratch.arena, total_proc_count    );
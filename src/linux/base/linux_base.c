@@ -79,6 +79,85 @@ lnx_safe_call_sig_handler(int x)
   abort();
 }
 
+////////////////////////////////
+//~ File Watchers
+
+internal LNX_FileWatch *
+lnx_file_watch_from_wd(LNX_FileWatcher *watcher, int wd, B32 create)
+{
+  U64 slot_idx = (U64)wd%watcher->watch_slots_count;
+  LNX_FileWatch *watch = 0;
+  for(LNX_FileWatch *w = watcher->watch_slots[slot_idx]; w != 0; w = w->next)
+  {
+    if(w->wd == wd)
+    {
+      watch = w;
+      break;
+    }
+  }
+  if(watch == 0 && create)
+  {
+    watch = watcher->watch_free;
+    if(watch != 0)
+    {
+      SLLStackPop(watcher->watch_free);
+    }
+    else
+    {
+      watch = push_array_no_zero(watcher->arena, LNX_FileWatch, 1);
+    }
+    MemoryZeroStruct(watch);
+    watch->wd = wd;
+    SLLStackPush(watcher->watch_slots[slot_idx], watch);
+  }
+  return watch;
+}
+
+internal B32
+lnx_file_watcher_add_watch(LNX_FileWatcher *watcher, String8 path, B32 is_folder)
+{
+  // NOTE: the caller holds `watcher->mutex`
+  Temp scratch = scratch_begin(0, 0);
+  String8 watch_path = path;
+  U32 mask = IN_ATTRIB|IN_CLOSE_WRITE|IN_MODIFY|IN_DELETE_SELF|IN_MOVE_SELF;
+  if(is_folder)
+  {
+    watch_path = str8_chop_last_slash(path);
+    if(watch_path.size == 0)
+    {
+      watch_path = (path.str[0] == '/') ? str8_lit("/") : str8_lit(".");
+    }
+    mask |= IN_ONLYDIR|IN_CREATE|IN_DELETE|IN_MOVED_FROM|IN_MOVED_TO;
+  }
+  String8 watch_path_copy = push_str8_copy(scratch.arena, watch_path);
+  int wd = inotify_add_watch(watcher->fd, (char *)watch_path_copy.str, mask);
+  if(wd >= 0)
+  {
+    // NOTE: a descriptor is reused when its file is already watched; only
+    // list each path once per watch
+    String8 name = is_folder ? str8_skip_last_slash(path) : str8_zero();
+    LNX_FileWatch *watch = lnx_file_watch_from_wd(watcher, wd, 1);
+    B32 is_listed = 0;
+    for EachNode(p, LNX_FileWatchPath, watch->first_path)
+    {
+      if(str8_match(p->path, path, 0) && str8_match(p->name, name, 0))
+      {
+        is_listed = 1;
+        break;
+      }
+    }
+    if(!is_listed)
+    {
+      LNX_FileWatchPath *p = push_array(watcher->arena, LNX_FileWatchPath, 1);
+      p->path = push_str8_copy(watcher->arena, path);
+      p->name = is_folder ? str8_skip_last_slash(p->path) : str8_zero();
+      SLLStackPush(watch->first_path, p);
+    }
+  }
+  scratch_end(scratch);
+  return (wd >= 0);
+}
+
 ////////////////////////////////
 //~ rjf: Entities
 
@@ -387,6 +466,12 @@ thread_detach(Thread thread)
   lnx_entity_release(entity);
 }
 
+internal void
+thread_yield(void)
+{
+  sched_yield();
+}
+
 ////////////////////////////////
 //~ rjf: @per_os_impl Synchronization Primitive Functions
 
@@ -485,7 +570,11 @@ internal CondVar
 cond_var_alloc(void)
 {
   LNX_Entity *entity = lnx_entity_alloc(LNX_EntityKind_ConditionVariable);
-  int init_result = pthread_cond_init(&entity->cv.cond_handle, 0);
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC); // NOTE: endt_us values come from now_time_us, which is monotonic
+  int init_result = pthread_cond_init(&entity->cv.cond_handle, &attr);
+  pthread_condattr_destroy(&attr);
   if(init_result == -1)
   {
     lnx_entity_release(entity);
@@ -669,22 +758,27 @@ semaphore_close(Semaphore semaphore)
 internal B32
 semaphore_take(Semaphore semaphore, U64 endt_us)
 {
-  // TODO(rjf): we need to use `sem_timedwait` here.
-  AssertAlways(endt_us == max_U64);
+  B32 result = 0;
+  struct timespec endt_timespec;
+  endt_timespec.tv_sec = endt_us/Million(1);
+  endt_timespec.tv_nsec = Thousand(1) * (endt_us - (endt_us/Million(1))*Million(1));
   for(;;)
   {
-    int err = sem_wait((sem_t*)semaphore.u64[0]);
+    int err = (endt_us == max_U64 ?
+               sem_wait((sem_t*)semaphore.u64[0]) :
+               sem_clockwait((sem_t*)semaphore.u64[0], CLOCK_MONOTONIC, &endt_timespec));
     if(err == 0)
     {
+      result = 1;
       break;
     }
-    else if(errno == EAGAIN)
+    else if(errno == EAGAIN || errno == EINTR)
     {
       continue;
     }
     break;
   }
-  return 1;
+  return result;
 }
 
 internal void
@@ -1172,6 +1266,133 @@ make_directory(String8 path)
   return result;
 }
 
+//- file change watching
+
+internal FileWatcher
+file_watcher_alloc(void)
+{
+  FileWatcher result = {0};
+  int fd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+  if(fd >= 0)
+  {
+    Arena *arena = arena_alloc();
+    LNX_FileWatcher *watcher = push_array(arena, LNX_FileWatcher, 1);
+    watcher->arena = arena;
+    watcher->fd = fd;
+    pthread_mutex_init(&watcher->mutex, 0);
+    watcher->watch_slots_count = 4096;
+    watcher->watch_slots = push_array(arena, LNX_FileWatch *, watcher->watch_slots_count);
+    result.u64[0] = (U64)watcher;
+  }
+  return result;
+}
+
+internal void
+file_watcher_release(FileWatcher handle)
+{
+  LNX_FileWatcher *watcher = (LNX_FileWatcher *)handle.u64[0];
+  if(watcher != 0)
+  {
+    close(watcher->fd);
+    pthread_mutex_destroy(&watcher->mutex);
+    arena_release(watcher->arena);
+  }
+}
+
+internal B32
+file_watcher_add_path(FileWatcher handle, String8 path)
+{
+  LNX_FileWatcher *watcher = (LNX_FileWatcher *)handle.u64[0];
+  B32 result = 0;
+  if(watcher != 0 && path.size != 0)
+  {
+    pthread_mutex_lock(&watcher->mutex);
+    B32 is_folder_watched = lnx_file_watcher_add_watch(watcher, path, 1);
+    B32 is_self_watched = lnx_file_watcher_add_watch(watcher, path, 0);
+    result = (is_folder_watched && is_self_watched);
+    pthread_mutex_unlock(&watcher->mutex);
+  }
+  return result;
+}
+
+internal FileWatchChanges
+file_watcher_pop_changes(Arena *arena, FileWatcher handle)
+{
+  FileWatchChanges result = {0};
+  LNX_FileWatcher *watcher = (LNX_FileWatcher *)handle.u64[0];
+  if(watcher != 0)
+  {
+    pthread_mutex_lock(&watcher->mutex);
+    for(;;)
+    {
+      union
+      {
+        struct inotify_event event;
+        U8 bytes[KB(16)];
+      }
+      buffer;
+      ssize_t read_size = LNX_RETRY_ON_EINTR(read(watcher->fd, buffer.bytes, sizeof(buffer.bytes)));
+      if(read_size <= 0)
+      {
+        break;
+      }
+      for(U64 off = 0; off + sizeof(struct inotify_event) <= (U64)read_size;)
+      {
+        struct inotify_event *event = (struct inotify_event *)(buffer.bytes + off);
+        off += sizeof(struct inotify_event) + event->len;
+        if(event->mask & IN_Q_OVERFLOW)
+        {
+          result.lost_changes = 1;
+          continue;
+        }
+        LNX_FileWatch *watch = lnx_file_watch_from_wd(watcher, event->wd, 0);
+        if(watch == 0)
+        {
+          continue;
+        }
+        String8 name = {0};
+        if(event->len != 0)
+        {
+          name = str8_cstring_capped(event->name, event->name + event->len);
+        }
+        for(LNX_FileWatchPath *watch_path = watch->first_path; watch_path != 0; watch_path = watch_path->next)
+        {
+          if(name.size == 0 || watch_path->name.size == 0 || str8_match(watch_path->name, name, 0))
+          {
+            str8_list_push(arena, &result.paths, push_str8_copy(arena, watch_path->path));
+          }
+        }
+        
+        // NOTE: the kernel dropped this watch (its file/folder was deleted,
+        // e.g. replaced by a save, or its filesystem was unmounted); re-add it
+        // for each of its paths, or report the paths as no longer watched
+        if(event->mask & IN_IGNORED)
+        {
+          U64 slot_idx = (U64)event->wd%watcher->watch_slots_count;
+          for(LNX_FileWatch **ptr = &watcher->watch_slots[slot_idx]; *ptr != 0; ptr = &(*ptr)->next)
+          {
+            if(*ptr == watch)
+            {
+              *ptr = watch->next;
+              break;
+            }
+          }
+          for(LNX_FileWatchPath *watch_path = watch->first_path; watch_path != 0; watch_path = watch_path->next)
+          {
+            if(!lnx_file_watcher_add_watch(watcher, watch_path->path, watch_path->name.size != 0))
+            {
+              str8_list_push(arena, &result.unwatched_paths, push_str8_copy(arena, watch_path->path));
+            }
+          }
+          SLLStackPush(watcher->watch_free, watch);
+        }
+      }
+    }
+    pthread_mutex_unlock(&watcher->mutex);
+  }
+  return result;
+}
+
 ////////////////////////////////
 //~ rjf: @per_os_impl Aborting
 
@@ -20,6 +20,7 @@
 #include <signal.h>
 #include <spawn.h>
 #include <stdlib.h>
+#include <sys/inotify.h>
 #include <sys/mman.h>
 #include <sys/random.h>
 #include <sys/sendfile.h>
@@ -63,6 +64,43 @@ struct LNX_FileIter
 };
 StaticAssert(sizeof(Member(FileIter, memory)) >= sizeof(LNX_FileIter), lnx_file_iter_size_check);
 
+////////////////////////////////
+//~ File Watchers
+//
+// One inotify instance per watcher. Each added path gets a watch on its
+// folder (catches replace-by-rename saves) and on itself (catches writes
+// through symlinks); watches are keyed by descriptor, and list the added
+// paths they cover, by name for folder watches. When the kernel drops a watch
+// (e.g. a save replaced the file), it is re-added for the same paths; paths
+// which cannot be re-watched are reported, so that callers poll them.
+
+typedef struct LNX_FileWatchPath LNX_FileWatchPath;
+struct LNX_FileWatchPath
+{
+  LNX_FileWatchPath *next;
+  String8 path;
+  String8 name; // empty for self-watches: every event on the watch matches
+};
+
+typedef struct LNX_FileWatch LNX_FileWatch;
+struct LNX_FileWatch
+{
+  LNX_FileWatch *next;
+  int wd;
+  LNX_FileWatchPath *first_path;
+};
+
+typedef struct LNX_FileWatcher LNX_FileWatcher;
+struct LNX_FileWatcher
+{
+  Arena *arena;
+  pthread_mutex_t mutex;
+  int fd;
+  U64 watch_slots_count;
+  LNX_FileWatch **watch_slots;
+  LNX_FileWatch *watch_free;
+};
+
 ////////////////////////////////
 //~ rjf: Safe Call Handler Chain
 
@@ -141,6 +179,8 @@ internal tm lnx_tm_from_date_time(DateTime dt);
 internal timespec lnx_timespec_from_date_time(DateTime dt);
 internal DenseTime lnx_dense_time_from_timespec(timespec in);
 internal FileProperties lnx_file_properties_from_stat(struct stat *s);
+internal LNX_FileWatch *lnx_file_watch_from_wd(LNX_FileWatcher *watcher, int wd, B32 create);
+internal B32 lnx_file_watcher_add_watch(LNX_FileWatcher *watcher, String8 path, B32 is_folder);
 internal void lnx_safe_call_sig_handler(int x);
 
 ////////////////////////////////
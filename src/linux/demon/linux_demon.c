@@ -8,6 +8,10 @@
 #include <sys/uio.h>
 #include <elf.h>
 
+#if !defined(MAP_FIXED_NOREPLACE)
+# define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
 ////////////////////////////////
 
 internal U64
@@ -39,6 +43,70 @@ lnx_dmn_read(int memory_fd, Rng1U64 range, void *dst)
   return cursor;
 }
 
+internal U64
+lnx_dmn_read_many(pid_t pid, int memory_fd, U64 count, Rng1U64 *ranges, void **dsts, U64 *read_sizes_out)
+{
+  U64 total_read = 0;
+  for(U64 range_idx = 0; range_idx < count;)
+  {
+    // gather as many ranges as fit into one process_vm_readv call
+    struct iovec local_iov[LNX_DMN_READ_MANY_IOV_MAX];
+    struct iovec remote_iov[LNX_DMN_READ_MANY_IOV_MAX];
+    U64 iov_count = 0;
+    if(ins_atomic_u32_eval(&lnx_dmn_state->is_vm_readv_supported))
+    {
+      for(; range_idx + iov_count < count && iov_count < ArrayCount(local_iov); iov_count += 1)
+      {
+        U64 idx = range_idx + iov_count;
+        local_iov[iov_count].iov_base  = dsts[idx];
+        local_iov[iov_count].iov_len   = dim_1u64(ranges[idx]);
+        remote_iov[iov_count].iov_base = (void *)ranges[idx].min;
+        remote_iov[iov_count].iov_len  = dim_1u64(ranges[idx]);
+      }
+    }
+    
+    // read the batch
+    U64 bytes_left = 0;
+    if(iov_count != 0)
+    {
+      ssize_t actual_read = LNX_RETRY_ON_EINTR(process_vm_readv(pid, local_iov, iov_count, remote_iov, iov_count, 0));
+      if(actual_read > 0)
+      {
+        bytes_left = (U64)actual_read;
+      }
+      else if(actual_read < 0 && errno == ENOSYS)
+      {
+        ins_atomic_u32_eval_assign(&lnx_dmn_state->is_vm_readv_supported, 0);
+      }
+    }
+    
+    // the kernel stops at the first range it cannot fully read, and transfers
+    // whole iovecs otherwise; count off all ranges which were fully read
+    U64 done_count = 0;
+    for(; done_count < iov_count && bytes_left >= remote_iov[done_count].iov_len; done_count += 1)
+    {
+      U64 size = remote_iov[done_count].iov_len;
+      if(read_sizes_out) { read_sizes_out[range_idx + done_count] = size; }
+      bytes_left -= size;
+      total_read += size;
+    }
+    range_idx += done_count;
+    
+    // fall back to /proc/pid/mem for the range which stopped the batch (or
+    // for every range, without process_vm_readv) - it may still be readable
+    // through the tracer, or partially readable
+    B32 is_batch_stopped = (done_count < iov_count || iov_count == 0);
+    if(is_batch_stopped && range_idx < count)
+    {
+      U64 read_size = lnx_dmn_read(memory_fd, ranges[range_idx], dsts[range_idx]);
+      if(read_sizes_out) { read_sizes_out[range_idx] = read_size; }
+      total_read += read_size;
+      range_idx += 1;
+    }
+  }
+  return total_read;
+}
+
 internal B32
 lnx_dmn_write(int memory_fd, Rng1U64 range, void *src)
 {
@@ -272,45 +340,878 @@ lnx_dmn_auxv_from_pid(pid_t pid, ELF_Class elf_class)
         case ELF_AuxType_Pagesz: result.pagesz = auxv.a_val; break;
       }
     }
-    brkloop:;
-    LNX_RETRY_ON_EINTR(close(auxv_fd));
+    brkloop:;
+    LNX_RETRY_ON_EINTR(close(auxv_fd));
+  }
+  
+  scratch_end(scratch);
+  return result;
+}
+
+internal LNX_DMN_Thread *
+lnx_dmn_thread_from_pid(pid_t tid)
+{
+  return hash_table_search_u64_raw(lnx_dmn_state->tid_ht, tid);
+}
+
+internal LNX_DMN_Process *
+lnx_dmn_process_from_pid(pid_t pid)
+{
+  return hash_table_search_u64_raw(lnx_dmn_state->pid_ht, pid);
+}
+
+////////////////////////////////
+//~ rjf: Trap Setting
+
+internal LNX_DMN_ActiveTrap *
+lnx_dmn_set_trap(Arena *arena, DMN_Trap *trap)
+{
+  ARCH_Info *arch = arch_info_from_arch(Arch_CURRENT);
+  String8 trap_inst = arch->trap_instruction;
+  U8 *swap_bytes = push_array(arena, U8, trap_inst.size);
+  
+  // NOTE: traps are written straight through the memory descriptor; the
+  // debugger never observes them, so they must not bump the generations of
+  // tracked pages.
+  LNX_DMN_Process *process = lnx_dmn_process_from_handle(trap->process);
+  B32 good_read = 0;
+  B32 good_write = 0;
+  if(process)
+  {
+    good_read = (lnx_dmn_read(process->fd, r1u64(trap->vaddr, trap->vaddr + trap_inst.size), swap_bytes) == trap_inst.size);
+  }
+  if(good_read)
+  {
+    good_write = lnx_dmn_write(process->fd, r1u64(trap->vaddr, trap->vaddr + trap_inst.size), trap_inst.str);
+  }
+  LNX_DMN_ActiveTrap *result = push_array(arena, LNX_DMN_ActiveTrap, 1);
+  result->good = (good_read && good_write);
+  result->trap = trap;
+  result->swap_bytes = str8(swap_bytes, trap_inst.size);
+  return result;
+}
+
+////////////////////////////////
+//~ Remote Syscalls
+
+internal S64
+lnx_dmn_process_syscall(LNX_DMN_Process *process, U64 nr, U64 arg0, U64 arg1, U64 arg2, U64 arg3, U64 arg4, U64 arg5)
+{
+  S64 result = -ENOSYS;
+  
+  // any stopped thread will do
+  LNX_DMN_Thread *thread = 0;
+  for EachNode(t, LNX_DMN_Thread, process->first_thread)
+  {
+    if(t->state == LNX_DMN_ThreadState_Stopped)
+    {
+      thread = t;
+      break;
+    }
+  }
+  
+  if(thread != 0 && process->ctx != 0 && process->ctx->arch == Arch_x64)
+  {
+    // save registers & the code at rip; swap in a `syscall`
+    LNX_DMN_GprsX64 saved_regs = {0};
+    U8 saved_code[2] = {0};
+    U8 syscall_code[2] = {0x0F, 0x05};
+    B32 is_code_swapped = 0;
+    if(LNX_RETRY_ON_EINTR(ptrace(PTRACE_GETREGSET, thread->tid, (void *)NT_PRSTATUS, &(struct iovec){ .iov_len = sizeof(saved_regs), .iov_base = &saved_regs })) >= 0 &&
+       lnx_dmn_read_struct(process->fd, saved_regs.rip, &saved_code) == sizeof(saved_code))
+    {
+      is_code_swapped = lnx_dmn_write_struct(process->fd, saved_regs.rip, &syscall_code);
+    }
+    
+    // set up the syscall; orig_rax of -1 keeps the kernel from restarting
+    // whichever syscall the thread was stopped in
+    B32 is_regs_set = 0;
+    if(is_code_swapped)
+    {
+      LNX_DMN_GprsX64 regs = saved_regs;
+      regs.rax      = nr;
+      regs.rdi      = arg0;
+      regs.rsi      = arg1;
+      regs.rdx      = arg2;
+      regs.r10      = arg3;
+      regs.r8       = arg4;
+      regs.r9       = arg5;
+      regs.orig_rax = max_U64;
+      regs.rflags  &= ~(U64)X64_RFlag_Trap;
+      is_regs_set = LNX_RETRY_ON_EINTR(ptrace(PTRACE_SETREGSET, thread->tid, (void *)NT_PRSTATUS, &(struct iovec){ .iov_len = sizeof(regs), .iov_base = &regs })) >= 0;
+    }
+    
+    // step over it; signals which arrive first are held for the next resume
+    if(is_regs_set)
+    {
+      for EachIndex(attempt_idx, 8)
+      {
+        int status = 0;
+        if(LNX_RETRY_ON_EINTR(ptrace(PTRACE_SINGLESTEP, thread->tid, 0, 0)) < 0 ||
+           LNX_RETRY_ON_EINTR(waitpid(thread->tid, &status, __WALL)) != thread->tid ||
+           !WIFSTOPPED(status))
+        {
+          break;
+        }
+        if(WSTOPSIG(status) != SIGTRAP && (status >> 16) == 0 && !thread->pass_through_signal)
+        {
+          thread->pass_through_signal = 1;
+          thread->pass_through_signo  = WSTOPSIG(status);
+        }
+        LNX_DMN_GprsX64 regs = {0};
+        if(LNX_RETRY_ON_EINTR(ptrace(PTRACE_GETREGSET, thread->tid, (void *)NT_PRSTATUS, &(struct iovec){ .iov_len = sizeof(regs), .iov_base = &regs })) >= 0 &&
+           regs.rip == saved_regs.rip + sizeof(syscall_code))
+        {
+          result = (S64)regs.rax;
+          break;
+        }
+      }
+    }
+    
+    // restore
+    if(is_regs_set)
+    {
+      LNX_RETRY_ON_EINTR(ptrace(PTRACE_SETREGSET, thread->tid, (void *)NT_PRSTATUS, &(struct iovec){ .iov_len = sizeof(saved_regs), .iov_base = &saved_regs }));
+    }
+    if(is_code_swapped)
+    {
+      lnx_dmn_write_struct(process->fd, saved_regs.rip, &saved_code);
+    }
+  }
+  
+  return result;
+}
+
+////////////////////////////////
+//~ Condition Trampolines
+
+internal LNX_DMN_CondTrampoline *
+lnx_dmn_cond_trampoline_from_trap(LNX_DMN_Process *process, DMN_Trap *trap)
+{
+  Temp scratch = scratch_begin(0, 0);
+  LNX_DMN_ProcessCtx *ctx = process->ctx;
+  DMN_Handle process_handle = lnx_dmn_handle_from_process(process);
+  LNX_DMN_CondTrampoline *result = 0;
+  
+  // read the site instruction
+  String8 site_inst = str8(push_array(scratch.arena, U8, trap->condition_site_size), trap->condition_site_size);
+  B32 good = (lnx_dmn_process_read(process, r1u64(trap->vaddr, trap->vaddr + site_inst.size), site_inst.str) == site_inst.size);
+  
+  // look for a trampoline which was built for this site, code, & instruction
+  U64 hash = 0;
+  if(good)
+  {
+    hash = u64_hash_from_str8(trap->condition_code);
+    hash = u64_hash_from_seed_str8(hash, site_inst);
+    hash = u64_hash_from_seed_str8(hash, str8_struct(&trap->condition_site_rip_disp_off));
+    for EachNode(t, LNX_DMN_CondTrampoline, ctx->first_cond_trampoline)
+    {
+      if(t->site_vaddr == trap->vaddr && t->hash == hash)
+      {
+        result = t;
+        break;
+      }
+    }
+  }
+  
+  // build a new one, in the first code block which has room & is in reach of the site
+  if(good && result == 0)
+  {
+    X64_CondTrampoline code = {0};
+    U8 jmp[X64_COND_SITE_JMP_SIZE];
+    LNX_DMN_CondCodeBlock *block = 0;
+    for EachNode(b, LNX_DMN_CondCodeBlock, ctx->first_cond_code_block)
+    {
+      U64 vaddr = b->vaddr_range.min + b->used_size;
+      code = x64_cond_trampoline_from_code(scratch.arena, vaddr, trap->vaddr, site_inst, trap->condition_site_rip_disp_off, trap->condition_code);
+      if(code.code.size != 0 && b->used_size + code.code.size <= dim_1u64(b->vaddr_range) && x64_write_rel32_jmp(jmp, trap->vaddr, vaddr))
+      {
+        block = b;
+        break;
+      }
+    }
+    
+    // no room? map a new block, trying hints which alternate below & above the site
+    for(U64 hint_idx = 0; block == 0 && hint_idx < LNX_DMN_COND_CODE_BLOCK_HINT_COUNT; hint_idx += 1)
+    {
+      U64 site_base = AlignDownPow2(trap->vaddr, LNX_DMN_COND_CODE_BLOCK_SIZE);
+      U64 distance = (hint_idx/2 + 1)*LNX_DMN_COND_CODE_BLOCK_HINT_STRIDE;
+      if(!(hint_idx & 1) && site_base < distance) { continue; }
+      U64 hint = (hint_idx & 1) ? site_base + distance : site_base - distance;
+      U64 vaddr = dmn_process_memory_reserve(process_handle, hint, LNX_DMN_COND_CODE_BLOCK_SIZE);
+      if(vaddr == 0) { break; }
+      code = x64_cond_trampoline_from_code(scratch.arena, vaddr, trap->vaddr, site_inst, trap->condition_site_rip_disp_off, trap->condition_code);
+      if(code.code.size != 0 && code.code.size <= LNX_DMN_COND_CODE_BLOCK_SIZE && x64_write_rel32_jmp(jmp, trap->vaddr, vaddr))
+      {
+        dmn_process_memory_commit(process_handle, vaddr, LNX_DMN_COND_CODE_BLOCK_SIZE);
+        dmn_process_memory_protect(process_handle, vaddr, LNX_DMN_COND_CODE_BLOCK_SIZE, AccessFlag_Read|AccessFlag_Execute);
+        block = push_array(ctx->arena, LNX_DMN_CondCodeBlock, 1);
+        block->vaddr_range = r1u64(vaddr, vaddr + LNX_DMN_COND_CODE_BLOCK_SIZE);
+        SLLStackPush(ctx->first_cond_code_block, block);
+      }
+      else
+      {
+        dmn_process_memory_release(process_handle, vaddr, LNX_DMN_COND_CODE_BLOCK_SIZE);
+      }
+    }
+    
+    // write it
+    if(block != 0)
+    {
+      U64 vaddr = block->vaddr_range.min + block->used_size;
+      if(lnx_dmn_write(process->fd, r1u64(vaddr, vaddr + code.code.size), code.code.str))
+      {
+        block->used_size += AlignPow2(code.code.size, 16);
+        result = push_array(ctx->arena, LNX_DMN_CondTrampoline, 1);
+        result->site_vaddr            = trap->vaddr;
+        result->hash                  = hash;
+        result->vaddr_range           = r1u64(vaddr, vaddr + code.code.size);
+        result->cond_vaddr_range      = shift_1u64(code.cond_off_range, vaddr);
+        result->trap_vaddr            = vaddr + code.trap_off;
+        result->site_inst_vaddr_range = shift_1u64(code.site_inst_off_range, vaddr);
+        SLLStackPush(ctx->first_cond_trampoline, result);
+      }
+    }
+  }
+  
+  scratch_end(scratch);
+  return result;
+}
+
+internal LNX_DMN_CondTrampoline *
+lnx_dmn_cond_trampoline_from_vaddr(LNX_DMN_ProcessCtx *ctx, U64 vaddr)
+{
+  LNX_DMN_CondTrampoline *result = 0;
+  for EachNode(t, LNX_DMN_CondTrampoline, ctx->first_cond_trampoline)
+  {
+    if(contains_1u64(t->vaddr_range, vaddr))
+    {
+      result = t;
+      break;
+    }
+  }
+  return result;
+}
+
+internal B32
+lnx_dmn_event_cond_trampoline_fault(Arena *arena, DMN_EventList *events, LNX_DMN_Thread *thread, U64 signo)
+{
+  B32 is_handled = 0;
+  LNX_DMN_Process *process = thread->process;
+  U64 ip = lnx_dmn_thread_read_ip(thread);
+  LNX_DMN_CondTrampoline *trampoline = lnx_dmn_cond_trampoline_from_vaddr(process->ctx, ip);
+  if(trampoline != 0 && contains_1u64(trampoline->cond_vaddr_range, ip))
+  {
+    // the condition faulted; unwind the trampoline's frame, & report the trap,
+    // so that the debugger evaluates the condition itself
+    X64_RegBlock *regs = thread->reg_block;
+    U64 frame[4] = {0};
+    if(lnx_dmn_read_struct(process->fd, regs->rdx, &frame) == sizeof(frame))
+    {
+      U64 frame_vaddr = regs->rdx;
+      regs->rdx    = frame[X64_COND_FRAME_OFF_RDX/sizeof(U64)];
+      regs->rcx    = frame[X64_COND_FRAME_OFF_RCX/sizeof(U64)];
+      regs->rax    = frame[X64_COND_FRAME_OFF_RAX/sizeof(U64)];
+      regs->rflags = frame[X64_COND_FRAME_OFF_RFLAGS/sizeof(U64)] & ~(U64)X64_RFlag_Trap;
+      regs->rsp    = frame_vaddr + X64_COND_FRAME_OFF_RSP;
+      lnx_dmn_thread_write_ip(thread, trampoline->site_vaddr);
+      DMN_Event *e = dmn_event_list_push(arena, events);
+      e->kind                = DMN_EventKind_Breakpoint;
+      e->process             = lnx_dmn_handle_from_process(process);
+      e->thread              = lnx_dmn_handle_from_thread(thread);
+      e->instruction_pointer = trampoline->site_vaddr;
+      is_handled = 1;
+    }
+  }
+  else if(trampoline != 0 && contains_1u64(trampoline->site_inst_vaddr_range, ip))
+  {
+    // the relocated site instruction faulted; report it at the site
+    lnx_dmn_thread_write_ip(thread, trampoline->site_vaddr);
+    lnx_dmn_event_exception(arena, events, thread->tid, signo);
+    is_handled = 1;
+  }
+  return is_handled;
+}
+
+internal void
+lnx_dmn_thread_step_out_of_cond_trampoline(Arena *arena, DMN_EventList *events, LNX_DMN_Thread *thread)
+{
+  LNX_DMN_ProcessCtx *ctx = thread->process->ctx;
+  LNX_DMN_CondTrampoline *trampoline = 0;
+  if(thread->state == LNX_DMN_ThreadState_Stopped)
+  {
+    trampoline = lnx_dmn_cond_trampoline_from_vaddr(ctx, lnx_dmn_thread_read_ip(thread));
+  }
+  for(U64 step_idx = 0; trampoline != 0 && step_idx < LNX_DMN_COND_STEP_OUT_MAX; step_idx += 1)
+  {
+    // the condition held; stop at the site, as if its trap were hit
+    U64 ip = lnx_dmn_thread_read_ip(thread);
+    if(ip == trampoline->trap_vaddr)
+    {
+      lnx_dmn_thread_write_ip(thread, trampoline->site_vaddr);
+      DMN_Event *e = dmn_event_list_push(arena, events);
+      e->kind                = DMN_EventKind_Breakpoint;
+      e->process             = lnx_dmn_handle_from_process(thread->process);
+      e->thread              = lnx_dmn_handle_from_thread(thread);
+      e->instruction_pointer = trampoline->site_vaddr;
+      break;
+    }
+    
+    // step
+    int status = 0;
+    if(thread->is_reg_block_dirty)
+    {
+      thread->is_reg_block_dirty = !lnx_dmn_thread_write_reg_block(thread);
+    }
+    if(LNX_RETRY_ON_EINTR(ptrace(PTRACE_SINGLESTEP, thread->tid, 0, 0)) < 0 ||
+       LNX_RETRY_ON_EINTR(waitpid(thread->tid, &status, __WALL)) != thread->tid ||
+       !WIFSTOPPED(status))
+    {
+      break;
+    }
+    thread->is_reg_block_dirty = !lnx_dmn_thread_read_stop_reg_block(thread);
+    int stop_signal = WSTOPSIG(status);
+    if(stop_signal == SIGSEGV || stop_signal == SIGBUS)
+    {
+      if(!lnx_dmn_event_cond_trampoline_fault(arena, events, thread, stop_signal))
+      {
+        lnx_dmn_event_exception(arena, events, thread->tid, stop_signal);
+      }
+      break;
+    }
+    if(stop_signal != SIGTRAP && (status >> 16) == 0 && !thread->pass_through_signal)
+    {
+      thread->pass_through_signal = 1;
+      thread->pass_through_signo  = stop_signal;
+    }
+    trampoline = lnx_dmn_cond_trampoline_from_vaddr(ctx, lnx_dmn_thread_read_ip(thread));
+  }
+}
+
+////////////////////////////////
+//~ Installed Traps
+
+StaticAssert(X64_COND_SITE_JMP_SIZE <= LNX_DMN_INSTALLED_TRAP_SWAP_CAP, lnx_dmn_installed_trap_swap_cap_check);
+
+internal U64
+lnx_dmn_installed_trap_idx_from_vaddr(LNX_DMN_Process *process, U64 vaddr)
+{
+  // first installed trap which ends past `vaddr`; traps don't overlap, so
+  // their ends are sorted too
+  U64 lo = 0, hi = process->installed_trap_count;
+  while(lo < hi)
+  {
+    U64 mid = lo + (hi - lo)/2;
+    LNX_DMN_InstalledTrap *t = &process->installed_traps[mid];
+    if(t->trap.vaddr + t->swap_bytes_size <= vaddr)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+internal void
+lnx_dmn_process_overlay_installed_traps(LNX_DMN_Process *process, Rng1U64 range, void *dst)
+{
+  for(U64 idx = lnx_dmn_installed_trap_idx_from_vaddr(process, range.min); idx < process->installed_trap_count; idx += 1)
+  {
+    LNX_DMN_InstalledTrap *t = &process->installed_traps[idx];
+    Rng1U64 trap_range = r1u64(t->trap.vaddr, t->trap.vaddr + t->swap_bytes_size);
+    if(trap_range.min >= range.max) { break; }
+    Rng1U64 overlap = intersect_1u64(range, trap_range);
+    MemoryCopy((U8 *)dst + (overlap.min - range.min), t->swap_bytes + (overlap.min - trap_range.min), dim_1u64(overlap));
+  }
+}
+
+internal U64
+lnx_dmn_process_read(LNX_DMN_Process *process, Rng1U64 range, void *dst)
+{
+  U64 result = lnx_dmn_read(process->fd, range, dst);
+  lnx_dmn_process_overlay_installed_traps(process, r1u64(range.min, range.min + result), dst);
+  return result;
+}
+
+internal void
+lnx_dmn_process_remove_installed_traps(LNX_DMN_Process *process, Rng1U64 range, B32 restore_bytes)
+{
+  U64 first_idx = lnx_dmn_installed_trap_idx_from_vaddr(process, range.min);
+  U64 opl_idx   = first_idx;
+  for(; opl_idx < process->installed_trap_count && process->installed_traps[opl_idx].trap.vaddr < range.max; opl_idx += 1)
+  {
+    LNX_DMN_InstalledTrap *t = &process->installed_traps[opl_idx];
+    if(restore_bytes)
+    {
+      lnx_dmn_write(process->fd, r1u64(t->trap.vaddr, t->trap.vaddr + t->swap_bytes_size), t->swap_bytes);
+    }
+  }
+  if(opl_idx > first_idx)
+  {
+    MemoryCopy(process->installed_traps + first_idx, process->installed_traps + opl_idx, (process->installed_trap_count - opl_idx)*sizeof(process->installed_traps[0]));
+    process->installed_trap_count -= (opl_idx - first_idx);
+  }
+}
+
+internal void
+lnx_dmn_process_rebind_installed_traps(LNX_DMN_Process *process)
+{
+  // the process context was cloned; point jumps at the clone's trampolines
+  for EachIndex(idx, process->installed_trap_count)
+  {
+    LNX_DMN_InstalledTrap *t = &process->installed_traps[idx];
+    if(t->trampoline != 0)
+    {
+      LNX_DMN_CondTrampoline *old = t->trampoline;
+      t->trampoline = 0;
+      for EachNode(n, LNX_DMN_CondTrampoline, process->ctx->first_cond_trampoline)
+      {
+        if(n->site_vaddr == old->site_vaddr && n->hash == old->hash)
+        {
+          t->trampoline = n;
+          break;
+        }
+      }
+      AssertAlways(t->trampoline != 0);
+    }
+  }
+}
+
+internal int
+lnx_dmn_trap_ptr_qsort_compare__vaddr_ascending(DMN_Trap **a, DMN_Trap **b)
+{
+  int result = 0;
+  if((*a)->vaddr < (*b)->vaddr)      { result = -1; }
+  else if((*a)->vaddr > (*b)->vaddr) { result = +1; }
+  return result;
+}
+
+internal void
+lnx_dmn_process_sync_traps(LNX_DMN_Process *process, DMN_Trap **traps, U64 trap_count, B32 use_cond_traps, B32 keep_unrequested, Rng1U64 keep_exclude_range)
+{
+  Temp scratch = scratch_begin(0, 0);
+  String8 trap_inst = arch_info_from_arch(Arch_CURRENT)->trap_instruction;
+  
+  //- pick how each requested address is armed; a site can only jump to one
+  // condition, so traps at the same address which disagree fall back to a
+  // trap instruction
+  B32 is_sorted = 1;
+  for(U64 idx = 1; idx < trap_count && is_sorted; idx += 1)
+  {
+    is_sorted = (traps[idx-1]->vaddr <= traps[idx]->vaddr);
+  }
+  if(!is_sorted)
+  {
+    quick_sort(traps, trap_count, sizeof(traps[0]), lnx_dmn_trap_ptr_qsort_compare__vaddr_ascending);
+  }
+  LNX_DMN_InstalledTrap *wanted = push_array_no_zero(scratch.arena, LNX_DMN_InstalledTrap, trap_count);
+  U64 wanted_count = 0;
+  for(U64 idx = 0, next_idx = 0; idx < trap_count; idx = next_idx)
+  {
+    DMN_Trap *trap = traps[idx];
+    B32 is_cond = (use_cond_traps &&
+                   process->ctx != 0 &&
+                   process->ctx->arch == Arch_x64 &&
+                   trap->condition_code.size != 0 &&
+                   trap->condition_site_size >= X64_COND_SITE_JMP_SIZE);
+    for(next_idx = idx + 1; next_idx < trap_count && traps[next_idx]->vaddr == trap->vaddr; next_idx += 1)
+    {
+      is_cond = is_cond && str8_match(traps[next_idx]->condition_code, trap->condition_code, 0);
+    }
+    LNX_DMN_InstalledTrap *w = &wanted[wanted_count];
+    wanted_count += 1;
+    w->trap                = *trap;
+    w->trap.condition_code = str8_zero();
+    w->trampoline          = is_cond ? lnx_dmn_cond_trampoline_from_trap(process, trap) : 0;
+    w->swap_bytes_size     = 0;
+  }
+  
+  //- merge with the installed traps; installed traps which are no longer
+  // wanted (or are armed differently) are restored before anything new is
+  // installed, so that new traps read original bytes
+  LNX_DMN_InstalledTrap *installed = process->installed_traps;
+  U64 installed_count = process->installed_trap_count;
+  LNX_DMN_InstalledTrap *merged = push_array_no_zero(scratch.arena, LNX_DMN_InstalledTrap, wanted_count + installed_count);
+  B8 *merged_is_new = push_array(scratch.arena, B8, wanted_count + installed_count);
+  U64 merged_count = 0;
+  for(U64 w_idx = 0, i_idx = 0; w_idx < wanted_count || i_idx < installed_count;)
+  {
+    LNX_DMN_InstalledTrap *w = (w_idx < wanted_count ? &wanted[w_idx] : 0);
+    LNX_DMN_InstalledTrap *i = (i_idx < installed_count ? &installed[i_idx] : 0);
+    if(w != 0 && i != 0 && w->trap.vaddr == i->trap.vaddr && w->trampoline == i->trampoline)
+    {
+      merged[merged_count] = *i;
+      merged[merged_count].trap = w->trap;
+      merged_count += 1;
+      w_idx += 1;
+      i_idx += 1;
+    }
+    else if(i != 0 && (w == 0 || i->trap.vaddr <= w->trap.vaddr))
+    {
+      Rng1U64 i_range = r1u64(i->trap.vaddr, i->trap.vaddr + i->swap_bytes_size);
+      B32 is_requested = (w != 0 && w->trap.vaddr == i->trap.vaddr);
+      B32 is_excluded = (i_range.min < keep_exclude_range.max && keep_exclude_range.min < i_range.max);
+      if(keep_unrequested && !is_requested && !is_excluded)
+      {
+        merged[merged_count] = *i;
+        merged_count += 1;
+      }
+      else
+      {
+        lnx_dmn_write(process->fd, i_range, i->swap_bytes);
+      }
+      i_idx += 1;
+    }
+    else
+    {
+      merged[merged_count] = *w;
+      merged_is_new[merged_count] = 1;
+      merged_count += 1;
+      w_idx += 1;
+    }
+  }
+  
+  //- find the next trap which stays in place, past each trap
+  U64 *next_kept_vaddrs = push_array_no_zero(scratch.arena, U64, merged_count + 1);
+  next_kept_vaddrs[merged_count] = max_U64;
+  for(U64 idx = merged_count; idx > 0; idx -= 1)
+  {
+    next_kept_vaddrs[idx-1] = merged_is_new[idx-1] ? next_kept_vaddrs[idx] : merged[idx-1].trap.vaddr;
+  }
+  
+  //- install new traps; a jump which would run into the next trap falls back
+  // to a trap instruction, & traps which would overlap are dropped
+  U64 next_count = 0;
+  for EachIndex(idx, merged_count)
+  {
+    LNX_DMN_InstalledTrap *t = &merged[idx];
+    if(merged_is_new[idx])
+    {
+      U64 prev_opl = (next_count > 0 ? merged[next_count-1].trap.vaddr + merged[next_count-1].swap_bytes_size : 0);
+      U64 next_min = next_kept_vaddrs[idx+1];
+      U8 jmp[X64_COND_SITE_JMP_SIZE];
+      String8 bytes = trap_inst;
+      if(t->trampoline != 0 &&
+         t->trap.vaddr + sizeof(jmp) <= next_min &&
+         x64_write_rel32_jmp(jmp, t->trap.vaddr, t->trampoline->vaddr_range.min))
+      {
+        bytes = str8(jmp, sizeof(jmp));
+      }
+      else
+      {
+        t->trampoline = 0;
+      }
+      Rng1U64 range = r1u64(t->trap.vaddr, t->trap.vaddr + bytes.size);
+      B32 good = (bytes.size <= sizeof(t->swap_bytes) &&
+                  prev_opl <= range.min && range.max <= next_min &&
+                  lnx_dmn_read(process->fd, range, t->swap_bytes) == bytes.size &&
+                  lnx_dmn_write(process->fd, range, bytes.str));
+      if(!good) { continue; }
+      t->swap_bytes_size = bytes.size;
+    }
+    if(next_count != idx)
+    {
+      merged[next_count] = *t;
+    }
+    next_count += 1;
+  }
+  
+  //- store the new set
+  arena_clear(process->trap_arena);
+  process->installed_traps = push_array_no_zero(process->trap_arena, LNX_DMN_InstalledTrap, next_count);
+  process->installed_trap_count = next_count;
+  MemoryCopy(process->installed_traps, merged, next_count*sizeof(merged[0]));
+  
+  scratch_end(scratch);
+}
+
+////////////////////////////////
+//~ Soft-Dirty Page Tracking
+
+internal B32
+lnx_dmn_soft_dirty_is_supported(void)
+{
+  // the kernel may be built without CONFIG_MEM_SOFT_DIRTY, in which case
+  // clear_refs still accepts "4" but the soft-dirty bit is never reported;
+  // verify the round-trip on a page of our own before trusting it
+  B32 is_supported  = 0;
+  U64 page_size     = get_system_info()->page_size;
+  int pagemap_fd    = LNX_RETRY_ON_EINTR(open("/proc/self/pagemap", O_RDONLY));
+  int clear_refs_fd = LNX_RETRY_ON_EINTR(open("/proc/self/clear_refs", O_WRONLY));
+  volatile U8 *page = mmap(0, page_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  if(pagemap_fd >= 0 && clear_refs_fd >= 0 && page != MAP_FAILED)
+  {
+    U64 entry_off    = ((U64)page / page_size) * sizeof(U64);
+    U64 entry_before = 0;
+    U64 entry_after  = 0;
+    page[0] = 1;
+    B32 is_cleared     = (LNX_RETRY_ON_EINTR(write(clear_refs_fd, "4", 1)) == 1);
+    B32 is_read_before = (LNX_RETRY_ON_EINTR(pread(pagemap_fd, &entry_before, sizeof(entry_before), entry_off)) == sizeof(entry_before));
+    page[0] = 2;
+    B32 is_read_after  = (LNX_RETRY_ON_EINTR(pread(pagemap_fd, &entry_after, sizeof(entry_after), entry_off)) == sizeof(entry_after));
+    is_supported = (is_cleared && is_read_before && is_read_after &&
+                    !(entry_before & LNX_DMN_PAGEMAP_SOFT_DIRTY_BIT) &&
+                    (entry_after & LNX_DMN_PAGEMAP_SOFT_DIRTY_BIT));
+  }
+  if(page != MAP_FAILED)  { munmap((void *)page, page_size); }
+  if(pagemap_fd >= 0)     { LNX_RETRY_ON_EINTR(close(pagemap_fd)); }
+  if(clear_refs_fd >= 0)  { LNX_RETRY_ON_EINTR(close(clear_refs_fd)); }
+  return is_supported;
+}
+
+internal Rng1U64Array
+lnx_dmn_untracked_vranges_from_pid(Arena *arena, pid_t pid)
+{
+  Temp scratch = scratch_begin(&arena, 1);
+  
+  Rng1U64List untracked = {0};
+  B32         is_parsed = 0;
+  
+  int maps_fd = LNX_RETRY_ON_EINTR(open((char *)str8f(scratch.arena, "/proc/%d/maps", pid).str, O_RDONLY));
+  if(maps_fd >= 0)
+  {
+    // read entire /proc/pid/maps; a truncated read can't tell which pages are safe
+    U64  maps_cap  = MB(64);
+    U64  maps_size = lnx_dmn_size_from_fd(maps_fd, maps_cap);
+    U8  *maps_ptr  = push_array(scratch.arena, U8, maps_size);
+    U64  read_size = lnx_dmn_read(maps_fd, r1u64(0, maps_size), maps_ptr);
+    is_parsed = (maps_size < maps_cap && read_size == maps_size);
+    
+    // lines are "<lo>-<hi> <perms> <offset> <dev> <inode> <path>"
+    String8List lines = str8_split_by_string_chars(scratch.arena, str8(maps_ptr, read_size), str8_lit("\n"), 0);
+    for EachNode(n, String8Node, lines.first)
+    {
+      String8List parts = str8_split_by_string_chars(scratch.arena, n->string, str8_lit(" "), 0);
+      if(parts.node_count < 5) { is_parsed = 0; break; }
+      String8List vaddr_list = str8_split_by_string_chars(scratch.arena, parts.first->string, str8_lit("-"), 0);
+      String8     perms      = parts.first->next->string;
+      String8     inode      = parts.first->next->next->next->next->string;
+      if(vaddr_list.node_count != 2 || perms.size < 4) { is_parsed = 0; break; }
+      
+      // shared pages are written by other processes & writable file-backed
+      // pages may be changed through the page cache, neither sets soft-dirty
+      B32 is_shared      = (perms.str[3] == 's');
+      B32 is_file_backed = (u64_from_str8(inode, 10) != 0);
+      B32 is_writable    = (perms.str[1] == 'w');
+      if(is_shared || (is_file_backed && is_writable))
+      {
+        Rng1U64 vrange = r1u64(u64_from_str8(vaddr_list.first->string, 16), u64_from_str8(vaddr_list.last->string, 16));
+        if(untracked.last && untracked.last->v.max == vrange.min)
+        {
+          untracked.last->v.max = vrange.max;
+        }
+        else
+        {
+          rng1u64_list_push(scratch.arena, &untracked, vrange);
+        }
+      }
+    }
+    
+    LNX_RETRY_ON_EINTR(close(maps_fd));
+  }
+  
+  // when mappings are unknown, nothing can be tracked
+  if(!is_parsed)
+  {
+    MemoryZeroStruct(&untracked);
+    rng1u64_list_push(scratch.arena, &untracked, r1u64(0, max_U64));
   }
   
+  Rng1U64Array result = rng1u64_array_from_list(arena, &untracked);
   scratch_end(scratch);
   return result;
 }
 
-internal LNX_DMN_Thread *
-lnx_dmn_thread_from_pid(pid_t tid)
+internal void
+lnx_dmn_process_page_tracking_open(LNX_DMN_Process *process)
 {
-  return hash_table_search_u64_raw(lnx_dmn_state->tid_ht, tid);
+  process->pagemap_fd    = -1;
+  process->clear_refs_fd = -1;
+  if(lnx_dmn_state->is_soft_dirty_supported)
+  {
+    Temp scratch = scratch_begin(0, 0);
+    int pagemap_fd    = LNX_RETRY_ON_EINTR(open((char *)str8f(scratch.arena, "/proc/%d/pagemap", process->pid).str, O_RDONLY));
+    int clear_refs_fd = LNX_RETRY_ON_EINTR(open((char *)str8f(scratch.arena, "/proc/%d/clear_refs", process->pid).str, O_WRONLY));
+    if(pagemap_fd >= 0 && clear_refs_fd >= 0)
+    {
+      process->pagemap_fd       = pagemap_fd;
+      process->clear_refs_fd    = clear_refs_fd;
+      process->page_track_arena = arena_alloc();
+      process->page_track_ht    = hash_table_init(process->page_track_arena, 0x1000);
+      process->page_gen         = 1;
+      process->untracked_arena  = arena_alloc();
+    }
+    else
+    {
+      if(pagemap_fd >= 0)    { LNX_RETRY_ON_EINTR(close(pagemap_fd)); }
+      if(clear_refs_fd >= 0) { LNX_RETRY_ON_EINTR(close(clear_refs_fd)); }
+    }
+    scratch_end(scratch);
+  }
 }
 
-internal LNX_DMN_Process *
-lnx_dmn_process_from_pid(pid_t pid)
+internal void
+lnx_dmn_process_page_tracking_close(LNX_DMN_Process *process)
 {
-  return hash_table_search_u64_raw(lnx_dmn_state->pid_ht, pid);
+  MutexScope(lnx_dmn_state->page_track_mutex)
+  {
+    if(process->pagemap_fd >= 0)    { LNX_RETRY_ON_EINTR(close(process->pagemap_fd)); }
+    if(process->clear_refs_fd >= 0) { LNX_RETRY_ON_EINTR(close(process->clear_refs_fd)); }
+    if(process->page_track_arena)   { arena_release(process->page_track_arena); }
+    if(process->untracked_arena)    { arena_release(process->untracked_arena); }
+    process->pagemap_fd             = -1;
+    process->clear_refs_fd          = -1;
+    process->page_track_arena       = 0;
+    process->page_track_ht          = 0;
+    process->first_page_track_block = 0;
+    process->page_track_block_count = 0;
+    process->untracked_arena        = 0;
+    process->is_untracked_valid     = 0;
+  }
 }
 
-////////////////////////////////
-//~ rjf: Trap Setting
+internal void
+lnx_dmn_process_clear_soft_dirty(LNX_DMN_Process *process)
+{
+  MutexScope(lnx_dmn_state->page_track_mutex)
+  {
+    // mappings may change while the process runs
+    process->is_untracked_valid = 0;
+    
+    if(lnx_dmn_state->is_soft_dirty_enabled && process->clear_refs_fd >= 0 && process->page_track_block_count > 0)
+    {
+      // NOTE: a failed clear only leaves stale soft-dirty bits behind, which
+      // makes the next sweep conservative, not wrong.
+      LNX_RETRY_ON_EINTR(write(process->clear_refs_fd, "4", 1));
+    }
+  }
+}
 
-internal LNX_DMN_ActiveTrap *
-lnx_dmn_set_trap(Arena *arena, DMN_Trap *trap)
+internal void
+lnx_dmn_process_sweep_soft_dirty(LNX_DMN_Process *process)
 {
-  ARCH_Info *arch = arch_info_from_arch(Arch_CURRENT);
-  String8 trap_inst = arch->trap_instruction;
-  U8 *swap_bytes = push_array(arena, U8, trap_inst.size);
-  B32 good_read = dmn_process_read(trap->process, r1u64(trap->vaddr, trap->vaddr + trap_inst.size), swap_bytes);
-  B32 good_write = 0;
-  if(good_read)
+  MutexScope(lnx_dmn_state->page_track_mutex)
   {
-    good_write = dmn_process_write(trap->process, r1u64(trap->vaddr, trap->vaddr + trap_inst.size), trap_inst.str);
+    if(lnx_dmn_state->is_soft_dirty_enabled && process->pagemap_fd >= 0 && process->page_track_block_count > 0)
+    {
+      U64 page_size = get_system_info()->page_size;
+      U64 new_gen   = process->page_gen + 1;
+      B32 any_dirty = 0;
+      for EachNode(block, LNX_DMN_PageTrackBlock, process->first_page_track_block)
+      {
+        // one pagemap read covers the whole block
+        U64     entries[LNX_DMN_PAGE_TRACK_BLOCK_PAGES];
+        U64     entries_off = (block->base_vaddr / page_size) * sizeof(entries[0]);
+        ssize_t read_size   = LNX_RETRY_ON_EINTR(pread(process->pagemap_fd, entries, sizeof(entries), entries_off));
+        U64     entry_count = read_size > 0 ? (U64)read_size / sizeof(entries[0]) : 0;
+        
+        for EachIndex(page_idx, LNX_DMN_PAGE_TRACK_BLOCK_PAGES)
+        {
+          if(!(block->tracked_mask & (1ull << page_idx))) { continue; }
+          
+          // unmapped pages carry no soft-dirty state, so treat them as changed
+          U64 entry     = page_idx < entry_count ? entries[page_idx] : 0;
+          B32 is_mapped = !!(entry & (LNX_DMN_PAGEMAP_PRESENT_BIT|LNX_DMN_PAGEMAP_SWAPPED_BIT));
+          if(!is_mapped || (entry & LNX_DMN_PAGEMAP_SOFT_DIRTY_BIT))
+          {
+            block->gens[page_idx] = new_gen;
+            any_dirty = 1;
+          }
+        }
+      }
+      if(any_dirty)
+      {
+        process->page_gen = new_gen;
+      }
+    }
+  }
+}
+
+internal void
+lnx_dmn_process_mark_pages_dirty(LNX_DMN_Process *process, Rng1U64 range)
+{
+  MutexScope(lnx_dmn_state->page_track_mutex)
+  {
+    if(process->page_track_block_count > 0 && range.max > range.min)
+    {
+      U64 page_size  = get_system_info()->page_size;
+      U64 block_size = page_size * LNX_DMN_PAGE_TRACK_BLOCK_PAGES;
+      process->page_gen += 1;
+      for(U64 page_vaddr = AlignDownPow2(range.min, page_size); page_vaddr < range.max; page_vaddr += page_size)
+      {
+        U64                     block_base = AlignDownPow2(page_vaddr, block_size);
+        LNX_DMN_PageTrackBlock *block      = hash_table_search_u64_raw(process->page_track_ht, block_base);
+        if(block)
+        {
+          U64 page_idx = (page_vaddr - block_base) / page_size;
+          block->gens[page_idx] = process->page_gen;
+        }
+      }
+    }
+  }
+}
+
+internal U64
+lnx_dmn_process_page_gen_from_range(LNX_DMN_Process *process, Rng1U64 range)
+{
+  U64 result = 0;
+  MutexScope(lnx_dmn_state->page_track_mutex)
+  {
+    if(lnx_dmn_state->is_soft_dirty_enabled &&
+       process->pagemap_fd >= 0 &&
+       process->state == LNX_DMN_ProcessState_Normal &&
+       range.max > range.min)
+    {
+      // load mappings which can't be tracked once per stop
+      if(!process->is_untracked_valid)
+      {
+        arena_clear(process->untracked_arena);
+        process->untracked_vranges  = lnx_dmn_untracked_vranges_from_pid(process->untracked_arena, process->pid);
+        process->is_untracked_valid = 1;
+      }
+      
+      // ranges which touch an untracked mapping fall back to the global generation
+      B32 is_untracked = 0;
+      {
+        Rng1U64Array vranges = process->untracked_vranges;
+        U64 lo = 0, hi = vranges.count;
+        while(lo < hi)
+        {
+          U64 mid = lo + (hi - lo) / 2;
+          if(vranges.v[mid].max <= range.min) { lo = mid + 1; }
+          else                                { hi = mid; }
+        }
+        is_untracked = (lo < vranges.count && vranges.v[lo].min < range.max);
+      }
+      
+      U64 page_size  = get_system_info()->page_size;
+      U64 block_size = page_size * LNX_DMN_PAGE_TRACK_BLOCK_PAGES;
+      for(U64 page_vaddr = AlignDownPow2(range.min, page_size); !is_untracked && page_vaddr < range.max; page_vaddr += page_size)
+      {
+        // start tracking pages on first query
+        U64                     block_base = AlignDownPow2(page_vaddr, block_size);
+        LNX_DMN_PageTrackBlock *block      = hash_table_search_u64_raw(process->page_track_ht, block_base);
+        if(block == 0)
+        {
+          block = push_array(process->page_track_arena, LNX_DMN_PageTrackBlock, 1);
+          block->base_vaddr = block_base;
+          SLLStackPush(process->first_page_track_block, block);
+          process->page_track_block_count += 1;
+          hash_table_push_u64_raw(process->page_track_arena, process->page_track_ht, block_base, block);
+        }
+        U64 page_idx = (page_vaddr - block_base) / page_size;
+        if(!(block->tracked_mask & (1ull << page_idx)))
+        {
+          block->tracked_mask |= (1ull << page_idx);
+          block->gens[page_idx] = process->page_gen;
+        }
+        result = Max(result, block->gens[page_idx]);
+      }
+    }
   }
-  LNX_DMN_ActiveTrap *result = push_array(arena, LNX_DMN_ActiveTrap, 1);
-  result->good = (good_read && good_write);
-  result->trap = trap;
-  result->swap_bytes = str8(swap_bytes, trap_inst.size);
   return result;
 }
 
@@ -657,6 +1558,8 @@ lnx_dmn_process_alloc(pid_t pid, LNX_DMN_ProcessState state, LNX_DMN_Process *pa
   process->debug_subprocesses = debug_subprocesses;
   process->is_cow             = is_cow;
   process->parent_process     = parent_process;
+  process->trap_arena         = arena_alloc();
+  lnx_dmn_process_page_tracking_open(process);
   
   // update pending process tracker
   if(state != LNX_DMN_ProcessState_Normal)
@@ -787,7 +1690,7 @@ lnx_dmn_thread_alloc(LNX_DMN_Process *process, LNX_DMN_ThreadState thread_state,
   thread->reg_block = reg_block;
   if(thread_state == LNX_DMN_ThreadState_Stopped)
   {
-    thread->is_reg_block_dirty = !lnx_dmn_thread_read_reg_block(thread);
+    thread->is_reg_block_dirty = !lnx_dmn_thread_read_stop_reg_block(thread);
   }
   
   // add thread to the list
@@ -892,6 +1795,18 @@ lnx_dmn_process_release(LNX_DMN_Process *process)
   // close memory handle
   if(LNX_RETRY_ON_EINTR(close(process->fd)) < 0) { Assert(0 && "failed to close memory descriptor"); }
   
+  // close page tracking handles
+  lnx_dmn_process_page_tracking_close(process);
+  
+  // drop installed traps; the memory they were written to is gone
+  RWMutexScope(lnx_dmn_state->installed_traps_rw_mutex, 1)
+  {
+    arena_release(process->trap_arena);
+    process->trap_arena           = 0;
+    process->installed_traps      = 0;
+    process->installed_trap_count = 0;
+  }
+  
   // remove pid mapping
   hash_table_purge_u64(lnx_dmn_state->pid_ht, process->pid);
   
@@ -1015,6 +1930,22 @@ lnx_dmn_process_ctx_clone(LNX_DMN_Process *new_owner, LNX_DMN_ProcessCtx *ctx)
     SLLQueuePush(result->first_probe_trap, result->last_probe_trap, dst);
   }
   
+  // clone condition trampolines; the child has the same mappings
+  for EachNode(src, LNX_DMN_CondCodeBlock, ctx->first_cond_code_block)
+  {
+    LNX_DMN_CondCodeBlock *dst = push_array(result->arena, LNX_DMN_CondCodeBlock, 1);
+    dst->vaddr_range = src->vaddr_range;
+    dst->used_size   = src->used_size;
+    SLLStackPush(result->first_cond_code_block, dst);
+  }
+  for EachNode(src, LNX_DMN_CondTrampoline, ctx->first_cond_trampoline)
+  {
+    LNX_DMN_CondTrampoline *dst = push_array(result->arena, LNX_DMN_CondTrampoline, 1);
+    *dst = *src;
+    dst->next = 0;
+    SLLStackPush(result->first_cond_trampoline, dst);
+  }
+  
   // clone modules
   for EachNode(module, LNX_DMN_Module, ctx->first_module)
   {
@@ -1172,6 +2103,7 @@ lnx_dmn_thread_write_ip(LNX_DMN_Thread *thread, U64 ip)
   ARCH_Info *arch_info = arch_info_from_arch(thread->process->ctx->arch);
   arch_reg_block_write_ip(arch_info, thread->reg_block, ip);
   thread->is_reg_block_dirty = 1;
+  thread->reg_block_dirty_parts |= LNX_DMN_RegBlockPart_Gprs;
 }
 
 internal void
@@ -1180,10 +2112,11 @@ lnx_dmn_thread_write_sp(LNX_DMN_Thread *thread, U64 sp)
   ARCH_Info *arch_info = arch_info_from_arch(thread->process->ctx->arch);
   arch_reg_block_write_sp(arch_info, thread->reg_block, sp);
   thread->is_reg_block_dirty = 1;
+  thread->reg_block_dirty_parts |= LNX_DMN_RegBlockPart_Gprs;
 }
 
 internal B32
-lnx_dmn_thread_read_reg_block(LNX_DMN_Thread *thread)
+lnx_dmn_thread_read_reg_block(LNX_DMN_Thread *thread, LNX_DMN_RegBlockParts parts)
 {
   B32 is_reg_block_read = 0;
   if(thread->state == LNX_DMN_ThreadState_Stopped)
@@ -1197,6 +2130,7 @@ lnx_dmn_thread_read_reg_block(LNX_DMN_Thread *thread)
         X64_RegBlock *dst = thread->reg_block;
         
         // general purpose registers
+        if(parts & LNX_DMN_RegBlockPart_Gprs)
         {
           LNX_DMN_GprsX64 src;
           int ptrace_result = LNX_RETRY_ON_EINTR(ptrace(PTRACE_GETREGSET, thread->tid, (void *)NT_PRSTATUS, &(struct iovec){ .iov_len = sizeof(src), .iov_base = &src }));
@@ -1232,6 +2166,7 @@ lnx_dmn_thread_read_reg_block(LNX_DMN_Thread *thread)
         }
         
         // xsave
+        if(parts & LNX_DMN_RegBlockPart_XState)
         {
           Temp scratch = scratch_begin(0, 0);
           
@@ -1350,6 +2285,7 @@ lnx_dmn_thread_read_reg_block(LNX_DMN_Thread *thread)
         }
         
         // debug registers
+        if(parts & LNX_DMN_RegBlockPart_DebugRegs)
         {
           U64 *dr_d = &dst->dr0;
           for EachIndex(n, 8)
@@ -1370,15 +2306,62 @@ lnx_dmn_thread_read_reg_block(LNX_DMN_Thread *thread)
     }
   }
   exit:;
+  if(is_reg_block_read)
+  {
+    thread->reg_block_read_parts  |= parts;
+    thread->reg_block_dirty_parts &= ~parts;
+  }
   return is_reg_block_read;
 }
 
+internal B32
+lnx_dmn_thread_read_stop_reg_block(LNX_DMN_Thread *thread)
+{
+  LNX_DMN_RegBlockParts parts = LNX_DMN_RegBlockPart_Volatile | (LNX_DMN_RegBlockPart_All & ~thread->reg_block_read_parts);
+  return lnx_dmn_thread_read_reg_block(thread, parts);
+}
+
+internal LNX_DMN_RegBlockParts
+lnx_dmn_reg_block_parts_from_diff(Arch arch, void *a, void *b)
+{
+  LNX_DMN_RegBlockParts parts = 0;
+  switch(arch)
+  {
+    default:{parts = LNX_DMN_RegBlockPart_All;}break;
+    case Arch_x64:
+    {
+      U8 *a_bytes = a;
+      U8 *b_bytes = b;
+      U64 dr_off   = OffsetOf(X64_RegBlock, dr0);
+      U64 st_off   = OffsetOf(X64_RegBlock, st0);
+      U64 seg_off  = OffsetOf(X64_RegBlock, ss);
+      U64 zmm_off  = OffsetOf(X64_RegBlock, zmm0);
+      if(!MemoryMatch(a_bytes, b_bytes, dr_off) ||
+         !MemoryMatch(a_bytes + seg_off, b_bytes + seg_off, zmm_off - seg_off))
+      {
+        parts |= LNX_DMN_RegBlockPart_Gprs;
+      }
+      if(!MemoryMatch(a_bytes + dr_off, b_bytes + dr_off, st_off - dr_off))
+      {
+        parts |= LNX_DMN_RegBlockPart_DebugRegs;
+      }
+      if(!MemoryMatch(a_bytes + st_off, b_bytes + st_off, seg_off - st_off) ||
+         !MemoryMatch(a_bytes + zmm_off, b_bytes + zmm_off, sizeof(X64_RegBlock) - zmm_off))
+      {
+        parts |= LNX_DMN_RegBlockPart_XState;
+      }
+    }break;
+  }
+  return parts;
+}
+
 internal B32
 lnx_dmn_thread_write_reg_block(LNX_DMN_Thread *thread)
 {
   AssertAlways(thread->state == LNX_DMN_ThreadState_Stopped);
   
   B32 is_reg_block_written = 0;
+  LNX_DMN_RegBlockParts parts = thread->reg_block_dirty_parts;
   
   switch(thread->process->ctx->arch)
   {
@@ -1389,6 +2372,7 @@ lnx_dmn_thread_write_reg_block(LNX_DMN_Thread *thread)
       X64_RegBlock   *src         = thread->reg_block;
       
       // general purpose registers
+      if(parts & LNX_DMN_RegBlockPart_Gprs)
       {
         LNX_DMN_GprsX64 dst;
         dst.r15      = src->r15;
@@ -1423,6 +2407,7 @@ lnx_dmn_thread_write_reg_block(LNX_DMN_Thread *thread)
       }
       
       // xsave
+      if(parts & LNX_DMN_RegBlockPart_XState)
       {
         Temp scratch = scratch_begin(0, 0);
         
@@ -1541,6 +2526,7 @@ lnx_dmn_thread_write_reg_block(LNX_DMN_Thread *thread)
       }
       
       // debug registers
+      if(parts & LNX_DMN_RegBlockPart_DebugRegs)
       {
         src->dr7 |= (1 << 10);
         
@@ -1565,6 +2551,10 @@ lnx_dmn_thread_write_reg_block(LNX_DMN_Thread *thread)
   }
   
   exit:;
+  if(is_reg_block_written)
+  {
+    thread->reg_block_dirty_parts = 0;
+  }
   return is_reg_block_written;
 }
 
@@ -1581,6 +2571,7 @@ lnx_dmn_set_single_step_flag(LNX_DMN_Thread *thread, B32 is_on)
       if(is_on) { reg_block->rflags |= X64_RFlag_Trap;  }
       else      { reg_block->rflags &= ~X64_RFlag_Trap; }
       thread->is_reg_block_dirty = 1;
+      thread->reg_block_dirty_parts |= LNX_DMN_RegBlockPart_Gprs;
       is_flag_set = 1;
     } break;
     case Arch_x86:
@@ -1921,6 +2912,7 @@ lnx_dmn_event_load_module(Arena *arena, DMN_EventList *events, LNX_DMN_Thread *t
     {
       process->is_cow = 0;
       process->ctx    = lnx_dmn_process_ctx_clone(process, process->ctx);
+      lnx_dmn_process_rebind_installed_traps(process);
     }
     
     // alloc module
@@ -1974,12 +2966,19 @@ lnx_dmn_event_unload_module(Arena *arena, DMN_EventList *events, LNX_DMN_Process
     {
       process->is_cow = 0;
       process->ctx    = lnx_dmn_process_ctx_clone(process, process->ctx);
+      lnx_dmn_process_rebind_installed_traps(process);
     }
   }
   
   // push events and clean up unloaded modules
   for EachNode(module_n, LNX_DMN_ModulePtrNode, to_release.first)
   {
+    // the module's memory is gone; whatever is mapped there next must not
+    // get its bytes overwritten with the old ones
+    RWMutexScope(lnx_dmn_state->installed_traps_rw_mutex, 1)
+    {
+      lnx_dmn_process_remove_installed_traps(process, r1u64(module_n->v->base_vaddr, module_n->v->base_vaddr + module_n->v->size), 0);
+    }
     lnx_dmn_push_event_unload_module(arena, events, process, module_n->v);
     lnx_dmn_module_release(process->ctx, module_n->v);
   }
@@ -2002,7 +3001,8 @@ lnx_dmn_event_breakpoint(Arena *arena, DMN_EventList *events, LNX_DMN_ActiveTrap
     {
       if(MemoryCompare(&active_trap->trap->process, &process_handle, sizeof(DMN_Handle)) == 0)
       {
-        if(active_trap->trap->vaddr == ip-1)
+        if(active_trap->trap->vaddr == ip-1 ||
+           (active_trap->trampoline != 0 && active_trap->trampoline->trap_vaddr == ip-1))
         {
           hit_user_trap = active_trap;
           break;
@@ -2077,11 +3077,11 @@ lnx_dmn_event_breakpoint(Arena *arena, DMN_EventList *events, LNX_DMN_ActiveTrap
   
   if(probe_type == LNX_DMN_ProbeType_Null)
   {
-    // rollback IP on user traps
+    // rollback IP on user traps; traps in condition trampolines roll back to
+    // their sites
     if(hit_user_trap)
     {
-      U64 ip = lnx_dmn_thread_read_ip(thread);
-      lnx_dmn_thread_write_ip(thread, ip - 1);
+      lnx_dmn_thread_write_ip(thread, hit_user_trap->trap->vaddr);
     }
     
     DMN_Event *e = dmn_event_list_push(arena, events);
@@ -2097,6 +3097,9 @@ lnx_dmn_event_data_breakpoint(Arena *arena, DMN_EventList *events, pid_t tid)
 {
   LNX_DMN_Thread *thread = lnx_dmn_thread_from_pid(tid);
   
+  // the hit is reported in the debug status register, which stops don't re-read
+  lnx_dmn_thread_read_reg_block(thread, LNX_DMN_RegBlockPart_DebugRegs);
+  
   B32 is_valid = 1;
   U64 address  = 0;
   switch(thread->process->ctx->arch)
@@ -2233,8 +3236,17 @@ dmn_init(void)
     lnx_dmn_state->tid_ht         = hash_table_init(lnx_dmn_state->arena, 0x2000);
     lnx_dmn_state->pid_ht         = hash_table_init(lnx_dmn_state->arena, 0x400);
     lnx_dmn_state->halter_mutex   = mutex_alloc();
+    lnx_dmn_state->installed_traps_rw_mutex = rw_mutex_alloc();
     lnx_dmn_entity_alloc(LNX_DMN_EntityKind_Null);
     
+    // probe for soft-dirty page tracking
+    lnx_dmn_state->is_soft_dirty_supported = lnx_dmn_soft_dirty_is_supported();
+    lnx_dmn_state->is_soft_dirty_enabled   = lnx_dmn_state->is_soft_dirty_supported;
+    lnx_dmn_state->page_track_mutex        = mutex_alloc();
+    
+    // assume process_vm_readv is available until the kernel says otherwise
+    lnx_dmn_state->is_vm_readv_supported = 1;
+    
     // find offsets of TLS index and TLS offset in the link_map struct
     // 
     // TODO: assuming that target is using same libc version as debugger
@@ -2401,6 +3413,10 @@ dmn_ctrl_detach(DMN_CtrlCtx *ctx, DMN_Handle process_handle)
   LNX_DMN_Process *process = lnx_dmn_process_from_handle(process_handle);
   if(process)
   {
+    RWMutexScope(lnx_dmn_state->installed_traps_rw_mutex, 1)
+    {
+      lnx_dmn_process_remove_installed_traps(process, r1u64(0, max_U64), 1);
+    }
     result = LNX_RETRY_ON_EINTR(ptrace(PTRACE_DETACH, process->pid, 0, 0)) >= 0;
   }
   mutex_drop(lnx_dmn_state->halter_mutex);
@@ -2418,49 +3434,83 @@ dmn_ctrl_run(Arena *arena, DMN_CtrlCtx *ctx, DMN_RunCtrls *ctrls)
   // wait for signals from the running threads
   if(lnx_dmn_state->process_count > 0)
   {
-    // write traps to memory
-    LNX_DMN_ActiveTrap *active_trap_first = 0, *active_trap_last = 0;
+    // gather software traps per process
+    HashTable *process_ht = hash_table_init(scratch.arena, lnx_dmn_state->process_count);
+    for EachNode(process, LNX_DMN_Process, lnx_dmn_state->first_process)
+    {
+      LNX_DMN_TrapPtrArray *process_traps = push_array(scratch.arena, LNX_DMN_TrapPtrArray, 1);
+      process_traps->v = push_array_no_zero(scratch.arena, DMN_Trap *, ctrls->traps.trap_count);
+      hash_table_push_u64_raw(scratch.arena, process_ht, lnx_dmn_handle_from_process(process).u64[0], process_traps);
+    }
+    for EachNode(n, DMN_TrapChunkNode, ctrls->traps.first)
+    {
+      for EachIndex(n_idx, n->count)
+      {
+        // skip hardware breakpoints
+        DMN_Trap *trap = n->v+n_idx;
+        if(trap->flags) { continue; }
+        
+        // TODO: ctrl sends down traps for exited process
+        LNX_DMN_TrapPtrArray *process_traps = hash_table_search_u64_raw(process_ht, trap->process.u64[0]);
+        if(process_traps == 0) { continue; }
+        
+        process_traps->v[process_traps->count] = trap;
+        process_traps->count += 1;
+      }
+    }
+    
+    // patch the difference between the requested & installed traps
+    //
+    // a single step only runs one instruction of one thread, so traps which
+    // aren't requested stay in place unless they cover that instruction, and
+    // the next run doesn't have to write them back. condition jumps are only
+    // used when not single-stepping.
+    B32 is_single_step = !dmn_handle_match(ctrls->single_step_thread, dmn_handle_zero());
+    LNX_DMN_Thread *single_step_thread = lnx_dmn_thread_from_handle(ctrls->single_step_thread);
+    RWMutexScope(lnx_dmn_state->installed_traps_rw_mutex, 1)
     {
-      HashTable *process_ht = hash_table_init(scratch.arena, lnx_dmn_state->process_count);
-      for EachNode(n, DMN_TrapChunkNode, ctrls->traps.first)
+      for EachNode(process, LNX_DMN_Process, lnx_dmn_state->first_process)
       {
-        for EachIndex(n_idx, n->count)
+        Rng1U64 keep_exclude_range = {0};
+        if(single_step_thread != 0 && single_step_thread->process == process)
         {
-          // skip hardware breakpoints
-          DMN_Trap *trap = n->v+n_idx;
-          if(trap->flags) { continue; }
-          
-          HashTable *active_trap_ht = hash_table_search_u64_raw(process_ht, trap->process.u64[0]);
-          if(active_trap_ht == 0)
-          {
-            active_trap_ht = hash_table_init(scratch.arena, ctrls->traps.trap_count);
-            hash_table_push_u64_raw(scratch.arena, process_ht, trap->process.u64[0], active_trap_ht);
-          }
-          
-          // TODO: ctrl sends down duplicate traps
-          LNX_DMN_ActiveTrap *is_set = hash_table_search_u64_raw(active_trap_ht, trap->vaddr);
-          if(is_set) { continue; }
-          
-          // TODO: ctrl sends down traps for exited process
-          LNX_DMN_Process *process = lnx_dmn_process_from_handle(trap->process);
-          if(!process) { continue; }
-          
-          // trap instruction
-          LNX_DMN_ActiveTrap *active_trap = lnx_dmn_set_trap(scratch.arena, trap);
-          
-          // add trap to the active list
-          SLLQueuePush(active_trap_first, active_trap_last, active_trap);
-          
-          // add (address -> trap)
-          hash_table_push_u64_raw(scratch.arena, active_trap_ht, trap->vaddr, active_trap);
+          U64 ip = lnx_dmn_thread_read_ip(single_step_thread);
+          keep_exclude_range = r1u64(ip, ip + LNX_DMN_MAX_INSTRUCTION_SIZE);
         }
+        LNX_DMN_TrapPtrArray *process_traps = hash_table_search_u64_raw(process_ht, lnx_dmn_handle_from_process(process).u64[0]);
+        lnx_dmn_process_sync_traps(process, process_traps->v, process_traps->count, !is_single_step, is_single_step, keep_exclude_range);
+      }
+    }
+    
+    // every installed trap is active; copies keep them valid if their
+    // process exits during the wait
+    LNX_DMN_ActiveTrap *active_trap_first = 0, *active_trap_last = 0;
+    for EachNode(process, LNX_DMN_Process, lnx_dmn_state->first_process)
+    {
+      U64                    count           = process->installed_trap_count;
+      LNX_DMN_InstalledTrap *installed_traps = push_array_no_zero(scratch.arena, LNX_DMN_InstalledTrap, count);
+      LNX_DMN_ActiveTrap    *active_traps    = push_array(scratch.arena, LNX_DMN_ActiveTrap, count);
+      MemoryCopy(installed_traps, process->installed_traps, count*sizeof(installed_traps[0]));
+      for EachIndex(idx, count)
+      {
+        LNX_DMN_ActiveTrap *active_trap = &active_traps[idx];
+        active_trap->good       = 1;
+        active_trap->trap       = &installed_traps[idx].trap;
+        active_trap->swap_bytes = str8(installed_traps[idx].swap_bytes, installed_traps[idx].swap_bytes_size);
+        active_trap->trampoline = installed_traps[idx].trampoline;
+        SLLQueuePush(active_trap_first, active_trap_last, active_trap);
       }
     }
     
+    // clear soft-dirty bits, so the next stop can tell which pages this run wrote
+    for EachNode(process, LNX_DMN_Process, lnx_dmn_state->first_process)
+    {
+      lnx_dmn_process_clear_soft_dirty(process);
+    }
+    
     // enable single stepping
-    if(!dmn_handle_match(ctrls->single_step_thread, dmn_handle_zero()))
+    if(is_single_step)
     {
-      LNX_DMN_Thread *single_step_thread = lnx_dmn_thread_from_handle(ctrls->single_step_thread);
       if(single_step_thread)
       {
         lnx_dmn_set_single_step_flag(single_step_thread, 1);
@@ -2740,7 +3790,7 @@ dmn_ctrl_run(Arena *arena, DMN_CtrlCtx *ctx, DMN_RunCtrls *ctrls)
           LNX_DMN_Thread *thread = lnx_dmn_thread_from_pid(wait_id);
           if(thread && thread->state != LNX_DMN_ThreadState_PendingCreation)
           {
-            thread->is_reg_block_dirty = !lnx_dmn_thread_read_reg_block(thread);
+            thread->is_reg_block_dirty = !lnx_dmn_thread_read_stop_reg_block(thread);
             Assert(!thread->is_reg_block_dirty);
           }
         }
@@ -2838,6 +3888,17 @@ dmn_ctrl_run(Arena *arena, DMN_CtrlCtx *ctx, DMN_RunCtrls *ctrls)
             default: { Assert(0 && "unexpected ptrace code"); } break;
           }
         }
+        else if(wstopsig == SIGSTOP && event_code == PTRACE_EVENT_STOP &&
+                lnx_dmn_thread_from_pid(wait_id) != 0 &&
+                lnx_dmn_thread_from_pid(wait_id)->state == LNX_DMN_ThreadState_PendingCreation)
+        {
+          // seized tracees report the initial stop of auto-attached threads
+          // as a group-stop, with SIGSTOP
+          LNX_DMN_Thread *thread = lnx_dmn_thread_from_pid(wait_id);
+          LNX_DMN_Process *process = thread->process;
+          lnx_dmn_thread_release(thread);
+          lnx_dmn_event_create_thread(arena, &events, process, wait_id);
+        }
         else if(wstopsig == SIGSTOP)
         {
           siginfo_t siginfo = {0};
@@ -2856,7 +3917,17 @@ dmn_ctrl_run(Arena *arena, DMN_CtrlCtx *ctx, DMN_RunCtrls *ctrls)
         }
         else
         {
-          lnx_dmn_event_exception(arena, &events, wait_id, wstopsig);
+          // faults in condition trampolines are reported at their sites
+          LNX_DMN_Thread *thread = lnx_dmn_thread_from_pid(wait_id);
+          B32 is_cond_fault = 0;
+          if((wstopsig == SIGSEGV || wstopsig == SIGBUS) && thread != 0 && thread->process->ctx != 0 && thread->process->ctx->first_cond_trampoline != 0)
+          {
+            is_cond_fault = lnx_dmn_event_cond_trampoline_fault(arena, &events, thread, wstopsig);
+          }
+          if(!is_cond_fault)
+          {
+            lnx_dmn_event_exception(arena, &events, wait_id, wstopsig);
+          }
         }
       }
       else { Assert(0 && "unexpected stop code"); }
@@ -2875,21 +3946,24 @@ dmn_ctrl_run(Arena *arena, DMN_CtrlCtx *ctx, DMN_RunCtrls *ctrls)
       lnx_dmn_state->is_halting     = 0;
     }
     
-    // restore original instruction bytes
-    for EachNode(active_trap, LNX_DMN_ActiveTrap, active_trap_first)
+    // threads which were stopped inside condition trampolines finish them, so
+    // nothing is left running trampoline code while the debugger observes it
+    for EachNode(process, LNX_DMN_Process, lnx_dmn_state->first_process)
     {
-      // skip process that exited during the wait
-      LNX_DMN_Process *process = lnx_dmn_process_from_handle(active_trap->trap->process);
-      if(!process) { continue; }
-      
-      if(!dmn_process_write(active_trap->trap->process, r1u64(active_trap->trap->vaddr, active_trap->trap->vaddr + active_trap->swap_bytes.size), active_trap->swap_bytes.str) &&
-         active_trap->good)
+      if(process->ctx != 0 && process->ctx->first_cond_trampoline != 0)
       {
-        // TODO(rjf): log an error here? - we wrote the trap successfully, but we did not remove it successfully,
-        // implying a change in address mapping. this is maybe not even a bug, since the address is simply now
-        // unmapped.
+        for EachNode(thread, LNX_DMN_Thread, process->first_thread)
+        {
+          lnx_dmn_thread_step_out_of_cond_trampoline(arena, &events, thread);
+        }
       }
     }
+    
+    // sweep tracked pages for writes
+    for EachNode(process, LNX_DMN_Process, lnx_dmn_state->first_process)
+    {
+      lnx_dmn_process_sweep_soft_dirty(process);
+    }
   }
   
   if(events.count == 0 && lnx_dmn_state->process_count == 0)
@@ -2955,29 +4029,90 @@ dmn_access_close(void)
 //- rjf: processes
 
 internal U64
-dmn_process_memory_reserve(DMN_Handle process, U64 vaddr, U64 size)
+dmn_process_memory_reserve(DMN_Handle process_handle, U64 vaddr, U64 size)
 {
-  return 0;
+  U64 result = 0;
+  DMN_AccessScope
+  {
+    LNX_DMN_Process *process = lnx_dmn_process_from_handle(process_handle);
+    if(process)
+    {
+      int flags = MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE;
+      S64 mmap_result = -1;
+      if(vaddr != 0)
+      {
+        mmap_result = lnx_dmn_process_syscall(process, SYS_mmap, vaddr, size, PROT_NONE, flags|MAP_FIXED_NOREPLACE, max_U64, 0);
+      }
+      if(mmap_result < 0)
+      {
+        mmap_result = lnx_dmn_process_syscall(process, SYS_mmap, 0, size, PROT_NONE, flags, max_U64, 0);
+      }
+      if(mmap_result > 0)
+      {
+        result = (U64)mmap_result;
+      }
+    }
+  }
+  return result;
 }
 
 internal void
-dmn_process_memory_commit(DMN_Handle process, U64 vaddr, U64 size)
+dmn_process_memory_commit(DMN_Handle process_handle, U64 vaddr, U64 size)
 {
+  DMN_AccessScope
+  {
+    LNX_DMN_Process *process = lnx_dmn_process_from_handle(process_handle);
+    if(process)
+    {
+      lnx_dmn_process_syscall(process, SYS_mprotect, vaddr, size, PROT_READ|PROT_WRITE, 0, 0, 0);
+      lnx_dmn_process_mark_pages_dirty(process, r1u64(vaddr, vaddr + size));
+    }
+  }
 }
 
 internal void
-dmn_process_memory_decommit(DMN_Handle process, U64 vaddr, U64 size)
+dmn_process_memory_decommit(DMN_Handle process_handle, U64 vaddr, U64 size)
 {
+  DMN_AccessScope
+  {
+    LNX_DMN_Process *process = lnx_dmn_process_from_handle(process_handle);
+    if(process)
+    {
+      lnx_dmn_process_syscall(process, SYS_mmap, vaddr, size, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE|MAP_FIXED, max_U64, 0);
+      lnx_dmn_process_mark_pages_dirty(process, r1u64(vaddr, vaddr + size));
+    }
+  }
 }
 
 internal void
-dmn_process_memory_release(DMN_Handle process, U64 vaddr, U64 size)
+dmn_process_memory_release(DMN_Handle process_handle, U64 vaddr, U64 size)
 {
+  DMN_AccessScope
+  {
+    LNX_DMN_Process *process = lnx_dmn_process_from_handle(process_handle);
+    if(process)
+    {
+      lnx_dmn_process_syscall(process, SYS_munmap, vaddr, size, 0, 0, 0, 0);
+      lnx_dmn_process_mark_pages_dirty(process, r1u64(vaddr, vaddr + size));
+    }
+  }
 }
 
 internal void
-dmn_process_memory_protect(DMN_Handle process, U64 vaddr, U64 size, AccessFlags flags)
+dmn_process_memory_protect(DMN_Handle process_handle, U64 vaddr, U64 size, AccessFlags flags)
 {
+  DMN_AccessScope
+  {
+    LNX_DMN_Process *process = lnx_dmn_process_from_handle(process_handle);
+    if(process)
+    {
+      int prot = PROT_NONE;
+      if(flags & AccessFlag_Read)    { prot |= PROT_READ; }
+      if(flags & AccessFlag_Write)   { prot |= PROT_WRITE; }
+      if(flags & AccessFlag_Execute) { prot |= PROT_EXEC; }
+      lnx_dmn_process_syscall(process, SYS_mprotect, vaddr, size, prot, 0, 0, 0);
+    }
+  }
 }
 
 internal U64
@@ -2987,7 +4122,39 @@ dmn_process_read(DMN_Handle process_handle, Rng1U64 range, void *dst)
   U64 result = 0;
   if(process)
   {
-    result = lnx_dmn_read(process->fd, range, dst);
+    RWMutexScope(lnx_dmn_state->installed_traps_rw_mutex, 0)
+    {
+      result = lnx_dmn_process_read(process, range, dst);
+    }
+  }
+  return result;
+}
+
+internal U64
+dmn_process_read_many(DMN_Handle process_handle, U64 count, Rng1U64 *ranges, void **dsts, U64 *read_sizes_out)
+{
+  LNX_DMN_Process *process = lnx_dmn_process_from_handle(process_handle);
+  U64 result = 0;
+  if(read_sizes_out)
+  {
+    MemoryZeroTyped(read_sizes_out, count);
+  }
+  if(process)
+  {
+    Temp scratch = scratch_begin(0, 0);
+    U64 *read_sizes = (read_sizes_out ? read_sizes_out : push_array(scratch.arena, U64, count));
+    RWMutexScope(lnx_dmn_state->installed_traps_rw_mutex, 0)
+    {
+      result = lnx_dmn_read_many(process->pid, process->fd, count, ranges, dsts, read_sizes);
+      if(process->installed_trap_count != 0)
+      {
+        for EachIndex(idx, count)
+        {
+          lnx_dmn_process_overlay_installed_traps(process, r1u64(ranges[idx].min, ranges[idx].min + read_sizes[idx]), dsts[idx]);
+        }
+      }
+    }
+    scratch_end(scratch);
   }
   return result;
 }
@@ -2995,11 +4162,36 @@ dmn_process_read(DMN_Handle process_handle, Rng1U64 range, void *dst)
 internal B32
 dmn_process_write(DMN_Handle process_handle, Rng1U64 range, void *src)
 {
-  LNX_DMN_Process *process = lnx_dmn_process_from_handle(process_handle);
   B32 result = 0;
-  if(process)
+  DMN_AccessScope
+  {
+    LNX_DMN_Process *process = lnx_dmn_process_from_handle(process_handle);
+    if(process)
+    {
+      // traps under the write are restored first; the next run reinstalls
+      // them over the new bytes
+      RWMutexScope(lnx_dmn_state->installed_traps_rw_mutex, 1)
+      {
+        lnx_dmn_process_remove_installed_traps(process, range, 1);
+        result = lnx_dmn_write(process->fd, range, src);
+      }
+      lnx_dmn_process_mark_pages_dirty(process, range);
+    }
+  }
+  return result;
+}
+
+internal U64
+dmn_process_memory_gen_from_range(DMN_Handle process_handle, Rng1U64 range)
+{
+  U64 result = 0;
+  DMN_AccessScope
   {
-    result = lnx_dmn_write(process->fd, range, src);
+    LNX_DMN_Process *process = lnx_dmn_process_from_handle(process_handle);
+    if(process)
+    {
+      result = lnx_dmn_process_page_gen_from_range(process, range);
+    }
   }
   return result;
 }
@@ -3087,6 +4279,7 @@ dmn_thread_write_reg_block(DMN_Handle thread_handle, void *reg_block)
     {
       ARCH_Info *arch_info = arch_info_from_arch(thread->process->ctx->arch);
       U64 reg_block_size = arch_info->reg_block_size;
+      thread->reg_block_dirty_parts |= lnx_dmn_reg_block_parts_from_diff(thread->process->ctx->arch, thread->reg_block, reg_block);
       MemoryCopy(thread->reg_block, reg_block, reg_block_size);
       thread->is_reg_block_dirty = 1;
       result = 1;
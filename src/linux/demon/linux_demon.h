@@ -145,6 +145,115 @@ typedef struct LNX_DMN_DynamicInfo
   U64 symtab_entry_size;
 } LNX_DMN_DynamicInfo;
 
+////////////////////////////////
+//~ Condition Trampolines
+//
+// Software traps which carry native condition code (see `DMN_Trap`) are armed
+// by overwriting their site instruction with a jump to a condition trampoline
+// (see `x64_cond_trampoline_from_code`), so the debuggee only stops when the
+// condition holds. Trampolines are written into code blocks which are mapped
+// into the debuggee near their sites, so that rel32 jumps can reach them, &
+// are kept across runs, keyed by site, condition code, & site instruction.
+
+#define LNX_DMN_COND_CODE_BLOCK_SIZE        KB(64)
+#define LNX_DMN_COND_CODE_BLOCK_HINT_STRIDE MB(64)
+#define LNX_DMN_COND_CODE_BLOCK_HINT_COUNT  16
+#define LNX_DMN_COND_STEP_OUT_MAX           4096
+
+typedef struct LNX_DMN_CondCodeBlock
+{
+  struct LNX_DMN_CondCodeBlock *next;
+  Rng1U64 vaddr_range;
+  U64     used_size;
+} LNX_DMN_CondCodeBlock;
+
+typedef struct LNX_DMN_CondTrampoline
+{
+  struct LNX_DMN_CondTrampoline *next;
+  U64     site_vaddr;
+  U64     hash;
+  Rng1U64 vaddr_range;
+  Rng1U64 cond_vaddr_range;
+  U64     trap_vaddr;
+  Rng1U64 site_inst_vaddr_range;
+} LNX_DMN_CondTrampoline;
+
+////////////////////////////////
+//~ rjf: Active Trap Data Structure
+
+typedef struct LNX_DMN_ActiveTrap LNX_DMN_ActiveTrap;
+struct LNX_DMN_ActiveTrap
+{
+  LNX_DMN_ActiveTrap *next;
+  B32 good;
+  DMN_Trap *trap;
+  String8 swap_bytes;
+  LNX_DMN_CondTrampoline *trampoline; // nonzero if armed with a jump, rather than a trap instruction
+};
+
+////////////////////////////////
+//~ Installed Traps
+//
+// Software traps stay in memory across runs; each run only patches the
+// difference between the requested traps & the installed ones. Installed
+// traps never overlap, & are sorted by address, so that reads can overlay
+// their original bytes.
+
+#define LNX_DMN_INSTALLED_TRAP_SWAP_CAP 8
+
+// single steps keep traps which aren't requested, except within this many
+// bytes of the stepped instruction (longest x64 instruction is 15 bytes)
+#define LNX_DMN_MAX_INSTRUCTION_SIZE 16
+
+typedef struct LNX_DMN_InstalledTrap LNX_DMN_InstalledTrap;
+struct LNX_DMN_InstalledTrap
+{
+  DMN_Trap                trap; // condition code is not retained
+  LNX_DMN_CondTrampoline *trampoline; // nonzero if armed with a jump, rather than a trap instruction
+  U64                     swap_bytes_size;
+  U8                      swap_bytes[LNX_DMN_INSTALLED_TRAP_SWAP_CAP];
+};
+
+typedef struct LNX_DMN_TrapPtrArray LNX_DMN_TrapPtrArray;
+struct LNX_DMN_TrapPtrArray
+{
+  DMN_Trap **v;
+  U64        count;
+};
+
+////////////////////////////////
+//~ Batched Reads
+
+// process_vm_readv rejects more iovecs than this (UIO_MAXIOV)
+#define LNX_DMN_READ_MANY_IOV_MAX 1024
+
+////////////////////////////////
+//~ Soft-Dirty Page Tracking
+//
+// The kernel sets the soft-dirty bit of a /proc/pid/pagemap entry whenever a
+// page is written after the last write of "4" to /proc/pid/clear_refs. Pages
+// the debugger has asked about are tracked in blocks of 64; the soft-dirty bits
+// are cleared before the process resumes, and swept when it stops. Pages which
+// were written (or unmapped) get a new generation number, so the debugger's
+// memory cache only re-reads pages which actually changed.
+//
+// Only this process' own writes set the bit. Shared and writable file-backed
+// mappings can also change through other processes or the page cache, so
+// ranges which touch them are not tracked.
+
+#define LNX_DMN_PAGEMAP_SOFT_DIRTY_BIT (1ull << 55)
+#define LNX_DMN_PAGEMAP_SWAPPED_BIT    (1ull << 62)
+#define LNX_DMN_PAGEMAP_PRESENT_BIT    (1ull << 63)
+#define LNX_DMN_PAGE_TRACK_BLOCK_PAGES 64
+
+typedef struct LNX_DMN_PageTrackBlock
+{
+  struct LNX_DMN_PageTrackBlock *next;
+  U64 base_vaddr;
+  U64 tracked_mask;
+  U64 gens[LNX_DMN_PAGE_TRACK_BLOCK_PAGES];
+} LNX_DMN_PageTrackBlock;
+
 ////////////////////////////////
 //~ Entities
 
@@ -166,6 +275,17 @@ typedef enum LNX_DMN_ThreadState
   LNX_DMN_ThreadState_PendingCreation,
 } LNX_DMN_ThreadState;
 
+// NOTE: debug registers only change when the debugger writes them, or when a
+// hardware breakpoint is hit, so they are not re-read on every stop
+typedef enum
+{
+  LNX_DMN_RegBlockPart_Gprs      = (1 << 0),
+  LNX_DMN_RegBlockPart_XState    = (1 << 1),
+  LNX_DMN_RegBlockPart_DebugRegs = (1 << 2),
+  LNX_DMN_RegBlockPart_Volatile  = LNX_DMN_RegBlockPart_Gprs|LNX_DMN_RegBlockPart_XState,
+  LNX_DMN_RegBlockPart_All       = LNX_DMN_RegBlockPart_Gprs|LNX_DMN_RegBlockPart_XState|LNX_DMN_RegBlockPart_DebugRegs,
+} LNX_DMN_RegBlockParts;
+
 typedef struct LNX_DMN_Thread
 {
   pid_t                   tid;
@@ -173,6 +293,8 @@ typedef struct LNX_DMN_Thread
   struct LNX_DMN_Process *process;
   void                   *reg_block;
   B32                     is_reg_block_dirty;
+  LNX_DMN_RegBlockParts   reg_block_read_parts;
+  LNX_DMN_RegBlockParts   reg_block_dirty_parts;
   B32                     pass_through_signal;
   U64                     pass_through_signo;
   U64                     orig_rax;
@@ -259,6 +381,22 @@ typedef struct LNX_DMN_Process
   struct LNX_DMN_Process    *parent_process;
   struct LNX_DMN_ProcessCtx *ctx;
   
+  // soft-dirty page tracking
+  int                     pagemap_fd;
+  int                     clear_refs_fd;
+  Arena                  *page_track_arena;
+  HashTable              *page_track_ht; // block base vaddr -> LNX_DMN_PageTrackBlock
+  LNX_DMN_PageTrackBlock *first_page_track_block;
+  U64                     page_track_block_count;
+  U64                     page_gen;
+  Arena                  *untracked_arena;
+  Rng1U64Array            untracked_vranges;  // sorted; valid until the process resumes
+  B32                     is_untracked_valid;
+  
+  // installed software traps; changed under the installed traps mutex
+  Arena                 *trap_arena;
+  LNX_DMN_InstalledTrap *installed_traps;
+  U64                    installed_trap_count;
   
   struct LNX_DMN_Process *next;
   struct LNX_DMN_Process *prev;
@@ -295,6 +433,10 @@ typedef struct LNX_DMN_ProcessCtx
   String8List free_reg_blocks;
   String8List free_reg_block_nodes;
   
+  // condition trampolines
+  LNX_DMN_CondCodeBlock  *first_cond_code_block;
+  LNX_DMN_CondTrampoline *first_cond_trampoline;
+  
   // x64
   U64             xcr0;
   U64             xsave_size;
@@ -331,18 +473,6 @@ typedef struct LNX_DMN_EntityList
   LNX_DMN_EntityNode *last;
 } LNX_DMN_EntityList;
 
-////////////////////////////////
-//~ rjf: Active Trap Data Structure
-
-typedef struct LNX_DMN_ActiveTrap LNX_DMN_ActiveTrap;
-struct LNX_DMN_ActiveTrap
-{
-  LNX_DMN_ActiveTrap *next;
-  B32 good;
-  DMN_Trap *trap;
-  String8 swap_bytes;
-};
-
 ////////////////////////////////
 //~ Global State
 
@@ -354,6 +484,9 @@ typedef struct LNX_DMN_State
   Mutex access_mutex;
   B32   access_run_state;
   
+  // installed traps are read from any thread, to overlay original bytes
+  RWMutex installed_traps_rw_mutex;
+  
   // rjf: entity storage
   Arena          *entities_arena;
   LNX_DMN_Entity *entities_base;
@@ -383,18 +516,28 @@ typedef struct LNX_DMN_State
   B32            is_tls_detected;
   LNX_DMN_DbDesc tls_modid_desc;
   LNX_DMN_DbDesc tls_offset_desc;
+  
+  // soft-dirty page tracking; page_track_mutex guards every process' tracked
+  // blocks, which are queried from async threads & written by the ctrl thread
+  B32   is_soft_dirty_supported;
+  B32   is_soft_dirty_enabled;
+  Mutex page_track_mutex;
+  
+  // batched reads
+  B32 is_vm_readv_supported;
 } LNX_DMN_State;
 
 ////////////////////////////////
 //~ Globals
 
-global B32            lnx_dmn_ctrl_thread;
+thread_static B32 lnx_dmn_ctrl_thread;
 global LNX_DMN_State *lnx_dmn_state;
 
 ////////////////////////////////
 //~ Memory R/W
 
 internal U64     lnx_dmn_read(int memory_fd, Rng1U64 range, void *dst);
+internal U64     lnx_dmn_read_many(pid_t pid, int memory_fd, U64 count, Rng1U64 *ranges, void **dsts, U64 *read_sizes_out);
 internal B32     lnx_dmn_write(int memory_fd, Rng1U64 range, void *src);
 internal String8 lnx_dmn_read_string_capped(Arena *arena, int memory_fd, U64 base_vaddr, U64 cap_size);
 internal String8 lnx_dmn_read_string(Arena *arena, int memory_fd, U64 base_vaddr);
@@ -406,6 +549,41 @@ internal String8 lnx_dmn_read_string(Arena *arena, int memory_fd, U64 base_vaddr
 
 internal LNX_DMN_ActiveTrap *lnx_dmn_set_trap(Arena *arena, DMN_Trap *trap);
 
+////////////////////////////////
+//~ Remote Syscalls
+
+internal S64 lnx_dmn_process_syscall(LNX_DMN_Process *process, U64 nr, U64 arg0, U64 arg1, U64 arg2, U64 arg3, U64 arg4, U64 arg5);
+
+////////////////////////////////
+//~ Condition Trampolines
+
+internal LNX_DMN_CondTrampoline *lnx_dmn_cond_trampoline_from_trap(LNX_DMN_Process *process, DMN_Trap *trap);
+internal LNX_DMN_CondTrampoline *lnx_dmn_cond_trampoline_from_vaddr(LNX_DMN_ProcessCtx *ctx, U64 vaddr);
+internal B32                     lnx_dmn_event_cond_trampoline_fault(Arena *arena, DMN_EventList *events, LNX_DMN_Thread *thread, U64 signo);
+internal void                    lnx_dmn_thread_step_out_of_cond_trampoline(Arena *arena, DMN_EventList *events, LNX_DMN_Thread *thread);
+
+////////////////////////////////
+//~ Installed Traps
+
+internal U64  lnx_dmn_installed_trap_idx_from_vaddr(LNX_DMN_Process *process, U64 vaddr);
+internal void lnx_dmn_process_overlay_installed_traps(LNX_DMN_Process *process, Rng1U64 range, void *dst);
+internal U64  lnx_dmn_process_read(LNX_DMN_Process *process, Rng1U64 range, void *dst);
+internal void lnx_dmn_process_remove_installed_traps(LNX_DMN_Process *process, Rng1U64 range, B32 restore_bytes);
+internal void lnx_dmn_process_rebind_installed_traps(LNX_DMN_Process *process);
+internal void lnx_dmn_process_sync_traps(LNX_DMN_Process *process, DMN_Trap **traps, U64 trap_count, B32 use_cond_traps, B32 keep_unrequested, Rng1U64 keep_exclude_range);
+
+////////////////////////////////
+//~ Soft-Dirty Page Tracking
+
+internal B32  lnx_dmn_soft_dirty_is_supported(void);
+internal Rng1U64Array lnx_dmn_untracked_vranges_from_pid(Arena *arena, pid_t pid);
+internal void lnx_dmn_process_page_tracking_open(LNX_DMN_Process *process);
+internal void lnx_dmn_process_page_tracking_close(LNX_DMN_Process *process);
+internal void lnx_dmn_process_clear_soft_dirty(LNX_DMN_Process *process);
+internal void lnx_dmn_process_sweep_soft_dirty(LNX_DMN_Process *process);
+internal void lnx_dmn_process_mark_pages_dirty(LNX_DMN_Process *process, Rng1U64 range);
+internal U64  lnx_dmn_process_page_gen_from_range(LNX_DMN_Process *process, Rng1U64 range);
+
 ////////////////////////////////
 //~ ELF/GNU info
 
@@ -471,7 +649,9 @@ internal U64  lnx_dmn_thread_read_ip(LNX_DMN_Thread *thread);
 internal U64  lnx_dmn_thread_read_sp(LNX_DMN_Thread *thread);
 internal void lnx_dmn_thread_write_ip(LNX_DMN_Thread *thread, U64 ip);
 internal void lnx_dmn_thread_write_sp(LNX_DMN_Thread *thread, U64 sp);
-internal B32  lnx_dmn_thread_read_reg_block(LNX_DMN_Thread *thread);
+internal B32  lnx_dmn_thread_read_reg_block(LNX_DMN_Thread *thread, LNX_DMN_RegBlockParts parts);
+internal B32  lnx_dmn_thread_read_stop_reg_block(LNX_DMN_Thread *thread);
+internal LNX_DMN_RegBlockParts lnx_dmn_reg_block_parts_from_diff(Arch arch, void *a, void *b);
 internal B32  lnx_dmn_thread_write_reg_block(LNX_DMN_Thread *thread);
 internal B32  lnx_dmn_set_single_step_flag(LNX_DMN_Thread *thread, B32 is_on);
 
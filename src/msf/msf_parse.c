@@ -226,11 +226,11 @@ msf_raw_stream_table_from_data(Arena *arena, String8 msf_data)
   return result;
 }
 
-internal String8
-msf_data_from_stream_number_ex(Arena *arena, String8 msf_data, MSF_RawStreamTable *st, MSF_StreamNumber sn, Rng1U64 range, U64 align)
+internal U64
+msf_copy_from_stream_number(U8 *dst, String8 msf_data, MSF_RawStreamTable *st, MSF_StreamNumber sn, Rng1U64 range)
 {
   ProfBeginFunction();
-  String8 result = {0};
+  U64 copy_size = 0;
   if(sn < st->stream_count)
   {
     MSF_RawStream stream        = st->streams[sn];
@@ -238,8 +238,6 @@ msf_data_from_stream_number_ex(Arena *arena, String8 msf_data, MSF_RawStreamTabl
     U64           page_count    = CeilIntegerDiv(dim_1u64(range_clamped), st->page_size);
     U64           pn_base       = range_clamped.min / st->page_size;
 
-    result = (String8){ .str = push_array_aligned(arena, U8, dim_1u64(range_clamped), align) };
-
     for EachIndex(page_idx, page_count) {
       U64 pn_begin;
       if (st->index_size == 4) { pn_begin = stream.u.page_indices_u32[pn_base + page_idx]; }
@@ -255,8 +253,8 @@ msf_data_from_stream_number_ex(Arena *arena, String8 msf_data, MSF_RawStreamTabl
       }
       pn_end += 1;
 
-      U64 read_off  = result.size + range_clamped.min;
-      U64 to_read   = dim_1u64(range_clamped) - result.size;
+      U64 read_off  = copy_size + range_clamped.min;
+      U64 to_read   = dim_1u64(range_clamped) - copy_size;
       U64 read_size = Min(to_read, (pn_end - pn_begin) * st->page_size - (read_off % st->page_size));
 
       U64     page_off  = (pn_begin * st->page_size) + (read_off % st->page_size);
@@ -264,17 +262,65 @@ msf_data_from_stream_number_ex(Arena *arena, String8 msf_data, MSF_RawStreamTabl
       if (page.size != read_size) { break; }
 
       // copy page data
-      Assert(result.size + read_size <= dim_1u64(range_clamped));
-      U8 *ptr = result.str + result.size;
-      MemoryCopy(ptr, page.str, read_size);
-      result.size += read_size;
+      Assert(copy_size + read_size <= dim_1u64(range_clamped));
+      MemoryCopy(dst + copy_size, page.str, read_size);
+      copy_size += read_size;
+    }
+  }
+  ProfEnd();
+  return copy_size;
+}
+
+internal String8
+msf_view_from_stream_number(String8 msf_data, MSF_RawStreamTable *st, MSF_StreamNumber sn)
+{
+  String8 result = {0};
+  if(sn < st->stream_count && st->streams[sn].size != 0)
+  {
+    MSF_RawStream stream = st->streams[sn];
+    
+    // check that every page follows the previous one in the file
+    U64 pn_first = (st->index_size == 4 ? stream.u.page_indices_u32[0] : stream.u.page_indices_u16[0]);
+    B32 is_contiguous = 1;
+    for(U64 page_idx = 1; page_idx < stream.page_count; page_idx += 1)
+    {
+      U64 pn = (st->index_size == 4 ? stream.u.page_indices_u32[page_idx] : stream.u.page_indices_u16[page_idx]);
+      if(pn != pn_first + page_idx)
+      {
+        is_contiguous = 0;
+        break;
+      }
+    }
+    
+    // contiguous & fully in the file -> slice
+    if(is_contiguous)
+    {
+      U64     off   = pn_first * st->page_size;
+      String8 slice = str8_substr(msf_data, r1u64(off, off + stream.size));
+      if(slice.size == stream.size)
+      {
+        result = slice;
+      }
     }
+  }
+  return result;
+}
+
+internal String8
+msf_data_from_stream_number_ex(Arena *arena, String8 msf_data, MSF_RawStreamTable *st, MSF_StreamNumber sn, Rng1U64 range, U64 align)
+{
+  String8 result = {0};
+  if(sn < st->stream_count)
+  {
+    MSF_RawStream stream        = st->streams[sn];
+    Rng1U64       range_clamped = { .min = Min(range.min, stream.size), .max = Min(range.max, stream.size) };
+    result.str  = push_array_aligned(arena, U8, dim_1u64(range_clamped), align);
+    result.size = msf_copy_from_stream_number(result.str, msf_data, st, sn, range_clamped);
 
     // release unused bytes
     U64 unused_buf_size = dim_1u64(range_clamped) - result.size;
     arena_pop(arena, unused_buf_size);
   }
-  ProfEnd();
   return result;
 }
 
@@ -287,25 +333,38 @@ msf_data_from_stream_number(Arena *arena, String8 msf_data, MSF_RawStreamTable *
 internal MSF_Parsed *
 msf_parsed_from_data(Arena *arena, String8 msf_data)
 {
-  Temp scratch = scratch_begin(&arena, 1);
-  
+  ProfBeginFunction();
   MSF_Parsed *result = 0;
   
-  MSF_RawStreamTable *st = msf_raw_stream_table_from_data(scratch.arena, msf_data);
+  MSF_RawStreamTable *st = msf_raw_stream_table_from_data(arena, msf_data);
   if (st) {
-    String8 *streams = push_array_no_zero(arena, String8, st->stream_count);
+    result                     = push_array(arena, MSF_Parsed, 1);
+    result->streams            = push_array(arena, String8, st->stream_count);
+    result->stream_count       = st->stream_count;
+    result->page_size          = st->page_size;
+    result->page_count         = st->total_page_count;
+    result->data               = msf_data;
+    result->st                 = st;
+    result->stream_states      = push_array(arena, U32, st->stream_count);
+    result->stream_gather_offs = push_array(arena, U64, st->stream_count);
+    
+    // resolve contiguous streams to slices, & lay out space for the rest
+    U64 gather_size = 0;
     for (MSF_StreamNumber sn = 0; sn < st->stream_count; ++sn) {
-      streams[sn] = msf_data_from_stream_number(arena, msf_data, st, sn);
+      String8 view = msf_view_from_stream_number(msf_data, st, sn);
+      if (view.size == st->streams[sn].size) {
+        result->streams[sn]       = view;
+        result->stream_states[sn] = MSF_StreamState_Ready;
+        result->zero_copy_stream_count += (view.size != 0);
+      } else {
+        result->stream_gather_offs[sn] = gather_size;
+        gather_size += AlignPow2(st->streams[sn].size, 8);
+      }
     }
-    
-    result               = push_array_no_zero(arena, MSF_Parsed, 1);
-    result->streams      = streams;
-    result->stream_count = st->stream_count;
-    result->page_size   = st->page_size;
-    result->page_count  = st->total_page_count;
+    result->gather_buffer = push_array_no_zero_aligned(arena, U8, gather_size, 8);
   }
   
-  scratch_end(scratch);
+  ProfEnd();
   return result;
 }
 
@@ -315,6 +374,33 @@ msf_data_from_stream(MSF_Parsed *msf, MSF_StreamNumber sn)
   String8 result = {0};
   if(sn < msf->stream_count)
   {
+    U32 *state = &msf->stream_states[sn];
+    if(ins_atomic_u32_eval(state) != MSF_StreamState_Ready)
+    {
+      if(ins_atomic_u32_eval_cond_assign(state, MSF_StreamState_Gathering, MSF_StreamState_Ungathered) == MSF_StreamState_Ungathered)
+      {
+        U8 *dst  = msf->gather_buffer + msf->stream_gather_offs[sn];
+        U64 size = msf_copy_from_stream_number(dst, msf->data, msf->st, sn, r1u64(0, max_U64));
+        msf->streams[sn] = str8(dst, size);
+        ins_atomic_u32_eval_assign(state, MSF_StreamState_Ready);
+      }
+      else
+      {
+        // another thread is gathering the stream, which is a single copy; spin
+        // on it briefly, then give up the time slice between checks
+        for(U64 spin_count = 0; ins_atomic_u32_eval(state) != MSF_StreamState_Ready; spin_count += 1)
+        {
+          if(spin_count < 128)
+          {
+            ins_pause();
+          }
+          else
+          {
+            thread_yield();
+          }
+        }
+      }
+    }
     result = msf->streams[sn];
   }
   return(result);
@@ -28,6 +28,18 @@ struct MSF_RawStreamTable
   MSF_RawStream *streams;
 };
 
+typedef enum MSF_StreamState
+{
+  MSF_StreamState_Ungathered,
+  MSF_StreamState_Gathering,
+  MSF_StreamState_Ready,
+}
+MSF_StreamState;
+
+// NOTE: streams whose pages are contiguous in the file are zero-copy slices
+// of `data`; all others are gathered into `gather_buffer` (at a fixed offset
+// per stream, reserved but untouched until then) on their first access, by
+// whichever thread gets there first.
 typedef struct MSF_Parsed MSF_Parsed;
 struct MSF_Parsed
 {
@@ -35,6 +47,14 @@ struct MSF_Parsed
   U64      stream_count;
   U64      page_size;
   U64      page_count;
+  
+  // lazy gathering
+  String8             data;
+  MSF_RawStreamTable *st;
+  U32                *stream_states;
+  U64                *stream_gather_offs;
+  U8                 *gather_buffer;
+  U64                 zero_copy_stream_count;
 };
 
 ////////////////////////////////
@@ -42,6 +62,8 @@ struct MSF_Parsed
 
 internal MSF_RawStreamTable* msf_raw_stream_table_from_data(Arena *arena, String8 msf_data);
 internal U64                 msf_size_from_stream_number(MSF_RawStreamTable *st, MSF_StreamNumber sn);
+internal U64                 msf_copy_from_stream_number(U8 *dst, String8 msf_data, MSF_RawStreamTable *st, MSF_StreamNumber sn, Rng1U64 range);
+internal String8             msf_view_from_stream_number(String8 msf_data, MSF_RawStreamTable *st, MSF_StreamNumber sn);
 internal String8             msf_data_from_stream_number_ex(Arena *arena, String8 msf_data, MSF_RawStreamTable *st, MSF_StreamNumber sn, Rng1U64 range, U64 align);
 internal String8             msf_data_from_stream_number(Arena *arena, String8 msf_data, MSF_RawStreamTable *st, MSF_StreamNumber sn);
 internal MSF_Parsed*         msf_parsed_from_data(Arena *arena, String8 msf_data);
@@ -20,6 +20,7 @@
 #include "rdi_make/rdi_make_local.h"
 #include "coff/coff_inc.h"
 #include "pe/pe.h"
+#include "zstd/zstd.h"
 #include "elf/elf.h"
 #include "gnu/gnu.h"
 #include "elf/elf_parse.h"
@@ -50,6 +51,7 @@
 #include "rdi_make/rdi_make_local.c"
 #include "coff/coff_inc.c"
 #include "pe/pe.c"
+#include "zstd/zstd.c"
 #include "elf/elf.c"
 #include "gnu/gnu.c"
 #include "elf/elf_parse.c"
@@ -16533,6 +16533,10 @@ rd_frame(void)
         {
           flags |= D_BreakpointFlag_BreakOnExecute;
         }
+        if(str8_match(cfg_node_child_from_string(src_bp, str8_lit("in_process_condition"))->first->string, str8_lit("1"), 0))
+        {
+          flags |= D_BreakpointFlag_InProcessCondition;
+        }
         
         //- rjf: compute address range size
         U64 addr_range_size = 0;
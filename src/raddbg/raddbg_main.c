@@ -311,6 +311,7 @@
 #include "coff/coff.h"
 #include "coff/coff_parse.h"
 #include "pe/pe.h"
+#include "zstd/zstd.h"
 #include "elf/elf.h"
 #include "gnu/gnu.h"
 #include "gnu/gnu_parse.h"
@@ -367,6 +368,7 @@
 #include "coff/coff.c"
 #include "coff/coff_parse.c"
 #include "pe/pe.c"
+#include "zstd/zstd.c"
 #include "elf/elf.c"
 #include "gnu/gnu.c"
 #include "gnu/gnu_parse.c"
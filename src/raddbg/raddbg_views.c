@@ -1940,7 +1940,7 @@ RD_VIEW_UI_FUNCTION_DEF(null) {}
 //~ rjf: text @view_hook_impl
 
 internal AC_Artifact
-rd_md5_artifact_create(String8 key, B32 *cancel_out, B32 *retry_out, U64 *gen_out)
+rd_md5_artifact_create(String8 key, B32 *cancel_out, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   AC_Artifact result = {0};
   {
@@ -1957,7 +1957,7 @@ rd_md5_artifact_create(String8 key, B32 *cancel_out, B32 *retry_out, U64 *gen_ou
 }
 
 internal AC_Artifact
-rd_sha1_artifact_create(String8 key, B32 *cancel_out, B32 *retry_out, U64 *gen_out)
+rd_sha1_artifact_create(String8 key, B32 *cancel_out, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   AC_Artifact result = {0};
   {
@@ -1974,7 +1974,7 @@ rd_sha1_artifact_create(String8 key, B32 *cancel_out, B32 *retry_out, U64 *gen_o
 }
 
 internal AC_Artifact
-rd_sha256_artifact_create(String8 key, B32 *cancel_out, B32 *retry_out, U64 *gen_out)
+rd_sha256_artifact_create(String8 key, B32 *cancel_out, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   AC_Artifact result = {0};
   {
@@ -4503,7 +4503,7 @@ struct RD_BitmapCanvasBoxDrawData
 };
 
 internal AC_Artifact
-rd_bitmap_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out)
+rd_bitmap_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   Access *access = access_open();
   
@@ -4523,6 +4523,7 @@ rd_bitmap_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *
      data.size >= (U64)top.dim.x*(U64)top.dim.y*(U64)r_tex2d_format_bytes_per_pixel_table[top.fmt])
   {
     texture = r_tex2d_alloc(R_ResourceKind_Static, v2s32(top.dim.x, top.dim.y), top.fmt, data.str);
+    size_out[0] = (U64)top.dim.x*(U64)top.dim.y*(U64)r_tex2d_format_bytes_per_pixel_table[top.fmt];
   }
   
   //- rjf: bundle as artifact
@@ -5129,7 +5130,7 @@ struct RD_Geo3DBoxDrawData
 };
 
 internal AC_Artifact
-rd_geo3d_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out)
+rd_geo3d_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   Access *access = access_open();
   U128 hash = {0};
@@ -5139,6 +5140,7 @@ rd_geo3d_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *g
   if(data.size != 0)
   {
     buffer = r_buffer_alloc(R_ResourceKind_Static, data.size, data.str);
+    size_out[0] = data.size;
   }
   AC_Artifact artifact = {0};
   MemoryCopy(&artifact, &buffer, Min(sizeof(artifact), sizeof(buffer)));
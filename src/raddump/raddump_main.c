@@ -32,6 +32,7 @@
 #include "coff/coff.h"
 #include "coff/coff_parse.h"
 #include "pe/pe.h"
+#include "zstd/zstd.h"
 #include "elf/elf.h"
 #include "elf/elf_parse.h"
 #include "msvc_crt/msvc_crt.h"
@@ -64,6 +65,7 @@
 #include "coff/coff.c"
 #include "coff/coff_parse.c"
 #include "pe/pe.c"
+#include "zstd/zstd.c"
 #include "elf/elf.c"
 #include "elf/elf_parse.c"
 #include "msvc_crt/msvc_crt.c"
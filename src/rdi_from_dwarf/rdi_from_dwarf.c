@@ -2721,6 +2721,17 @@ d2r_convert(Arena *arena, D2R_ConvertParams *params)
 {
   Temp scratch = scratch_begin(&arena, 1);
   
+  ////////////////////////////////
+  
+  // dw_input_from_elf_bin syncs lanes, so it is called on all lanes, which
+  // also decompresses compressed sections in parallel
+  ELF_Bin elf_bin   = {0};
+  DW_Raw  elf_input = {0};
+  if (params->exe_kind == ExecutableImageKind_Elf32 || params->exe_kind == ExecutableImageKind_Elf64) {
+    elf_bin   = elf_bin_from_data(scratch.arena, params->dbg_data);
+    elf_input = dw_input_from_elf_bin(scratch.arena, params->dbg_data, &elf_bin);
+  }
+  
   if (lane_idx() == 0) {
     ////////////////////////////////
     
@@ -2746,14 +2757,12 @@ d2r_convert(Arena *arena, D2R_ConvertParams *params)
       } break;
       case ExecutableImageKind_Elf32:
       case ExecutableImageKind_Elf64: {
-        ELF_Bin bin = elf_bin_from_data(scratch.arena, params->dbg_data);
-        
-        arch       = arch_from_elf_machine(bin.hdr.e_machine);
-        image_base = elf_base_addr_from_bin(&bin);
-        input      = dw_input_from_elf_bin(scratch.arena, params->dbg_data, &bin);
+        arch       = arch_from_elf_machine(elf_bin.hdr.e_machine);
+        image_base = elf_base_addr_from_bin(&elf_bin);
+        input      = elf_input;
         path_style = PathStyle_UnixAbsolute;
         
-        g_d2r_shared.binary_sections = e2r_rdi_binary_sections_from_elf_section_table(arena, params->dbg_data, &bin, &bin.shdrs);
+        g_d2r_shared.binary_sections = e2r_rdi_binary_sections_from_elf_section_table(arena, params->dbg_data, &elf_bin, &elf_bin.shdrs);
       } break;
       default: { InvalidPath; } break;
     }
@@ -400,45 +400,17 @@ p2r_convert(Arena *arena, P2R_ConvertParams *params)
   //////////////////////////////////////////////////////////////
   //- rjf: do base MSF parse
   //
+  // NOTE: no stream data is copied here; see MSF_Parsed
+  //
   MSF_Parsed *msf = 0;
   ProfScope("do base MSF parse")
   {
-    Temp scratch2 = scratch_begin(&scratch.arena, 1);
-    
-    // rjf: setup output buckets
-    MSF_RawStreamTable *msf_raw_stream_table = 0;
-    U64 *msf_stream_take_counter = 0;
     if(lane_idx() == 0)
     {
-      msf_raw_stream_table = msf_raw_stream_table_from_data(scratch2.arena, params->input_pdb_data);
-      msf = push_array(scratch.arena, MSF_Parsed, 1);
-      msf->page_size = msf_raw_stream_table->page_size;
-      msf->page_count = msf_raw_stream_table->total_page_count;
-      msf->stream_count = msf_raw_stream_table->stream_count;
-      msf->streams = push_array(scratch.arena, String8, msf->stream_count);
-      msf_stream_take_counter = push_array(scratch.arena, U64, 1);
+      msf = msf_parsed_from_data(arena, params->input_pdb_data);
     }
     lane_sync_u64(&msf, 0);
-    lane_sync_u64(&msf_raw_stream_table, 0);
-    
-    // rjf: do wide fill
-    {
-      lane_sync_u64(&msf_stream_take_counter, 0);
-      for(;;)
-      {
-        U64 stream_idx = ins_atomic_u64_inc_eval(msf_stream_take_counter) - 1;
-        if(stream_idx >= msf->stream_count)
-        {
-          break;
-        }
-        msf->streams[stream_idx] = msf_data_from_stream_number(arena, params->input_pdb_data, msf_raw_stream_table, stream_idx);
-      }
-    }
-    lane_sync();
-    
-    scratch_end(scratch2);
   }
-  lane_sync();
   
   //////////////////////////////////////////////////////////////
   //- rjf: do top-level MSF/PDB extraction
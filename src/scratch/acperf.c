@@ -0,0 +1,197 @@
+// Copyright (c) Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+////////////////////////////////
+//~ Build Options
+
+#define BUILD_TITLE "acperf"
+#define BUILD_CONSOLE_INTERFACE 1
+
+////////////////////////////////
+//~ Includes
+
+//- [h]
+#include "base/base_inc.h"
+#include "artifact_cache/artifact_cache.h"
+
+//- [c]
+#include "base/base_inc.c"
+#include "artifact_cache/artifact_cache.c"
+
+////////////////////////////////
+//~ Synthetic Artifacts
+//
+// A slow wide artifact, with uneven work per lane (like a big symbol search,
+// where lane 0 often gets the largest chunk), & many small thin artifacts
+// (like memory or disassembly artifacts), requested while the wide one runs.
+// Sized artifacts report a footprint, to exercise the cache's memory budget.
+
+global U64 acperf_wide_step_count = 100;
+global U64 acperf_wide_step_us = 2000;
+global U64 acperf_thin_us = 200;
+global U64 acperf_sized_bytes = MB(1);
+
+internal void
+acperf_spin_us(U64 us)
+{
+  U64 endt_us = now_time_us() + us;
+  while(now_time_us() < endt_us) {}
+}
+
+internal AC_Artifact
+acperf_wide_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
+{
+  for EachIndex(step_idx, acperf_wide_step_count)
+  {
+    acperf_spin_us(lane_idx() == 0 ? acperf_wide_step_us : acperf_wide_step_us/4);
+    lane_sync();
+  }
+  AC_Artifact artifact = {1};
+  return artifact;
+}
+
+internal AC_Artifact
+acperf_thin_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
+{
+  acperf_spin_us(acperf_thin_us);
+  AC_Artifact artifact = {1};
+  return artifact;
+}
+
+internal AC_Artifact
+acperf_sized_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
+{
+  acperf_spin_us(acperf_thin_us);
+  size_out[0] = acperf_sized_bytes;
+  AC_Artifact artifact = {1};
+  return artifact;
+}
+
+////////////////////////////////
+//~ Entry Point
+
+internal void
+entry_point(CmdLine *cmdline)
+{
+  U64 round_count = 8;
+  U64 thin_count = 64;
+  U64 sized_count = 256;
+  U64 budget_mb = 64;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("rounds")), &round_count);
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("thin")), &thin_count);
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("sized")), &sized_count);
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("budget_mb")), &budget_mb);
+  round_count = Max(round_count, 1);
+  U64 thin_done_us_total = 0;
+  U64 thin_done_us_max = 0;
+  U64 wide_done_us_total = 0;
+  for EachIndex(round_idx, round_count)
+  {
+    Temp scratch = scratch_begin(0, 0);
+    Access *access = access_open();
+    String8 wide_key = push_str8f(scratch.arena, "wide_%llu", round_idx);
+    String8 *thin_keys = push_array(scratch.arena, String8, thin_count);
+    for EachIndex(idx, thin_count)
+    {
+      thin_keys[idx] = push_str8f(scratch.arena, "thin_%llu_%llu", round_idx, idx);
+    }
+
+    //- start the wide artifact, & give the async lanes a moment to pick it up
+    U64 wide_begin_us = now_time_us();
+    ac_artifact_from_key(access, wide_key, acperf_wide_create, 0, 0, .flags = AC_Flag_Wide);
+    sleep_ms(5);
+
+    //- request all thin artifacts, then poll until all of them are done
+    U64 thin_begin_us = now_time_us();
+    U64 thin_done_us = 0;
+    U64 wide_done_us = 0;
+    for(;;)
+    {
+      U64 done_count = 0;
+      for EachIndex(idx, thin_count)
+      {
+        AC_Artifact artifact = ac_artifact_from_key(access, thin_keys[idx], acperf_thin_create, 0, 0);
+        done_count += (artifact.u64[0] != 0);
+      }
+      AC_Artifact wide_artifact = ac_artifact_from_key(access, wide_key, acperf_wide_create, 0, 0, .flags = AC_Flag_Wide);
+      if(done_count == thin_count && thin_done_us == 0)
+      {
+        thin_done_us = now_time_us() - thin_begin_us;
+      }
+      if(wide_artifact.u64[0] != 0 && wide_done_us == 0)
+      {
+        wide_done_us = now_time_us() - wide_begin_us;
+      }
+      if(thin_done_us != 0 && wide_done_us != 0)
+      {
+        break;
+      }
+      sleep_ms(1);
+    }
+    thin_done_us_total += thin_done_us;
+    thin_done_us_max = Max(thin_done_us_max, thin_done_us);
+    wide_done_us_total += wide_done_us;
+    access_close(access);
+    scratch_end(scratch);
+  }
+  
+  //- request more sized artifacts than fit in the budget, twice over, with
+  // one access (& update tick) per artifact, like a user scrolling through
+  // many large views; the cache should stay near the budget throughout
+  U64 sized_peak_bytes = 0;
+  U64 sized_settle_us = 0;
+  {
+    Temp scratch = scratch_begin(0, 0);
+    ac_shared->budget_bytes = MB(budget_mb);
+    for EachIndex(pass_idx, 2)
+    {
+      for EachIndex(idx, sized_count)
+      {
+        Access *access = access_open();
+        String8 key = push_str8f(scratch.arena, "sized_%llu", idx);
+        for(;;)
+        {
+          AC_Artifact artifact = ac_artifact_from_key(access, key, acperf_sized_create, 0, 0);
+          if(artifact.u64[0] != 0)
+          {
+            break;
+          }
+          sleep_ms(1);
+        }
+        access_close(access);
+        update();
+        sized_peak_bytes = Max(sized_peak_bytes, ac_total_stats().bytes);
+      }
+    }
+    U64 settle_begin_us = now_time_us();
+    while(ac_total_stats().bytes > ac_shared->budget_bytes && now_time_us() - settle_begin_us < 3000000)
+    {
+      sleep_ms(1);
+    }
+    sized_settle_us = now_time_us() - settle_begin_us;
+    scratch_end(scratch);
+  }
+  AC_CacheStats sized_stats = ac_cache_stats_from_create(acperf_sized_create);
+  AC_CacheStats total_stats = ac_total_stats();
+  
+  AC_ThinStats thin_stats = ac_thin_stats();
+  AsyncTickStats tick_stats = async_tick_stats();
+  printf("ac: %" PRIu64 " async lanes, %" PRIu64 " thin workers | %" PRIu64 " thin/round | thin done: %8.2f ms avg, %8.2f ms max | wide done: %8.2f ms avg\n",
+         async_threads_count, ac_shared->thin_workers_count, thin_count,
+         thin_done_us_total/(1000.0*round_count), thin_done_us_max/1000.0,
+         wide_done_us_total/(1000.0*round_count));
+  printf("ac: thin scheduler | %" PRIu64 " runs, %" PRIu64 " steals | queue latency: %8.2f ms avg, %8.2f ms max\n",
+         thin_stats.run_count, thin_stats.steal_count,
+         thin_stats.run_count ? thin_stats.queue_latency_us/(1000.0*thin_stats.run_count) : 0.0,
+         thin_stats.queue_latency_max_us/1000.0);
+  printf("ac: async ticks | %" PRIu64 " ticks, %8.2f lane-ms | %8.2f lane-ms waiting at barriers (%.1f%%)\n",
+         tick_stats.tick_count, tick_stats.lane_us/1000.0, tick_stats.lane_barrier_wait_us/1000.0,
+         tick_stats.lane_us ? 100.0*tick_stats.lane_barrier_wait_us/tick_stats.lane_us : 0.0);
+  printf("ac: budget %" PRIu64 " MB | %" PRIu64 " sized x %" PRIu64 " KB | peak %8.2f MB, settled %8.2f MB in %8.2f ms | %" PRIu64 " live, %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " evictions\n",
+         budget_mb, sized_count, acperf_sized_bytes/KB(1),
+         sized_peak_bytes/(1024.0*1024.0), sized_stats.bytes/(1024.0*1024.0), sized_settle_us/1000.0,
+         sized_stats.count, sized_stats.hits, sized_stats.misses, sized_stats.evictions);
+  printf("ac: all caches | %8.2f MB in %" PRIu64 " artifacts | %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " evictions\n",
+         total_stats.bytes/(1024.0*1024.0), total_stats.count,
+         total_stats.hits, total_stats.misses, total_stats.evictions);
+}
@@ -0,0 +1,488 @@
+// Copyright (c) Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+////////////////////////////////
+//~ Build Options
+
+#define BUILD_TITLE "condperf"
+#define BUILD_CONSOLE_INTERFACE 1
+#define NO_ASYNC 1
+#define DMN_INIT_MANUAL 1
+#define D_INIT_MANUAL 1
+
+////////////////////////////////
+//~ Includes
+
+//- [h]
+#include "base/base_inc.h"
+#include "x64/x64.h"
+#include "linker/hash_table.h"
+#include "linker/base_ext/base_bit_array.h"
+#include "artifact_cache/artifact_cache.h"
+#include "rdi/rdi_local.h"
+#include "rdi_make/rdi_make_local.h"
+#include "minidump/minidump.h"
+#include "minidump/minidump_parse.h"
+#include "mdesk/mdesk.h"
+#include "content/content.h"
+#include "file_stream/file_stream.h"
+#include "text/text.h"
+#include "mutable_text/mutable_text.h"
+#include "coff/coff.h"
+#include "coff/coff_parse.h"
+#include "pe/pe.h"
+#include "zstd/zstd.h"
+#include "elf/elf.h"
+#include "gnu/gnu.h"
+#include "gnu/gnu_parse.h"
+#include "elf/elf_parse.h"
+#include "codeview/codeview.h"
+#include "codeview/codeview_parse.h"
+#include "msf/msf.h"
+#include "msf/msf_parse.h"
+#include "pdb/pdb.h"
+#include "pdb/pdb_parse.h"
+#include "dwarf/dwarf_inc.h"
+#include "arch/arch_inc.h"
+#include "dbg_info/dbg_info.h"
+#include "disasm/disasm_inc.h"
+#include "stap/stap_parse.h"
+#include "demon/demon_inc.h"
+#include "eval/eval_inc.h"
+#include "dbg_engine/dbg_engine_inc.h"
+
+// NOTE: the eval & engine layers still reach up into the frontend for list
+// gathers & path overrides; none of this program's conditions use them.
+internal D_Entity *rd_ctrl_entity_from_eval_space(E_Space space) { return &d_entity_nil; }
+internal String8List rd_possible_overrides_from_file_path(Arena *arena, String8 file_path) { String8List result = {0}; return result; }
+
+//- [c]
+#include "base/base_inc.c"
+#include "x64/x64.c"
+#include "linker/hash_table.c"
+#include "linker/base_ext/base_bit_array.c"
+#include "artifact_cache/artifact_cache.c"
+#include "rdi/rdi_local.c"
+#include "rdi_make/rdi_make_local.c"
+#include "minidump/minidump.c"
+#include "minidump/minidump_parse.c"
+#include "mdesk/mdesk.c"
+#include "content/content.c"
+#include "file_stream/file_stream.c"
+#include "text/text.c"
+#include "mutable_text/mutable_text.c"
+#include "coff/coff.c"
+#include "coff/coff_parse.c"
+#include "pe/pe.c"
+#include "zstd/zstd.c"
+#include "elf/elf.c"
+#include "gnu/gnu.c"
+#include "gnu/gnu_parse.c"
+#include "elf/elf_parse.c"
+#include "codeview/codeview.c"
+#include "codeview/codeview_parse.c"
+#include "msf/msf.c"
+#include "msf/msf_parse.c"
+#include "pdb/pdb.c"
+#include "pdb/pdb_parse.c"
+#include "dwarf/dwarf_inc.c"
+#include "arch/arch_inc.c"
+#include "dbg_info/dbg_info.c"
+#include "disasm/disasm_inc.c"
+#include "stap/stap_parse.c"
+#include "demon/demon_inc.c"
+#include "eval/eval_inc.c"
+#include "dbg_engine/dbg_engine_inc.c"
+
+////////////////////////////////
+//~ Local Test Program
+//
+// Stands in for a debuggee stopped on a conditional breakpoint in a hot loop:
+// each hit updates a "thread" register block, which conditions read through
+// an eval space. Memory reads fail, as if nothing were mapped.
+
+typedef enum CONDPERF_SpaceKind
+{
+  CONDPERF_SpaceKind_Regs = E_SpaceKind_FirstUserDefined,
+  CONDPERF_SpaceKind_Memory,
+}
+CONDPERF_SpaceKind;
+
+global U8 *condperf_regs = 0;
+global U64 condperf_regs_size = 0;
+
+internal void
+condperf_reg_write(String8 name, U64 value)
+{
+  ARCH_Info *arch_info = arch_info_from_arch(Arch_x64);
+  ARCH_RegCode code = arch_reg_code_from_name(arch_info, name);
+  arch_reg_block_write_range(arch_info, condperf_regs, arch_info->reg_code_rng_table[code], &value);
+}
+
+internal U64
+condperf_space_gen(E_Space space)
+{
+  return 0;
+}
+
+internal B32
+condperf_space_read(E_Space space, void *out, E_SpaceRangeInfo *out_range_info, Rng1U64 range)
+{
+  B32 result = 0;
+  switch(space.kind)
+  {
+    default:{}break;
+    case CONDPERF_SpaceKind_Regs:
+    if(range.max <= condperf_regs_size)
+    {
+      MemoryCopy(out, condperf_regs + range.min, dim_1u64(range));
+      result = 1;
+    }break;
+  }
+  return result;
+}
+
+////////////////////////////////
+//~ Eval Scopes
+//
+// Mirrors `d_ctrl_thread__interpret_scope_begin`, minus entity/debug info
+// gathering, which this program has none of.
+
+internal D_EvalScope *
+condperf_interpret_scope_begin(Arena *arena)
+{
+  D_EvalScope *scope = push_array(arena, D_EvalScope, 1);
+  {
+    E_BaseCtx *ctx = &scope->base_ctx;
+    ctx->thread_arch          = Arch_x64;
+    ctx->thread_reg_space     = e_space_make(CONDPERF_SpaceKind_Regs);
+    ctx->thread_process_space = e_space_make(CONDPERF_SpaceKind_Memory);
+    ctx->space_gen            = condperf_space_gen;
+    ctx->space_read           = condperf_space_read;
+  }
+  e_select_base_ctx(&scope->base_ctx);
+  {
+    E_InterpretCtx *ctx = &scope->interpret_ctx;
+    ctx->primary_space  = e_space_make(CONDPERF_SpaceKind_Memory);
+    ctx->reg_arch       = Arch_x64;
+    ctx->reg_space      = e_space_make(CONDPERF_SpaceKind_Regs);
+    ctx->module_base    = push_array(arena, U64, 1);
+    ctx->frame_base     = push_array(arena, U64, 1);
+    ctx->tls_base       = push_array(arena, U64, 1);
+  }
+  e_select_interpret_ctx(&scope->interpret_ctx, 0, 0);
+  return scope;
+}
+
+////////////////////////////////
+//~ Benchmark
+
+internal F64
+condperf_hits_per_second(String8 condition, U64 hit_count, B32 use_cache, U64 *stop_count_out, U64 *cache_hit_count_out, U64 *cache_miss_count_out)
+{
+  D_CondBytecodeCache *cache = d_cond_bytecode_cache_alloc();
+  U64 stop_count = 0;
+  U64 begin_us = now_time_us();
+  for EachIndex(hit_idx, hit_count)
+  {
+    Temp scratch = scratch_begin(0, 0);
+    condperf_reg_write(str8_lit("rcx"), hit_idx);
+    condperf_reg_write(str8_lit("rdx"), hit_idx*3);
+    D_EvalScope *eval_scope = condperf_interpret_scope_begin(scratch.arena);
+    E_Interpretation interpretation = {0};
+    if(use_cache)
+    {
+      interpretation = d_ctrl_thread__interpretation_from_condition(cache, scratch.arena, eval_scope, condition, d_handle_zero(), d_handle_zero(), 0);
+    }
+    else
+    {
+      d_ctrl_thread__eval_scope_select_ir_ctx(scratch.arena, eval_scope);
+      E_Eval eval = e_eval_from_string(condition);
+      interpretation.code  = eval.code;
+      interpretation.value = eval.value;
+    }
+    stop_count += (interpretation.code != E_InterpretationCode_Good || interpretation.value.u64 != 0);
+    scratch_end(scratch);
+  }
+  U64 end_us = now_time_us();
+  stop_count_out[0] = stop_count;
+  if(cache_hit_count_out)  { cache_hit_count_out[0] = cache->hit_count; }
+  if(cache_miss_count_out) { cache_miss_count_out[0] = cache->miss_count; }
+  d_cond_bytecode_cache_release(cache);
+  return hit_count / ((F64)Max(end_us - begin_us, 1) / Million(1));
+}
+
+////////////////////////////////
+//~ In-Process Conditions: Target
+//
+// The in-process benchmark re-launches this program with --target; the
+// target stops on an int3 with the address of `condperf_site` in rax, calls
+// it `hits` times with the hit index in rdi, then stops on a final int3. The
+// site starts with a 5-byte nop, so a condition trampoline can replace it.
+
+#if OS_LINUX && ARCH_X64
+__asm__(".text\n"
+        ".type condperf_site, @function\n"
+        "condperf_site:\n"
+        "  .byte 0x0f, 0x1f, 0x44, 0x00, 0x00\n"
+        "  ret\n");
+void condperf_site(U64 hit_idx);
+#endif
+
+internal void
+condperf_target(CmdLine *cmdline)
+{
+#if OS_LINUX && ARCH_X64
+  U64 hit_count = 20000;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("hits")), &hit_count);
+  void (*volatile site)(U64) = condperf_site;
+  __asm__ volatile("int3" :: "a"(site));
+  for EachIndex(hit_idx, hit_count)
+  {
+    site(hit_idx);
+  }
+  __asm__ volatile("int3" :: "a"(0));
+#endif
+}
+
+////////////////////////////////
+//~ In-Process Conditions: Debugger Side
+//
+// Runs the target to its end with a conditional breakpoint on the site, once
+// evaluating the condition on each stop, like the engine does by default,
+// & once with the condition compiled to native code & tested in-process, so
+// that the target only stops when the condition is true.
+
+internal F64
+condperf_inproc_hits_per_second(Arena *arena, DMN_CtrlCtx *ctrl, String8 exe_path, String8 condition, U64 hit_count, B32 in_process, U64 *stop_count_out)
+{
+  F64 result = 0;
+  U64 stop_count = 0;
+  Temp temp = temp_begin(arena);
+  ARCH_Info *arch_info = arch_info_from_arch(Arch_x64);
+  D_CondBytecodeCache *cache = d_cond_bytecode_cache_alloc();
+
+  //- launch the target, & run until it reports the site address
+  ProcessLaunchParams params = {0};
+  str8_list_push(temp.arena, &params.cmd_line, exe_path);
+  str8_list_push(temp.arena, &params.cmd_line, str8_lit("--target"));
+  str8_list_pushf(temp.arena, &params.cmd_line, "--hits=%llu", hit_count);
+  params.path = get_process_info()->initial_path;
+  params.inherit_env = 1;
+  dmn_ctrl_launch(ctrl, &params);
+  DMN_Handle process = {0};
+  DMN_Handle thread = {0};
+  {
+    DMN_RunCtrls run_ctrls = {0};
+    for(B32 done = 0; !done;)
+    {
+      DMN_EventList events = dmn_ctrl_run(temp.arena, ctrl, &run_ctrls);
+      for EachNode(n, DMN_EventNode, events.first)
+      {
+        switch(n->v.kind)
+        {
+          default:{}break;
+          case DMN_EventKind_CreateProcess:{process = n->v.process;}break;
+          case DMN_EventKind_Breakpoint:
+          case DMN_EventKind_Exception:{done = 1; thread = n->v.thread;}break;
+          case DMN_EventKind_Error:
+          case DMN_EventKind_ExitProcess:{done = 1; MemoryZeroStruct(&process);}break;
+        }
+      }
+    }
+  }
+  if(dmn_handle_match(process, dmn_handle_zero()))
+  {
+    fprintf(stderr, "inproc: failed to launch target\n");
+    goto end;
+  }
+  U64 site_vaddr = 0;
+  dmn_thread_read_reg_block(thread, condperf_regs);
+  arch_reg_block_read_range(arch_info, condperf_regs, arch_info->reg_code_rng_table[arch_reg_code_from_name(arch_info, str8_lit("rax"))], &site_vaddr);
+
+  //- build the trap; the target has no debug info, so the condition can only
+  // read registers
+  DMN_Trap trap = {process, site_vaddr, 1};
+  if(in_process)
+  {
+    D_EvalScope *eval_scope = condperf_interpret_scope_begin(temp.arena);
+    d_ctrl_thread__eval_scope_select_ir_ctx(temp.arena, eval_scope);
+    E_Eval eval = e_eval_from_string(condition);
+    trap.condition_code = e_native_code_from_bytecode(temp.arena, eval.bytecode, str8_zero());
+    trap.condition_site_size = 5;
+    if(trap.condition_code.size == 0)
+    {
+      fprintf(stderr, "inproc: condition \"%.*s\" has no native code\n", str8_varg(condition));
+      goto end;
+    }
+  }
+  DMN_TrapChunkList traps = {0};
+  dmn_trap_chunk_list_push(temp.arena, &traps, 16, &trap);
+
+  //- run to the end of the target; step each stopped thread past the site
+  // with no traps, then resume
+  U64 begin_us = now_time_us();
+  for(B32 done = 0; !done;)
+  {
+    Temp run_temp = temp_begin(temp.arena);
+    DMN_Handle stopped_thread = {0};
+    DMN_RunCtrls run_ctrls = {0};
+    run_ctrls.traps = traps;
+    DMN_EventList events = dmn_ctrl_run(run_temp.arena, ctrl, &run_ctrls);
+    for EachNode(n, DMN_EventNode, events.first)
+    {
+      switch(n->v.kind)
+      {
+        default:{}break;
+        case DMN_EventKind_Breakpoint:
+        case DMN_EventKind_Exception:
+        {
+          dmn_thread_read_reg_block(n->v.thread, condperf_regs);
+          if(arch_ip_from_reg_block(arch_info, condperf_regs) == site_vaddr)
+          {
+            stopped_thread = n->v.thread;
+          }
+          else
+          {
+            done = 1;
+          }
+        }break;
+        case DMN_EventKind_Error:
+        case DMN_EventKind_ExitProcess:{done = 1; MemoryZeroStruct(&process);}break;
+      }
+    }
+    if(!dmn_handle_match(stopped_thread, dmn_handle_zero()))
+    {
+      if(in_process)
+      {
+        stop_count += 1;
+      }
+      else
+      {
+        D_EvalScope *eval_scope = condperf_interpret_scope_begin(run_temp.arena);
+        E_Interpretation interpretation = d_ctrl_thread__interpretation_from_condition(cache, run_temp.arena, eval_scope, condition, d_handle_zero(), d_handle_zero(), 0);
+        stop_count += (interpretation.code != E_InterpretationCode_Good || interpretation.value.u64 != 0);
+      }
+      DMN_RunCtrls step_ctrls = {0};
+      step_ctrls.single_step_thread = stopped_thread;
+      for(B32 stepped = 0; !stepped;)
+      {
+        DMN_EventList step_events = dmn_ctrl_run(run_temp.arena, ctrl, &step_ctrls);
+        for EachNode(n, DMN_EventNode, step_events.first)
+        {
+          stepped = (stepped ||
+                     n->v.kind == DMN_EventKind_SingleStep ||
+                     n->v.kind == DMN_EventKind_Error ||
+                     n->v.kind == DMN_EventKind_ExitProcess);
+        }
+      }
+    }
+    temp_end(run_temp);
+  }
+  U64 end_us = now_time_us();
+  result = hit_count / ((F64)Max(end_us - begin_us, 1) / Million(1));
+  end:;
+
+  //- kill the target, & wait for it to exit, so its events don't leak into
+  // the next launch
+  if(!dmn_handle_match(process, dmn_handle_zero()))
+  {
+    dmn_ctrl_kill(ctrl, process, 0);
+    DMN_RunCtrls run_ctrls = {0};
+    for(B32 done = 0; !done;)
+    {
+      Temp run_temp = temp_begin(temp.arena);
+      DMN_EventList events = dmn_ctrl_run(run_temp.arena, ctrl, &run_ctrls);
+      for EachNode(n, DMN_EventNode, events.first)
+      {
+        done = (done ||
+                n->v.kind == DMN_EventKind_Error ||
+                (n->v.kind == DMN_EventKind_ExitProcess && dmn_handle_match(n->v.process, process)));
+      }
+      temp_end(run_temp);
+    }
+  }
+  stop_count_out[0] = stop_count;
+  d_cond_bytecode_cache_release(cache);
+  temp_end(temp);
+  return result;
+}
+
+////////////////////////////////
+//~ Entry Point
+
+internal void
+entry_point(CmdLine *cmdline)
+{
+  if(cmd_line_has_flag(cmdline, str8_lit("target")))
+  {
+    condperf_target(cmdline);
+    return;
+  }
+  Arena *arena = arena_alloc();
+  U64 hit_count = 200000;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("hits")), &hit_count);
+  hit_count = Max(hit_count, 1);
+
+  //- set up the test program's register block
+  condperf_regs_size = arch_info_from_arch(Arch_x64)->reg_block_size;
+  condperf_regs = push_array(arena, U8, condperf_regs_size);
+
+  //- set up the parts of the ctrl state which condition evaluation touches
+  d_ctrl_state = push_array(arena, D_CtrlState, 1);
+  d_ctrl_state->arena = arena;
+  for EachEnumVal(Arch, arch)
+  {
+    ARCH_Info *arch_info = arch_info_from_arch(arch);
+    d_ctrl_state->arch_string2reg_tables[arch] = e_string2num_map_make(arena, 256);
+    for(U64 idx = 1; idx < arch_info->reg_code_count; idx += 1)
+    {
+      e_string2num_map_insert(arena, &d_ctrl_state->arch_string2reg_tables[arch], arch_info->reg_code_name_table[idx], idx);
+    }
+  }
+  e_select_cache(e_cache_alloc());
+
+  //- compare hits/sec with & without the bytecode cache
+  String8 conditions[] =
+  {
+    str8_lit("rcx == 123456"),
+    str8_lit("(rcx & 0xff) == 0x7f && rdx > 30"),
+    str8_lit("(rdx - rcx*3) + (rcx >> 4)*(rcx & 3) == 7500"),
+  };
+  for EachElement(idx, conditions)
+  {
+    U64 uncached_stop_count = 0;
+    U64 cached_stop_count = 0;
+    U64 cache_hit_count = 0;
+    U64 cache_miss_count = 0;
+    F64 uncached_hits_per_second = condperf_hits_per_second(conditions[idx], hit_count, 0, &uncached_stop_count, 0, 0);
+    F64 cached_hits_per_second = condperf_hits_per_second(conditions[idx], hit_count, 1, &cached_stop_count, &cache_hit_count, &cache_miss_count);
+    printf("cond: %-44.*s | uncached: %9.0f hits/s | cached: %9.0f hits/s (%" PRIu64 " hits, %" PRIu64 " misses) | %5.1fx | %" PRIu64 " stops%s\n",
+           str8_varg(conditions[idx]), uncached_hits_per_second, cached_hits_per_second,
+           cache_hit_count, cache_miss_count,
+           cached_hits_per_second/uncached_hits_per_second, cached_stop_count,
+           uncached_stop_count == cached_stop_count ? "" : " (MISMATCH)");
+  }
+
+  //- compare hits/sec in a real target, with the condition evaluated by the
+  // debugger on each stop, & tested in-process
+#if OS_LINUX && ARCH_X64
+  {
+    U64 inproc_hit_count = 20000;
+    try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("inproc_hits")), &inproc_hit_count);
+    inproc_hit_count = Max(inproc_hit_count, 1);
+    dmn_init();
+    DMN_CtrlCtx *ctrl = dmn_ctrl_begin();
+    String8 exe_path = str8f(arena, "%S/%S", get_process_info()->binary_path, str8_skip_last_slash(cmdline->exe_name));
+    String8 condition = str8_lit("rdi % 1000 == 999");
+    U64 debugger_stop_count = 0;
+    U64 in_process_stop_count = 0;
+    F64 debugger_hits_per_second = condperf_inproc_hits_per_second(arena, ctrl, exe_path, condition, inproc_hit_count, 0, &debugger_stop_count);
+    F64 in_process_hits_per_second = condperf_inproc_hits_per_second(arena, ctrl, exe_path, condition, inproc_hit_count, 1, &in_process_stop_count);
+    printf("inproc: %-42.*s | debugger: %9.0f hits/s | in-process: %9.0f hits/s | %7.1fx | %" PRIu64 " stops%s\n",
+           str8_varg(condition), debugger_hits_per_second, in_process_hits_per_second,
+           in_process_hits_per_second/Max(debugger_hits_per_second, 1), in_process_stop_count,
+           debugger_stop_count == in_process_stop_count ? "" : " (MISMATCH)");
+  }
+#endif
+}
@@ -0,0 +1,531 @@
+// Copyright (c) Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+////////////////////////////////
+//~ Build Options
+
+#define BUILD_TITLE "dmnperf"
+#define BUILD_CONSOLE_INTERFACE 1
+
+////////////////////////////////
+//~ Includes
+
+//- [h]
+#include "base/base_inc.h"
+#include "x64/x64.h"
+#include "linker/hash_table.h"
+#include "rdi/rdi_local.h"
+#include "coff/coff.h"
+#include "coff/coff_parse.h"
+#include "zstd/zstd.h"
+#include "elf/elf.h"
+#include "gnu/gnu.h"
+#include "gnu/gnu_parse.h"
+#include "elf/elf_parse.h"
+#include "dwarf/dwarf_inc.h"
+#include "arch/arch_inc.h"
+#include "stap/stap_parse.h"
+#include "demon/demon_inc.h"
+
+//- [c]
+#include "base/base_inc.c"
+#include "x64/x64.c"
+#include "linker/hash_table.c"
+#include "rdi/rdi_local.c"
+#include "coff/coff.c"
+#include "coff/coff_parse.c"
+#include "zstd/zstd.c"
+#include "elf/elf.c"
+#include "gnu/gnu.c"
+#include "gnu/gnu_parse.c"
+#include "elf/elf_parse.c"
+#include "dwarf/dwarf_inc.c"
+#include "arch/arch_inc.c"
+#include "stap/stap_parse.c"
+#include "demon/demon_inc.c"
+
+////////////////////////////////
+//~ Target
+//
+// The benchmark re-launches itself with --target; the target maps a heap at a
+// fixed address, optionally starts idle threads, then loops forever: write to
+// a slice of the heap, then stop on an int3 so the debugger side can measure
+// the stop.
+
+#define DMNPERF_HEAP_VADDR 0x200000000000ull
+#define DMNPERF_HEAP_SIZE  GB(1)
+
+internal void
+dmnperf_idle_thread(void *p)
+{
+#if OS_LINUX
+  for(;;)
+  {
+    pause();
+  }
+#endif
+}
+
+internal void
+dmnperf_target(CmdLine *cmdline)
+{
+#if OS_LINUX
+  U64 page_size = get_system_info()->page_size;
+  U64 page_count = DMNPERF_HEAP_SIZE/page_size;
+  U64 touch_percent = 1;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("touch_percent")), &touch_percent);
+  U64 thread_count = 0;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("threads")), &thread_count);
+  for EachIndex(idx, thread_count)
+  {
+    thread_launch(dmnperf_idle_thread, 0);
+  }
+  U8 *heap = mmap((void *)DMNPERF_HEAP_VADDR, DMNPERF_HEAP_SIZE, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_FIXED_NOREPLACE, -1, 0);
+  if(heap == MAP_FAILED)
+  {
+    return;
+  }
+  for(U64 off = 0; off < DMNPERF_HEAP_SIZE; off += page_size)
+  {
+    heap[off] = 1;
+  }
+  U64 touch_count = Max(1, page_count*touch_percent/100);
+  U64 step_idx = 0;
+  for(;;)
+  {
+    __asm__ volatile("int3");
+    step_idx += 1;
+    for EachIndex(idx, touch_count)
+    {
+      U64 page_idx = (idx*7919 + step_idx*104729) % page_count;
+      heap[page_idx*page_size] += 1;
+    }
+  }
+#endif
+}
+
+////////////////////////////////
+//~ Debugger Side Helpers
+
+global String8 dmnperf_exe_path = {0};
+
+internal DMN_Handle
+dmnperf_launch_target(Arena *arena, DMN_CtrlCtx *ctrl, String8List extra_args)
+{
+  ProcessLaunchParams params = {0};
+  str8_list_push(arena, &params.cmd_line, dmnperf_exe_path);
+  str8_list_push(arena, &params.cmd_line, str8_lit("--target"));
+  str8_list_concat_in_place(&params.cmd_line, &extra_args);
+  params.path = get_process_info()->initial_path;
+  params.inherit_env = 1;
+  dmn_ctrl_launch(ctrl, &params);
+
+  // run until the target reaches its first int3
+  DMN_Handle process = {0};
+  DMN_RunCtrls run_ctrls = {0};
+  for(B32 done = 0; !done;)
+  {
+    DMN_EventList events = dmn_ctrl_run(arena, ctrl, &run_ctrls);
+    for EachNode(n, DMN_EventNode, events.first)
+    {
+      switch(n->v.kind)
+      {
+        default:{}break;
+        case DMN_EventKind_CreateProcess:{process = n->v.process;}break;
+        case DMN_EventKind_Breakpoint:
+        case DMN_EventKind_Exception:{done = 1;}break;
+        case DMN_EventKind_Error:
+        case DMN_EventKind_ExitProcess:{done = 1; MemoryZeroStruct(&process);}break;
+      }
+    }
+  }
+  return process;
+}
+
+internal DMN_Handle
+dmnperf_run_to_stop(Arena *arena, DMN_CtrlCtx *ctrl, DMN_RunCtrls *run_ctrls)
+{
+  DMN_Handle thread = {0};
+  for(B32 done = 0; !done;)
+  {
+    Temp temp = temp_begin(arena);
+    DMN_EventList events = dmn_ctrl_run(temp.arena, ctrl, run_ctrls);
+    for EachNode(n, DMN_EventNode, events.first)
+    {
+      if(n->v.kind == DMN_EventKind_Breakpoint ||
+         n->v.kind == DMN_EventKind_Exception ||
+         n->v.kind == DMN_EventKind_Error ||
+         n->v.kind == DMN_EventKind_ExitProcess)
+      {
+        thread = n->v.thread;
+        done = 1;
+      }
+    }
+    temp_end(temp);
+  }
+  return thread;
+}
+
+internal void
+dmnperf_kill_target(Arena *arena, DMN_CtrlCtx *ctrl, DMN_Handle process)
+{
+  // wait for the exit, so its events don't leak into the next launch
+  dmn_ctrl_kill(ctrl, process, 0);
+  DMN_RunCtrls run_ctrls = {0};
+  for(B32 done = 0; !done;)
+  {
+    Temp temp = temp_begin(arena);
+    DMN_EventList events = dmn_ctrl_run(temp.arena, ctrl, &run_ctrls);
+    for EachNode(n, DMN_EventNode, events.first)
+    {
+      done = (done ||
+              n->v.kind == DMN_EventKind_Error ||
+              (n->v.kind == DMN_EventKind_ExitProcess && dmn_handle_match(n->v.process, process)));
+    }
+    temp_end(temp);
+  }
+}
+
+////////////////////////////////
+//~ Benchmark: Soft-Dirty Page Tracking
+//
+// Mirrors what the debugger's memory cache does after each step: every cached
+// page whose generation changed is re-read. The "on" case only runs on kernels
+// which report soft-dirty bits; it also counts pages the target wrote whose
+// generation did not change, which must be zero.
+
+internal void
+dmnperf_soft_dirty(Arena *arena, DMN_CtrlCtx *ctrl, U64 step_count)
+{
+#if OS_LINUX
+  B32 supported = lnx_dmn_state->is_soft_dirty_supported;
+  if(!supported)
+  {
+    fprintf(stderr, "soft_dirty: kernel does not report soft-dirty bits, only measuring with tracking off\n");
+  }
+  for(B32 tracking = 0; tracking <= supported; tracking += 1)
+  {
+    lnx_dmn_state->is_soft_dirty_enabled = tracking;
+    Temp temp = temp_begin(arena);
+    DMN_Handle process = dmnperf_launch_target(temp.arena, ctrl, (String8List){0});
+    if(dmn_handle_match(process, dmn_handle_zero()))
+    {
+      fprintf(stderr, "soft_dirty: failed to launch target\n");
+      temp_end(temp);
+      break;
+    }
+    U64 page_size = get_system_info()->page_size;
+    U64 page_count = DMNPERF_HEAP_SIZE/page_size;
+    U64 *page_gens = push_array(temp.arena, U64, page_count);
+    U64 *page_read_steps = push_array(temp.arena, U64, page_count);
+    U8 *page_buffer = push_array(temp.arena, U8, page_size);
+    U64 touch_count = Max(1, page_count/100);
+    U64 total_pages_read = 0;
+    U64 total_pages_missed = 0;
+    U64 total_read_us = 0;
+    DMN_RunCtrls run_ctrls = {0};
+    for EachIndex(step_idx, step_count+1)
+    {
+      if(step_idx != 0)
+      {
+        dmnperf_run_to_stop(temp.arena, ctrl, &run_ctrls);
+      }
+      U64 pages_read = 0;
+      U64 begin_us = now_time_us();
+      for EachIndex(page_idx, page_count)
+      {
+        Rng1U64 page_range = r1u64(DMNPERF_HEAP_VADDR + page_idx*page_size, DMNPERF_HEAP_VADDR + (page_idx+1)*page_size);
+        U64 gen = dmn_process_memory_gen_from_range(process, page_range);
+        if(step_idx == 0 || gen == 0 || gen != page_gens[page_idx])
+        {
+          dmn_process_read(process, page_range, page_buffer);
+          page_gens[page_idx] = gen;
+          page_read_steps[page_idx] = step_idx;
+          pages_read += 1;
+        }
+      }
+      U64 end_us = now_time_us();
+      if(step_idx != 0)
+      {
+        total_pages_read += pages_read;
+        total_read_us += (end_us - begin_us);
+        
+        // pages the target wrote in this step (see dmnperf_target) must have been re-read
+        for EachIndex(idx, touch_count)
+        {
+          U64 page_idx = (idx*7919 + step_idx*104729) % page_count;
+          total_pages_missed += (page_read_steps[page_idx] != step_idx);
+        }
+      }
+    }
+    dmnperf_kill_target(temp.arena, ctrl, process);
+    printf("soft_dirty: tracking %-3s | %" PRIu64 " steps | %" PRIu64 " pages written/step | %" PRIu64 " pages re-read/step | %" PRIu64 " written pages missed | %.2f ms refresh/step\n",
+           tracking ? "on" : "off", step_count, touch_count, total_pages_read/Max(step_count, 1), total_pages_missed, total_read_us/(1000.0*Max(step_count, 1)));
+    temp_end(temp);
+  }
+  lnx_dmn_state->is_soft_dirty_enabled = supported;
+#else
+  fprintf(stderr, "soft_dirty: only supported on Linux\n");
+#endif
+}
+
+////////////////////////////////
+//~ Benchmark: Batched Reads
+//
+// Reads many small scattered fragments (like a pointer-chasing watch window or
+// an unwinder reading saved registers), one call per fragment vs one batch.
+
+internal U64
+dmnperf_io_count(String8 key)
+{
+  // /proc/self/io's syscr counts read-family syscalls, including pread but not
+  // process_vm_readv, so it shows how many fragments fell back to pread;
+  // syscw counts write-family syscalls, including pwrite
+  U64 result = 0;
+#if OS_LINUX
+  // procfs reports a size of 0, so read into a fixed buffer
+  U8 buffer[1024] = {0};
+  int fd = open("/proc/self/io", O_RDONLY);
+  ssize_t size = (fd >= 0 ? read(fd, buffer, sizeof(buffer)) : 0);
+  if(fd >= 0) { close(fd); }
+  String8 io = str8(buffer, size > 0 ? (U64)size : 0);
+  U64 pos = str8_find_needle(io, 0, key, 0);
+  if(pos < io.size)
+  {
+    String8 num = str8_skip(io, pos + key.size);
+    U64 num_size = 0;
+    for(; num_size < num.size && char_is_digit(num.str[num_size], 10); num_size += 1);
+    result = u64_from_str8(str8_prefix(num, num_size), 10);
+  }
+#endif
+  return result;
+}
+
+internal void
+dmnperf_read_many(Arena *arena, DMN_CtrlCtx *ctrl, U64 iteration_count)
+{
+  Temp temp = temp_begin(arena);
+  DMN_Handle process = dmnperf_launch_target(temp.arena, ctrl, (String8List){0});
+  if(dmn_handle_match(process, dmn_handle_zero()))
+  {
+    fprintf(stderr, "read_many: failed to launch target\n");
+    temp_end(temp);
+    return;
+  }
+  U64 fragment_counts[] = {16, 256, 4096};
+  U64 page_size = get_system_info()->page_size;
+  U64 page_count = DMNPERF_HEAP_SIZE/page_size;
+  for EachElement(count_idx, fragment_counts)
+  {
+    U64 count = fragment_counts[count_idx];
+    Rng1U64 *ranges = push_array(temp.arena, Rng1U64, count);
+    void **dsts_one = push_array(temp.arena, void *, count);
+    void **dsts_many = push_array(temp.arena, void *, count);
+    for EachIndex(idx, count)
+    {
+      U64 page_idx = (idx*7919) % page_count;
+      U64 vaddr = DMNPERF_HEAP_VADDR + page_idx*page_size + (idx*64) % page_size;
+      ranges[idx] = r1u64(vaddr, vaddr + 8);
+      dsts_one[idx] = push_array(temp.arena, U8, 8);
+      dsts_many[idx] = push_array(temp.arena, U8, 8);
+    }
+    
+    // one read per fragment
+    U64 one_syscalls_before = dmnperf_io_count(str8_lit("syscr: "));
+    U64 one_begin_us = now_time_us();
+    for EachIndex(it, iteration_count)
+    {
+      for EachIndex(idx, count)
+      {
+        dmn_process_read(process, ranges[idx], dsts_one[idx]);
+      }
+    }
+    U64 one_end_us = now_time_us();
+    U64 one_syscalls = dmnperf_io_count(str8_lit("syscr: ")) - one_syscalls_before;
+    
+    // one batch for all fragments
+    U64 many_syscalls_before = dmnperf_io_count(str8_lit("syscr: "));
+    U64 many_begin_us = now_time_us();
+    for EachIndex(it, iteration_count)
+    {
+      dmn_process_read_many(process, count, ranges, dsts_many, 0);
+    }
+    U64 many_end_us = now_time_us();
+    U64 many_syscalls = dmnperf_io_count(str8_lit("syscr: ")) - many_syscalls_before;
+    
+    // check
+    B32 match = 1;
+    for EachIndex(idx, count)
+    {
+      match = match && MemoryMatch(dsts_one[idx], dsts_many[idx], 8);
+    }
+    
+    printf("read_many: %5" PRIu64 " fragments | read:      %8.2f us/sweep, %6" PRIu64 " pread/sweep\n",
+           count, (one_end_us - one_begin_us)/(F64)iteration_count, one_syscalls/iteration_count);
+    printf("read_many: %5" PRIu64 " fragments | read_many: %8.2f us/sweep, %6" PRIu64 " pread/sweep%s\n",
+           count, (many_end_us - many_begin_us)/(F64)iteration_count, many_syscalls/iteration_count, match ? "" : " (MISMATCH)");
+  }
+  dmnperf_kill_target(temp.arena, ctrl, process);
+  temp_end(temp);
+}
+
+////////////////////////////////
+//~ Benchmark: Continue Latency With Many Traps
+//
+// Mirrors what the engine does to continue from a stop with many breakpoints:
+// single-step the stopped thread with no traps, then run with all of them.
+// The traps sit in heap pages which the target never executes or writes, so
+// only the cost of arming them shows up.
+
+internal void
+dmnperf_traps(Arena *arena, DMN_CtrlCtx *ctrl, U64 step_count, U64 trap_count)
+{
+  U64 trap_counts[] = {0, trap_count};
+  for EachElement(count_idx, trap_counts)
+  {
+    Temp temp = temp_begin(arena);
+    String8List args = {0};
+    str8_list_push(temp.arena, &args, str8_lit("--touch_percent=0"));
+    DMN_Handle process = dmnperf_launch_target(temp.arena, ctrl, args);
+    if(dmn_handle_match(process, dmn_handle_zero()))
+    {
+      fprintf(stderr, "traps: failed to launch target\n");
+      temp_end(temp);
+      break;
+    }
+    
+    // one trap per page, past the byte which the target writes
+    U64 page_size = get_system_info()->page_size;
+    U64 count = Min(trap_counts[count_idx], DMNPERF_HEAP_SIZE/page_size);
+    DMN_TrapChunkList traps = {0};
+    for EachIndex(idx, count)
+    {
+      DMN_Trap trap = {process, DMNPERF_HEAP_VADDR + idx*page_size + 64, idx};
+      dmn_trap_chunk_list_push(temp.arena, &traps, 1024, &trap);
+    }
+    DMN_RunCtrls run_ctrls = {0};
+    run_ctrls.traps = traps;
+    DMN_Handle thread = dmnperf_run_to_stop(temp.arena, ctrl, &run_ctrls);
+    
+    // continue from each stop; the debugger must not see trap bytes meanwhile
+    B32 match = 1;
+    U64 step_us = 0;
+    U64 continue_us = 0;
+    U64 writes_before = dmnperf_io_count(str8_lit("syscw: "));
+    for EachIndex(step_idx, step_count)
+    {
+      DMN_RunCtrls step_ctrls = {0};
+      step_ctrls.single_step_thread = thread;
+      U64 step_begin_us = now_time_us();
+      for(B32 stepped = 0; !stepped;)
+      {
+        DMN_EventList step_events = dmn_ctrl_run(temp.arena, ctrl, &step_ctrls);
+        for EachNode(n, DMN_EventNode, step_events.first)
+        {
+          stepped = (stepped ||
+                     n->v.kind == DMN_EventKind_SingleStep ||
+                     n->v.kind == DMN_EventKind_Error ||
+                     n->v.kind == DMN_EventKind_ExitProcess);
+        }
+      }
+      U64 continue_begin_us = now_time_us();
+      thread = dmnperf_run_to_stop(temp.arena, ctrl, &run_ctrls);
+      U64 continue_end_us = now_time_us();
+      step_us += continue_begin_us - step_begin_us;
+      continue_us += continue_end_us - continue_begin_us;
+      for(U64 idx = 0; idx < count; idx += Max(count/16, 1))
+      {
+        U8 byte = 0xff;
+        dmn_process_read(process, r1u64(DMNPERF_HEAP_VADDR + idx*page_size + 64, DMNPERF_HEAP_VADDR + idx*page_size + 65), &byte);
+        match = match && (byte == 0);
+      }
+    }
+    U64 writes = dmnperf_io_count(str8_lit("syscw: ")) - writes_before;
+    dmnperf_kill_target(temp.arena, ctrl, process);
+    printf("traps: %5" PRIu64 " traps | %8.2f us/step | %8.2f us/continue | %6" PRIu64 " pwrite/continue%s\n",
+           count, step_us/(F64)Max(step_count, 1), continue_us/(F64)Max(step_count, 1), writes/Max(step_count, 1), match ? "" : " (MISMATCH)");
+    temp_end(temp);
+  }
+}
+
+////////////////////////////////
+//~ Benchmark: Stops With Many Threads
+//
+// Every thread of a stopped process has its registers read at the stop; the
+// target's extra threads sit idle in `pause`, like blocked workers do.
+
+internal void
+dmnperf_thread_stops(Arena *arena, DMN_CtrlCtx *ctrl, U64 step_count, U64 thread_count)
+{
+  Temp temp = temp_begin(arena);
+  String8List args = {0};
+  str8_list_push(temp.arena, &args, str8_lit("--touch_percent=0"));
+  str8_list_pushf(temp.arena, &args, "--threads=%llu", thread_count);
+  DMN_Handle process = dmnperf_launch_target(temp.arena, ctrl, args);
+  if(dmn_handle_match(process, dmn_handle_zero()))
+  {
+    fprintf(stderr, "thread_stops: failed to launch target\n");
+    temp_end(temp);
+    return;
+  }
+  
+  // let the idle threads start, so that every stop sees all of them
+  DMN_RunCtrls run_ctrls = {0};
+  for EachIndex(warmup_idx, 16)
+  {
+    dmnperf_run_to_stop(temp.arena, ctrl, &run_ctrls);
+  }
+  U64 begin_us = now_time_us();
+  for EachIndex(step_idx, step_count)
+  {
+    dmnperf_run_to_stop(temp.arena, ctrl, &run_ctrls);
+  }
+  U64 end_us = now_time_us();
+  dmnperf_kill_target(temp.arena, ctrl, process);
+  printf("thread_stops: %5" PRIu64 " threads | %8.2f us/stop\n", thread_count, (end_us - begin_us)/(F64)Max(step_count, 1));
+  temp_end(temp);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+internal void
+entry_point(CmdLine *cmdline)
+{
+  if(cmd_line_has_flag(cmdline, str8_lit("target")))
+  {
+    dmnperf_target(cmdline);
+    return;
+  }
+  Arena *arena = arena_alloc();
+  dmnperf_exe_path = str8f(arena, "%S/%S", get_process_info()->binary_path, str8_skip_last_slash(cmdline->exe_name));
+  DMN_CtrlCtx *ctrl = dmn_ctrl_begin();
+  U64 step_count = 16;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("steps")), &step_count);
+  U64 iteration_count = 64;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("iterations")), &iteration_count);
+  U64 trap_count = 10000;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("trap_count")), &trap_count);
+  U64 thread_count = 512;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("thread_count")), &thread_count);
+  B32 run_all = (!cmd_line_has_flag(cmdline, str8_lit("soft_dirty")) &&
+                 !cmd_line_has_flag(cmdline, str8_lit("read_many")) &&
+                 !cmd_line_has_flag(cmdline, str8_lit("traps")) &&
+                 !cmd_line_has_flag(cmdline, str8_lit("thread_stops")));
+  if(run_all || cmd_line_has_flag(cmdline, str8_lit("soft_dirty")))
+  {
+    dmnperf_soft_dirty(arena, ctrl, step_count);
+  }
+  if(run_all || cmd_line_has_flag(cmdline, str8_lit("read_many")))
+  {
+    dmnperf_read_many(arena, ctrl, Max(iteration_count, 1));
+  }
+  if(run_all || cmd_line_has_flag(cmdline, str8_lit("traps")))
+  {
+    dmnperf_traps(arena, ctrl, Max(step_count, 1), trap_count);
+  }
+  if(run_all || cmd_line_has_flag(cmdline, str8_lit("thread_stops")))
+  {
+    dmnperf_thread_stops(arena, ctrl, Max(step_count, 1), thread_count);
+  }
+}
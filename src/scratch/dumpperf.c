@@ -0,0 +1,321 @@
+// Copyright (c) Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+////////////////////////////////
+//~ Build Options
+
+#define BUILD_TITLE "dumpperf"
+#define BUILD_CONSOLE_INTERFACE 1
+#define NO_ASYNC 1
+
+////////////////////////////////
+//~ Includes
+
+//- [h]
+#include "base/base_inc.h"
+#include "x64/x64.h"
+#include "linker/hash_table.h"
+#include "linker/base_ext/base_bit_array.h"
+#include "artifact_cache/artifact_cache.h"
+#include "rdi/rdi_local.h"
+#include "rdi_make/rdi_make_local.h"
+#include "minidump/minidump.h"
+#include "minidump/minidump_parse.h"
+#include "mdesk/mdesk.h"
+#include "content/content.h"
+#include "file_stream/file_stream.h"
+#include "text/text.h"
+#include "mutable_text/mutable_text.h"
+#include "coff/coff.h"
+#include "coff/coff_parse.h"
+#include "pe/pe.h"
+#include "zstd/zstd.h"
+#include "elf/elf.h"
+#include "gnu/gnu.h"
+#include "gnu/gnu_parse.h"
+#include "elf/elf_parse.h"
+#include "codeview/codeview.h"
+#include "codeview/codeview_parse.h"
+#include "msf/msf.h"
+#include "msf/msf_parse.h"
+#include "pdb/pdb.h"
+#include "pdb/pdb_parse.h"
+#include "dwarf/dwarf_inc.h"
+#include "win32/win32_inc.h"
+#include "arch/arch_inc.h"
+#include "dbg_info/dbg_info.h"
+#include "disasm/disasm_inc.h"
+#include "stap/stap_parse.h"
+#include "demon/demon_inc.h"
+#include "eval/eval_inc.h"
+#include "dbg_engine/dbg_engine_inc.h"
+
+// NOTE: the eval & engine layers still reach up into the frontend for list
+// gathers & path overrides; this program uses none of them.
+internal D_Entity *rd_ctrl_entity_from_eval_space(E_Space space) { return &d_entity_nil; }
+internal String8List rd_possible_overrides_from_file_path(Arena *arena, String8 file_path) { String8List result = {0}; return result; }
+
+//- [c]
+#include "base/base_inc.c"
+#include "x64/x64.c"
+#include "linker/hash_table.c"
+#include "linker/base_ext/base_bit_array.c"
+#include "artifact_cache/artifact_cache.c"
+#include "rdi/rdi_local.c"
+#include "rdi_make/rdi_make_local.c"
+#include "minidump/minidump.c"
+#include "minidump/minidump_parse.c"
+#include "mdesk/mdesk.c"
+#include "content/content.c"
+#include "file_stream/file_stream.c"
+#include "text/text.c"
+#include "mutable_text/mutable_text.c"
+#include "coff/coff.c"
+#include "coff/coff_parse.c"
+#include "pe/pe.c"
+#include "zstd/zstd.c"
+#include "elf/elf.c"
+#include "gnu/gnu.c"
+#include "gnu/gnu_parse.c"
+#include "elf/elf_parse.c"
+#include "codeview/codeview.c"
+#include "codeview/codeview_parse.c"
+#include "msf/msf.c"
+#include "msf/msf_parse.c"
+#include "pdb/pdb.c"
+#include "pdb/pdb_parse.c"
+#include "dwarf/dwarf_inc.c"
+#include "win32/win32_inc.c"
+#include "arch/arch_inc.c"
+#include "dbg_info/dbg_info.c"
+#include "disasm/disasm_inc.c"
+#include "stap/stap_parse.c"
+#include "demon/demon_inc.c"
+#include "eval/eval_inc.c"
+#include "dbg_engine/dbg_engine_inc.c"
+
+////////////////////////////////
+//~ Synthetic Dump
+//
+// An x64 minidump with one stack per thread in the 32-bit memory list, & a
+// large 64-bit memory list of small filler ranges below the stacks. Every
+// other filler range directly follows the one before it, so the ranges also
+// exercise coalescing. Each thread's stack holds a chain of return addresses
+// ending with zero, which the module-less unwinder pops one by one.
+
+#define DUMPPERF_STACK_BASE_VADDR  0x00007ff000000000ull
+#define DUMPPERF_STACK_STRIDE      0x0000000000100000ull
+#define DUMPPERF_STACK_SIZE        D_UNWIND_STACK_SNAPSHOT_SIZE
+#define DUMPPERF_FILLER_BASE_VADDR 0x0000000010000000ull
+#define DUMPPERF_FILLER_SIZE       KB(1)
+
+internal Rng1U64
+dumpperf_filler_vaddr_range_from_idx(U64 idx)
+{
+  U64 base = DUMPPERF_FILLER_BASE_VADDR + (idx/2)*KB(16) + (idx%2)*DUMPPERF_FILLER_SIZE;
+  Rng1U64 result = r1u64(base, base + DUMPPERF_FILLER_SIZE);
+  return result;
+}
+
+internal String8
+dumpperf_dump_from_params(Arena *arena, U64 threads_count, U64 frames_count, U64 fillers_count)
+{
+  //- lay out the file
+  U64 directories_count  = 4;
+  U64 directories_foff   = sizeof(MDMP_Header);
+  U64 system_info_foff   = directories_foff + directories_count*sizeof(MDMP_Directory);
+  U64 thread_list_foff   = system_info_foff + sizeof(MDMP_SystemInfo);
+  U64 contexts_foff      = AlignPow2(thread_list_foff + sizeof(U32) + threads_count*sizeof(MDMP_Thread), 16);
+  U64 memory_list_foff   = contexts_foff + threads_count*sizeof(W32_X64_ThreadContext);
+  U64 stacks_foff        = AlignPow2(memory_list_foff + sizeof(U32) + threads_count*sizeof(MDMP_MemoryDescriptor32), 16);
+  U64 memory64_list_foff = stacks_foff + threads_count*DUMPPERF_STACK_SIZE;
+  U64 fillers_foff       = memory64_list_foff + 2*sizeof(U64) + fillers_count*sizeof(MDMP_MemoryDescriptor64);
+  U64 size               = fillers_foff + fillers_count*DUMPPERF_FILLER_SIZE;
+  U8 *data = push_array(arena, U8, size);
+  
+  //- header & directories
+  {
+    MDMP_Header *header = (MDMP_Header *)data;
+    header->magic                 = MDMP_MAGIC;
+    header->number_of_streams     = directories_count;
+    header->stream_directory_foff = directories_foff;
+    MDMP_Directory *dirs = (MDMP_Directory *)(data + directories_foff);
+    dirs[0].stream_kind = MDMP_StreamKind_SystemInfo;
+    dirs[0].location    = (MDMP_LocationDescriptor32){sizeof(MDMP_SystemInfo), system_info_foff};
+    dirs[1].stream_kind = MDMP_StreamKind_ThreadList;
+    dirs[1].location    = (MDMP_LocationDescriptor32){contexts_foff - thread_list_foff, thread_list_foff};
+    dirs[2].stream_kind = MDMP_StreamKind_MemoryList;
+    dirs[2].location    = (MDMP_LocationDescriptor32){stacks_foff - memory_list_foff, memory_list_foff};
+    dirs[3].stream_kind = MDMP_StreamKind_Memory64List;
+    dirs[3].location    = (MDMP_LocationDescriptor32){fillers_foff - memory64_list_foff, memory64_list_foff};
+    MDMP_SystemInfo *system_info = (MDMP_SystemInfo *)(data + system_info_foff);
+    system_info->processor_architecture = MDMP_Arch_x64;
+  }
+  
+  //- threads, contexts, & stacks
+  {
+    *(U32 *)(data + thread_list_foff) = (U32)threads_count;
+    *(U32 *)(data + memory_list_foff) = (U32)threads_count;
+    MDMP_Thread *threads = (MDMP_Thread *)(data + thread_list_foff + sizeof(U32));
+    MDMP_MemoryDescriptor32 *stacks = (MDMP_MemoryDescriptor32 *)(data + memory_list_foff + sizeof(U32));
+    for EachIndex(idx, threads_count)
+    {
+      U64 stack_vaddr = DUMPPERF_STACK_BASE_VADDR + idx*DUMPPERF_STACK_STRIDE;
+      U64 stack_foff = stacks_foff + idx*DUMPPERF_STACK_SIZE;
+      U64 context_foff = contexts_foff + idx*sizeof(W32_X64_ThreadContext);
+      stacks[idx].start_of_memory_range = stack_vaddr;
+      stacks[idx].memory_location       = (MDMP_LocationDescriptor32){DUMPPERF_STACK_SIZE, stack_foff};
+      threads[idx].id             = (U32)(idx+1);
+      threads[idx].stack          = stacks[idx];
+      threads[idx].thread_context = (MDMP_LocationDescriptor32){sizeof(W32_X64_ThreadContext), context_foff};
+      W32_X64_ThreadContext *ctx = (W32_X64_ThreadContext *)(data + context_foff);
+      ctx->Rip = 0x140001000ull + idx*0x10;
+      ctx->Rsp = stack_vaddr;
+      U64 *return_addresses = (U64 *)(data + stack_foff);
+      for EachIndex(frame_idx, frames_count)
+      {
+        return_addresses[frame_idx] = 0x140002000ull + frame_idx*0x10;
+      }
+    }
+  }
+  
+  //- filler ranges
+  {
+    *(U64 *)(data + memory64_list_foff) = fillers_count;
+    *(U64 *)(data + memory64_list_foff + sizeof(U64)) = fillers_foff;
+    MDMP_MemoryDescriptor64 *fillers = (MDMP_MemoryDescriptor64 *)(data + memory64_list_foff + 2*sizeof(U64));
+    for EachIndex(idx, fillers_count)
+    {
+      fillers[idx].start_of_memory_range = dumpperf_filler_vaddr_range_from_idx(idx).min;
+      fillers[idx].size                  = DUMPPERF_FILLER_SIZE;
+      MemorySet(data + fillers_foff + idx*DUMPPERF_FILLER_SIZE, (U8)idx, DUMPPERF_FILLER_SIZE);
+    }
+  }
+  
+  String8 result = str8(data, size);
+  return result;
+}
+
+////////////////////////////////
+//~ Benchmark
+//
+// Opens the dump through the engine, then times repeated unwinds of all of
+// its threads (with the unwind cache dropped before each pass, so every pass
+// reads the stacks), & small reads scattered over the filler ranges.
+
+internal void
+dumpperf_run(Arena *arena, String8 dump_path, U64 passes_count, U64 reads_count, U64 fillers_count)
+{
+  Temp temp = temp_begin(arena);
+  D_TargetArray targets = {0};
+  D_BreakpointArray breakpoints = {0};
+  D_PathMapArray path_maps = {0};
+  U64 exception_code_filters[(D_ExceptionCodeKind_COUNT+63)/64] = {0};
+  
+  //- open the dump; gather its threads
+  U64 open_begin_us = now_time_us();
+  d_push_cmd(D_CmdKind_OpenCrashDump, &(D_CmdParams){.file_path = dump_path});
+  D_Handle process = {0};
+  D_HandleList threads = {0};
+  for(B32 stopped = 0; !stopped;)
+  {
+    D_EventList events = d_tick(temp.arena, &targets, &breakpoints, &path_maps, exception_code_filters);
+    for EachNode(n, D_EventNode, events.first)
+    {
+      switch(n->v.kind)
+      {
+        default:{}break;
+        case D_EventKind_NewProc:{process = n->v.entity;}break;
+        case D_EventKind_NewThread:{d_handle_list_push(temp.arena, &threads, &n->v.entity);}break;
+        case D_EventKind_Stopped:{stopped = 1;}break;
+      }
+    }
+    if(!stopped)
+    {
+      sleep_ms(1);
+    }
+  }
+  U64 open_end_us = now_time_us();
+  printf("open:   %8.2f ms | %" PRIu64 " threads\n", (open_end_us - open_begin_us)/1000.0, threads.count);
+  
+  //- unwind all threads, many times
+  {
+    U64 frames_count = 0;
+    U64 begin_us = now_time_us();
+    for EachIndex(pass_idx, passes_count)
+    {
+      d_unwind_cache_release(process, d_handle_zero());
+      for EachNode(n, D_HandleNode, threads.first)
+      {
+        Temp unwind_temp = temp_begin(temp.arena);
+        D_Unwind unwind = d_unwind_from_thread(unwind_temp.arena, n->v, 0);
+        frames_count += unwind.frames.count;
+        temp_end(unwind_temp);
+      }
+    }
+    U64 end_us = now_time_us();
+    U64 unwinds_count = passes_count*threads.count;
+    printf("unwind: %8.2f us/unwind | %6" PRIu64 " unwinds | %" PRIu64 " frames/unwind\n",
+           (end_us - begin_us)/(F64)Max(unwinds_count, 1), unwinds_count, frames_count/Max(unwinds_count, 1));
+  }
+  
+  //- read 8 bytes at pseudo-random addresses; half land in holes between
+  // ranges
+  {
+    U64 found_count = 0;
+    U64 checksum = 0;
+    U64 rng = 0x9e3779b97f4a7c15ull;
+    U64 begin_us = now_time_us();
+    for EachIndex(read_idx, reads_count)
+    {
+      rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+      Rng1U64 filler = dumpperf_filler_vaddr_range_from_idx(rng%Max(fillers_count, 1));
+      U64 vaddr = filler.min + ((rng >> 32)%(2*DUMPPERF_FILLER_SIZE));
+      U64 value = 0;
+      if(d_process_read(process, r1u64(vaddr, vaddr+sizeof(value)), &value) == sizeof(value))
+      {
+        found_count += 1;
+        checksum += value;
+      }
+    }
+    U64 end_us = now_time_us();
+    printf("read:   %8.2f us/read   | %6" PRIu64 " reads   | %" PRIu64 " found (checksum %016" PRIx64 ")\n",
+           (end_us - begin_us)/(F64)Max(reads_count, 1), reads_count, found_count, checksum);
+  }
+  
+  temp_end(temp);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+internal void
+entry_point(CmdLine *cmdline)
+{
+  Arena *arena = arena_alloc();
+  U64 threads_count = 64;
+  U64 frames_count = 256;
+  U64 fillers_count = 65536;
+  U64 passes_count = 50;
+  U64 reads_count = 1000000;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("threads")), &threads_count);
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("frames")), &frames_count);
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("ranges")), &fillers_count);
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("passes")), &passes_count);
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("reads")), &reads_count);
+  threads_count = Clamp(1, threads_count, 4096);
+  frames_count = Min(frames_count, DUMPPERF_STACK_SIZE/sizeof(U64) - 1);
+  String8 dump_path = cmd_line_string(cmdline, str8_lit("out"));
+  if(dump_path.size == 0)
+  {
+    dump_path = push_str8f(arena, "%S/dumpperf.dmp", get_process_info()->binary_path);
+  }
+  String8 dump = dumpperf_dump_from_params(arena, threads_count, frames_count, fillers_count);
+  if(!write_data_to_file_path(dump_path, dump))
+  {
+    fprintf(stderr, "dumpperf: could not write %.*s\n", str8_varg(dump_path));
+    return;
+  }
+  printf("dump:   %8.2f MB | %" PRIu64 " threads, %" PRIu64 " frames each, %" PRIu64 " filler ranges\n", dump.size/(F64)MB(1), threads_count, frames_count, fillers_count);
+  dumpperf_run(arena, dump_path, passes_count, reads_count, fillers_count);
+}
@@ -0,0 +1,217 @@
+// Copyright (c) Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+////////////////////////////////
+//~ Build Options
+
+#define BUILD_TITLE "fsperf"
+#define BUILD_CONSOLE_INTERFACE 1
+#define NO_ASYNC 1
+
+////////////////////////////////
+//~ Includes
+
+//- [h]
+#include "base/base_inc.h"
+#include "content/content.h"
+#include "artifact_cache/artifact_cache.h"
+#include "file_stream/file_stream.h"
+
+//- [c]
+#include "base/base_inc.c"
+#include "content/content.c"
+#include "artifact_cache/artifact_cache.c"
+#include "file_stream/file_stream.c"
+
+#if OS_LINUX
+# include <sys/ptrace.h>
+#endif
+
+////////////////////////////////
+//~ Tracked Files
+//
+// Creates `count` small files in a scratch folder & tracks each of them in
+// the file stream layer, by running its artifact creation directly (there are
+// no async threads in this program).
+
+typedef struct FSPERF_Files FSPERF_Files;
+struct FSPERF_Files
+{
+  String8 *paths;
+  U64 count;
+};
+
+internal FSPERF_Files
+fsperf_files_make(Arena *arena, String8 folder, U64 count)
+{
+  FSPERF_Files files = {0};
+  files.count = count;
+  files.paths = push_array(arena, String8, count);
+  make_directory(folder);
+  for EachIndex(idx, count)
+  {
+    Temp scratch = scratch_begin(&arena, 1);
+    files.paths[idx] = push_str8f(arena, "%S/file_%05llu.txt", folder, idx);
+    write_data_to_file_path(files.paths[idx], push_str8f(scratch.arena, "contents of file %llu\n", idx));
+    String8List key_parts = {0};
+    Rng1U64 range = r1u64(0, max_U64);
+    str8_list_push(scratch.arena, &key_parts, str8_struct(&files.paths[idx].size));
+    str8_list_push(scratch.arena, &key_parts, files.paths[idx]);
+    str8_list_push(scratch.arena, &key_parts, str8_struct(&range));
+    String8 key = str8_list_join(scratch.arena, &key_parts, 0);
+    B32 cancel_signal = 0;
+    B32 retry = 0;
+    U64 gen = 0;
+    U64 size = 0;
+    fs_artifact_create(key, &cancel_signal, &retry, &gen, &size);
+    scratch_end(scratch);
+  }
+  return files;
+}
+
+internal void
+fsperf_files_touch(FSPERF_Files *files, U64 first_idx, U64 count)
+{
+  for EachIndex(n, count)
+  {
+    String8 path = files->paths[(first_idx + n)%files->count];
+    append_data_to_file_path(path, str8_lit("x"));
+  }
+}
+
+internal U64
+fsperf_set_watching(B32 watching)
+{
+  U64 watched_count = 0;
+  for EachIndex(slot_idx, fs_shared->slots_count)
+  {
+    for(FS_Node *n = fs_shared->slots[slot_idx].first; n != 0; n = n->next)
+    {
+      n->is_watched = (watching && !!fs_shared->watcher.u64[0]);
+      watched_count += !!n->is_watched;
+    }
+  }
+  return watched_count;
+}
+
+////////////////////////////////
+//~ Syscall Counting
+//
+// Forks; the child touches a few tracked files before each tick, and brackets
+// each tick with SIGUSR1/SIGUSR2, while the parent single-steps it from
+// syscall to syscall with ptrace, counting only inside the brackets.
+
+internal F64
+fsperf_syscalls_per_tick(FSPERF_Files *files, U64 tick_count, U64 touch_count)
+{
+  F64 result = 0;
+#if OS_LINUX
+  pid_t pid = fork();
+  if(pid == 0)
+  {
+    ptrace(PTRACE_TRACEME, 0, 0, 0);
+    raise(SIGSTOP);
+    for EachIndex(tick_idx, tick_count)
+    {
+      fsperf_files_touch(files, tick_idx*touch_count, touch_count);
+      raise(SIGUSR1);
+      fs_async_tick();
+      raise(SIGUSR2);
+    }
+    _exit(0);
+  }
+  if(pid > 0)
+  {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ptrace(PTRACE_SETOPTIONS, pid, 0, PTRACE_O_TRACESYSGOOD|PTRACE_O_EXITKILL);
+    U64 syscall_stop_count = 0;
+    B32 is_counting = 0;
+    int signal_to_deliver = 0;
+    for(;;)
+    {
+      ptrace(PTRACE_SYSCALL, pid, 0, signal_to_deliver);
+      signal_to_deliver = 0;
+      if(waitpid(pid, &status, 0) < 0 || WIFEXITED(status) || WIFSIGNALED(status))
+      {
+        break;
+      }
+      if(WIFSTOPPED(status))
+      {
+        int stop_signal = WSTOPSIG(status);
+        if(stop_signal == (SIGTRAP|0x80))
+        {
+          syscall_stop_count += is_counting;
+        }
+        else if(stop_signal == SIGUSR1)
+        {
+          is_counting = 1;
+        }
+        else if(stop_signal == SIGUSR2)
+        {
+          is_counting = 0;
+        }
+        else
+        {
+          signal_to_deliver = stop_signal;
+        }
+      }
+    }
+
+    // NOTE: each syscall stops on entry & exit; the raise(SIGUSR2) call
+    // closing each bracket counts, so drop it
+    U64 syscall_count = syscall_stop_count/2;
+    U64 marker_syscall_count = tick_count;
+    result = (F64)(syscall_count - Min(syscall_count, marker_syscall_count))/tick_count;
+  }
+#endif
+  return result;
+}
+
+////////////////////////////////
+//~ Entry Point
+
+internal void
+entry_point(CmdLine *cmdline)
+{
+  U64 lane_broadcast_memory = 0;
+  LaneCtx single_lane_ctx = {0, 1, {0}, &lane_broadcast_memory};
+  lane_ctx(single_lane_ctx);
+  Arena *arena = arena_alloc();
+  U64 file_count = 10000;
+  U64 tick_count = 16;
+  U64 touch_count = 8;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("files")), &file_count);
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("ticks")), &tick_count);
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("touches")), &touch_count);
+  file_count = Max(file_count, 1);
+  tick_count = Max(tick_count, 1);
+  String8 folder = push_str8f(arena, "/tmp/fsperf_%llu", (U64)get_process_info()->pid);
+  FSPERF_Files files = fsperf_files_make(arena, folder, file_count);
+  fs_async_tick();
+  for(B32 watching = 0; watching <= 1; watching += 1)
+  {
+    U64 watched_count = fsperf_set_watching(watching);
+    U64 change_gen_begin = fs_change_gen();
+    U64 begin_us = now_time_us();
+    for EachIndex(tick_idx, tick_count)
+    {
+      fsperf_files_touch(&files, tick_idx*touch_count, touch_count);
+      fs_async_tick();
+    }
+    U64 end_us = now_time_us();
+    U64 change_gen_end = fs_change_gen();
+    F64 syscalls_per_tick = fsperf_syscalls_per_tick(&files, tick_count, touch_count);
+    printf("fs: %" PRIu64 " files (%5" PRIu64 " watched), %" PRIu64 " touched/tick | %8.2f ms/tick (incl. touches) | %10.1f syscalls/tick | %" PRIu64 " change gen bumps\n",
+           file_count, watched_count, touch_count,
+           (F64)(end_us - begin_us)/(1000.0*tick_count), syscalls_per_tick,
+           change_gen_end - change_gen_begin);
+  }
+  for EachIndex(idx, files.count)
+  {
+    delete_file_at_path(files.paths[idx]);
+  }
+#if OS_LINUX
+  rmdir((char *)folder.str);
+#endif
+}
@@ -0,0 +1,350 @@
+// Copyright (c) Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+////////////////////////////////
+//~ Build Options
+
+#define BUILD_TITLE "lexperf"
+#define BUILD_CONSOLE_INTERFACE 1
+
+////////////////////////////////
+//~ Includes
+
+//- [h]
+#include "base/base_inc.h"
+#include "content/content.h"
+#include "artifact_cache/artifact_cache.h"
+#include "text/text.h"
+
+//- [c]
+#include "base/base_inc.c"
+#include "content/content.c"
+#include "artifact_cache/artifact_cache.c"
+#include "text/text.c"
+
+////////////////////////////////
+//~ Synthetic Sources
+//
+// Source-shaped text, with the constructs which make chunked lexing hard: block
+// comments & raw strings which span many lines & contain code-looking text,
+// macros continued with `\`, & quotes inside of character literals.
+
+internal U64
+lexperf_rand(U64 *state)
+{
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
+internal String8
+lexperf_c_source_make(Arena *arena, U64 size)
+{
+  local_persist char *pieces[] =
+  {
+    "internal U64\nfoo_%llu(U64 x, U64 y)\n{\n  U64 result = (x << 3) + y*%llu;\n  if(result >= 0x%llx && x != y)\n  {\n    result ^= 0x%llxull;\n  }\n  return result;\n}\n\n",
+    "/*\n * block comment %llu, with code inside:\n *\nint not_code(void)\n{\n  return \"not a string;\n}\n */\n",
+    "#define MACRO_%llu(x) \\\n  do { \\\n    bar_%llu((x), \"str\\\\\"); \\\n  } while(0)\n\n",
+    "global char *strings_%llu[] =\n{\n  \"a \\\"quoted\\\" string %llu\",\n  \"/* not a comment */\",\n  \"// also not a comment\",\n};\n\n",
+    "internal void\nbaz_%llu(void)\n{\n  char c0 = '\\'', c1 = '\"', c2 = '\\\\';\n  F32 f = .5f + 1.25e-3f*%llu.f;\n  x->y.z[%llu] <<= 2; // trailing comment\n}\n\n",
+    "struct Thing_%llu\n{\n  U64 a;\n  U32 b[%llu];\n};\n\n",
+  };
+  String8List parts = {0};
+  U64 state = 0x9e3779b97f4a7c15ull;
+  for(U64 idx = 0; parts.total_size < size; idx += 1)
+  {
+    U64 r = lexperf_rand(&state);
+    str8_list_pushf(arena, &parts, pieces[r%ArrayCount(pieces)], idx, r%1000, r>>40, r>>32);
+  }
+  String8 result = str8_list_join(arena, &parts, 0);
+  return result;
+}
+
+internal String8
+lexperf_rust_source_make(Arena *arena, U64 size)
+{
+  local_persist char *pieces[] =
+  {
+    "pub fn foo_%llu<'a>(x: &'a str, y: u64) -> Option<&'a str> {\n    let n = y * %llu + 0x%llx;\n    if n >= 3 { Some(x) } else { None }\n}\n\n",
+    "/* outer comment %llu\n   /* nested comment\n      fn not_code() { \"not a string }\n   */\n   still commented out\n*/\n",
+    "const RAW_%llu: &str = r#\"raw string %llu\nwith \"quotes\" inside\n}\nfn not_code() {}\n\"#;\n\n",
+    "fn bar_%llu() {\n    let c0 = '\\''; let c1 = '\"'; let c2 = b'x';\n    let s = \"escaped \\\" quote %llu\";\n    // fn commented_out() {}\n}\n\n",
+    "#[derive(Debug)]\nstruct Thing%llu {\n    a: u64,\n    b: [u32; %llu],\n}\n\n",
+  };
+  String8List parts = {0};
+  U64 state = 0x2545f4914f6cdd1dull;
+  for(U64 idx = 0; parts.total_size < size; idx += 1)
+  {
+    U64 r = lexperf_rand(&state);
+    str8_list_pushf(arena, &parts, pieces[r%ArrayCount(pieces)], idx, r%1000, r>>40, r>>32);
+  }
+  String8 result = str8_list_join(arena, &parts, 0);
+  return result;
+}
+
+////////////////////////////////
+//~ Benchmark
+
+internal B32
+lexperf_tokens_match(TXT_TokenArray *a, TXT_TokenArray *b)
+{
+  B32 result = (a->count == b->count);
+  for(U64 idx = 0; result && idx < a->count; idx += 1)
+  {
+    result = (a->v[idx].kind == b->v[idx].kind && MemoryMatchStruct(&a->v[idx].range, &b->v[idx].range));
+  }
+  return result;
+}
+
+internal void
+lexperf_run(String8 name, TXT_LangKind lang, String8 source, U64 round_count)
+{
+  TXT_LangLexFunctionType *lex_function = txt_lex_function_from_lang_kind(lang);
+  if(lex_function == 0)
+  {
+    printf("lex: no lexer for %.*s\n", str8_varg(name));
+    return;
+  }
+  U64 serial_us_total = 0;
+  U64 artifact_us_total = 0;
+  U64 serial_lines_us_total = 0;
+  U64 block_lines_us_total = 0;
+  B32 good = 1;
+  for EachIndex(round_idx, round_count)
+  {
+    Temp scratch = scratch_begin(0, 0);
+
+    //- make fresh data for each round, so that the artifact is recomputed
+    String8 data = push_str8f(scratch.arena, "// round %llu\n%S", round_idx, source);
+
+    //- serial reference: split lines byte-by-byte, & lex, on one thread
+    U64 serial_begin_us = now_time_us();
+    U64 lines_count = 1;
+    for EachIndex(idx, data.size)
+    {
+      lines_count += (data.str[idx] == '\n');
+    }
+    Rng1U64 *lines_ranges = push_array_no_zero(scratch.arena, Rng1U64, lines_count);
+    U64 lines_max_size = 0;
+    {
+      U64 line_idx = 0;
+      U64 line_start_idx = 0;
+      for(U64 idx = 0; idx <= data.size; idx += 1)
+      {
+        if(idx == data.size || data.str[idx] == '\n')
+        {
+          Rng1U64 line_range = r1u64(line_start_idx, idx);
+          if(idx > 0 && data.str[idx-1] == '\r' && line_range.max > line_range.min)
+          {
+            line_range.max -= 1;
+          }
+          lines_ranges[line_idx] = line_range;
+          lines_max_size = Max(lines_max_size, dim_1u64(line_range));
+          line_idx += 1;
+          line_start_idx = idx+1;
+        }
+      }
+    }
+    U64 serial_lines_end_us = now_time_us();
+    TXT_TokenArray tokens = lex_function(scratch.arena, 0, data);
+    serial_us_total += now_time_us() - serial_begin_us;
+    serial_lines_us_total += serial_lines_end_us - serial_begin_us;
+
+    //- block-wise line split, on one thread
+    {
+      Temp temp = temp_begin(scratch.arena);
+      U64 block_lines_begin_us = now_time_us();
+      U64 block_lines_count = 1 + txt_newline_count_from_string(data);
+      Rng1U64 *block_lines_ranges = push_array(temp.arena, Rng1U64, block_lines_count);
+      block_lines_ranges[block_lines_count-1].max = data.size;
+      txt_line_ranges_fill_from_data_range(data, r1u64(0, data.size), block_lines_ranges, block_lines_count, 0);
+      block_lines_us_total += now_time_us() - block_lines_begin_us;
+      temp_end(temp);
+    }
+
+    //- artifact: submit data, poll until the text info is ready
+    Arena *data_arena = arena_alloc();
+    String8 data_copy = push_str8_copy(data_arena, data);
+    U128 hash = c_submit_data(c_key_make(c_root_alloc(), c_id_make(round_idx, 0)), &data_arena, data_copy);
+    U64 artifact_begin_us = now_time_us();
+    for(;;)
+    {
+      Access *access = access_open();
+      TXT_TextInfo info = txt_text_info_from_hash_lang(access, hash, lang);
+      if(info.lines_count != 0)
+      {
+        artifact_us_total += now_time_us() - artifact_begin_us;
+        good = (good &&
+                info.lines_count == lines_count &&
+                info.lines_max_size == lines_max_size &&
+                MemoryMatch(info.lines_ranges, lines_ranges, sizeof(Rng1U64)*lines_count) &&
+                lexperf_tokens_match(&info.tokens, &tokens));
+        access_close(access);
+        break;
+      }
+      access_close(access);
+      sleep_ms(1);
+    }
+    scratch_end(scratch);
+  }
+  printf("lex: %-4.*s %6.1f MB | %" PRIu64 " async lanes | serial: %9.2f ms | artifact: %9.2f ms | %5.1fx%s\n",
+         str8_varg(name), source.size/(1024.0*1024.0), async_threads_count,
+         serial_us_total/(1000.0*round_count), artifact_us_total/(1000.0*round_count),
+         artifact_us_total ? (F64)serial_us_total/artifact_us_total : 0.0,
+         good ? "" : " (MISMATCH)");
+  printf("lex: %-4.*s %6.1f MB | line split on one thread | bytewise: %9.2f ms | %" PRIu64 "-byte blocks: %9.2f ms | %5.1fx\n",
+         str8_varg(name), source.size/(1024.0*1024.0),
+         serial_lines_us_total/(1000.0*round_count), (U64)TXT_LINE_SCAN_BLOCK_SIZE, block_lines_us_total/(1000.0*round_count),
+         block_lines_us_total ? (F64)serial_lines_us_total/block_lines_us_total : 0.0);
+}
+
+internal B32
+lexperf_infos_match(TXT_TextInfo *a, TXT_TextInfo *b)
+{
+  B32 result = (a->lines_count == b->lines_count &&
+                a->lines_max_size == b->lines_max_size &&
+                MemoryMatch(a->lines_ranges, b->lines_ranges, sizeof(Rng1U64)*a->lines_count) &&
+                lexperf_tokens_match(&a->tokens, &b->tokens) &&
+                a->scope_nodes.count == b->scope_nodes.count &&
+                MemoryMatch(a->scope_nodes.v, b->scope_nodes.v, sizeof(TXT_ScopeNode)*a->scope_nodes.count) &&
+                a->scope_pts.count == b->scope_pts.count &&
+                MemoryMatch(a->scope_pts.v, b->scope_pts.v, sizeof(TXT_ScopePt)*a->scope_pts.count));
+  return result;
+}
+
+internal U64
+lexperf_text_info_wait(U128 hash, TXT_LangKind lang, TXT_TextInfo *info_out, Access **access_out)
+{
+  // NOTE: returns the # of microseconds until the text info was ready; the
+  // returned access keeps it alive
+  U64 begin_us = now_time_us();
+  for(;;)
+  {
+    Access *access = access_open();
+    TXT_TextInfo info = txt_text_info_from_hash_lang(access, hash, lang);
+    if(info.lines_count != 0)
+    {
+      *info_out = info;
+      *access_out = access;
+      break;
+    }
+    access_close(access);
+    sleep_ms(1);
+  }
+  return now_time_us() - begin_us;
+}
+
+internal void
+lexperf_incremental_run(String8 name, TXT_LangKind lang, TXT_LangKind full_lang, String8 source, U64 edit_count)
+{
+  // NOTE: `full_lang` must share `lang`'s lexer. every other version is also
+  // built for `full_lang`, from scratch, since the version before it never is,
+  // & compared with the incrementally built text info.
+  local_persist char *insertions[] =
+  {
+    "x = (y + 1)*z[2];\n",
+    "{ int a = 0; }",
+    "{",
+    "}",
+    "/*",
+    "\"",
+    "'",
+    "\n\n",
+    "\r\n",
+    "\\\n",
+  };
+  Temp scratch = scratch_begin(0, 0);
+  C_Key key = c_key_make(c_root_alloc(), c_id_make(0x1ec5, 0));
+  U64 state = 0x853c49e6748fea9bull;
+  U64 incremental_us_total = 0;
+  U64 full_us_total = 0;
+  U64 full_count = 0;
+  U64 mismatch_count = 0;
+  String8 data = source;
+  {
+    Arena *data_arena = arena_alloc();
+    U128 hash = c_submit_data(key, &data_arena, push_str8_copy(data_arena, data));
+    TXT_TextInfo info = {0};
+    Access *access = 0;
+    lexperf_text_info_wait(hash, lang, &info, &access);
+    access_close(access);
+  }
+  for EachIndex(edit_idx, edit_count)
+  {
+    //- edit the prior version: insert, delete, or both
+    U64 r = lexperf_rand(&state);
+    U64 off = r%data.size;
+    U64 delete_size = ((r>>32)%3 == 0 ? 0 : Min((r>>40)%64, data.size - off));
+    String8 insertion = ((r>>32)%3 == 1 ? str8_zero() : str8_cstring(insertions[(r>>48)%ArrayCount(insertions)]));
+    String8List parts = {0};
+    str8_list_push(scratch.arena, &parts, str8_prefix(data, off));
+    str8_list_push(scratch.arena, &parts, insertion);
+    str8_list_push(scratch.arena, &parts, str8_skip(data, off + delete_size));
+    data = str8_list_join(scratch.arena, &parts, 0);
+    
+    //- submit new version under the same key, time incremental update
+    Arena *data_arena = arena_alloc();
+    U128 hash = c_submit_data(key, &data_arena, push_str8_copy(data_arena, data));
+    TXT_TextInfo info = {0};
+    Access *access = 0;
+    incremental_us_total += lexperf_text_info_wait(hash, lang, &info, &access);
+    
+    //- build the same version from scratch, & compare
+    if(edit_idx%2 == 1)
+    {
+      TXT_TextInfo full_info = {0};
+      Access *full_access = 0;
+      full_us_total += lexperf_text_info_wait(hash, full_lang, &full_info, &full_access);
+      full_count += 1;
+      if(!lexperf_infos_match(&info, &full_info))
+      {
+        mismatch_count += 1;
+        printf("lex: %.*s incremental mismatch, edit %" PRIu64 ": deleted %" PRIu64 " bytes, inserted \"%.*s\" at %" PRIu64 "\n",
+               str8_varg(name), edit_idx, delete_size, str8_varg(insertion), off);
+      }
+      access_close(full_access);
+    }
+    access_close(access);
+  }
+  printf("lex: %-4.*s %6.1f MB | %" PRIu64 " edits | from scratch: %9.2f ms | incremental: %9.2f ms | %5.1fx%s\n",
+         str8_varg(name), source.size/(1024.0*1024.0), edit_count,
+         full_us_total/(1000.0*Max(full_count, 1)), incremental_us_total/(1000.0*edit_count),
+         incremental_us_total ? ((F64)full_us_total/Max(full_count, 1))/((F64)incremental_us_total/edit_count) : 0.0,
+         mismatch_count == 0 ? "" : " (MISMATCH)");
+  scratch_end(scratch);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+internal void
+entry_point(CmdLine *cmdline)
+{
+  Arena *arena = arena_alloc();
+  U64 size_mb = 16;
+  U64 round_count = 4;
+  U64 edit_size_mb = 4;
+  U64 edit_count = 16;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("size_mb")), &size_mb);
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("rounds")), &round_count);
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("edit_size_mb")), &edit_size_mb);
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("edits")), &edit_count);
+  round_count = Max(round_count, 1);
+  String8 path = cmd_line_string(cmdline, str8_lit("file"));
+  if(path.size != 0)
+  {
+    String8 source = data_from_file_path(arena, path);
+    TXT_LangKind lang = txt_lang_kind_from_extension(str8_skip_last_dot(path));
+    lexperf_run(str8_skip_last_dot(path), lang, source, round_count);
+  }
+  else
+  {
+    lexperf_run(str8_lit("c"), TXT_LangKind_C, lexperf_c_source_make(arena, MB(size_mb)), round_count);
+    lexperf_run(str8_lit("rs"), TXT_LangKind_Rust, lexperf_rust_source_make(arena, MB(size_mb)), round_count);
+    if(edit_count != 0)
+    {
+      lexperf_incremental_run(str8_lit("c"), TXT_LangKind_C, TXT_LangKind_CPlusPlus, lexperf_c_source_make(arena, MB(edit_size_mb)), edit_count);
+    }
+  }
+}
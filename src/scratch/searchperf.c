@@ -0,0 +1,189 @@
+// Copyright (c) Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+////////////////////////////////
+//~ Build Options
+
+#define BUILD_TITLE "searchperf"
+#define BUILD_CONSOLE_INTERFACE 1
+
+////////////////////////////////
+//~ Includes
+
+//- [h]
+#include "base/base_inc.h"
+#include "content/content.h"
+#include "artifact_cache/artifact_cache.h"
+#include "file_stream/file_stream.h"
+#include "rdi/rdi_local.h"
+#include "dbg_info/dbg_info.h"
+
+//- [c]
+#include "base/base_inc.c"
+#include "content/content.c"
+#include "artifact_cache/artifact_cache.c"
+#include "file_stream/file_stream.c"
+#include "rdi/rdi_local.c"
+#include "dbg_info/dbg_info.c"
+
+////////////////////////////////
+//~ Synthetic Names
+//
+// Symbol-shaped names (namespace::Class::verb_noun_N), so that trigram
+// frequencies look roughly like those of a real program's procedures.
+
+typedef struct SEARCHPERF_Names SEARCHPERF_Names;
+struct SEARCHPERF_Names
+{
+  String8 *v;
+  U64 count;
+};
+
+internal String8
+searchperf_name_from_idx(Arena *arena, void *user_data, U64 idx)
+{
+  SEARCHPERF_Names *names = (SEARCHPERF_Names *)user_data;
+  String8 result = {0};
+  if(idx < names->count)
+  {
+    result = names->v[idx];
+  }
+  return result;
+}
+
+internal SEARCHPERF_Names
+searchperf_names_make(Arena *arena, U64 count)
+{
+  local_persist char *namespaces[] = {"core", "gfx", "net", "ui", "audio", "physics", "script", "io", "mem", "dbg"};
+  local_persist char *classes[] = {"Renderer", "Window", "Socket", "Buffer", "Allocator", "Texture", "Parser", "Stream", "Thread", "Widget", "Font", "Mesh", "Body", "Channel", "Frame", "Scene"};
+  local_persist char *verbs[] = {"get", "set", "update", "create", "destroy", "push", "pop", "find", "load", "save", "draw", "build", "reset", "flush", "begin", "end"};
+  local_persist char *nouns[] = {"size", "data", "state", "frame", "node", "list", "entry", "count", "flags", "handle", "path", "name", "range", "cursor", "color", "target"};
+  SEARCHPERF_Names names = {0};
+  names.count = count;
+  names.v = push_array(arena, String8, count);
+  U64 state = 0x2545f4914f6cdd1dull;
+  for EachIndex(idx, count)
+  {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    names.v[idx] = push_str8f(arena, "%s::%s::%s_%s_%llu",
+                              namespaces[(state >> 0)  % ArrayCount(namespaces)],
+                              classes   [(state >> 8)  % ArrayCount(classes)],
+                              verbs     [(state >> 16) % ArrayCount(verbs)],
+                              nouns     [(state >> 24) % ArrayCount(nouns)],
+                              (state >> 32) % 1000);
+  }
+  return names;
+}
+
+////////////////////////////////
+//~ Benchmark
+
+internal void
+searchperf_run(Arena *arena, U64 count, U64 iteration_count)
+{
+  local_persist char *queries[] =
+  {
+    "update",
+    "renderer draw_frame",
+    "gfx::Texture::load",
+    "socket flush_handle_42",
+    "zzz",
+  };
+  Temp scratch = scratch_begin(&arena, 1);
+  SEARCHPERF_Names names = searchperf_names_make(scratch.arena, count);
+  B32 cancel_signal = 0;
+
+  //- build index
+  U64 build_begin_us = now_time_us();
+  DI_SearchIndex *index = di_search_index_build(scratch.arena, names.count, searchperf_name_from_idx, &names, &cancel_signal);
+  U64 build_end_us = now_time_us();
+  printf("search: %8" PRIu64 " names | index build: %9.2f ms, %" PRIu64 " postings (%.1f MB)\n",
+         count, (build_end_us-build_begin_us)/1000.0, index->postings_count,
+         (index->postings_count*sizeof(U32) + (DI_SEARCH_INDEX_TRIGRAM_COUNT+1)*sizeof(U64))/(1024.0*1024.0));
+
+  //- compare full scans with indexed queries
+  for EachElement(query_idx, queries)
+  {
+    String8 query = str8_cstring(queries[query_idx]);
+    U64 scan_matches_count = 0;
+    U64 scan_begin_us = now_time_us();
+    for EachIndex(iteration_idx, iteration_count)
+    {
+      scan_matches_count = 0;
+      for EachIndex(idx, names.count)
+      {
+        Temp temp = temp_begin(scratch.arena);
+        FuzzyMatchRangeList matches = fuzzy_match_find(temp.arena, query, names.v[idx]);
+        scan_matches_count += (matches.count == matches.needle_part_count);
+        temp_end(temp);
+      }
+    }
+    U64 scan_end_us = now_time_us();
+    U64 index_matches_count = 0;
+    U64 index_candidates_count = 0;
+    U64 index_begin_us = now_time_us();
+    for EachIndex(iteration_idx, iteration_count)
+    {
+      Temp temp = temp_begin(scratch.arena);
+      index_matches_count = 0;
+      index_candidates_count = 0;
+      DI_SearchPostingListArray lists = di_search_posting_list_array_from_query(temp.arena, index, query);
+      U64 *lists_cursors = push_array(temp.arena, U64, lists.count);
+      U64 candidates_count = (lists.count != 0 ? lists.v[0].count : names.count);
+      for EachIndex(candidate_idx, candidates_count)
+      {
+        U64 idx = candidate_idx;
+        if(lists.count != 0)
+        {
+          idx = lists.v[0].v[candidate_idx];
+          if(!di_search_posting_lists_contain(lists.v+1, lists.count-1, lists_cursors+1, (U32)idx))
+          {
+            continue;
+          }
+        }
+        index_candidates_count += 1;
+        Temp match_temp = temp_begin(temp.arena);
+        FuzzyMatchRangeList matches = fuzzy_match_find(match_temp.arena, query, names.v[idx]);
+        index_matches_count += (matches.count == matches.needle_part_count);
+        temp_end(match_temp);
+      }
+      temp_end(temp);
+    }
+    U64 index_end_us = now_time_us();
+    F64 scan_us = (F64)(scan_end_us-scan_begin_us)/iteration_count;
+    F64 index_us = (F64)(index_end_us-index_begin_us)/iteration_count;
+    printf("search: %8" PRIu64 " names | %-24.*s | scan: %10.2f us | index: %10.2f us (%8" PRIu64 " candidates) | %6.1fx | %" PRIu64 " matches%s\n",
+           count, str8_varg(query), scan_us, index_us, index_candidates_count,
+           index_us > 0 ? scan_us/index_us : 0.0, index_matches_count,
+           scan_matches_count == index_matches_count ? "" : " (MISMATCH)");
+  }
+  scratch_end(scratch);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+internal void
+entry_point(CmdLine *cmdline)
+{
+  // NOTE: the index build is written for wide lanes; run it on one lane here,
+  // so timings compare single-threaded scans with single-threaded queries.
+  U64 lane_broadcast_memory = 0;
+  LaneCtx single_lane_ctx = {0, 1, {0}, &lane_broadcast_memory};
+  lane_ctx(single_lane_ctx);
+  Arena *arena = arena_alloc();
+  U64 iteration_count = 4;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("iterations")), &iteration_count);
+  U64 counts[] = {10000, 100000, 1000000};
+  U64 count = 0;
+  if(try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("count")), &count) && count != 0)
+  {
+    searchperf_run(arena, count, Max(iteration_count, 1));
+  }
+  else for EachElement(idx, counts)
+  {
+    searchperf_run(arena, counts[idx], Max(iteration_count, 1));
+  }
+}
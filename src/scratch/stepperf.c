@@ -0,0 +1,386 @@
+// Copyright (c) Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+////////////////////////////////
+//~ Build Options
+
+#define BUILD_TITLE "stepperf"
+#define BUILD_CONSOLE_INTERFACE 1
+#define NO_ASYNC 1
+#define DMN_INIT_MANUAL 1
+#define D_INIT_MANUAL 1
+
+////////////////////////////////
+//~ Includes
+
+//- [h]
+#include "base/base_inc.h"
+#include "x64/x64.h"
+#include "linker/hash_table.h"
+#include "linker/base_ext/base_bit_array.h"
+#include "artifact_cache/artifact_cache.h"
+#include "rdi/rdi_local.h"
+#include "rdi_make/rdi_make_local.h"
+#include "minidump/minidump.h"
+#include "minidump/minidump_parse.h"
+#include "mdesk/mdesk.h"
+#include "content/content.h"
+#include "file_stream/file_stream.h"
+#include "text/text.h"
+#include "mutable_text/mutable_text.h"
+#include "coff/coff.h"
+#include "coff/coff_parse.h"
+#include "pe/pe.h"
+#include "zstd/zstd.h"
+#include "elf/elf.h"
+#include "gnu/gnu.h"
+#include "gnu/gnu_parse.h"
+#include "elf/elf_parse.h"
+#include "codeview/codeview.h"
+#include "codeview/codeview_parse.h"
+#include "msf/msf.h"
+#include "msf/msf_parse.h"
+#include "pdb/pdb.h"
+#include "pdb/pdb_parse.h"
+#include "dwarf/dwarf_inc.h"
+#include "arch/arch_inc.h"
+#include "dbg_info/dbg_info.h"
+#include "disasm/disasm_inc.h"
+#include "stap/stap_parse.h"
+#include "demon/demon_inc.h"
+#include "eval/eval_inc.h"
+#include "dbg_engine/dbg_engine_inc.h"
+
+// NOTE: the eval & engine layers still reach up into the frontend for list
+// gathers & path overrides; this program uses none of them.
+internal D_Entity *rd_ctrl_entity_from_eval_space(E_Space space) { return &d_entity_nil; }
+internal String8List rd_possible_overrides_from_file_path(Arena *arena, String8 file_path) { String8List result = {0}; return result; }
+
+//- [c]
+#include "base/base_inc.c"
+#include "x64/x64.c"
+#include "linker/hash_table.c"
+#include "linker/base_ext/base_bit_array.c"
+#include "artifact_cache/artifact_cache.c"
+#include "rdi/rdi_local.c"
+#include "rdi_make/rdi_make_local.c"
+#include "minidump/minidump.c"
+#include "minidump/minidump_parse.c"
+#include "mdesk/mdesk.c"
+#include "content/content.c"
+#include "file_stream/file_stream.c"
+#include "text/text.c"
+#include "mutable_text/mutable_text.c"
+#include "coff/coff.c"
+#include "coff/coff_parse.c"
+#include "pe/pe.c"
+#include "zstd/zstd.c"
+#include "elf/elf.c"
+#include "gnu/gnu.c"
+#include "gnu/gnu_parse.c"
+#include "elf/elf_parse.c"
+#include "codeview/codeview.c"
+#include "codeview/codeview_parse.c"
+#include "msf/msf.c"
+#include "msf/msf_parse.c"
+#include "pdb/pdb.c"
+#include "pdb/pdb_parse.c"
+#include "dwarf/dwarf_inc.c"
+#include "arch/arch_inc.c"
+#include "dbg_info/dbg_info.c"
+#include "disasm/disasm_inc.c"
+#include "stap/stap_parse.c"
+#include "demon/demon_inc.c"
+#include "eval/eval_inc.c"
+#include "dbg_engine/dbg_engine_inc.c"
+
+
+////////////////////////////////
+//~ Target
+//
+// The benchmark re-launches this program with --target; the target stops on an
+// int3 with the bounds of a tight loop in rax/rdx/rcx, then runs the loop
+// forever. The loop stands in for two source lines: [rax, rdx) & [rdx, rcx),
+// where the first has a branch which stays inside of it, & the second jumps
+// back to the first.
+
+#if OS_LINUX && ARCH_X64
+__asm__(".text\n"
+        ".type stepperf_loop, @function\n"
+        "stepperf_loop:\n"
+        "  add $1, %rax\n"
+        "  imul $3, %rax, %rcx\n"
+        "  xor %rcx, %rdx\n"
+        "  lea (%rdx,%rax,2), %rsi\n"
+        "  test $1, %rsi\n"
+        "  jz 1f\n"
+        "  add %rsi, %rdi\n"
+        "1:\n"
+        "stepperf_line_b:\n"
+        "  sub %rax, %rdi\n"
+        "  ror $3, %rdi\n"
+        "  jmp stepperf_loop\n"
+        "stepperf_loop_end:\n"
+        "  ret\n");
+void stepperf_loop(void);
+extern U8 stepperf_line_b[];
+extern U8 stepperf_loop_end[];
+#endif
+
+internal void
+stepperf_target(void)
+{
+#if OS_LINUX && ARCH_X64
+  __asm__ volatile("int3" :: "a"(stepperf_loop), "d"(stepperf_line_b), "c"(stepperf_loop_end));
+  stepperf_loop();
+#endif
+}
+
+////////////////////////////////
+//~ Debugger Side Helpers
+
+internal DMN_Handle
+stepperf_run_to_stop(Arena *arena, DMN_CtrlCtx *ctrl, DMN_RunCtrls *run_ctrls, DMN_Handle *thread_out)
+{
+  DMN_Handle process = {0};
+  for(B32 done = 0; !done;)
+  {
+    Temp temp = temp_begin(arena);
+    DMN_EventList events = dmn_ctrl_run(temp.arena, ctrl, run_ctrls);
+    for EachNode(n, DMN_EventNode, events.first)
+    {
+      switch(n->v.kind)
+      {
+        default:{}break;
+        case DMN_EventKind_CreateProcess:{process = n->v.process;}break;
+        case DMN_EventKind_Breakpoint:
+        case DMN_EventKind_Exception:{done = 1; process = n->v.process; thread_out[0] = n->v.thread;}break;
+        case DMN_EventKind_Error:
+        case DMN_EventKind_ExitProcess:{done = 1; MemoryZeroStruct(&process);}break;
+      }
+    }
+    temp_end(temp);
+  }
+  return process;
+}
+
+internal U64
+stepperf_ip_from_thread(DMN_Handle thread, U8 *regs)
+{
+  dmn_thread_read_reg_block(thread, regs);
+  return arch_ip_from_reg_block(arch_info_from_arch(Arch_x64), regs);
+}
+
+////////////////////////////////
+//~ Trap Nets
+//
+// Mirrors `d_trap_net_from_thread__step_over_line`, for a line with no calls &
+// no stack pointer changes: branches which leave the line, & the end of the
+// line, end the step.
+
+internal D_TrapList
+stepperf_traps_from_line_code(Arena *arena, Rng1U64 line_vaddr_rng, String8 machine_code)
+{
+  Temp scratch = scratch_begin(&arena, 1);
+  D_TrapList traps = {0};
+  DASM_CtrlFlowInfo ctrl_flow_info = dasm_ctrl_flow_info_from_arch_vaddr_code(scratch.arena,
+                                                                              DASM_InstFlag_Call|
+                                                                              DASM_InstFlag_Branch|
+                                                                              DASM_InstFlag_UnconditionalJump|
+                                                                              DASM_InstFlag_ChangesStackPointer|
+                                                                              DASM_InstFlag_Return,
+                                                                              Arch_x64,
+                                                                              line_vaddr_rng.min,
+                                                                              machine_code);
+  for EachNode(n, DASM_CtrlFlowPointNode, ctrl_flow_info.exit_points.first)
+  {
+    if(n->v.inst_flags & (DASM_InstFlag_Branch|DASM_InstFlag_UnconditionalJump) &&
+       n->v.jump_dest_vaddr != 0 &&
+       !contains_1u64(line_vaddr_rng, n->v.jump_dest_vaddr))
+    {
+      D_Trap trap = {D_TrapFlag_EndStepping, n->v.jump_dest_vaddr};
+      d_trap_list_push(arena, &traps, &trap);
+    }
+  }
+  D_Trap trap = {D_TrapFlag_EndStepping, line_vaddr_rng.max};
+  d_trap_list_push(arena, &traps, &trap);
+  scratch_end(scratch);
+  return traps;
+}
+
+internal D_TrapList
+stepperf_traps_from_line(Arena *arena, D_TrapNetCache *cache, DMN_Handle process, Rng1U64 line_vaddr_rng, U64 run_idx)
+{
+  D_TrapList traps = {0};
+  
+  //- mirror `d_mem_gen_from_process_vaddr_range`: without per-page tracking,
+  // the generation changes with every run
+  U64 mem_gen = run_idx;
+  U64 page_gen = dmn_process_memory_gen_from_range(process, line_vaddr_rng);
+  if(page_gen != 0)
+  {
+    mem_gen = page_gen | (1ull<<63);
+  }
+  
+  //- try the cache with the generation, then with the code bytes
+  D_TrapNet net = {0};
+  D_TrapNetCacheKey key = {D_CmdKind_StepOverLine, d_handle_zero(), di_key_zero(), line_vaddr_rng};
+  if(cache != 0 && d_trap_net_from_cache(arena, cache, &key, mem_gen, str8_zero(), &net))
+  {
+    traps = net.traps;
+  }
+  else
+  {
+    String8 machine_code = {push_array_no_zero(arena, U8, dim_1u64(line_vaddr_rng)), dim_1u64(line_vaddr_rng)};
+    dmn_process_read(process, line_vaddr_rng, machine_code.str);
+    if(cache != 0 && d_trap_net_from_cache(arena, cache, &key, mem_gen, machine_code, &net))
+    {
+      traps = net.traps;
+    }
+    else
+    {
+      traps = stepperf_traps_from_line_code(arena, line_vaddr_rng, machine_code);
+      if(cache != 0)
+      {
+        d_trap_net_cache_store(cache, &key, mem_gen, machine_code, &traps);
+      }
+    }
+  }
+  return traps;
+}
+
+////////////////////////////////
+//~ Benchmark
+//
+// Steps over the target's loop lines, building each line's trap net like the
+// engine does, with & without the trap net cache, & times both the trap net
+// builds & whole steps (build, run, & stop on an end-stepping trap).
+
+internal void
+stepperf_steps(Arena *arena, DMN_CtrlCtx *ctrl, String8 exe_path, U64 step_count, B32 use_cache)
+{
+  Temp temp = temp_begin(arena);
+  D_TrapNetCache *cache = use_cache ? d_trap_net_cache_alloc() : 0;
+  U8 *regs = push_array(temp.arena, U8, arch_info_from_arch(Arch_x64)->reg_block_size);
+  
+  //- launch the target, & run until it reports its lines
+  ProcessLaunchParams params = {0};
+  str8_list_push(temp.arena, &params.cmd_line, exe_path);
+  str8_list_push(temp.arena, &params.cmd_line, str8_lit("--target"));
+  params.path = get_process_info()->initial_path;
+  params.inherit_env = 1;
+  dmn_ctrl_launch(ctrl, &params);
+  DMN_Handle thread = {0};
+  DMN_RunCtrls run_ctrls = {0};
+  DMN_Handle process = stepperf_run_to_stop(temp.arena, ctrl, &run_ctrls, &thread);
+  if(dmn_handle_match(process, dmn_handle_zero()))
+  {
+    fprintf(stderr, "steps: failed to launch target\n");
+    goto end;
+  }
+  Rng1U64 lines[2] = {0};
+  {
+    ARCH_Info *arch_info = arch_info_from_arch(Arch_x64);
+    U64 bounds[3] = {0};
+    String8 names[3] = {str8_lit("rax"), str8_lit("rdx"), str8_lit("rcx")};
+    dmn_thread_read_reg_block(thread, regs);
+    for EachElement(idx, names)
+    {
+      arch_reg_block_read_range(arch_info, regs, arch_info->reg_code_rng_table[arch_reg_code_from_name(arch_info, names[idx])], &bounds[idx]);
+    }
+    lines[0] = r1u64(bounds[0], bounds[1]);
+    lines[1] = r1u64(bounds[1], bounds[2]);
+  }
+  
+  //- run to the top of the loop
+  {
+    DMN_Trap trap = {process, lines[0].min, 0};
+    dmn_trap_chunk_list_push(temp.arena, &run_ctrls.traps, 16, &trap);
+    stepperf_run_to_stop(temp.arena, ctrl, &run_ctrls, &thread);
+  }
+  
+  //- step over lines
+  U64 build_us = 0;
+  U64 step_us = 0;
+  for EachIndex(step_idx, step_count)
+  {
+    Temp step_temp = temp_begin(temp.arena);
+    U64 ip = stepperf_ip_from_thread(thread, regs);
+    Rng1U64 line = contains_1u64(lines[1], ip) ? lines[1] : lines[0];
+    U64 begin_us = now_time_us();
+    D_TrapList traps = stepperf_traps_from_line(step_temp.arena, cache, process, line, step_idx+1);
+    U64 build_end_us = now_time_us();
+    DMN_RunCtrls step_ctrls = {0};
+    for EachNode(n, D_TrapNode, traps.first)
+    {
+      DMN_Trap trap = {process, n->v.vaddr, 0};
+      dmn_trap_chunk_list_push(step_temp.arena, &step_ctrls.traps, 16, &trap);
+    }
+    DMN_Handle stopped_process = stepperf_run_to_stop(step_temp.arena, ctrl, &step_ctrls, &thread);
+    U64 end_us = now_time_us();
+    build_us += build_end_us - begin_us;
+    step_us += end_us - begin_us;
+    temp_end(step_temp);
+    if(dmn_handle_match(stopped_process, dmn_handle_zero()))
+    {
+      fprintf(stderr, "steps: target exited\n");
+      process = stopped_process;
+      break;
+    }
+  }
+  printf("steps: cache %-3s | %6" PRIu64 " steps | %8.2f us/trap net | %8.2f us/step | %" PRIu64 " hits, %" PRIu64 " misses\n",
+         use_cache ? "on" : "off", step_count, build_us/(F64)step_count, step_us/(F64)step_count,
+         cache ? cache->hit_count : 0, cache ? cache->miss_count : 0);
+  end:;
+  
+  //- kill the target, & wait for it to exit, so its events don't leak into
+  // the next launch
+  if(!dmn_handle_match(process, dmn_handle_zero()))
+  {
+    dmn_ctrl_kill(ctrl, process, 0);
+    DMN_RunCtrls kill_run_ctrls = {0};
+    for(B32 done = 0; !done;)
+    {
+      Temp run_temp = temp_begin(temp.arena);
+      DMN_EventList events = dmn_ctrl_run(run_temp.arena, ctrl, &kill_run_ctrls);
+      for EachNode(n, DMN_EventNode, events.first)
+      {
+        done = (done ||
+                n->v.kind == DMN_EventKind_Error ||
+                (n->v.kind == DMN_EventKind_ExitProcess && dmn_handle_match(n->v.process, process)));
+      }
+      temp_end(run_temp);
+    }
+  }
+  if(cache != 0)
+  {
+    d_trap_net_cache_release(cache);
+  }
+  temp_end(temp);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+internal void
+entry_point(CmdLine *cmdline)
+{
+  if(cmd_line_has_flag(cmdline, str8_lit("target")))
+  {
+    stepperf_target();
+    return;
+  }
+#if OS_LINUX && ARCH_X64
+  Arena *arena = arena_alloc();
+  U64 step_count = 20000;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("steps")), &step_count);
+  step_count = Max(step_count, 1);
+  dmn_init();
+  DMN_CtrlCtx *ctrl = dmn_ctrl_begin();
+  String8 exe_path = str8f(arena, "%S/%S", get_process_info()->binary_path, str8_skip_last_slash(cmdline->exe_name));
+  stepperf_steps(arena, ctrl, exe_path, step_count, 0);
+  stepperf_steps(arena, ctrl, exe_path, step_count, 1);
+#else
+  fprintf(stderr, "stepperf: only supported on Linux x64\n");
+#endif
+}
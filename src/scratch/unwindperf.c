@@ -0,0 +1,671 @@
+// Copyright (c) Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+////////////////////////////////
+//~ Build Options
+
+#define BUILD_TITLE "unwindperf"
+#define BUILD_CONSOLE_INTERFACE 1
+#define NO_ASYNC 1
+
+////////////////////////////////
+//~ Includes
+
+//- [h]
+#include "base/base_inc.h"
+#include "x64/x64.h"
+#include "linker/hash_table.h"
+#include "linker/base_ext/base_bit_array.h"
+#include "artifact_cache/artifact_cache.h"
+#include "rdi/rdi_local.h"
+#include "rdi_make/rdi_make_local.h"
+#include "minidump/minidump.h"
+#include "minidump/minidump_parse.h"
+#include "mdesk/mdesk.h"
+#include "content/content.h"
+#include "file_stream/file_stream.h"
+#include "text/text.h"
+#include "mutable_text/mutable_text.h"
+#include "coff/coff.h"
+#include "coff/coff_parse.h"
+#include "pe/pe.h"
+#include "zstd/zstd.h"
+#include "elf/elf.h"
+#include "gnu/gnu.h"
+#include "gnu/gnu_parse.h"
+#include "elf/elf_parse.h"
+#include "codeview/codeview.h"
+#include "codeview/codeview_parse.h"
+#include "msf/msf.h"
+#include "msf/msf_parse.h"
+#include "pdb/pdb.h"
+#include "pdb/pdb_parse.h"
+#include "dwarf/dwarf_inc.h"
+#include "win32/win32_inc.h"
+#include "arch/arch_inc.h"
+#include "dbg_info/dbg_info.h"
+#include "disasm/disasm_inc.h"
+#include "stap/stap_parse.h"
+#include "demon/demon_inc.h"
+#include "eval/eval_inc.h"
+#include "dbg_engine/dbg_engine_inc.h"
+
+// NOTE: the eval & engine layers still reach up into the frontend for list
+// gathers & path overrides; this program uses none of them.
+internal D_Entity *rd_ctrl_entity_from_eval_space(E_Space space) { return &d_entity_nil; }
+internal String8List rd_possible_overrides_from_file_path(Arena *arena, String8 file_path) { String8List result = {0}; return result; }
+
+//- [c]
+#include "base/base_inc.c"
+#include "x64/x64.c"
+#include "linker/hash_table.c"
+#include "linker/base_ext/base_bit_array.c"
+#include "artifact_cache/artifact_cache.c"
+#include "rdi/rdi_local.c"
+#include "rdi_make/rdi_make_local.c"
+#include "minidump/minidump.c"
+#include "minidump/minidump_parse.c"
+#include "mdesk/mdesk.c"
+#include "content/content.c"
+#include "file_stream/file_stream.c"
+#include "text/text.c"
+#include "mutable_text/mutable_text.c"
+#include "coff/coff.c"
+#include "coff/coff_parse.c"
+#include "pe/pe.c"
+#include "zstd/zstd.c"
+#include "elf/elf.c"
+#include "gnu/gnu.c"
+#include "gnu/gnu_parse.c"
+#include "elf/elf_parse.c"
+#include "codeview/codeview.c"
+#include "codeview/codeview_parse.c"
+#include "msf/msf.c"
+#include "msf/msf_parse.c"
+#include "pdb/pdb.c"
+#include "pdb/pdb_parse.c"
+#include "dwarf/dwarf_inc.c"
+#include "win32/win32_inc.c"
+#include "arch/arch_inc.c"
+#include "dbg_info/dbg_info.c"
+#include "disasm/disasm_inc.c"
+#include "stap/stap_parse.c"
+#include "demon/demon_inc.c"
+#include "eval/eval_inc.c"
+#include "dbg_engine/dbg_engine_inc.c"
+
+#if OS_LINUX
+# include <link.h>
+#endif
+
+////////////////////////////////
+//~ Module
+//
+// The unwinder works on this program's own executable, through its
+// .eh_frame_hdr, the same way the debugger works on a debuggee's modules;
+// memory reads are plain loads rather than process memory cache lookups.
+
+typedef struct UNWINDPERF_Module UNWINDPERF_Module;
+struct UNWINDPERF_Module
+{
+  Rng1U64 text_vrange;
+  EH_FrameHdr eh_frame_hdr;
+  EH_PtrCtx eh_ptr_ctx;
+};
+
+#if OS_LINUX
+internal int
+unwindperf_module_from_phdr(struct dl_phdr_info *info, size_t size, void *data)
+{
+  int result = 0;
+  UNWINDPERF_Module *module = data;
+  Rng1U64 text_vrange = {0};
+  Rng1U64 eh_frame_hdr_vrange = {0};
+  for EachIndex(idx, info->dlpi_phnum)
+  {
+    const ElfW(Phdr) *phdr = &info->dlpi_phdr[idx];
+    Rng1U64 vrange = r1u64(info->dlpi_addr + phdr->p_vaddr, info->dlpi_addr + phdr->p_vaddr + phdr->p_memsz);
+    if(phdr->p_type == PT_LOAD && phdr->p_flags & PF_X)
+    {
+      text_vrange = vrange;
+    }
+    if(phdr->p_type == PT_GNU_EH_FRAME)
+    {
+      eh_frame_hdr_vrange = vrange;
+    }
+  }
+  if(contains_1u64(text_vrange, (U64)&unwindperf_module_from_phdr) && eh_frame_hdr_vrange.max != 0)
+  {
+    module->text_vrange = text_vrange;
+    module->eh_ptr_ctx = (EH_PtrCtx){ .pc_vaddr = max_U64, .text_vaddr = max_U64, .data_vaddr = max_U64, .func_vaddr = max_U64, .ptr_align = 0 };
+    module->eh_ptr_ctx.pc_vaddr   = eh_frame_hdr_vrange.min;
+    module->eh_ptr_ctx.data_vaddr = eh_frame_hdr_vrange.min;
+    module->eh_frame_hdr = eh_parse_frame_hdr(str8((U8 *)eh_frame_hdr_vrange.min, dim_1u64(eh_frame_hdr_vrange)), 8, &module->eh_ptr_ctx);
+    result = 1;
+  }
+  return result;
+}
+#endif
+
+internal MACHINE_OP_MEM_READ(unwindperf_mem_read)
+{
+  MemoryCopy(buffer, (void *)addr, buffer_size);
+  return MachineOpResult_Ok;
+}
+
+////////////////////////////////
+//~ Call Frame Info
+//
+// Mirrors `d_establish_frame_unwind_context__dwarf`: find the nearest FDE,
+// then parse it & its CIE. Unwinds either replay the FDE up to the IP on
+// each frame, or look up rows in per-FDE row tables, built on first use.
+
+typedef struct UNWINDPERF_RowTableNode UNWINDPERF_RowTableNode;
+struct UNWINDPERF_RowTableNode
+{
+  UNWINDPERF_RowTableNode *next;
+  U64 fde_addr;
+  U64 ret_addr_reg;
+  DW_CFI_RowTable table;
+};
+
+#define UNWINDPERF_ROW_TABLE_SLOTS_COUNT 256
+global Arena *unwindperf_row_table_arena = 0;
+global UNWINDPERF_RowTableNode *unwindperf_row_table_slots[UNWINDPERF_ROW_TABLE_SLOTS_COUNT] = {0};
+global U64 unwindperf_row_table_count = 0;
+global U64 unwindperf_row_count = 0;
+
+internal B32
+unwindperf_cfi_from_fde_addr(UNWINDPERF_Module *module, U64 fde_addr, DW_CIE *cie_out, DW_FDE *fde_out)
+{
+  B32 result = 0;
+
+  //- FDE
+  U32 fde_first_four_bytes = *(U32 *)fde_addr;
+  DW_Format fde_format = (fde_first_four_bytes == max_U32 ? DW_Format_64Bit : DW_Format_32Bit);
+  U64 fde_size = (fde_format == DW_Format_64Bit ? 12 + *(U64 *)(fde_addr + 4) : 4 + fde_first_four_bytes);
+  String8 fde_data = str8((U8 *)fde_addr, fde_size);
+  U64 cie_delta_off = (fde_format == DW_Format_32Bit ? 4 : 12);
+  U64 cie_delta = 0;
+  if(str8_deserial_read_dwarf_uint(fde_data, cie_delta_off, fde_format, &cie_delta) != 0)
+  {
+    //- CIE
+    U64 cie_addr = (fde_addr + cie_delta_off) - cie_delta;
+    U32 cie_first_four_bytes = *(U32 *)cie_addr;
+    DW_Format cie_format = (cie_first_four_bytes == max_U32 ? DW_Format_64Bit : DW_Format_32Bit);
+    U64 cie_size = (cie_format == DW_Format_64Bit ? 12 + *(U64 *)(cie_addr + 4) : 4 + cie_first_four_bytes);
+    String8 cie_data = str8((U8 *)cie_addr, cie_size);
+    EH_PtrCtx eh_ptr_ctx = module->eh_ptr_ctx;
+    result = (eh_parse_cie(cie_data, cie_format, Arch_x64, cie_addr, &eh_ptr_ctx, cie_out) &&
+              eh_parse_fde(fde_data, fde_format, fde_addr, cie_out, &eh_ptr_ctx, fde_out));
+  }
+  return result;
+}
+
+internal DW_CFI_Row *
+unwindperf_cfi_row_from_ip(Arena *arena, UNWINDPERF_Module *module, U64 ip, B32 use_row_tables, U64 *ret_addr_reg_out)
+{
+  DW_CFI_Row *result = 0;
+  U64 reg_count = dw_reg_count_from_arch(Arch_x64);
+  U64 fde_addr = eh_find_nearest_fde(module->eh_frame_hdr, &module->eh_ptr_ctx, ip);
+  if(fde_addr != max_U64)
+  {
+    //- look for a row table
+    U64 slot_idx = u64_hash_from_str8(str8_struct(&fde_addr))%UNWINDPERF_ROW_TABLE_SLOTS_COUNT;
+    UNWINDPERF_RowTableNode *table_node = 0;
+    if(use_row_tables)
+    {
+      for EachNode(t, UNWINDPERF_RowTableNode, unwindperf_row_table_slots[slot_idx])
+      {
+        if(t->fde_addr == fde_addr)
+        {
+          table_node = t;
+          break;
+        }
+      }
+    }
+
+    //- none? -> parse, & replay the FDE
+    if(table_node == 0)
+    {
+      DW_CIE cie = {0};
+      DW_FDE fde = {0};
+      if(unwindperf_cfi_from_fde_addr(module, fde_addr, &cie, &fde) && contains_1u64(fde.pc_range, ip))
+      {
+        EH_PtrCtx eh_ptr_ctx = module->eh_ptr_ctx;
+        EH_DecodePtrCtx decode_ptr_ctx = {cie.ext[EH_CIE_Ext_AddrEnc], &eh_ptr_ctx};
+        if(use_row_tables)
+        {
+          table_node = push_array(unwindperf_row_table_arena, UNWINDPERF_RowTableNode, 1);
+          table_node->fde_addr     = fde_addr;
+          table_node->ret_addr_reg = cie.ret_addr_reg;
+          table_node->table        = dw_cfi_row_table_from_fde(unwindperf_row_table_arena, Arch_x64, &cie, &fde, eh_decode_ptr, &decode_ptr_ctx);
+          SLLStackPush(unwindperf_row_table_slots[slot_idx], table_node);
+          unwindperf_row_table_count += 1;
+          unwindperf_row_count += table_node->table.count;
+        }
+        else
+        {
+          result = dw_cfi_row_from_pc(arena, Arch_x64, &cie, &fde, eh_decode_ptr, &decode_ptr_ctx, ip);
+          ret_addr_reg_out[0] = cie.ret_addr_reg;
+        }
+      }
+    }
+
+    //- row table -> look up row
+    if(table_node != 0)
+    {
+      DW_CFI_Row *row = dw_cfi_row_from_row_table(&table_node->table, ip);
+      if(row != 0)
+      {
+        result = dw_copy_cfi_row_deep(arena, row, reg_count);
+        ret_addr_reg_out[0] = table_node->ret_addr_reg;
+      }
+    }
+  }
+  return result;
+}
+
+////////////////////////////////
+//~ Unwinding
+
+typedef struct UNWINDPERF_Unwind UNWINDPERF_Unwind;
+struct UNWINDPERF_Unwind
+{
+  U64 frame_count;
+  U64 ip_hash;
+};
+
+internal UNWINDPERF_Unwind
+unwindperf_unwind(UNWINDPERF_Module *module, X64_RegBlock *initial_regs, B32 use_row_tables)
+{
+  Temp scratch = scratch_begin(0, 0);
+  UNWINDPERF_Unwind result = {0};
+  X64_RegBlock regs = *initial_regs;
+  for(;;)
+  {
+    U64 ip = regs.rip;
+    if(!contains_1u64(module->text_vrange, ip))
+    {
+      break;
+    }
+    result.frame_count += 1;
+    result.ip_hash = result.ip_hash*31 + ip;
+    U64 ret_addr_reg = 0;
+    DW_CFI_Row *row = unwindperf_cfi_row_from_ip(scratch.arena, module, ip, use_row_tables, &ret_addr_reg);
+    U64 cfa = 0;
+    if(row == 0 ||
+       dw_compute_cfa(Arch_x64, row, &regs, unwindperf_mem_read, 0, &cfa) != MachineOpResult_Ok ||
+       dw_cfi_apply_register_rules(Arch_x64, cfa, row, &regs, unwindperf_mem_read, 0) != MachineOpResult_Ok ||
+       row->regs[ret_addr_reg].rule == DW_CFI_RegisterRule_Undefined)
+    {
+      break;
+    }
+  }
+  scratch_end(scratch);
+  return result;
+}
+
+////////////////////////////////
+//~ Recursive Stack
+//
+// Recurses `depth` frames deep, then runs the benchmark from the deepest
+// frame, unwinding from its own registers, so that the whole stack stays
+// intact.
+
+global U64 unwindperf_iteration_count = 0;
+global UNWINDPERF_Module unwindperf_module = {0};
+
+no_inline internal void
+unwindperf_bench(U64 depth)
+{
+#if ARCH_X64
+  X64_RegBlock regs = {0};
+  __asm__ volatile("lea 0(%%rip), %0\n\t"
+                   "mov %%rsp, %1\n\t"
+                   "mov %%rbp, %2\n\t"
+                   "mov %%rbx, %3\n\t"
+                   : "=r"(regs.rip), "=r"(regs.rsp), "=r"(regs.rbp), "=r"(regs.rbx));
+  UNWINDPERF_Unwind unwinds[2] = {0};
+  F64 unwinds_per_second[2] = {0};
+  for EachElement(mode_idx, unwinds)
+  {
+    B32 use_row_tables = (mode_idx == 1);
+    U64 begin_us = now_time_us();
+    for EachIndex(iteration_idx, unwindperf_iteration_count)
+    {
+      unwinds[mode_idx] = unwindperf_unwind(&unwindperf_module, &regs, use_row_tables);
+    }
+    U64 end_us = now_time_us();
+    unwinds_per_second[mode_idx] = unwindperf_iteration_count / ((F64)Max(end_us - begin_us, 1) / Million(1));
+  }
+  B32 match = (unwinds[0].frame_count == unwinds[1].frame_count && unwinds[0].ip_hash == unwinds[1].ip_hash);
+  printf("unwind: depth %5" PRIu64 ", %5" PRIu64 " frames | replayed: %9.1f unwinds/s (%10.0f frames/s) | row tables: %9.1f unwinds/s (%10.0f frames/s) | %5.1fx | %" PRIu64 " FDEs, %" PRIu64 " rows%s\n",
+         depth, unwinds[1].frame_count,
+         unwinds_per_second[0], unwinds_per_second[0]*unwinds[0].frame_count,
+         unwinds_per_second[1], unwinds_per_second[1]*unwinds[1].frame_count,
+         unwinds_per_second[1]/Max(unwinds_per_second[0], 1),
+         unwindperf_row_table_count, unwindperf_row_count,
+         match ? "" : " (MISMATCH)");
+#endif
+}
+
+no_inline internal U64
+unwindperf_recurse(U64 depth, U64 remaining)
+{
+  // volatile, so that each level keeps a real frame, rather than the
+  // recursion being folded into a loop
+  volatile U64 frame_remaining = remaining;
+  U64 result = 0;
+  if(remaining == 0)
+  {
+    unwindperf_bench(depth);
+  }
+  else
+  {
+    result = unwindperf_recurse(depth, remaining - 1) + frame_remaining;
+  }
+  return result;
+}
+
+////////////////////////////////
+//~ Incremental Refresh
+//
+// Times the engine's unwind cache. An x64 minidump holds one stack per thread,
+// each a chain of 16 to 31 return addresses ending with zero. Each "stop"
+// moves some threads to a new depth, by rewriting their contexts & stacks in
+// the dump file, & bumps the memory & register generations as a real stop
+// does; then every thread is unwound again through d_unwind_from_thread,
+// either with the cache dropped first, or with it kept.
+
+#define UNWINDPERF_STACK_BASE_VADDR 0x00007ff000000000ull
+#define UNWINDPERF_STACK_STRIDE     0x0000000000100000ull
+#define UNWINDPERF_STACK_SIZE       D_UNWIND_STACK_SNAPSHOT_SIZE
+#define UNWINDPERF_MAX_DEPTH        32
+
+typedef struct UNWINDPERF_Dump UNWINDPERF_Dump;
+struct UNWINDPERF_Dump
+{
+  String8 data;
+  U64 contexts_foff;
+  U64 stacks_foff;
+};
+
+typedef struct UNWINDPERF_ThreadFrames UNWINDPERF_ThreadFrames;
+struct UNWINDPERF_ThreadFrames
+{
+  U64 rip;
+  U64 return_addresses[UNWINDPERF_MAX_DEPTH];
+};
+
+internal UNWINDPERF_ThreadFrames
+unwindperf_thread_frames_from_depth(U64 thread_idx, U64 depth)
+{
+  UNWINDPERF_ThreadFrames result = {0};
+  result.rip = 0x140001000ull + thread_idx*0x100 + depth*0x10;
+  for EachIndex(frame_idx, Min(depth, UNWINDPERF_MAX_DEPTH-1))
+  {
+    result.return_addresses[frame_idx] = 0x140002000ull + frame_idx*0x10;
+  }
+  return result;
+}
+
+internal UNWINDPERF_Dump
+unwindperf_dump_from_depths(Arena *arena, U64 *depths, U64 threads_count)
+{
+  //- lay out the file
+  U64 directories_count = 3;
+  U64 directories_foff  = sizeof(MDMP_Header);
+  U64 system_info_foff  = directories_foff + directories_count*sizeof(MDMP_Directory);
+  U64 thread_list_foff  = system_info_foff + sizeof(MDMP_SystemInfo);
+  U64 contexts_foff     = AlignPow2(thread_list_foff + sizeof(U32) + threads_count*sizeof(MDMP_Thread), 16);
+  U64 memory_list_foff  = contexts_foff + threads_count*sizeof(W32_X64_ThreadContext);
+  U64 stacks_foff       = AlignPow2(memory_list_foff + sizeof(U32) + threads_count*sizeof(MDMP_MemoryDescriptor32), 16);
+  U64 size              = stacks_foff + threads_count*UNWINDPERF_STACK_SIZE;
+  U8 *data = push_array(arena, U8, size);
+  
+  //- header & directories
+  {
+    MDMP_Header *header = (MDMP_Header *)data;
+    header->magic                 = MDMP_MAGIC;
+    header->number_of_streams     = directories_count;
+    header->stream_directory_foff = directories_foff;
+    MDMP_Directory *dirs = (MDMP_Directory *)(data + directories_foff);
+    dirs[0].stream_kind = MDMP_StreamKind_SystemInfo;
+    dirs[0].location    = (MDMP_LocationDescriptor32){sizeof(MDMP_SystemInfo), system_info_foff};
+    dirs[1].stream_kind = MDMP_StreamKind_ThreadList;
+    dirs[1].location    = (MDMP_LocationDescriptor32){contexts_foff - thread_list_foff, thread_list_foff};
+    dirs[2].stream_kind = MDMP_StreamKind_MemoryList;
+    dirs[2].location    = (MDMP_LocationDescriptor32){stacks_foff - memory_list_foff, memory_list_foff};
+    MDMP_SystemInfo *system_info = (MDMP_SystemInfo *)(data + system_info_foff);
+    system_info->processor_architecture = MDMP_Arch_x64;
+  }
+  
+  //- threads, contexts, & stacks
+  {
+    *(U32 *)(data + thread_list_foff) = (U32)threads_count;
+    *(U32 *)(data + memory_list_foff) = (U32)threads_count;
+    MDMP_Thread *threads = (MDMP_Thread *)(data + thread_list_foff + sizeof(U32));
+    MDMP_MemoryDescriptor32 *stacks = (MDMP_MemoryDescriptor32 *)(data + memory_list_foff + sizeof(U32));
+    for EachIndex(idx, threads_count)
+    {
+      U64 stack_vaddr = UNWINDPERF_STACK_BASE_VADDR + idx*UNWINDPERF_STACK_STRIDE;
+      U64 stack_foff = stacks_foff + idx*UNWINDPERF_STACK_SIZE;
+      U64 context_foff = contexts_foff + idx*sizeof(W32_X64_ThreadContext);
+      stacks[idx].start_of_memory_range = stack_vaddr;
+      stacks[idx].memory_location       = (MDMP_LocationDescriptor32){UNWINDPERF_STACK_SIZE, stack_foff};
+      threads[idx].id             = (U32)(idx+1);
+      threads[idx].stack          = stacks[idx];
+      threads[idx].thread_context = (MDMP_LocationDescriptor32){sizeof(W32_X64_ThreadContext), context_foff};
+      UNWINDPERF_ThreadFrames frames = unwindperf_thread_frames_from_depth(idx, depths[idx]);
+      W32_X64_ThreadContext *ctx = (W32_X64_ThreadContext *)(data + context_foff);
+      ctx->Rip = frames.rip;
+      ctx->Rsp = stack_vaddr;
+      MemoryCopy(data + stack_foff, frames.return_addresses, sizeof(frames.return_addresses));
+    }
+  }
+  
+  UNWINDPERF_Dump result = {str8(data, size), contexts_foff, stacks_foff};
+  return result;
+}
+
+internal U64
+unwindperf_hash_from_engine_unwind(D_Unwind *unwind)
+{
+  ARCH_Info *arch_info = arch_info_from_arch(Arch_x64);
+  U64 result = unwind->frames.count ^ ((U64)unwind->flags << 32);
+  for EachIndex(idx, unwind->frames.count)
+  {
+    U64 ip = arch_ip_from_reg_block(arch_info, unwind->frames.v[idx].regs);
+    result = (result*1099511628211ull) ^ ip ^ unwind->frames.v[idx].cfa;
+  }
+  return result;
+}
+
+internal void
+unwindperf_refresh(Arena *arena, String8 dump_path, U64 threads_count, U64 stops_count, U64 moved_percent)
+{
+  Temp temp = temp_begin(arena);
+  D_TargetArray targets = {0};
+  D_BreakpointArray breakpoints = {0};
+  D_PathMapArray path_maps = {0};
+  U64 exception_code_filters[(D_ExceptionCodeKind_COUNT+63)/64] = {0};
+  
+  //- write the dump; open it through the engine; gather its threads
+  U64 *depths = push_array(temp.arena, U64, threads_count);
+  for EachIndex(idx, threads_count)
+  {
+    depths[idx] = 16 + idx%16;
+  }
+  UNWINDPERF_Dump dump = unwindperf_dump_from_depths(temp.arena, depths, threads_count);
+  if(!write_data_to_file_path(dump_path, dump.data))
+  {
+    fprintf(stderr, "refresh: could not write %.*s\n", str8_varg(dump_path));
+    temp_end(temp);
+    return;
+  }
+  d_push_cmd(D_CmdKind_OpenCrashDump, &(D_CmdParams){.file_path = dump_path});
+  D_Handle process = {0};
+  D_Handle *threads = push_array(temp.arena, D_Handle, threads_count);
+  U64 threads_found_count = 0;
+  for(B32 stopped = 0; !stopped;)
+  {
+    D_EventList events = d_tick(temp.arena, &targets, &breakpoints, &path_maps, exception_code_filters);
+    for EachNode(n, D_EventNode, events.first)
+    {
+      switch(n->v.kind)
+      {
+        default:{}break;
+        case D_EventKind_NewProc:{process = n->v.entity;}break;
+        case D_EventKind_NewThread:
+        {
+          D_Entity *thread = d_entity_from_handle(n->v.entity);
+          if(1 <= thread->id && thread->id <= threads_count)
+          {
+            threads[thread->id-1] = n->v.entity;
+            threads_found_count += 1;
+          }
+        }break;
+        case D_EventKind_Stopped:{stopped = 1;}break;
+      }
+    }
+    if(!stopped)
+    {
+      sleep_ms(1);
+    }
+  }
+  
+  //- time refreshes: first with the cache dropped at each stop, then with it
+  // kept; the first stop of each fills the cache, & isn't timed
+  U64 moved_count = (threads_count*moved_percent + 99)/100;
+  U64 move_cursor = 0;
+  F64 us_per_stop[2] = {0};
+  U64 hit_count = 0;
+  U64 mismatch_count = 0;
+  U64 *warm_hashes = push_array(temp.arena, U64, threads_count);
+  File file = file_open(AccessFlag_Read|AccessFlag_Write, dump_path);
+  for EachElement(mode_idx, us_per_stop)
+  {
+    B32 incremental = (mode_idx == 1);
+    d_unwind_cache_release(process, d_handle_zero());
+    U64 refresh_us = 0;
+    for EachIndex(stop_idx, stops_count+1)
+    {
+      //- move threads
+      for EachIndex(idx, moved_count)
+      {
+        U64 thread_idx = move_cursor;
+        depths[thread_idx] = 16 + (depths[thread_idx] + 1)%16;
+        UNWINDPERF_ThreadFrames frames = unwindperf_thread_frames_from_depth(thread_idx, depths[thread_idx]);
+        U64 rip_foff = dump.contexts_foff + thread_idx*sizeof(W32_X64_ThreadContext) + OffsetOf(W32_X64_ThreadContext, Rip);
+        U64 stack_foff = dump.stacks_foff + thread_idx*UNWINDPERF_STACK_SIZE;
+        file_write(file, r1u64(rip_foff, rip_foff + sizeof(frames.rip)), &frames.rip);
+        file_write(file, r1u64(stack_foff, stack_foff + sizeof(frames.return_addresses)), frames.return_addresses);
+        move_cursor = (move_cursor + 1)%threads_count;
+      }
+      ins_atomic_u64_inc_eval(&d_ctrl_state->mem_gen);
+      ins_atomic_u64_inc_eval(&d_ctrl_state->reg_gen);
+      
+      //- refresh all unwinds
+      if(!incremental)
+      {
+        d_unwind_cache_release(process, d_handle_zero());
+      }
+      U64 hit_count_before = ins_atomic_u64_eval(&d_ctrl_state->unwind_cache.hit_count);
+      U64 begin_us = now_time_us();
+      for EachIndex(idx, threads_count)
+      {
+        Temp unwind_temp = temp_begin(temp.arena);
+        D_Unwind unwind = d_unwind_from_thread(unwind_temp.arena, threads[idx], 0);
+        if(incremental)
+        {
+          warm_hashes[idx] = unwindperf_hash_from_engine_unwind(&unwind);
+        }
+        temp_end(unwind_temp);
+      }
+      U64 end_us = now_time_us();
+      if(stop_idx != 0)
+      {
+        refresh_us += end_us - begin_us;
+        hit_count += incremental ? ins_atomic_u64_eval(&d_ctrl_state->unwind_cache.hit_count) - hit_count_before : 0;
+      }
+    }
+    us_per_stop[mode_idx] = refresh_us/(F64)Max(stops_count, 1);
+  }
+  file_close(file);
+  
+  //- check the last stop's kept unwinds against fresh ones
+  d_unwind_cache_release(process, d_handle_zero());
+  for EachIndex(idx, threads_count)
+  {
+    Temp unwind_temp = temp_begin(temp.arena);
+    D_Unwind unwind = d_unwind_from_thread(unwind_temp.arena, threads[idx], 0);
+    mismatch_count += (unwind.frames.count != depths[idx]+1 || unwindperf_hash_from_engine_unwind(&unwind) != warm_hashes[idx]);
+    temp_end(unwind_temp);
+  }
+  
+  //- close the dump, so the next refresh starts from a fresh one
+  d_push_cmd(D_CmdKind_Kill, &(D_CmdParams){.process = process});
+  for(B32 stopped = 0; !stopped;)
+  {
+    D_EventList events = d_tick(temp.arena, &targets, &breakpoints, &path_maps, exception_code_filters);
+    for EachNode(n, D_EventNode, events.first)
+    {
+      stopped = (stopped || n->v.kind == D_EventKind_Stopped);
+    }
+    if(!stopped)
+    {
+      sleep_ms(1);
+    }
+  }
+  
+  printf("refresh: %5" PRIu64 " threads, %3" PRIu64 "%% moved/stop | full: %10.1f us/stop | incremental: %10.1f us/stop | %6.1fx | %5.1f%% hits%s\n",
+         threads_found_count, moved_percent,
+         us_per_stop[0], us_per_stop[1],
+         us_per_stop[0]/Max(us_per_stop[1], 1),
+         100.0*hit_count/Max(threads_count*stops_count, 1),
+         (mismatch_count == 0 && threads_found_count == threads_count) ? "" : " (MISMATCH)");
+  temp_end(temp);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+internal void
+entry_point(CmdLine *cmdline)
+{
+  Arena *arena = arena_alloc();
+#if OS_LINUX && ARCH_X64
+  U64 iteration_count = 64;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("iterations")), &iteration_count);
+  unwindperf_iteration_count = Max(iteration_count, 1);
+  unwindperf_row_table_arena = arena_alloc();
+  if(!dl_iterate_phdr(unwindperf_module_from_phdr, &unwindperf_module))
+  {
+    fprintf(stderr, "unwind: no .eh_frame_hdr found for this program\n");
+    return;
+  }
+  U64 depths[] = {16, 256, 4096};
+  for EachElement(idx, depths)
+  {
+    unwindperf_recurse(depths[idx], depths[idx]);
+  }
+#endif
+  
+  //- time refreshes with different shares of the threads moving
+  U64 threads_count = 256;
+  U64 stops_count = 16;
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("threads")), &threads_count);
+  try_u64_from_str8_c_rules(cmd_line_string(cmdline, str8_lit("stops")), &stops_count);
+  threads_count = Clamp(1, threads_count, 4096);
+  String8 dump_path = cmd_line_string(cmdline, str8_lit("out"));
+  if(dump_path.size == 0)
+  {
+    dump_path = push_str8f(arena, "%S/unwindperf.dmp", get_process_info()->binary_path);
+  }
+  U64 moved_percents[] = {0, 1, 10, 100};
+  for EachElement(idx, moved_percents)
+  {
+    unwindperf_refresh(arena, dump_path, threads_count, stops_count, moved_percents[idx]);
+  }
+}
@@ -9,6 +9,13 @@
 
 #include "generated/text.meta.c"
 
+////////////////////////////////
+//~ Includes
+
+#if ARCH_X64
+# include <emmintrin.h>
+#endif
+
 ////////////////////////////////
 //~ rjf: Basic Helpers
 
@@ -64,6 +71,70 @@ txt_lex_function_from_lang_kind(TXT_LangKind kind)
   return fn;
 }
 
+////////////////////////////////
+//~ Line Scanning Functions
+
+internal U32
+txt_newline_mask_from_block(U8 *ptr)
+{
+  U32 result = 0;
+#if ARCH_X64
+  __m128i block = _mm_loadu_si128((__m128i *)ptr);
+  result = (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')));
+#else
+  for EachIndex(idx, TXT_LINE_SCAN_BLOCK_SIZE)
+  {
+    result |= (U32)(ptr[idx] == '\n') << idx;
+  }
+#endif
+  return result;
+}
+
+internal U64
+txt_newline_count_from_string(String8 string)
+{
+  U64 result = 0;
+  U64 off = 0;
+  for(; off+TXT_LINE_SCAN_BLOCK_SIZE <= string.size; off += TXT_LINE_SCAN_BLOCK_SIZE)
+  {
+    result += count_bits_set32(txt_newline_mask_from_block(string.str+off));
+  }
+  for(; off < string.size; off += 1)
+  {
+    result += (string.str[off] == '\n');
+  }
+  return result;
+}
+
+internal U64
+txt_line_ranges_fill_from_data_range(String8 data, Rng1U64 range, Rng1U64 *lines_ranges, U64 lines_count, U64 line_idx)
+{
+  // NOTE: the `line_idx`th newline ends line `line_idx` & starts the next line,
+  // so that disjoint ranges of `data` may be filled independently, given the #
+  // of newlines which precede each range.
+  U64 off = range.min;
+  for(; off+TXT_LINE_SCAN_BLOCK_SIZE <= range.max && line_idx+1 < lines_count; off += TXT_LINE_SCAN_BLOCK_SIZE)
+  {
+    for(U32 mask = txt_newline_mask_from_block(data.str+off); mask != 0 && line_idx+1 < lines_count; mask &= mask-1)
+    {
+      U64 newline_off = off + ctz32(mask);
+      lines_ranges[line_idx].max = newline_off;
+      lines_ranges[line_idx+1].min = newline_off+1;
+      line_idx += 1;
+    }
+  }
+  for(; off < range.max && line_idx+1 < lines_count; off += 1)
+  {
+    if(data.str[off] == '\n')
+    {
+      lines_ranges[line_idx].max = off;
+      lines_ranges[line_idx+1].min = off+1;
+      line_idx += 1;
+    }
+  }
+  return line_idx;
+}
+
 ////////////////////////////////
 //~ rjf: Token Type Functions
 
@@ -93,6 +164,21 @@ txt_token_list_push(Arena *arena, TXT_TokenList *list, TXT_Token *token)
   list->count += 1;
 }
 
+internal void
+txt_token_chunk_list_push_array(Arena *arena, TXT_TokenChunkList *list, TXT_Token *v, U64 count)
+{
+  if(count != 0)
+  {
+    TXT_TokenChunkNode *node = push_array(arena, TXT_TokenChunkNode, 1);
+    SLLQueuePush(list->first, list->last, node);
+    node->cap = count;
+    node->count = count;
+    node->v = v;
+    list->chunk_count += 1;
+    list->token_count += count;
+  }
+}
+
 internal TXT_TokenArray
 txt_token_array_from_chunk_list(Arena *arena, TXT_TokenChunkList *list)
 {
@@ -483,6 +569,189 @@ txt_token_array_from_lang_kind_string(Arena *arena, TXT_LangKind lang_kind, Stri
   return result;
 }
 
+internal U64
+txt_lex_resync_off_from_data_range(String8 data, Rng1U64 range)
+{
+  // NOTE: picks the first line in `range` which starts with a non-space byte,
+  // & which does not continue the previous line (e.g. `\` at the end of a
+  // macro line), as a point where lexing is likely to be able to start fresh.
+  U64 result = range.max;
+  for(U64 off = Max(range.min, 1); off < range.max; off += 1)
+  {
+    if(data.str[off-1] == '\n' && !char_is_space(data.str[off]))
+    {
+      U64 line_end_off = off-1;
+      if(line_end_off > 0 && data.str[line_end_off-1] == '\r')
+      {
+        line_end_off -= 1;
+      }
+      if(line_end_off == 0 || data.str[line_end_off-1] != '\\')
+      {
+        result = off;
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+internal U64
+txt_token_idx_from_array_off(TXT_TokenArray *tokens, U64 off)
+{
+  // NOTE: returns the index of the first token which ends after `off`
+  U64 min = 0;
+  U64 max = tokens->count;
+  for(;min < max;)
+  {
+    U64 mid = min + (max-min)/2;
+    if(tokens->v[mid].range.max <= off)
+    {
+      min = mid+1;
+    }
+    else
+    {
+      max = mid;
+    }
+  }
+  return min;
+}
+
+internal TXT_TokenArray
+txt_token_array_relex_until_match(Arena *arena, TXT_LangLexFunctionType *lex_function, String8 data, U64 relex_off, TXT_LexMatchTarget *targets, U64 targets_count, U64 *target_idx_out, U64 *target_token_idx_out)
+{
+  // NOTE: re-lexes `data` from `relex_off`, in growing windows, until a
+  // re-lexed token matches one in a target, after which the target's tokens
+  // are the same as those which a full lex would produce. returns the tokens
+  // before the match, or all tokens to the end of `data` if there is none.
+  ProfBeginFunction();
+  TXT_TokenArray result = {0};
+  U64 target_idx = targets_count;
+  U64 target_token_idx = 0;
+  for(U64 window_size = TXT_LEX_RESYNC_WINDOW_SIZE;; window_size *= 2)
+  {
+    Temp temp = temp_begin(arena);
+    Rng1U64 window = r1u64(relex_off, Min(data.size, relex_off + window_size));
+    B32 window_is_last = (window.max >= data.size);
+    TXT_TokenArray relexed = lex_function(arena, 0, str8_substr(data, window));
+    B32 matched = 0;
+    for EachIndex(relexed_idx, relexed.count)
+    {
+      // skip tokens which the end of the window may have cut short
+      TXT_Token *token = &relexed.v[relexed_idx];
+      token->range.min += window.min;
+      token->range.max += window.min;
+      if(!window_is_last && token->range.max+1 >= window.max)
+      {
+        break;
+      }
+      
+      // find target which covers this token
+      U64 candidate_target_idx = 0;
+      for(;candidate_target_idx < targets_count && targets[candidate_target_idx].range.max <= token->range.min; candidate_target_idx += 1){}
+      if(candidate_target_idx >= targets_count || token->range.min < targets[candidate_target_idx].range.min)
+      {
+        continue;
+      }
+      
+      // match with target's token at the same spot
+      TXT_LexMatchTarget *target = &targets[candidate_target_idx];
+      U64 target_off = token->range.min - target->off_delta;
+      U64 candidate_token_idx = txt_token_idx_from_array_off(&target->tokens, target_off);
+      if(candidate_token_idx < target->tokens.count &&
+         target->tokens.v[candidate_token_idx].kind == token->kind &&
+         target->tokens.v[candidate_token_idx].range.min == target_off &&
+         target->tokens.v[candidate_token_idx].range.max + target->off_delta == token->range.max &&
+         (target->range.max >= data.size || token->range.max+1 < target->range.max))
+      {
+        result.v = relexed.v;
+        result.count = relexed_idx;
+        target_idx = candidate_target_idx;
+        target_token_idx = candidate_token_idx;
+        matched = 1;
+        break;
+      }
+    }
+    if(matched)
+    {
+      break;
+    }
+    if(window_is_last)
+    {
+      result = relexed;
+      break;
+    }
+    temp_end(temp);
+  }
+  if(target_idx_out)
+  {
+    *target_idx_out = target_idx;
+  }
+  if(target_token_idx_out)
+  {
+    *target_token_idx_out = target_token_idx;
+  }
+  ProfEnd();
+  return result;
+}
+
+internal TXT_TokenArray
+txt_token_array_from_lex_chunks(Arena *arena, TXT_LangLexFunctionType *lex_function, String8 data, Rng1U64 *chunk_ranges, TXT_TokenArray *chunk_tokens, U64 chunk_count)
+{
+  ProfBeginFunction();
+  Temp scratch = scratch_begin(&arena, 1);
+  
+  //- gather runs of final tokens, from chunks & from re-lexed boundaries
+  TXT_TokenChunkList final_tokens = {0};
+  for(U64 chunk_idx = 0, token_idx = 0;;)
+  {
+    TXT_TokenArray *tokens = &chunk_tokens[chunk_idx];
+    Rng1U64 chunk_range = chunk_ranges[chunk_idx];
+    
+    //- last chunk -> all remaining tokens are final
+    if(chunk_range.max >= data.size)
+    {
+      txt_token_chunk_list_push_array(scratch.arena, &final_tokens, tokens->v+token_idx, tokens->count-token_idx);
+      break;
+    }
+    
+    //- take tokens which end well before the chunk boundary; later tokens
+    // may have been cut short, or lexed without the following bytes
+    U64 safe_token_idx = txt_token_idx_from_array_off(tokens, chunk_range.max - Min(chunk_range.max, 2));
+    safe_token_idx = Max(safe_token_idx, token_idx);
+    txt_token_chunk_list_push_array(scratch.arena, &final_tokens, tokens->v+token_idx, safe_token_idx-token_idx);
+    
+    //- re-lex across the boundary, until a token matches one which a later
+    // chunk produced
+    U64 targets_count = chunk_count - (chunk_idx+1);
+    TXT_LexMatchTarget *targets = push_array(scratch.arena, TXT_LexMatchTarget, targets_count);
+    for EachIndex(idx, targets_count)
+    {
+      targets[idx].tokens = chunk_tokens[chunk_idx+1+idx];
+      targets[idx].range = chunk_ranges[chunk_idx+1+idx];
+    }
+    U64 relex_off = (safe_token_idx < tokens->count ? tokens->v[safe_token_idx].range.min : chunk_range.max);
+    U64 target_idx = 0;
+    U64 target_token_idx = 0;
+    TXT_TokenArray relexed = txt_token_array_relex_until_match(scratch.arena, lex_function, data, relex_off, targets, targets_count, &target_idx, &target_token_idx);
+    txt_token_chunk_list_push_array(scratch.arena, &final_tokens, relexed.v, relexed.count);
+    
+    //- re-lexed to the end -> done
+    if(target_idx >= targets_count)
+    {
+      break;
+    }
+    chunk_idx += 1+target_idx;
+    token_idx = target_token_idx;
+  }
+  
+  //- runs -> token array
+  TXT_TokenArray result = txt_token_array_from_chunk_list(arena, &final_tokens);
+  
+  scratch_end(scratch);
+  ProfEnd();
+  return result;
+}
+
 internal TXT_TokenArray
 txt_token_array_from_string__c_cpp(Arena *arena, U64 *bytes_processed_counter, String8 string)
 {
@@ -2665,6 +2934,537 @@ txt_scope_node_from_info_pt(TXT_TextInfo *info, TxtPt pt)
   return result;
 }
 
+////////////////////////////////
+//~ Text Info Building
+
+internal S32
+txt_scope_delta_from_data_token(String8 data, TXT_Token *token)
+{
+  S32 result = 0;
+  if(token->kind == TXT_TokenKind_Symbol && token->range.max > token->range.min)
+  {
+    U8 first = data.str[token->range.min];
+    if(first == '{' || first == '(' || first == '[')
+    {
+      result = +1;
+    }
+    else if(first == '}' || first == ')' || first == ']')
+    {
+      result = -1;
+    }
+  }
+  return result;
+}
+
+internal void
+txt_scope_tree_fill(String8 data, TXT_TokenArray *tokens, Rng1U64 token_range, TXT_ScopeNode *nodes, U64 scope_idx, TXT_ScopePt *pts, U64 pt_idx, U64 enclosing_num, B32 *cancel_signal)
+{
+  typedef struct ScopeTask ScopeTask;
+  struct ScopeTask
+  {
+    ScopeTask *next;
+    U64 scope_idx;
+  };
+  Temp scratch = scratch_begin(0, 0);
+  ScopeTask *top_scope_task = 0;
+  ScopeTask *free_scope_task = 0;
+  
+  // seed the stack with the scope which encloses the token range
+  if(enclosing_num != 0)
+  {
+    top_scope_task = push_array(scratch.arena, ScopeTask, 1);
+    top_scope_task->scope_idx = enclosing_num-1;
+  }
+  
+  for EachInRange(token_idx, token_range)
+  {
+    if(token_idx%1000 == 0 && ins_atomic_u32_eval(cancel_signal))
+    {
+      break;
+    }
+    if(tokens->v[token_idx].kind == TXT_TokenKind_Symbol)
+    {
+      String8 token_string = str8_substr(data, tokens->v[token_idx].range);
+      B32 is_opener = (token_string.str[0] == '{' ||
+                       token_string.str[0] == '(' ||
+                       token_string.str[0] == '[');
+      B32 is_closer = (token_string.str[0] == '}' ||
+                       token_string.str[0] == ')' ||
+                       token_string.str[0] == ']');
+      
+      // rjf: opener symbols -> push scope
+      if(is_opener)
+      {
+        // rjf: insert into scope tree
+        TXT_ScopeNode *new_scope = &nodes[scope_idx];
+        new_scope->token_idx_range.min = token_idx;
+        if(top_scope_task)
+        {
+          U64 new_scope_num = scope_idx+1;
+          TXT_ScopeNode *parent = &nodes[top_scope_task->scope_idx];
+          if(parent->first_num == 0)
+          {
+            parent->first_num = new_scope_num;
+          }
+          if(parent->last_num != 0)
+          {
+            TXT_ScopeNode *prev_scope = &nodes[parent->last_num-1];
+            prev_scope->next_num = new_scope_num;
+          }
+          parent->last_num = new_scope_num;
+          new_scope->parent_num = top_scope_task->scope_idx+1;
+        }
+        
+        // rjf: push onto scope stack
+        ScopeTask *scope_task = free_scope_task;
+        if(scope_task)
+        {
+          SLLStackPop(free_scope_task);
+        }
+        else
+        {
+          scope_task = push_array(scratch.arena, ScopeTask, 1);
+        }
+        scope_task->scope_idx = scope_idx;
+        scope_idx += 1;
+        SLLStackPush(top_scope_task, scope_task);
+      }
+      
+      // rjf: opener or closer -> fill endpoint
+      if(top_scope_task && (is_opener || is_closer))
+      {
+        pts[pt_idx].token_idx = token_idx;
+        pts[pt_idx].scope_idx = top_scope_task->scope_idx;
+        pt_idx += 1;
+      }
+      
+      // rjf: closer symbols -> pop
+      if(is_closer && top_scope_task != 0)
+      {
+        ScopeTask *popped = top_scope_task;
+        nodes[popped->scope_idx].token_idx_range.max = token_idx;
+        SLLStackPop(top_scope_task);
+        SLLStackPush(free_scope_task, popped);
+      }
+    }
+  }
+  scratch_end(scratch);
+}
+
+internal U64
+txt_line_idx_from_info_off(TXT_TextInfo *info, U64 off)
+{
+  // NOTE: returns the index of the last line which starts at or before `off`
+  U64 min = 0;
+  U64 max = info->lines_count;
+  for(;min < max;)
+  {
+    U64 mid = min + (max-min)/2;
+    if(info->lines_ranges[mid].min <= off)
+    {
+      min = mid+1;
+    }
+    else
+    {
+      max = mid;
+    }
+  }
+  U64 result = (min > 0 ? min-1 : 0);
+  return result;
+}
+
+internal U64
+txt_scope_node_idx_from_array_token_idx(TXT_ScopeNodeArray *nodes, U64 token_idx)
+{
+  // NOTE: returns the index of the first scope which opens at or after
+  // `token_idx` - scopes are stored in the order of their openers
+  U64 min = 0;
+  U64 max = nodes->count;
+  for(;min < max;)
+  {
+    U64 mid = min + (max-min)/2;
+    if(nodes->v[mid].token_idx_range.min < token_idx)
+    {
+      min = mid+1;
+    }
+    else
+    {
+      max = mid;
+    }
+  }
+  return min;
+}
+
+internal U64
+txt_scope_pt_idx_from_array_token_idx(TXT_ScopePtArray *pts, U64 token_idx)
+{
+  // NOTE: returns the index of the first scope point at or after `token_idx`
+  U64 min = 0;
+  U64 max = pts->count;
+  for(;min < max;)
+  {
+    U64 mid = min + (max-min)/2;
+    if(pts->v[mid].token_idx < token_idx)
+    {
+      min = mid+1;
+    }
+    else
+    {
+      max = mid;
+    }
+  }
+  return min;
+}
+
+internal TXT_TextEdit
+txt_text_edit_from_base_data(String8 base_data, String8 data)
+{
+  TXT_TextEdit edit = {0};
+  U64 max_size = Min(base_data.size, data.size);
+  
+  //- find common prefix
+  for(;edit.prefix_size + TXT_EDIT_SCAN_BLOCK_SIZE <= max_size &&
+      MemoryMatch(base_data.str + edit.prefix_size, data.str + edit.prefix_size, TXT_EDIT_SCAN_BLOCK_SIZE);
+      edit.prefix_size += TXT_EDIT_SCAN_BLOCK_SIZE){}
+  for(;edit.prefix_size < max_size && base_data.str[edit.prefix_size] == data.str[edit.prefix_size]; edit.prefix_size += 1){}
+  
+  //- find common suffix, which doesn't overlap the prefix
+  U64 suffix_max_size = max_size - edit.prefix_size;
+  for(;edit.suffix_size + TXT_EDIT_SCAN_BLOCK_SIZE <= suffix_max_size &&
+      MemoryMatch(base_data.str + base_data.size - edit.suffix_size - TXT_EDIT_SCAN_BLOCK_SIZE,
+                  data.str + data.size - edit.suffix_size - TXT_EDIT_SCAN_BLOCK_SIZE,
+                  TXT_EDIT_SCAN_BLOCK_SIZE);
+      edit.suffix_size += TXT_EDIT_SCAN_BLOCK_SIZE){}
+  for(;edit.suffix_size < suffix_max_size && base_data.str[base_data.size - edit.suffix_size - 1] == data.str[data.size - edit.suffix_size - 1]; edit.suffix_size += 1){}
+  
+  return edit;
+}
+
+typedef struct TXT_TextInfoUpdateShared TXT_TextInfoUpdateShared;
+struct TXT_TextInfoUpdateShared
+{
+  U64 base_end;
+  U64 end;
+  U64 off_delta;
+  U64 *lane_lines_max_sizes;
+  
+  // lines
+  U64 line_lo;
+  U64 base_line_hi;
+  U64 region_lines_count;
+  U64 region_lines_max_size;
+  
+  // tokens
+  U64 token_lo;
+  U64 base_token_hi;
+  TXT_TokenArray relexed;
+  
+  // scopes
+  B32 scopes_spliced;
+  U64 window_nodes_count;
+  U64 window_pts_count;
+  U64 node_lo;
+  U64 base_node_hi;
+  U64 pt_lo;
+  U64 base_pt_hi;
+  U64 token_idx_delta;
+  U64 node_idx_delta;
+  U64 enclosing_num;
+};
+
+internal B32
+txt_text_info_from_base_edit(Arena *arena, String8 data, TXT_LangLexFunctionType *lex_function, String8 base_data, TXT_TextInfo *base_info, TXT_TextEdit edit, TXT_TextInfo *info)
+{
+  // NOTE: called by all lanes, with the same arguments. fills the lines &
+  // tokens of `info` from those of `base_info`, re-splitting only the lines
+  // which the edit touches, & re-lexing only from the last token before the
+  // edit until the tokens line up with those of `base_info` again. scopes are
+  // spliced in too, if the edit opens & closes as many scopes as it replaces,
+  // in which case this returns 1 - otherwise, the caller must build scopes.
+  ProfBeginFunction();
+  Temp scratch = scratch_begin(&arena, 1);
+  TXT_TextInfoUpdateShared *shared = 0;
+  if(lane_idx() == 0)
+  {
+    shared = push_array(scratch.arena, TXT_TextInfoUpdateShared, 1);
+  }
+  lane_sync_u64(&shared, 0);
+  
+  //- plan line & token splices
+  if(lane_idx() == 0)
+  {
+    shared->base_end = base_data.size - edit.suffix_size;
+    shared->end = data.size - edit.suffix_size;
+    shared->off_delta = data.size - base_data.size;
+    shared->lane_lines_max_sizes = push_array(scratch.arena, U64, lane_count());
+    
+    // re-split all lines which overlap the edit, from the start of the line
+    // which contains its first byte, to the newline which follows it
+    shared->line_lo = txt_line_idx_from_info_off(base_info, edit.prefix_size);
+    shared->base_line_hi = txt_line_idx_from_info_off(base_info, shared->base_end)+1;
+    Rng1U64 region = r1u64(base_info->lines_ranges[shared->line_lo].min, data.size);
+    if(shared->base_line_hi < base_info->lines_count)
+    {
+      region.max = base_info->lines_ranges[shared->base_line_hi].min - 1 + shared->off_delta;
+    }
+    shared->region_lines_count = txt_newline_count_from_string(str8_substr(data, region)) + 1;
+    info->lines_count = shared->line_lo + shared->region_lines_count + (base_info->lines_count - shared->base_line_hi);
+    info->lines_ranges = push_array_no_zero(arena, Rng1U64, info->lines_count);
+    {
+      Rng1U64 *region_lines = info->lines_ranges + shared->line_lo;
+      region_lines[0].min = region.min;
+      region_lines[shared->region_lines_count-1].max = region.max;
+      txt_line_ranges_fill_from_data_range(data, region, info->lines_ranges, shared->line_lo + shared->region_lines_count, shared->line_lo);
+      for EachIndex(idx, shared->region_lines_count)
+      {
+        if(region_lines[idx].max > region_lines[idx].min && data.str[region_lines[idx].max-1] == '\r')
+        {
+          region_lines[idx].max -= 1;
+        }
+        shared->region_lines_max_size = Max(shared->region_lines_max_size, dim_1u64(region_lines[idx]));
+      }
+    }
+    
+    // re-lex from the end of the last token which can't have been changed by
+    // the edit, until the tokens match the base tokens past the edit
+    if(lex_function != 0)
+    {
+      TXT_TokenArray *base_tokens = &base_info->tokens;
+      shared->token_lo = txt_token_idx_from_array_off(base_tokens, edit.prefix_size - Min(edit.prefix_size, 2));
+      U64 relex_off = (shared->token_lo > 0 ? base_tokens->v[shared->token_lo-1].range.max : 0);
+      TXT_LexMatchTarget target = {*base_tokens, r1u64(shared->end, data.size), shared->off_delta};
+      U64 target_idx = 0;
+      U64 target_token_idx = 0;
+      shared->relexed = txt_token_array_relex_until_match(scratch.arena, lex_function, data, relex_off, &target, 1, &target_idx, &target_token_idx);
+      shared->base_token_hi = (target_idx == 0 ? target_token_idx : base_tokens->count);
+      info->tokens.count = shared->token_lo + shared->relexed.count + (base_tokens->count - shared->base_token_hi);
+      info->tokens.v = push_array_no_zero(arena, TXT_Token, info->tokens.count);
+      MemoryCopy(info->tokens.v + shared->token_lo, shared->relexed.v, sizeof(TXT_Token)*shared->relexed.count);
+    }
+  }
+  lane_sync();
+  
+  //- copy lines & tokens before & after the edit
+  {
+    U64 lane_lines_max_size = 0;
+    Rng1U64 prefix_range = lane_range(shared->line_lo);
+    for EachInRange(idx, prefix_range)
+    {
+      info->lines_ranges[idx] = base_info->lines_ranges[idx];
+      lane_lines_max_size = Max(lane_lines_max_size, dim_1u64(info->lines_ranges[idx]));
+    }
+    U64 suffix_dst_idx = shared->line_lo + shared->region_lines_count;
+    Rng1U64 suffix_range = lane_range(base_info->lines_count - shared->base_line_hi);
+    for EachInRange(idx, suffix_range)
+    {
+      Rng1U64 line_range = base_info->lines_ranges[shared->base_line_hi + idx];
+      line_range.min += shared->off_delta;
+      line_range.max += shared->off_delta;
+      info->lines_ranges[suffix_dst_idx + idx] = line_range;
+      lane_lines_max_size = Max(lane_lines_max_size, dim_1u64(line_range));
+    }
+    shared->lane_lines_max_sizes[lane_idx()] = lane_lines_max_size;
+  }
+  if(lex_function != 0)
+  {
+    Rng1U64 prefix_range = lane_range(shared->token_lo);
+    MemoryCopy(info->tokens.v + prefix_range.min, base_info->tokens.v + prefix_range.min, sizeof(TXT_Token)*dim_1u64(prefix_range));
+    U64 suffix_dst_idx = shared->token_lo + shared->relexed.count;
+    Rng1U64 suffix_range = lane_range(base_info->tokens.count - shared->base_token_hi);
+    for EachInRange(idx, suffix_range)
+    {
+      TXT_Token token = base_info->tokens.v[shared->base_token_hi + idx];
+      token.range.min += shared->off_delta;
+      token.range.max += shared->off_delta;
+      info->tokens.v[suffix_dst_idx + idx] = token;
+    }
+  }
+  lane_sync();
+  
+  //- measure lines; plan scope splice, if the old & new token windows both
+  // close every scope which they open, so that scopes outside of the windows
+  // keep their structure
+  if(lane_idx() == 0)
+  {
+    info->lines_max_size = shared->region_lines_max_size;
+    for EachIndex(idx, lane_count())
+    {
+      info->lines_max_size = Max(info->lines_max_size, shared->lane_lines_max_sizes[idx]);
+    }
+    Rng1U64 base_window = r1u64(shared->token_lo, shared->base_token_hi);
+    Rng1U64 window = r1u64(shared->token_lo, shared->token_lo + shared->relexed.count);
+    B32 base_window_is_balanced = 1;
+    B32 window_is_balanced = 1;
+    U64 base_window_nodes_count = 0;
+    U64 base_window_pts_count = 0;
+    {
+      S64 depth = 0;
+      for EachInRange(idx, base_window)
+      {
+        S32 delta = txt_scope_delta_from_data_token(base_data, &base_info->tokens.v[idx]);
+        depth += delta;
+        base_window_nodes_count += (delta > 0);
+        base_window_pts_count += (delta != 0);
+        if(depth < 0) { base_window_is_balanced = 0; break; }
+      }
+      base_window_is_balanced = (base_window_is_balanced && depth == 0);
+    }
+    {
+      S64 depth = 0;
+      for EachInRange(idx, window)
+      {
+        S32 delta = txt_scope_delta_from_data_token(data, &info->tokens.v[idx]);
+        depth += delta;
+        shared->window_nodes_count += (delta > 0);
+        shared->window_pts_count += (delta != 0);
+        if(depth < 0) { window_is_balanced = 0; break; }
+      }
+      window_is_balanced = (window_is_balanced && depth == 0);
+    }
+    if(base_window_is_balanced && window_is_balanced)
+    {
+      TXT_ScopeNodeArray *base_nodes = &base_info->scope_nodes;
+      TXT_ScopePtArray *base_pts = &base_info->scope_pts;
+      shared->scopes_spliced = 1;
+      shared->node_lo = txt_scope_node_idx_from_array_token_idx(base_nodes, base_window.min);
+      shared->base_node_hi = shared->node_lo + base_window_nodes_count;
+      shared->pt_lo = txt_scope_pt_idx_from_array_token_idx(base_pts, base_window.min);
+      shared->base_pt_hi = shared->pt_lo + base_window_pts_count;
+      shared->token_idx_delta = shared->relexed.count - dim_1u64(base_window);
+      shared->node_idx_delta = shared->window_nodes_count - base_window_nodes_count;
+      info->scope_nodes.count = base_nodes->count - base_window_nodes_count + shared->window_nodes_count;
+      info->scope_nodes.v = push_array_no_zero(arena, TXT_ScopeNode, info->scope_nodes.count);
+      MemoryZero(info->scope_nodes.v + shared->node_lo, sizeof(TXT_ScopeNode)*shared->window_nodes_count);
+      info->scope_pts.count = base_pts->count - base_window_pts_count + shared->window_pts_count;
+      info->scope_pts.v = push_array_no_zero(arena, TXT_ScopePt, info->scope_pts.count);
+      
+      // the scope which encloses the window: the scope of the last point
+      // before it, if that opens a scope - otherwise, that scope's parent
+      if(shared->pt_lo > 0)
+      {
+        TXT_ScopePt *pt = &base_pts->v[shared->pt_lo-1];
+        if(txt_scope_delta_from_data_token(base_data, &base_info->tokens.v[pt->token_idx]) > 0)
+        {
+          shared->enclosing_num = pt->scope_idx+1;
+        }
+        else
+        {
+          shared->enclosing_num = base_nodes->v[pt->scope_idx].parent_num;
+        }
+      }
+    }
+  }
+  lane_sync();
+  
+  //- copy scopes before & after the window, shifting token indices & scope
+  // numbers after it
+  if(shared->scopes_spliced)
+  {
+    TXT_ScopeNodeArray *base_nodes = &base_info->scope_nodes;
+    TXT_ScopePtArray *base_pts = &base_info->scope_pts;
+    U64 token_hi = shared->base_token_hi;
+    U64 num_hi = shared->base_node_hi;
+    U64 token_idx_delta = shared->token_idx_delta;
+    U64 node_idx_delta = shared->node_idx_delta;
+#define txt_shift_token_idx(idx) ((idx) >= token_hi ? (idx) + token_idx_delta : (idx))
+#define txt_shift_num(num) ((num) > num_hi ? (num) + node_idx_delta : (num))
+    Rng1U64 nodes_prefix_range = lane_range(shared->node_lo);
+    Rng1U64 nodes_suffix_range = lane_range(base_nodes->count - shared->base_node_hi);
+    for(U64 pass = 0; pass < 2; pass += 1)
+    {
+      Rng1U64 range = (pass == 0 ? nodes_prefix_range : nodes_suffix_range);
+      U64 src_off = (pass == 0 ? 0 : shared->base_node_hi);
+      U64 dst_off = (pass == 0 ? 0 : shared->node_lo + shared->window_nodes_count);
+      for EachInRange(idx, range)
+      {
+        TXT_ScopeNode *src = &base_nodes->v[src_off + idx];
+        TXT_ScopeNode *dst = &info->scope_nodes.v[dst_off + idx];
+        dst->first_num = txt_shift_num(src->first_num);
+        dst->last_num = txt_shift_num(src->last_num);
+        dst->next_num = txt_shift_num(src->next_num);
+        dst->parent_num = txt_shift_num(src->parent_num);
+        dst->token_idx_range.min = txt_shift_token_idx(src->token_idx_range.min);
+        dst->token_idx_range.max = txt_shift_token_idx(src->token_idx_range.max);
+      }
+    }
+    Rng1U64 pts_prefix_range = lane_range(shared->pt_lo);
+    Rng1U64 pts_suffix_range = lane_range(base_pts->count - shared->base_pt_hi);
+    for(U64 pass = 0; pass < 2; pass += 1)
+    {
+      Rng1U64 range = (pass == 0 ? pts_prefix_range : pts_suffix_range);
+      U64 src_off = (pass == 0 ? 0 : shared->base_pt_hi);
+      U64 dst_off = (pass == 0 ? 0 : shared->pt_lo + shared->window_pts_count);
+      for EachInRange(idx, range)
+      {
+        TXT_ScopePt *src = &base_pts->v[src_off + idx];
+        TXT_ScopePt *dst = &info->scope_pts.v[dst_off + idx];
+        dst->token_idx = txt_shift_token_idx(src->token_idx);
+        dst->scope_idx = txt_shift_num(src->scope_idx+1)-1;
+      }
+    }
+#undef txt_shift_num
+#undef txt_shift_token_idx
+  }
+  lane_sync();
+  
+  //- build scopes within the window, & link them in with their siblings
+  if(lane_idx() == 0 && shared->scopes_spliced)
+  {
+    TXT_ScopeNodeArray *base_nodes = &base_info->scope_nodes;
+    TXT_ScopeNode *nodes = info->scope_nodes.v;
+    U64 enclosing_num = shared->enclosing_num;
+    U64 prev_num = 0;
+    U64 next_num = 0;
+    if(enclosing_num != 0)
+    {
+      // find the enclosing scope's last child before the window, & first
+      // child after it
+      for(U64 num = shared->node_lo; num > enclosing_num; num -= 1)
+      {
+        if(base_nodes->v[num-1].parent_num == enclosing_num)
+        {
+          prev_num = num;
+          break;
+        }
+      }
+      if(shared->base_node_hi < base_nodes->count && base_nodes->v[shared->base_node_hi].parent_num == enclosing_num)
+      {
+        next_num = shared->base_node_hi+1 + shared->node_idx_delta;
+      }
+      TXT_ScopeNode *enclosing = &nodes[enclosing_num-1];
+      if(prev_num == 0)
+      {
+        enclosing->first_num = 0;
+      }
+      enclosing->last_num = prev_num;
+    }
+    txt_scope_tree_fill(data, &info->tokens, r1u64(shared->token_lo, shared->token_lo + shared->relexed.count), nodes, shared->node_lo, info->scope_pts.v, shared->pt_lo, enclosing_num, 0);
+    if(enclosing_num != 0)
+    {
+      TXT_ScopeNode *enclosing = &nodes[enclosing_num-1];
+      if(enclosing->last_num != 0)
+      {
+        nodes[enclosing->last_num-1].next_num = next_num;
+      }
+      if(enclosing->first_num == 0)
+      {
+        enclosing->first_num = next_num;
+      }
+      if(next_num != 0)
+      {
+        enclosing->last_num = base_nodes->v[enclosing_num-1].last_num + shared->node_idx_delta;
+      }
+    }
+  }
+  lane_sync();
+  
+  B32 result = shared->scopes_spliced;
+  lane_sync();
+  scratch_end(scratch);
+  ProfEnd();
+  return result;
+}
+
 ////////////////////////////////
 //~ rjf: Artifact Cache Hooks / Lookups
 
@@ -2682,10 +3482,19 @@ struct TXT_ArtifactCreateShared
   Arena *arena;
   TXT_TextInfo info;
   TXT_Artifact *artifact;
+  U64 *lane_newline_counts;
+  U64 *lane_lines_max_sizes;
+  Rng1U64 *lex_chunk_ranges;
+  TXT_TokenArray *lex_chunk_tokens;
+  B32 has_base;
+  B32 scopes_spliced;
+  String8 base_data;
+  TXT_TextInfo base_info;
+  TXT_TextEdit edit;
 };
 
 internal AC_Artifact
-txt_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out)
+txt_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out)
 {
   ProfBeginFunction();
   Temp scratch = scratch_begin(0, 0);
@@ -2745,209 +3554,218 @@ txt_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_ou
         line_end_kind = TXT_LineEndKind_LF;
       }
       shared->info.line_end_kind = line_end_kind;
+      shared->lane_newline_counts   = push_array(scratch.arena, U64, lane_count());
+      shared->lane_lines_max_sizes  = push_array(scratch.arena, U64, lane_count());
+      shared->lex_chunk_ranges      = push_array(scratch.arena, Rng1U64, lane_count());
+      shared->lex_chunk_tokens      = push_array(scratch.arena, TXT_TokenArray, lane_count());
+    }
+    
+    //- find the text info of this data's prior version, if it's still cached;
+    // if the edit between the two is small, only the edited lines & tokens
+    // are re-split & re-lexed
+    if(lane_idx() == 0)
+    {
+      U128 base_hash = c_prev_hash_from_hash(hash);
+      if(!u128_match(base_hash, u128_zero()))
+      {
+#pragma pack(push, 1)
+        struct
+        {
+          U128 hash;
+          TXT_LangKind lang;
+        } base_key = {base_hash, lang};
+#pragma pack(pop)
+        AC_Artifact base_artifact = ac_artifact_from_key(access, str8_struct(&base_key), txt_artifact_create, txt_artifact_destroy, 0, .flags = AC_Flag_Wide|AC_Flag_NoRequest);
+        TXT_Artifact *base_txt_artifact = (TXT_Artifact *)base_artifact.u64[0];
+        String8 base_data = c_data_from_hash(access, base_hash);
+        if(base_txt_artifact != 0 && base_data.size != 0 && base_txt_artifact->info.lines_count != 0)
+        {
+          TXT_TextEdit edit = txt_text_edit_from_base_data(base_data, data);
+          U64 edit_size = (data.size - edit.prefix_size - edit.suffix_size) + (base_data.size - edit.prefix_size - edit.suffix_size);
+          if(edit_size <= data.size/4)
+          {
+            shared->has_base  = 1;
+            shared->base_data = base_data;
+            shared->base_info = base_txt_artifact->info;
+            shared->edit      = edit;
+          }
+        }
+      }
     }
     lane_sync();
     set_progress(Min(data.size, 1024));
     
-    //- rjf: count # of lines
-    U64 lane_line_count = 0;
-    if(lane_idx() == 0)
+    //- incrementally update prior text info
+    if(shared->has_base)
     {
-      lane_line_count = 1;
+      shared->scopes_spliced = txt_text_info_from_base_edit(shared->arena, data, lex_function, shared->base_data, &shared->base_info, shared->edit, &shared->info);
     }
+    
+    //- build lines & tokens from scratch
+    else
     {
-      Rng1U64 range = lane_range(data.size);
-      for EachInRange(idx, range)
+      //- count # of newlines in each lane's range
+      Rng1U64 lane_data_range = lane_range(data.size);
       {
-        if(idx%1000 == 0 && ins_atomic_u32_eval(cancel_signal))
-        {
-          break;
-        }
-        if(data.str[idx] == '\n')
+        U64 lane_newline_count = 0;
+        for(U64 off = lane_data_range.min; off < lane_data_range.max; off += TXT_LINE_SCAN_STEP_SIZE)
         {
-          lane_line_count += 1;
+          if(ins_atomic_u32_eval(cancel_signal))
+          {
+            break;
+          }
+          Rng1U64 step_range = r1u64(off, Min(off + TXT_LINE_SCAN_STEP_SIZE, lane_data_range.max));
+          lane_newline_count += txt_newline_count_from_string(str8_substr(data, step_range));
+          add_progress(dim_1u64(step_range));
         }
-        if(idx && idx%1000 == 0)
+        shared->lane_newline_counts[lane_idx()] = lane_newline_count;
+      }
+      lane_sync();
+      set_progress(Min(data.size, 1024) + data.size);
+      
+      //- allocate line ranges
+      if(lane_idx() == 0)
+      {
+        shared->info.lines_count = 1;
+        for EachIndex(idx, lane_count())
         {
-          add_progress(1000);
+          shared->info.lines_count += shared->lane_newline_counts[idx];
         }
+        shared->info.lines_ranges = push_array(shared->arena, Rng1U64, shared->info.lines_count);
+        shared->info.lines_ranges[0].min = 0;
+        shared->info.lines_ranges[shared->info.lines_count-1].max = data.size;
       }
-    }
-    ins_atomic_u64_add_eval(&shared->info.lines_count, lane_line_count);
-    lane_sync();
-    set_progress(Min(data.size, 1024) + data.size);
-    
-    //- rjf: allocate & store line ranges
-    if(lane_idx() == 0)
-    {
-      shared->info.lines_ranges = push_array_no_zero(shared->arena, Rng1U64, shared->info.lines_count);
-      U64 line_idx = 0;
-      U64 line_start_idx = 0;
-      for(U64 idx = 0; idx <= data.size; idx += 1)
+      lane_sync();
+      
+      //- store line ranges, starting each lane at the line which follows the
+      // newlines of all prior lanes
       {
-        if(idx%1000 == 0 && ins_atomic_u32_eval(cancel_signal))
+        U64 line_idx = 0;
+        for EachIndex(idx, lane_idx())
         {
-          break;
+          line_idx += shared->lane_newline_counts[idx];
         }
-        if(idx == data.size || data.str[idx] == '\n')
+        for(U64 off = lane_data_range.min; off < lane_data_range.max; off += TXT_LINE_SCAN_STEP_SIZE)
         {
-          Rng1U64 line_range = r1u64(line_start_idx, idx);
-          if(idx > 0 && data.str[idx-1] == '\r' && line_range.max > line_range.min)
+          if(ins_atomic_u32_eval(cancel_signal))
           {
-            line_range.max -= 1;
+            break;
           }
-          U64 line_size = dim_1u64(line_range);
-          shared->info.lines_ranges[line_idx] = line_range;
-          shared->info.lines_max_size = Max(shared->info.lines_max_size, line_size);
-          line_idx += 1;
-          line_start_idx = idx+1;
+          Rng1U64 step_range = r1u64(off, Min(off + TXT_LINE_SCAN_STEP_SIZE, lane_data_range.max));
+          line_idx = txt_line_ranges_fill_from_data_range(data, step_range, shared->info.lines_ranges, shared->info.lines_count, line_idx);
+          add_progress(dim_1u64(step_range));
         }
-        if(idx && idx%1000 == 0)
+      }
+      lane_sync();
+      
+      //- measure lines, excluding CRs
+      {
+        U64 lane_lines_max_size = 0;
+        Rng1U64 range = lane_range(shared->info.lines_count);
+        for EachInRange(idx, range)
         {
-          add_progress(1000);
+          Rng1U64 *line_range = &shared->info.lines_ranges[idx];
+          if(line_range->max > line_range->min && data.str[line_range->max-1] == '\r')
+          {
+            line_range->max -= 1;
+          }
+          lane_lines_max_size = Max(lane_lines_max_size, dim_1u64(*line_range));
         }
+        shared->lane_lines_max_sizes[lane_idx()] = lane_lines_max_size;
       }
-    }
-    lane_sync();
-    set_progress(Min(data.size, 1024) + data.size + data.size);
-    
-    //- rjf: lex function * data -> tokens
-#if 1
-    if(lane_idx() == 0 && lex_function != 0)
-    {
-      shared->info.tokens = lex_function(shared->arena, 0, data);
-    }
-#else
-    if(lane_idx() == 0)
-    {
-      shared->info.tokens = txt_token_array_from_lang_kind_string(shared->arena, lang, data);
-    }
-#endif
-    lane_sync();
-    set_progress(Min(data.size, 1024) + data.size + data.size + data.size*(lex_function != 0));
-    TXT_TokenArray tokens = shared->info.tokens;
-    
-    //- rjf: count scope points
-    {
-      U64 lane_scope_pt_opener_count = 0;
-      U64 lane_scope_pt_count = 0;
-      Rng1U64 range = lane_range(tokens.count);
-      for EachInRange(idx, range)
+      lane_sync();
+      if(lane_idx() == 0)
+      {
+        for EachIndex(idx, lane_count())
+        {
+          shared->info.lines_max_size = Max(shared->info.lines_max_size, shared->lane_lines_max_sizes[idx]);
+        }
+      }
+      set_progress(Min(data.size, 1024) + data.size + data.size);
+      
+      //- lex function * data -> tokens; big files are lexed in one chunk per
+      // lane, each starting at a line which is likely to start a fresh token,
+      // & then stitched together by re-lexing across chunk boundaries
+      if(lex_function != 0)
       {
-        if(tokens.v[idx].kind == TXT_TokenKind_Symbol)
+        U64 chunk_count = (data.size >= TXT_LEX_CHUNK_MIN_SIZE*lane_count() ? lane_count() : 1);
+        if(lane_idx() < chunk_count)
         {
-          String8 token_string = str8_substr(data, tokens.v[idx].range);
-          B32 is_opener = (token_string.str[0] == '{' ||
-                           token_string.str[0] == '(' ||
-                           token_string.str[0] == '[');
-          B32 is_closer = (token_string.str[0] == '}' ||
-                           token_string.str[0] == ')' ||
-                           token_string.str[0] == ']');
-          if(token_string.size == 1 && (is_opener || is_closer))
+          Rng1U64 nominal_range = m_range_from_n_idx_m_count(lane_idx(), chunk_count, data.size);
+          shared->lex_chunk_ranges[lane_idx()].min = (lane_idx() == 0 ? 0 : txt_lex_resync_off_from_data_range(data, nominal_range));
+        }
+        lane_sync();
+        if(chunk_count == 1 && lane_idx() == 0)
+        {
+          shared->info.tokens = lex_function(shared->arena, 0, data);
+        }
+        else if(lane_idx() < chunk_count)
+        {
+          Rng1U64 *chunk_range = &shared->lex_chunk_ranges[lane_idx()];
+          chunk_range->max = (lane_idx()+1 < chunk_count ? shared->lex_chunk_ranges[lane_idx()+1].min : data.size);
+          TXT_TokenArray chunk_tokens = {0};
+          if(chunk_range->max > chunk_range->min)
           {
-            lane_scope_pt_count += 1;
-            lane_scope_pt_opener_count += !!is_opener;
+            chunk_tokens = lex_function(scratch.arena, 0, str8_substr(data, *chunk_range));
           }
+          for EachIndex(idx, chunk_tokens.count)
+          {
+            chunk_tokens.v[idx].range.min += chunk_range->min;
+            chunk_tokens.v[idx].range.max += chunk_range->min;
+          }
+          shared->lex_chunk_tokens[lane_idx()] = chunk_tokens;
+        }
+        lane_sync();
+        if(chunk_count > 1 && lane_idx() == 0)
+        {
+          shared->info.tokens = txt_token_array_from_lex_chunks(shared->arena, lex_function, data, shared->lex_chunk_ranges, shared->lex_chunk_tokens, chunk_count);
         }
       }
-      ins_atomic_u64_add_eval(&shared->info.scope_pts.count, lane_scope_pt_count);
-      ins_atomic_u64_add_eval(&shared->info.scope_nodes.count, lane_scope_pt_opener_count);
+      lane_sync();
     }
-    lane_sync();
+    set_progress(Min(data.size, 1024) + data.size + data.size + data.size*(lex_function != 0));
+    TXT_TokenArray tokens = shared->info.tokens;
     
-    //- rjf: allocate & fill scope data
-    if(lane_idx() == 0)
+    //- rjf: build scopes, unless they were spliced into the prior text info's
+    if(!shared->scopes_spliced)
     {
-      shared->info.scope_pts.v = push_array_no_zero(shared->arena, TXT_ScopePt, shared->info.scope_pts.count);
-      shared->info.scope_nodes.v = push_array_no_zero(shared->arena, TXT_ScopeNode, shared->info.scope_nodes.count);
+      //- rjf: count scope points
       {
-        typedef struct ScopeTask ScopeTask;
-        struct ScopeTask
-        {
-          ScopeTask *next;
-          U64 scope_idx;
-        };
-        Temp scratch = scratch_begin(0, 0);
-        ScopeTask *top_scope_task = 0;
-        ScopeTask *free_scope_task = 0;
-        U64 pt_idx = 0;
-        U64 scope_idx = 0;
-        for EachIndex(token_idx, tokens.count)
+        U64 lane_scope_pt_opener_count = 0;
+        U64 lane_scope_pt_count = 0;
+        Rng1U64 range = lane_range(tokens.count);
+        for EachInRange(idx, range)
         {
-          if(token_idx%1000 == 0 && ins_atomic_u32_eval(cancel_signal))
+          if(tokens.v[idx].kind == TXT_TokenKind_Symbol)
           {
-            break;
-          }
-          if(tokens.v[token_idx].kind == TXT_TokenKind_Symbol)
-          {
-            String8 token_string = str8_substr(data, tokens.v[token_idx].range);
+            String8 token_string = str8_substr(data, tokens.v[idx].range);
             B32 is_opener = (token_string.str[0] == '{' ||
                              token_string.str[0] == '(' ||
                              token_string.str[0] == '[');
             B32 is_closer = (token_string.str[0] == '}' ||
                              token_string.str[0] == ')' ||
                              token_string.str[0] == ']');
-            
-            // rjf: opener symbols -> push scope
-            if(is_opener)
-            {
-              // rjf: insert into scope tree
-              TXT_ScopeNode *new_scope = &shared->info.scope_nodes.v[scope_idx];
-              new_scope->token_idx_range.min = token_idx;
-              if(top_scope_task)
-              {
-                U64 new_scope_num = scope_idx+1;
-                TXT_ScopeNode *parent = &shared->info.scope_nodes.v[top_scope_task->scope_idx];
-                if(parent->first_num == 0)
-                {
-                  parent->first_num = new_scope_num;
-                }
-                if(parent->last_num != 0)
-                {
-                  TXT_ScopeNode *prev_scope = &shared->info.scope_nodes.v[parent->last_num-1];
-                  prev_scope->next_num = new_scope_num;
-                }
-                parent->last_num = new_scope_num;
-                new_scope->parent_num = top_scope_task->scope_idx+1;
-              }
-              
-              // rjf: push onto scope stack
-              ScopeTask *scope_task = free_scope_task;
-              if(scope_task)
-              {
-                SLLStackPop(free_scope_task);
-              }
-              else
-              {
-                scope_task = push_array(scratch.arena, ScopeTask, 1);
-              }
-              scope_task->scope_idx = scope_idx;
-              scope_idx += 1;
-              SLLStackPush(top_scope_task, scope_task);
-            }
-            
-            // rjf: opener or closer -> fill endpoint
-            if(top_scope_task && (is_opener || is_closer))
+            if(token_string.size == 1 && (is_opener || is_closer))
             {
-              shared->info.scope_pts.v[pt_idx].token_idx = token_idx;
-              shared->info.scope_pts.v[pt_idx].scope_idx = top_scope_task->scope_idx;
-              pt_idx += 1;
-            }
-            
-            // rjf: closer symbols -> pop
-            if(is_closer && top_scope_task != 0)
-            {
-              ScopeTask *popped = top_scope_task;
-              shared->info.scope_nodes.v[popped->scope_idx].token_idx_range.max = token_idx;
-              SLLStackPop(top_scope_task);
-              SLLStackPush(free_scope_task, popped);
+              lane_scope_pt_count += 1;
+              lane_scope_pt_opener_count += !!is_opener;
             }
           }
         }
-        scratch_end(scratch);
+        ins_atomic_u64_add_eval(&shared->info.scope_pts.count, lane_scope_pt_count);
+        ins_atomic_u64_add_eval(&shared->info.scope_nodes.count, lane_scope_pt_opener_count);
+      }
+      lane_sync();
+      
+      //- rjf: allocate & fill scope data
+      if(lane_idx() == 0)
+      {
+        shared->info.scope_pts.v = push_array_no_zero(shared->arena, TXT_ScopePt, shared->info.scope_pts.count);
+        shared->info.scope_nodes.v = push_array(shared->arena, TXT_ScopeNode, shared->info.scope_nodes.count);
+        txt_scope_tree_fill(data, &tokens, r1u64(0, tokens.count), shared->info.scope_nodes.v, 0, shared->info.scope_pts.v, 0, 0, cancel_signal);
       }
+      lane_sync();
     }
-    lane_sync();
   }
   
   //- rjf: cancel -> release
@@ -2970,6 +3788,7 @@ txt_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_ou
     shared->artifact->arena     = shared->arena;
     shared->artifact->data_hash = hash;
     shared->artifact->info      = shared->info;
+    size_out[0] = arena_pos(shared->arena);
   }
   lane_sync();
   AC_Artifact result = {0};
@@ -4,6 +4,25 @@
 #ifndef TEXT_H
 #define TEXT_H
 
+////////////////////////////////
+//~ Parallel Scanning Parameters
+//
+// Lines are split by all lanes at once, 16 bytes at a time. Files which are
+// large enough are lexed in one chunk per lane, where each chunk starts at a
+// line which is likely to also start a token; tokens near chunk boundaries are
+// re-lexed, in windows which grow until they line up with a later chunk.
+//
+// When a file changes, & the text info of its prior contents is still cached,
+// only the lines & tokens which the edit touches are re-split & re-lexed, & the
+// rest are copied from the prior text info. Edits are found by comparing 256
+// byte blocks from each end of the two versions.
+
+#define TXT_LINE_SCAN_BLOCK_SIZE   16
+#define TXT_LINE_SCAN_STEP_SIZE    KB(64)
+#define TXT_LEX_CHUNK_MIN_SIZE     KB(64)
+#define TXT_LEX_RESYNC_WINDOW_SIZE KB(4)
+#define TXT_EDIT_SCAN_BLOCK_SIZE   256
+
 ////////////////////////////////
 //~ rjf: Value Types
 
@@ -157,6 +176,15 @@ struct TXT_TextInfo
   U64 bytes_to_process;
 };
 
+// NOTE: the sizes of the leading & trailing bytes which two versions of some
+// text have in common; everything between them was edited
+typedef struct TXT_TextEdit TXT_TextEdit;
+struct TXT_TextEdit
+{
+  U64 prefix_size;
+  U64 suffix_size;
+};
+
 typedef struct TXT_LineTokensSlice TXT_LineTokensSlice;
 struct TXT_LineTokensSlice
 {
@@ -173,6 +201,19 @@ struct TXT_LineTokensSlice
 
 typedef TXT_TokenArray TXT_LangLexFunctionType(Arena *arena, U64 *bytes_processed_counter, String8 string);
 
+////////////////////////////////
+//~ Re-Lexing Types
+
+// NOTE: tokens which were lexed earlier, & which are still valid within
+// `range` of the current data, once `off_delta` is added to their offsets
+typedef struct TXT_LexMatchTarget TXT_LexMatchTarget;
+struct TXT_LexMatchTarget
+{
+  TXT_TokenArray tokens;
+  Rng1U64 range;
+  U64 off_delta;
+};
+
 ////////////////////////////////
 //~ rjf: Globals
 
@@ -186,10 +227,17 @@ internal String8 txt_extension_from_lang_kind(TXT_LangKind kind);
 internal TXT_LangKind txt_lang_kind_from_arch(Arch arch);
 internal TXT_LangLexFunctionType *txt_lex_function_from_lang_kind(TXT_LangKind kind);
 
+////////////////////////////////
+//~ Line Scanning Functions
+
+internal U64 txt_newline_count_from_string(String8 string);
+internal U64 txt_line_ranges_fill_from_data_range(String8 data, Rng1U64 range, Rng1U64 *lines_ranges, U64 lines_count, U64 line_idx);
+
 ////////////////////////////////
 //~ rjf: Token Type Functions
 
 internal void txt_token_chunk_list_push(Arena *arena, TXT_TokenChunkList *list, U64 cap, TXT_Token *token);
+internal void txt_token_chunk_list_push_array(Arena *arena, TXT_TokenChunkList *list, TXT_Token *v, U64 count);
 internal void txt_token_list_push(Arena *arena, TXT_TokenList *list, TXT_Token *token);
 internal TXT_TokenArray txt_token_array_from_chunk_list(Arena *arena, TXT_TokenChunkList *list);
 internal TXT_TokenArray txt_token_array_from_list(Arena *arena, TXT_TokenList *list);
@@ -198,6 +246,10 @@ internal TXT_TokenArray txt_token_array_from_list(Arena *arena, TXT_TokenList *l
 //~ rjf: Lexing Functions
 
 internal TXT_TokenArray txt_token_array_from_lang_kind_string(Arena *arena, TXT_LangKind lang_kind, String8 string);
+internal U64 txt_lex_resync_off_from_data_range(String8 data, Rng1U64 range);
+internal U64 txt_token_idx_from_array_off(TXT_TokenArray *tokens, U64 off);
+internal TXT_TokenArray txt_token_array_relex_until_match(Arena *arena, TXT_LangLexFunctionType *lex_function, String8 data, U64 relex_off, TXT_LexMatchTarget *targets, U64 targets_count, U64 *target_idx_out, U64 *target_token_idx_out);
+internal TXT_TokenArray txt_token_array_from_lex_chunks(Arena *arena, TXT_LangLexFunctionType *lex_function, String8 data, Rng1U64 *chunk_ranges, TXT_TokenArray *chunk_tokens, U64 chunk_count);
 
 internal TXT_TokenArray txt_token_array_from_string__c_cpp(Arena *arena, U64 *bytes_processed_counter, String8 string);
 internal TXT_TokenArray txt_token_array_from_string__odin(Arena *arena, U64 *bytes_processed_counter, String8 string);
@@ -221,10 +273,21 @@ internal TXT_ScopeNode *txt_scope_node_from_info_num(TXT_TextInfo *info, U64 num
 internal TXT_ScopeNode *txt_scope_node_from_info_off(TXT_TextInfo *info, U64 off);
 internal TXT_ScopeNode *txt_scope_node_from_info_pt(TXT_TextInfo *info, TxtPt pt);
 
+////////////////////////////////
+//~ Text Info Building Functions
+
+internal S32 txt_scope_delta_from_data_token(String8 data, TXT_Token *token);
+internal void txt_scope_tree_fill(String8 data, TXT_TokenArray *tokens, Rng1U64 token_range, TXT_ScopeNode *nodes, U64 scope_idx, TXT_ScopePt *pts, U64 pt_idx, U64 enclosing_num, B32 *cancel_signal);
+internal U64 txt_line_idx_from_info_off(TXT_TextInfo *info, U64 off);
+internal U64 txt_scope_node_idx_from_array_token_idx(TXT_ScopeNodeArray *nodes, U64 token_idx);
+internal U64 txt_scope_pt_idx_from_array_token_idx(TXT_ScopePtArray *pts, U64 token_idx);
+internal TXT_TextEdit txt_text_edit_from_base_data(String8 base_data, String8 data);
+internal B32 txt_text_info_from_base_edit(Arena *arena, String8 data, TXT_LangLexFunctionType *lex_function, String8 base_data, TXT_TextInfo *base_info, TXT_TextEdit edit, TXT_TextInfo *info);
+
 ////////////////////////////////
 //~ rjf: Artifact Cache Hooks / Lookups
 
-internal AC_Artifact txt_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out);
+internal AC_Artifact txt_artifact_create(String8 key, B32 *cancel_signal, B32 *retry_out, U64 *gen_out, U64 *size_out);
 internal void txt_artifact_destroy(AC_Artifact artifact);
 internal TXT_TextInfo txt_text_info_from_hash_lang(Access *access, U128 hash, TXT_LangKind lang);
 internal TXT_TextInfo txt_text_info_from_key_lang(Access *access, C_Key key, TXT_LangKind lang, U128 *hash_out);
@@ -1040,4 +1040,197 @@ TEST(reg_split_spill)
 }
 #endif
 
+////////////////////////////////
+// zstd-compressed sections
+//
+// frames were produced by the reference `zstd` tool (--no-check) from the
+// contents generated below: 64 pseudo-random bytes (one raw block), 300000
+// copies of 0xAB (a compressed block followed by two RLE blocks), and 2048
+// bytes of DWARF-like strings (one compressed block)
+
+read_only global U8 t_dw_zstd_raw_frame[] = {
+  0x28, 0xB5, 0x2F, 0xFD, 0x00, 0x68, 0x01, 0x02, 0x00, 0x6C, 0x82, 0xA5, 0x62, 0xCB, 0x80, 0x8D,
+  0x10, 0xD6, 0x32, 0xBE, 0x89, 0xC8, 0x51, 0x3E, 0xBF, 0x6C, 0x92, 0x9F, 0x34, 0xDD, 0xFA, 0x8C,
+  0x9F, 0x63, 0xC9, 0x96, 0x0E, 0xF6, 0xE3, 0x48, 0xA3, 0x52, 0x8C, 0x8A, 0x3F, 0xCC, 0x2F, 0x04,
+  0x4E, 0x39, 0xA3, 0xFC, 0x5B, 0x94, 0x49, 0x2F, 0x8F, 0x03, 0x2E, 0x75, 0x49, 0xA2, 0x00, 0x98,
+  0xF9, 0x5B, 0xEF, 0xD6, 0x12, 0x48, 0xA2, 0x3C, 0xD7
+};
+read_only global U8 t_dw_zstd_rle_frame[] = {
+  0x28, 0xB5, 0x2F, 0xFD, 0x00, 0x58, 0x54, 0x00, 0x00, 0x10, 0xAB, 0xAB, 0x01, 0x00, 0xFB, 0xFF,
+  0x39, 0xC0, 0x02, 0x02, 0x00, 0x10, 0xAB, 0x03, 0x9F, 0x04, 0xAB
+};
+read_only global U8 t_dw_zstd_cmp_frame[] = {
+  0x28, 0xB5, 0x2F, 0xFD, 0x00, 0x68, 0x4D, 0x0A, 0x00, 0xB2, 0xC4, 0x0F, 0x11, 0xA0, 0x6F, 0x20,
+  0x61, 0xC9, 0x9B, 0xF2, 0x27, 0xEF, 0x22, 0x13, 0x6D, 0x1F, 0xF2, 0xFF, 0x81, 0x32, 0x3E, 0xB3,
+  0x75, 0x98, 0xFA, 0xD1, 0xC6, 0xF6, 0x1F, 0x6D, 0xA7, 0x62, 0xD3, 0x26, 0xE9, 0x4C, 0xB7, 0xA2,
+  0x32, 0x8C, 0xAF, 0x0B, 0xD5, 0x3F, 0x41, 0xEB, 0x15, 0x60, 0xF9, 0xB7, 0x57, 0xFF, 0xFE, 0xEB,
+  0x08, 0x3C, 0xF6, 0x23, 0x33, 0xD0, 0x21, 0x40, 0x05, 0x29, 0x59, 0x80, 0x81, 0xA8, 0xC1, 0x27,
+  0x29, 0xED, 0xCC, 0x01, 0x20, 0x84, 0x18, 0xC3, 0x98, 0x55, 0x07, 0x12, 0xC0, 0x10, 0x60, 0x09,
+  0x10, 0xA6, 0x23, 0x40, 0x18, 0xA8, 0x80, 0x09, 0x48, 0x81, 0x11, 0x70, 0x81, 0x90, 0x04, 0x14,
+  0x26, 0xB1, 0x96, 0x03, 0x89, 0x70, 0xCC, 0x83, 0x22, 0x39, 0xC8, 0x5D, 0x05, 0x95, 0x94, 0x2D,
+  0x96, 0x21, 0x55, 0x60, 0x90, 0x12, 0xC2, 0x4A, 0x3C, 0x75, 0x94, 0x7C, 0x18, 0xC5, 0x32, 0xDC,
+  0xCD, 0xDA, 0x44, 0x02, 0xF1, 0x77, 0x8F, 0x0B, 0x79, 0x80, 0xDB, 0x7C, 0xBA, 0x1E, 0xF9, 0x60,
+  0x3C, 0xB2, 0xAD, 0x24, 0x46, 0xA7, 0x9B, 0xE1, 0xD3, 0x5E, 0x57, 0xF3, 0x35, 0x1A, 0xBE, 0xEC,
+  0xE8, 0x6B, 0x8E, 0xBA, 0xF3, 0xC7, 0x6A, 0x79, 0x6B, 0x99, 0x77, 0x73, 0x06, 0xD5, 0xD6, 0x52,
+  0x56, 0x1F, 0x51, 0xD6, 0x65, 0xA2, 0xE1, 0x7B, 0xC6, 0xDB, 0xD6, 0x65, 0xF6, 0x21, 0xDB, 0x61,
+  0x00, 0xD7, 0xC3, 0x1B, 0x8B, 0x3B, 0x35, 0x93, 0x1D, 0x25, 0xFC, 0x7E, 0xB6, 0x0A, 0x37, 0xFD,
+  0x08, 0x43, 0xBC, 0x96, 0x50, 0x98, 0x1C, 0x84, 0x10, 0x49, 0x82, 0xFC, 0x17, 0x40, 0xAD, 0xEF,
+  0xD1, 0xBF, 0xAA, 0x87, 0x3F, 0x2F, 0x89, 0x0B, 0x9B, 0x61, 0xA7, 0xEA, 0xB8, 0x98, 0x55, 0x6C,
+  0xAC, 0x17, 0x04, 0x50, 0x69, 0x18, 0xA2, 0xA0, 0x8A, 0x70, 0xF8, 0x1F, 0x6A, 0xAA, 0xD2, 0xE3,
+  0xF5, 0x5D, 0x71, 0xF0, 0x8E, 0x60, 0x82, 0xA3, 0xC4, 0xE4, 0x7C, 0x64, 0xA6, 0xE6, 0xAA, 0x2B,
+  0xE4, 0x0C, 0x6E, 0x6C, 0x41, 0x1A, 0xEA, 0xB7, 0xA3, 0xA8, 0x85, 0x64, 0x33, 0xC2, 0x4E, 0x50,
+  0x06, 0x38, 0x38, 0x40, 0x19, 0x13, 0x8E, 0x41, 0x68, 0x54, 0xDB, 0xAC, 0xD8, 0x68, 0x49, 0x4A,
+  0xB0, 0x1F, 0xF6, 0x77, 0x8E, 0xBC, 0xFC, 0x40, 0x6A, 0xDF, 0x4A, 0x4A, 0xED, 0xC2, 0x2A, 0xF8,
+  0xA5, 0x0A
+};
+
+internal String8
+t_dw_zstd_raw_contents(Arena *arena)
+{
+  String8 result = str8(push_array(arena, U8, 64), 64);
+  U64 x = 1;
+  for EachIndex(idx, result.size) {
+    x = x*6364136223846793005ull + 1442695040888963407ull;
+    result.str[idx] = (U8)(x >> 56);
+  }
+  return result;
+}
+
+internal String8
+t_dw_zstd_rle_contents(Arena *arena)
+{
+  String8 result = str8(push_array(arena, U8, 300000), 300000);
+  MemorySet(result.str, 0xAB, result.size);
+  return result;
+}
+
+internal String8
+t_dw_zstd_cmp_contents(Arena *arena)
+{
+  read_only local_persist char *words[] = { "DW_TAG_variable", "DW_AT_name", "int", "main", "DW_TAG_subprogram", "unsigned", "char", "DW_AT_type", "foo.c", "/usr/include" };
+  String8 result = str8(push_array(arena, U8, 2048), 2048);
+  U64 x = 7;
+  for (U64 off = 0; off < result.size;) {
+    x = x*6364136223846793005ull + 1442695040888963407ull;
+    String8 word = str8_cstring(words[(x >> 33) % ArrayCount(words)]);
+    for EachIndex(idx, word.size + 1) {
+      if (off < result.size) {
+        result.str[off] = idx < word.size ? word.str[idx] : 0;
+        off += 1;
+      }
+    }
+  }
+  return result;
+}
+
+internal B32
+t_dw_zstd_decompress_matches(String8 frame, String8 expected)
+{
+  Temp scratch = scratch_begin(0, 0);
+  U8 *buffer = push_array(scratch.arena, U8, expected.size + 1);
+  buffer[expected.size] = 0xCD;
+  U64 size = zstd_decompress(buffer, expected.size, frame);
+  B32 is_match = size == expected.size && MemoryMatch(buffer, expected.str, expected.size) && buffer[expected.size] == 0xCD;
+  scratch_end(scratch);
+  return is_match;
+}
+
+internal B32
+t_dw_zstd_truncated_is_rejected(String8 frame, String8 expected)
+{
+  Temp scratch = scratch_begin(0, 0);
+  B32 is_rejected = 1;
+  U8 *buffer = push_array(scratch.arena, U8, expected.size + 1);
+  for (U64 size = 0; size < frame.size && is_rejected; size += 1) {
+    buffer[expected.size] = 0xCD;
+    U64 decompressed_size = zstd_decompress(buffer, expected.size, str8_prefix(frame, size));
+    is_rejected = (decompressed_size < expected.size &&
+                   MemoryMatch(buffer, expected.str, decompressed_size) &&
+                   buffer[expected.size] == 0xCD);
+  }
+  scratch_end(scratch);
+  return is_rejected;
+}
+
+TEST(zstd_blocks)
+{
+  String8 raw_frame = str8_array_fixed(t_dw_zstd_raw_frame);
+  String8 rle_frame = str8_array_fixed(t_dw_zstd_rle_frame);
+  String8 cmp_frame = str8_array_fixed(t_dw_zstd_cmp_frame);
+  String8 raw       = t_dw_zstd_raw_contents(arena);
+  String8 rle       = t_dw_zstd_rle_contents(arena);
+  String8 cmp       = t_dw_zstd_cmp_contents(arena);
+  
+  // raw, RLE, and compressed blocks
+  T_Ok(t_dw_zstd_decompress_matches(raw_frame, raw));
+  T_Ok(t_dw_zstd_decompress_matches(rle_frame, rle));
+  T_Ok(t_dw_zstd_decompress_matches(cmp_frame, cmp));
+  
+  // concatenated frames decode back-to-back
+  String8 frames   = push_str8f(arena, "%S%S%S", raw_frame, rle_frame, cmp_frame);
+  String8 contents = push_str8f(arena, "%S%S%S", raw, rle, cmp);
+  T_Ok(t_dw_zstd_decompress_matches(frames, contents));
+  
+  // output which does not fit is not written past the buffer
+  T_Ok(!t_dw_zstd_decompress_matches(cmp_frame, str8_prefix(cmp, cmp.size - 1)));
+  
+  // every truncation stops short, without writing past the buffer
+  T_Ok(t_dw_zstd_truncated_is_rejected(raw_frame, raw));
+  T_Ok(t_dw_zstd_truncated_is_rejected(rle_frame, rle));
+  T_Ok(t_dw_zstd_truncated_is_rejected(cmp_frame, cmp));
+}
+
+TEST(zstd_debug_sections)
+{
+  String8 cmp_frame = str8_array_fixed(t_dw_zstd_cmp_frame);
+  String8 cmp       = t_dw_zstd_cmp_contents(arena);
+  String8 abbrev    = str8_lit("\x01\x11\x00\x00\x00");
+  String8 shstrtab  = str8_lit("\0.shstrtab\0.debug_str\0.debug_abbrev\0");
+  
+  // ELF with a zstd-compressed .debug_str & an uncompressed .debug_abbrev
+  ELF_Chdr64 chdr = { .ch_type = ELF_CompressType_ZStd, .ch_size = cmp.size, .ch_addr_align = 1 };
+  U64 shstrtab_off = sizeof(ELF_Hdr64);
+  U64 str_off      = shstrtab_off + shstrtab.size;
+  U64 abbrev_off   = str_off + sizeof(chdr) + cmp_frame.size;
+  U64 shdrs_off    = AlignPow2(abbrev_off + abbrev.size, 8);
+  ELF_Shdr64 shdrs[] = {
+    {0},
+    { .sh_name = 1,  .sh_type = ELF_ShType_Strtab,   .sh_offset = shstrtab_off, .sh_size = shstrtab.size },
+    { .sh_name = 11, .sh_type = ELF_ShType_ProgBits, .sh_offset = str_off,      .sh_size = sizeof(chdr) + cmp_frame.size, .sh_flags = ELF_Shf_Compressed },
+    { .sh_name = 22, .sh_type = ELF_ShType_ProgBits, .sh_offset = abbrev_off,   .sh_size = abbrev.size },
+  };
+  ELF_Hdr64 hdr = {
+    .e_ident     = { 0x7F, 'E', 'L', 'F', ELF_Class_64, ELF_Data_2LSB, ELF_Version_Current },
+    .e_type      = ELF_Type_Exec,
+    .e_machine   = ELF_MachineKind_X86_64,
+    .e_version   = ELF_Version_Current,
+    .e_shoff     = shdrs_off,
+    .e_ehsize    = sizeof(ELF_Hdr64),
+    .e_shentsize = sizeof(ELF_Shdr64),
+    .e_shnum     = ArrayCount(shdrs),
+    .e_shstrndx  = 1,
+  };
+  String8List parts = {0};
+  str8_list_push(arena, &parts, str8_struct(&hdr));
+  str8_list_push(arena, &parts, shstrtab);
+  str8_list_push(arena, &parts, str8_struct(&chdr));
+  str8_list_push(arena, &parts, cmp_frame);
+  str8_list_push(arena, &parts, abbrev);
+  str8_list_push(arena, &parts, str8(push_array(arena, U8, shdrs_off - parts.total_size), shdrs_off - parts.total_size));
+  str8_list_push(arena, &parts, str8_array_fixed(shdrs));
+  String8 data = str8_list_join(arena, &parts, 0);
+  
+  // dw_input_from_elf_bin syncs lanes & broadcasts, so run it on a single lane
+  U64     broadcast_memory = 0;
+  LaneCtx single_lane_ctx  = {0, 1, {0}, &broadcast_memory};
+  LaneCtx lane_ctx_restore = lane_ctx(single_lane_ctx);
+  ELF_Bin bin              = elf_bin_from_data(arena, data);
+  DW_Raw  input            = dw_input_from_elf_bin(arena, data, &bin);
+  lane_ctx(lane_ctx_restore);
+  
+  T_Ok(str8_match(input.sec[DW_Section_Str].name, str8_lit(".debug_str"), 0));
+  T_Ok(str8_match(input.sec[DW_Section_Str].data, cmp, 0));
+  T_Ok(str8_match(input.sec[DW_Section_Abbrev].data, abbrev, 0));
+}
+
 #undef T_Group
@@ -43,6 +43,7 @@
 #include "pe/pe.h"
 #include "pe/pe_section_flags.h"
 #include "pe/pe_make_import_table.h"
+#include "zstd/zstd.h"
 #include "elf/elf.h"
 #include "gnu/gnu.h"
 #include "gnu/gnu_parse.h"
@@ -118,6 +119,7 @@
 #include "coff/coff_lib_writer.c"
 #include "pe/pe.c"
 #include "pe/pe_make_import_table.c"
+#include "zstd/zstd.c"
 #include "elf/elf.c"
 #include "gnu/gnu.c"
 #include "gnu/gnu_parse.c"
@@ -7,11 +7,12 @@
 //  [ ] opt_ref_weak_alias_comdat
 //  [ ] reloc_apply_off_out_of_bounds
 //  [ ] lib_member_reloc_apply_off_out_of_bounds
-//  [ ] fold_two_funcs
-//  [ ] same_but_different
-//  [ ] fold_diamond
-//  [ ] cyclic_icf
-//  [ ] fold_with_largest_align
+//  [x] fold_two_funcs
+//  [x] same_but_different
+//  [x] fold_diamond
+//  [x] cyclic_icf
+//  [x] fold_with_largest_align
+//  [x] icf_iter_limit
 
 ////////////////////////////////
 // Def -> COFF
@@ -6553,8 +6554,6 @@ TEST(determ_test)
 
 #endif
 
-#if 0
-
 TEST(fold_two_funcs)
 {
   U8 same_text[] = {
@@ -6594,13 +6593,13 @@ TEST(fold_two_funcs)
   t_invoke_linkerf("/subsystem:console /entry:entry /out:a.exe /opt:icf ident_funcs.obj");
   T_Ok(g_last_exit_code == 0);
 
-  String8 exe = t_read_file(arena, str8_lit("ident_funcs.exe"));
+  String8 exe = t_read_file(arena, str8_lit("a.exe"));
   T_Ok(exe.size);
 
   PE_BinInfo           pe            = pe_bin_info_from_data(arena, exe);
   COFF_SectionHeader  *section_table = (COFF_SectionHeader *)str8_substr(exe, pe.section_table_range).str;
   String8              string_table  = str8_substr(exe, pe.string_table_range);
-  COFF_SectionHeader  *text_sect     = coff_section_header_from_name(exe, section_table, pe.section_count, str8_lit(".text"));
+  COFF_SectionHeader  *text_sect     = coff_section_header_from_name(string_table, section_table, pe.section_count, str8_lit(".text"));
 
   // validate .text header
   T_Ok(text_sect->voff  == 0x1000);
@@ -6884,6 +6883,94 @@ TEST(cyclic_icf)
 }
 
 
+TEST(icf_iter_limit)
+{
+  U8 call_a1_and_a2[] = {
+    0xe8, 0x00, 0x00, 0x00, 0x00, // call a1
+    0xe8, 0x00, 0x00, 0x00, 0x00, // call a2
+    0xc3
+  };
+  U8 call_and_return[] = {
+    0xe8, 0x00, 0x00, 0x00, 0x00,
+    0xc3
+  };
+  U8 return_1[] = {
+    0x48, 0xc7, 0xc0, 0x01, 0x00, 0x00, 0x00, // mov rax, 1
+    0xc3                                      // ret
+  };
+  U8 return_2[] = {
+    0x48, 0xc7, 0xc0, 0x02, 0x00, 0x00, 0x00, // mov rax, 2
+    0xc3                                      // ret
+  };
+  // a1 -> b1 -> c1 -> d1 and a2 -> b2 -> c2 -> d2 differ only at the leaf,
+  // one refine iteration splits c1/c2 but a1/a2 and b1/b2 still share a class
+  T_Ok(t_write_def_obj("a.obj", (T_COFF_DefObj){
+    .machine = T_COFF_DefSetMachine(X64),
+    .sections = (T_COFF_DefSection[]){
+      {
+        "entry", ".text", str8_array_fixed(call_a1_and_a2), .flags = "rx:code",
+        .relocs = (T_COFF_DefReloc[]){
+          T_COFF_DefReloc(X64_Rel32, 1, "a1"),
+          T_COFF_DefReloc(X64_Rel32, 6, "a2"),
+          {0}
+        }
+      },
+      { "a1", ".text", str8_array_fixed(call_and_return), .flags = "rx:code", .raw_flags = COFF_SectionFlag_LnkCOMDAT, .relocs = (T_COFF_DefReloc[]){ T_COFF_DefReloc(X64_Rel32, 1, "b1"), {0} } },
+      { "a2", ".text", str8_array_fixed(call_and_return), .flags = "rx:code", .raw_flags = COFF_SectionFlag_LnkCOMDAT, .relocs = (T_COFF_DefReloc[]){ T_COFF_DefReloc(X64_Rel32, 1, "b2"), {0} } },
+      { "b1", ".text", str8_array_fixed(call_and_return), .flags = "rx:code", .raw_flags = COFF_SectionFlag_LnkCOMDAT, .relocs = (T_COFF_DefReloc[]){ T_COFF_DefReloc(X64_Rel32, 1, "c1"), {0} } },
+      { "b2", ".text", str8_array_fixed(call_and_return), .flags = "rx:code", .raw_flags = COFF_SectionFlag_LnkCOMDAT, .relocs = (T_COFF_DefReloc[]){ T_COFF_DefReloc(X64_Rel32, 1, "c2"), {0} } },
+      { "c1", ".text", str8_array_fixed(call_and_return), .flags = "rx:code", .raw_flags = COFF_SectionFlag_LnkCOMDAT, .relocs = (T_COFF_DefReloc[]){ T_COFF_DefReloc(X64_Rel32, 1, "d1"), {0} } },
+      { "c2", ".text", str8_array_fixed(call_and_return), .flags = "rx:code", .raw_flags = COFF_SectionFlag_LnkCOMDAT, .relocs = (T_COFF_DefReloc[]){ T_COFF_DefReloc(X64_Rel32, 1, "d2"), {0} } },
+      { "d1", ".text", str8_array_fixed(return_1), .flags = "rx:code", .raw_flags = COFF_SectionFlag_LnkCOMDAT },
+      { "d2", ".text", str8_array_fixed(return_2), .flags = "rx:code", .raw_flags = COFF_SectionFlag_LnkCOMDAT },
+      {0}
+    },
+    .symbols = (T_COFF_DefSymbol[]){
+      T_COFF_DefSymbol_Secdef("a1", COFF_ComdatSelect_NoDuplicates),
+      T_COFF_DefSymbol_Secdef("a2", COFF_ComdatSelect_NoDuplicates),
+      T_COFF_DefSymbol_Secdef("b1", COFF_ComdatSelect_NoDuplicates),
+      T_COFF_DefSymbol_Secdef("b2", COFF_ComdatSelect_NoDuplicates),
+      T_COFF_DefSymbol_Secdef("c1", COFF_ComdatSelect_NoDuplicates),
+      T_COFF_DefSymbol_Secdef("c2", COFF_ComdatSelect_NoDuplicates),
+      T_COFF_DefSymbol_Secdef("d1", COFF_ComdatSelect_NoDuplicates),
+      T_COFF_DefSymbol_Secdef("d2", COFF_ComdatSelect_NoDuplicates),
+      T_COFF_DefSymbol_Extern("entry", "entry", 0),
+      T_COFF_DefSymbol_Extern("a1", "a1", 0),
+      T_COFF_DefSymbol_Extern("a2", "a2", 0),
+      T_COFF_DefSymbol_Extern("b1", "b1", 0),
+      T_COFF_DefSymbol_Extern("b2", "b2", 0),
+      T_COFF_DefSymbol_Extern("c1", "c1", 0),
+      T_COFF_DefSymbol_Extern("c2", "c2", 0),
+      T_COFF_DefSymbol_Extern("d1", "d1", 0),
+      T_COFF_DefSymbol_Extern("d2", "d2", 0),
+      {0}
+    }
+  }));
+
+  for EachIndex(iter_count, 4) {
+    t_invoke_linkerf("/subsystem:console /entry:entry /out:a.exe /opt:icf=%llu a.obj", iter_count + 1);
+    T_Ok(g_last_exit_code == 0);
+
+    String8 exe = t_read_file(arena, str8_lit("a.exe"));
+    T_Ok(exe.size);
+
+    PE_BinInfo          pe            = pe_bin_info_from_data(arena, exe);
+    COFF_SectionHeader *section_table = (COFF_SectionHeader *)str8_substr(exe, pe.section_table_range).str;
+    String8             string_table  = str8_substr(exe, pe.string_table_range);
+    COFF_SectionHeader *text_section  = coff_section_header_from_name(string_table, section_table, pe.section_count, str8_lit(".text"));
+    T_Ok(text_section);
+    T_Ok(text_section->foff + sizeof(call_a1_and_a2) <= exe.size);
+
+    // entry is placed first, a1 and a2 must not be folded no matter where the iteration limit cuts off refinement
+    String8 entry = str8_substr(exe, r1u64(text_section->foff, text_section->foff + sizeof(call_a1_and_a2)));
+    S32     a1_disp, a2_disp;
+    MemoryCopy(&a1_disp, entry.str + 1, sizeof(a1_disp));
+    MemoryCopy(&a2_disp, entry.str + 6, sizeof(a2_disp));
+    T_Ok(5 + a1_disp != 10 + a2_disp);
+  }
+}
+
+
 TEST(fold_with_largest_align)
 {
   U8 text[] = {
@@ -7005,8 +7092,6 @@ TEST(fold_with_largest_align)
   }
 }
 
-#endif
-
 #if 0
 TEST(reloc_apply_off_out_of_bounds)
 {
@@ -7197,4 +7282,631 @@ TEST(opt_ref_weak_alias_comdat)
 }
 #endif
 
+internal String8
+t_inc_make_func_obj(Arena *arena, U64 helper_pad, U8 func_value)
+{
+  // helper: mov eax, imm; nop * helper_pad; ret
+  // func:   mov eax, imm; ret
+  U64 func_off  = 5 + helper_pad + 1;
+  U64 text_size = func_off + 6;
+  U8 *text      = push_array(arena, U8, text_size);
+  text[0] = 0xB8; text[1] = func_value;
+  MemorySet(text + 5, 0x90, helper_pad);
+  text[5 + helper_pad] = 0xC3;
+  text[func_off + 0] = 0xB8; text[func_off + 1] = func_value;
+  text[func_off + 5] = 0xC3;
+
+  return t_coff_from_def_obj(arena, (T_COFF_DefObj){
+    .machine = T_COFF_DefSetMachine(X64),
+    .sections = (T_COFF_DefSection[]){
+      { "text", ".text", str8(text, text_size), .flags = "rx:code@1" },
+      {
+        "data", ".data", str8_lit_comp("\x00\x00\x00\x00\x00\x00\x00\x00"), .flags = "rw:data@8",
+        .relocs = (T_COFF_DefReloc[]){ T_COFF_DefReloc(X64_Addr64, 0, "func"), {0} }
+      },
+      {0}
+    },
+    .symbols = (T_COFF_DefSymbol[]){
+      T_COFF_DefSymbol_Extern("helper", "text", 0),
+      T_COFF_DefSymbol_Extern("func", "text", func_off),
+      T_COFF_DefSymbol_Extern("func_ptr", "data", 0),
+      {0}
+    }
+  });
+}
+
+internal B32
+t_inc_write_entry_obj(void)
+{
+  return t_write_def_obj("entry.obj", (T_COFF_DefObj){
+    .machine = T_COFF_DefSetMachine(X64),
+    .sections = (T_COFF_DefSection[]){
+      {
+        "text", ".text", str8_lit_comp("\xE8\x00\x00\x00\x00\xC3"), .flags = "rx:code@1",
+        .relocs = (T_COFF_DefReloc[]){ T_COFF_DefReloc(X64_Rel32, 1, "func"), {0} }
+      },
+      {0}
+    },
+    .symbols = (T_COFF_DefSymbol[]){
+      T_COFF_DefSymbol_Extern("entry", "text", 0),
+      T_COFF_DefSymbol_Undef("func"),
+      {0}
+    }
+  });
+}
+
+internal B32
+t_inc_is_func_valid(Arena *arena, String8 exe_name, U8 func_value)
+{
+  String8 exe = t_read_file(arena, exe_name);
+  if (exe.size == 0) { return 0; }
+
+  PE_BinInfo          pe            = pe_bin_info_from_data(arena, exe);
+  COFF_SectionHeader *section_table = (COFF_SectionHeader *)str8_substr(exe, pe.section_table_range).str;
+  String8             string_table  = str8_substr(exe, pe.string_table_range);
+  COFF_SectionHeader *text_sect     = coff_section_header_from_name(string_table, section_table, pe.section_count, str8_lit(".text"));
+  COFF_SectionHeader *data_sect     = coff_section_header_from_name(string_table, section_table, pe.section_count, str8_lit(".data"));
+  if (text_sect == 0 || data_sect == 0) { return 0; }
+
+  // entry is first in .text and calls func
+  S32 call_disp = 0;
+  str8_deserial_read_struct(exe, text_sect->foff + 1, &call_disp);
+  U64 func_voff = (U64)((S64)text_sect->voff + 5 + call_disp);
+
+  // func_ptr is first in .data and points to func
+  U64 func_ptr = 0;
+  str8_deserial_read_struct(exe, data_sect->foff, &func_ptr);
+  if (func_ptr != pe.image_base + func_voff) { return 0; }
+
+  U8  expected_func[] = { 0xB8, func_value, 0x00, 0x00, 0x00, 0xC3 };
+  U64 func_foff       = text_sect->foff + (func_voff - text_sect->voff);
+  return str8_match(str8_substr(exe, r1u64(func_foff, func_foff + sizeof(expected_func))), str8_array_fixed(expected_func), 0);
+}
+
+TEST(incremental_same_size)
+{
+  T_Ok(t_inc_write_entry_obj());
+  T_Ok(t_write_file(str8_lit("func.obj"), t_inc_make_func_obj(arena, 0, 1)));
+
+  t_invoke_linkerf("/subsystem:console /entry:entry /incremental /rad_log:incremental /out:a.exe entry.obj func.obj");
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(t_inc_is_func_valid(arena, str8_lit("a.exe"), 1));
+
+  // make sure modification time changes
+  sleep_ms(20);
+  T_Ok(t_write_file(str8_lit("func.obj"), t_inc_make_func_obj(arena, 0, 2)));
+
+  String8 output = {0};
+  t_invoke_(g_linker, str8_lit("/subsystem:console /entry:entry /incremental /rad_log:incremental /out:a.exe entry.obj func.obj"), max_U64, arena, &output);
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_find_needle(output, 0, str8_lit("patched 1 changed obj(s)"), 0) < output.size);
+  T_Ok(t_inc_is_func_valid(arena, str8_lit("a.exe"), 2));
+
+  // patched image must match a full link with same inputs
+  t_invoke_linkerf("/subsystem:console /entry:entry /incremental /rad_log:incremental /out:b.exe entry.obj func.obj");
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_match(t_read_file(arena, str8_lit("a.exe")), t_read_file(arena, str8_lit("b.exe")), 0));
+
+  // nothing to do when inputs are unchanged
+  t_invoke_(g_linker, str8_lit("/subsystem:console /entry:entry /incremental /rad_log:incremental /out:a.exe entry.obj func.obj"), max_U64, arena, &output);
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_find_needle(output, 0, str8_lit("is up to date"), 0) < output.size);
+}
+
+TEST(incremental_grow)
+{
+  T_Ok(t_inc_write_entry_obj());
+  T_Ok(t_write_file(str8_lit("func.obj"), t_inc_make_func_obj(arena, 0, 1)));
+
+  t_invoke_linkerf("/subsystem:console /entry:entry /incremental /rad_log:incremental /out:a.exe entry.obj func.obj");
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(t_inc_is_func_valid(arena, str8_lit("a.exe"), 1));
+
+  // helper grows and moves func, so entry.obj has to be relocated too
+  sleep_ms(20);
+  T_Ok(t_write_file(str8_lit("func.obj"), t_inc_make_func_obj(arena, 8, 3)));
+
+  String8 output = {0};
+  t_invoke_(g_linker, str8_lit("/subsystem:console /entry:entry /incremental /rad_log:incremental /out:a.exe entry.obj func.obj"), max_U64, arena, &output);
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_find_needle(output, 0, str8_lit("relocating"), 0) < output.size);
+  T_Ok(str8_find_needle(output, 0, str8_lit("patched 1 changed obj(s) and relocated 1 obj(s)"), 0) < output.size);
+  T_Ok(t_inc_is_func_valid(arena, str8_lit("a.exe"), 3));
+}
+
+TEST(incremental_overflow)
+{
+  T_Ok(t_inc_write_entry_obj());
+  T_Ok(t_write_file(str8_lit("func.obj"), t_inc_make_func_obj(arena, 0, 1)));
+
+  t_invoke_linkerf("/subsystem:console /entry:entry /incremental /rad_log:incremental /out:a.exe entry.obj func.obj");
+  T_Ok(g_last_exit_code == 0);
+
+  // growth past the reserve falls back to a full link
+  sleep_ms(20);
+  T_Ok(t_write_file(str8_lit("func.obj"), t_inc_make_func_obj(arena, 256, 4)));
+
+  String8 output = {0};
+  t_invoke_(g_linker, str8_lit("/subsystem:console /entry:entry /incremental /rad_log:incremental /out:a.exe entry.obj func.obj"), max_U64, arena, &output);
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_find_needle(output, 0, str8_lit("overflows its reserve"), 0) < output.size);
+  T_Ok(str8_find_needle(output, 0, str8_lit("performing full link"), 0) < output.size);
+  T_Ok(t_inc_is_func_valid(arena, str8_lit("a.exe"), 4));
+
+  // next link picks up state of the full link
+  sleep_ms(20);
+  T_Ok(t_write_file(str8_lit("func.obj"), t_inc_make_func_obj(arena, 256, 5)));
+  t_invoke_(g_linker, str8_lit("/subsystem:console /entry:entry /incremental /rad_log:incremental /out:a.exe entry.obj func.obj"), max_U64, arena, &output);
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_find_needle(output, 0, str8_lit("patched 1 changed obj(s)"), 0) < output.size);
+  T_Ok(t_inc_is_func_valid(arena, str8_lit("a.exe"), 5));
+}
+
+TEST(incremental_debug)
+{
+  String8 cmdline = str8_lit("/subsystem:console /entry:entry /incremental /rad_log:incremental /debug:full /rad_debug /rad_workers:1 /out:a.exe entry.obj func.obj");
+
+  T_Ok(t_inc_write_entry_obj());
+  T_Ok(t_write_file(str8_lit("func.obj"), t_inc_make_func_obj(arena, 0, 1)));
+
+  t_invoke_linker(cmdline);
+  T_Ok(g_last_exit_code == 0);
+
+  // debug info is rebuilt against the patched image
+  sleep_ms(20);
+  T_Ok(t_write_file(str8_lit("func.obj"), t_inc_make_func_obj(arena, 0, 2)));
+
+  String8 output = {0};
+  t_invoke_(g_linker, cmdline, max_U64, arena, &output);
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_find_needle(output, 0, str8_lit("patched 1 changed obj(s)"), 0) < output.size);
+  T_Ok(t_inc_is_func_valid(arena, str8_lit("a.exe"), 2));
+
+  String8 inc_exe = t_read_file(arena, str8_lit("a.exe"));
+  String8 inc_pdb = t_read_file(arena, str8_lit("a.pdb"));
+  String8 inc_rdi = t_read_file(arena, str8_lit("a.rdi"));
+  T_Ok(inc_pdb.size > 0);
+  T_Ok(inc_rdi.size > 0);
+
+  // without state same command line does a full link
+  T_Ok(t_delete_file(str8_lit("a.ilk")));
+  t_invoke_(g_linker, cmdline, max_U64, arena, &output);
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_find_needle(output, 0, str8_lit("patched"), 0) == output.size);
+
+  T_Ok(str8_match(inc_exe, t_read_file(arena, str8_lit("a.exe")), 0));
+  T_Ok(str8_match(inc_pdb, t_read_file(arena, str8_lit("a.pdb")), 0));
+  T_Ok(str8_match(inc_rdi, t_read_file(arena, str8_lit("a.rdi")), 0));
+
+  // helper grows and moves func, public symbol must follow it
+  sleep_ms(20);
+  T_Ok(t_write_file(str8_lit("func.obj"), t_inc_make_func_obj(arena, 8, 3)));
+  t_invoke_(g_linker, cmdline, max_U64, arena, &output);
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_find_needle(output, 0, str8_lit("patched 1 changed obj(s) and relocated 1 obj(s)"), 0) < output.size);
+  T_Ok(t_inc_is_func_valid(arena, str8_lit("a.exe"), 3));
+
+  String8             exe           = t_read_file(arena, str8_lit("a.exe"));
+  PE_BinInfo          pe            = pe_bin_info_from_data(arena, exe);
+  COFF_SectionHeader *section_table = (COFF_SectionHeader *)str8_substr(exe, pe.section_table_range).str;
+  S32                 call_disp     = 0;
+  str8_deserial_read_struct(exe, section_table[0].foff + 1, &call_disp);
+  U64 func_voff = (U64)((S64)section_table[0].voff + 5 + call_disp);
+
+  String8        raw_pdb      = t_read_file(arena, str8_lit("a.pdb"));
+  MSF_Parsed    *msf          = msf_parsed_from_data(arena, raw_pdb);
+  PDB_DbiParsed *dbi          = pdb_dbi_from_data(arena, msf_data_from_stream(msf, PDB_FixedStream_Dbi));
+  String8        psi_data     = msf_data_from_stream(msf, dbi->psi_sn);
+  String8        psi_gsi_data = str8_range(psi_data.str + sizeof(PDB_PsiHeader), psi_data.str+psi_data.size);
+  PDB_GsiParsed *psi          = pdb_gsi_from_data(arena, psi_gsi_data);
+  String8        symbol_data  = msf_data_from_stream(msf, dbi->sym_sn);
+  U64            symbol_off   = pdb_gsi_symbol_from_string(psi, symbol_data, str8_lit("func"));
+  T_Ok(symbol_off < symbol_data.size);
+
+  CV_Symbol func_symbol = {0};
+  T_Ok(cv_read_symbol(str8_skip(symbol_data, symbol_off), 0, 1, &func_symbol) > 0);
+  T_Ok(func_symbol.kind == CV_SymKind_PUB32);
+  CV_SymPub32 *pub32 = str8_deserial_get_raw_ptr(func_symbol.data, 0, sizeof(*pub32));
+  T_Ok(pub32->sec == 1);
+  T_Ok(section_table[0].voff + pub32->off == func_voff);
+}
+
+TEST(incremental_timing)
+{
+  // chain of objs where each function calls the next one
+  U64         objs_count = 512;
+  String8List obj_names  = {0};
+  U8         *payload    = push_array(arena, U8, KB(16));
+  for EachIndex(obj_idx, objs_count) {
+    U8  text[]  = { 0xE8, 0x00, 0x00, 0x00, 0x00, 0xC3 };
+    B32 is_last = obj_idx + 1 == objs_count;
+    T_COFF_DefSymbol symbols[] = {
+      T_COFF_DefSymbol_Extern((char *)push_str8f(arena, "f%llu", obj_idx).str, "text", 0),
+      T_COFF_DefSymbol_Undef((char *)push_str8f(arena, "f%llu", obj_idx+1).str),
+      {0}
+    };
+    if (is_last) { MemoryZeroStruct(&symbols[1]); }
+    String8 obj = t_coff_from_def_obj(arena, (T_COFF_DefObj){
+      .machine = T_COFF_DefSetMachine(X64),
+      .sections = (T_COFF_DefSection[]){
+        {
+          "text", ".text", is_last ? str8_lit("\xC3") : str8_array_fixed(text), .flags = "rx:code@16",
+          .relocs = is_last ? 0 : (T_COFF_DefReloc[]){ T_COFF_DefReloc(X64_Rel32, 1, (char *)push_str8f(arena, "f%llu", obj_idx+1).str), {0} }
+        },
+        { "rdata", ".rdata", str8(payload, KB(16)), .flags = "r:data@16" },
+        {0}
+      },
+      .symbols = symbols
+    });
+    String8 obj_name = push_str8f(arena, "f%llu.obj", obj_idx);
+    T_Ok(t_write_file(obj_name, obj));
+    str8_list_push(arena, &obj_names, obj_name);
+  }
+  String8 objs_cmd_line = str8_list_join(arena, &obj_names, &(StringJoin){ .sep = str8_lit_comp(" ") });
+  String8 cmd_line      = push_str8f(arena, "/subsystem:console /entry:f0 /incremental /rad_log:incremental /out:a.exe %S", objs_cmd_line);
+
+  U64 full_begin = now_time_us();
+  t_invoke_linker(cmd_line);
+  U64 full_time = now_time_us() - full_begin;
+  T_Ok(g_last_exit_code == 0);
+
+  // change payload of an obj in the middle of the chain
+  sleep_ms(20);
+  {
+    U8 text[] = { 0xE8, 0x00, 0x00, 0x00, 0x00, 0xC3 };
+    payload[0] = 0xFF;
+    U64 obj_idx = objs_count / 2;
+    String8 obj = t_coff_from_def_obj(arena, (T_COFF_DefObj){
+      .machine = T_COFF_DefSetMachine(X64),
+      .sections = (T_COFF_DefSection[]){
+        {
+          "text", ".text", str8_array_fixed(text), .flags = "rx:code@16",
+          .relocs = (T_COFF_DefReloc[]){ T_COFF_DefReloc(X64_Rel32, 1, (char *)push_str8f(arena, "f%llu", obj_idx+1).str), {0} }
+        },
+        { "rdata", ".rdata", str8(payload, KB(16)), .flags = "r:data@16" },
+        {0}
+      },
+      .symbols = (T_COFF_DefSymbol[]){
+        T_COFF_DefSymbol_Extern((char *)push_str8f(arena, "f%llu", obj_idx).str, "text", 0),
+        T_COFF_DefSymbol_Undef((char *)push_str8f(arena, "f%llu", obj_idx+1).str),
+        {0}
+      }
+    });
+    T_Ok(t_write_file(push_str8f(arena, "f%llu.obj", obj_idx), obj));
+  }
+
+  String8 output    = {0};
+  U64     inc_begin = now_time_us();
+  t_invoke_(g_linker, cmd_line, max_U64, arena, &output);
+  U64     inc_time  = now_time_us() - inc_begin;
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_find_needle(output, 0, str8_lit("patched 1 changed obj(s)"), 0) < output.size);
+
+  t_outf("full link:        %llu us", full_time);
+  t_outf("incremental link: %llu us", inc_time);
+}
+
+internal B32
+t_order_write_funcs_obj(void)
+{
+  return t_write_def_obj("funcs.obj", (T_COFF_DefObj){
+    .machine = T_COFF_DefSetMachine(X64),
+    .sections = (T_COFF_DefSection[]){
+      {
+        "entry", ".text", str8_lit_comp("\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"), .flags = "rx:code@1",
+        .relocs = (T_COFF_DefReloc[]){
+          T_COFF_DefReloc(X64_Addr32Nb, 0,  "a"),
+          T_COFF_DefReloc(X64_Addr32Nb, 4,  "b"),
+          T_COFF_DefReloc(X64_Addr32Nb, 8,  "c"),
+          T_COFF_DefReloc(X64_Addr32Nb, 12, "d"),
+          {0}
+        }
+      },
+      { "a", ".text$mn", str8_lit_comp("\xAA"), .flags = "rx:code@1", .raw_flags = COFF_SectionFlag_LnkCOMDAT },
+      { "b", ".text$mn", str8_lit_comp("\xBB"), .flags = "rx:code@1", .raw_flags = COFF_SectionFlag_LnkCOMDAT },
+      { "c", ".text$mn", str8_lit_comp("\xCC"), .flags = "rx:code@1", .raw_flags = COFF_SectionFlag_LnkCOMDAT },
+      { "d", ".text$mn", str8_lit_comp("\xDD"), .flags = "rx:code@1", .raw_flags = COFF_SectionFlag_LnkCOMDAT },
+      {0}
+    },
+    .symbols = (T_COFF_DefSymbol[]){
+      T_COFF_DefSymbol_Secdef("a", COFF_ComdatSelect_NoDuplicates),
+      T_COFF_DefSymbol_Secdef("b", COFF_ComdatSelect_NoDuplicates),
+      T_COFF_DefSymbol_Secdef("c", COFF_ComdatSelect_NoDuplicates),
+      T_COFF_DefSymbol_Secdef("d", COFF_ComdatSelect_NoDuplicates),
+      T_COFF_DefSymbol_ExternFunc("a", "a", 0),
+      T_COFF_DefSymbol_ExternFunc("b", "b", 0),
+      T_COFF_DefSymbol_ExternFunc("c", "c", 0),
+      T_COFF_DefSymbol_ExternFunc("d", "d", 0),
+      T_COFF_DefSymbol_ExternFunc("entry", "entry", 0),
+      {0}
+    }
+  });
+}
+
+internal String8
+t_order_funcs_from_exe(Arena *arena, String8 exe_name)
+{
+  String8 exe = t_read_file(arena, exe_name);
+  if (exe.size == 0) { return str8_zero(); }
+
+  PE_BinInfo          pe            = pe_bin_info_from_data(arena, exe);
+  COFF_SectionHeader *section_table = (COFF_SectionHeader *)str8_substr(exe, pe.section_table_range).str;
+  String8             string_table  = str8_substr(exe, pe.string_table_range);
+  COFF_SectionHeader *text_sect     = coff_section_header_from_name(string_table, section_table, pe.section_count, str8_lit(".text"));
+  if (text_sect == 0) { return str8_zero(); }
+
+  // functions follow the entry since .text sorts before .text$mn
+  return str8_substr(exe, r1u64(text_sect->foff + 16, text_sect->foff + 20));
+}
+
+TEST(order_file)
+{
+  T_Ok(t_order_write_funcs_obj());
+  T_Ok(t_write_file(str8_lit("order.txt"), str8_lit("c\r\nd\n\n  a  \nmissing\n")));
+
+  t_invoke_linkerf("/subsystem:console /entry:entry /out:a.exe /order:@order.txt funcs.obj");
+  T_Ok(g_last_exit_code == 0);
+
+  // listed functions go first and the rest keep their input order
+  T_Ok(str8_match(t_order_funcs_from_exe(arena, str8_lit("a.exe")), str8_lit("\xCC\xDD\xAA\xBB"), 0));
+}
+
+TEST(order_profile)
+{
+  T_Ok(t_order_write_funcs_obj());
+  T_Ok(t_write_file(str8_lit("profile.txt"), str8_lit("# caller callee count\n"
+                                                      "a c 100\n"
+                                                      "c d 50\n"
+                                                      "# symbol count\n"
+                                                      "b 1000\n")));
+
+  t_invoke_linkerf("/subsystem:console /entry:entry /out:a.exe /rad_order_profile:profile.txt funcs.obj");
+  T_Ok(g_last_exit_code == 0);
+
+  // b is the densest cluster, then a with its callees chained after it
+  T_Ok(str8_match(t_order_funcs_from_exe(arena, str8_lit("a.exe")), str8_lit("\xBB\xAA\xCC\xDD"), 0));
+}
+
+TEST(lib_search_timing)
+{
+  // every member defines a few symbols and references a symbol in the next lib, entry obj references
+  // a symbol from each member, so thousands of undefined symbols are pending while libs are searched;
+  // "dup" and "dup_late" are defined in l1.lib and l4.lib, entry obj references "dup" and l2.lib
+  // references "dup_late", so it is still undefined when the search is past l1.lib
+  U64              libs_count    = 500;
+  U64              members_count = 8;
+  U64              symbols_count = 8;
+  COFF_MachineType machine       = COFF_MachineType_X64;
+  COFF_RelocType   addr64        = COFF_Reloc_X64_Addr64;
+  String8List      lib_names     = {0};
+  for EachIndex(lib_idx, libs_count) {
+    String8 lib_name = push_str8f(arena, "l%llu.lib", lib_idx);
+    str8_list_push(arena, &lib_names, lib_name);
+
+    Temp temp = temp_begin(arena);
+
+    B32                  is_last_lib = lib_idx + 1 == libs_count;
+    T_COFF_DefLibMember *members     = push_array(temp.arena, T_COFF_DefLibMember, members_count + 3);
+    for EachIndex(member_idx, members_count) {
+      T_COFF_DefSymbol *symbols = push_array(temp.arena, T_COFF_DefSymbol, symbols_count + 3);
+      for EachIndex(symbol_idx, symbols_count) {
+        char *name = (char *)push_str8f(temp.arena, "s%llu_%llu_%llu", lib_idx, member_idx, symbol_idx).str;
+        symbols[symbol_idx] = (T_COFF_DefSymbol)T_COFF_DefSymbol_Extern(name, "data", symbol_idx * 8);
+      }
+
+      T_COFF_DefReloc *relocs = 0;
+      if ( ! is_last_lib) {
+        char *next_name = (char *)push_str8f(temp.arena, "s%llu_%llu_1", lib_idx + 1, member_idx).str;
+        symbols[symbols_count] = (T_COFF_DefSymbol)T_COFF_DefSymbol_Undef(next_name);
+        relocs = push_array(temp.arena, T_COFF_DefReloc, 3);
+        relocs[0] = (T_COFF_DefReloc){ .type = &addr64, .apply_off = 0, .symbol = next_name };
+        if (lib_idx == 2 && member_idx == 0) {
+          symbols[symbols_count + 1] = (T_COFF_DefSymbol)T_COFF_DefSymbol_Undef("dup_late");
+          relocs[1] = (T_COFF_DefReloc){ .type = &addr64, .apply_off = 8, .symbol = "dup_late" };
+        }
+      }
+
+      T_COFF_DefSection *sections = push_array(temp.arena, T_COFF_DefSection, 2);
+      sections[0] = (T_COFF_DefSection){ "data", ".data", str8(push_array(temp.arena, U8, symbols_count * 8), symbols_count * 8), .flags = "rw:data@8", .relocs = relocs };
+
+      members[member_idx] = (T_COFF_DefLibMember){ .type = T_COFF_DefLibMember_Obj, .obj = { .machine = &machine, .sections = sections, .symbols = symbols } };
+    }
+
+    if (lib_idx == 1 || lib_idx == 4) {
+      char *dup_names[] = { "dup", "dup_late" };
+      U8    dup_tags[]  = { 0xD0, 0xE0 };
+      for EachElement(dup_idx, dup_names) {
+        T_COFF_DefSymbol *symbols = push_array(temp.arena, T_COFF_DefSymbol, 2);
+        symbols[0] = (T_COFF_DefSymbol)T_COFF_DefSymbol_Extern(dup_names[dup_idx], "data", 0);
+
+        // data tells which lib provided the symbol
+        U8 *dup_data = push_array(temp.arena, U8, 8);
+        MemorySet(dup_data, dup_tags[dup_idx] | (U8)lib_idx, 8);
+        T_COFF_DefSection *sections = push_array(temp.arena, T_COFF_DefSection, 2);
+        sections[0] = (T_COFF_DefSection){ "data", ".data", str8(dup_data, 8), .flags = "rw:data@8" };
+
+        members[members_count + dup_idx] = (T_COFF_DefLibMember){ .type = T_COFF_DefLibMember_Obj, .obj = { .machine = &machine, .sections = sections, .symbols = symbols } };
+      }
+    }
+
+    // odd libs have only the first linker member, which lists symbols unsorted
+    T_Ok(t_write_def_lib((char *)lib_name.str, (T_COFF_DefLib){ .emit_second_member = !(lib_idx & 1), .members = members }));
+
+    temp_end(temp);
+  }
+
+  {
+    U64               refs_count = libs_count * members_count + 1;
+    T_COFF_DefReloc  *relocs     = push_array(arena, T_COFF_DefReloc, refs_count + 1);
+    T_COFF_DefSymbol *symbols    = push_array(arena, T_COFF_DefSymbol, refs_count + 2);
+    symbols[0] = (T_COFF_DefSymbol)T_COFF_DefSymbol_Extern("entry", "text", 0);
+    for EachIndex(ref_idx, refs_count) {
+      char *name = ref_idx + 1 == refs_count ? "dup" : (char *)push_str8f(arena, "s%llu_%llu_0", ref_idx / members_count, ref_idx % members_count).str;
+      symbols[ref_idx + 1] = (T_COFF_DefSymbol)T_COFF_DefSymbol_Undef(name);
+      relocs[ref_idx]      = (T_COFF_DefReloc){ .type = &addr64, .apply_off = ref_idx * 8, .symbol = name };
+    }
+    T_Ok(t_write_def_obj("entry.obj", (T_COFF_DefObj){
+      .machine = &machine,
+      .sections = (T_COFF_DefSection[]){
+        { "text", ".text", str8_lit("\xC3"), .flags = "rx:code@16" },
+        { "data", ".data", str8(push_array(arena, U8, refs_count * 8), refs_count * 8), .flags = "rw:data@8", .relocs = relocs },
+        {0}
+      },
+      .symbols = symbols
+    }));
+  }
+
+  String8 libs_cmd_line = str8_list_join(arena, &lib_names, &(StringJoin){ .sep = str8_lit_comp(" ") });
+
+  U64 link_begin = now_time_us();
+  t_invoke_linkerf("/subsystem:console /entry:entry /out:a.exe /rad_time_stamp:0 entry.obj %S", libs_cmd_line);
+  U64 link_time = now_time_us() - link_begin;
+  T_Ok(g_last_exit_code == 0);
+
+  // search every lib for each undefined symbol, as the linker did before the archive symbol index
+  U64 ref_link_begin = now_time_us();
+  t_invoke_linkerf("/subsystem:console /entry:entry /out:b.exe /rad_time_stamp:0 /rad_lib_index:no entry.obj %S", libs_cmd_line);
+  U64 ref_link_time = now_time_us() - ref_link_begin;
+  T_Ok(g_last_exit_code == 0);
+
+  String8 exe = t_read_file(arena, str8_lit("a.exe"));
+  T_Ok(exe.size);
+  T_Ok(str8_match(t_read_file(arena, str8_lit("b.exe")), exe, 0));
+
+  // dup comes from l1.lib, the first lib that defines it; dup_late was referenced after l1.lib was
+  // searched, so it comes from the next lib in the link order that defines it
+  T_Ok(str8_find_needle(exe, 0, str8_lit("\xD1\xD1\xD1\xD1\xD1\xD1\xD1\xD1"), 0) <  exe.size);
+  T_Ok(str8_find_needle(exe, 0, str8_lit("\xD4\xD4\xD4\xD4\xD4\xD4\xD4\xD4"), 0) == exe.size);
+  T_Ok(str8_find_needle(exe, 0, str8_lit("\xE1\xE1\xE1\xE1\xE1\xE1\xE1\xE1"), 0) == exe.size);
+  T_Ok(str8_find_needle(exe, 0, str8_lit("\xE4\xE4\xE4\xE4\xE4\xE4\xE4\xE4"), 0) <  exe.size);
+
+  t_outf("libs: %llu, lib symbols: %llu", libs_count, libs_count * members_count * symbols_count);
+  t_outf("link: %llu us, without index: %llu us", link_time, ref_link_time);
+}
+
+
+TEST(lib_cache)
+{
+  U64              libs_count    = 300;
+  U64              symbols_count = 64;
+  COFF_MachineType machine       = COFF_MachineType_X64;
+  COFF_RelocType   addr64        = COFF_Reloc_X64_Addr64;
+  String8List      lib_names     = {0};
+  for EachIndex(lib_idx, libs_count) {
+    String8 lib_name = push_str8f(arena, "l%llu.lib", lib_idx);
+    str8_list_push(arena, &lib_names, lib_name);
+
+    Temp temp = temp_begin(arena);
+
+    T_COFF_DefSymbol *symbols = push_array(temp.arena, T_COFF_DefSymbol, symbols_count + 1);
+    for EachIndex(symbol_idx, symbols_count) {
+      char *name = (char *)push_str8f(temp.arena, "s%llu_%llu", lib_idx, symbol_idx).str;
+      symbols[symbol_idx] = (T_COFF_DefSymbol)T_COFF_DefSymbol_Extern(name, "data", symbol_idx * 8);
+    }
+    T_COFF_DefSection *sections = push_array(temp.arena, T_COFF_DefSection, 2);
+    sections[0] = (T_COFF_DefSection){ "data", ".data", str8(push_array(temp.arena, U8, symbols_count * 8), symbols_count * 8), .flags = "rw:data@8" };
+
+    T_COFF_DefLibMember *members = push_array(temp.arena, T_COFF_DefLibMember, 2);
+    members[0] = (T_COFF_DefLibMember){ .type = T_COFF_DefLibMember_Obj, .obj = { .machine = &machine, .sections = sections, .symbols = symbols } };
+
+    // odd libs have only the first linker member
+    T_Ok(t_write_def_lib((char *)lib_name.str, (T_COFF_DefLib){ .emit_second_member = !(lib_idx & 1), .members = members }));
+
+    temp_end(temp);
+  }
+
+  {
+    T_COFF_DefReloc  *relocs  = push_array(arena, T_COFF_DefReloc, libs_count + 1);
+    T_COFF_DefSymbol *symbols = push_array(arena, T_COFF_DefSymbol, libs_count + 2);
+    symbols[0] = (T_COFF_DefSymbol)T_COFF_DefSymbol_Extern("entry", "text", 0);
+    for EachIndex(lib_idx, libs_count) {
+      char *name = (char *)push_str8f(arena, "s%llu_%llu", lib_idx, lib_idx % symbols_count).str;
+      symbols[lib_idx + 1] = (T_COFF_DefSymbol)T_COFF_DefSymbol_Undef(name);
+      relocs[lib_idx]      = (T_COFF_DefReloc){ .type = &addr64, .apply_off = lib_idx * 8, .symbol = name };
+    }
+    T_Ok(t_write_def_obj("entry.obj", (T_COFF_DefObj){
+      .machine = &machine,
+      .sections = (T_COFF_DefSection[]){
+        { "text", ".text", str8_lit("\xC3"), .flags = "rx:code@16" },
+        { "data", ".data", str8(push_array(arena, U8, libs_count * 8), libs_count * 8), .flags = "rw:data@8", .relocs = relocs },
+        {0}
+      },
+      .symbols = symbols
+    }));
+  }
+
+  String8 libs_cmd_line = str8_list_join(arena, &lib_names, &(StringJoin){ .sep = str8_lit_comp(" ") });
+
+  // link without the cache for reference
+  t_invoke_linkerf("/subsystem:console /entry:entry /out:a.exe /rad_time_stamp:0 entry.obj %S", libs_cmd_line);
+  T_Ok(g_last_exit_code == 0);
+  String8 exe = t_read_file(arena, str8_lit("a.exe"));
+
+  // cold link populates the cache
+  U64 cold_begin = now_time_us();
+  t_invoke_linkerf("/subsystem:console /entry:entry /out:b.exe /rad_time_stamp:0 /rad_lib_cache:cache entry.obj %S", libs_cmd_line);
+  U64 cold_time = now_time_us() - cold_begin;
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_match(t_read_file(arena, str8_lit("b.exe")), exe, 0));
+
+  String8List cache_paths = {0};
+  {
+    String8   cache_dir = t_make_file_path(arena, str8_lit("cache"));
+    FileIter *iter      = file_iter_begin(arena, cache_dir, 0);
+    for (FileInfo info = {0}; file_iter_next(arena, iter, &info); ) {
+      T_Ok(str8_ends_with(info.name, str8_lit(".rlc"), 0));
+      str8_list_pushf(arena, &cache_paths, "%S/%S", cache_dir, info.name);
+    }
+    file_iter_end(iter);
+  }
+  T_Ok(cache_paths.node_count == libs_count);
+
+  // warm link reads indices from the cache
+  U64 warm_begin = now_time_us();
+  t_invoke_linkerf("/subsystem:console /entry:entry /out:c.exe /rad_time_stamp:0 /rad_lib_cache:cache entry.obj %S", libs_cmd_line);
+  U64 warm_time = now_time_us() - warm_begin;
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_match(t_read_file(arena, str8_lit("c.exe")), exe, 0));
+
+  // warm link with memory-mapped cache entries
+  U64 mapped_begin = now_time_us();
+  t_invoke_linkerf("/subsystem:console /entry:entry /out:d.exe /rad_time_stamp:0 /rad_lib_cache:cache /rad_memory_map_files entry.obj %S", libs_cmd_line);
+  U64 mapped_time = now_time_us() - mapped_begin;
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_match(t_read_file(arena, str8_lit("d.exe")), exe, 0));
+
+  // corrupt entries must be rejected and rebuilt
+  for EachNode(n, String8Node, cache_paths.first) {
+    T_Ok(write_data_to_file_path(n->string, str8_lit("garbage")));
+  }
+  t_invoke_linkerf("/subsystem:console /entry:entry /out:e.exe /rad_time_stamp:0 /rad_lib_cache:cache entry.obj %S", libs_cmd_line);
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_match(t_read_file(arena, str8_lit("e.exe")), exe, 0));
+  for EachNode(n, String8Node, cache_paths.first) {
+    T_Ok(!str8_match(data_from_file_path(arena, n->string), str8_lit("garbage"), 0));
+  }
+
+  // flip a bit without changing the size: low bit of the last symbol's name size, which is followed
+  // by the U16 symbol indices at the end of the entry; the name would still point into the lib, so only
+  // the payload hash can tell that the entry is damaged
+  String8List cache_entries = {0};
+  for EachNode(n, String8Node, cache_paths.first) {
+    String8 entry = data_from_file_path(arena, n->string);
+    T_Ok(entry.size > symbols_count * sizeof(U16) + sizeof(U32));
+    str8_list_push(arena, &cache_entries, entry);
+
+    String8 damaged = push_str8_copy(arena, entry);
+    damaged.str[damaged.size - symbols_count * sizeof(U16) - sizeof(U32)] ^= 1;
+    T_Ok(write_data_to_file_path(n->string, damaged));
+  }
+  t_invoke_linkerf("/subsystem:console /entry:entry /out:f.exe /rad_time_stamp:0 /rad_lib_cache:cache entry.obj %S", libs_cmd_line);
+  T_Ok(g_last_exit_code == 0);
+  T_Ok(str8_match(t_read_file(arena, str8_lit("f.exe")), exe, 0));
+  for (String8Node *path_n = cache_paths.first, *entry_n = cache_entries.first; path_n != 0; path_n = path_n->next, entry_n = entry_n->next) {
+    T_Ok(str8_match(data_from_file_path(arena, path_n->string), entry_n->string, 0));
+  }
+
+  t_outf("libs: %llu, lib symbols: %llu", libs_count, libs_count * symbols_count);
+  t_outf("cold: %llu us, warm: %llu us, warm mapped: %llu us", cold_time, warm_time, mapped_time);
+}
 #undef T_Group
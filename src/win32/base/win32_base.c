@@ -465,6 +465,12 @@ thread_detach(Thread thread)
   }
 }
 
+internal void
+thread_yield(void)
+{
+  SwitchToThread();
+}
+
 ////////////////////////////////
 //~ rjf: @os_hooks Safe Calls
 
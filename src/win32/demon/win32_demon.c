@@ -2919,6 +2919,30 @@ dmn_process_read(DMN_Handle process, Rng1U64 range, void *dst)
   return result;
 }
 
+internal U64
+dmn_process_read_many(DMN_Handle process, U64 count, Rng1U64 *ranges, void **dsts, U64 *read_sizes_out)
+{
+  U64 result = 0;
+  if(read_sizes_out)
+  {
+    MemoryZeroTyped(read_sizes_out, count);
+  }
+  DMN_AccessScope
+  {
+    W32_DMN_Entity *entity = w32_dmn_entity_from_handle(process);
+    for EachIndex(idx, count)
+    {
+      U64 read_size = w32_dmn_process_read(entity->handle, ranges[idx], dsts[idx]);
+      if(read_sizes_out)
+      {
+        read_sizes_out[idx] = read_size;
+      }
+      result += read_size;
+    }
+  }
+  return result;
+}
+
 internal B32
 dmn_process_write(DMN_Handle process, Rng1U64 range, void *src)
 {
@@ -2931,6 +2955,12 @@ dmn_process_write(DMN_Handle process, Rng1U64 range, void *src)
   return result;
 }
 
+internal U64
+dmn_process_memory_gen_from_range(DMN_Handle process, Rng1U64 range)
+{
+  return 0;
+}
+
 //- rjf: threads
 
 internal Arch
@@ -37,6 +37,7 @@ x64_dasm_inst_from_code(Arena *arena, U64 vaddr, String8  code, DASM_Syntax synt
   X64_RegCode dst_reg_code = 0;
   S64 src_reg_off = 0;
   S64 dst_reg_off = 0;
+  U32 rip_disp_off = 0;
   {
     //- rjf: unpack operands
     ZydisDecodedOperand *first_visible_op = (zinst.info.operand_count_visible > 0 ? &zinst.operands[0] : 0);
@@ -385,6 +386,10 @@ x64_dasm_inst_from_code(Arena *arena, U64 vaddr, String8  code, DASM_Syntax synt
         flags |= DASM_InstFlag_ChangesStackPointerVariably;
       }
     }
+    if(zinst.info.attributes & ZYDIS_ATTRIB_IS_RELATIVE && zinst.info.raw.disp.size != 0)
+    {
+      rip_disp_off = zinst.info.raw.disp.offset;
+    }
     if(zinst.info.attributes & (ZYDIS_ATTRIB_HAS_REP|
                                 ZYDIS_ATTRIB_HAS_REPE|
                                 ZYDIS_ATTRIB_HAS_REPZ|
@@ -463,6 +468,7 @@ x64_dasm_inst_from_code(Arena *arena, U64 vaddr, String8  code, DASM_Syntax synt
     inst.dst_reg_off     = dst_reg_off;
     inst.src_reg_code    = src_reg_code;
     inst.src_reg_off     = src_reg_off;
+    inst.rip_disp_off    = rip_disp_off;
   }
   
   return inst;
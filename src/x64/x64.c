@@ -195,3 +195,92 @@ x64_set_debug_break(U64 *drs, U64 trap_idx, U64 addr, U64 size, X64_BreakpointTy
     default: { InvalidPath; }
   }
 }
+
+////////////////////////////////
+//~ Condition Trampolines
+
+internal B32
+x64_write_rel32_jmp(U8 *dst, U64 src_vaddr, U64 dst_vaddr)
+{
+  S64 rel = (S64)(dst_vaddr - (src_vaddr + X64_COND_SITE_JMP_SIZE));
+  B32 fits = (rel == (S64)(S32)rel);
+  if(fits)
+  {
+    S32 rel32 = (S32)rel;
+    dst[0] = 0xE9;
+    MemoryCopy(dst+1, &rel32, sizeof(rel32));
+  }
+  return fits;
+}
+
+internal X64_CondTrampoline
+x64_cond_trampoline_from_code(Arena *arena, U64 vaddr, U64 site_vaddr, String8 site_inst, U32 site_inst_rip_disp_off, String8 condition_code)
+{
+  local_persist read_only U8 prologue[] =
+  {
+    0x48, 0x8D, 0x64, 0x24, 0x80,                   // lea rsp, [rsp-128]
+    0x9C,                                           // pushfq
+    0x50,                                           // push rax
+    0x51,                                           // push rcx
+    0x52,                                           // push rdx
+    0x48, 0x89, 0xE2,                               // mov rdx, rsp
+  };
+  local_persist read_only U8 epilogue[] =
+  {
+    0x48, 0x89, 0xD4,                               // mov rsp, rdx
+    0x48, 0x85, 0xC0,                               // test rax, rax
+    0x5A,                                           // pop rdx
+    0x59,                                           // pop rcx
+    0x58,                                           // pop rax
+    0x74, 0x0C,                                     // jz .false
+    0x9D,                                           // popfq
+    0x48, 0x8D, 0xA4, 0x24, 0x80, 0x00, 0x00, 0x00, // lea rsp, [rsp+128]
+    0xCC,                                           // int3
+    0xEB, 0x09,                                     // jmp .site_inst
+    0x9D,                                           // .false: popfq
+    0x48, 0x8D, 0xA4, 0x24, 0x80, 0x00, 0x00, 0x00, // lea rsp, [rsp+128]
+  };
+  U64 epilogue_trap_off = 20;
+  
+  //- lay out prologue, condition, epilogue, relocated site instruction, & jump back
+  U64 cond_off = sizeof(prologue);
+  U64 epilogue_off = cond_off + condition_code.size;
+  U64 site_inst_off = epilogue_off + sizeof(epilogue);
+  U64 jmp_off = site_inst_off + site_inst.size;
+  U64 size = jmp_off + X64_COND_SITE_JMP_SIZE;
+  U8 *code = push_array(arena, U8, size);
+  MemoryCopy(code, prologue, sizeof(prologue));
+  MemoryCopy(code + cond_off, condition_code.str, condition_code.size);
+  MemoryCopy(code + epilogue_off, epilogue, sizeof(epilogue));
+  MemoryCopy(code + site_inst_off, site_inst.str, site_inst.size);
+  B32 good = (condition_code.size != 0 && site_inst.size != 0);
+  
+  //- rebase the site instruction's rip-relative displacement, if it has one
+  if(good && site_inst_rip_disp_off != 0)
+  {
+    good = (site_inst_rip_disp_off + sizeof(S32) <= site_inst.size);
+    if(good)
+    {
+      U8 *disp_ptr = code + site_inst_off + site_inst_rip_disp_off;
+      S32 disp = 0;
+      MemoryCopy(&disp, disp_ptr, sizeof(disp));
+      S64 new_disp = (S64)disp + (S64)(site_vaddr - (vaddr + site_inst_off));
+      good = (new_disp == (S64)(S32)new_disp);
+      S32 new_disp32 = (S32)new_disp;
+      MemoryCopy(disp_ptr, &new_disp32, sizeof(new_disp32));
+    }
+  }
+  
+  //- jump back to the instruction after the site
+  good = good && x64_write_rel32_jmp(code + jmp_off, vaddr + jmp_off, site_vaddr + site_inst.size);
+  
+  X64_CondTrampoline result = {0};
+  if(good)
+  {
+    result.code                = str8(code, size);
+    result.cond_off_range      = r1u64(cond_off, epilogue_off);
+    result.trap_off            = epilogue_off + epilogue_trap_off;
+    result.site_inst_off_range = r1u64(site_inst_off, jmp_off);
+  }
+  return result;
+}
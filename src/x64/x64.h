@@ -209,6 +209,36 @@ typedef enum X64_DebugControlFlags
 }
 X64_DebugControlFlags;
 
+////////////////////////////////
+//~ Condition Trampolines
+//
+// A condition trampoline stands in for one instruction at a breakpoint site,
+// which is overwritten with a 5-byte `jmp`. It skips the red zone, saves the
+// registers & flags which condition code may clobber, & runs the condition.
+// If the condition is nonzero, it executes an `int3`. Either way, it then
+// executes a relocated copy of the site's instruction, & jumps back to the
+// instruction following the site.
+//
+// Condition code is entered with rsp == rdx, pointing at the saved frame. It
+// may clobber rax & rcx, & push/pop on the stack, but must leave rdx & all
+// other registers intact, & leave its result in rax.
+
+#define X64_COND_FRAME_OFF_RDX    0
+#define X64_COND_FRAME_OFF_RCX    8
+#define X64_COND_FRAME_OFF_RAX    16
+#define X64_COND_FRAME_OFF_RFLAGS 24
+#define X64_COND_FRAME_OFF_RSP    (32 + 128)
+#define X64_COND_SITE_JMP_SIZE    5
+
+typedef struct X64_CondTrampoline X64_CondTrampoline;
+struct X64_CondTrampoline
+{
+  String8 code;
+  Rng1U64 cond_off_range; // condition code; rdx points at the saved frame
+  U64 trap_off;           // `int3`, executed when the condition is nonzero
+  Rng1U64 site_inst_off_range;
+};
+
 ////////////////////////////////
 //~ rjf: Generated
 
@@ -234,4 +264,10 @@ internal X64_XSaveLayout x64_get_xsave_layout(U64 xcr0);
 
 internal void x64_set_debug_break(U64 *drs, U64 trap_idx, U64 addr, U64 size, X64_BreakpointType bp_type, X64_DebugBreakType break_type);
 
+////////////////////////////////
+//~ Condition Trampolines
+
+internal B32 x64_write_rel32_jmp(U8 *dst, U64 src_vaddr, U64 dst_vaddr);
+internal X64_CondTrampoline x64_cond_trampoline_from_code(Arena *arena, U64 vaddr, U64 site_vaddr, String8 site_inst, U32 site_inst_rip_disp_off, String8 condition_code);
+
 #endif // BASE_X64_H
@@ -0,0 +1,895 @@
+// Copyright (c) Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+////////////////////////////////
+//~ Predefined Tables
+
+global read_only S16 zstd_ll_default_counts[36] =
+{
+  4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+  -1, -1, -1, -1,
+};
+
+global read_only S16 zstd_ml_default_counts[53] =
+{
+  1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+  -1, -1, -1, -1, -1,
+};
+
+global read_only S16 zstd_of_default_counts[29] =
+{
+  1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1,
+};
+
+global read_only U32 zstd_ll_bases[36] =
+{
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+  16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048, 4096,
+  8192, 16384, 32768, 65536,
+};
+
+global read_only U8 zstd_ll_extra_bits[36] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+  13, 14, 15, 16,
+};
+
+global read_only U32 zstd_ml_bases[53] =
+{
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+  19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+  35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027, 2051,
+  4099, 8195, 16387, 32771, 65539,
+};
+
+global read_only U8 zstd_ml_extra_bits[53] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+  12, 13, 14, 15, 16,
+};
+
+////////////////////////////////
+//~ Bitstream Functions
+
+internal U64
+zstd_fwd_bit_reader_peek(ZSTD_FwdBitReader *r, U64 bit_count)
+{
+  U64 bits = 0;
+  U64 byte_idx = r->bit_off >> 3;
+  if(byte_idx < r->data.size)
+  {
+    MemoryCopy(&bits, r->data.str + byte_idx, Min(sizeof(bits), r->data.size - byte_idx));
+  }
+  U64 result = (bits >> (r->bit_off & 7)) & ((1ull << bit_count) - 1);
+  return result;
+}
+
+internal U64
+zstd_fwd_bit_reader_read(ZSTD_FwdBitReader *r, U64 bit_count)
+{
+  U64 result = zstd_fwd_bit_reader_peek(r, bit_count);
+  r->bit_off += bit_count;
+  return result;
+}
+
+internal ZSTD_BwdBitReader
+zstd_bwd_bit_reader_from_data(String8 data)
+{
+  ZSTD_BwdBitReader r = {data, -1};
+  if(data.size != 0 && data.str[data.size-1] != 0)
+  {
+    r.bits_left = (S64)(data.size-1)*8 + (31 - clz32(data.str[data.size-1]));
+  }
+  return r;
+}
+
+internal U64
+zstd_bwd_bit_reader_peek(ZSTD_BwdBitReader *r, U64 bit_count)
+{
+  U64 result = 0;
+  S64 lo_bit_off = r->bits_left - (S64)bit_count;
+  if(bit_count == 0)
+  {
+    // NOTE: nothing to read
+  }
+  else if(lo_bit_off >= 0)
+  {
+    U64 bits = 0;
+    U64 byte_idx = (U64)lo_bit_off >> 3;
+    if(byte_idx + sizeof(bits) <= r->data.size)
+    {
+      MemoryCopy(&bits, r->data.str + byte_idx, sizeof(bits));
+    }
+    else
+    {
+      MemoryCopy(&bits, r->data.str + byte_idx, r->data.size - byte_idx);
+    }
+    result = (bits >> (lo_bit_off & 7)) & ((1ull << bit_count) - 1);
+  }
+  else if(r->bits_left > 0)
+  {
+    U64 bits = 0;
+    MemoryCopy(&bits, r->data.str, Min(sizeof(bits), r->data.size));
+    result = (bits & ((1ull << r->bits_left) - 1)) << (-lo_bit_off);
+  }
+  return result;
+}
+
+internal U64
+zstd_bwd_bit_reader_read(ZSTD_BwdBitReader *r, U64 bit_count)
+{
+  U64 result = zstd_bwd_bit_reader_peek(r, bit_count);
+  r->bits_left -= (S64)bit_count;
+  return result;
+}
+
+////////////////////////////////
+//~ Table Building Functions
+
+internal B32
+zstd_fse_table_fill_from_counts(ZSTD_FSETable *table, S16 *counts, U64 symbol_count, U32 accuracy_log)
+{
+  B32 good = (accuracy_log <= ZSTD_FSE_MAX_ACCURACY_LOG && symbol_count <= ZSTD_FSE_MAX_SYMBOL_COUNT);
+  U32 table_size = (1u << accuracy_log);
+  U32 high_idx = table_size-1;
+  U32 next_states[ZSTD_FSE_MAX_SYMBOL_COUNT] = {0};
+  
+  //- place "less than 1" probability symbols at the end of the table
+  for(U64 symbol = 0; good && symbol < symbol_count; symbol += 1)
+  {
+    if(counts[symbol] == -1)
+    {
+      good = (high_idx != 0);
+      table->v[high_idx].symbol = (U8)symbol;
+      high_idx -= 1;
+      next_states[symbol] = 1;
+    }
+    else
+    {
+      next_states[symbol] = (U32)counts[symbol];
+    }
+  }
+  
+  //- spread all other symbols across the rest of the table
+  if(good)
+  {
+    U32 pos = 0;
+    U32 step = (table_size >> 1) + (table_size >> 3) + 3;
+    for EachIndex(symbol, symbol_count)
+    {
+      for(S32 idx = 0; idx < counts[symbol]; idx += 1)
+      {
+        table->v[pos].symbol = (U8)symbol;
+        do
+        {
+          pos = (pos + step) & (table_size-1);
+        } while(pos > high_idx);
+      }
+    }
+    good = (pos == 0);
+  }
+  
+  //- compute each state's successor range
+  if(good)
+  {
+    for EachIndex(idx, table_size)
+    {
+      ZSTD_FSEEntry *entry = &table->v[idx];
+      U32 next_state = next_states[entry->symbol]++;
+      U32 bits = accuracy_log - (31 - (U32)clz32(next_state));
+      entry->bits = (U8)bits;
+      entry->base = (U16)((next_state << bits) - table_size);
+    }
+    table->accuracy_log = accuracy_log;
+  }
+  return good;
+}
+
+internal U64
+zstd_fse_table_fill_from_data(ZSTD_FSETable *table, String8 data, U64 max_symbol_count, U32 max_accuracy_log)
+{
+  // NOTE: returns the # of bytes which describe the table, or 0 if malformed
+  U64 result = 0;
+  ZSTD_FwdBitReader r = {data};
+  U32 accuracy_log = (U32)zstd_fwd_bit_reader_read(&r, 4) + 5;
+  if(accuracy_log <= max_accuracy_log)
+  {
+    S16 counts[ZSTD_FSE_MAX_SYMBOL_COUNT] = {0};
+    S32 remaining = (1 << accuracy_log) + 1;
+    S32 threshold = (1 << accuracy_log);
+    U32 bit_count = accuracy_log+1;
+    U64 symbol_count = 0;
+    B32 good = 1;
+    for(;good && remaining > 1 && symbol_count < max_symbol_count;)
+    {
+      // read value; small values are read with one bit fewer
+      S32 max = (2*threshold - 1) - remaining;
+      S32 value = (S32)zstd_fwd_bit_reader_peek(&r, bit_count);
+      if((value & (threshold-1)) < max)
+      {
+        value &= (threshold-1);
+        r.bit_off += bit_count-1;
+      }
+      else
+      {
+        if(value >= threshold)
+        {
+          value -= max;
+        }
+        r.bit_off += bit_count;
+      }
+      
+      // store count; a count of 0 is followed by a # of repeated zeroes
+      S32 count = value - 1;
+      counts[symbol_count] = (S16)count;
+      symbol_count += 1;
+      remaining -= (count < 0 ? -count : count);
+      if(count == 0)
+      {
+        for(U64 repeat = 3; repeat == 3;)
+        {
+          repeat = zstd_fwd_bit_reader_read(&r, 2);
+          good = (symbol_count + repeat <= max_symbol_count);
+          symbol_count += repeat;
+          if(!good) { break; }
+        }
+      }
+      for(;remaining < threshold;)
+      {
+        bit_count -= 1;
+        threshold >>= 1;
+      }
+    }
+    U64 size = (r.bit_off + 7) / 8;
+    if(good && remaining == 1 && size <= data.size &&
+       zstd_fse_table_fill_from_counts(table, counts, symbol_count, accuracy_log))
+    {
+      result = size;
+    }
+  }
+  return result;
+}
+
+internal U64
+zstd_huff_table_fill_from_data(ZSTD_HuffTable *table, String8 data)
+{
+  // NOTE: returns the # of bytes which describe the table, or 0 if malformed
+  U64 result = 0;
+  U8 weights[ZSTD_HUFF_MAX_SYMBOL_COUNT] = {0};
+  U64 weights_count = 0;
+  
+  //- read weights of all but the last symbol, either as 4 bits each, or
+  // FSE-compressed, decoded by two interleaved states
+  if(data.size != 0 && data.str[0] >= 128)
+  {
+    weights_count = data.str[0] - 127;
+    U64 size = 1 + (weights_count+1)/2;
+    if(size <= data.size)
+    {
+      for EachIndex(idx, weights_count)
+      {
+        U8 byte = data.str[1 + idx/2];
+        weights[idx] = (idx%2 == 0 ? byte >> 4 : byte & 0xf);
+      }
+      result = size;
+    }
+  }
+  else if(data.size != 0 && 1 + (U64)data.str[0] <= data.size)
+  {
+    String8 compressed = str8_substr(data, r1u64(1, 1 + data.str[0]));
+    ZSTD_FSETable fse = {0};
+    U64 fse_size = zstd_fse_table_fill_from_data(&fse, compressed, 12, 6);
+    if(fse_size != 0 && fse_size < compressed.size)
+    {
+      ZSTD_BwdBitReader r = zstd_bwd_bit_reader_from_data(str8_skip(compressed, fse_size));
+      U32 states[2] = {0};
+      states[0] = (U32)zstd_bwd_bit_reader_read(&r, fse.accuracy_log);
+      states[1] = (U32)zstd_bwd_bit_reader_read(&r, fse.accuracy_log);
+      B32 good = (r.bits_left >= 0);
+      for(U64 state_idx = 0; good; state_idx ^= 1)
+      {
+        ZSTD_FSEEntry *entry = &fse.v[states[state_idx]];
+        weights[weights_count] = entry->symbol;
+        weights_count += 1;
+        states[state_idx] = entry->base + (U32)zstd_bwd_bit_reader_read(&r, entry->bits);
+        if(r.bits_left < 0)
+        {
+          // stream is done -> the other state has one more weight
+          good = (weights_count < ZSTD_HUFF_MAX_SYMBOL_COUNT-1);
+          if(good)
+          {
+            weights[weights_count] = fse.v[states[state_idx^1]].symbol;
+            weights_count += 1;
+          }
+          break;
+        }
+        good = (weights_count < ZSTD_HUFF_MAX_SYMBOL_COUNT-2);
+      }
+      if(good)
+      {
+        result = compressed.size + 1;
+      }
+    }
+  }
+  
+  //- derive last symbol's weight, which completes the sum of 2^(weight-1)
+  // to a power of 2
+  U32 max_bits = 0;
+  if(result != 0)
+  {
+    U32 total = 0;
+    for EachIndex(idx, weights_count)
+    {
+      if(weights[idx] > ZSTD_HUFF_MAX_BITS)
+      {
+        result = 0;
+        break;
+      }
+      total += (weights[idx] ? (1u << (weights[idx]-1)) : 0);
+    }
+    if(result != 0 && total != 0)
+    {
+      max_bits = (31 - (U32)clz32(total)) + 1;
+      U32 rest = (1u << max_bits) - total;
+      if(max_bits <= ZSTD_HUFF_MAX_BITS && (rest & (rest-1)) == 0 && weights_count < ZSTD_HUFF_MAX_SYMBOL_COUNT)
+      {
+        weights[weights_count] = (U8)((31 - clz32(rest)) + 1);
+        weights_count += 1;
+      }
+      else
+      {
+        result = 0;
+      }
+    }
+    else
+    {
+      result = 0;
+    }
+  }
+  
+  //- fill table; codes are assigned from the lowest weight (longest code) up,
+  // & in symbol order within each weight
+  if(result != 0)
+  {
+    U32 weight_starts[ZSTD_HUFF_MAX_BITS+2] = {0};
+    for EachIndex(idx, weights_count)
+    {
+      if(weights[idx] != 0)
+      {
+        weight_starts[weights[idx]+1] += (1u << (weights[idx]-1));
+      }
+    }
+    for(U32 weight = 1; weight <= max_bits; weight += 1)
+    {
+      weight_starts[weight+1] += weight_starts[weight];
+    }
+    for EachIndex(idx, weights_count)
+    {
+      U8 weight = weights[idx];
+      if(weight != 0)
+      {
+        ZSTD_HuffEntry entry = {(U8)idx, (U8)(max_bits + 1 - weight)};
+        U32 entry_count = (1u << (weight-1));
+        for EachIndex(entry_idx, entry_count)
+        {
+          table->v[weight_starts[weight] + entry_idx] = entry;
+        }
+        weight_starts[weight] += entry_count;
+      }
+    }
+    table->max_bits = max_bits;
+  }
+  return result;
+}
+
+internal B32
+zstd_huff_stream_decode(ZSTD_HuffTable *table, String8 stream, U8 *out, U64 count)
+{
+  ZSTD_BwdBitReader r = zstd_bwd_bit_reader_from_data(stream);
+  U32 max_bits = table->max_bits;
+  U64 idx = 0;
+  
+  //- decode 4 symbols per load, while at least 57 bits are left
+  for(;idx+4 <= count && r.bits_left >= 57;)
+  {
+    U64 load_end = ((U64)r.bits_left + 7) >> 3;
+    U64 bits = 0;
+    MemoryCopy(&bits, r.data.str + load_end - 8, sizeof(bits));
+    U64 bits_avail = 64 - (load_end*8 - (U64)r.bits_left);
+    bits <<= (64 - bits_avail);
+    U64 bits_used = 0;
+    for EachIndex(n, 4)
+    {
+      ZSTD_HuffEntry entry = table->v[bits >> (64 - max_bits)];
+      out[idx+n] = entry.symbol;
+      bits <<= entry.bits;
+      bits_used += entry.bits;
+    }
+    r.bits_left -= (S64)bits_used;
+    idx += 4;
+  }
+  
+  //- decode remaining symbols one at a time
+  for(;idx < count; idx += 1)
+  {
+    ZSTD_HuffEntry entry = table->v[zstd_bwd_bit_reader_peek(&r, max_bits)];
+    out[idx] = entry.symbol;
+    r.bits_left -= entry.bits;
+  }
+  B32 result = (r.bits_left == 0);
+  return result;
+}
+
+////////////////////////////////
+//~ Decoding Functions
+
+internal ZSTD_FrameHeader
+zstd_frame_header_from_data(String8 data)
+{
+  // NOTE: `header_size` is 0 if `data` doesn't start with a valid frame header
+  ZSTD_FrameHeader header = {0};
+  U32 magic = 0;
+  str8_deserial_read_struct(data, 0, &magic);
+  if(magic == ZSTD_MAGIC && data.size > 4)
+  {
+    U8 descriptor = data.str[4];
+    U64 content_size_flag   = (descriptor >> 6);
+    B32 is_single_segment   = (descriptor >> 5) & 1;
+    B32 reserved_bit        = (descriptor >> 3) & 1;
+    U64 dict_id_flag        = (descriptor & 3);
+    U64 window_desc_size    = !is_single_segment;
+    U64 dict_id_size        = (dict_id_flag == 3 ? 4 : dict_id_flag);
+    U64 content_size_size   = (content_size_flag == 0 ? is_single_segment : 1ull << content_size_flag);
+    U64 off = 5;
+    if(!reserved_bit && off + window_desc_size + dict_id_size + content_size_size <= data.size)
+    {
+      header.has_checksum = (descriptor >> 2) & 1;
+      if(window_desc_size != 0)
+      {
+        U8 window_desc = data.str[off];
+        U64 window_base = 1ull << (10 + (window_desc >> 3));
+        header.window_size = window_base + (window_base/8)*(window_desc & 7);
+        off += 1;
+      }
+      MemoryCopy(&header.dict_id, data.str + off, dict_id_size);
+      off += dict_id_size;
+      MemoryCopy(&header.content_size, data.str + off, content_size_size);
+      off += content_size_size;
+      if(content_size_size == 2)
+      {
+        header.content_size += 256;
+      }
+      header.has_content_size = (content_size_size != 0);
+      if(is_single_segment)
+      {
+        header.window_size = header.content_size;
+      }
+      header.header_size = off;
+    }
+  }
+  return header;
+}
+
+internal B32
+zstd_block_decompress(ZSTD_FrameState *state, String8 block, U8 *dst, U64 dst_size, U64 frame_off, U64 *dst_off_out)
+{
+  B32 good = (block.size != 0);
+  U64 off = 0;
+  
+  //////////////////////////////
+  //- decode literals
+  //
+  U8 *literals = state->literals;
+  U64 literals_count = 0;
+  if(good)
+  {
+    ZSTD_LiteralsKind kind = (ZSTD_LiteralsKind)(block.str[0] & 3);
+    U64 size_format = (block.str[0] >> 2) & 3;
+    switch(kind)
+    {
+      //- raw/RLE: 1-3 byte header, holding the # of literals
+      case ZSTD_LiteralsKind_Raw:
+      case ZSTD_LiteralsKind_RLE:
+      {
+        U64 header_size = (size_format == 1 ? 2 : size_format == 3 ? 3 : 1);
+        U64 header = 0;
+        good = (header_size <= block.size);
+        if(good)
+        {
+          MemoryCopy(&header, block.str, header_size);
+          literals_count = (header_size == 1 ? header >> 3 : header >> 4);
+          off = header_size;
+        }
+        if(good && kind == ZSTD_LiteralsKind_Raw)
+        {
+          good = (off + literals_count <= block.size);
+          literals = block.str + off;
+          off += literals_count;
+        }
+        else if(good && kind == ZSTD_LiteralsKind_RLE)
+        {
+          good = (off + 1 <= block.size && literals_count <= ZSTD_BLOCK_SIZE_MAX);
+          if(good)
+          {
+            MemorySet(literals, block.str[off], literals_count);
+            off += 1;
+          }
+        }
+      }break;
+      
+      //- compressed: 3-5 byte header, holding the # of literals & the size of
+      // their 1 or 4 Huffman-coded streams, which may be preceded by a table
+      case ZSTD_LiteralsKind_Compressed:
+      case ZSTD_LiteralsKind_Treeless:
+      {
+        U64 streams_count = (size_format == 0 ? 1 : 4);
+        U64 header_size = (size_format <= 1 ? 3 : size_format + 2);
+        U64 size_bits = (size_format <= 1 ? 10 : size_format == 2 ? 14 : 18);
+        U64 header = 0;
+        U64 compressed_size = 0;
+        good = (header_size <= block.size);
+        if(good)
+        {
+          MemoryCopy(&header, block.str, header_size);
+          literals_count  = (header >> 4) & ((1ull << size_bits) - 1);
+          compressed_size = (header >> (4 + size_bits)) & ((1ull << size_bits) - 1);
+          off = header_size;
+          good = (off + compressed_size <= block.size && literals_count <= ZSTD_BLOCK_SIZE_MAX);
+        }
+        String8 compressed = str8_substr(block, r1u64(off, off + compressed_size));
+        off += compressed_size;
+        if(good && kind == ZSTD_LiteralsKind_Compressed)
+        {
+          U64 table_size = zstd_huff_table_fill_from_data(&state->huff, compressed);
+          state->has_huff = (table_size != 0);
+          compressed = str8_skip(compressed, table_size);
+        }
+        good = (good && state->has_huff);
+        if(good && streams_count == 1)
+        {
+          good = zstd_huff_stream_decode(&state->huff, compressed, literals, literals_count);
+        }
+        else if(good)
+        {
+          U16 stream_sizes[3] = {0};
+          U64 segment_size = (literals_count+3)/4;
+          good = (compressed.size >= sizeof(stream_sizes) && segment_size*3 <= literals_count);
+          if(good)
+          {
+            MemoryCopy(stream_sizes, compressed.str, sizeof(stream_sizes));
+            compressed = str8_skip(compressed, sizeof(stream_sizes));
+          }
+          for(U64 stream_idx = 0; good && stream_idx < 4; stream_idx += 1)
+          {
+            U64 stream_size = (stream_idx < 3 ? stream_sizes[stream_idx] : compressed.size);
+            U64 stream_literals_count = (stream_idx < 3 ? segment_size : literals_count - segment_size*3);
+            good = (stream_size <= compressed.size &&
+                    zstd_huff_stream_decode(&state->huff, str8_prefix(compressed, stream_size), literals + segment_size*stream_idx, stream_literals_count));
+            compressed = str8_skip(compressed, stream_size);
+          }
+        }
+      }break;
+    }
+  }
+  
+  //////////////////////////////
+  //- decode sequences header: # of sequences, & the table for each of literal
+  // lengths, offsets, & match lengths
+  //
+  U64 sequences_count = 0;
+  if(good && off < block.size)
+  {
+    U8 *b = block.str + off;
+    U64 avail = block.size - off;
+    if(b[0] < 128)
+    {
+      sequences_count = b[0];
+      off += 1;
+    }
+    else if(b[0] < 255)
+    {
+      good = (avail >= 2);
+      sequences_count = good ? (((U64)b[0] - 128) << 8) + b[1] : 0;
+      off += 2;
+    }
+    else
+    {
+      good = (avail >= 3);
+      sequences_count = good ? b[1] + ((U64)b[2] << 8) + 0x7f00 : 0;
+      off += 3;
+    }
+  }
+  if(good && sequences_count != 0)
+  {
+    good = (off < block.size);
+    U8 modes = good ? block.str[off] : 0;
+    off += 1;
+    good = (good && (modes & 3) == 0);
+    struct
+    {
+      ZSTD_FSETable *table;
+      ZSTD_SeqMode mode;
+      S16 *default_counts;
+      U64 default_counts_count;
+      U32 default_accuracy_log;
+      U64 max_symbol_count;
+      U32 max_accuracy_log;
+    }
+    table_params[] =
+    {
+      {&state->ll, (ZSTD_SeqMode)((modes >> 6) & 3), zstd_ll_default_counts, ArrayCount(zstd_ll_default_counts), 6, 36, 9},
+      {&state->of, (ZSTD_SeqMode)((modes >> 4) & 3), zstd_of_default_counts, ArrayCount(zstd_of_default_counts), 5, 32, 8},
+      {&state->ml, (ZSTD_SeqMode)((modes >> 2) & 3), zstd_ml_default_counts, ArrayCount(zstd_ml_default_counts), 6, 53, 9},
+    };
+    for(U64 idx = 0; good && idx < ArrayCount(table_params); idx += 1)
+    {
+      switch(table_params[idx].mode)
+      {
+        case ZSTD_SeqMode_Predefined:
+        {
+          good = zstd_fse_table_fill_from_counts(table_params[idx].table, table_params[idx].default_counts, table_params[idx].default_counts_count, table_params[idx].default_accuracy_log);
+        }break;
+        case ZSTD_SeqMode_RLE:
+        {
+          good = (off < block.size && block.str[off] < table_params[idx].max_symbol_count);
+          if(good)
+          {
+            ZSTD_FSEEntry entry = {0, block.str[off], 0};
+            table_params[idx].table->accuracy_log = 0;
+            table_params[idx].table->v[0] = entry;
+            off += 1;
+          }
+        }break;
+        case ZSTD_SeqMode_Compressed:
+        {
+          U64 table_size = zstd_fse_table_fill_from_data(table_params[idx].table, str8_skip(block, off), table_params[idx].max_symbol_count, table_params[idx].max_accuracy_log);
+          good = (table_size != 0);
+          off += table_size;
+        }break;
+        case ZSTD_SeqMode_Repeat:{}break;
+      }
+    }
+  }
+  
+  //////////////////////////////
+  //- decode & execute sequences: copy literals, then copy a match from
+  // earlier output
+  //
+  U8 *out       = dst + *dst_off_out;
+  U8 *out_first = dst + frame_off;
+  U8 *out_opl   = dst + dst_size;
+  U8 *lit       = literals;
+  U8 *lit_opl   = literals + literals_count;
+  if(good && sequences_count != 0)
+  {
+    ZSTD_BwdBitReader r = zstd_bwd_bit_reader_from_data(str8_skip(block, off));
+    U32 ll_state = (U32)zstd_bwd_bit_reader_read(&r, state->ll.accuracy_log);
+    U32 of_state = (U32)zstd_bwd_bit_reader_read(&r, state->of.accuracy_log);
+    U32 ml_state = (U32)zstd_bwd_bit_reader_read(&r, state->ml.accuracy_log);
+    U64 *rep = state->rep;
+    for(U64 seq_idx = 0; good && seq_idx < sequences_count; seq_idx += 1)
+    {
+      //- decode lengths & offset
+      ZSTD_FSEEntry ll_entry = state->ll.v[ll_state];
+      ZSTD_FSEEntry of_entry = state->of.v[of_state];
+      ZSTD_FSEEntry ml_entry = state->ml.v[ml_state];
+      U64 offset_value = (1ull << of_entry.symbol) + zstd_bwd_bit_reader_read(&r, of_entry.symbol);
+      U64 ml = zstd_ml_bases[ml_entry.symbol] + zstd_bwd_bit_reader_read(&r, zstd_ml_extra_bits[ml_entry.symbol]);
+      U64 ll = zstd_ll_bases[ll_entry.symbol] + zstd_bwd_bit_reader_read(&r, zstd_ll_extra_bits[ll_entry.symbol]);
+      
+      //- offset values 1-3 select a repeated offset, shifted by one if there
+      // are no literals; others are new offsets
+      U64 offset = 0;
+      if(offset_value > 3)
+      {
+        offset = offset_value - 3;
+        rep[2] = rep[1];
+        rep[1] = rep[0];
+        rep[0] = offset;
+      }
+      else
+      {
+        U64 rep_idx = offset_value - 1 + (ll == 0);
+        if(rep_idx == 0)
+        {
+          offset = rep[0];
+        }
+        else
+        {
+          offset = (rep_idx == 3 ? rep[0] - 1 : rep[rep_idx]);
+          if(rep_idx != 1)
+          {
+            rep[2] = rep[1];
+          }
+          rep[1] = rep[0];
+          rep[0] = offset;
+        }
+      }
+      
+      //- advance states
+      if(seq_idx+1 < sequences_count)
+      {
+        ll_state = ll_entry.base + (U32)zstd_bwd_bit_reader_read(&r, ll_entry.bits);
+        ml_state = ml_entry.base + (U32)zstd_bwd_bit_reader_read(&r, ml_entry.bits);
+        of_state = of_entry.base + (U32)zstd_bwd_bit_reader_read(&r, of_entry.bits);
+      }
+      
+      //- execute
+      good = (ll <= (U64)(lit_opl - lit) &&
+              ll + ml <= (U64)(out_opl - out) &&
+              offset != 0 && offset <= (U64)(out + ll - out_first));
+      if(good)
+      {
+        // NOTE: most literal runs & matches are short, so when there is room
+        // past their ends, they're copied in 16 byte pieces, which may write
+        // past the end (to be overwritten later)
+        B32 has_slack = (ll + ml + 16 <= (U64)(out_opl - out));
+        if(has_slack && ll <= 16 && lit + 16 <= lit_opl)
+        {
+          MemoryCopy(out, lit, 16);
+        }
+        else
+        {
+          MemoryCopy(out, lit, ll);
+        }
+        out += ll;
+        lit += ll;
+        U8 *match = out - offset;
+        if(has_slack && offset >= 16)
+        {
+          for(U64 copied = 0; copied < ml; copied += 16)
+          {
+            MemoryCopy(out + copied, match + copied, 16);
+          }
+        }
+        else if(offset == 1)
+        {
+          MemorySet(out, match[0], ml);
+        }
+        else
+        {
+          // NOTE: copy in pieces no longer than the offset, so that no piece
+          // overlaps its source
+          for(U64 copied = 0, piece_size = 0; copied < ml; copied += piece_size)
+          {
+            piece_size = Min(offset, ml - copied);
+            MemoryCopy(out + copied, match + copied, piece_size);
+          }
+        }
+        out += ml;
+      }
+    }
+    good = (good && r.bits_left == 0);
+  }
+  
+  //- copy last literals
+  if(good)
+  {
+    U64 rest = (U64)(lit_opl - lit);
+    good = (rest <= (U64)(out_opl - out));
+    if(good)
+    {
+      MemoryCopy(out, lit, rest);
+      out += rest;
+    }
+  }
+  
+  *dst_off_out = (U64)(out - dst);
+  return good;
+}
+
+internal U64
+zstd_decompress(U8 *dst, U64 dst_size, String8 src)
+{
+  ProfBeginFunction();
+  Temp scratch = scratch_begin(0, 0);
+  ZSTD_FrameState *state = push_array_no_zero(scratch.arena, ZSTD_FrameState, 1);
+  U64 dst_off = 0;
+  U64 src_off = 0;
+  for(B32 good = 1; good && src_off + 4 <= src.size;)
+  {
+    //- skip skippable frames
+    U32 magic = 0;
+    MemoryCopy(&magic, src.str + src_off, sizeof(magic));
+    if(ZSTD_SKIPPABLE_MAGIC_MIN <= magic && magic <= ZSTD_SKIPPABLE_MAGIC_MAX)
+    {
+      U32 skip_size = 0;
+      good = (str8_deserial_read_struct(src, src_off + 4, &skip_size) == sizeof(skip_size));
+      src_off += 8 + skip_size;
+      continue;
+    }
+    
+    //- read frame header
+    ZSTD_FrameHeader header = zstd_frame_header_from_data(str8_skip(src, src_off));
+    good = (header.header_size != 0 && header.dict_id == 0);
+    if(!good)
+    {
+      break;
+    }
+    src_off += header.header_size;
+    state->has_huff = 0;
+    state->rep[0] = 1;
+    state->rep[1] = 4;
+    state->rep[2] = 8;
+    MemoryZeroStruct(&state->ll);
+    MemoryZeroStruct(&state->of);
+    MemoryZeroStruct(&state->ml);
+    
+    //- decode blocks
+    U64 frame_off = dst_off;
+    U64 block_size_max = Min(header.window_size, ZSTD_BLOCK_SIZE_MAX);
+    for(B32 is_last = 0; good && !is_last;)
+    {
+      U32 block_header = 0;
+      good = (src_off + 3 <= src.size);
+      if(!good)
+      {
+        break;
+      }
+      MemoryCopy(&block_header, src.str + src_off, 3);
+      src_off += 3;
+      is_last = (block_header & 1);
+      ZSTD_BlockKind kind = (ZSTD_BlockKind)((block_header >> 1) & 3);
+      U64 block_size = (block_header >> 3);
+      switch(kind)
+      {
+        case ZSTD_BlockKind_Raw:
+        {
+          good = (src_off + block_size <= src.size && dst_off + block_size <= dst_size && block_size <= block_size_max);
+          if(good)
+          {
+            MemoryCopy(dst + dst_off, src.str + src_off, block_size);
+            src_off += block_size;
+            dst_off += block_size;
+          }
+        }break;
+        case ZSTD_BlockKind_RLE:
+        {
+          good = (src_off + 1 <= src.size && dst_off + block_size <= dst_size && block_size <= block_size_max);
+          if(good)
+          {
+            MemorySet(dst + dst_off, src.str[src_off], block_size);
+            src_off += 1;
+            dst_off += block_size;
+          }
+        }break;
+        case ZSTD_BlockKind_Compressed:
+        {
+          good = (src_off + block_size <= src.size && block_size <= block_size_max);
+          if(good)
+          {
+            U64 block_dst_off = dst_off;
+            good = zstd_block_decompress(state, str8(src.str + src_off, block_size), dst, dst_size, frame_off, &dst_off);
+            good = (good && dst_off - block_dst_off <= block_size_max);
+            src_off += block_size;
+          }
+        }break;
+        case ZSTD_BlockKind_Reserved:
+        {
+          good = 0;
+        }break;
+      }
+    }
+    
+    //- skip checksum; content size must match, if present
+    if(good && header.has_checksum)
+    {
+      good = (src_off + 4 <= src.size);
+      src_off += 4;
+    }
+    if(good && header.has_content_size)
+    {
+      good = (dst_off - frame_off == header.content_size);
+    }
+  }
+  scratch_end(scratch);
+  ProfEnd();
+  return dst_off;
+}
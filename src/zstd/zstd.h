@@ -0,0 +1,159 @@
+// Copyright (c) Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+#ifndef ZSTD_H
+#define ZSTD_H
+
+////////////////////////////////
+//~ Zstandard Decoding
+//
+// A decoder for Zstandard frames (RFC 8878), as produced by toolchains which
+// compress ELF debug sections with `--compress-debug-sections=zstd`. Frames
+// are decoded into a single flat buffer, so matches are copied straight from
+// earlier output; dictionaries are not supported. Malformed input stops
+// decoding, & the # of bytes which were decoded up to that point is returned.
+
+#define ZSTD_MAGIC                  0xFD2FB528u
+#define ZSTD_SKIPPABLE_MAGIC_MIN    0x184D2A50u
+#define ZSTD_SKIPPABLE_MAGIC_MAX    0x184D2A5Fu
+#define ZSTD_BLOCK_SIZE_MAX         KB(128)
+#define ZSTD_HUFF_MAX_BITS          11
+#define ZSTD_HUFF_MAX_SYMBOL_COUNT  256
+#define ZSTD_FSE_MAX_ACCURACY_LOG   9
+#define ZSTD_FSE_MAX_SYMBOL_COUNT   53
+
+////////////////////////////////
+//~ Format Types
+
+typedef enum ZSTD_BlockKind
+{
+  ZSTD_BlockKind_Raw,
+  ZSTD_BlockKind_RLE,
+  ZSTD_BlockKind_Compressed,
+  ZSTD_BlockKind_Reserved,
+}
+ZSTD_BlockKind;
+
+typedef enum ZSTD_LiteralsKind
+{
+  ZSTD_LiteralsKind_Raw,
+  ZSTD_LiteralsKind_RLE,
+  ZSTD_LiteralsKind_Compressed,
+  ZSTD_LiteralsKind_Treeless,
+}
+ZSTD_LiteralsKind;
+
+typedef enum ZSTD_SeqMode
+{
+  ZSTD_SeqMode_Predefined,
+  ZSTD_SeqMode_RLE,
+  ZSTD_SeqMode_Compressed,
+  ZSTD_SeqMode_Repeat,
+}
+ZSTD_SeqMode;
+
+typedef struct ZSTD_FrameHeader ZSTD_FrameHeader;
+struct ZSTD_FrameHeader
+{
+  U64 header_size;
+  U64 window_size;
+  U64 content_size;
+  U32 dict_id;
+  B32 has_content_size;
+  B32 has_checksum;
+};
+
+////////////////////////////////
+//~ Decoding Tables
+
+typedef struct ZSTD_FSEEntry ZSTD_FSEEntry;
+struct ZSTD_FSEEntry
+{
+  U16 base;
+  U8 symbol;
+  U8 bits;
+};
+
+typedef struct ZSTD_FSETable ZSTD_FSETable;
+struct ZSTD_FSETable
+{
+  U32 accuracy_log;
+  ZSTD_FSEEntry v[1<<ZSTD_FSE_MAX_ACCURACY_LOG];
+};
+
+typedef struct ZSTD_HuffEntry ZSTD_HuffEntry;
+struct ZSTD_HuffEntry
+{
+  U8 symbol;
+  U8 bits;
+};
+
+typedef struct ZSTD_HuffTable ZSTD_HuffTable;
+struct ZSTD_HuffTable
+{
+  U32 max_bits;
+  ZSTD_HuffEntry v[1<<ZSTD_HUFF_MAX_BITS];
+};
+
+////////////////////////////////
+//~ Bitstreams
+
+// NOTE: read from the first byte onwards, starting at each byte's lowest bit
+typedef struct ZSTD_FwdBitReader ZSTD_FwdBitReader;
+struct ZSTD_FwdBitReader
+{
+  String8 data;
+  U64 bit_off;
+};
+
+// NOTE: read from the last byte backwards, starting below the highest set bit
+// of the last byte (which marks the end of the stream); reads past the start
+// produce zeroes, & leave `bits_left` negative
+typedef struct ZSTD_BwdBitReader ZSTD_BwdBitReader;
+struct ZSTD_BwdBitReader
+{
+  String8 data;
+  S64 bits_left;
+};
+
+////////////////////////////////
+//~ Decoder State
+
+// NOTE: state which carries over between the blocks of a frame
+typedef struct ZSTD_FrameState ZSTD_FrameState;
+struct ZSTD_FrameState
+{
+  ZSTD_HuffTable huff;
+  B32 has_huff;
+  ZSTD_FSETable ll;
+  ZSTD_FSETable of;
+  ZSTD_FSETable ml;
+  U64 rep[3];
+  U8 literals[ZSTD_BLOCK_SIZE_MAX];
+};
+
+////////////////////////////////
+//~ Bitstream Functions
+
+internal U64 zstd_fwd_bit_reader_peek(ZSTD_FwdBitReader *r, U64 bit_count);
+internal U64 zstd_fwd_bit_reader_read(ZSTD_FwdBitReader *r, U64 bit_count);
+internal ZSTD_BwdBitReader zstd_bwd_bit_reader_from_data(String8 data);
+internal U64 zstd_bwd_bit_reader_peek(ZSTD_BwdBitReader *r, U64 bit_count);
+internal U64 zstd_bwd_bit_reader_read(ZSTD_BwdBitReader *r, U64 bit_count);
+
+////////////////////////////////
+//~ Table Building Functions
+
+internal B32 zstd_fse_table_fill_from_counts(ZSTD_FSETable *table, S16 *counts, U64 symbol_count, U32 accuracy_log);
+internal U64 zstd_fse_table_fill_from_data(ZSTD_FSETable *table, String8 data, U64 max_symbol_count, U32 max_accuracy_log);
+internal U64 zstd_huff_table_fill_from_data(ZSTD_HuffTable *table, String8 data);
+internal B32 zstd_huff_stream_decode(ZSTD_HuffTable *table, String8 stream, U8 *out, U64 count);
+
+////////////////////////////////
+//~ Decoding Functions
+
+internal ZSTD_FrameHeader zstd_frame_header_from_data(String8 data);
+internal B32 zstd_block_decompress(ZSTD_FrameState *state, String8 block, U8 *dst, U64 dst_size, U64 frame_off, U64 *dst_off_out);
+internal U64 zstd_decompress(U8 *dst, U64 dst_size, String8 src);
+
+#endif // ZSTD_H